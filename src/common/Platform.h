@@ -71,4 +71,9 @@ static_assert(sizeof(sizeof(char)) == 4, "Expect sizeof(size_t) == 4");
 #    error "Unsupported platform"
 #endif
 
+// SSE2 is part of the x86-64 baseline and can be enabled explicitly on 32-bit x86.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DAWN_PLATFORM_SSE2 1
+#endif
+
 #endif  // COMMON_PLATFORM_H_
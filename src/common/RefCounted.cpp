@@ -73,6 +73,19 @@ void RefCounted::Release() {
     }
 }
 
+bool RefCounted::TryReference() {
+    // Like in Reference, the relaxed ordering is enough because the caller makes sure the object
+    // isn't deleted while this runs.
+    uint64_t refCount = mRefCount.load(std::memory_order_relaxed);
+    do {
+        if ((refCount & ~kPayloadMask) == 0) {
+            return false;
+        }
+    } while (!mRefCount.compare_exchange_weak(refCount, refCount + kRefCountIncrement,
+                                              std::memory_order_relaxed));
+    return true;
+}
+
 void RefCounted::DeleteThis() {
     delete this;
 }
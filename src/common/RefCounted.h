@@ -28,6 +28,9 @@ class RefCounted {
     // Dawn API
     void Reference();
     void Release();
+    // Adds a reference unless the last one was already released, for objects that can be found
+    // while they wait for a deferred deletion.
+    bool TryReference();
 
   protected:
     virtual ~RefCounted() = default;
@@ -15,72 +15,433 @@
 #ifndef COMMON_SERIALQUEUE_H_
 #define COMMON_SERIALQUEUE_H_
 
-#include "common/SerialStorage.h"
+#include "common/Assert.h"
 
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
 #include <vector>
 
+// SerialQueue stores an associative list mapping a Serial to Value.
+// It enforces that the Serials enqueued are non-decreasing.
+// The (serial, value) entries are stored in a circular buffer that is only reallocated when it
+// grows, so enqueuing and clearing values up to a serial are amortized O(1) per value and don't
+// allocate memory in the steady state.
 template <typename Serial, typename Value>
-class SerialQueue;
+class SerialQueue {
+    struct Entry {
+        Entry(Serial serial, const Value& value) : serial(serial), value(value) {
+        }
+        Entry(Serial serial, Value&& value) : serial(serial), value(std::move(value)) {
+        }
 
-template <typename SerialT, typename ValueT>
-struct SerialStorageTraits<SerialQueue<SerialT, ValueT>> {
-    using Serial = SerialT;
-    using Value = ValueT;
-    using SerialPair = std::pair<Serial, std::vector<Value>>;
-    using Storage = std::vector<SerialPair>;
-    using StorageIterator = typename Storage::iterator;
-    using ConstStorageIterator = typename Storage::const_iterator;
-};
+        Serial serial;
+        Value value;
+    };
 
-// SerialQueue stores an associative list mapping a Serial to Value.
-// It enforces that the Serials enqueued are strictly non-decreasing.
-// This makes it very efficient iterate or clear all items added up
-// to some Serial value because they are stored contiguously in memory.
-template <typename Serial, typename Value>
-class SerialQueue : public SerialStorage<SerialQueue<Serial, Value>> {
   public:
+    class Iterator {
+      public:
+        Iterator(SerialQueue* queue, size_t index);
+        Iterator& operator++();
+
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const;
+        Value& operator*() const;
+
+      private:
+        SerialQueue* mQueue;
+        size_t mIndex;
+    };
+
+    class ConstIterator {
+      public:
+        ConstIterator(const SerialQueue* queue, size_t index);
+        ConstIterator& operator++();
+
+        bool operator==(const ConstIterator& other) const;
+        bool operator!=(const ConstIterator& other) const;
+        const Value& operator*() const;
+
+      private:
+        const SerialQueue* mQueue;
+        size_t mIndex;
+    };
+
+    class BeginEnd {
+      public:
+        BeginEnd(SerialQueue* queue, size_t end);
+
+        Iterator begin() const;
+        Iterator end() const;
+
+      private:
+        SerialQueue* mQueue;
+        size_t mEnd;
+    };
+
+    class ConstBeginEnd {
+      public:
+        ConstBeginEnd(const SerialQueue* queue, size_t end);
+
+        ConstIterator begin() const;
+        ConstIterator end() const;
+
+      private:
+        const SerialQueue* mQueue;
+        size_t mEnd;
+    };
+
+    SerialQueue() = default;
+    SerialQueue(const SerialQueue& other);
+    SerialQueue(SerialQueue&& other);
+    SerialQueue& operator=(const SerialQueue& other);
+    SerialQueue& operator=(SerialQueue&& other);
+    ~SerialQueue();
 
     // The serial must be given in (not strictly) increasing order.
     void Enqueue(const Value& value, Serial serial);
     void Enqueue(Value&& value, Serial serial);
     void Enqueue(const std::vector<Value>& values, Serial serial);
     void Enqueue(std::vector<Value>&& values, Serial serial);
+
+    bool Empty() const;
+
+    // The UpTo variants of Iterate and Clear affect all values associated to a serial
+    // that is smaller OR EQUAL to the given serial. Iterating is done like so:
+    //     for (const T& value : queue.IterateAll()) { stuff(T); }
+    ConstBeginEnd IterateAll() const;
+    ConstBeginEnd IterateUpTo(Serial serial) const;
+    BeginEnd IterateAll();
+    BeginEnd IterateUpTo(Serial serial);
+
+    void Clear();
+    void ClearUpTo(Serial serial);
+
+    Serial FirstSerial() const;
+    Serial LastSerial() const;
+
+  private:
+    Entry& GetEntry(size_t index);
+    const Entry& GetEntry(size_t index) const;
+
+    // Returns the index of the first entry with a serial bigger than serial.
+    size_t FindUpTo(Serial serial) const;
+
+    void Grow();
+    void DestroyFirstEntries(size_t count);
+
+    std::allocator<Entry> mAllocator;
+    Entry* mEntries = nullptr;
+    // mCapacity is always zero or a power of two so indices wrap around with a mask.
+    size_t mCapacity = 0;
+    size_t mHead = 0;
+    size_t mSize = 0;
 };
 
 // SerialQueue
 
+template <typename Serial, typename Value>
+SerialQueue<Serial, Value>::SerialQueue(const SerialQueue& other) {
+    if (other.mCapacity == 0) {
+        return;
+    }
+    mEntries = mAllocator.allocate(other.mCapacity);
+    mCapacity = other.mCapacity;
+    for (size_t i = 0; i < other.mSize; ++i) {
+        const Entry& entry = other.GetEntry(i);
+        new (&mEntries[i]) Entry(entry.serial, entry.value);
+        mSize++;
+    }
+}
+
+template <typename Serial, typename Value>
+SerialQueue<Serial, Value>::SerialQueue(SerialQueue&& other)
+    : mEntries(other.mEntries),
+      mCapacity(other.mCapacity),
+      mHead(other.mHead),
+      mSize(other.mSize) {
+    other.mEntries = nullptr;
+    other.mCapacity = 0;
+    other.mHead = 0;
+    other.mSize = 0;
+}
+
+template <typename Serial, typename Value>
+SerialQueue<Serial, Value>& SerialQueue<Serial, Value>::operator=(const SerialQueue& other) {
+    if (this != &other) {
+        *this = SerialQueue(other);
+    }
+    return *this;
+}
+
+template <typename Serial, typename Value>
+SerialQueue<Serial, Value>& SerialQueue<Serial, Value>::operator=(SerialQueue&& other) {
+    if (this != &other) {
+        std::swap(mEntries, other.mEntries);
+        std::swap(mCapacity, other.mCapacity);
+        std::swap(mHead, other.mHead);
+        std::swap(mSize, other.mSize);
+    }
+    return *this;
+}
+
+template <typename Serial, typename Value>
+SerialQueue<Serial, Value>::~SerialQueue() {
+    Clear();
+    if (mEntries != nullptr) {
+        mAllocator.deallocate(mEntries, mCapacity);
+    }
+}
+
 template <typename Serial, typename Value>
 void SerialQueue<Serial, Value>::Enqueue(const Value& value, Serial serial) {
-    DAWN_ASSERT(this->Empty() || this->mStorage.back().first <= serial);
+    DAWN_ASSERT(Empty() || LastSerial() <= serial);
 
-    if (this->Empty() || this->mStorage.back().first < serial) {
-        this->mStorage.emplace_back(serial, std::vector<Value>{});
+    if (mSize == mCapacity) {
+        // |value| can be one of the values of the queue, so it is copied before Grow destroys
+        // them.
+        Value copy(value);
+        Grow();
+        new (&GetEntry(mSize)) Entry(serial, std::move(copy));
+    } else {
+        new (&GetEntry(mSize)) Entry(serial, value);
     }
-    this->mStorage.back().second.push_back(value);
+    mSize++;
 }
 
 template <typename Serial, typename Value>
 void SerialQueue<Serial, Value>::Enqueue(Value&& value, Serial serial) {
-    DAWN_ASSERT(this->Empty() || this->mStorage.back().first <= serial);
+    DAWN_ASSERT(Empty() || LastSerial() <= serial);
 
-    if (this->Empty() || this->mStorage.back().first < serial) {
-        this->mStorage.emplace_back(serial, std::vector<Value>{});
+    if (mSize == mCapacity) {
+        // Same as above, |value| is moved out before Grow.
+        Value moved(std::move(value));
+        Grow();
+        new (&GetEntry(mSize)) Entry(serial, std::move(moved));
+    } else {
+        new (&GetEntry(mSize)) Entry(serial, std::move(value));
     }
-    this->mStorage.back().second.push_back(std::move(value));
+    mSize++;
 }
 
 template <typename Serial, typename Value>
 void SerialQueue<Serial, Value>::Enqueue(const std::vector<Value>& values, Serial serial) {
     DAWN_ASSERT(values.size() > 0);
-    DAWN_ASSERT(this->Empty() || this->mStorage.back().first <= serial);
-    this->mStorage.emplace_back(serial, values);
+    for (const Value& value : values) {
+        Enqueue(value, serial);
+    }
 }
 
 template <typename Serial, typename Value>
 void SerialQueue<Serial, Value>::Enqueue(std::vector<Value>&& values, Serial serial) {
     DAWN_ASSERT(values.size() > 0);
-    DAWN_ASSERT(this->Empty() || this->mStorage.back().first <= serial);
-    this->mStorage.emplace_back(serial, values);
+    for (Value& value : values) {
+        Enqueue(std::move(value), serial);
+    }
+}
+
+template <typename Serial, typename Value>
+bool SerialQueue<Serial, Value>::Empty() const {
+    return mSize == 0;
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::ConstBeginEnd SerialQueue<Serial, Value>::IterateAll() const {
+    return {this, mSize};
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::ConstBeginEnd SerialQueue<Serial, Value>::IterateUpTo(
+    Serial serial) const {
+    return {this, FindUpTo(serial)};
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::BeginEnd SerialQueue<Serial, Value>::IterateAll() {
+    return {this, mSize};
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::BeginEnd SerialQueue<Serial, Value>::IterateUpTo(
+    Serial serial) {
+    return {this, FindUpTo(serial)};
+}
+
+template <typename Serial, typename Value>
+void SerialQueue<Serial, Value>::Clear() {
+    DestroyFirstEntries(mSize);
+    mHead = 0;
+}
+
+template <typename Serial, typename Value>
+void SerialQueue<Serial, Value>::ClearUpTo(Serial serial) {
+    DestroyFirstEntries(FindUpTo(serial));
+}
+
+template <typename Serial, typename Value>
+Serial SerialQueue<Serial, Value>::FirstSerial() const {
+    DAWN_ASSERT(!Empty());
+    return GetEntry(0).serial;
+}
+
+template <typename Serial, typename Value>
+Serial SerialQueue<Serial, Value>::LastSerial() const {
+    DAWN_ASSERT(!Empty());
+    return GetEntry(mSize - 1).serial;
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::Entry& SerialQueue<Serial, Value>::GetEntry(size_t index) {
+    return mEntries[(mHead + index) & (mCapacity - 1)];
+}
+
+template <typename Serial, typename Value>
+const typename SerialQueue<Serial, Value>::Entry& SerialQueue<Serial, Value>::GetEntry(
+    size_t index) const {
+    return mEntries[(mHead + index) & (mCapacity - 1)];
+}
+
+template <typename Serial, typename Value>
+size_t SerialQueue<Serial, Value>::FindUpTo(Serial serial) const {
+    // Serials are sorted so binary search for the first one that is bigger than serial.
+    size_t begin = 0;
+    size_t end = mSize;
+    while (begin < end) {
+        size_t middle = begin + (end - begin) / 2;
+        if (GetEntry(middle).serial <= serial) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+    return begin;
+}
+
+template <typename Serial, typename Value>
+void SerialQueue<Serial, Value>::Grow() {
+    constexpr size_t kInitialCapacity = 8;
+    size_t newCapacity = mCapacity == 0 ? kInitialCapacity : mCapacity * 2;
+    Entry* newEntries = mAllocator.allocate(newCapacity);
+
+    for (size_t i = 0; i < mSize; ++i) {
+        Entry& entry = GetEntry(i);
+        new (&newEntries[i]) Entry(entry.serial, std::move(entry.value));
+        entry.~Entry();
+    }
+
+    if (mEntries != nullptr) {
+        mAllocator.deallocate(mEntries, mCapacity);
+    }
+    mEntries = newEntries;
+    mCapacity = newCapacity;
+    mHead = 0;
+}
+
+template <typename Serial, typename Value>
+void SerialQueue<Serial, Value>::DestroyFirstEntries(size_t count) {
+    DAWN_ASSERT(count <= mSize);
+    for (size_t i = 0; i < count; ++i) {
+        GetEntry(i).~Entry();
+    }
+    if (mCapacity != 0) {
+        mHead = (mHead + count) & (mCapacity - 1);
+    }
+    mSize -= count;
+}
+
+// SerialQueue::BeginEnd
+
+template <typename Serial, typename Value>
+SerialQueue<Serial, Value>::BeginEnd::BeginEnd(SerialQueue* queue, size_t end)
+    : mQueue(queue), mEnd(end) {
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::Iterator SerialQueue<Serial, Value>::BeginEnd::begin() const {
+    return {mQueue, 0};
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::Iterator SerialQueue<Serial, Value>::BeginEnd::end() const {
+    return {mQueue, mEnd};
+}
+
+// SerialQueue::Iterator
+
+template <typename Serial, typename Value>
+SerialQueue<Serial, Value>::Iterator::Iterator(SerialQueue* queue, size_t index)
+    : mQueue(queue), mIndex(index) {
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::Iterator& SerialQueue<Serial, Value>::Iterator::operator++() {
+    mIndex++;
+    return *this;
+}
+
+template <typename Serial, typename Value>
+bool SerialQueue<Serial, Value>::Iterator::operator==(const Iterator& other) const {
+    return other.mQueue == mQueue && other.mIndex == mIndex;
+}
+
+template <typename Serial, typename Value>
+bool SerialQueue<Serial, Value>::Iterator::operator!=(const Iterator& other) const {
+    return !(*this == other);
+}
+
+template <typename Serial, typename Value>
+Value& SerialQueue<Serial, Value>::Iterator::operator*() const {
+    return mQueue->GetEntry(mIndex).value;
+}
+
+// SerialQueue::ConstBeginEnd
+
+template <typename Serial, typename Value>
+SerialQueue<Serial, Value>::ConstBeginEnd::ConstBeginEnd(const SerialQueue* queue, size_t end)
+    : mQueue(queue), mEnd(end) {
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::ConstIterator
+SerialQueue<Serial, Value>::ConstBeginEnd::begin() const {
+    return {mQueue, 0};
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::ConstIterator SerialQueue<Serial, Value>::ConstBeginEnd::end()
+    const {
+    return {mQueue, mEnd};
+}
+
+// SerialQueue::ConstIterator
+
+template <typename Serial, typename Value>
+SerialQueue<Serial, Value>::ConstIterator::ConstIterator(const SerialQueue* queue, size_t index)
+    : mQueue(queue), mIndex(index) {
+}
+
+template <typename Serial, typename Value>
+typename SerialQueue<Serial, Value>::ConstIterator&
+SerialQueue<Serial, Value>::ConstIterator::operator++() {
+    mIndex++;
+    return *this;
+}
+
+template <typename Serial, typename Value>
+bool SerialQueue<Serial, Value>::ConstIterator::operator==(const ConstIterator& other) const {
+    return other.mQueue == mQueue && other.mIndex == mIndex;
+}
+
+template <typename Serial, typename Value>
+bool SerialQueue<Serial, Value>::ConstIterator::operator!=(const ConstIterator& other) const {
+    return !(*this == other);
+}
+
+template <typename Serial, typename Value>
+const Value& SerialQueue<Serial, Value>::ConstIterator::operator*() const {
+    return mQueue->GetEntry(mIndex).value;
 }
 
 #endif  // COMMON_SERIALQUEUE_H_
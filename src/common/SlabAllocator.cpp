@@ -84,6 +84,7 @@ SlabAllocatorImpl::SlabAllocatorImpl(SlabAllocatorImpl&& rhs)
       mBlockStride(rhs.mBlockStride),
       mBlocksPerSlab(rhs.mBlocksPerSlab),
       mTotalAllocationSize(rhs.mTotalAllocationSize),
+      mSlabCount(rhs.mSlabCount),
       mAvailableSlabs(std::move(rhs.mAvailableSlabs)),
       mFullSlabs(std::move(rhs.mFullSlabs)),
       mRecycledSlabs(std::move(rhs.mRecycledSlabs)) {
@@ -91,6 +92,10 @@ SlabAllocatorImpl::SlabAllocatorImpl(SlabAllocatorImpl&& rhs)
 
 SlabAllocatorImpl::~SlabAllocatorImpl() = default;
 
+size_t SlabAllocatorImpl::GetAllocatedBytes() const {
+    return mSlabCount * mTotalAllocationSize;
+}
+
 SlabAllocatorImpl::IndexLinkNode* SlabAllocatorImpl::OffsetFrom(
     IndexLinkNode* node,
     std::make_signed_t<Index> offset) const {
@@ -246,4 +251,5 @@ void SlabAllocatorImpl::GetNewSlab() {
     lastNode->nextIndex = kInvalidIndex;
 
     mAvailableSlabs.Prepend(new (alignedPtr) Slab(std::move(allocation), node));
+    mSlabCount++;
 }
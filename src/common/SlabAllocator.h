@@ -62,6 +62,9 @@ class SlabAllocatorImpl {
 
     SlabAllocatorImpl(SlabAllocatorImpl&& rhs);
 
+    // The size of all the slabs. Slabs are never freed so this only grows.
+    size_t GetAllocatedBytes() const;
+
   protected:
     // This is essentially a singly linked list using indices instead of pointers,
     // so we store the index of "this" in |this->index|.
@@ -146,6 +149,8 @@ class SlabAllocatorImpl {
 
     const size_t mTotalAllocationSize;
 
+    size_t mSlabCount = 0;
+
     struct SentinelSlab : Slab {
         SentinelSlab();
         ~SentinelSlab();
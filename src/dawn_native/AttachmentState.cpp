@@ -127,7 +127,11 @@ namespace dawn_native {
     }
 
     AttachmentState::~AttachmentState() {
-        GetDevice()->UncacheAttachmentState(this);
+        // The object isn't in the cache anymore if it was replaced while waiting for a deferred
+        // deletion.
+        if (IsCachedReference()) {
+            GetDevice()->UncacheAttachmentState(this);
+        }
     }
 
     ityp::bitset<ColorAttachmentIndex, kMaxColorAttachments>
@@ -20,6 +20,7 @@
 #include "dawn_native/BindGroupLayout.h"
 #include "dawn_native/Buffer.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/Sampler.h"
 #include "dawn_native/Texture.h"
 
@@ -310,6 +311,9 @@ namespace dawn_native {
                 ++packedIdx;
             }
         }
+
+        device->GetCountersTracker()->RecordObjectCreated(
+            DeviceCountersTracker::LiveObject::BindGroup);
     }
 
     BindGroupBase::~BindGroupBase() {
@@ -318,15 +322,17 @@ namespace dawn_native {
             for (BindingIndex i{0}; i < mLayout->GetBindingCount(); ++i) {
                 mBindingData.bindings[i].~Ref<ObjectBase>();
             }
+            GetDevice()->GetCountersTracker()->RecordObjectDestroyed(
+                DeviceCountersTracker::LiveObject::BindGroup);
         }
     }
 
-    void BindGroupBase::DeleteThis() {
+    void BindGroupBase::DeleteThisNow() {
         // Add another ref to the layout so that if this is the last ref, the layout
         // is destroyed after the bind group. The bind group is slab-allocated inside
         // memory owned by the layout (except for the null backend).
         Ref<BindGroupLayoutBase> layout = mLayout;
-        RefCounted::DeleteThis();
+        ObjectBase::DeleteThisNow();
     }
 
     BindGroupBase::BindGroupBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -75,7 +75,7 @@ namespace dawn_native {
 
       private:
         BindGroupBase(DeviceBase* device, ObjectBase::ErrorTag tag);
-        void DeleteThis() override;
+        void DeleteThisNow() override;
 
         Ref<BindGroupLayoutBase> mLayout;
         BindGroupLayoutBase::BindingDataPointers mBindingData;
@@ -17,6 +17,7 @@
 #include "common/BitSetIterator.h"
 #include "common/HashUtils.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/PerStage.h"
 #include "dawn_native/ValidationUtils_autogen.h"
 
@@ -307,6 +308,9 @@ namespace dawn_native {
         }
         ASSERT(CheckBufferBindingsFirst({mBindingInfo.data(), GetBindingCount()}));
         ASSERT(mBindingInfo.size() <= kMaxBindingsPerPipelineLayoutTyped);
+
+        device->GetCountersTracker()->RecordObjectCreated(
+            DeviceCountersTracker::LiveObject::BindGroupLayout);
     }
 
     BindGroupLayoutBase::BindGroupLayoutBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -314,6 +318,10 @@ namespace dawn_native {
     }
 
     BindGroupLayoutBase::~BindGroupLayoutBase() {
+        if (!IsError()) {
+            GetDevice()->GetCountersTracker()->RecordObjectDestroyed(
+                DeviceCountersTracker::LiveObject::BindGroupLayout);
+        }
         // Do not uncache the actual cached object if we are a blueprint
         if (IsCachedReference()) {
             GetDevice()->UncacheBindGroupLayout(this);
@@ -415,4 +423,8 @@ namespace dawn_native {
                 {unverifiedBufferSizes, mBindingCounts.unverifiedBufferCount}};
     }
 
+    size_t BindGroupLayoutBase::GetBindGroupAllocatorBytes() const {
+        return 0;
+    }
+
 }  // namespace dawn_native
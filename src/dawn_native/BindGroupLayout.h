@@ -96,6 +96,9 @@ namespace dawn_native {
 
         BindingDataPointers ComputeBindingDataPointers(void* dataStart) const;
 
+        // The memory held by the backend to allocate the bind groups of this layout.
+        virtual size_t GetBindGroupAllocatorBytes() const;
+
       protected:
         template <typename BindGroup>
         SlabAllocator<BindGroup> MakeFrontendBindGroupAllocator(size_t size) {
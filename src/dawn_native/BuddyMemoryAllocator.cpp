@@ -51,15 +51,15 @@ namespace dawn_native {
         }
 
         // Round allocation size to nearest power-of-two.
-        allocationSize = NextPowerOfTwo(allocationSize);
+        const uint64_t blockSize = NextPowerOfTwo(allocationSize);
 
         // Allocation cannot exceed the memory size.
-        if (allocationSize > mMemoryBlockSize) {
+        if (blockSize > mMemoryBlockSize) {
             return std::move(invalidAllocation);
         }
 
         // Attempt to sub-allocate a block of the requested size.
-        const uint64_t blockOffset = mBuddyBlockAllocator.Allocate(allocationSize, alignment);
+        const uint64_t blockOffset = mBuddyBlockAllocator.Allocate(blockSize, alignment);
         if (blockOffset == BuddyAllocator::kInvalidOffset) {
             return std::move(invalidAllocation);
         }
@@ -70,12 +70,16 @@ namespace dawn_native {
             std::unique_ptr<ResourceHeapBase> memory;
             DAWN_TRY_ASSIGN(memory, mHeapAllocator->AllocateResourceHeap(mMemoryBlockSize));
             mTrackedSubAllocations[memoryIndex] = {/*refcount*/ 0, std::move(memory)};
+            mHeapCount++;
         }
 
         mTrackedSubAllocations[memoryIndex].refcount++;
+        mRequestedBytes += allocationSize;
+        mBlockBytes += blockSize;
 
         AllocationInfo info;
         info.mBlockOffset = blockOffset;
+        info.mRequestedSize = allocationSize;
         info.mMethod = AllocationMethod::kSubAllocated;
 
         // Allocation offset is always local to the memory.
@@ -98,8 +102,13 @@ namespace dawn_native {
         if (mTrackedSubAllocations[memoryIndex].refcount == 0) {
             mHeapAllocator->DeallocateResourceHeap(
                 std::move(mTrackedSubAllocations[memoryIndex].mMemoryAllocation));
+            mHeapCount--;
         }
 
+        ASSERT(mRequestedBytes >= info.mRequestedSize);
+        mRequestedBytes -= info.mRequestedSize;
+        mBlockBytes -= NextPowerOfTwo(info.mRequestedSize);
+
         mBuddyBlockAllocator.Deallocate(info.mBlockOffset);
     }
 
@@ -107,6 +116,15 @@ namespace dawn_native {
         return mMemoryBlockSize;
     }
 
+    void BuddyMemoryAllocator::ReportMemoryUsage(
+        DeviceMemoryUsage::SubAllocatorUsage* usage) const {
+        const uint64_t heapBytes = mHeapCount * mMemoryBlockSize;
+        usage->heapBytes += heapBytes;
+        usage->usedBytes += mRequestedBytes;
+        usage->wastedBytes += mBlockBytes - mRequestedBytes;
+        usage->freeBytes += heapBytes - mBlockBytes;
+    }
+
     uint64_t BuddyMemoryAllocator::ComputeTotalNumOfHeapsForTesting() const {
         uint64_t count = 0;
         for (const TrackedSubAllocations& allocation : mTrackedSubAllocations) {
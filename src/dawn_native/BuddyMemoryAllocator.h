@@ -16,6 +16,7 @@
 #define DAWNNATIVE_BUDDYMEMORYALLOCATOR_H_
 
 #include "dawn_native/BuddyAllocator.h"
+#include "dawn_native/DawnNative.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/ResourceMemoryAllocation.h"
 
@@ -50,6 +51,9 @@ namespace dawn_native {
 
         uint64_t GetMemoryBlockSize() const;
 
+        // Adds the size of the heaps and how they are used to |usage|.
+        void ReportMemoryUsage(DeviceMemoryUsage::SubAllocatorUsage* usage) const;
+
         // For testing purposes.
         uint64_t ComputeTotalNumOfHeapsForTesting() const;
 
@@ -67,6 +71,11 @@ namespace dawn_native {
         };
 
         std::vector<TrackedSubAllocations> mTrackedSubAllocations;
+
+        uint64_t mHeapCount = 0;
+        // The sizes requested by the live allocations, and of the blocks they were rounded up to.
+        uint64_t mRequestedBytes = 0;
+        uint64_t mBlockBytes = 0;
     };
 
 }  // namespace dawn_native
@@ -17,10 +17,13 @@
 #include "common/Assert.h"
 #include "dawn_native/Commands.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/DynamicUploader.h"
 #include "dawn_native/ErrorData.h"
 #include "dawn_native/Queue.h"
 #include "dawn_native/ValidationUtils_autogen.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
 
 #include <cstdio>
 #include <cstring>
@@ -134,6 +137,11 @@ namespace dawn_native {
         if (mUsage & wgpu::BufferUsage::Storage) {
             mUsage |= kReadOnlyStorageBuffer;
         }
+
+        device->GetCountersTracker()->RecordObjectCreated(
+            DeviceCountersTracker::LiveObject::Buffer);
+        device->GetCountersTracker()->RecordMemoryAllocated(DeviceCountersTracker::Memory::Buffers,
+                                                            mSize);
     }
 
     BufferBase::BufferBase(DeviceBase* device,
@@ -152,6 +160,16 @@ namespace dawn_native {
             ASSERT(!IsError());
             CallMapCallback(mLastMapID, WGPUBufferMapAsyncStatus_DestroyedBeforeCallback);
         }
+        if (!IsError()) {
+            GetDevice()->GetCountersTracker()->RecordObjectDestroyed(
+                DeviceCountersTracker::LiveObject::Buffer);
+
+            // Backends usually destroy the buffer in their destructor, which frees its memory.
+            if (mState != BufferState::Destroyed) {
+                GetDevice()->GetCountersTracker()->RecordMemoryFreed(
+                    DeviceCountersTracker::Memory::Buffers, mSize);
+            }
+        }
     }
 
     // static
@@ -210,7 +228,7 @@ namespace dawn_native {
         return {};
     }
 
-    MaybeError BufferBase::ValidateCanUseOnQueueNow() const {
+    MaybeError BufferBase::ValidateCanUseOnQueueNow(const QueueBase* queue) const {
         ASSERT(!IsError());
 
         switch (mState) {
@@ -220,8 +238,22 @@ namespace dawn_native {
             case BufferState::MappedAtCreation:
                 return DAWN_VALIDATION_ERROR("Buffer used in a submit while mapped");
             case BufferState::Unmapped:
-                return {};
+                break;
+        }
+
+        // Queues execute concurrently with each other, so a buffer can only move to another
+        // queue once the commands of the previous one that use it are complete.
+        if (mLastUsageQueue != nullptr && mLastUsageQueue != queue &&
+            mLastUsageQueue->GetCompletedSerial() < mLastUsageSerial) {
+            return DAWN_VALIDATION_ERROR("Buffer still in use on another queue");
         }
+        return {};
+    }
+
+    void BufferBase::TrackUsageOnQueue(const QueueBase* queue, ExecutionSerial serial) {
+        ASSERT(!IsError());
+        mLastUsageQueue = queue;
+        mLastUsageSerial = serial;
     }
 
     void BufferBase::CallMapCallback(MapRequestID mapID, WGPUBufferMapAsyncStatus status) {
@@ -245,6 +277,8 @@ namespace dawn_native {
                               size_t size,
                               WGPUBufferMapCallback callback,
                               void* userdata) {
+        TRACE_EVENT0(GetDevice()->GetPlatform(), General, "Buffer::MapAsync");
+
         // Handle the defaulting of size required by WebGPU, even if in webgpu_cpp.h it is not
         // possible to default the function argument (because there is the callback later in the
         // argument list)
@@ -523,6 +557,10 @@ namespace dawn_native {
     void BufferBase::DestroyInternal() {
         if (mState != BufferState::Destroyed) {
             DestroyImpl();
+            if (!IsError()) {
+                GetDevice()->GetCountersTracker()->RecordMemoryFreed(
+                    DeviceCountersTracker::Memory::Buffers, mSize);
+            }
         }
         mState = BufferState::Destroyed;
     }
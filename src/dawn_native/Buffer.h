@@ -55,7 +55,10 @@ namespace dawn_native {
         MaybeError MapAtCreation();
         void OnMapRequestCompleted(MapRequestID mapID);
 
-        MaybeError ValidateCanUseOnQueueNow() const;
+        MaybeError ValidateCanUseOnQueueNow(const QueueBase* queue) const;
+        // Records that the commands |queue| executes at |serial| use the buffer, so that other
+        // queues can't use it until they complete.
+        void TrackUsageOnQueue(const QueueBase* queue, ExecutionSerial serial);
 
         bool IsFullBufferRange(uint64_t offset, uint64_t size) const;
         bool IsDataInitialized() const;
@@ -110,6 +113,9 @@ namespace dawn_native {
         BufferState mState;
         bool mIsDataInitialized = false;
 
+        const QueueBase* mLastUsageQueue = nullptr;
+        ExecutionSerial mLastUsageSerial = ExecutionSerial(0);
+
         std::unique_ptr<StagingBufferBase> mStagingBuffer;
 
         WGPUBufferMapCallback mMapCallback = nullptr;
@@ -24,4 +24,8 @@ namespace dawn_native {
         mIsCachedReference = true;
     }
 
+    void CachedObject::ClearIsCachedReference() {
+        mIsCachedReference = false;
+    }
+
 }  // namespace dawn_native
@@ -32,6 +32,8 @@ namespace dawn_native {
       private:
         friend class DeviceBase;
         void SetIsCachedReference();
+        // Called when the object is removed from the cache before it is deleted.
+        void ClearIsCachedReference();
 
         bool mIsCachedReference = false;
     };
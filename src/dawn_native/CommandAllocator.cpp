@@ -30,25 +30,45 @@ namespace dawn_native {
     }
 
     CommandIterator::~CommandIterator() {
-        ASSERT(IsEmpty());
+        ASSERT(IsEmpty() || !mOwnsBlocks);
     }
 
     CommandIterator::CommandIterator(CommandIterator&& other) {
         if (!other.IsEmpty()) {
             mBlocks = std::move(other.mBlocks);
+            mBlockData = other.mBlockData;
+            mBlockCount = other.mBlockCount;
+            mOwnsBlocks = other.mOwnsBlocks;
+            other.mBlocks.clear();
+            other.mOwnsBlocks = true;
             other.Reset();
         }
         Reset();
     }
 
     CommandIterator& CommandIterator::operator=(CommandIterator&& other) {
-        ASSERT(IsEmpty());
-        mBlocks = std::move(other.mBlocks);
-        other.Reset();
+        ASSERT(IsEmpty() || !mOwnsBlocks);
+        if (other.IsEmpty()) {
+            mBlocks.clear();
+            mOwnsBlocks = true;
+        } else {
+            mBlocks = std::move(other.mBlocks);
+            mBlockData = other.mBlockData;
+            mBlockCount = other.mBlockCount;
+            mOwnsBlocks = other.mOwnsBlocks;
+            other.mBlocks.clear();
+            other.mOwnsBlocks = true;
+            other.Reset();
+        }
         Reset();
         return *this;
     }
 
+    CommandIterator::CommandIterator(const BlockDef* blocks, size_t blockCount)
+        : mBlockData(blocks), mBlockCount(blockCount), mOwnsBlocks(false) {
+        Reset();
+    }
+
     CommandIterator::CommandIterator(CommandAllocator&& allocator)
         : mBlocks(allocator.AcquireBlocks()) {
         Reset();
@@ -63,28 +83,46 @@ namespace dawn_native {
 
     bool CommandIterator::NextCommandIdInNewBlock(uint32_t* commandId) {
         mCurrentBlock++;
-        if (mCurrentBlock >= mBlocks.size()) {
+        if (mCurrentBlock >= mBlockCount) {
             Reset();
             *commandId = detail::kEndOfBlock;
             return false;
         }
-        mCurrentPtr = AlignPtr(mBlocks[mCurrentBlock].block, alignof(uint32_t));
+        mCurrentPtr = AlignPtr(mBlockData[mCurrentBlock].block, alignof(uint32_t));
         return NextCommandId(commandId);
     }
 
     void CommandIterator::Reset() {
         mCurrentBlock = 0;
 
-        if (mBlocks.empty()) {
-            // This will case the first NextCommandId call to try to move to the next block and stop
-            // the iteration immediately, without special casing the initialization.
-            mCurrentPtr = reinterpret_cast<uint8_t*>(&mEndOfBlock);
-            mBlocks.emplace_back();
-            mBlocks[0].size = sizeof(mEndOfBlock);
-            mBlocks[0].block = mCurrentPtr;
-        } else {
-            mCurrentPtr = AlignPtr(mBlocks[0].block, alignof(uint32_t));
+        // Borrowed iterators keep reading the blocks of their owner.
+        if (mOwnsBlocks) {
+            if (mBlocks.empty()) {
+                // This will case the first NextCommandId call to try to move to the next block and
+                // stop the iteration immediately, without special casing the initialization.
+                mBlocks.emplace_back();
+                mBlocks[0].size = sizeof(mEndOfBlock);
+                mBlocks[0].block = reinterpret_cast<uint8_t*>(&mEndOfBlock);
+            }
+            mBlockData = mBlocks.data();
+            mBlockCount = mBlocks.size();
         }
+        mCurrentPtr = AlignPtr(mBlockData[0].block, alignof(uint32_t));
+    }
+
+    CommandIterator::Position CommandIterator::GetPosition() const {
+        return {mCurrentBlock, mCurrentPtr};
+    }
+
+    void CommandIterator::SetPosition(const Position& position) {
+        ASSERT(position.block < mBlockCount);
+        mCurrentBlock = position.block;
+        mCurrentPtr = position.ptr;
+    }
+
+    CommandIterator CommandIterator::Borrow() const {
+        // An empty iterator is borrowed too, its blocks are its end of block marker.
+        return CommandIterator(mBlockData, mBlockCount);
     }
 
     void CommandIterator::MakeEmptyAsDataWasDestroyed() {
@@ -92,16 +130,31 @@ namespace dawn_native {
             return;
         }
 
-        for (auto& block : mBlocks) {
-            free(block.block);
+        if (mOwnsBlocks) {
+            for (auto& block : mBlocks) {
+                free(block.block);
+            }
         }
+        mOwnsBlocks = true;
         mBlocks.clear();
         Reset();
         ASSERT(IsEmpty());
     }
 
+    size_t CommandIterator::GetAllocatedBytes() const {
+        if (IsEmpty()) {
+            return 0;
+        }
+
+        size_t bytes = 0;
+        for (size_t i = 0; i < mBlockCount; ++i) {
+            bytes += mBlockData[i].size;
+        }
+        return bytes;
+    }
+
     bool CommandIterator::IsEmpty() const {
-        return mBlocks[0].block == reinterpret_cast<const uint8_t*>(&mEndOfBlock);
+        return mBlockData[0].block == reinterpret_cast<const uint8_t*>(&mEndOfBlock);
     }
 
     // Potential TODO(cwallez@chromium.org):
@@ -123,6 +176,10 @@ namespace dawn_native {
         ASSERT(mBlocks.empty());
     }
 
+    const CommandAllocator::CommandCounts& CommandAllocator::GetCommandCounts() const {
+        return mCommandCounts;
+    }
+
     CommandBlocks&& CommandAllocator::AcquireBlocks() {
         ASSERT(mCurrentPtr != nullptr && mEndPtr != nullptr);
         ASSERT(IsPtrAligned(mCurrentPtr, alignof(uint32_t)));
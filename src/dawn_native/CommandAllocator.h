@@ -18,8 +18,10 @@
 #include "common/Assert.h"
 #include "common/Math.h"
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <vector>
 
 namespace dawn_native {
@@ -27,12 +29,18 @@ namespace dawn_native {
     // Allocation for command buffers should be fast. To avoid doing an allocation per command
     // or to avoid copying commands when reallocing, we use a linear allocator in a growing set
     // of large memory blocks. We also use this to have the format to be (u32 commandId, command),
-    // so that iteration over the commands is easy.
+    // so that iteration over the commands is easy. Commands with variable-length data, like
+    // labels or dynamic offsets, store it inline right after the command without an id so that
+    // both are read with a single id check.
 
     // Usage of the allocator and iterator:
     //     CommandAllocator allocator;
     //     DrawCommand* cmd = allocator.Allocate<DrawCommand>(CommandType::Draw);
     //     // Fill command
+    //     uint32_t* data;
+    //     MultiCommand* multi = allocator.AllocateWithData<MultiCommand>(CommandType::Multi,
+    //                                                                     count, &data);
+    //     // Fill command and its |count| elements of data
     //     // Repeat allocation and filling commands
     //
     //     CommandIterator commands(allocator);
@@ -43,6 +51,10 @@ namespace dawn_native {
     //                  DrawCommand* draw = commands.NextCommand<DrawCommand>();
     //                  // Do the draw
     //                  break;
+    //              case CommandType::Multi:
+    //                  MultiCommand* multi = commands.NextCommand<MultiCommand>();
+    //                  uint32_t* data = commands.NextData<uint32_t>(multi->count);
+    //                  break;
     //              // other cases
     //         }
     //     }
@@ -61,7 +73,6 @@ namespace dawn_native {
 
     namespace detail {
         constexpr uint32_t kEndOfBlock = std::numeric_limits<uint32_t>::max();
-        constexpr uint32_t kAdditionalData = std::numeric_limits<uint32_t>::max() - 1;
     }  // namespace detail
 
     class CommandAllocator;
@@ -86,11 +97,27 @@ namespace dawn_native {
         T* NextCommand() {
             return static_cast<T*>(NextCommand(sizeof(T), alignof(T)));
         }
+        // Returns the data allocated with the command that was just returned by NextCommand.
         template <typename T>
         T* NextData(size_t count) {
-            return static_cast<T*>(NextData(sizeof(T) * count, alignof(T)));
+            return static_cast<T*>(NextCommand(sizeof(T) * count, alignof(T)));
         }
 
+        // The position after the last command or id that was read. Setting it back allows reading
+        // the commands again, for example after looking at the commands that follow the current
+        // one.
+        struct Position {
+            size_t block;
+            uint8_t* ptr;
+        };
+        Position GetPosition() const;
+        void SetPosition(const Position& position);
+
+        // Returns an iterator at the beginning of the same commands that doesn't own them, so
+        // that several threads can read the commands at the same time. It reads the blocks of
+        // this iterator without copying them, so it must not outlive this iterator.
+        CommandIterator Borrow() const;
+
         // Sets iterator to the beginning of the commands without emptying the list. This method can
         // be used if iteration was stopped early and the iterator needs to be restarted.
         void Reset();
@@ -99,13 +126,19 @@ namespace dawn_native {
         // commands have been submitted and they are no longer valid.
         void MakeEmptyAsDataWasDestroyed();
 
+        // The size of the blocks holding the commands, used to report the memory usage.
+        size_t GetAllocatedBytes() const;
+
       private:
+        // Creates an iterator reading the blocks of another iterator.
+        CommandIterator(const BlockDef* blocks, size_t blockCount);
+
         bool IsEmpty() const;
 
         DAWN_FORCE_INLINE bool NextCommandId(uint32_t* commandId) {
             uint8_t* idPtr = AlignPtr(mCurrentPtr, alignof(uint32_t));
             ASSERT(idPtr + sizeof(uint32_t) <=
-                   mBlocks[mCurrentBlock].block + mBlocks[mCurrentBlock].size);
+                   mBlockData[mCurrentBlock].block + mBlockData[mCurrentBlock].size);
 
             uint32_t id = *reinterpret_cast<uint32_t*>(idPtr);
 
@@ -122,26 +155,23 @@ namespace dawn_native {
         DAWN_FORCE_INLINE void* NextCommand(size_t commandSize, size_t commandAlignment) {
             uint8_t* commandPtr = AlignPtr(mCurrentPtr, commandAlignment);
             ASSERT(commandPtr + sizeof(commandSize) <=
-                   mBlocks[mCurrentBlock].block + mBlocks[mCurrentBlock].size);
+                   mBlockData[mCurrentBlock].block + mBlockData[mCurrentBlock].size);
 
             mCurrentPtr = commandPtr + commandSize;
             return commandPtr;
         }
 
-        DAWN_FORCE_INLINE void* NextData(size_t dataSize, size_t dataAlignment) {
-            uint32_t id;
-            bool hasId = NextCommandId(&id);
-            ASSERT(hasId);
-            ASSERT(id == detail::kAdditionalData);
-
-            return NextCommand(dataSize, dataAlignment);
-        }
-
+        // The blocks owned by the iterator, empty for the iterators returned by Borrow().
         CommandBlocks mBlocks;
+        // The blocks that are read: mBlocks, or the blocks of the owner of a borrowed iterator.
+        const BlockDef* mBlockData = nullptr;
+        size_t mBlockCount = 0;
         uint8_t* mCurrentPtr = nullptr;
         size_t mCurrentBlock = 0;
         // Used to avoid a special case for empty iterators.
         uint32_t mEndOfBlock = detail::kEndOfBlock;
+        // False for the iterators returned by Borrow().
+        bool mOwnsBlocks = true;
     };
 
     class CommandAllocator {
@@ -163,19 +193,50 @@ namespace dawn_native {
             return result;
         }
 
-        template <typename T>
-        T* AllocateData(size_t count) {
+        // Allocates a command followed by |count| elements of data in the same block, so that the
+        // iterator can read the data right after the command without another id.
+        template <typename T, typename E, typename D>
+        T* AllocateWithData(E commandId, size_t count, D** data) {
+            static_assert(sizeof(E) == sizeof(uint32_t), "");
+            static_assert(alignof(E) == alignof(uint32_t), "");
             static_assert(alignof(T) <= kMaxSupportedAlignment, "");
-            T* result = reinterpret_cast<T*>(AllocateData(sizeof(T) * count, alignof(T)));
-            if (!result) {
+            static_assert(alignof(D) <= kMaxSupportedAlignment, "");
+
+            // The command is allocated with the upper bound of the padding before the data.
+            constexpr size_t kMaxCommandAndPadding = sizeof(T) + alignof(D);
+            if (DAWN_UNLIKELY(count > (std::numeric_limits<size_t>::max() -
+                                       kMaxCommandAndPadding - kWorstCaseAdditionalSize) /
+                                          sizeof(D))) {
+                return nullptr;
+            }
+            size_t dataSize = sizeof(D) * count;
+
+            uint8_t* commandAlloc = Allocate(static_cast<uint32_t>(commandId),
+                                             kMaxCommandAndPadding + dataSize, alignof(T));
+            if (!commandAlloc) {
                 return nullptr;
             }
+
+            // Give back the padding that wasn't needed so that the next id is where the iterator
+            // will look for it.
+            uint8_t* dataAlloc = AlignPtr(commandAlloc + sizeof(T), alignof(D));
+            mCurrentPtr = AlignPtr(dataAlloc + dataSize, alignof(uint32_t));
+
+            T* result = new (commandAlloc) T;
+            D* dataResult = reinterpret_cast<D*>(dataAlloc);
             for (size_t i = 0; i < count; i++) {
-                new (result + i) T;
+                new (dataResult + i) D;
             }
+            *data = dataResult;
             return result;
         }
 
+        // The number of commands allocated for each command id, used to keep the device counters.
+        // Ids greater than or equal to kMaxCountedCommandIds aren't counted.
+        static constexpr uint32_t kMaxCountedCommandIds = 64;
+        using CommandCounts = std::array<uint32_t, kMaxCountedCommandIds>;
+        const CommandCounts& GetCommandCounts() const;
+
       private:
         // This is used for some internal computations and can be any power of two as long as code
         // using the CommandAllocator passes the static_asserts.
@@ -222,6 +283,10 @@ namespace dawn_native {
                 uint8_t* commandAlloc = AlignPtr(mCurrentPtr + sizeof(uint32_t), commandAlignment);
                 mCurrentPtr = AlignPtr(commandAlloc + commandSize, alignof(uint32_t));
 
+                if (commandId < kMaxCountedCommandIds) {
+                    mCommandCounts[commandId]++;
+                }
+
                 return commandAlloc;
             }
             return AllocateInNewBlock(commandId, commandSize, commandAlignment);
@@ -231,10 +296,6 @@ namespace dawn_native {
                                     size_t commandSize,
                                     size_t commandAlignment);
 
-        DAWN_FORCE_INLINE uint8_t* AllocateData(size_t commandSize, size_t commandAlignment) {
-            return Allocate(detail::kAdditionalData, commandSize, commandAlignment);
-        }
-
         bool GetNewBlock(size_t minimumSize);
 
         CommandBlocks mBlocks;
@@ -250,6 +311,8 @@ namespace dawn_native {
         // there is not enough space and calls GetNewBlock. This avoids having to special case the
         // initialization in Allocate.
         uint32_t mDummyEnum[1] = {0};
+
+        CommandCounts mCommandCounts = {};
     };
 
 }  // namespace dawn_native
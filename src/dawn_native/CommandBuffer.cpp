@@ -18,15 +18,21 @@
 #include "dawn_native/Buffer.h"
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/Commands.h"
+#include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/Format.h"
 #include "dawn_native/Texture.h"
 
 namespace dawn_native {
 
-    CommandBufferBase::CommandBufferBase(CommandEncoder* encoder, const CommandBufferDescriptor*)
+    CommandBufferBase::CommandBufferBase(CommandEncoder* encoder,
+                                         const CommandBufferDescriptor* descriptor)
         : ObjectBase(encoder->GetDevice()),
           mCommands(encoder->AcquireCommands()),
-          mResourceUsages(encoder->AcquireResourceUsages()) {
+          mResourceUsages(encoder->AcquireResourceUsages()),
+          mReusable(descriptor != nullptr && descriptor->reusable) {
+        GetDevice()->GetCountersTracker()->RecordMemoryAllocated(
+            DeviceCountersTracker::Memory::Commands, mCommands.GetAllocatedBytes());
     }
 
     CommandBufferBase::CommandBufferBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -52,11 +58,18 @@ namespace dawn_native {
     }
 
     void CommandBufferBase::Destroy() {
+        // The commands are already freed if the command buffer was destroyed before.
+        GetDevice()->GetCountersTracker()->RecordMemoryFreed(
+            DeviceCountersTracker::Memory::Commands, mCommands.GetAllocatedBytes());
         FreeCommands(&mCommands);
         mResourceUsages = {};
         mDestroyed = true;
     }
 
+    bool CommandBufferBase::IsReusable() const {
+        return mReusable;
+    }
+
     const CommandBufferResourceUsage& CommandBufferBase::GetResourceUsages() const {
         return mResourceUsages;
     }
@@ -85,6 +98,21 @@ namespace dawn_native {
     }
 
     void LazyClearRenderPassAttachments(BeginRenderPassCmd* renderPass) {
+        // Undo the changes made when the render pass was recorded before, since the attachments
+        // might have been initialized since then.
+        for (ColorAttachmentIndex i : IterateBitSet(renderPass->lazyClearedColorAttachments)) {
+            renderPass->colorAttachments[i].loadOp = wgpu::LoadOp::Load;
+        }
+        renderPass->lazyClearedColorAttachments.reset();
+        if (renderPass->lazyClearedDepth) {
+            renderPass->depthStencilAttachment.depthLoadOp = wgpu::LoadOp::Load;
+            renderPass->lazyClearedDepth = false;
+        }
+        if (renderPass->lazyClearedStencil) {
+            renderPass->depthStencilAttachment.stencilLoadOp = wgpu::LoadOp::Load;
+            renderPass->lazyClearedStencil = false;
+        }
+
         for (ColorAttachmentIndex i :
              IterateBitSet(renderPass->attachmentState->GetColorAttachmentsMask())) {
             auto& attachmentInfo = renderPass->colorAttachments[i];
@@ -100,6 +128,7 @@ namespace dawn_native {
                 !view->GetTexture()->IsSubresourceContentInitialized(range)) {
                 attachmentInfo.loadOp = wgpu::LoadOp::Clear;
                 attachmentInfo.clearColor = {0.f, 0.f, 0.f, 0.f};
+                renderPass->lazyClearedColorAttachments.set(i);
             }
 
             if (hasResolveTarget) {
@@ -143,12 +172,14 @@ namespace dawn_native {
                 attachmentInfo.depthLoadOp == wgpu::LoadOp::Load) {
                 attachmentInfo.clearDepth = 0.0f;
                 attachmentInfo.depthLoadOp = wgpu::LoadOp::Clear;
+                renderPass->lazyClearedDepth = true;
             }
 
             if (!view->GetTexture()->IsSubresourceContentInitialized(stencilRange) &&
                 attachmentInfo.stencilLoadOp == wgpu::LoadOp::Load) {
                 attachmentInfo.clearStencil = 0u;
                 attachmentInfo.stencilLoadOp = wgpu::LoadOp::Clear;
+                renderPass->lazyClearedStencil = true;
             }
 
             view->GetTexture()->SetIsSubresourceContentInitialized(
@@ -39,6 +39,10 @@ namespace dawn_native {
         MaybeError ValidateCanUseInSubmitNow() const;
         void Destroy();
 
+        // Reusable command buffers aren't destroyed when submitted so that they can be submitted
+        // again without being re-encoded and re-validated.
+        bool IsReusable() const;
+
         const CommandBufferResourceUsage& GetResourceUsages() const;
 
       protected:
@@ -50,6 +54,7 @@ namespace dawn_native {
         CommandBufferBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
         CommandBufferResourceUsage mResourceUsages;
+        bool mReusable = false;
         bool mDestroyed = false;
     };
 
@@ -99,19 +99,17 @@ namespace dawn_native {
         ASSERT((aspects & ~kLazyAspects).none());
 
         if (aspects[VALIDATION_ASPECT_BIND_GROUPS]) {
-            bool matches = true;
+            const BindGroupLayoutMask& requiredBindGroups =
+                mLastPipelineLayout->GetBindGroupLayoutsMask();
 
-            for (BindGroupIndex i : IterateBitSet(mLastPipelineLayout->GetBindGroupLayoutsMask())) {
-                if (mBindgroups[i] == nullptr ||
-                    mLastPipelineLayout->GetBindGroupLayout(i) != mBindgroups[i]->GetLayout() ||
-                    !BufferSizesAtLeastAsBig(mBindgroups[i]->GetUnverifiedBufferSizes(),
-                                             (*mMinBufferSizes)[i])) {
-                    matches = false;
-                    break;
-                }
+            // Only re-check the groups that changed since they were last checked against the
+            // current pipeline. Groups unused by the layout stay dirty until they are needed.
+            for (BindGroupIndex i : IterateBitSet(mDirtyBindGroups & requiredBindGroups)) {
+                mCompatibleBindGroups.set(i, IsBindGroupCompatible(i));
             }
+            mDirtyBindGroups &= ~requiredBindGroups;
 
-            if (matches) {
+            if ((mCompatibleBindGroups & requiredBindGroups) == requiredBindGroups) {
                 mAspects.set(VALIDATION_ASPECT_BIND_GROUPS);
             }
         }
@@ -221,13 +219,20 @@ namespace dawn_native {
     }
 
     void CommandBufferStateTracker::SetBindGroup(BindGroupIndex index, BindGroupBase* bindgroup) {
+        // Setting the same bind group again doesn't change its compatibility with the pipeline.
+        if (mBindgroups[index] == bindgroup) {
+            return;
+        }
+
         mBindgroups[index] = bindgroup;
+        mDirtyBindGroups.set(index);
         mAspects.reset(VALIDATION_ASPECT_BIND_GROUPS);
     }
 
     void CommandBufferStateTracker::SetIndexBuffer(wgpu::IndexFormat format) {
         mIndexBufferSet = true;
         mIndexFormat = format;
+        mAspects.reset(VALIDATION_ASPECT_INDEX_BUFFER);
     }
 
     void CommandBufferStateTracker::SetVertexBuffer(VertexBufferSlot slot) {
@@ -235,8 +240,32 @@ namespace dawn_native {
     }
 
     void CommandBufferStateTracker::SetPipelineCommon(PipelineBase* pipeline) {
-        mLastPipelineLayout = pipeline->GetLayout();
-        mMinBufferSizes = &pipeline->GetMinBufferSizes();
+        // Setting the same pipeline again doesn't invalidate anything.
+        if (pipeline == mLastPipeline) {
+            return;
+        }
+
+        PipelineLayoutBase* layout = pipeline->GetLayout();
+        const RequiredBufferSizes* minBufferSizes = &pipeline->GetMinBufferSizes();
+
+        // Groups whose layout is inherited from the previous pipeline layout keep their cached
+        // compatibility, unless minimum buffer sizes are involved in the old or new pipeline.
+        BindGroupLayoutMask inheritedGroups;
+        if (mLastPipelineLayout == layout) {
+            inheritedGroups = layout->GetBindGroupLayoutsMask();
+        } else if (mLastPipelineLayout != nullptr) {
+            inheritedGroups = layout->InheritedGroupsMask(mLastPipelineLayout);
+        }
+        for (BindGroupIndex i : IterateBitSet(inheritedGroups)) {
+            if (!(*minBufferSizes)[i].empty() || !(*mMinBufferSizes)[i].empty()) {
+                inheritedGroups.reset(i);
+            }
+        }
+        mDirtyBindGroups |= ~inheritedGroups;
+
+        mLastPipeline = pipeline;
+        mLastPipelineLayout = layout;
+        mMinBufferSizes = minBufferSizes;
 
         mAspects.set(VALIDATION_ASPECT_PIPELINE);
 
@@ -244,4 +273,11 @@ namespace dawn_native {
         mAspects &= ~kLazyAspects;
     }
 
+    bool CommandBufferStateTracker::IsBindGroupCompatible(BindGroupIndex index) const {
+        return mBindgroups[index] != nullptr &&
+               mLastPipelineLayout->GetBindGroupLayout(index) == mBindgroups[index]->GetLayout() &&
+               BufferSizesAtLeastAsBig(mBindgroups[index]->GetUnverifiedBufferSizes(),
+                                       (*mMinBufferSizes)[index]);
+    }
+
 }  // namespace dawn_native
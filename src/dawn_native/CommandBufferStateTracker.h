@@ -51,13 +51,21 @@ namespace dawn_native {
 
         void SetPipelineCommon(PipelineBase* pipeline);
 
+        bool IsBindGroupCompatible(BindGroupIndex index) const;
+
         ValidationAspects mAspects;
 
         ityp::array<BindGroupIndex, BindGroupBase*, kMaxBindGroups> mBindgroups = {};
+        // Bind group compatibility with the current pipeline is computed incrementally: only the
+        // groups in |mDirtyBindGroups| are re-checked, and the result is cached in
+        // |mCompatibleBindGroups| so that unchanged groups aren't walked again on every draw.
+        ityp::bitset<BindGroupIndex, kMaxBindGroups> mDirtyBindGroups;
+        ityp::bitset<BindGroupIndex, kMaxBindGroups> mCompatibleBindGroups;
         ityp::bitset<VertexBufferSlot, kMaxVertexBuffers> mVertexBufferSlotsUsed;
         bool mIndexBufferSet = false;
         wgpu::IndexFormat mIndexFormat;
 
+        PipelineBase* mLastPipeline = nullptr;
         PipelineLayoutBase* mLastPipelineLayout = nullptr;
         RenderPipelineBase* mLastRenderPipeline = nullptr;
 
@@ -24,6 +24,7 @@
 #include "dawn_native/Commands.h"
 #include "dawn_native/ComputePassEncoder.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/ErrorData.h"
 #include "dawn_native/QuerySet.h"
 #include "dawn_native/RenderPassEncoder.h"
@@ -447,6 +448,79 @@ namespace dawn_native {
             return {};
         }
 
+        // Validates the commands outside of passes, and the passes with ValidateComputePass and
+        // ValidateRenderPass.
+        class TopLevelCommandValidator {
+          public:
+            TopLevelCommandValidator(CommandIterator* commands) : mCommands(commands) {
+            }
+
+            template <typename T, typename D>
+            MaybeError operator()(T*, D*) {
+                return DAWN_VALIDATION_ERROR("Command disallowed outside of a pass");
+            }
+
+            MaybeError operator()(BeginComputePassCmd*, CommandData<BeginComputePassCmd>::Type*) {
+                return ValidateComputePass(mCommands);
+            }
+
+            MaybeError operator()(BeginRenderPassCmd* cmd,
+                                  CommandData<BeginRenderPassCmd>::Type*) {
+                return ValidateRenderPass(mCommands, cmd);
+            }
+
+            MaybeError operator()(CopyBufferToBufferCmd*,
+                                  CommandData<CopyBufferToBufferCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError operator()(CopyBufferToTextureCmd*,
+                                  CommandData<CopyBufferToTextureCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError operator()(CopyTextureToBufferCmd*,
+                                  CommandData<CopyTextureToBufferCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError operator()(CopyTextureToTextureCmd*,
+                                  CommandData<CopyTextureToTextureCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError operator()(InsertDebugMarkerCmd*, char*) {
+                return {};
+            }
+
+            MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                DAWN_TRY(ValidateCanPopDebugGroup(mDebugGroupStackSize));
+                mDebugGroupStackSize--;
+                return {};
+            }
+
+            MaybeError operator()(PushDebugGroupCmd*, char*) {
+                mDebugGroupStackSize++;
+                return {};
+            }
+
+            MaybeError operator()(ResolveQuerySetCmd*, CommandData<ResolveQuerySetCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError operator()(WriteTimestampCmd*, CommandData<WriteTimestampCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError ValidateFinalState() const {
+                return ValidateFinalDebugGroupStackSize(mDebugGroupStackSize);
+            }
+
+          private:
+            CommandIterator* mCommands;
+            uint64_t mDebugGroupStackSize = 0;
+        };
+
     }  // namespace
 
     CommandEncoder::CommandEncoder(DeviceBase* device, const CommandEncoderDescriptor*)
@@ -801,12 +875,12 @@ namespace dawn_native {
 
     void CommandEncoder::InsertDebugMarker(const char* groupLabel) {
         mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
-            InsertDebugMarkerCmd* cmd =
-                allocator->Allocate<InsertDebugMarkerCmd>(Command::InsertDebugMarker);
-            cmd->length = strlen(groupLabel);
-
-            char* label = allocator->AllocateData<char>(cmd->length + 1);
-            memcpy(label, groupLabel, cmd->length + 1);
+            size_t length = strlen(groupLabel);
+            char* label;
+            InsertDebugMarkerCmd* cmd = allocator->AllocateWithData<InsertDebugMarkerCmd>(
+                Command::InsertDebugMarker, length + 1, &label);
+            cmd->length = length;
+            memcpy(label, groupLabel, length + 1);
 
             return {};
         });
@@ -822,12 +896,12 @@ namespace dawn_native {
 
     void CommandEncoder::PushDebugGroup(const char* groupLabel) {
         mEncodingContext.TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
-            PushDebugGroupCmd* cmd =
-                allocator->Allocate<PushDebugGroupCmd>(Command::PushDebugGroup);
-            cmd->length = strlen(groupLabel);
-
-            char* label = allocator->AllocateData<char>(cmd->length + 1);
-            memcpy(label, groupLabel, cmd->length + 1);
+            size_t length = strlen(groupLabel);
+            char* label;
+            PushDebugGroupCmd* cmd = allocator->AllocateWithData<PushDebugGroupCmd>(
+                Command::PushDebugGroup, length + 1, &label);
+            cmd->length = length;
+            memcpy(label, groupLabel, length + 1);
 
             return {};
         });
@@ -903,85 +977,22 @@ namespace dawn_native {
     MaybeError CommandEncoder::ValidateFinish(CommandIterator* commands,
                                               const PerPassUsages& perPassUsages) const {
         TRACE_EVENT0(GetDevice()->GetPlatform(), Validation, "CommandEncoder::ValidateFinish");
+        DeviceCountersTracker::ScopedTimer timer(GetDevice()->GetCountersTracker(),
+                                                 DeviceCountersTracker::Timer::ValidateFinish);
         DAWN_TRY(GetDevice()->ValidateObject(this));
 
         for (const PassResourceUsage& passUsage : perPassUsages) {
             DAWN_TRY(ValidatePassResourceUsage(passUsage));
         }
 
-        uint64_t debugGroupStackSize = 0;
-
         commands->Reset();
+        TopLevelCommandValidator validator(commands);
         Command type;
         while (commands->NextCommandId(&type)) {
-            switch (type) {
-                case Command::BeginComputePass: {
-                    commands->NextCommand<BeginComputePassCmd>();
-                    DAWN_TRY(ValidateComputePass(commands));
-                    break;
-                }
-
-                case Command::BeginRenderPass: {
-                    const BeginRenderPassCmd* cmd = commands->NextCommand<BeginRenderPassCmd>();
-                    DAWN_TRY(ValidateRenderPass(commands, cmd));
-                    break;
-                }
-
-                case Command::CopyBufferToBuffer: {
-                    commands->NextCommand<CopyBufferToBufferCmd>();
-                    break;
-                }
-
-                case Command::CopyBufferToTexture: {
-                    commands->NextCommand<CopyBufferToTextureCmd>();
-                    break;
-                }
-
-                case Command::CopyTextureToBuffer: {
-                    commands->NextCommand<CopyTextureToBufferCmd>();
-                    break;
-                }
-
-                case Command::CopyTextureToTexture: {
-                    commands->NextCommand<CopyTextureToTextureCmd>();
-                    break;
-                }
-
-                case Command::InsertDebugMarker: {
-                    const InsertDebugMarkerCmd* cmd = commands->NextCommand<InsertDebugMarkerCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    break;
-                }
-
-                case Command::PopDebugGroup: {
-                    commands->NextCommand<PopDebugGroupCmd>();
-                    DAWN_TRY(ValidateCanPopDebugGroup(debugGroupStackSize));
-                    debugGroupStackSize--;
-                    break;
-                }
-
-                case Command::PushDebugGroup: {
-                    const PushDebugGroupCmd* cmd = commands->NextCommand<PushDebugGroupCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    debugGroupStackSize++;
-                    break;
-                }
-
-                case Command::ResolveQuerySet: {
-                    commands->NextCommand<ResolveQuerySetCmd>();
-                    break;
-                }
-
-                case Command::WriteTimestamp: {
-                    commands->NextCommand<WriteTimestampCmd>();
-                    break;
-                }
-                default:
-                    return DAWN_VALIDATION_ERROR("Command disallowed outside of a pass");
-            }
+            DAWN_TRY(VisitCommand(commands, type, validator));
         }
 
-        DAWN_TRY(ValidateFinalDebugGroupStackSize(debugGroupStackSize));
+        DAWN_TRY(validator.ValidateFinalState());
 
         return {};
     }
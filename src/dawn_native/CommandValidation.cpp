@@ -29,96 +29,207 @@ namespace dawn_native {
 
     namespace {
 
-        inline MaybeError ValidateRenderBundleCommand(CommandIterator* commands,
-                                                      Command type,
-                                                      CommandBufferStateTracker* commandBufferState,
-                                                      const AttachmentState* attachmentState,
-                                                      uint64_t* debugGroupStackSize,
-                                                      const char* disallowedMessage) {
-            switch (type) {
-                case Command::Draw: {
-                    commands->NextCommand<DrawCmd>();
-                    DAWN_TRY(commandBufferState->ValidateCanDraw());
-                    break;
-                }
+        // Validates the commands of a render bundle. Each call of the visitor validates one
+        // command, and the commands that aren't allowed in the bundle produce |disallowedMessage|.
+        class RenderBundleCommandValidator {
+          public:
+            RenderBundleCommandValidator(const AttachmentState* attachmentState,
+                                         const char* disallowedMessage)
+                : mAttachmentState(attachmentState), mDisallowedMessage(disallowedMessage) {
+            }
 
-                case Command::DrawIndexed: {
-                    commands->NextCommand<DrawIndexedCmd>();
-                    DAWN_TRY(commandBufferState->ValidateCanDrawIndexed());
-                    break;
-                }
+            template <typename T, typename D>
+            MaybeError operator()(T*, D*) {
+                return DAWN_VALIDATION_ERROR(mDisallowedMessage);
+            }
 
-                case Command::DrawIndirect: {
-                    commands->NextCommand<DrawIndirectCmd>();
-                    DAWN_TRY(commandBufferState->ValidateCanDraw());
-                    break;
-                }
+            MaybeError operator()(DrawCmd*, CommandData<DrawCmd>::Type*) {
+                return mCommandBufferState.ValidateCanDraw();
+            }
 
-                case Command::DrawIndexedIndirect: {
-                    commands->NextCommand<DrawIndexedIndirectCmd>();
-                    DAWN_TRY(commandBufferState->ValidateCanDrawIndexed());
-                    break;
-                }
+            MaybeError operator()(DrawIndexedCmd*, CommandData<DrawIndexedCmd>::Type*) {
+                return mCommandBufferState.ValidateCanDrawIndexed();
+            }
 
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = commands->NextCommand<InsertDebugMarkerCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    break;
-                }
+            MaybeError operator()(DrawIndirectCmd*, CommandData<DrawIndirectCmd>::Type*) {
+                return mCommandBufferState.ValidateCanDraw();
+            }
 
-                case Command::PopDebugGroup: {
-                    commands->NextCommand<PopDebugGroupCmd>();
-                    DAWN_TRY(ValidateCanPopDebugGroup(*debugGroupStackSize));
-                    *debugGroupStackSize -= 1;
-                    break;
-                }
+            MaybeError operator()(DrawIndexedIndirectCmd*,
+                                  CommandData<DrawIndexedIndirectCmd>::Type*) {
+                return mCommandBufferState.ValidateCanDrawIndexed();
+            }
 
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = commands->NextCommand<PushDebugGroupCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    *debugGroupStackSize += 1;
-                    break;
-                }
+            MaybeError operator()(MultiDrawCmd*, DrawCmd*) {
+                return mCommandBufferState.ValidateCanDraw();
+            }
 
-                case Command::SetRenderPipeline: {
-                    SetRenderPipelineCmd* cmd = commands->NextCommand<SetRenderPipelineCmd>();
-                    RenderPipelineBase* pipeline = cmd->pipeline.Get();
+            MaybeError operator()(MultiDrawIndexedCmd*, DrawIndexedCmd*) {
+                return mCommandBufferState.ValidateCanDrawIndexed();
+            }
 
-                    if (DAWN_UNLIKELY(pipeline->GetAttachmentState() != attachmentState)) {
-                        return DAWN_VALIDATION_ERROR("Pipeline attachment state is not compatible");
-                    }
-                    commandBufferState->SetRenderPipeline(pipeline);
-                    break;
-                }
+            MaybeError operator()(InsertDebugMarkerCmd*, char*) {
+                return {};
+            }
 
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = commands->NextCommand<SetBindGroupCmd>();
-                    if (cmd->dynamicOffsetCount > 0) {
-                        commands->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+            MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                DAWN_TRY(ValidateCanPopDebugGroup(mDebugGroupStackSize));
+                mDebugGroupStackSize--;
+                return {};
+            }
 
-                    commandBufferState->SetBindGroup(cmd->index, cmd->group.Get());
-                    break;
+            MaybeError operator()(PushDebugGroupCmd*, char*) {
+                mDebugGroupStackSize++;
+                return {};
+            }
+
+            MaybeError operator()(SetRenderPipelineCmd* cmd,
+                                  CommandData<SetRenderPipelineCmd>::Type*) {
+                RenderPipelineBase* pipeline = cmd->pipeline.Get();
+
+                if (DAWN_UNLIKELY(pipeline->GetAttachmentState() != mAttachmentState)) {
+                    return DAWN_VALIDATION_ERROR("Pipeline attachment state is not compatible");
                 }
+                mCommandBufferState.SetRenderPipeline(pipeline);
+                return {};
+            }
 
-                case Command::SetIndexBuffer: {
-                    SetIndexBufferCmd* cmd = commands->NextCommand<SetIndexBufferCmd>();
-                    commandBufferState->SetIndexBuffer(cmd->format);
-                    break;
+            MaybeError operator()(SetBindGroupCmd* cmd, uint32_t*) {
+                mCommandBufferState.SetBindGroup(cmd->index, cmd->group.Get());
+                return {};
+            }
+
+            MaybeError operator()(SetIndexBufferCmd* cmd, CommandData<SetIndexBufferCmd>::Type*) {
+                mCommandBufferState.SetIndexBuffer(cmd->format);
+                return {};
+            }
+
+            MaybeError operator()(SetVertexBufferCmd* cmd,
+                                  CommandData<SetVertexBufferCmd>::Type*) {
+                mCommandBufferState.SetVertexBuffer(cmd->slot);
+                return {};
+            }
+
+            MaybeError ValidateFinalState() const {
+                return ValidateFinalDebugGroupStackSize(mDebugGroupStackSize);
+            }
+
+          protected:
+            CommandBufferStateTracker mCommandBufferState;
+            uint64_t mDebugGroupStackSize = 0;
+
+          private:
+            const AttachmentState* mAttachmentState;
+            const char* mDisallowedMessage;
+        };
+
+        // Validates the commands of a render pass, which are the commands allowed in render
+        // bundles and the commands below. EndRenderPass is handled by the caller.
+        class RenderPassCommandValidator : public RenderBundleCommandValidator {
+          public:
+            RenderPassCommandValidator(const BeginRenderPassCmd* renderPass)
+                : RenderBundleCommandValidator(renderPass->attachmentState.Get(),
+                                               "Command disallowed inside a render pass"),
+                  mRenderPass(renderPass) {
+            }
+
+            using RenderBundleCommandValidator::operator();
+
+            MaybeError operator()(ExecuteBundlesCmd* cmd, Ref<RenderBundleBase>* bundles) {
+                for (uint32_t i = 0; i < cmd->count; ++i) {
+                    if (DAWN_UNLIKELY(mRenderPass->attachmentState.Get() !=
+                                      bundles[i]->GetAttachmentState())) {
+                        return DAWN_VALIDATION_ERROR(
+                            "Render bundle is not compatible with render pass");
+                    }
                 }
 
-                case Command::SetVertexBuffer: {
-                    SetVertexBufferCmd* cmd = commands->NextCommand<SetVertexBufferCmd>();
-                    commandBufferState->SetVertexBuffer(cmd->slot);
-                    break;
+                if (cmd->count > 0) {
+                    // Reset state. It is invalidated after render bundle execution.
+                    mCommandBufferState = CommandBufferStateTracker{};
                 }
+                return {};
+            }
 
-                default:
-                    return DAWN_VALIDATION_ERROR(disallowedMessage);
+            MaybeError operator()(SetStencilReferenceCmd*,
+                                  CommandData<SetStencilReferenceCmd>::Type*) {
+                return {};
             }
 
-            return {};
-        }
+            MaybeError operator()(SetBlendColorCmd*, CommandData<SetBlendColorCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError operator()(SetViewportCmd*, CommandData<SetViewportCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError operator()(SetScissorRectCmd*, CommandData<SetScissorRectCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError operator()(WriteTimestampCmd*, CommandData<WriteTimestampCmd>::Type*) {
+                return {};
+            }
+
+          private:
+            const BeginRenderPassCmd* mRenderPass;
+        };
+
+        // Validates the commands of a compute pass. EndComputePass is handled by the caller.
+        class ComputePassCommandValidator {
+          public:
+            template <typename T, typename D>
+            MaybeError operator()(T*, D*) {
+                return DAWN_VALIDATION_ERROR("Command disallowed inside a compute pass");
+            }
+
+            MaybeError operator()(DispatchCmd*, CommandData<DispatchCmd>::Type*) {
+                return mCommandBufferState.ValidateCanDispatch();
+            }
+
+            MaybeError operator()(DispatchIndirectCmd*, CommandData<DispatchIndirectCmd>::Type*) {
+                return mCommandBufferState.ValidateCanDispatch();
+            }
+
+            MaybeError operator()(InsertDebugMarkerCmd*, char*) {
+                return {};
+            }
+
+            MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                DAWN_TRY(ValidateCanPopDebugGroup(mDebugGroupStackSize));
+                mDebugGroupStackSize--;
+                return {};
+            }
+
+            MaybeError operator()(PushDebugGroupCmd*, char*) {
+                mDebugGroupStackSize++;
+                return {};
+            }
+
+            MaybeError operator()(SetComputePipelineCmd* cmd,
+                                  CommandData<SetComputePipelineCmd>::Type*) {
+                mCommandBufferState.SetComputePipeline(cmd->pipeline.Get());
+                return {};
+            }
+
+            MaybeError operator()(SetBindGroupCmd* cmd, uint32_t*) {
+                mCommandBufferState.SetBindGroup(cmd->index, cmd->group.Get());
+                return {};
+            }
+
+            MaybeError operator()(WriteTimestampCmd*, CommandData<WriteTimestampCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError ValidateFinalState() const {
+                return ValidateFinalDebugGroupStackSize(mDebugGroupStackSize);
+            }
+
+          private:
+            CommandBufferStateTracker mCommandBufferState;
+            uint64_t mDebugGroupStackSize = 0;
+        };
 
     }  // namespace
 
@@ -138,82 +249,29 @@ namespace dawn_native {
 
     MaybeError ValidateRenderBundle(CommandIterator* commands,
                                     const AttachmentState* attachmentState) {
-        CommandBufferStateTracker commandBufferState;
-        uint64_t debugGroupStackSize = 0;
+        RenderBundleCommandValidator validator(attachmentState,
+                                               "Command disallowed inside a render bundle");
 
         Command type;
         while (commands->NextCommandId(&type)) {
-            DAWN_TRY(ValidateRenderBundleCommand(commands, type, &commandBufferState,
-                                                 attachmentState, &debugGroupStackSize,
-                                                 "Command disallowed inside a render bundle"));
+            DAWN_TRY(VisitCommand(commands, type, validator));
         }
 
-        DAWN_TRY(ValidateFinalDebugGroupStackSize(debugGroupStackSize));
+        DAWN_TRY(validator.ValidateFinalState());
         return {};
     }
 
     MaybeError ValidateRenderPass(CommandIterator* commands, const BeginRenderPassCmd* renderPass) {
-        CommandBufferStateTracker commandBufferState;
-        uint64_t debugGroupStackSize = 0;
+        RenderPassCommandValidator validator(renderPass);
 
         Command type;
         while (commands->NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndRenderPass: {
-                    commands->NextCommand<EndRenderPassCmd>();
-                    DAWN_TRY(ValidateFinalDebugGroupStackSize(debugGroupStackSize));
-                    return {};
-                }
-
-                case Command::ExecuteBundles: {
-                    ExecuteBundlesCmd* cmd = commands->NextCommand<ExecuteBundlesCmd>();
-                    auto bundles = commands->NextData<Ref<RenderBundleBase>>(cmd->count);
-                    for (uint32_t i = 0; i < cmd->count; ++i) {
-                        if (DAWN_UNLIKELY(renderPass->attachmentState.Get() !=
-                                          bundles[i]->GetAttachmentState())) {
-                            return DAWN_VALIDATION_ERROR(
-                                "Render bundle is not compatible with render pass");
-                        }
-                    }
-
-                    if (cmd->count > 0) {
-                        // Reset state. It is invalidated after render bundle execution.
-                        commandBufferState = CommandBufferStateTracker{};
-                    }
-
-                    break;
-                }
-
-                case Command::SetStencilReference: {
-                    commands->NextCommand<SetStencilReferenceCmd>();
-                    break;
-                }
-
-                case Command::SetBlendColor: {
-                    commands->NextCommand<SetBlendColorCmd>();
-                    break;
-                }
-
-                case Command::SetViewport: {
-                    commands->NextCommand<SetViewportCmd>();
-                    break;
-                }
-
-                case Command::SetScissorRect: {
-                    commands->NextCommand<SetScissorRectCmd>();
-                    break;
-                }
-
-                case Command::WriteTimestamp: {
-                    commands->NextCommand<WriteTimestampCmd>();
-                    break;
-                }
-
-                default:
-                    DAWN_TRY(ValidateRenderBundleCommand(
-                        commands, type, &commandBufferState, renderPass->attachmentState.Get(),
-                        &debugGroupStackSize, "Command disallowed inside a render pass"));
+            if (type == Command::EndRenderPass) {
+                commands->NextCommand<EndRenderPassCmd>();
+                DAWN_TRY(validator.ValidateFinalState());
+                return {};
             }
+            DAWN_TRY(VisitCommand(commands, type, validator));
         }
 
         UNREACHABLE();
@@ -221,74 +279,16 @@ namespace dawn_native {
     }
 
     MaybeError ValidateComputePass(CommandIterator* commands) {
-        CommandBufferStateTracker commandBufferState;
-        uint64_t debugGroupStackSize = 0;
+        ComputePassCommandValidator validator;
 
         Command type;
         while (commands->NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndComputePass: {
-                    commands->NextCommand<EndComputePassCmd>();
-                    DAWN_TRY(ValidateFinalDebugGroupStackSize(debugGroupStackSize));
-                    return {};
-                }
-
-                case Command::Dispatch: {
-                    commands->NextCommand<DispatchCmd>();
-                    DAWN_TRY(commandBufferState.ValidateCanDispatch());
-                    break;
-                }
-
-                case Command::DispatchIndirect: {
-                    commands->NextCommand<DispatchIndirectCmd>();
-                    DAWN_TRY(commandBufferState.ValidateCanDispatch());
-                    break;
-                }
-
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = commands->NextCommand<InsertDebugMarkerCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    break;
-                }
-
-                case Command::PopDebugGroup: {
-                    commands->NextCommand<PopDebugGroupCmd>();
-                    DAWN_TRY(ValidateCanPopDebugGroup(debugGroupStackSize));
-                    debugGroupStackSize--;
-                    break;
-                }
-
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = commands->NextCommand<PushDebugGroupCmd>();
-                    commands->NextData<char>(cmd->length + 1);
-                    debugGroupStackSize++;
-                    break;
-                }
-
-                case Command::SetComputePipeline: {
-                    SetComputePipelineCmd* cmd = commands->NextCommand<SetComputePipelineCmd>();
-                    ComputePipelineBase* pipeline = cmd->pipeline.Get();
-                    commandBufferState.SetComputePipeline(pipeline);
-                    break;
-                }
-
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = commands->NextCommand<SetBindGroupCmd>();
-                    if (cmd->dynamicOffsetCount > 0) {
-                        commands->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
-                    commandBufferState.SetBindGroup(cmd->index, cmd->group.Get());
-                    break;
-                }
-
-                case Command::WriteTimestamp: {
-                    commands->NextCommand<WriteTimestampCmd>();
-                    break;
-                }
-
-                default:
-                    return DAWN_VALIDATION_ERROR("Command disallowed inside a compute pass");
+            if (type == Command::EndComputePass) {
+                commands->NextCommand<EndComputePassCmd>();
+                DAWN_TRY(validator.ValidateFinalState());
+                return {};
             }
+            DAWN_TRY(VisitCommand(commands, type, validator));
         }
 
         UNREACHABLE();
@@ -19,12 +19,14 @@
 
 #include "dawn_native/AttachmentState.h"
 #include "dawn_native/BindingInfo.h"
+#include "dawn_native/CommandAllocator.h"
 #include "dawn_native/Texture.h"
 
 #include "dawn_native/dawn_platform.h"
 
 #include <array>
 #include <bitset>
+#include <utility>
 
 namespace dawn_native {
 
@@ -32,36 +34,45 @@ namespace dawn_native {
     // CommandBufferBuilder. There are not defined in CommandBuffer.h to break some header
     // dependencies: Ref<Object> needs Object to be defined.
 
+    // The list of all the commands, used to generate the code that handles each of them. Each
+    // command Name is encoded as Command::Name followed by a NameCmd structure.
+#define DAWN_FOREACH_COMMAND(X) \
+    X(BeginComputePass)         \
+    X(BeginRenderPass)          \
+    X(CopyBufferToBuffer)       \
+    X(CopyBufferToTexture)      \
+    X(CopyTextureToBuffer)      \
+    X(CopyTextureToTexture)     \
+    X(Dispatch)                 \
+    X(DispatchIndirect)         \
+    X(Draw)                     \
+    X(DrawIndexed)              \
+    X(DrawIndirect)             \
+    X(DrawIndexedIndirect)      \
+    X(EndComputePass)           \
+    X(EndRenderPass)            \
+    X(ExecuteBundles)           \
+    X(InsertDebugMarker)        \
+    X(MultiDraw)                \
+    X(MultiDrawIndexed)         \
+    X(PopDebugGroup)            \
+    X(PushDebugGroup)           \
+    X(ResolveQuerySet)          \
+    X(SetComputePipeline)       \
+    X(SetRenderPipeline)        \
+    X(SetStencilReference)      \
+    X(SetViewport)              \
+    X(SetScissorRect)           \
+    X(SetBlendColor)            \
+    X(SetBindGroup)             \
+    X(SetIndexBuffer)           \
+    X(SetVertexBuffer)          \
+    X(WriteTimestamp)
+
     enum class Command {
-        BeginComputePass,
-        BeginRenderPass,
-        CopyBufferToBuffer,
-        CopyBufferToTexture,
-        CopyTextureToBuffer,
-        CopyTextureToTexture,
-        Dispatch,
-        DispatchIndirect,
-        Draw,
-        DrawIndexed,
-        DrawIndirect,
-        DrawIndexedIndirect,
-        EndComputePass,
-        EndRenderPass,
-        ExecuteBundles,
-        InsertDebugMarker,
-        PopDebugGroup,
-        PushDebugGroup,
-        ResolveQuerySet,
-        SetComputePipeline,
-        SetRenderPipeline,
-        SetStencilReference,
-        SetViewport,
-        SetScissorRect,
-        SetBlendColor,
-        SetBindGroup,
-        SetIndexBuffer,
-        SetVertexBuffer,
-        WriteTimestamp,
+#define DAWN_COMMAND_ENUM(Name) Name,
+        DAWN_FOREACH_COMMAND(DAWN_COMMAND_ENUM)
+#undef DAWN_COMMAND_ENUM
     };
 
     struct BeginComputePassCmd {};
@@ -93,6 +104,13 @@ namespace dawn_native {
         // Cache the width and height of all attachments for convenience
         uint32_t width;
         uint32_t height;
+
+        // The attachments for which LazyClearRenderPassAttachments replaced the Load operation
+        // with Clear. They are restored to Load when a reusable command buffer records the render
+        // pass again.
+        ityp::bitset<ColorAttachmentIndex, kMaxColorAttachments> lazyClearedColorAttachments;
+        bool lazyClearedDepth = false;
+        bool lazyClearedStencil = false;
     };
 
     struct BufferCopy {
@@ -183,6 +201,16 @@ namespace dawn_native {
         uint32_t length;
     };
 
+    // The draws are stored as |drawCount| DrawCmd in the data following the command.
+    struct MultiDrawCmd {
+        uint32_t drawCount;
+    };
+
+    // The draws are stored as |drawCount| DrawIndexedCmd in the data following the command.
+    struct MultiDrawIndexedCmd {
+        uint32_t drawCount;
+    };
+
     struct PopDebugGroupCmd {};
 
     struct PushDebugGroupCmd {
@@ -246,9 +274,95 @@ namespace dawn_native {
         uint32_t queryIndex;
     };
 
+    // The type and number of elements of the data stored after a command. Most commands don't
+    // have any, and those that do are declared below.
+    template <typename T>
+    struct CommandData {
+        struct None {};
+        using Type = None;
+        static size_t Count(const T&) {
+            return 0;
+        }
+    };
+
+    template <>
+    struct CommandData<ExecuteBundlesCmd> {
+        using Type = Ref<RenderBundleBase>;
+        static size_t Count(const ExecuteBundlesCmd& cmd) {
+            return cmd.count;
+        }
+    };
+
+    template <>
+    struct CommandData<InsertDebugMarkerCmd> {
+        using Type = char;
+        static size_t Count(const InsertDebugMarkerCmd& cmd) {
+            return cmd.length + 1;
+        }
+    };
+
+    template <>
+    struct CommandData<MultiDrawCmd> {
+        using Type = DrawCmd;
+        static size_t Count(const MultiDrawCmd& cmd) {
+            return cmd.drawCount;
+        }
+    };
+
+    template <>
+    struct CommandData<MultiDrawIndexedCmd> {
+        using Type = DrawIndexedCmd;
+        static size_t Count(const MultiDrawIndexedCmd& cmd) {
+            return cmd.drawCount;
+        }
+    };
+
+    template <>
+    struct CommandData<PushDebugGroupCmd> {
+        using Type = char;
+        static size_t Count(const PushDebugGroupCmd& cmd) {
+            return cmd.length + 1;
+        }
+    };
+
+    template <>
+    struct CommandData<SetBindGroupCmd> {
+        using Type = uint32_t;
+        static size_t Count(const SetBindGroupCmd& cmd) {
+            return cmd.dynamicOffsetCount;
+        }
+    };
+
+    // The type returned by the calls of |Visitor|, which must be the same for all the commands.
+    template <typename Visitor>
+    using CommandVisitorResult =
+        decltype(std::declval<Visitor>()(std::declval<EndRenderPassCmd*>(),
+                                         std::declval<CommandData<EndRenderPassCmd>::Type*>()));
+
+    // Reads the command of type |type| and its data from |commands|, calls
+    // visitor(T* cmd, CommandData<T>::Type* data) with them and returns the result of the call.
+    // The switch is generated from DAWN_FOREACH_COMMAND so that the code handling all the
+    // commands can't miss one.
+    template <typename Visitor>
+    DAWN_FORCE_INLINE CommandVisitorResult<Visitor> VisitCommand(CommandIterator* commands,
+                                                                 Command type,
+                                                                 Visitor&& visitor) {
+        switch (type) {
+#define DAWN_VISIT_COMMAND(Name)                                                         \
+    case Command::Name: {                                                                \
+        Name##Cmd* cmd = commands->NextCommand<Name##Cmd>();                             \
+        using Data = CommandData<Name##Cmd>;                                             \
+        return visitor(cmd, commands->NextData<typename Data::Type>(Data::Count(*cmd))); \
+    }
+            DAWN_FOREACH_COMMAND(DAWN_VISIT_COMMAND)
+#undef DAWN_VISIT_COMMAND
+        }
+        UNREACHABLE();
+        return CommandVisitorResult<Visitor>();
+    }
+
     // This needs to be called before the CommandIterator is freed so that the Ref<> present in
     // the commands have a chance to run their destructor and remove internal references.
-    class CommandIterator;
     void FreeCommands(CommandIterator* commands);
 
     // Helper function to allow skipping over a command when it is unimplemented, while still
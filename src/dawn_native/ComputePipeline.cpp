@@ -16,6 +16,7 @@
 
 #include "common/HashUtils.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 
 namespace dawn_native {
 
@@ -41,6 +42,8 @@ namespace dawn_native {
         : PipelineBase(device,
                        descriptor->layout,
                        {{SingleShaderStage::Compute, &descriptor->computeStage}}) {
+        device->GetCountersTracker()->RecordObjectCreated(
+            DeviceCountersTracker::LiveObject::ComputePipeline);
     }
 
     ComputePipelineBase::ComputePipelineBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -48,6 +51,10 @@ namespace dawn_native {
     }
 
     ComputePipelineBase::~ComputePipelineBase() {
+        if (!IsError()) {
+            GetDevice()->GetCountersTracker()->RecordObjectDestroyed(
+                DeviceCountersTracker::LiveObject::ComputePipeline);
+        }
         // Do not uncache the actual cached object if we are a blueprint
         if (IsCachedReference()) {
             GetDevice()->UncacheComputePipeline(this);
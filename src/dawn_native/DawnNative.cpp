@@ -176,6 +176,16 @@ namespace dawn_native {
         return deviceBase->GetDeprecationWarningCountForTesting();
     }
 
+    DeviceCounters GetDeviceCounters(WGPUDevice device) {
+        dawn_native::DeviceBase* deviceBase = reinterpret_cast<dawn_native::DeviceBase*>(device);
+        return deviceBase->GetCounters();
+    }
+
+    DeviceMemoryUsage GetDeviceMemoryUsage(WGPUDevice device) {
+        dawn_native::DeviceBase* deviceBase = reinterpret_cast<dawn_native::DeviceBase*>(device);
+        return deviceBase->GetMemoryUsage();
+    }
+
     bool IsTextureSubresourceInitialized(WGPUTexture texture,
                                          uint32_t baseMipLevel,
                                          uint32_t levelCount,
@@ -201,6 +211,11 @@ namespace dawn_native {
         return deviceBase->Tick();
     }
 
+    WGPUQueue CreateAdditionalQueue(WGPUDevice device, QueueType type) {
+        dawn_native::DeviceBase* deviceBase = reinterpret_cast<dawn_native::DeviceBase*>(device);
+        return reinterpret_cast<WGPUQueue>(deviceBase->CreateAdditionalQueue(type));
+    }
+
     // ExternalImageDescriptor
 
     ExternalImageDescriptor::ExternalImageDescriptor(ExternalImageType type) : type(type) {
@@ -24,6 +24,7 @@
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/ComputePipeline.h"
 #include "dawn_native/CreateReadyPipelineTracker.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/DynamicUploader.h"
 #include "dawn_native/ErrorData.h"
 #include "dawn_native/ErrorScope.h"
@@ -36,16 +37,29 @@
 #include "dawn_native/RenderBundleEncoder.h"
 #include "dawn_native/RenderPipeline.h"
 #include "dawn_native/Sampler.h"
+#include "dawn_native/ScratchBufferAllocator.h"
 #include "dawn_native/ShaderModule.h"
 #include "dawn_native/Surface.h"
 #include "dawn_native/SwapChain.h"
 #include "dawn_native/Texture.h"
 #include "dawn_native/ValidationUtils_autogen.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "dawn_platform/tracing/TraceEvent.h"
 
 #include <unordered_set>
 
 namespace dawn_native {
 
+    namespace {
+
+        // The head of DeviceBase::mDeferredDeletions while objects are deleted immediately. It is
+        // never the address of an object.
+        char sNotDeferringObjectDeletion;
+        ObjectBase* const kNotDeferringObjectDeletion =
+            reinterpret_cast<ObjectBase*>(&sNotDeferringObjectDeletion);
+
+    }  // anonymous namespace
+
     // DeviceBase sub-structures
 
     // The caches are unordered_sets of pointers with special hash and compare functions
@@ -82,7 +96,9 @@ namespace dawn_native {
     // DeviceBase
 
     DeviceBase::DeviceBase(AdapterBase* adapter, const DeviceDescriptor* descriptor)
-        : mAdapter(adapter) {
+        : mAdapter(adapter),
+          mCountersTracker(std::make_unique<DeviceCountersTracker>()),
+          mDeferredDeletions(kNotDeferringObjectDeletion) {
         if (descriptor != nullptr) {
             ApplyToggleOverrides(descriptor);
             ApplyExtensions(descriptor);
@@ -103,6 +119,7 @@ namespace dawn_native {
         mCaches = std::make_unique<DeviceBase::Caches>();
         mErrorScopeTracker = std::make_unique<ErrorScopeTracker>(this);
         mDynamicUploader = std::make_unique<DynamicUploader>(this);
+        mScratchBufferAllocator = std::make_unique<ScratchBufferAllocator>(this);
         mCreateReadyPipelineTracker = std::make_unique<CreateReadyPipelineTracker>(this);
         mDeprecationWarnings = std::make_unique<DeprecationWarnings>();
 
@@ -110,12 +127,27 @@ namespace dawn_native {
         // alive.
         mState = State::Alive;
 
+        // The backends can only change toggles before calling Initialize.
+        if (IsToggleEnabled(Toggle::DeferObjectDestruction)) {
+            mDeferredDeletions.store(nullptr, std::memory_order_relaxed);
+        }
+
         DAWN_TRY_ASSIGN(mEmptyBindGroupLayout, CreateEmptyBindGroupLayout());
 
         return {};
     }
 
     void DeviceBase::ShutDownBase() {
+        // Objects released from now on are deleted immediately, while the device can still
+        // handle their destruction. The deferred objects are taken in the same exchange that stops
+        // the deferral, so an object released concurrently is either taken here or deleted by the
+        // thread releasing it.
+        ObjectBase* deferredObjects =
+            mDeferredDeletions.exchange(kNotDeferringObjectDeletion, std::memory_order_acquire);
+        if (deferredObjects != kNotDeferringObjectDeletion) {
+            DeleteDeferredObjectList(deferredObjects);
+        }
+
         // Disconnect the device, depending on which state we are currently in.
         switch (mState) {
             case State::BeingCreated:
@@ -151,6 +183,9 @@ namespace dawn_native {
             // pending callbacks.
             mErrorScopeTracker->Tick(GetCompletedCommandSerial());
             GetDefaultQueue()->Tick(GetCompletedCommandSerial());
+            for (Ref<QueueBase>& queue : mAdditionalQueues) {
+                queue->Tick(GetCompletedCommandSerial());
+            }
             mCreateReadyPipelineTracker->Tick(GetCompletedCommandSerial());
 
             // call TickImpl once last time to clean up resources
@@ -167,6 +202,7 @@ namespace dawn_native {
         }
         mErrorScopeTracker = nullptr;
         mDynamicUploader = nullptr;
+        mScratchBufferAllocator = nullptr;
         mCreateReadyPipelineTracker = nullptr;
 
         mEmptyBindGroupLayout = nullptr;
@@ -179,6 +215,11 @@ namespace dawn_native {
     }
 
     void DeviceBase::HandleError(InternalErrorType type, const char* message) {
+        LazyErrorMessage lazyMessage(message);
+        HandleErrorImpl(type, &lazyMessage);
+    }
+
+    void DeviceBase::HandleErrorImpl(InternalErrorType type, LazyErrorMessage* message) {
         // If we receive an internal error, assume the backend can't recover and proceed with
         // device destruction. We first wait for all previous commands to be completed so that
         // backend objects can be freed immediately, before handling the loss.
@@ -203,7 +244,7 @@ namespace dawn_native {
 
         // The device was lost, call the application callback.
         if (type == InternalErrorType::DeviceLost && mDeviceLostCallback != nullptr) {
-            mDeviceLostCallback(message, mDeviceLostUserdata);
+            mDeviceLostCallback(message->Get(), mDeviceLostUserdata);
             mDeviceLostCallback = nullptr;
         }
 
@@ -229,13 +270,8 @@ namespace dawn_native {
 
     void DeviceBase::ConsumeError(std::unique_ptr<ErrorData> error) {
         ASSERT(error != nullptr);
-        std::ostringstream ss;
-        ss << error->GetMessage();
-        for (const auto& callsite : error->GetBacktrace()) {
-            ss << "\n    at " << callsite.function << " (" << callsite.file << ":" << callsite.line
-               << ")";
-        }
-        HandleError(error->GetType(), ss.str().c_str());
+        LazyErrorMessage message(error.get());
+        HandleErrorImpl(error->GetType(), &message);
     }
 
     void DeviceBase::SetUncapturedErrorCallback(wgpu::ErrorCallback callback, void* userdata) {
@@ -316,6 +352,49 @@ namespace dawn_native {
         return mErrorScopeTracker.get();
     }
 
+    DeviceCountersTracker* DeviceBase::GetCountersTracker() const {
+        return mCountersTracker.get();
+    }
+
+    DeviceCounters DeviceBase::GetCounters() const {
+        DeviceCounters counters = mCountersTracker->GetSnapshot();
+        if (mState == State::Alive) {
+            ReportBackendCounters(&counters);
+        }
+        return counters;
+    }
+
+    DeviceMemoryUsage DeviceBase::GetMemoryUsage() const {
+        DeviceMemoryUsage usage = mCountersTracker->GetMemoryUsageSnapshot();
+
+        if (mCaches != nullptr) {
+            for (const BindGroupLayoutBase* layout : mCaches->bindGroupLayouts) {
+                usage.bindGroupAllocatorBytes += layout->GetBindGroupAllocatorBytes();
+            }
+            for (const ShaderModuleBase* module : mCaches->shaderModules) {
+                usage.shaderModuleBytes += module->GetCodeByteSize();
+            }
+        }
+
+        if (mDynamicUploader != nullptr) {
+            mDynamicUploader->ReportMemoryUsage(&usage);
+        }
+        if (mScratchBufferAllocator != nullptr) {
+            mScratchBufferAllocator->ReportMemoryUsage(&usage);
+        }
+
+        if (mState == State::Alive) {
+            ReportBackendMemoryUsage(&usage);
+        }
+        return usage;
+    }
+
+    void DeviceBase::ReportBackendMemoryUsage(DeviceMemoryUsage* usage) const {
+    }
+
+    void DeviceBase::ReportBackendCounters(DeviceCounters* counters) const {
+    }
+
     ExecutionSerial DeviceBase::GetCompletedCommandSerial() const {
         return mCompletedSerial;
     }
@@ -393,12 +472,19 @@ namespace dawn_native {
 
     ResultOrError<Ref<BindGroupLayoutBase>> DeviceBase::GetOrCreateBindGroupLayout(
         const BindGroupLayoutDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::GetOrCreateBindGroupLayout");
         BindGroupLayoutBase blueprint(this, descriptor);
 
         Ref<BindGroupLayoutBase> result = nullptr;
         auto iter = mCaches->bindGroupLayouts.find(&blueprint);
-        if (iter != mCaches->bindGroupLayouts.end()) {
-            result = *iter;
+        if (iter != mCaches->bindGroupLayouts.end() && !ReferenceCachedObject(*iter)) {
+            mCaches->bindGroupLayouts.erase(iter);
+            iter = mCaches->bindGroupLayouts.end();
+        }
+        bool hit = iter != mCaches->bindGroupLayouts.end();
+        mCountersTracker->RecordCacheLookup(DeviceCountersTracker::Cache::BindGroupLayout, hit);
+        if (hit) {
+            result = AcquireRef(*iter);
         } else {
             BindGroupLayoutBase* backendObj;
             DAWN_TRY_ASSIGN(backendObj, CreateBindGroupLayoutImpl(descriptor));
@@ -431,11 +517,17 @@ namespace dawn_native {
 
     ResultOrError<ComputePipelineBase*> DeviceBase::GetOrCreateComputePipeline(
         const ComputePipelineDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::GetOrCreateComputePipeline");
         ComputePipelineBase blueprint(this, descriptor);
 
         auto iter = mCaches->computePipelines.find(&blueprint);
-        if (iter != mCaches->computePipelines.end()) {
-            (*iter)->Reference();
+        if (iter != mCaches->computePipelines.end() && !ReferenceCachedObject(*iter)) {
+            mCaches->computePipelines.erase(iter);
+            iter = mCaches->computePipelines.end();
+        }
+        bool hit = iter != mCaches->computePipelines.end();
+        mCountersTracker->RecordCacheLookup(DeviceCountersTracker::Cache::ComputePipeline, hit);
+        if (hit) {
             return *iter;
         }
 
@@ -454,11 +546,17 @@ namespace dawn_native {
 
     ResultOrError<PipelineLayoutBase*> DeviceBase::GetOrCreatePipelineLayout(
         const PipelineLayoutDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::GetOrCreatePipelineLayout");
         PipelineLayoutBase blueprint(this, descriptor);
 
         auto iter = mCaches->pipelineLayouts.find(&blueprint);
-        if (iter != mCaches->pipelineLayouts.end()) {
-            (*iter)->Reference();
+        if (iter != mCaches->pipelineLayouts.end() && !ReferenceCachedObject(*iter)) {
+            mCaches->pipelineLayouts.erase(iter);
+            iter = mCaches->pipelineLayouts.end();
+        }
+        bool hit = iter != mCaches->pipelineLayouts.end();
+        mCountersTracker->RecordCacheLookup(DeviceCountersTracker::Cache::PipelineLayout, hit);
+        if (hit) {
             return *iter;
         }
 
@@ -477,11 +575,17 @@ namespace dawn_native {
 
     ResultOrError<RenderPipelineBase*> DeviceBase::GetOrCreateRenderPipeline(
         const RenderPipelineDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::GetOrCreateRenderPipeline");
         RenderPipelineBase blueprint(this, descriptor);
 
         auto iter = mCaches->renderPipelines.find(&blueprint);
-        if (iter != mCaches->renderPipelines.end()) {
-            (*iter)->Reference();
+        if (iter != mCaches->renderPipelines.end() && !ReferenceCachedObject(*iter)) {
+            mCaches->renderPipelines.erase(iter);
+            iter = mCaches->renderPipelines.end();
+        }
+        bool hit = iter != mCaches->renderPipelines.end();
+        mCountersTracker->RecordCacheLookup(DeviceCountersTracker::Cache::RenderPipeline, hit);
+        if (hit) {
             return *iter;
         }
 
@@ -500,11 +604,17 @@ namespace dawn_native {
 
     ResultOrError<SamplerBase*> DeviceBase::GetOrCreateSampler(
         const SamplerDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::GetOrCreateSampler");
         SamplerBase blueprint(this, descriptor);
 
         auto iter = mCaches->samplers.find(&blueprint);
-        if (iter != mCaches->samplers.end()) {
-            (*iter)->Reference();
+        if (iter != mCaches->samplers.end() && !ReferenceCachedObject(*iter)) {
+            mCaches->samplers.erase(iter);
+            iter = mCaches->samplers.end();
+        }
+        bool hit = iter != mCaches->samplers.end();
+        mCountersTracker->RecordCacheLookup(DeviceCountersTracker::Cache::Sampler, hit);
+        if (hit) {
             return *iter;
         }
 
@@ -523,11 +633,17 @@ namespace dawn_native {
 
     ResultOrError<ShaderModuleBase*> DeviceBase::GetOrCreateShaderModule(
         const ShaderModuleDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::GetOrCreateShaderModule");
         ShaderModuleBase blueprint(this, descriptor);
 
         auto iter = mCaches->shaderModules.find(&blueprint);
-        if (iter != mCaches->shaderModules.end()) {
-            (*iter)->Reference();
+        if (iter != mCaches->shaderModules.end() && !ReferenceCachedObject(*iter)) {
+            mCaches->shaderModules.erase(iter);
+            iter = mCaches->shaderModules.end();
+        }
+        bool hit = iter != mCaches->shaderModules.end();
+        mCountersTracker->RecordCacheLookup(DeviceCountersTracker::Cache::ShaderModule, hit);
+        if (hit) {
             return *iter;
         }
 
@@ -546,9 +662,17 @@ namespace dawn_native {
 
     Ref<AttachmentState> DeviceBase::GetOrCreateAttachmentState(
         AttachmentStateBlueprint* blueprint) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::GetOrCreateAttachmentState");
         auto iter = mCaches->attachmentStates.find(blueprint);
-        if (iter != mCaches->attachmentStates.end()) {
-            return static_cast<AttachmentState*>(*iter);
+        if (iter != mCaches->attachmentStates.end() &&
+            !ReferenceCachedObject(static_cast<AttachmentState*>(*iter))) {
+            mCaches->attachmentStates.erase(iter);
+            iter = mCaches->attachmentStates.end();
+        }
+        bool hit = iter != mCaches->attachmentStates.end();
+        mCountersTracker->RecordCacheLookup(DeviceCountersTracker::Cache::AttachmentState, hit);
+        if (hit) {
+            return AcquireRef(static_cast<AttachmentState*>(*iter));
         }
 
         Ref<AttachmentState> attachmentState = AcquireRef(new AttachmentState(this, *blueprint));
@@ -584,6 +708,7 @@ namespace dawn_native {
     // Object creation API methods
 
     BindGroupBase* DeviceBase::CreateBindGroup(const BindGroupDescriptor* descriptor) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::CreateBindGroup");
         BindGroupBase* result = nullptr;
 
         if (ConsumedError(CreateBindGroupInternal(&result, descriptor))) {
@@ -631,8 +756,7 @@ namespace dawn_native {
         MaybeError maybeError = CreateComputePipelineInternal(&result, descriptor);
         if (maybeError.IsError()) {
             std::unique_ptr<ErrorData> error = maybeError.AcquireError();
-            callback(WGPUCreateReadyPipelineStatus_Error, nullptr, error->GetMessage().c_str(),
-                     userdata);
+            callback(WGPUCreateReadyPipelineStatus_Error, nullptr, error->GetMessage(), userdata);
             return;
         }
 
@@ -681,8 +805,7 @@ namespace dawn_native {
         MaybeError maybeError = CreateRenderPipelineInternal(&result, descriptor);
         if (maybeError.IsError()) {
             std::unique_ptr<ErrorData> error = maybeError.AcquireError();
-            callback(WGPUCreateReadyPipelineStatus_Error, nullptr, error->GetMessage().c_str(),
-                     userdata);
+            callback(WGPUCreateReadyPipelineStatus_Error, nullptr, error->GetMessage(), userdata);
             return;
         }
 
@@ -760,6 +883,12 @@ namespace dawn_native {
 
     // Returns true if future ticking is needed.
     bool DeviceBase::Tick() {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::Tick");
+
+        // Delete the deferred objects first so that the backend resources they free are reclaimed
+        // by this tick when possible. Lost devices still delete them to free their memory.
+        DeleteDeferredObjects();
+
         if (ConsumedError(ValidateIsAlive())) {
             return false;
         }
@@ -785,14 +914,75 @@ namespace dawn_native {
             // tick the dynamic uploader before the backend resource allocators. This would allow
             // reclaiming resources one tick earlier.
             mDynamicUploader->Deallocate(mCompletedSerial);
+            mScratchBufferAllocator->Deallocate(mCompletedSerial);
             mErrorScopeTracker->Tick(mCompletedSerial);
             GetDefaultQueue()->Tick(mCompletedSerial);
+            // The fences of the additional queues complete with the work of their own queue.
+            for (Ref<QueueBase>& queue : mAdditionalQueues) {
+                queue->Tick(queue->GetCompletedSerial());
+            }
             mCreateReadyPipelineTracker->Tick(mCompletedSerial);
         }
 
         return !IsDeviceIdle();
     }
 
+    bool DeviceBase::IsDeferringObjectDeletion() const {
+        return mDeferredDeletions.load(std::memory_order_relaxed) != kNotDeferringObjectDeletion;
+    }
+
+    bool DeviceBase::TryDeferObjectDeletion(ObjectBase* object) {
+        // Push the object on the stack. The release order makes the object's last accesses
+        // on this thread visible to the thread that deletes it.
+        ObjectBase* head = mDeferredDeletions.load(std::memory_order_relaxed);
+        do {
+            if (head == kNotDeferringObjectDeletion) {
+                return false;
+            }
+            object->mNextDeferredDeletion = head;
+        } while (!mDeferredDeletions.compare_exchange_weak(head, object, std::memory_order_release,
+                                                           std::memory_order_relaxed));
+        return true;
+    }
+
+    void DeviceBase::DeleteDeferredObjects() {
+        // Only this thread stops the deferral, so the stack keeps a valid head while it is taken.
+        if (!IsDeferringObjectDeletion()) {
+            return;
+        }
+
+        // Objects can release the last reference to other objects when they are deleted, so keep
+        // going until the stack stays empty. The whole stack is taken at once so there is no ABA
+        // problem with concurrent pushes.
+        ObjectBase* object;
+        while ((object = mDeferredDeletions.exchange(nullptr, std::memory_order_acquire)) !=
+               nullptr) {
+            DeleteDeferredObjectList(object);
+        }
+    }
+
+    void DeviceBase::DeleteDeferredObjectList(ObjectBase* object) {
+        TRACE_EVENT0(GetPlatform(), General, "DeviceBase::DeleteDeferredObjects");
+        while (object != nullptr) {
+            ObjectBase* next = object->mNextDeferredDeletion;
+            object->DeleteThisNow();
+            object = next;
+        }
+    }
+
+    bool DeviceBase::ReferenceCachedObject(CachedObject* object) {
+        ASSERT(object->IsCachedReference());
+        if (object->TryReference()) {
+            return true;
+        }
+
+        // The object is only deleted by DeleteDeferredObjects, on this thread, so it stays valid
+        // until then. Its destructor must not uncache the object that replaces it.
+        ASSERT(IsDeferringObjectDeletion());
+        object->ClearIsCachedReference();
+        return false;
+    }
+
     void DeviceBase::Reference() {
         ASSERT(mRefCount != 0);
         mRefCount++;
@@ -1058,12 +1248,37 @@ namespace dawn_native {
         return {};
     }
 
+    QueueBase* DeviceBase::CreateAdditionalQueue(QueueType type) {
+        QueueBase* result = nullptr;
+
+        if (ConsumedError(CreateAdditionalQueueInternal(&result, type))) {
+            return QueueBase::MakeError(this);
+        }
+
+        return result;
+    }
+
+    MaybeError DeviceBase::CreateAdditionalQueueInternal(QueueBase** result, QueueType type) {
+        DAWN_TRY(ValidateIsAlive());
+        DAWN_TRY_ASSIGN(*result, CreateAdditionalQueueImpl(type));
+        mAdditionalQueues.emplace_back(*result);
+        return {};
+    }
+
+    ResultOrError<QueueBase*> DeviceBase::CreateAdditionalQueueImpl(QueueType type) {
+        return DAWN_VALIDATION_ERROR("Additional queues are not supported on this backend");
+    }
+
     // Other implementation details
 
     DynamicUploader* DeviceBase::GetDynamicUploader() const {
         return mDynamicUploader.get();
     }
 
+    ScratchBufferAllocator* DeviceBase::GetScratchBufferAllocator() const {
+        return mScratchBufferAllocator.get();
+    }
+
     // The Toggle device facility
 
     std::vector<const char*> DeviceBase::GetTogglesUsed() const {
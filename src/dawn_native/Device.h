@@ -26,17 +26,22 @@
 #include "dawn_native/DawnNative.h"
 #include "dawn_native/dawn_platform.h"
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 namespace dawn_native {
     class AdapterBase;
     class AttachmentState;
     class AttachmentStateBlueprint;
     class BindGroupLayoutBase;
+    class CachedObject;
     class CreateReadyPipelineTracker;
+    class DeviceCountersTracker;
     class DynamicUploader;
     class ErrorScope;
     class ErrorScopeTracker;
+    class ScratchBufferAllocator;
     class StagingBufferBase;
 
     class DeviceBase {
@@ -45,6 +50,7 @@ namespace dawn_native {
         virtual ~DeviceBase();
 
         void HandleError(InternalErrorType type, const char* message);
+        void ConsumeError(std::unique_ptr<ErrorData> error);
 
         bool ConsumedError(MaybeError maybeError) {
             if (DAWN_UNLIKELY(maybeError.IsError())) {
@@ -165,11 +171,25 @@ namespace dawn_native {
         // For Dawn Wire
         BufferBase* CreateErrorBuffer();
 
+        // For the buffers created internally, which need the error instead of an error buffer.
+        ResultOrError<Ref<BufferBase>> CreateBufferInternal(const BufferDescriptor* descriptor);
+
         QueueBase* GetDefaultQueue();
+        QueueBase* CreateAdditionalQueue(QueueType type);
 
         void InjectError(wgpu::ErrorType type, const char* message);
         bool Tick();
 
+        // Objects released while the DeferObjectDestruction toggle is enabled are queued with
+        // TryDeferObjectDeletion, which is lock-free and can be called from any thread. They are
+        // deleted at the start of the next Tick, or when the device is shut down. This includes
+        // cached objects: they stay in their cache until then, but cache lookups don't return
+        // them anymore. Without the toggle, objects must be released on the device's thread.
+        bool IsDeferringObjectDeletion() const;
+        // Returns false when the deletion isn't deferred, in which case the caller deletes the
+        // object immediately.
+        bool TryDeferObjectDeletion(ObjectBase* object);
+
         void SetDeviceLostCallback(wgpu::DeviceLostCallback callback, void* userdata);
         void SetUncapturedErrorCallback(wgpu::ErrorCallback callback, void* userdata);
         void PushErrorScope(wgpu::ErrorFilter filter);
@@ -195,6 +215,11 @@ namespace dawn_native {
                                                     const Extent3D& copySizePixels) = 0;
 
         DynamicUploader* GetDynamicUploader() const;
+        ScratchBufferAllocator* GetScratchBufferAllocator() const;
+
+        DeviceCountersTracker* GetCountersTracker() const;
+        DeviceCounters GetCounters() const;
+        DeviceMemoryUsage GetMemoryUsage() const;
 
         // The device state which is a combination of creation state and loss state.
         //
@@ -284,6 +309,8 @@ namespace dawn_native {
         virtual ResultOrError<TextureViewBase*> CreateTextureViewImpl(
             TextureBase* texture,
             const TextureViewDescriptor* descriptor) = 0;
+        // Backends that can execute several queues concurrently override this.
+        virtual ResultOrError<QueueBase*> CreateAdditionalQueueImpl(QueueType type);
 
         ResultOrError<Ref<BindGroupLayoutBase>> CreateEmptyBindGroupLayout();
 
@@ -291,7 +318,6 @@ namespace dawn_native {
                                            const BindGroupDescriptor* descriptor);
         MaybeError CreateBindGroupLayoutInternal(BindGroupLayoutBase** result,
                                                  const BindGroupLayoutDescriptor* descriptor);
-        ResultOrError<Ref<BufferBase>> CreateBufferInternal(const BufferDescriptor* descriptor);
         MaybeError CreateComputePipelineInternal(ComputePipelineBase** result,
                                                  const ComputePipelineDescriptor* descriptor);
         MaybeError CreatePipelineLayoutInternal(PipelineLayoutBase** result,
@@ -313,22 +339,34 @@ namespace dawn_native {
         MaybeError CreateTextureViewInternal(TextureViewBase** result,
                                              TextureBase* texture,
                                              const TextureViewDescriptor* descriptor);
+        MaybeError CreateAdditionalQueueInternal(QueueBase** result, QueueType type);
 
         void ApplyToggleOverrides(const DeviceDescriptor* deviceDescriptor);
         void ApplyExtensions(const DeviceDescriptor* deviceDescriptor);
 
         void SetDefaultToggles();
 
-        void ConsumeError(std::unique_ptr<ErrorData> error);
+        void HandleErrorImpl(InternalErrorType type, LazyErrorMessage* message);
 
         // Each backend should implement to check their passed fences if there are any and return a
         // completed serial. Return 0 should indicate no fences to check.
         virtual ExecutionSerial CheckAndUpdateCompletedSerials() = 0;
+        // Backends that allocate GPU memory themselves add how they allocated it to |usage|.
+        virtual void ReportBackendMemoryUsage(DeviceMemoryUsage* usage) const;
+        // Backends add the counters that only they can track to |counters|.
+        virtual void ReportBackendCounters(DeviceCounters* counters) const;
         // During shut down of device, some operations might have been started since the last submit
         // and waiting on a serial that doesn't have a corresponding fence enqueued. Fake serials to
         // make all commands look completed.
         void AssumeCommandsComplete();
         bool IsDeviceIdle();
+        void DeleteDeferredObjects();
+        void DeleteDeferredObjectList(ObjectBase* object);
+        // Adds a reference to an object found in a cache. Returns false if the last reference to
+        // the object was released and its deletion is deferred: the object then stops being a
+        // cached reference and the caller removes it from the cache so that a new object takes
+        // its place.
+        bool ReferenceCachedObject(CachedObject* object);
 
         // mCompletedSerial tracks the last completed command serial that the fence has returned.
         // mLastSubmittedSerial tracks the last submitted command serial.
@@ -368,9 +406,21 @@ namespace dawn_native {
         Ref<BindGroupLayoutBase> mEmptyBindGroupLayout;
 
         std::unique_ptr<DynamicUploader> mDynamicUploader;
+        std::unique_ptr<ScratchBufferAllocator> mScratchBufferAllocator;
         std::unique_ptr<ErrorScopeTracker> mErrorScopeTracker;
         std::unique_ptr<CreateReadyPipelineTracker> mCreateReadyPipelineTracker;
+        // Unlike the other trackers, this lives for as long as the device so that objects
+        // released after shutdown can still update their counts.
+        std::unique_ptr<DeviceCountersTracker> mCountersTracker;
         Ref<QueueBase> mDefaultQueue;
+        // The device keeps the additional queues alive, like the default queue, so that it can
+        // tick them until it is destroyed.
+        std::vector<Ref<QueueBase>> mAdditionalQueues;
+
+        // An intrusive stack of the objects waiting to be deleted, linked with
+        // ObjectBase::mNextDeferredDeletion. Its head is a sentinel while objects aren't deferred,
+        // so that checking the deferral and pushing an object is a single atomic operation.
+        std::atomic<ObjectBase*> mDeferredDeletions;
 
         struct DeprecationWarnings;
         std::unique_ptr<DeprecationWarnings> mDeprecationWarnings;
@@ -0,0 +1,202 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/DeviceCountersTracker.h"
+
+#include "common/Assert.h"
+#include "dawn_native/Commands.h"
+
+namespace dawn_native {
+
+    namespace {
+
+        uint64_t Load(const std::atomic<uint64_t>& counter) {
+            return counter.load(std::memory_order_relaxed);
+        }
+
+        void Add(std::atomic<uint64_t>* counter, uint64_t value) {
+            counter->fetch_add(value, std::memory_order_relaxed);
+        }
+
+    }  // anonymous namespace
+
+    DeviceCountersTracker::ScopedTimer::ScopedTimer(DeviceCountersTracker* tracker, Timer timer)
+        : mTracker(tracker), mTimer(timer), mStart(std::chrono::steady_clock::now()) {
+    }
+
+    DeviceCountersTracker::ScopedTimer::~ScopedTimer() {
+        mTracker->RecordTime(mTimer, std::chrono::steady_clock::now() - mStart);
+    }
+
+    void DeviceCountersTracker::RecordEncodedCommands(
+        const CommandAllocator::CommandCounts& counts) {
+        static_assert(static_cast<uint32_t>(Command::WriteTimestamp) <
+                          CommandAllocator::kMaxCountedCommandIds,
+                      "All commands must be counted by the CommandAllocator");
+
+        uint64_t categoryCounts[static_cast<size_t>(CommandCategory::Count)] = {};
+        for (uint32_t id = 0; id < counts.size(); ++id) {
+            if (counts[id] == 0) {
+                continue;
+            }
+
+            CommandCategory category;
+            switch (static_cast<Command>(id)) {
+                case Command::BeginRenderPass:
+                    category = CommandCategory::RenderPass;
+                    break;
+                case Command::BeginComputePass:
+                    category = CommandCategory::ComputePass;
+                    break;
+                case Command::Draw:
+                case Command::DrawIndexed:
+                case Command::DrawIndirect:
+                case Command::DrawIndexedIndirect:
+                case Command::MultiDraw:
+                case Command::MultiDrawIndexed:
+                    category = CommandCategory::Draw;
+                    break;
+                case Command::Dispatch:
+                case Command::DispatchIndirect:
+                    category = CommandCategory::Dispatch;
+                    break;
+                case Command::CopyBufferToBuffer:
+                case Command::CopyBufferToTexture:
+                case Command::CopyTextureToBuffer:
+                case Command::CopyTextureToTexture:
+                    category = CommandCategory::Copy;
+                    break;
+                case Command::SetComputePipeline:
+                case Command::SetRenderPipeline:
+                    category = CommandCategory::PipelineChange;
+                    break;
+                case Command::SetBindGroup:
+                    category = CommandCategory::BindGroupChange;
+                    break;
+                default:
+                    category = CommandCategory::Other;
+                    break;
+            }
+            categoryCounts[static_cast<size_t>(category)] += counts[id];
+        }
+
+        for (size_t i = 0; i < static_cast<size_t>(CommandCategory::Count); ++i) {
+            if (categoryCounts[i] != 0) {
+                Add(&mCommandsEncoded[i], categoryCounts[i]);
+            }
+        }
+    }
+
+    void DeviceCountersTracker::RecordSubmit() {
+        Add(&mQueueSubmits, 1);
+    }
+
+    void DeviceCountersTracker::RecordBytesUploaded(uint64_t bytes) {
+        Add(&mBytesUploaded, bytes);
+    }
+
+    void DeviceCountersTracker::RecordCacheLookup(Cache cache, bool hit) {
+        if (hit) {
+            Add(&mCacheHits[static_cast<size_t>(cache)], 1);
+        } else {
+            Add(&mCacheMisses[static_cast<size_t>(cache)], 1);
+        }
+    }
+
+    void DeviceCountersTracker::RecordObjectCreated(LiveObject object) {
+        Add(&mLiveObjects[static_cast<size_t>(object)], 1);
+    }
+
+    void DeviceCountersTracker::RecordObjectDestroyed(LiveObject object) {
+        uint64_t previous =
+            mLiveObjects[static_cast<size_t>(object)].fetch_sub(1, std::memory_order_relaxed);
+        ASSERT(previous > 0);
+    }
+
+    void DeviceCountersTracker::RecordTime(Timer timer, std::chrono::nanoseconds duration) {
+        Add(&mTimerNanoseconds[static_cast<size_t>(timer)],
+            static_cast<uint64_t>(duration.count()));
+    }
+
+    void DeviceCountersTracker::RecordMemoryAllocated(Memory memory, uint64_t bytes) {
+        Add(&mMemoryBytes[static_cast<size_t>(memory)], bytes);
+    }
+
+    void DeviceCountersTracker::RecordMemoryFreed(Memory memory, uint64_t bytes) {
+        uint64_t previous =
+            mMemoryBytes[static_cast<size_t>(memory)].fetch_sub(bytes, std::memory_order_relaxed);
+        ASSERT(previous >= bytes);
+    }
+
+    DeviceCounters DeviceCountersTracker::GetSnapshot() const {
+        auto CommandsEncoded = [&](CommandCategory category) {
+            return Load(mCommandsEncoded[static_cast<size_t>(category)]);
+        };
+        auto CacheCounters = [&](Cache cache) {
+            DeviceCounters::CacheCounters counters;
+            counters.hits = Load(mCacheHits[static_cast<size_t>(cache)]);
+            counters.misses = Load(mCacheMisses[static_cast<size_t>(cache)]);
+            return counters;
+        };
+
+        DeviceCounters counters;
+        counters.renderPassesEncoded = CommandsEncoded(CommandCategory::RenderPass);
+        counters.computePassesEncoded = CommandsEncoded(CommandCategory::ComputePass);
+        counters.drawsEncoded = CommandsEncoded(CommandCategory::Draw);
+        counters.dispatchesEncoded = CommandsEncoded(CommandCategory::Dispatch);
+        counters.copiesEncoded = CommandsEncoded(CommandCategory::Copy);
+        counters.pipelineChangesEncoded = CommandsEncoded(CommandCategory::PipelineChange);
+        counters.bindGroupChangesEncoded = CommandsEncoded(CommandCategory::BindGroupChange);
+        counters.otherCommandsEncoded = CommandsEncoded(CommandCategory::Other);
+
+        counters.queueSubmits = Load(mQueueSubmits);
+        counters.bytesUploaded = Load(mBytesUploaded);
+
+        counters.attachmentStateCache = CacheCounters(Cache::AttachmentState);
+        counters.bindGroupLayoutCache = CacheCounters(Cache::BindGroupLayout);
+        counters.computePipelineCache = CacheCounters(Cache::ComputePipeline);
+        counters.pipelineLayoutCache = CacheCounters(Cache::PipelineLayout);
+        counters.renderPipelineCache = CacheCounters(Cache::RenderPipeline);
+        counters.samplerCache = CacheCounters(Cache::Sampler);
+        counters.shaderModuleCache = CacheCounters(Cache::ShaderModule);
+
+        auto LiveObjects = [&](LiveObject object) {
+            return Load(mLiveObjects[static_cast<size_t>(object)]);
+        };
+        counters.liveBuffers = LiveObjects(LiveObject::Buffer);
+        counters.liveTextures = LiveObjects(LiveObject::Texture);
+        counters.liveBindGroups = LiveObjects(LiveObject::BindGroup);
+        counters.liveBindGroupLayouts = LiveObjects(LiveObject::BindGroupLayout);
+        counters.liveComputePipelines = LiveObjects(LiveObject::ComputePipeline);
+        counters.livePipelineLayouts = LiveObjects(LiveObject::PipelineLayout);
+        counters.liveRenderPipelines = LiveObjects(LiveObject::RenderPipeline);
+        counters.liveSamplers = LiveObjects(LiveObject::Sampler);
+        counters.liveShaderModules = LiveObjects(LiveObject::ShaderModule);
+
+        counters.validateFinishNanoseconds =
+            Load(mTimerNanoseconds[static_cast<size_t>(Timer::ValidateFinish)]);
+        counters.validateSubmitNanoseconds =
+            Load(mTimerNanoseconds[static_cast<size_t>(Timer::ValidateSubmit)]);
+        return counters;
+    }
+
+    DeviceMemoryUsage DeviceCountersTracker::GetMemoryUsageSnapshot() const {
+        DeviceMemoryUsage usage;
+        usage.commandBytes = Load(mMemoryBytes[static_cast<size_t>(Memory::Commands)]);
+        usage.bufferBytes = Load(mMemoryBytes[static_cast<size_t>(Memory::Buffers)]);
+        usage.textureBytes = Load(mMemoryBytes[static_cast<size_t>(Memory::Textures)]);
+        return usage;
+    }
+
+}  // namespace dawn_native
@@ -0,0 +1,125 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_DEVICECOUNTERSTRACKER_H_
+#define DAWNNATIVE_DEVICECOUNTERSTRACKER_H_
+
+#include "dawn_native/CommandAllocator.h"
+#include "dawn_native/DawnNative.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace dawn_native {
+
+    // Keeps the always-on counters returned by GetDeviceCounters. All the counters are relaxed
+    // atomics so that recording them is cheap and can be done from any thread. A snapshot isn't
+    // guaranteed to be consistent across counters.
+    class DeviceCountersTracker {
+      public:
+        enum class Cache {
+            AttachmentState,
+            BindGroupLayout,
+            ComputePipeline,
+            PipelineLayout,
+            RenderPipeline,
+            Sampler,
+            ShaderModule,
+            Count,
+        };
+
+        enum class LiveObject {
+            Buffer,
+            Texture,
+            BindGroup,
+            BindGroupLayout,
+            ComputePipeline,
+            PipelineLayout,
+            RenderPipeline,
+            Sampler,
+            ShaderModule,
+            Count,
+        };
+
+        // Memory tracked as it is allocated and freed. The rest of DeviceMemoryUsage is computed
+        // by the device when queried.
+        enum class Memory {
+            Commands,
+            Buffers,
+            Textures,
+            Count,
+        };
+
+        enum class Timer {
+            ValidateFinish,
+            ValidateSubmit,
+            Count,
+        };
+
+        // Adds the time between its construction and its destruction to a timer.
+        class ScopedTimer {
+          public:
+            ScopedTimer(DeviceCountersTracker* tracker, Timer timer);
+            ~ScopedTimer();
+
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+          private:
+            DeviceCountersTracker* mTracker;
+            Timer mTimer;
+            std::chrono::steady_clock::time_point mStart;
+        };
+
+        void RecordEncodedCommands(const CommandAllocator::CommandCounts& counts);
+        void RecordSubmit();
+        void RecordBytesUploaded(uint64_t bytes);
+        void RecordCacheLookup(Cache cache, bool hit);
+        void RecordObjectCreated(LiveObject object);
+        void RecordObjectDestroyed(LiveObject object);
+        void RecordTime(Timer timer, std::chrono::nanoseconds duration);
+        void RecordMemoryAllocated(Memory memory, uint64_t bytes);
+        void RecordMemoryFreed(Memory memory, uint64_t bytes);
+
+        DeviceCounters GetSnapshot() const;
+        // Only the fields of the tracked memory are set.
+        DeviceMemoryUsage GetMemoryUsageSnapshot() const;
+
+      private:
+        enum class CommandCategory {
+            RenderPass,
+            ComputePass,
+            Draw,
+            Dispatch,
+            Copy,
+            PipelineChange,
+            BindGroupChange,
+            Other,
+            Count,
+        };
+
+        std::atomic<uint64_t> mCommandsEncoded[static_cast<size_t>(CommandCategory::Count)] = {};
+        std::atomic<uint64_t> mQueueSubmits = {0};
+        std::atomic<uint64_t> mBytesUploaded = {0};
+        std::atomic<uint64_t> mCacheHits[static_cast<size_t>(Cache::Count)] = {};
+        std::atomic<uint64_t> mCacheMisses[static_cast<size_t>(Cache::Count)] = {};
+        std::atomic<uint64_t> mLiveObjects[static_cast<size_t>(LiveObject::Count)] = {};
+        std::atomic<uint64_t> mTimerNanoseconds[static_cast<size_t>(Timer::Count)] = {};
+        std::atomic<uint64_t> mMemoryBytes[static_cast<size_t>(Memory::Count)] = {};
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_DEVICECOUNTERSTRACKER_H_
@@ -15,6 +15,7 @@
 #include "dawn_native/DynamicUploader.h"
 #include "common/Math.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 
 namespace dawn_native {
 
@@ -110,6 +111,23 @@ namespace dawn_native {
         mReleasedStagingBuffers.ClearUpTo(lastCompletedSerial);
     }
 
+    void DynamicUploader::ReportMemoryUsage(DeviceMemoryUsage* usage) const {
+        for (const std::unique_ptr<RingBuffer>& ringBuffer : mRingBuffers) {
+            // The staging buffer of the first ring buffer is created lazily.
+            if (ringBuffer->mStagingBuffer != nullptr) {
+                usage->uploadBytes += ringBuffer->mAllocator.GetSize();
+            }
+            usage->uploadUsedBytes += ringBuffer->mAllocator.GetUsedSize();
+        }
+
+        // The staging buffers of large uploads are used until they are released.
+        for (const std::unique_ptr<StagingBufferBase>& stagingBuffer :
+             mReleasedStagingBuffers.IterateAll()) {
+            usage->uploadBytes += stagingBuffer->GetSize();
+            usage->uploadUsedBytes += stagingBuffer->GetSize();
+        }
+    }
+
     // TODO(dawn:512): Optimize this function so that it doesn't allocate additional memory
     // when it's not necessary.
     ResultOrError<UploadHandle> DynamicUploader::Allocate(uint64_t allocationSize,
@@ -124,6 +142,7 @@ namespace dawn_native {
         uploadHandle.mappedBuffer =
             static_cast<uint8_t*>(uploadHandle.mappedBuffer) + additionalOffset;
         uploadHandle.startOffset += additionalOffset;
+        mDevice->GetCountersTracker()->RecordBytesUploaded(allocationSize);
         return uploadHandle;
     }
 }  // namespace dawn_native
@@ -15,6 +15,7 @@
 #ifndef DAWNNATIVE_DYNAMICUPLOADER_H_
 #define DAWNNATIVE_DYNAMICUPLOADER_H_
 
+#include "dawn_native/DawnNative.h"
 #include "dawn_native/Forward.h"
 #include "dawn_native/IntegerTypes.h"
 #include "dawn_native/RingBufferAllocator.h"
@@ -46,6 +47,9 @@ namespace dawn_native {
                                              uint64_t offsetAlignment);
         void Deallocate(ExecutionSerial lastCompletedSerial);
 
+        // Adds the size of the staging memory and the part of it in use to |usage|.
+        void ReportMemoryUsage(DeviceMemoryUsage* usage) const;
+
       private:
         static constexpr uint64_t kRingBufferSize = 4 * 1024 * 1024;
 
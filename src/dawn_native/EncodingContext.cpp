@@ -18,6 +18,7 @@
 #include "dawn_native/CommandEncoder.h"
 #include "dawn_native/Commands.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/ErrorData.h"
 #include "dawn_native/RenderBundleEncoder.h"
 
@@ -53,16 +54,15 @@ namespace dawn_native {
         }
     }
 
-    void EncodingContext::HandleError(InternalErrorType type, const char* message) {
+    void EncodingContext::HandleError(std::unique_ptr<ErrorData> error) {
         if (!IsFinished()) {
             // If the encoding context is not finished, errors are deferred until
             // Finish() is called.
-            if (!mGotError) {
-                mGotError = true;
-                mErrorMessage = message;
+            if (mError == nullptr) {
+                mError = std::move(error);
             }
         } else {
-            mDevice->HandleError(type, message);
+            mDevice->ConsumeError(std::move(error));
         }
     }
 
@@ -109,12 +109,19 @@ namespace dawn_native {
         mCurrentEncoder = nullptr;
         mTopLevelEncoder = nullptr;
 
-        if (mGotError) {
-            return DAWN_VALIDATION_ERROR(mErrorMessage);
+        if (mError != nullptr) {
+            // Errors of the encoding commands are reported as validation errors of Finish, even
+            // internal and out of memory errors, so that they don't lose the device.
+            if (mError->GetType() != InternalErrorType::Validation) {
+                return DAWN_VALIDATION_ERROR(mError->GetMessage());
+            }
+            return std::move(mError);
         }
         if (currentEncoder != topLevelEncoder) {
             return DAWN_VALIDATION_ERROR("Command buffer recording ended mid-pass");
         }
+
+        mDevice->GetCountersTracker()->RecordEncodedCommands(mAllocator.GetCommandCounts());
         return {};
     }
 
@@ -47,6 +47,9 @@ namespace dawn_native {
     // but shorthand version for specific error types are preferred:
     //   return DAWN_VALIDATION_ERROR("My error message");
     //
+    // DAWN_VALIDATION_ERROR references string literal messages instead of copying them, so a
+    // constant array of char passed to it must outlive the error.
+    //
     // There are different types of errors that should be used for different purpose:
     //
     //   - Validation: these are errors that show the user did something bad, which causes the
@@ -72,7 +75,9 @@ namespace dawn_native {
 
 #define DAWN_MAKE_ERROR(TYPE, MESSAGE) \
     ::dawn_native::ErrorData::Create(TYPE, MESSAGE, __FILE__, __func__, __LINE__)
-#define DAWN_VALIDATION_ERROR(MESSAGE) DAWN_MAKE_ERROR(InternalErrorType::Validation, MESSAGE)
+#define DAWN_VALIDATION_ERROR(MESSAGE)                                                   \
+    ::dawn_native::ErrorData::CreateWithLiteral(InternalErrorType::Validation, MESSAGE, \
+                                                __FILE__, __func__, __LINE__)
 #define DAWN_DEVICE_LOST_ERROR(MESSAGE) DAWN_MAKE_ERROR(InternalErrorType::DeviceLost, MESSAGE)
 #define DAWN_INTERNAL_ERROR(MESSAGE) DAWN_MAKE_ERROR(InternalErrorType::Internal, MESSAGE)
 #define DAWN_UNIMPLEMENTED_ERROR(MESSAGE) \
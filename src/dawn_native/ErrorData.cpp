@@ -14,17 +14,72 @@
 
 #include "dawn_native/ErrorData.h"
 
+#include "common/Assert.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/dawn_platform.h"
 
+#include <sstream>
+
 namespace dawn_native {
 
+    namespace {
+
+        // Most errors are freed before the next one is created, for example an encoder drops the
+        // errors of its commands after the first one, so only a few ErrorData need to be kept.
+        constexpr size_t kMaxPooledErrors = 16;
+
+        struct PooledError {
+            PooledError* next;
+        };
+
+        // Set when tErrorPool is destroyed at thread exit. ErrorData can still be allocated and
+        // freed after that, for example by the destructor of another thread_local, and then go
+        // straight to the heap. The flag has a trivial destructor so it can be read until the
+        // thread is gone.
+        thread_local bool tErrorPoolDestroyed = false;
+
+        struct ErrorPool {
+            ~ErrorPool() {
+                while (head != nullptr) {
+                    PooledError* next = head->next;
+                    ::operator delete(head);
+                    head = next;
+                }
+                tErrorPoolDestroyed = true;
+            }
+
+            PooledError* head = nullptr;
+            size_t count = 0;
+        };
+
+        thread_local ErrorPool tErrorPool;
+
+    }  // anonymous namespace
+
     std::unique_ptr<ErrorData> ErrorData::Create(InternalErrorType type,
                                                  std::string message,
                                                  const char* file,
                                                  const char* function,
                                                  int line) {
-        std::unique_ptr<ErrorData> error = std::make_unique<ErrorData>(type, message);
+        std::unique_ptr<ErrorData> error(new ErrorData(type, std::move(message)));
+        error->AppendBacktrace(file, function, line);
+        return error;
+    }
+
+    std::unique_ptr<ErrorData> ErrorData::CreateWithLiteral(InternalErrorType type,
+                                                            std::string message,
+                                                            const char* file,
+                                                            const char* function,
+                                                            int line) {
+        return Create(type, std::move(message), file, function, line);
+    }
+
+    std::unique_ptr<ErrorData> ErrorData::CreateWithStaticMessage(InternalErrorType type,
+                                                                  const char* staticMessage,
+                                                                  const char* file,
+                                                                  const char* function,
+                                                                  int line) {
+        std::unique_ptr<ErrorData> error(new ErrorData(type, staticMessage));
         error->AppendBacktrace(file, function, line);
         return error;
     }
@@ -33,25 +88,88 @@ namespace dawn_native {
         : mType(type), mMessage(std::move(message)) {
     }
 
+    ErrorData::ErrorData(InternalErrorType type, const char* staticMessage)
+        : mType(type), mStaticMessage(staticMessage) {
+    }
+
+    // static
+    void* ErrorData::operator new(size_t size) {
+        ASSERT(size == sizeof(ErrorData));
+        if (tErrorPoolDestroyed) {
+            return ::operator new(size);
+        }
+        ErrorPool& pool = tErrorPool;
+        if (pool.head != nullptr) {
+            PooledError* error = pool.head;
+            pool.head = error->next;
+            pool.count--;
+            return error;
+        }
+        return ::operator new(size);
+    }
+
+    // static
+    void ErrorData::operator delete(void* ptr) {
+        if (ptr == nullptr || tErrorPoolDestroyed) {
+            ::operator delete(ptr);
+            return;
+        }
+        ErrorPool& pool = tErrorPool;
+        if (pool.count >= kMaxPooledErrors) {
+            ::operator delete(ptr);
+            return;
+        }
+        PooledError* error = static_cast<PooledError*>(ptr);
+        error->next = pool.head;
+        pool.head = error;
+        pool.count++;
+    }
+
     void ErrorData::AppendBacktrace(const char* file, const char* function, int line) {
         BacktraceRecord record;
         record.file = file;
         record.function = function;
         record.line = line;
 
-        mBacktrace.push_back(std::move(record));
+        mBacktrace->push_back(std::move(record));
     }
 
     InternalErrorType ErrorData::GetType() const {
         return mType;
     }
 
-    const std::string& ErrorData::GetMessage() const {
-        return mMessage;
+    const char* ErrorData::GetMessage() const {
+        return mStaticMessage != nullptr ? mStaticMessage : mMessage.c_str();
+    }
+
+    const ErrorData::Backtrace& ErrorData::GetBacktrace() const {
+        return mBacktrace.container();
     }
 
-    const std::vector<ErrorData::BacktraceRecord>& ErrorData::GetBacktrace() const {
-        return mBacktrace;
+    std::string ErrorData::GetFormattedMessage() const {
+        std::ostringstream ss;
+        ss << GetMessage();
+        for (const BacktraceRecord& callsite : GetBacktrace()) {
+            ss << "\n    at " << callsite.function << " (" << callsite.file << ":" << callsite.line
+               << ")";
+        }
+        return ss.str();
+    }
+
+    LazyErrorMessage::LazyErrorMessage(const char* message) : mMessage(message), mError(nullptr) {
+    }
+
+    LazyErrorMessage::LazyErrorMessage(const ErrorData* error)
+        : mMessage(nullptr), mError(error) {
+    }
+
+    const char* LazyErrorMessage::Get() {
+        if (mMessage == nullptr) {
+            ASSERT(mError != nullptr);
+            mFormattedMessage = mError->GetFormattedMessage();
+            mMessage = mFormattedMessage.c_str();
+        }
+        return mMessage;
     }
 
 }  // namespace dawn_native
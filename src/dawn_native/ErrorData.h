@@ -16,11 +16,11 @@
 #define DAWNNATIVE_ERRORDATA_H_
 
 #include "common/Compiler.h"
+#include "common/StackContainer.h"
 
 #include <cstdint>
 #include <memory>
 #include <string>
-#include <vector>
 
 namespace wgpu {
     enum class ErrorType : uint32_t;
@@ -33,6 +33,11 @@ namespace dawn {
 namespace dawn_native {
     enum class InternalErrorType : uint32_t;
 
+    // Errors are on the hot path of applications that trigger validation errors every frame, so
+    // creating and discarding them is kept cheap: the string literal messages of
+    // DAWN_VALIDATION_ERROR aren't copied, the backtrace of a few DAWN_TRY is stored inline, and
+    // the ErrorData themselves are recycled by a small per-thread pool. The message is only
+    // combined with the backtrace when it is consumed, see GetFormattedMessage.
     class DAWN_NO_DISCARD ErrorData {
       public:
         static DAWN_NO_DISCARD std::unique_ptr<ErrorData> Create(InternalErrorType type,
@@ -40,23 +45,85 @@ namespace dawn_native {
                                                                  const char* file,
                                                                  const char* function,
                                                                  int line);
+        // Used by DAWN_VALIDATION_ERROR. String literals live for the whole program so only a
+        // pointer to them is kept. They are told apart from other messages by their type, an array
+        // of const char, so a mutable array is copied like pointers and std::string are.
+        template <size_t N>
+        static DAWN_NO_DISCARD std::unique_ptr<ErrorData> CreateWithLiteral(
+            InternalErrorType type,
+            const char (&literal)[N],
+            const char* file,
+            const char* function,
+            int line) {
+            return CreateWithStaticMessage(type, literal, file, function, line);
+        }
+        template <size_t N>
+        static DAWN_NO_DISCARD std::unique_ptr<ErrorData> CreateWithLiteral(
+            InternalErrorType type,
+            char (&message)[N],
+            const char* file,
+            const char* function,
+            int line) {
+            return Create(type, message, file, function, line);
+        }
+        static DAWN_NO_DISCARD std::unique_ptr<ErrorData> CreateWithLiteral(InternalErrorType type,
+                                                                            std::string message,
+                                                                            const char* file,
+                                                                            const char* function,
+                                                                            int line);
         ErrorData(InternalErrorType type, std::string message);
 
+        // Use the per-thread pool of ErrorData.
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
+
         struct BacktraceRecord {
             const char* file;
             const char* function;
             int line;
         };
+        // Most errors go through less DAWN_TRY than this before being consumed.
+        static constexpr size_t kInlineBacktraceSize = 8;
+        using Backtrace = StackVector<BacktraceRecord, kInlineBacktraceSize>::ContainerType;
+
         void AppendBacktrace(const char* file, const char* function, int line);
 
         InternalErrorType GetType() const;
-        const std::string& GetMessage() const;
-        const std::vector<BacktraceRecord>& GetBacktrace() const;
+        const char* GetMessage() const;
+        const Backtrace& GetBacktrace() const;
+
+        // The message followed by the backtrace, which is what is reported to the application.
+        std::string GetFormattedMessage() const;
 
       private:
+        static std::unique_ptr<ErrorData> CreateWithStaticMessage(InternalErrorType type,
+                                                                  const char* staticMessage,
+                                                                  const char* file,
+                                                                  const char* function,
+                                                                  int line);
+        ErrorData(InternalErrorType type, const char* staticMessage);
+
         InternalErrorType mType;
+        // Set for string literal messages, otherwise the message is in mMessage.
+        const char* mStaticMessage = nullptr;
         std::string mMessage;
-        std::vector<BacktraceRecord> mBacktrace;
+        StackVector<BacktraceRecord, kInlineBacktraceSize> mBacktrace;
+    };
+
+    // The message of an error that is either a plain string or formatted from an ErrorData the
+    // first time it is needed. Most errors handled by an error scope that already captured one are
+    // dropped, and never need their message.
+    class LazyErrorMessage {
+      public:
+        explicit LazyErrorMessage(const char* message);
+        explicit LazyErrorMessage(const ErrorData* error);
+
+        const char* Get();
+
+      private:
+        const char* mMessage;
+        const ErrorData* mError;
+        std::string mFormattedMessage;
     };
 
 }  // namespace dawn_native
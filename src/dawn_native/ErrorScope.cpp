@@ -15,6 +15,7 @@
 #include "dawn_native/ErrorScope.h"
 
 #include "common/Assert.h"
+#include "dawn_native/ErrorData.h"
 
 namespace dawn_native {
 
@@ -55,7 +56,7 @@ namespace dawn_native {
         }
     }
 
-    void ErrorScope::HandleError(wgpu::ErrorType type, const char* message) {
+    void ErrorScope::HandleError(wgpu::ErrorType type, LazyErrorMessage* message) {
         HandleErrorImpl(this, type, message);
     }
 
@@ -64,7 +65,9 @@ namespace dawn_native {
     }
 
     // static
-    void ErrorScope::HandleErrorImpl(ErrorScope* scope, wgpu::ErrorType type, const char* message) {
+    void ErrorScope::HandleErrorImpl(ErrorScope* scope,
+                                     wgpu::ErrorType type,
+                                     LazyErrorMessage* message) {
         ErrorScope* currentScope = scope;
         for (; !currentScope->IsRoot(); currentScope = currentScope->GetParent()) {
             ASSERT(currentScope != nullptr);
@@ -102,7 +105,7 @@ namespace dawn_native {
             // Record the error if the scope doesn't have one yet.
             if (currentScope->mErrorType == wgpu::ErrorType::NoError) {
                 currentScope->mErrorType = type;
-                currentScope->mErrorMessage = message;
+                currentScope->mErrorMessage = message->Get();
             }
 
             if (consumed) {
@@ -113,7 +116,7 @@ namespace dawn_native {
         // The root error scope captures all uncaptured errors.
         ASSERT(currentScope->IsRoot());
         if (currentScope->mCallback) {
-            currentScope->mCallback(static_cast<WGPUErrorType>(type), message,
+            currentScope->mCallback(static_cast<WGPUErrorType>(type), message->Get(),
                                     currentScope->mUserdata);
         }
     }
@@ -23,6 +23,8 @@
 
 namespace dawn_native {
 
+    class LazyErrorMessage;
+
     // Errors can be recorded into an ErrorScope by calling |HandleError|.
     // Because an error scope should not resolve until contained
     // commands are complete, calling the callback is deferred until it is destructed.
@@ -43,7 +45,7 @@ namespace dawn_native {
         void SetCallback(wgpu::ErrorCallback callback, void* userdata);
         ErrorScope* GetParent();
 
-        void HandleError(wgpu::ErrorType type, const char* message);
+        void HandleError(wgpu::ErrorType type, LazyErrorMessage* message);
         void UnlinkForShutdown();
 
       private:
@@ -51,7 +53,9 @@ namespace dawn_native {
         bool IsRoot() const;
         void RunNonRootCallback();
 
-        static void HandleErrorImpl(ErrorScope* scope, wgpu::ErrorType type, const char* message);
+        static void HandleErrorImpl(ErrorScope* scope,
+                                    wgpu::ErrorType type,
+                                    LazyErrorMessage* message);
         static void UnlinkForShutdownImpl(ErrorScope* scope);
 
         wgpu::ErrorFilter mErrorFilter = wgpu::ErrorFilter::None;
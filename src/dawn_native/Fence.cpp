@@ -137,8 +137,8 @@ namespace dawn_native {
             std::make_unique<FenceInFlight>(fence, value);
 
         // TODO: use GetLastSubmittedCommandSerial in the future for perforamnce
-        GetDevice()->GetDefaultQueue()->TrackTask(std::move(fenceInFlight),
-                                                  GetDevice()->GetPendingCommandSerial());
+        // The fence is tracked by its queue so that it completes with the work of that queue.
+        mQueue->TrackTask(std::move(fenceInFlight), GetDevice()->GetPendingCommandSerial());
     }
 
     MaybeError Fence::ValidateOnCompletion(FenceAPISerial value,
@@ -14,6 +14,8 @@
 
 #include "dawn_native/ObjectBase.h"
 
+#include "dawn_native/Device.h"
+
 namespace dawn_native {
 
     static constexpr uint64_t kErrorPayload = 0;
@@ -34,4 +36,14 @@ namespace dawn_native {
         return GetRefCountPayload() == kErrorPayload;
     }
 
+    void ObjectBase::DeleteThis() {
+        if (!mDevice->TryDeferObjectDeletion(this)) {
+            DeleteThisNow();
+        }
+    }
+
+    void ObjectBase::DeleteThisNow() {
+        RefCounted::DeleteThis();
+    }
+
 }  // namespace dawn_native
@@ -35,8 +35,19 @@ namespace dawn_native {
       protected:
         ~ObjectBase() override = default;
 
+        // Deletes the object. This is called directly when the last reference is released, or in
+        // DeviceBase::Tick if the device defers the destruction of objects. Subclasses that need a
+        // custom deleter override this instead of DeleteThis.
+        virtual void DeleteThisNow();
+
       private:
+        friend class DeviceBase;
+
+        void DeleteThis() final;
+
         DeviceBase* mDevice;
+        // Link in the device's list of objects waiting to be deleted.
+        ObjectBase* mNextDeferredDeletion = nullptr;
     };
 
 }  // namespace dawn_native
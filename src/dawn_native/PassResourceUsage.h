@@ -15,6 +15,7 @@
 #ifndef DAWNNATIVE_PASSRESOURCEUSAGE_H
 #define DAWNNATIVE_PASSRESOURCEUSAGE_H
 
+#include "dawn_native/Texture.h"
 #include "dawn_native/dawn_platform.h"
 
 #include <set>
@@ -24,7 +25,6 @@ namespace dawn_native {
 
     class BufferBase;
     class QuerySetBase;
-    class TextureBase;
 
     enum class PassType { Render, Compute };
 
@@ -41,6 +41,10 @@ namespace dawn_native {
     // although we can deliberately design some particular cases in which we have a few texture
     // views and all of them have the same usages and they cover all subresources of the texture
     // altogether.
+    //
+    // - lazyClearRanges is computed when the pass ends. It contains the subresources that must be
+    // initialized before the pass runs, merged into as few ranges as possible. Subresources only
+    // used as output attachments aren't in it because they are initialized with their loadOp.
 
     // TODO(yunchao.he@intel.com): if sameUsagesAcrossSubresources is true, we don't need
     // the vector to record every single subresource's Usages. The texture usage is enough. And we
@@ -49,6 +53,7 @@ namespace dawn_native {
         wgpu::TextureUsage usage = wgpu::TextureUsage::None;
         bool sameUsagesAcrossSubresources = true;
         std::vector<wgpu::TextureUsage> subresourceUsages;
+        std::vector<SubresourceRange> lazyClearRanges;
     };
 
     // Which resources are used by pass and how they are used. The command buffer validation
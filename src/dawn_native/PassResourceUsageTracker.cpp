@@ -20,6 +20,71 @@
 #include "dawn_native/Texture.h"
 
 namespace dawn_native {
+
+    namespace {
+
+        // Returns the subresources that need to be initialized before a pass using |texture|
+        // with |textureUsage|. Consecutive array layers with the same aspects are merged, and so
+        // are consecutive mip levels with the same layers, so that the backends can clear them
+        // with as few operations as possible.
+        std::vector<SubresourceRange> ComputeLazyClearRanges(const TextureBase* texture,
+                                                             const PassTextureUsage& textureUsage) {
+            std::vector<SubresourceRange> ranges;
+
+            if (textureUsage.sameUsagesAcrossSubresources) {
+                if (textureUsage.usage & ~wgpu::TextureUsage::OutputAttachment) {
+                    ranges.push_back(texture->GetAllSubresources());
+                }
+                return ranges;
+            }
+
+            const Aspect formatAspects = texture->GetFormat().aspects;
+            auto GetAspectsToClear = [&](uint32_t mipLevel, uint32_t arrayLayer) {
+                Aspect aspects = Aspect::None;
+                for (Aspect aspect : IterateEnumMask(formatAspects)) {
+                    uint32_t index = texture->GetSubresourceIndex(mipLevel, arrayLayer, aspect);
+                    if (textureUsage.subresourceUsages[index] &
+                        ~wgpu::TextureUsage::OutputAttachment) {
+                        aspects |= aspect;
+                    }
+                }
+                return aspects;
+            };
+
+            for (uint32_t mipLevel = 0; mipLevel < texture->GetNumMipLevels(); ++mipLevel) {
+                uint32_t arrayLayer = 0;
+                while (arrayLayer < texture->GetArrayLayers()) {
+                    Aspect aspects = GetAspectsToClear(mipLevel, arrayLayer);
+                    if (aspects == Aspect::None) {
+                        ++arrayLayer;
+                        continue;
+                    }
+
+                    uint32_t baseArrayLayer = arrayLayer;
+                    do {
+                        ++arrayLayer;
+                    } while (arrayLayer < texture->GetArrayLayers() &&
+                             GetAspectsToClear(mipLevel, arrayLayer) == aspects);
+                    uint32_t layerCount = arrayLayer - baseArrayLayer;
+
+                    if (!ranges.empty()) {
+                        SubresourceRange& last = ranges.back();
+                        if (last.baseMipLevel + last.levelCount == mipLevel &&
+                            last.baseArrayLayer == baseArrayLayer &&
+                            last.layerCount == layerCount && last.aspects == aspects) {
+                            last.levelCount++;
+                            continue;
+                        }
+                    }
+                    ranges.push_back({mipLevel, 1, baseArrayLayer, layerCount, aspects});
+                }
+            }
+
+            return ranges;
+        }
+
+    }  // anonymous namespace
+
     PassResourceUsageTracker::PassResourceUsageTracker(PassType passType) : mPassType(passType) {
     }
 
@@ -96,6 +161,7 @@ namespace dawn_native {
         }
 
         for (auto& it : mTextureUsages) {
+            it.second.lazyClearRanges = ComputeLazyClearRanges(it.first, it.second);
             result.textures.push_back(it.first);
             result.textureUsages.push_back(std::move(it.second));
         }
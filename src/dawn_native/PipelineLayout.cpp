@@ -20,6 +20,7 @@
 #include "common/ityp_stack_vec.h"
 #include "dawn_native/BindGroupLayout.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/ShaderModule.h"
 
 namespace dawn_native {
@@ -56,6 +57,9 @@ namespace dawn_native {
             mBindGroupLayouts[group] = descriptor->bindGroupLayouts[static_cast<uint32_t>(group)];
             mMask.set(group);
         }
+
+        device->GetCountersTracker()->RecordObjectCreated(
+            DeviceCountersTracker::LiveObject::PipelineLayout);
     }
 
     PipelineLayoutBase::PipelineLayoutBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -63,6 +67,10 @@ namespace dawn_native {
     }
 
     PipelineLayoutBase::~PipelineLayoutBase() {
+        if (!IsError()) {
+            GetDevice()->GetCountersTracker()->RecordObjectDestroyed(
+                DeviceCountersTracker::LiveObject::PipelineLayout);
+        }
         // Do not uncache the actual cached object if we are a blueprint
         if (IsCachedReference()) {
             GetDevice()->UncachePipelineLayout(this);
@@ -36,6 +36,9 @@ namespace dawn_native {
         // Pooled memory is LIFO because memory can be evicted by LRU. However, this means
         // pooling is disabled in-frame when the memory is still pending. For high in-frame
         // memory users, FIFO might be preferable when memory consumption is a higher priority.
+        ASSERT(mHeapSize == 0 || mHeapSize == size);
+        mHeapSize = size;
+
         std::unique_ptr<ResourceHeapBase> memory;
         if (!mPool.empty()) {
             memory = std::move(mPool.front());
@@ -54,6 +57,11 @@ namespace dawn_native {
         mPool.push_front(std::move(allocation));
     }
 
+    void PooledResourceMemoryAllocator::ReportMemoryUsage(
+        DeviceMemoryUsage::SubAllocatorUsage* usage) const {
+        usage->pooledBytes += mPool.size() * mHeapSize;
+    }
+
     uint64_t PooledResourceMemoryAllocator::GetPoolSizeForTesting() const {
         return mPool.size();
     }
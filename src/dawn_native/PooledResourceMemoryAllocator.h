@@ -16,6 +16,7 @@
 #define DAWNNATIVE_POOLEDRESOURCEMEMORYALLOCATOR_H_
 
 #include "common/SerialQueue.h"
+#include "dawn_native/DawnNative.h"
 #include "dawn_native/ResourceHeapAllocator.h"
 
 #include <deque>
@@ -39,6 +40,9 @@ namespace dawn_native {
 
         void DestroyPool();
 
+        // Adds the size of the pooled heaps to |usage|.
+        void ReportMemoryUsage(DeviceMemoryUsage::SubAllocatorUsage* usage) const;
+
         // For testing purposes.
         uint64_t GetPoolSizeForTesting() const;
 
@@ -46,6 +50,9 @@ namespace dawn_native {
         ResourceHeapAllocator* mHeapAllocator = nullptr;
 
         std::deque<std::unique_ptr<ResourceHeapBase>> mPool;
+
+        // All the heaps of the pool have the same size.
+        uint64_t mHeapSize = 0;
     };
 
 }  // namespace dawn_native
@@ -95,12 +95,12 @@ namespace dawn_native {
 
     void ProgrammablePassEncoder::InsertDebugMarker(const char* groupLabel) {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
-            InsertDebugMarkerCmd* cmd =
-                allocator->Allocate<InsertDebugMarkerCmd>(Command::InsertDebugMarker);
-            cmd->length = strlen(groupLabel);
-
-            char* label = allocator->AllocateData<char>(cmd->length + 1);
-            memcpy(label, groupLabel, cmd->length + 1);
+            size_t length = strlen(groupLabel);
+            char* label;
+            InsertDebugMarkerCmd* cmd = allocator->AllocateWithData<InsertDebugMarkerCmd>(
+                Command::InsertDebugMarker, length + 1, &label);
+            cmd->length = length;
+            memcpy(label, groupLabel, length + 1);
 
             return {};
         });
@@ -116,12 +116,12 @@ namespace dawn_native {
 
     void ProgrammablePassEncoder::PushDebugGroup(const char* groupLabel) {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
-            PushDebugGroupCmd* cmd =
-                allocator->Allocate<PushDebugGroupCmd>(Command::PushDebugGroup);
-            cmd->length = strlen(groupLabel);
-
-            char* label = allocator->AllocateData<char>(cmd->length + 1);
-            memcpy(label, groupLabel, cmd->length + 1);
+            size_t length = strlen(groupLabel);
+            char* label;
+            PushDebugGroupCmd* cmd = allocator->AllocateWithData<PushDebugGroupCmd>(
+                Command::PushDebugGroup, length + 1, &label);
+            cmd->length = length;
+            memcpy(label, groupLabel, length + 1);
 
             return {};
         });
@@ -185,12 +185,13 @@ namespace dawn_native {
                 }
             }
 
-            SetBindGroupCmd* cmd = allocator->Allocate<SetBindGroupCmd>(Command::SetBindGroup);
+            uint32_t* offsets;
+            SetBindGroupCmd* cmd = allocator->AllocateWithData<SetBindGroupCmd>(
+                Command::SetBindGroup, dynamicOffsetCountIn, &offsets);
             cmd->index = groupIndex;
             cmd->group = group;
             cmd->dynamicOffsetCount = dynamicOffsetCountIn;
             if (dynamicOffsetCountIn > 0) {
-                uint32_t* offsets = allocator->AllocateData<uint32_t>(cmd->dynamicOffsetCount);
                 memcpy(offsets, dynamicOffsetsIn, dynamicOffsetCountIn * sizeof(uint32_t));
             }
 
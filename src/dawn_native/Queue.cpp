@@ -15,11 +15,13 @@
 #include "dawn_native/Queue.h"
 
 #include "common/Constants.h"
+#include "common/Platform.h"
 #include "dawn_native/Buffer.h"
 #include "dawn_native/CommandBuffer.h"
 #include "dawn_native/CommandValidation.h"
 #include "dawn_native/Commands.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/DynamicUploader.h"
 #include "dawn_native/ErrorScope.h"
 #include "dawn_native/ErrorScopeTracker.h"
@@ -29,12 +31,58 @@
 #include "dawn_platform/DawnPlatform.h"
 #include "dawn_platform/tracing/TraceEvent.h"
 
+#include <algorithm>
 #include <cstring>
 
+#if defined(DAWN_PLATFORM_SSE2)
+#    include <emmintrin.h>
+#endif
+
 namespace dawn_native {
 
     namespace {
 
+        // Copies larger than this are written with non-temporal stores. Upload memory is only
+        // read by the GPU afterwards so pulling it into the CPU caches would just evict other data.
+        constexpr uint64_t kStreamingCopyThreshold = 256 * 1024;
+
+        // Copies |size| bytes with non-temporal stores when they are supported. The caller must
+        // call StreamingCopyFence() before the destination is used.
+        void StreamingCopy(uint8_t* dst, const uint8_t* src, size_t size) {
+#if defined(DAWN_PLATFORM_SSE2)
+            // Copy the head with memcpy so that the streaming stores are 16-byte aligned.
+            size_t headSize = std::min(size, (16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15);
+            memcpy(dst, src, headSize);
+            dst += headSize;
+            src += headSize;
+            size -= headSize;
+
+            size_t bodySize = size & ~size_t(63);
+            for (size_t i = 0; i < bodySize; i += 64) {
+                const __m128i* s = reinterpret_cast<const __m128i*>(src + i);
+                __m128i* d = reinterpret_cast<__m128i*>(dst + i);
+                __m128i v0 = _mm_loadu_si128(s + 0);
+                __m128i v1 = _mm_loadu_si128(s + 1);
+                __m128i v2 = _mm_loadu_si128(s + 2);
+                __m128i v3 = _mm_loadu_si128(s + 3);
+                _mm_stream_si128(d + 0, v0);
+                _mm_stream_si128(d + 1, v1);
+                _mm_stream_si128(d + 2, v2);
+                _mm_stream_si128(d + 3, v3);
+            }
+            dst += bodySize;
+            src += bodySize;
+            size -= bodySize;
+#endif
+            memcpy(dst, src, size);
+        }
+
+        void StreamingCopyFence() {
+#if defined(DAWN_PLATFORM_SSE2)
+            _mm_sfence();
+#endif
+        }
+
         void CopyTextureData(uint8_t* dstPointer,
                              const uint8_t* srcPointer,
                              uint32_t depth,
@@ -43,30 +91,48 @@ namespace dawn_native {
                              uint32_t actualBytesPerRow,
                              uint32_t dstBytesPerRow,
                              uint32_t srcBytesPerRow) {
-            bool copyWholeLayer =
-                actualBytesPerRow == dstBytesPerRow && dstBytesPerRow == srcBytesPerRow;
-            bool copyWholeData = copyWholeLayer && imageAdditionalStride == 0;
-
-            if (!copyWholeLayer) {  // copy row by row
+            ASSERT(depth > 0 && rowsPerImage > 0);
+
+            uint64_t copySize = uint64_t(depth) * rowsPerImage * actualBytesPerRow;
+            bool useStreamingStores = copySize >= kStreamingCopyThreshold;
+            auto Copy = [useStreamingStores](uint8_t* dst, const uint8_t* src, uint64_t size) {
+                if (useStreamingStores) {
+                    StreamingCopy(dst, src, static_cast<size_t>(size));
+                } else {
+                    memcpy(dst, src, static_cast<size_t>(size));
+                }
+            };
+
+            if (dstBytesPerRow == srcBytesPerRow) {
+                // Rows have the same pitch in both buffers so the padding at the end of each row
+                // can be copied along with it. The last row isn't padded since the source data
+                // might end right after it.
+                uint64_t dstImageSize = uint64_t(rowsPerImage) * dstBytesPerRow;
+                uint64_t imageCopySize = dstImageSize - dstBytesPerRow + actualBytesPerRow;
+
+                if (imageAdditionalStride == 0) {  // do a single copy
+                    Copy(dstPointer, srcPointer, dstImageSize * (depth - 1) + imageCopySize);
+                } else {  // copy layer by layer
+                    uint64_t srcImageSize = dstImageSize + imageAdditionalStride;
+                    for (uint32_t d = 0; d < depth; ++d) {
+                        Copy(dstPointer, srcPointer, imageCopySize);
+                        dstPointer += dstImageSize;
+                        srcPointer += srcImageSize;
+                    }
+                }
+            } else {  // copy row by row
                 for (uint32_t d = 0; d < depth; ++d) {
                     for (uint32_t h = 0; h < rowsPerImage; ++h) {
-                        memcpy(dstPointer, srcPointer, actualBytesPerRow);
+                        Copy(dstPointer, srcPointer, actualBytesPerRow);
                         dstPointer += dstBytesPerRow;
                         srcPointer += srcBytesPerRow;
                     }
                     srcPointer += imageAdditionalStride;
                 }
-            } else {
-                uint64_t layerSize = uint64_t(rowsPerImage) * actualBytesPerRow;
-                if (!copyWholeData) {  // copy layer by layer
-                    for (uint32_t d = 0; d < depth; ++d) {
-                        memcpy(dstPointer, srcPointer, layerSize);
-                        dstPointer += layerSize;
-                        srcPointer += layerSize + imageAdditionalStride;
-                    }
-                } else {  // do a single copy
-                    memcpy(dstPointer, srcPointer, layerSize * depth);
-                }
+            }
+
+            if (useStreamingStores) {
+                StreamingCopyFence();
             }
         }
 
@@ -142,6 +208,9 @@ namespace dawn_native {
     QueueBase::QueueBase(DeviceBase* device) : ObjectBase(device) {
     }
 
+    QueueBase::QueueBase(DeviceBase* device, QueueType type) : ObjectBase(device), mType(type) {
+    }
+
     QueueBase::QueueBase(DeviceBase* device, ObjectBase::ErrorTag tag) : ObjectBase(device, tag) {
     }
 
@@ -158,7 +227,9 @@ namespace dawn_native {
         SubmitInternal(commandCount, commands);
 
         for (uint32_t i = 0; i < commandCount; ++i) {
-            commands[i]->Destroy();
+            if (!commands[i]->IsReusable()) {
+                commands[i]->Destroy();
+            }
         }
     }
 
@@ -175,6 +246,7 @@ namespace dawn_native {
         fence->UpdateFenceOnComplete(fence, signalValue);
         device->GetErrorScopeTracker()->TrackUntilLastSubmitComplete(
             device->GetCurrentErrorScope());
+        device->GetCountersTracker()->RecordSubmit();
     }
 
     void QueueBase::TrackTask(std::unique_ptr<TaskInFlight> task, ExecutionSerial serial) {
@@ -189,6 +261,14 @@ namespace dawn_native {
         mTasksInFlight.ClearUpTo(finishedSerial);
     }
 
+    QueueType QueueBase::GetType() const {
+        return mType;
+    }
+
+    ExecutionSerial QueueBase::GetCompletedSerial() const {
+        return GetDevice()->GetCompletedCommandSerial();
+    }
+
     Fence* QueueBase::CreateFence(const FenceDescriptor* descriptor) {
         if (GetDevice()->ConsumedError(ValidateCreateFence(descriptor))) {
             return Fence::MakeError(GetDevice());
@@ -213,7 +293,15 @@ namespace dawn_native {
                                               const void* data,
                                               size_t size) {
         DAWN_TRY(ValidateWriteBuffer(buffer, bufferOffset, size));
-        return WriteBufferImpl(buffer, bufferOffset, data, size);
+
+        DeviceBase* device = GetDevice();
+        ExecutionSerial serial = device->GetPendingCommandSerial();
+        DAWN_TRY(WriteBufferImpl(buffer, bufferOffset, data, size));
+
+        if (device->IsValidationEnabled()) {
+            buffer->TrackUsageOnQueue(this, serial);
+        }
+        return {};
     }
 
     MaybeError QueueBase::WriteBufferImpl(BufferBase* buffer,
@@ -282,6 +370,9 @@ namespace dawn_native {
         uint32_t optimallyAlignedBytesPerRow =
             Align(alignedBytesPerRow, optimalBytesPerRowAlignment);
 
+        // The data is always staged, even when its layout is already the optimal one, because
+        // the textures of the backends aren't host-visible and |data| must be consumed before
+        // WriteTexture returns. Writing directly to the texture would need backend support.
         UploadHandle uploadHandle;
         DAWN_TRY_ASSIGN(uploadHandle,
                         UploadTextureDataAligningBytesPerRowAndOffset(
@@ -309,6 +400,8 @@ namespace dawn_native {
     MaybeError QueueBase::ValidateSubmit(uint32_t commandCount,
                                          CommandBufferBase* const* commands) const {
         TRACE_EVENT0(GetDevice()->GetPlatform(), Validation, "Queue::ValidateSubmit");
+        DeviceCountersTracker::ScopedTimer timer(GetDevice()->GetCountersTracker(),
+                                                 DeviceCountersTracker::Timer::ValidateSubmit);
         DAWN_TRY(GetDevice()->ValidateObject(this));
 
         for (uint32_t i = 0; i < commandCount; ++i) {
@@ -318,8 +411,15 @@ namespace dawn_native {
             const CommandBufferResourceUsage& usages = commands[i]->GetResourceUsages();
 
             for (const PassResourceUsage& passUsages : usages.perPass) {
+                if (mType == QueueType::Copy) {
+                    return DAWN_VALIDATION_ERROR("Copy queues can't execute passes");
+                }
+                if (mType == QueueType::Compute && passUsages.passType == PassType::Render) {
+                    return DAWN_VALIDATION_ERROR("Compute queues can't execute render passes");
+                }
+
                 for (const BufferBase* buffer : passUsages.buffers) {
-                    DAWN_TRY(buffer->ValidateCanUseOnQueueNow());
+                    DAWN_TRY(buffer->ValidateCanUseOnQueueNow(this));
                 }
                 for (const TextureBase* texture : passUsages.textures) {
                     DAWN_TRY(texture->ValidateCanUseInSubmitNow());
@@ -327,7 +427,7 @@ namespace dawn_native {
             }
 
             for (const BufferBase* buffer : usages.topLevelBuffers) {
-                DAWN_TRY(buffer->ValidateCanUseOnQueueNow());
+                DAWN_TRY(buffer->ValidateCanUseOnQueueNow(this));
             }
             for (const TextureBase* texture : usages.topLevelTextures) {
                 DAWN_TRY(texture->ValidateCanUseInSubmitNow());
@@ -340,6 +440,23 @@ namespace dawn_native {
         return {};
     }
 
+    void QueueBase::TrackBufferUsages(uint32_t commandCount,
+                                      CommandBufferBase* const* commands,
+                                      ExecutionSerial serial) {
+        for (uint32_t i = 0; i < commandCount; ++i) {
+            const CommandBufferResourceUsage& usages = commands[i]->GetResourceUsages();
+
+            for (const PassResourceUsage& passUsages : usages.perPass) {
+                for (BufferBase* buffer : passUsages.buffers) {
+                    buffer->TrackUsageOnQueue(this, serial);
+                }
+            }
+            for (BufferBase* buffer : usages.topLevelBuffers) {
+                buffer->TrackUsageOnQueue(this, serial);
+            }
+        }
+    }
+
     MaybeError QueueBase::ValidateSignal(const Fence* fence, FenceAPISerial signalValue) const {
         DAWN_TRY(GetDevice()->ValidateIsAlive());
         DAWN_TRY(GetDevice()->ValidateObject(this));
@@ -388,7 +505,7 @@ namespace dawn_native {
             return DAWN_VALIDATION_ERROR("Buffer needs the CopyDst usage bit");
         }
 
-        DAWN_TRY(buffer->ValidateCanUseOnQueueNow());
+        DAWN_TRY(buffer->ValidateCanUseOnQueueNow(this));
 
         return {};
     }
@@ -445,10 +562,15 @@ namespace dawn_native {
         }
         ASSERT(!IsError());
 
+        ExecutionSerial serial = device->GetPendingCommandSerial();
         if (device->ConsumedError(SubmitImpl(commandCount, commands))) {
             return;
         }
 
+        if (device->IsValidationEnabled()) {
+            TrackBufferUsages(commandCount, commands, serial);
+        }
+
         device->GetErrorScopeTracker()->TrackUntilLastSubmitComplete(
             device->GetCurrentErrorScope());
     }
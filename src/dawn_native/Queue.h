@@ -21,6 +21,7 @@
 #include "dawn_native/IntegerTypes.h"
 #include "dawn_native/ObjectBase.h"
 
+#include "dawn_native/DawnNative.h"
 #include "dawn_native/dawn_platform.h"
 
 namespace dawn_native {
@@ -49,10 +50,26 @@ namespace dawn_native {
         void TrackTask(std::unique_ptr<TaskInFlight> task, ExecutionSerial serial);
         void Tick(ExecutionSerial finishedSerial);
 
+        QueueType GetType() const;
+        // The serial up to which the work submitted to this queue is complete. It can be ahead of
+        // the completed serial of the device when the other queues still have work in flight.
+        virtual ExecutionSerial GetCompletedSerial() const;
+
       protected:
         QueueBase(DeviceBase* device);
+        QueueBase(DeviceBase* device, QueueType type);
         QueueBase(DeviceBase* device, ObjectBase::ErrorTag tag);
 
+        // The default implementations upload the data with the device's dynamic uploader.
+        virtual MaybeError WriteBufferImpl(BufferBase* buffer,
+                                           uint64_t bufferOffset,
+                                           const void* data,
+                                           size_t size);
+        virtual MaybeError WriteTextureImpl(const TextureCopyView& destination,
+                                            const void* data,
+                                            const TextureDataLayout& dataLayout,
+                                            const Extent3D& writeSize);
+
       private:
         MaybeError WriteBufferInternal(BufferBase* buffer,
                                        uint64_t bufferOffset,
@@ -66,17 +83,12 @@ namespace dawn_native {
 
         virtual MaybeError SubmitImpl(uint32_t commandCount,
                                       CommandBufferBase* const* commands) = 0;
-        virtual MaybeError WriteBufferImpl(BufferBase* buffer,
-                                           uint64_t bufferOffset,
-                                           const void* data,
-                                           size_t size);
-        virtual MaybeError WriteTextureImpl(const TextureCopyView& destination,
-                                            const void* data,
-                                            const TextureDataLayout& dataLayout,
-                                            const Extent3D& writeSize);
 
         MaybeError ValidateSubmit(uint32_t commandCount, CommandBufferBase* const* commands) const;
         MaybeError ValidateSignal(const Fence* fence, FenceAPISerial signalValue) const;
+        void TrackBufferUsages(uint32_t commandCount,
+                               CommandBufferBase* const* commands,
+                               ExecutionSerial serial);
         MaybeError ValidateCreateFence(const FenceDescriptor* descriptor) const;
         MaybeError ValidateWriteBuffer(const BufferBase* buffer,
                                        uint64_t bufferOffset,
@@ -89,6 +101,7 @@ namespace dawn_native {
         void SubmitInternal(uint32_t commandCount, CommandBufferBase* const* commands);
 
         SerialQueue<ExecutionSerial, std::unique_ptr<TaskInFlight>> mTasksInFlight;
+        QueueType mType = QueueType::General;
     };
 
 }  // namespace dawn_native
@@ -17,6 +17,7 @@
 #include "common/BitSetIterator.h"
 #include "dawn_native/Commands.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/RenderBundleEncoder.h"
 
 namespace dawn_native {
@@ -29,9 +30,13 @@ namespace dawn_native {
           mCommands(encoder->AcquireCommands()),
           mAttachmentState(attachmentState),
           mResourceUsage(std::move(resourceUsage)) {
+        GetDevice()->GetCountersTracker()->RecordMemoryAllocated(
+            DeviceCountersTracker::Memory::Commands, mCommands.GetAllocatedBytes());
     }
 
     RenderBundleBase::~RenderBundleBase() {
+        GetDevice()->GetCountersTracker()->RecordMemoryFreed(
+            DeviceCountersTracker::Memory::Commands, mCommands.GetAllocatedBytes());
         FreeCommands(&mCommands);
     }
 
@@ -17,6 +17,7 @@
 #include "dawn_native/CommandValidation.h"
 #include "dawn_native/Commands.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/Format.h"
 #include "dawn_native/RenderPipeline.h"
 #include "dawn_native/ValidationUtils_autogen.h"
@@ -122,6 +123,8 @@ namespace dawn_native {
     MaybeError RenderBundleEncoder::ValidateFinish(CommandIterator* commands,
                                                    const PassResourceUsage& usages) const {
         TRACE_EVENT0(GetDevice()->GetPlatform(), Validation, "RenderBundleEncoder::ValidateFinish");
+        DeviceCountersTracker::ScopedTimer timer(GetDevice()->GetCountersTracker(),
+                                                 DeviceCountersTracker::Timer::ValidateFinish);
         DAWN_TRY(GetDevice()->ValidateObject(this));
         DAWN_TRY(ValidatePassResourceUsage(usages));
         DAWN_TRY(ValidateRenderBundle(commands, mAttachmentState.Get()));
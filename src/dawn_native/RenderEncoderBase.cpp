@@ -132,6 +132,71 @@ namespace dawn_native {
         });
     }
 
+    void RenderEncoderBase::MultiDraw(uint32_t drawCount, const DrawArguments* draws) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (drawCount == 0) {
+                return {};
+            }
+
+            if (mDisableBaseInstance) {
+                for (uint32_t i = 0; i < drawCount; ++i) {
+                    if (draws[i].firstInstance != 0) {
+                        return DAWN_VALIDATION_ERROR("Non-zero first instance not supported");
+                    }
+                }
+            }
+
+            // All the draws share the same state so they are stored in a single command and
+            // validated at once when the pass is validated.
+            DrawCmd* drawCmds;
+            MultiDrawCmd* cmd =
+                allocator->AllocateWithData<MultiDrawCmd>(Command::MultiDraw, drawCount, &drawCmds);
+            cmd->drawCount = drawCount;
+            for (uint32_t i = 0; i < drawCount; ++i) {
+                drawCmds[i].vertexCount = draws[i].vertexCount;
+                drawCmds[i].instanceCount = draws[i].instanceCount;
+                drawCmds[i].firstVertex = draws[i].firstVertex;
+                drawCmds[i].firstInstance = draws[i].firstInstance;
+            }
+
+            return {};
+        });
+    }
+
+    void RenderEncoderBase::MultiDrawIndexed(uint32_t drawCount,
+                                             const DrawIndexedArguments* draws) {
+        mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
+            if (drawCount == 0) {
+                return {};
+            }
+
+            if (mDisableBaseInstance) {
+                for (uint32_t i = 0; i < drawCount; ++i) {
+                    if (draws[i].firstInstance != 0) {
+                        return DAWN_VALIDATION_ERROR("Non-zero first instance not supported");
+                    }
+                    if (draws[i].baseVertex != 0) {
+                        return DAWN_VALIDATION_ERROR("Non-zero base vertex not supported");
+                    }
+                }
+            }
+
+            DrawIndexedCmd* drawCmds;
+            MultiDrawIndexedCmd* cmd = allocator->AllocateWithData<MultiDrawIndexedCmd>(
+                Command::MultiDrawIndexed, drawCount, &drawCmds);
+            cmd->drawCount = drawCount;
+            for (uint32_t i = 0; i < drawCount; ++i) {
+                drawCmds[i].indexCount = draws[i].indexCount;
+                drawCmds[i].instanceCount = draws[i].instanceCount;
+                drawCmds[i].firstIndex = draws[i].firstIndex;
+                drawCmds[i].baseVertex = draws[i].baseVertex;
+                drawCmds[i].firstInstance = draws[i].firstInstance;
+            }
+
+            return {};
+        });
+    }
+
     void RenderEncoderBase::SetPipeline(RenderPipelineBase* pipeline) {
         mEncodingContext->TryEncode(this, [&](CommandAllocator* allocator) -> MaybeError {
             DAWN_TRY(GetDevice()->ValidateObject(pipeline));
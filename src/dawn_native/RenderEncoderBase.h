@@ -37,6 +37,9 @@ namespace dawn_native {
         void DrawIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset);
         void DrawIndexedIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset);
 
+        void MultiDraw(uint32_t drawCount, const DrawArguments* draws);
+        void MultiDrawIndexed(uint32_t drawCount, const DrawIndexedArguments* draws);
+
         void SetPipeline(RenderPipelineBase* pipeline);
 
         void SetVertexBuffer(uint32_t slot, BufferBase* buffer, uint64_t offset, uint64_t size);
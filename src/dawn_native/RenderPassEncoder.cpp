@@ -154,11 +154,10 @@ namespace dawn_native {
                 DAWN_TRY(GetDevice()->ValidateObject(renderBundles[i]));
             }
 
-            ExecuteBundlesCmd* cmd =
-                allocator->Allocate<ExecuteBundlesCmd>(Command::ExecuteBundles);
+            Ref<RenderBundleBase>* bundles;
+            ExecuteBundlesCmd* cmd = allocator->AllocateWithData<ExecuteBundlesCmd>(
+                Command::ExecuteBundles, count, &bundles);
             cmd->count = count;
-
-            Ref<RenderBundleBase>* bundles = allocator->AllocateData<Ref<RenderBundleBase>>(count);
             for (uint32_t i = 0; i < count; ++i) {
                 bundles[i] = renderBundles[i];
 
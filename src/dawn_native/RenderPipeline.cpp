@@ -18,6 +18,7 @@
 #include "common/HashUtils.h"
 #include "dawn_native/Commands.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/ValidationUtils_autogen.h"
 
 #include <cmath>
@@ -468,6 +469,9 @@ namespace dawn_native {
 
         // TODO(cwallez@chromium.org): Check against the shader module that the correct color
         // attachment are set?
+
+        device->GetCountersTracker()->RecordObjectCreated(
+            DeviceCountersTracker::LiveObject::RenderPipeline);
     }
 
     RenderPipelineBase::RenderPipelineBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -480,6 +484,10 @@ namespace dawn_native {
     }
 
     RenderPipelineBase::~RenderPipelineBase() {
+        if (!IsError()) {
+            GetDevice()->GetCountersTracker()->RecordObjectDestroyed(
+                DeviceCountersTracker::LiveObject::RenderPipeline);
+        }
         if (IsCachedReference()) {
             GetDevice()->UncacheRenderPipeline(this);
         }
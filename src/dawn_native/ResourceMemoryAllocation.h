@@ -46,6 +46,9 @@ namespace dawn_native {
         // allocation offset is always local to the memory.
         uint64_t mBlockOffset = 0;
 
+        // The size requested for the allocation, used to report the memory usage.
+        uint64_t mRequestedSize = 0;
+
         AllocationMethod mMethod = AllocationMethod::kInvalid;
     };
 
@@ -16,6 +16,7 @@
 
 #include "common/HashUtils.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/ValidationUtils_autogen.h"
 
 #include <cmath>
@@ -63,6 +64,8 @@ namespace dawn_native {
           mLodMinClamp(descriptor->lodMinClamp),
           mLodMaxClamp(descriptor->lodMaxClamp),
           mCompareFunction(descriptor->compare) {
+        device->GetCountersTracker()->RecordObjectCreated(
+            DeviceCountersTracker::LiveObject::Sampler);
     }
 
     SamplerBase::SamplerBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -70,6 +73,10 @@ namespace dawn_native {
     }
 
     SamplerBase::~SamplerBase() {
+        if (!IsError()) {
+            GetDevice()->GetCountersTracker()->RecordObjectDestroyed(
+                DeviceCountersTracker::LiveObject::Sampler);
+        }
         if (IsCachedReference()) {
             GetDevice()->UncacheSampler(this);
         }
@@ -0,0 +1,105 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/ScratchBufferAllocator.h"
+
+#include "common/Math.h"
+#include "dawn_native/Buffer.h"
+#include "dawn_native/Device.h"
+
+#include <algorithm>
+
+namespace dawn_native {
+
+    constexpr uint64_t ScratchBufferAllocator::kMinRingBufferSize;
+    constexpr uint64_t ScratchBufferAllocator::kMaxIdleRingBufferSize;
+
+    ScratchBufferAllocator::ScratchBufferAllocator(DeviceBase* device) : mDevice(device) {
+    }
+
+    ScratchBufferAllocator::~ScratchBufferAllocator() = default;
+
+    ResultOrError<ScratchBufferAllocation> ScratchBufferAllocator::Allocate(
+        uint64_t allocationSize,
+        ExecutionSerial serial,
+        uint64_t offsetAlignment) {
+        ASSERT(offsetAlignment > 0);
+        const uint64_t paddedSize = allocationSize + offsetAlignment - 1;
+
+        RingBuffer* targetRingBuffer = nullptr;
+        uint64_t startOffset = RingBufferAllocator::kInvalidOffset;
+        for (const std::unique_ptr<RingBuffer>& ringBuffer : mRingBuffers) {
+            startOffset = ringBuffer->allocator.Allocate(paddedSize, serial);
+            if (startOffset != RingBufferAllocator::kInvalidOffset) {
+                targetRingBuffer = ringBuffer.get();
+                break;
+            }
+        }
+
+        // Upon failure, add a ring buffer twice as large as the largest one. The smaller ring
+        // buffers are released once they are no longer in use, so the allocator converges to a
+        // single ring buffer large enough for the copies in flight.
+        if (targetRingBuffer == nullptr) {
+            uint64_t ringBufferSize = std::max(kMinRingBufferSize, NextPowerOfTwo(paddedSize));
+            if (!mRingBuffers.empty()) {
+                ringBufferSize =
+                    std::max(ringBufferSize, 2 * mRingBuffers.back()->allocator.GetSize());
+            }
+
+            BufferDescriptor descriptor;
+            descriptor.size = ringBufferSize;
+            descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+
+            Ref<BufferBase> buffer;
+            DAWN_TRY_ASSIGN(buffer, mDevice->CreateBufferInternal(&descriptor));
+
+            mRingBuffers.emplace_back(std::unique_ptr<RingBuffer>(
+                new RingBuffer{std::move(buffer), RingBufferAllocator(ringBufferSize)}));
+            targetRingBuffer = mRingBuffers.back().get();
+            startOffset = targetRingBuffer->allocator.Allocate(paddedSize, serial);
+        }
+
+        ASSERT(startOffset != RingBufferAllocator::kInvalidOffset);
+
+        ScratchBufferAllocation allocation;
+        allocation.buffer = targetRingBuffer->buffer.Get();
+        allocation.offset = Align(startOffset, offsetAlignment);
+        return allocation;
+    }
+
+    void ScratchBufferAllocator::Deallocate(ExecutionSerial lastCompletedSerial) {
+        for (const std::unique_ptr<RingBuffer>& ringBuffer : mRingBuffers) {
+            ringBuffer->allocator.Deallocate(lastCompletedSerial);
+        }
+
+        // Release the empty ring buffers, except the largest one if it is small enough to be
+        // worth keeping for the next copies.
+        const size_t largestIndex = mRingBuffers.size() - 1;
+        for (size_t i = mRingBuffers.size(); i-- > 0;) {
+            const RingBufferAllocator& allocator = mRingBuffers[i]->allocator;
+            if (allocator.Empty() &&
+                (i != largestIndex || allocator.GetSize() > kMaxIdleRingBufferSize)) {
+                mRingBuffers.erase(mRingBuffers.begin() + i);
+            }
+        }
+    }
+
+    void ScratchBufferAllocator::ReportMemoryUsage(DeviceMemoryUsage* usage) const {
+        for (const std::unique_ptr<RingBuffer>& ringBuffer : mRingBuffers) {
+            usage->scratchBytes += ringBuffer->allocator.GetSize();
+            usage->scratchUsedBytes += ringBuffer->allocator.GetUsedSize();
+        }
+    }
+
+}  // namespace dawn_native
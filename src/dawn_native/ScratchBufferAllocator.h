@@ -0,0 +1,72 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_SCRATCHBUFFERALLOCATOR_H_
+#define DAWNNATIVE_SCRATCHBUFFERALLOCATOR_H_
+
+#include "common/RefCounted.h"
+#include "dawn_native/DawnNative.h"
+#include "dawn_native/Error.h"
+#include "dawn_native/Forward.h"
+#include "dawn_native/IntegerTypes.h"
+#include "dawn_native/RingBufferAllocator.h"
+
+#include <memory>
+#include <vector>
+
+namespace dawn_native {
+
+    struct ScratchBufferAllocation {
+        BufferBase* buffer = nullptr;
+        uint64_t offset = 0;
+    };
+
+    // Sub-allocates the GPU-only buffers used as intermediate storage by the internal copies of
+    // the backends, for example texture-to-texture copies done through a buffer. Like the
+    // DynamicUploader, the memory is managed as ring buffers and an allocation can be reused
+    // once its serial has completed, so that internal copies don't create a buffer each time.
+    // The buffers have the CopySrc and CopyDst usages.
+    class ScratchBufferAllocator {
+      public:
+        ScratchBufferAllocator(DeviceBase* device);
+        ~ScratchBufferAllocator();
+
+        // The allocation is valid until |serial| has completed.
+        ResultOrError<ScratchBufferAllocation> Allocate(uint64_t allocationSize,
+                                                        ExecutionSerial serial,
+                                                        uint64_t offsetAlignment);
+        void Deallocate(ExecutionSerial lastCompletedSerial);
+
+        // Adds the size of the scratch memory and the part of it in use to |usage|.
+        void ReportMemoryUsage(DeviceMemoryUsage* usage) const;
+
+      private:
+        static constexpr uint64_t kMinRingBufferSize = 4 * 1024 * 1024;
+        // The largest ring buffer is kept when it's empty so that the next copies don't have to
+        // create it again, unless it is larger than this.
+        static constexpr uint64_t kMaxIdleRingBufferSize = 64 * 1024 * 1024;
+
+        struct RingBuffer {
+            Ref<BufferBase> buffer;
+            RingBufferAllocator allocator;
+        };
+
+        // The ring buffers are sorted by size so the last one is the largest.
+        std::vector<std::unique_ptr<RingBuffer>> mRingBuffers;
+        DeviceBase* mDevice;
+    };
+
+}  // namespace dawn_native
+
+#endif  // DAWNNATIVE_SCRATCHBUFFERALLOCATOR_H_
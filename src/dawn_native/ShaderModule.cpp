@@ -17,6 +17,7 @@
 #include "common/HashUtils.h"
 #include "dawn_native/BindGroupLayout.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/Pipeline.h"
 #include "dawn_native/PipelineLayout.h"
 #include "dawn_native/SpirvUtils.h"
@@ -824,6 +825,9 @@ namespace dawn_native {
             default:
                 UNREACHABLE();
         }
+
+        device->GetCountersTracker()->RecordObjectCreated(
+            DeviceCountersTracker::LiveObject::ShaderModule);
     }
 
     ShaderModuleBase::ShaderModuleBase(DeviceBase* device, ObjectBase::ErrorTag tag)
@@ -831,6 +835,10 @@ namespace dawn_native {
     }
 
     ShaderModuleBase::~ShaderModuleBase() {
+        if (!IsError()) {
+            GetDevice()->GetCountersTracker()->RecordObjectDestroyed(
+                DeviceCountersTracker::LiveObject::ShaderModule);
+        }
         if (IsCachedReference()) {
             GetDevice()->UncacheShaderModule(this);
         }
@@ -882,6 +890,10 @@ namespace dawn_native {
         return mSpirv;
     }
 
+    size_t ShaderModuleBase::GetCodeByteSize() const {
+        return (mOriginalSpirv.size() + mSpirv.size()) * sizeof(uint32_t) + mWgsl.size();
+    }
+
 #ifdef DAWN_ENABLE_WGSL
     ResultOrError<std::vector<uint32_t>> ShaderModuleBase::GeneratePullingSpirv(
         const VertexStateDescriptor& vertexState,
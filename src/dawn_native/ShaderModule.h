@@ -112,6 +112,9 @@ namespace dawn_native {
 
         const std::vector<uint32_t>& GetSpirv() const;
 
+        // The size of the shader code held by the module, used to report the memory usage.
+        size_t GetCodeByteSize() const;
+
 #ifdef DAWN_ENABLE_WGSL
         ResultOrError<std::vector<uint32_t>> GeneratePullingSpirv(
             const VertexStateDescriptor& vertexState,
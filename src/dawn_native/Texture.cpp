@@ -20,6 +20,7 @@
 #include "common/Constants.h"
 #include "common/Math.h"
 #include "dawn_native/Device.h"
+#include "dawn_native/DeviceCountersTracker.h"
 #include "dawn_native/EnumMaskIterator.h"
 #include "dawn_native/PassResourceUsage.h"
 #include "dawn_native/ValidationUtils_autogen.h"
@@ -404,6 +405,28 @@ namespace dawn_native {
         if (mUsage & wgpu::TextureUsage::Storage) {
             mUsage |= kReadonlyStorageTexture;
         }
+
+        device->GetCountersTracker()->RecordObjectCreated(
+            DeviceCountersTracker::LiveObject::Texture);
+
+        // The memory of external textures isn't owned by the device.
+        if (mState == TextureState::OwnedInternal) {
+            device->GetCountersTracker()->RecordMemoryAllocated(
+                DeviceCountersTracker::Memory::Textures, ComputeEstimatedByteSize());
+        }
+    }
+
+    TextureBase::~TextureBase() {
+        if (!IsError()) {
+            GetDevice()->GetCountersTracker()->RecordObjectDestroyed(
+                DeviceCountersTracker::LiveObject::Texture);
+
+            // Backends usually destroy the texture in their destructor, which frees its memory.
+            if (mState == TextureState::OwnedInternal) {
+                GetDevice()->GetCountersTracker()->RecordMemoryFreed(
+                    DeviceCountersTracker::Memory::Textures, ComputeEstimatedByteSize());
+            }
+        }
     }
 
     static Format kUnusedFormat;
@@ -600,9 +623,26 @@ namespace dawn_native {
 
     void TextureBase::DestroyInternal() {
         DestroyImpl();
+        if (mState == TextureState::OwnedInternal) {
+            GetDevice()->GetCountersTracker()->RecordMemoryFreed(
+                DeviceCountersTracker::Memory::Textures, ComputeEstimatedByteSize());
+        }
         mState = TextureState::Destroyed;
     }
 
+    uint64_t TextureBase::ComputeEstimatedByteSize() const {
+        uint64_t byteSize = 0;
+        for (Aspect aspect : IterateEnumMask(mFormat.aspects)) {
+            const TexelBlockInfo& blockInfo = mFormat.GetAspectInfo(aspect).block;
+            for (uint32_t level = 0; level < mMipLevelCount; ++level) {
+                Extent3D extent = GetMipLevelPhysicalSize(level);
+                byteSize += uint64_t(extent.width / blockInfo.width) *
+                            (extent.height / blockInfo.height) * extent.depth * blockInfo.byteSize;
+            }
+        }
+        return byteSize * GetArrayLayers() * mSampleCount;
+    }
+
     MaybeError TextureBase::ValidateDestroy() const {
         DAWN_TRY(GetDevice()->ValidateObject(this));
         return {};
@@ -93,6 +93,7 @@ namespace dawn_native {
         enum class TextureState { OwnedInternal, OwnedExternal, Destroyed };
         enum class ClearValue { Zero, NonZero };
         TextureBase(DeviceBase* device, const TextureDescriptor* descriptor, TextureState state);
+        ~TextureBase() override;
 
         static TextureBase* MakeError(DeviceBase* device);
 
@@ -140,6 +141,10 @@ namespace dawn_native {
         virtual void DestroyImpl();
 
         MaybeError ValidateDestroy() const;
+
+        // The size of the texels of all the subresources, used to report the memory usage.
+        uint64_t ComputeEstimatedByteSize() const;
+
         wgpu::TextureDimension mDimension;
         // TODO(cwallez@chromium.org): This should be deduplicated in the Device
         const Format& mFormat;
@@ -133,7 +133,35 @@ namespace dawn_native {
              {Toggle::MetalEnableVertexPulling,
               {"metal_enable_vertex_pulling",
                "Uses vertex pulling to protect out-of-bounds reads on Metal",
-               "https://crbug.com/dawn/480"}}}};
+               "https://crbug.com/dawn/480"}},
+             {Toggle::DeferObjectDestruction,
+              {"defer_object_destruction",
+               "Objects whose last reference is released are queued and destroyed in batches by "
+               "Device::Tick instead of immediately. This keeps backend destruction off the thread "
+               "and the call that released the object.",
+               ""}},
+             {Toggle::OpenGLUsePersistentlyMappedStaging,
+              {"opengl_use_persistently_mapped_staging",
+               "Stream Queue::WriteBuffer, Queue::WriteTexture and lazy texture clears through "
+               "staging buffers created with glBufferStorage that stay mapped for their whole "
+               "lifetime, instead of uploading with glBufferSubData or temporary buffers. This "
+               "toggle is enabled by default on desktop GL 4.4 and above.",
+               ""}},
+             {Toggle::NullUseAsyncTimeline,
+              {"null_use_async_timeline",
+               "Execute the work of the Null backend on a separate thread and only complete its "
+               "serials when that thread is done with it, instead of completing them immediately. "
+               "The latency and bandwidth of the thread are set with "
+               "dawn_native::null::SetAsyncTimelineOptions. This lets tests and benchmarks "
+               "exercise the code waiting for the GPU without a GPU.",
+               ""}},
+             {Toggle::VulkanRecordRenderPassesInParallel,
+              {"vulkan_record_render_passes_in_parallel",
+               "Split the render passes with many commands into chunks recorded in secondary "
+               "command buffers on worker threads, and execute the chunks from the primary "
+               "command buffer. This toggle is disabled by default, embedders can enable it when "
+               "they record large render passes.",
+               ""}}}};
 
     }  // anonymous namespace
 
@@ -43,6 +43,10 @@ namespace dawn_native {
         UseDXC,
         DisableRobustness,
         MetalEnableVertexPulling,
+        DeferObjectDestruction,
+        OpenGLUsePersistentlyMappedStaging,
+        NullUseAsyncTimeline,
+        VulkanRecordRenderPassesInParallel,
 
         EnumCount,
         InvalidEnum = EnumCount,
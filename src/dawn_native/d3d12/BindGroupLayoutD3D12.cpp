@@ -169,6 +169,10 @@ namespace dawn_native { namespace d3d12 {
         mBindGroupAllocator.Deallocate(bindGroup);
     }
 
+    size_t BindGroupLayout::GetBindGroupAllocatorBytes() const {
+        return mBindGroupAllocator.GetAllocatedBytes();
+    }
+
     ityp::span<BindingIndex, const uint32_t> BindGroupLayout::GetBindingOffsets() const {
         return {mBindingOffsets.data(), mBindingOffsets.size()};
     }
@@ -37,6 +37,8 @@ namespace dawn_native { namespace d3d12 {
                                                     const BindGroupDescriptor* descriptor);
         void DeallocateBindGroup(BindGroup* bindGroup, CPUDescriptorHeapAllocation* viewAllocation);
 
+        size_t GetBindGroupAllocatorBytes() const override;
+
         enum DescriptorType {
             CBV,
             UAV,
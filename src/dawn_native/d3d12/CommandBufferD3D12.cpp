@@ -582,25 +582,9 @@ namespace dawn_native { namespace d3d12 {
             }
         }
 
-    }  // anonymous namespace
-
-    CommandBuffer::CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor)
-        : CommandBufferBase(encoder, descriptor) {
-    }
-
-    MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* commandContext) {
-        Device* device = ToBackend(GetDevice());
-        BindGroupStateTracker bindingTracker(device);
-
-        ID3D12GraphicsCommandList* commandList = commandContext->GetCommandList();
-
-        // Make sure we use the correct descriptors for this command list. Could be done once per
-        // actual command list but here is ok because there should be few command buffers.
-        bindingTracker.SetID3D12DescriptorHeaps(commandList);
-
         // Records the necessary barriers for the resource usage pre-computed by the frontend
-        auto PrepareResourcesForRenderPass = [](CommandRecordingContext* commandContext,
-                                                const PassResourceUsage& usages) -> bool {
+        bool PrepareResourcesForRenderPass(CommandRecordingContext* commandContext,
+                                           const PassResourceUsage& usages) {
             std::vector<D3D12_RESOURCE_BARRIER> barriers;
 
             ID3D12GraphicsCommandList* commandList = commandContext->GetCommandList();
@@ -626,12 +610,11 @@ namespace dawn_native { namespace d3d12 {
 
             for (size_t i = 0; i < usages.textures.size(); ++i) {
                 Texture* texture = ToBackend(usages.textures[i]);
-                // Clear textures that are not output attachments. Output attachments will be
-                // cleared during record render pass if the texture subresource has not been
-                // initialized before the render pass.
-                if (!(usages.textureUsages[i].usage & wgpu::TextureUsage::OutputAttachment)) {
-                    texture->EnsureSubresourceContentInitialized(commandContext,
-                                                                 texture->GetAllSubresources());
+                // Clear the subresources used in the pass that are not output attachments. Output
+                // attachments will be cleared during record render pass if the texture
+                // subresource has not been initialized before the render pass.
+                for (const SubresourceRange& range : usages.textureUsages[i].lazyClearRanges) {
+                    texture->EnsureSubresourceContentInitialized(commandContext, range);
                 }
 
                 ToBackend(usages.textures[i])
@@ -646,12 +629,12 @@ namespace dawn_native { namespace d3d12 {
 
             return (bufferUsages & wgpu::BufferUsage::Storage ||
                     textureUsages & wgpu::TextureUsage::Storage);
-        };
+        }
 
         // TODO(jiawei.shao@intel.com): move the resource lazy clearing inside the barrier tracking
         // for compute passes.
-        auto PrepareResourcesForComputePass = [](CommandRecordingContext* commandContext,
-                                                 const PassResourceUsage& usages) -> void {
+        void PrepareResourcesForComputePass(CommandRecordingContext* commandContext,
+                                            const PassResourceUsage& usages) {
             for (size_t i = 0; i < usages.buffers.size(); ++i) {
                 Buffer* buffer = ToBackend(usages.buffers[i]);
 
@@ -662,412 +645,611 @@ namespace dawn_native { namespace d3d12 {
 
             for (size_t i = 0; i < usages.textures.size(); ++i) {
                 Texture* texture = ToBackend(usages.textures[i]);
-                texture->EnsureSubresourceContentInitialized(commandContext,
-                                                             texture->GetAllSubresources());
+                for (const SubresourceRange& range : usages.textureUsages[i].lazyClearRanges) {
+                    texture->EnsureSubresourceContentInitialized(commandContext, range);
+                }
             }
-        };
+        }
 
-        const std::vector<PassResourceUsage>& passResourceUsages = GetResourceUsages().perPass;
-        uint32_t nextPassNumber = 0;
+        void RecordInsertDebugMarker(Device* device,
+                                     ID3D12GraphicsCommandList* commandList,
+                                     const char* label) {
+            if (device->GetFunctions()->IsPIXEventRuntimeLoaded()) {
+                // PIX color is 1 byte per channel in ARGB format
+                constexpr uint64_t kPIXBlackColor = 0xff000000;
+                device->GetFunctions()->pixSetMarkerOnCommandList(commandList, kPIXBlackColor,
+                                                                  label);
+            }
+        }
 
-        Command type;
-        while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::BeginComputePass: {
-                    mCommands.NextCommand<BeginComputePassCmd>();
+        void RecordPushDebugGroup(Device* device,
+                                  ID3D12GraphicsCommandList* commandList,
+                                  const char* label) {
+            if (device->GetFunctions()->IsPIXEventRuntimeLoaded()) {
+                // PIX color is 1 byte per channel in ARGB format
+                constexpr uint64_t kPIXBlackColor = 0xff000000;
+                device->GetFunctions()->pixBeginEventOnCommandList(commandList, kPIXBlackColor,
+                                                                   label);
+            }
+        }
 
-                    PrepareResourcesForComputePass(commandContext,
-                                                   passResourceUsages[nextPassNumber]);
-                    bindingTracker.SetInComputePass(true);
-                    DAWN_TRY(RecordComputePass(commandContext, &bindingTracker));
+        void RecordPopDebugGroup(Device* device, ID3D12GraphicsCommandList* commandList) {
+            if (device->GetFunctions()->IsPIXEventRuntimeLoaded()) {
+                device->GetFunctions()->pixEndEventOnCommandList(commandList);
+            }
+        }
 
-                    nextPassNumber++;
-                    break;
-                }
+        // Records the commands of a compute pass other than EndComputePass.
+        class ComputePassRecorder {
+          public:
+            ComputePassRecorder(Device* device,
+                                CommandRecordingContext* commandContext,
+                                BindGroupStateTracker* bindingTracker)
+                : mDevice(device),
+                  mCommandContext(commandContext),
+                  mCommandList(commandContext->GetCommandList()),
+                  mBindingTracker(bindingTracker) {
+            }
 
-                case Command::BeginRenderPass: {
-                    BeginRenderPassCmd* beginRenderPassCmd =
-                        mCommands.NextCommand<BeginRenderPassCmd>();
+            template <typename T, typename D>
+            MaybeError operator()(T*, D*) {
+                UNREACHABLE();
+                return {};
+            }
 
-                    const bool passHasUAV = PrepareResourcesForRenderPass(
-                        commandContext, passResourceUsages[nextPassNumber]);
-                    bindingTracker.SetInComputePass(false);
+            MaybeError operator()(DispatchCmd* dispatch, CommandData<DispatchCmd>::Type*) {
+                DAWN_TRY(mBindingTracker->Apply(mCommandContext));
+                mCommandList->Dispatch(dispatch->x, dispatch->y, dispatch->z);
+                return {};
+            }
 
-                    LazyClearRenderPassAttachments(beginRenderPassCmd);
-                    DAWN_TRY(RecordRenderPass(commandContext, &bindingTracker, beginRenderPassCmd,
-                                              passHasUAV));
+            MaybeError operator()(DispatchIndirectCmd* dispatch,
+                                  CommandData<DispatchIndirectCmd>::Type*) {
+                DAWN_TRY(mBindingTracker->Apply(mCommandContext));
+                Buffer* buffer = ToBackend(dispatch->indirectBuffer.Get());
+                buffer->TrackUsageAndTransitionNow(mCommandContext, wgpu::BufferUsage::Indirect);
+                ComPtr<ID3D12CommandSignature> signature = mDevice->GetDispatchIndirectSignature();
+                mCommandList->ExecuteIndirect(signature.Get(), 1, buffer->GetD3D12Resource(),
+                                              dispatch->indirectOffset, nullptr, 0);
+                return {};
+            }
 
-                    nextPassNumber++;
-                    break;
-                }
+            MaybeError operator()(SetComputePipelineCmd* cmd,
+                                  CommandData<SetComputePipelineCmd>::Type*) {
+                ComputePipeline* pipeline = ToBackend(cmd->pipeline).Get();
+                PipelineLayout* layout = ToBackend(pipeline->GetLayout());
 
-                case Command::CopyBufferToBuffer: {
-                    CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
-                    Buffer* srcBuffer = ToBackend(copy->source.Get());
-                    Buffer* dstBuffer = ToBackend(copy->destination.Get());
+                mCommandList->SetComputeRootSignature(layout->GetRootSignature());
+                mCommandList->SetPipelineState(pipeline->GetPipelineState());
 
-                    DAWN_TRY(srcBuffer->EnsureDataInitialized(commandContext));
-                    DAWN_TRY(dstBuffer->EnsureDataInitializedAsDestination(
-                        commandContext, copy->destinationOffset, copy->size));
+                mBindingTracker->OnSetPipeline(pipeline);
+                return {};
+            }
 
-                    srcBuffer->TrackUsageAndTransitionNow(commandContext,
-                                                          wgpu::BufferUsage::CopySrc);
-                    dstBuffer->TrackUsageAndTransitionNow(commandContext,
-                                                          wgpu::BufferUsage::CopyDst);
+            MaybeError operator()(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                BindGroup* group = ToBackend(cmd->group.Get());
+                mBindingTracker->OnSetBindGroup(
+                    cmd->index, group, cmd->dynamicOffsetCount,
+                    cmd->dynamicOffsetCount > 0 ? dynamicOffsets : nullptr);
+                return {};
+            }
 
-                    commandList->CopyBufferRegion(
-                        dstBuffer->GetD3D12Resource(), copy->destinationOffset,
-                        srcBuffer->GetD3D12Resource(), copy->sourceOffset, copy->size);
-                    break;
-                }
+            MaybeError operator()(InsertDebugMarkerCmd*, char* label) {
+                RecordInsertDebugMarker(mDevice, mCommandList, label);
+                return {};
+            }
 
-                case Command::CopyBufferToTexture: {
-                    CopyBufferToTextureCmd* copy = mCommands.NextCommand<CopyBufferToTextureCmd>();
-                    Buffer* buffer = ToBackend(copy->source.buffer.Get());
-                    Texture* texture = ToBackend(copy->destination.texture.Get());
+            MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                RecordPopDebugGroup(mDevice, mCommandList);
+                return {};
+            }
 
-                    DAWN_TRY(buffer->EnsureDataInitialized(commandContext));
+            MaybeError operator()(PushDebugGroupCmd*, char* label) {
+                RecordPushDebugGroup(mDevice, mCommandList, label);
+                return {};
+            }
 
-                    ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
-                    SubresourceRange subresources =
-                        GetSubresourcesAffectedByCopy(copy->destination, copy->copySize);
+            MaybeError operator()(WriteTimestampCmd* cmd, CommandData<WriteTimestampCmd>::Type*) {
+                RecordWriteTimestampCmd(mCommandList, cmd);
+                return {};
+            }
 
-                    if (IsCompleteSubresourceCopiedTo(texture, copy->copySize,
-                                                      copy->destination.mipLevel)) {
-                        texture->SetIsSubresourceContentInitialized(true, subresources);
-                    } else {
-                        texture->EnsureSubresourceContentInitialized(commandContext, subresources);
-                    }
+          private:
+            Device* mDevice;
+            CommandRecordingContext* mCommandContext;
+            ID3D12GraphicsCommandList* mCommandList;
+            BindGroupStateTracker* mBindingTracker;
+        };
 
-                    buffer->TrackUsageAndTransitionNow(commandContext, wgpu::BufferUsage::CopySrc);
-                    texture->TrackUsageAndTransitionNow(commandContext, wgpu::TextureUsage::CopyDst,
-                                                        subresources);
+        // Records the commands of a render pass other than EndRenderPass, and the commands of the
+        // bundles it executes.
+        class RenderPassRecorder {
+          public:
+            RenderPassRecorder(Device* device,
+                               CommandRecordingContext* commandContext,
+                               BindGroupStateTracker* bindingTracker)
+                : mDevice(device),
+                  mCommandContext(commandContext),
+                  mCommandList(commandContext->GetCommandList()),
+                  mBindingTracker(bindingTracker) {
+            }
 
-                    // compute the copySplits and record the CopyTextureRegion commands
-                    CopyBufferToTextureWithCopySplit(
-                        commandContext, copy->destination, copy->copySize, texture,
-                        buffer->GetD3D12Resource(), copy->source.offset, copy->source.bytesPerRow,
-                        copy->source.rowsPerImage, subresources.aspects);
+            template <typename T, typename D>
+            MaybeError operator()(T*, D*) {
+                UNREACHABLE();
+                return {};
+            }
 
-                    break;
-                }
+            MaybeError operator()(DrawCmd* draw, CommandData<DrawCmd>::Type*) {
+                DAWN_TRY(mBindingTracker->Apply(mCommandContext));
+                mVertexBufferTracker.Apply(mCommandList, mLastPipeline);
+                mCommandList->DrawInstanced(draw->vertexCount, draw->instanceCount,
+                                            draw->firstVertex, draw->firstInstance);
+                return {};
+            }
 
-                case Command::CopyTextureToBuffer: {
-                    CopyTextureToBufferCmd* copy = mCommands.NextCommand<CopyTextureToBufferCmd>();
-                    Texture* texture = ToBackend(copy->source.texture.Get());
-                    Buffer* buffer = ToBackend(copy->destination.buffer.Get());
-
-                    DAWN_TRY(buffer->EnsureDataInitializedAsDestination(commandContext, copy));
-
-                    ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
-                    SubresourceRange subresources =
-                        GetSubresourcesAffectedByCopy(copy->source, copy->copySize);
-
-                    texture->EnsureSubresourceContentInitialized(commandContext, subresources);
-
-                    texture->TrackUsageAndTransitionNow(commandContext, wgpu::TextureUsage::CopySrc,
-                                                        subresources);
-                    buffer->TrackUsageAndTransitionNow(commandContext, wgpu::BufferUsage::CopyDst);
-
-                    const TexelBlockInfo& blockInfo =
-                        texture->GetFormat().GetAspectInfo(copy->source.aspect).block;
-
-                    // See comments around ComputeTextureCopySplits() for more details.
-                    const TextureCopySplits copySplits = ComputeTextureCopySplits(
-                        copy->source.origin, copy->copySize, blockInfo, copy->destination.offset,
-                        copy->destination.bytesPerRow, copy->destination.rowsPerImage);
-
-                    const uint64_t bytesPerSlice =
-                        copy->destination.bytesPerRow * copy->destination.rowsPerImage;
-
-                    // copySplits.copies2D[1] is always calculated for the second copy slice with
-                    // extra "bytesPerSlice" copy offset compared with the first copy slice. So
-                    // here we use an array bufferOffsetsForNextSlice to record the extra offsets
-                    // for each copy slice: bufferOffsetsForNextSlice[0] is the extra offset for
-                    // the next copy slice that uses copySplits.copies2D[0], and
-                    // bufferOffsetsForNextSlice[1] is the extra offset for the next copy slice
-                    // that uses copySplits.copies2D[1].
-                    std::array<uint64_t, TextureCopySplits::kMaxTextureCopySplits>
-                        bufferOffsetsForNextSlice = {{0u, 0u}};
-                    for (uint32_t copySlice = 0; copySlice < copy->copySize.depth; ++copySlice) {
-                        const uint32_t splitIndex = copySlice % copySplits.copies2D.size();
-
-                        const Texture2DCopySplit& copySplitPerLayerBase =
-                            copySplits.copies2D[splitIndex];
-                        const uint64_t bufferOffsetForNextSlice =
-                            bufferOffsetsForNextSlice[splitIndex];
-                        const uint32_t copyTextureLayer = copySlice + copy->source.origin.z;
-
-                        RecordCopyTextureToBufferFromTextureCopySplit(
-                            commandList, copySplitPerLayerBase, buffer, bufferOffsetForNextSlice,
-                            copy->destination.bytesPerRow, texture, copy->source.mipLevel,
-                            copyTextureLayer, subresources.aspects);
-
-                        bufferOffsetsForNextSlice[splitIndex] +=
-                            bytesPerSlice * copySplits.copies2D.size();
-                    }
+            MaybeError operator()(DrawIndexedCmd* draw, CommandData<DrawIndexedCmd>::Type*) {
+                DAWN_TRY(mBindingTracker->Apply(mCommandContext));
+                mIndexBufferTracker.Apply(mCommandList);
+                mVertexBufferTracker.Apply(mCommandList, mLastPipeline);
+                mCommandList->DrawIndexedInstanced(draw->indexCount, draw->instanceCount,
+                                                   draw->firstIndex, draw->baseVertex,
+                                                   draw->firstInstance);
+                return {};
+            }
 
-                    break;
+            MaybeError operator()(MultiDrawCmd* cmd, DrawCmd* draws) {
+                DAWN_TRY(mBindingTracker->Apply(mCommandContext));
+                mVertexBufferTracker.Apply(mCommandList, mLastPipeline);
+                for (uint32_t i = 0; i < cmd->drawCount; ++i) {
+                    mCommandList->DrawInstanced(draws[i].vertexCount, draws[i].instanceCount,
+                                                draws[i].firstVertex, draws[i].firstInstance);
                 }
+                return {};
+            }
 
-                case Command::CopyTextureToTexture: {
-                    CopyTextureToTextureCmd* copy =
-                        mCommands.NextCommand<CopyTextureToTextureCmd>();
+            MaybeError operator()(MultiDrawIndexedCmd* cmd, DrawIndexedCmd* draws) {
+                DAWN_TRY(mBindingTracker->Apply(mCommandContext));
+                mIndexBufferTracker.Apply(mCommandList);
+                mVertexBufferTracker.Apply(mCommandList, mLastPipeline);
+                for (uint32_t i = 0; i < cmd->drawCount; ++i) {
+                    mCommandList->DrawIndexedInstanced(draws[i].indexCount, draws[i].instanceCount,
+                                                       draws[i].firstIndex, draws[i].baseVertex,
+                                                       draws[i].firstInstance);
+                }
+                return {};
+            }
 
-                    Texture* source = ToBackend(copy->source.texture.Get());
-                    Texture* destination = ToBackend(copy->destination.texture.Get());
+            MaybeError operator()(DrawIndirectCmd* draw, CommandData<DrawIndirectCmd>::Type*) {
+                DAWN_TRY(mBindingTracker->Apply(mCommandContext));
+                mVertexBufferTracker.Apply(mCommandList, mLastPipeline);
+                Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
+                ComPtr<ID3D12CommandSignature> signature = mDevice->GetDrawIndirectSignature();
+                mCommandList->ExecuteIndirect(signature.Get(), 1, buffer->GetD3D12Resource(),
+                                              draw->indirectOffset, nullptr, 0);
+                return {};
+            }
 
-                    SubresourceRange srcRange =
-                        GetSubresourcesAffectedByCopy(copy->source, copy->copySize);
-                    SubresourceRange dstRange =
-                        GetSubresourcesAffectedByCopy(copy->destination, copy->copySize);
+            MaybeError operator()(DrawIndexedIndirectCmd* draw,
+                                  CommandData<DrawIndexedIndirectCmd>::Type*) {
+                DAWN_TRY(mBindingTracker->Apply(mCommandContext));
+                mIndexBufferTracker.Apply(mCommandList);
+                mVertexBufferTracker.Apply(mCommandList, mLastPipeline);
+                Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
+                ComPtr<ID3D12CommandSignature> signature =
+                    mDevice->GetDrawIndexedIndirectSignature();
+                mCommandList->ExecuteIndirect(signature.Get(), 1, buffer->GetD3D12Resource(),
+                                              draw->indirectOffset, nullptr, 0);
+                return {};
+            }
 
-                    source->EnsureSubresourceContentInitialized(commandContext, srcRange);
-                    if (IsCompleteSubresourceCopiedTo(destination, copy->copySize,
-                                                      copy->destination.mipLevel)) {
-                        destination->SetIsSubresourceContentInitialized(true, dstRange);
-                    } else {
-                        destination->EnsureSubresourceContentInitialized(commandContext, dstRange);
-                    }
+            MaybeError operator()(InsertDebugMarkerCmd*, char* label) {
+                RecordInsertDebugMarker(mDevice, mCommandList, label);
+                return {};
+            }
 
-                    if (copy->source.texture.Get() == copy->destination.texture.Get() &&
-                        copy->source.mipLevel == copy->destination.mipLevel) {
-                        // When there are overlapped subresources, the layout of the overlapped
-                        // subresources should all be COMMON instead of what we set now. Currently
-                        // it is not allowed to copy with overlapped subresources, but we still
-                        // add the ASSERT here as a reminder for this possible misuse.
-                        ASSERT(!IsRangeOverlapped(copy->source.origin.z, copy->destination.origin.z,
-                                                  copy->copySize.depth));
-                    }
-                    source->TrackUsageAndTransitionNow(commandContext, wgpu::TextureUsage::CopySrc,
-                                                       srcRange);
-                    destination->TrackUsageAndTransitionNow(commandContext,
-                                                            wgpu::TextureUsage::CopyDst, dstRange);
-
-                    ASSERT(srcRange.aspects == dstRange.aspects);
-                    if (CanUseCopyResource(copy->source, copy->destination, copy->copySize)) {
-                        commandList->CopyResource(destination->GetD3D12Resource(),
-                                                  source->GetD3D12Resource());
-                    } else {
-                        // TODO(jiawei.shao@intel.com): support copying with 1D and 3D textures.
-                        ASSERT(source->GetDimension() == wgpu::TextureDimension::e2D &&
-                               destination->GetDimension() == wgpu::TextureDimension::e2D);
-                        const dawn_native::Extent3D copyExtentOneSlice = {
-                            copy->copySize.width, copy->copySize.height, 1u};
-
-                        for (Aspect aspect : IterateEnumMask(srcRange.aspects)) {
-                            for (uint32_t slice = 0; slice < copy->copySize.depth; ++slice) {
-                                D3D12_TEXTURE_COPY_LOCATION srcLocation =
-                                    ComputeTextureCopyLocationForTexture(
-                                        source, copy->source.mipLevel,
-                                        copy->source.origin.z + slice, aspect);
-
-                                D3D12_TEXTURE_COPY_LOCATION dstLocation =
-                                    ComputeTextureCopyLocationForTexture(
-                                        destination, copy->destination.mipLevel,
-                                        copy->destination.origin.z + slice, aspect);
-
-                                Origin3D sourceOriginInSubresource = copy->source.origin;
-                                sourceOriginInSubresource.z = 0;
-                                D3D12_BOX sourceRegion = ComputeD3D12BoxFromOffsetAndSize(
-                                    sourceOriginInSubresource, copyExtentOneSlice);
-
-                                commandList->CopyTextureRegion(
-                                    &dstLocation, copy->destination.origin.x,
-                                    copy->destination.origin.y, 0, &srcLocation, &sourceRegion);
-                            }
-                        }
-                    }
-                    break;
-                }
+            MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                RecordPopDebugGroup(mDevice, mCommandList);
+                return {};
+            }
 
-                case Command::ResolveQuerySet: {
-                    ResolveQuerySetCmd* cmd = mCommands.NextCommand<ResolveQuerySetCmd>();
-                    QuerySet* querySet = ToBackend(cmd->querySet.Get());
-                    Buffer* destination = ToBackend(cmd->destination.Get());
+            MaybeError operator()(PushDebugGroupCmd*, char* label) {
+                RecordPushDebugGroup(mDevice, mCommandList, label);
+                return {};
+            }
 
-                    DAWN_TRY(destination->EnsureDataInitializedAsDestination(
-                        commandContext, cmd->destinationOffset,
-                        cmd->queryCount * sizeof(uint64_t)));
-                    destination->TrackUsageAndTransitionNow(commandContext,
-                                                            wgpu::BufferUsage::CopyDst);
+            MaybeError operator()(SetRenderPipelineCmd* cmd,
+                                  CommandData<SetRenderPipelineCmd>::Type*) {
+                RenderPipeline* pipeline = ToBackend(cmd->pipeline).Get();
+                PipelineLayout* layout = ToBackend(pipeline->GetLayout());
 
-                    commandList->ResolveQueryData(
-                        querySet->GetQueryHeap(), D3D12QueryType(querySet->GetQueryType()),
-                        cmd->firstQuery, cmd->queryCount, destination->GetD3D12Resource(),
-                        cmd->destinationOffset);
+                mCommandList->SetGraphicsRootSignature(layout->GetRootSignature());
+                mCommandList->SetPipelineState(pipeline->GetPipelineState());
+                mCommandList->IASetPrimitiveTopology(pipeline->GetD3D12PrimitiveTopology());
 
-                    // TODO(hao.x.li@intel.com): Add compute shader to convert the query result
-                    // (ticks) to timestamp (ns)
+                mBindingTracker->OnSetPipeline(pipeline);
+                mIndexBufferTracker.OnSetPipeline(pipeline);
 
-                    break;
-                }
+                mLastPipeline = pipeline;
+                return {};
+            }
 
-                case Command::WriteTimestamp: {
-                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
+            MaybeError operator()(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                BindGroup* group = ToBackend(cmd->group.Get());
+                mBindingTracker->OnSetBindGroup(
+                    cmd->index, group, cmd->dynamicOffsetCount,
+                    cmd->dynamicOffsetCount > 0 ? dynamicOffsets : nullptr);
+                return {};
+            }
 
-                    RecordWriteTimestampCmd(commandList, cmd);
-                    break;
-                }
+            MaybeError operator()(SetIndexBufferCmd* cmd, CommandData<SetIndexBufferCmd>::Type*) {
+                mIndexBufferTracker.OnSetIndexBuffer(ToBackend(cmd->buffer.Get()), cmd->format,
+                                                     cmd->offset, cmd->size);
+                return {};
+            }
 
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = mCommands.NextCommand<InsertDebugMarkerCmd>();
-                    const char* label = mCommands.NextData<char>(cmd->length + 1);
+            MaybeError operator()(SetVertexBufferCmd* cmd,
+                                  CommandData<SetVertexBufferCmd>::Type*) {
+                mVertexBufferTracker.OnSetVertexBuffer(cmd->slot, ToBackend(cmd->buffer.Get()),
+                                                       cmd->offset, cmd->size);
+                return {};
+            }
 
-                    if (ToBackend(GetDevice())->GetFunctions()->IsPIXEventRuntimeLoaded()) {
-                        // PIX color is 1 byte per channel in ARGB format
-                        constexpr uint64_t kPIXBlackColor = 0xff000000;
-                        ToBackend(GetDevice())
-                            ->GetFunctions()
-                            ->pixSetMarkerOnCommandList(commandList, kPIXBlackColor, label);
-                    }
-                    break;
-                }
+            MaybeError operator()(SetStencilReferenceCmd* cmd,
+                                  CommandData<SetStencilReferenceCmd>::Type*) {
+                mCommandList->OMSetStencilRef(cmd->reference);
+                return {};
+            }
 
-                case Command::PopDebugGroup: {
-                    mCommands.NextCommand<PopDebugGroupCmd>();
+            MaybeError operator()(SetViewportCmd* cmd, CommandData<SetViewportCmd>::Type*) {
+                D3D12_VIEWPORT viewport;
+                viewport.TopLeftX = cmd->x;
+                viewport.TopLeftY = cmd->y;
+                viewport.Width = cmd->width;
+                viewport.Height = cmd->height;
+                viewport.MinDepth = cmd->minDepth;
+                viewport.MaxDepth = cmd->maxDepth;
+
+                mCommandList->RSSetViewports(1, &viewport);
+                return {};
+            }
 
-                    if (ToBackend(GetDevice())->GetFunctions()->IsPIXEventRuntimeLoaded()) {
-                        ToBackend(GetDevice())
-                            ->GetFunctions()
-                            ->pixEndEventOnCommandList(commandList);
-                    }
-                    break;
-                }
+            MaybeError operator()(SetScissorRectCmd* cmd, CommandData<SetScissorRectCmd>::Type*) {
+                D3D12_RECT rect;
+                rect.left = cmd->x;
+                rect.top = cmd->y;
+                rect.right = cmd->x + cmd->width;
+                rect.bottom = cmd->y + cmd->height;
 
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = mCommands.NextCommand<PushDebugGroupCmd>();
-                    const char* label = mCommands.NextData<char>(cmd->length + 1);
+                mCommandList->RSSetScissorRects(1, &rect);
+                return {};
+            }
+
+            MaybeError operator()(SetBlendColorCmd* cmd, CommandData<SetBlendColorCmd>::Type*) {
+                const std::array<float, 4> color = ConvertToFloatColor(cmd->color);
+                mCommandList->OMSetBlendFactor(color.data());
+                return {};
+            }
 
-                    if (ToBackend(GetDevice())->GetFunctions()->IsPIXEventRuntimeLoaded()) {
-                        // PIX color is 1 byte per channel in ARGB format
-                        constexpr uint64_t kPIXBlackColor = 0xff000000;
-                        ToBackend(GetDevice())
-                            ->GetFunctions()
-                            ->pixBeginEventOnCommandList(commandList, kPIXBlackColor, label);
+            MaybeError operator()(ExecuteBundlesCmd* cmd, Ref<RenderBundleBase>* bundles) {
+                for (uint32_t i = 0; i < cmd->count; ++i) {
+                    CommandIterator bundleCommands = bundles[i]->GetCommands()->Borrow();
+                    Command bundleType;
+                    while (bundleCommands.NextCommandId(&bundleType)) {
+                        DAWN_TRY(VisitCommand(&bundleCommands, bundleType, *this));
                     }
-                    break;
                 }
+                return {};
+            }
 
-                default:
-                    UNREACHABLE();
+            MaybeError operator()(WriteTimestampCmd* cmd, CommandData<WriteTimestampCmd>::Type*) {
+                RecordWriteTimestampCmd(mCommandList, cmd);
+                return {};
             }
+
+          private:
+            Device* mDevice;
+            CommandRecordingContext* mCommandContext;
+            ID3D12GraphicsCommandList* mCommandList;
+            BindGroupStateTracker* mBindingTracker;
+
+            RenderPipeline* mLastPipeline = nullptr;
+            VertexBufferTracker mVertexBufferTracker = {};
+            IndexBufferTracker mIndexBufferTracker = {};
+        };
+
+    }  // anonymous namespace
+
+    // Records the commands outside of passes.
+    class CommandBuffer::CommandRecorder {
+      public:
+        CommandRecorder(CommandBuffer* commandBuffer, CommandRecordingContext* commandContext)
+            : mCommandBuffer(commandBuffer),
+              mCommandContext(commandContext),
+              mCommandList(commandContext->GetCommandList()),
+              mBindingTracker(ToBackend(commandBuffer->GetDevice())) {
+            // Make sure we use the correct descriptors for this command list. Could be done once
+            // per actual command list but here is ok because there should be few command buffers.
+            mBindingTracker.SetID3D12DescriptorHeaps(mCommandList);
         }
 
-        return {};
-    }
+        template <typename T, typename D>
+        MaybeError operator()(T*, D*) {
+            UNREACHABLE();
+            return {};
+        }
 
-    MaybeError CommandBuffer::RecordComputePass(CommandRecordingContext* commandContext,
-                                                BindGroupStateTracker* bindingTracker) {
-        PipelineLayout* lastLayout = nullptr;
-        ID3D12GraphicsCommandList* commandList = commandContext->GetCommandList();
+        MaybeError operator()(BeginComputePassCmd*, CommandData<BeginComputePassCmd>::Type*) {
+            PrepareResourcesForComputePass(mCommandContext, NextPassResourceUsage());
+            mBindingTracker.SetInComputePass(true);
+            return mCommandBuffer->RecordComputePass(mCommandContext, &mBindingTracker);
+        }
 
-        Command type;
-        while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::Dispatch: {
-                    DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
+        MaybeError operator()(BeginRenderPassCmd* beginRenderPassCmd,
+                              CommandData<BeginRenderPassCmd>::Type*) {
+            const bool passHasUAV =
+                PrepareResourcesForRenderPass(mCommandContext, NextPassResourceUsage());
+            mBindingTracker.SetInComputePass(false);
 
-                    DAWN_TRY(bindingTracker->Apply(commandContext));
-                    commandList->Dispatch(dispatch->x, dispatch->y, dispatch->z);
-                    break;
-                }
+            LazyClearRenderPassAttachments(beginRenderPassCmd);
+            return mCommandBuffer->RecordRenderPass(mCommandContext, &mBindingTracker,
+                                                    beginRenderPassCmd, passHasUAV);
+        }
 
-                case Command::DispatchIndirect: {
-                    DispatchIndirectCmd* dispatch = mCommands.NextCommand<DispatchIndirectCmd>();
+        MaybeError operator()(CopyBufferToBufferCmd* copy,
+                              CommandData<CopyBufferToBufferCmd>::Type*) {
+            Buffer* srcBuffer = ToBackend(copy->source.Get());
+            Buffer* dstBuffer = ToBackend(copy->destination.Get());
 
-                    DAWN_TRY(bindingTracker->Apply(commandContext));
-                    Buffer* buffer = ToBackend(dispatch->indirectBuffer.Get());
-                    buffer->TrackUsageAndTransitionNow(commandContext, wgpu::BufferUsage::Indirect);
-                    ComPtr<ID3D12CommandSignature> signature =
-                        ToBackend(GetDevice())->GetDispatchIndirectSignature();
-                    commandList->ExecuteIndirect(signature.Get(), 1, buffer->GetD3D12Resource(),
-                                                 dispatch->indirectOffset, nullptr, 0);
-                    break;
-                }
+            DAWN_TRY(srcBuffer->EnsureDataInitialized(mCommandContext));
+            DAWN_TRY(dstBuffer->EnsureDataInitializedAsDestination(
+                mCommandContext, copy->destinationOffset, copy->size));
 
-                case Command::EndComputePass: {
-                    mCommands.NextCommand<EndComputePassCmd>();
-                    return {};
-                }
+            srcBuffer->TrackUsageAndTransitionNow(mCommandContext, wgpu::BufferUsage::CopySrc);
+            dstBuffer->TrackUsageAndTransitionNow(mCommandContext, wgpu::BufferUsage::CopyDst);
 
-                case Command::SetComputePipeline: {
-                    SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
-                    ComputePipeline* pipeline = ToBackend(cmd->pipeline).Get();
-                    PipelineLayout* layout = ToBackend(pipeline->GetLayout());
+            mCommandList->CopyBufferRegion(dstBuffer->GetD3D12Resource(), copy->destinationOffset,
+                                           srcBuffer->GetD3D12Resource(), copy->sourceOffset,
+                                           copy->size);
+            return {};
+        }
 
-                    commandList->SetComputeRootSignature(layout->GetRootSignature());
-                    commandList->SetPipelineState(pipeline->GetPipelineState());
+        MaybeError operator()(CopyBufferToTextureCmd* copy,
+                              CommandData<CopyBufferToTextureCmd>::Type*) {
+            Buffer* buffer = ToBackend(copy->source.buffer.Get());
+            Texture* texture = ToBackend(copy->destination.texture.Get());
 
-                    bindingTracker->OnSetPipeline(pipeline);
+            DAWN_TRY(buffer->EnsureDataInitialized(mCommandContext));
 
-                    lastLayout = layout;
-                    break;
-                }
+            ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
+            SubresourceRange subresources =
+                GetSubresourcesAffectedByCopy(copy->destination, copy->copySize);
 
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
-                    BindGroup* group = ToBackend(cmd->group.Get());
-                    uint32_t* dynamicOffsets = nullptr;
+            if (IsCompleteSubresourceCopiedTo(texture, copy->copySize,
+                                              copy->destination.mipLevel)) {
+                texture->SetIsSubresourceContentInitialized(true, subresources);
+            } else {
+                texture->EnsureSubresourceContentInitialized(mCommandContext, subresources);
+            }
 
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = mCommands.NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+            buffer->TrackUsageAndTransitionNow(mCommandContext, wgpu::BufferUsage::CopySrc);
+            texture->TrackUsageAndTransitionNow(mCommandContext, wgpu::TextureUsage::CopyDst,
+                                                subresources);
 
-                    bindingTracker->OnSetBindGroup(cmd->index, group, cmd->dynamicOffsetCount,
-                                                   dynamicOffsets);
-                    break;
-                }
+            // compute the copySplits and record the CopyTextureRegion commands
+            CopyBufferToTextureWithCopySplit(
+                mCommandContext, copy->destination, copy->copySize, texture,
+                buffer->GetD3D12Resource(), copy->source.offset, copy->source.bytesPerRow,
+                copy->source.rowsPerImage, subresources.aspects);
+            return {};
+        }
 
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = mCommands.NextCommand<InsertDebugMarkerCmd>();
-                    const char* label = mCommands.NextData<char>(cmd->length + 1);
+        MaybeError operator()(CopyTextureToBufferCmd* copy,
+                              CommandData<CopyTextureToBufferCmd>::Type*) {
+            Texture* texture = ToBackend(copy->source.texture.Get());
+            Buffer* buffer = ToBackend(copy->destination.buffer.Get());
+
+            DAWN_TRY(buffer->EnsureDataInitializedAsDestination(mCommandContext, copy));
+
+            ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
+            SubresourceRange subresources =
+                GetSubresourcesAffectedByCopy(copy->source, copy->copySize);
+
+            texture->EnsureSubresourceContentInitialized(mCommandContext, subresources);
+
+            texture->TrackUsageAndTransitionNow(mCommandContext, wgpu::TextureUsage::CopySrc,
+                                                subresources);
+            buffer->TrackUsageAndTransitionNow(mCommandContext, wgpu::BufferUsage::CopyDst);
+
+            const TexelBlockInfo& blockInfo =
+                texture->GetFormat().GetAspectInfo(copy->source.aspect).block;
+
+            // See comments around ComputeTextureCopySplits() for more details.
+            const TextureCopySplits copySplits = ComputeTextureCopySplits(
+                copy->source.origin, copy->copySize, blockInfo, copy->destination.offset,
+                copy->destination.bytesPerRow, copy->destination.rowsPerImage);
+
+            const uint64_t bytesPerSlice =
+                copy->destination.bytesPerRow * copy->destination.rowsPerImage;
+
+            // copySplits.copies2D[1] is always calculated for the second copy slice with
+            // extra "bytesPerSlice" copy offset compared with the first copy slice. So
+            // here we use an array bufferOffsetsForNextSlice to record the extra offsets
+            // for each copy slice: bufferOffsetsForNextSlice[0] is the extra offset for
+            // the next copy slice that uses copySplits.copies2D[0], and
+            // bufferOffsetsForNextSlice[1] is the extra offset for the next copy slice
+            // that uses copySplits.copies2D[1].
+            std::array<uint64_t, TextureCopySplits::kMaxTextureCopySplits>
+                bufferOffsetsForNextSlice = {{0u, 0u}};
+            for (uint32_t copySlice = 0; copySlice < copy->copySize.depth; ++copySlice) {
+                const uint32_t splitIndex = copySlice % copySplits.copies2D.size();
+
+                const Texture2DCopySplit& copySplitPerLayerBase =
+                    copySplits.copies2D[splitIndex];
+                const uint64_t bufferOffsetForNextSlice =
+                    bufferOffsetsForNextSlice[splitIndex];
+                const uint32_t copyTextureLayer = copySlice + copy->source.origin.z;
+
+                RecordCopyTextureToBufferFromTextureCopySplit(
+                    mCommandList, copySplitPerLayerBase, buffer, bufferOffsetForNextSlice,
+                    copy->destination.bytesPerRow, texture, copy->source.mipLevel,
+                    copyTextureLayer, subresources.aspects);
+
+                bufferOffsetsForNextSlice[splitIndex] +=
+                    bytesPerSlice * copySplits.copies2D.size();
+            }
+            return {};
+        }
 
-                    if (ToBackend(GetDevice())->GetFunctions()->IsPIXEventRuntimeLoaded()) {
-                        // PIX color is 1 byte per channel in ARGB format
-                        constexpr uint64_t kPIXBlackColor = 0xff000000;
-                        ToBackend(GetDevice())
-                            ->GetFunctions()
-                            ->pixSetMarkerOnCommandList(commandList, kPIXBlackColor, label);
-                    }
-                    break;
-                }
+        MaybeError operator()(CopyTextureToTextureCmd* copy,
+                              CommandData<CopyTextureToTextureCmd>::Type*) {
+            Texture* source = ToBackend(copy->source.texture.Get());
+            Texture* destination = ToBackend(copy->destination.texture.Get());
+
+            SubresourceRange srcRange = GetSubresourcesAffectedByCopy(copy->source, copy->copySize);
+            SubresourceRange dstRange =
+                GetSubresourcesAffectedByCopy(copy->destination, copy->copySize);
 
-                case Command::PopDebugGroup: {
-                    mCommands.NextCommand<PopDebugGroupCmd>();
+            source->EnsureSubresourceContentInitialized(mCommandContext, srcRange);
+            if (IsCompleteSubresourceCopiedTo(destination, copy->copySize,
+                                              copy->destination.mipLevel)) {
+                destination->SetIsSubresourceContentInitialized(true, dstRange);
+            } else {
+                destination->EnsureSubresourceContentInitialized(mCommandContext, dstRange);
+            }
 
-                    if (ToBackend(GetDevice())->GetFunctions()->IsPIXEventRuntimeLoaded()) {
-                        ToBackend(GetDevice())
-                            ->GetFunctions()
-                            ->pixEndEventOnCommandList(commandList);
+            if (copy->source.texture.Get() == copy->destination.texture.Get() &&
+                copy->source.mipLevel == copy->destination.mipLevel) {
+                // When there are overlapped subresources, the layout of the overlapped
+                // subresources should all be COMMON instead of what we set now. Currently
+                // it is not allowed to copy with overlapped subresources, but we still
+                // add the ASSERT here as a reminder for this possible misuse.
+                ASSERT(!IsRangeOverlapped(copy->source.origin.z, copy->destination.origin.z,
+                                          copy->copySize.depth));
+            }
+            source->TrackUsageAndTransitionNow(mCommandContext, wgpu::TextureUsage::CopySrc,
+                                               srcRange);
+            destination->TrackUsageAndTransitionNow(mCommandContext, wgpu::TextureUsage::CopyDst,
+                                                    dstRange);
+
+            ASSERT(srcRange.aspects == dstRange.aspects);
+            if (CanUseCopyResource(copy->source, copy->destination, copy->copySize)) {
+                mCommandList->CopyResource(destination->GetD3D12Resource(),
+                                           source->GetD3D12Resource());
+            } else {
+                // TODO(jiawei.shao@intel.com): support copying with 1D and 3D textures.
+                ASSERT(source->GetDimension() == wgpu::TextureDimension::e2D &&
+                       destination->GetDimension() == wgpu::TextureDimension::e2D);
+                const dawn_native::Extent3D copyExtentOneSlice = {
+                    copy->copySize.width, copy->copySize.height, 1u};
+
+                for (Aspect aspect : IterateEnumMask(srcRange.aspects)) {
+                    for (uint32_t slice = 0; slice < copy->copySize.depth; ++slice) {
+                        D3D12_TEXTURE_COPY_LOCATION srcLocation =
+                            ComputeTextureCopyLocationForTexture(
+                                source, copy->source.mipLevel,
+                                copy->source.origin.z + slice, aspect);
+
+                        D3D12_TEXTURE_COPY_LOCATION dstLocation =
+                            ComputeTextureCopyLocationForTexture(
+                                destination, copy->destination.mipLevel,
+                                copy->destination.origin.z + slice, aspect);
+
+                        Origin3D sourceOriginInSubresource = copy->source.origin;
+                        sourceOriginInSubresource.z = 0;
+                        D3D12_BOX sourceRegion = ComputeD3D12BoxFromOffsetAndSize(
+                            sourceOriginInSubresource, copyExtentOneSlice);
+
+                        mCommandList->CopyTextureRegion(
+                            &dstLocation, copy->destination.origin.x,
+                            copy->destination.origin.y, 0, &srcLocation, &sourceRegion);
                     }
-                    break;
                 }
+            }
+            return {};
+        }
 
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = mCommands.NextCommand<PushDebugGroupCmd>();
-                    const char* label = mCommands.NextData<char>(cmd->length + 1);
+        MaybeError operator()(ResolveQuerySetCmd* cmd, CommandData<ResolveQuerySetCmd>::Type*) {
+            QuerySet* querySet = ToBackend(cmd->querySet.Get());
+            Buffer* destination = ToBackend(cmd->destination.Get());
 
-                    if (ToBackend(GetDevice())->GetFunctions()->IsPIXEventRuntimeLoaded()) {
-                        // PIX color is 1 byte per channel in ARGB format
-                        constexpr uint64_t kPIXBlackColor = 0xff000000;
-                        ToBackend(GetDevice())
-                            ->GetFunctions()
-                            ->pixBeginEventOnCommandList(commandList, kPIXBlackColor, label);
-                    }
-                    break;
-                }
+            DAWN_TRY(destination->EnsureDataInitializedAsDestination(
+                mCommandContext, cmd->destinationOffset, cmd->queryCount * sizeof(uint64_t)));
+            destination->TrackUsageAndTransitionNow(mCommandContext, wgpu::BufferUsage::CopyDst);
 
-                case Command::WriteTimestamp: {
-                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
+            mCommandList->ResolveQueryData(
+                querySet->GetQueryHeap(), D3D12QueryType(querySet->GetQueryType()),
+                cmd->firstQuery, cmd->queryCount, destination->GetD3D12Resource(),
+                cmd->destinationOffset);
 
-                    RecordWriteTimestampCmd(commandList, cmd);
-                    break;
-                }
+            // TODO(hao.x.li@intel.com): Add compute shader to convert the query result
+            // (ticks) to timestamp (ns)
+
+            return {};
+        }
+
+        MaybeError operator()(WriteTimestampCmd* cmd, CommandData<WriteTimestampCmd>::Type*) {
+            RecordWriteTimestampCmd(mCommandList, cmd);
+            return {};
+        }
 
-                default:
-                    UNREACHABLE();
+        MaybeError operator()(InsertDebugMarkerCmd*, char* label) {
+            RecordInsertDebugMarker(GetDevice(), mCommandList, label);
+            return {};
+        }
+
+        MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+            RecordPopDebugGroup(GetDevice(), mCommandList);
+            return {};
+        }
+
+        MaybeError operator()(PushDebugGroupCmd*, char* label) {
+            RecordPushDebugGroup(GetDevice(), mCommandList, label);
+            return {};
+        }
+
+      private:
+        Device* GetDevice() const {
+            return ToBackend(mCommandBuffer->GetDevice());
+        }
+
+        const PassResourceUsage& NextPassResourceUsage() {
+            return mCommandBuffer->GetResourceUsages().perPass[mNextPassNumber++];
+        }
+
+        CommandBuffer* mCommandBuffer;
+        CommandRecordingContext* mCommandContext;
+        ID3D12GraphicsCommandList* mCommandList;
+        BindGroupStateTracker mBindingTracker;
+        uint32_t mNextPassNumber = 0;
+    };
+
+    CommandBuffer::CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor)
+        : CommandBufferBase(encoder, descriptor) {
+    }
+
+    MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* commandContext) {
+        CommandRecorder recorder(this, commandContext);
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            DAWN_TRY(VisitCommand(&mCommands, type, recorder));
+        }
+
+        return {};
+    }
+
+    MaybeError CommandBuffer::RecordComputePass(CommandRecordingContext* commandContext,
+                                                BindGroupStateTracker* bindingTracker) {
+        ComputePassRecorder recorder(ToBackend(GetDevice()), commandContext, bindingTracker);
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            if (type == Command::EndComputePass) {
+                mCommands.NextCommand<EndComputePassCmd>();
+                return {};
             }
+            DAWN_TRY(VisitCommand(&mCommands, type, recorder));
         }
 
         return {};
@@ -1266,234 +1448,20 @@ namespace dawn_native { namespace d3d12 {
             commandList->OMSetBlendFactor(&defaultBlendFactor[0]);
         }
 
-        RenderPipeline* lastPipeline = nullptr;
-        PipelineLayout* lastLayout = nullptr;
-        VertexBufferTracker vertexBufferTracker = {};
-        IndexBufferTracker indexBufferTracker = {};
-
-        auto EncodeRenderBundleCommand = [&](CommandIterator* iter, Command type) -> MaybeError {
-            switch (type) {
-                case Command::Draw: {
-                    DrawCmd* draw = iter->NextCommand<DrawCmd>();
-
-                    DAWN_TRY(bindingTracker->Apply(commandContext));
-                    vertexBufferTracker.Apply(commandList, lastPipeline);
-                    commandList->DrawInstanced(draw->vertexCount, draw->instanceCount,
-                                               draw->firstVertex, draw->firstInstance);
-                    break;
-                }
-
-                case Command::DrawIndexed: {
-                    DrawIndexedCmd* draw = iter->NextCommand<DrawIndexedCmd>();
-
-                    DAWN_TRY(bindingTracker->Apply(commandContext));
-                    indexBufferTracker.Apply(commandList);
-                    vertexBufferTracker.Apply(commandList, lastPipeline);
-                    commandList->DrawIndexedInstanced(draw->indexCount, draw->instanceCount,
-                                                      draw->firstIndex, draw->baseVertex,
-                                                      draw->firstInstance);
-                    break;
-                }
-
-                case Command::DrawIndirect: {
-                    DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-
-                    DAWN_TRY(bindingTracker->Apply(commandContext));
-                    vertexBufferTracker.Apply(commandList, lastPipeline);
-                    Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
-                    ComPtr<ID3D12CommandSignature> signature =
-                        ToBackend(GetDevice())->GetDrawIndirectSignature();
-                    commandList->ExecuteIndirect(signature.Get(), 1, buffer->GetD3D12Resource(),
-                                                 draw->indirectOffset, nullptr, 0);
-                    break;
-                }
-
-                case Command::DrawIndexedIndirect: {
-                    DrawIndexedIndirectCmd* draw = iter->NextCommand<DrawIndexedIndirectCmd>();
-
-                    DAWN_TRY(bindingTracker->Apply(commandContext));
-                    indexBufferTracker.Apply(commandList);
-                    vertexBufferTracker.Apply(commandList, lastPipeline);
-                    Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
-                    ComPtr<ID3D12CommandSignature> signature =
-                        ToBackend(GetDevice())->GetDrawIndexedIndirectSignature();
-                    commandList->ExecuteIndirect(signature.Get(), 1, buffer->GetD3D12Resource(),
-                                                 draw->indirectOffset, nullptr, 0);
-                    break;
-                }
-
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = iter->NextCommand<InsertDebugMarkerCmd>();
-                    const char* label = iter->NextData<char>(cmd->length + 1);
-
-                    if (ToBackend(GetDevice())->GetFunctions()->IsPIXEventRuntimeLoaded()) {
-                        // PIX color is 1 byte per channel in ARGB format
-                        constexpr uint64_t kPIXBlackColor = 0xff000000;
-                        ToBackend(GetDevice())
-                            ->GetFunctions()
-                            ->pixSetMarkerOnCommandList(commandList, kPIXBlackColor, label);
-                    }
-                    break;
-                }
-
-                case Command::PopDebugGroup: {
-                    iter->NextCommand<PopDebugGroupCmd>();
-
-                    if (ToBackend(GetDevice())->GetFunctions()->IsPIXEventRuntimeLoaded()) {
-                        ToBackend(GetDevice())
-                            ->GetFunctions()
-                            ->pixEndEventOnCommandList(commandList);
-                    }
-                    break;
-                }
-
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = iter->NextCommand<PushDebugGroupCmd>();
-                    const char* label = iter->NextData<char>(cmd->length + 1);
-
-                    if (ToBackend(GetDevice())->GetFunctions()->IsPIXEventRuntimeLoaded()) {
-                        // PIX color is 1 byte per channel in ARGB format
-                        constexpr uint64_t kPIXBlackColor = 0xff000000;
-                        ToBackend(GetDevice())
-                            ->GetFunctions()
-                            ->pixBeginEventOnCommandList(commandList, kPIXBlackColor, label);
-                    }
-                    break;
-                }
-
-                case Command::SetRenderPipeline: {
-                    SetRenderPipelineCmd* cmd = iter->NextCommand<SetRenderPipelineCmd>();
-                    RenderPipeline* pipeline = ToBackend(cmd->pipeline).Get();
-                    PipelineLayout* layout = ToBackend(pipeline->GetLayout());
-
-                    commandList->SetGraphicsRootSignature(layout->GetRootSignature());
-                    commandList->SetPipelineState(pipeline->GetPipelineState());
-                    commandList->IASetPrimitiveTopology(pipeline->GetD3D12PrimitiveTopology());
-
-                    bindingTracker->OnSetPipeline(pipeline);
-                    indexBufferTracker.OnSetPipeline(pipeline);
-
-                    lastPipeline = pipeline;
-                    lastLayout = layout;
-                    break;
-                }
-
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
-                    BindGroup* group = ToBackend(cmd->group.Get());
-                    uint32_t* dynamicOffsets = nullptr;
-
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
-
-                    bindingTracker->OnSetBindGroup(cmd->index, group, cmd->dynamicOffsetCount,
-                                                   dynamicOffsets);
-                    break;
-                }
-
-                case Command::SetIndexBuffer: {
-                    SetIndexBufferCmd* cmd = iter->NextCommand<SetIndexBufferCmd>();
-
-                    indexBufferTracker.OnSetIndexBuffer(ToBackend(cmd->buffer.Get()), cmd->format,
-                                                        cmd->offset, cmd->size);
-                    break;
-                }
-
-                case Command::SetVertexBuffer: {
-                    SetVertexBufferCmd* cmd = iter->NextCommand<SetVertexBufferCmd>();
-
-                    vertexBufferTracker.OnSetVertexBuffer(cmd->slot, ToBackend(cmd->buffer.Get()),
-                                                          cmd->offset, cmd->size);
-                    break;
-                }
-
-                default:
-                    UNREACHABLE();
-                    break;
-            }
-            return {};
-        };
+        RenderPassRecorder recorder(device, commandContext, bindingTracker);
 
         Command type;
         while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndRenderPass: {
-                    mCommands.NextCommand<EndRenderPassCmd>();
-                    if (useRenderPass) {
-                        commandContext->GetCommandList4()->EndRenderPass();
-                    } else if (renderPass->attachmentState->GetSampleCount() > 1) {
-                        ResolveMultisampledRenderPass(commandContext, renderPass);
-                    }
-                    return {};
-                }
-
-                case Command::SetStencilReference: {
-                    SetStencilReferenceCmd* cmd = mCommands.NextCommand<SetStencilReferenceCmd>();
-
-                    commandList->OMSetStencilRef(cmd->reference);
-                    break;
-                }
-
-                case Command::SetViewport: {
-                    SetViewportCmd* cmd = mCommands.NextCommand<SetViewportCmd>();
-                    D3D12_VIEWPORT viewport;
-                    viewport.TopLeftX = cmd->x;
-                    viewport.TopLeftY = cmd->y;
-                    viewport.Width = cmd->width;
-                    viewport.Height = cmd->height;
-                    viewport.MinDepth = cmd->minDepth;
-                    viewport.MaxDepth = cmd->maxDepth;
-
-                    commandList->RSSetViewports(1, &viewport);
-                    break;
-                }
-
-                case Command::SetScissorRect: {
-                    SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
-                    D3D12_RECT rect;
-                    rect.left = cmd->x;
-                    rect.top = cmd->y;
-                    rect.right = cmd->x + cmd->width;
-                    rect.bottom = cmd->y + cmd->height;
-
-                    commandList->RSSetScissorRects(1, &rect);
-                    break;
-                }
-
-                case Command::SetBlendColor: {
-                    SetBlendColorCmd* cmd = mCommands.NextCommand<SetBlendColorCmd>();
-                    const std::array<float, 4> color = ConvertToFloatColor(cmd->color);
-                    commandList->OMSetBlendFactor(color.data());
-                    break;
-                }
-
-                case Command::ExecuteBundles: {
-                    ExecuteBundlesCmd* cmd = mCommands.NextCommand<ExecuteBundlesCmd>();
-                    auto bundles = mCommands.NextData<Ref<RenderBundleBase>>(cmd->count);
-
-                    for (uint32_t i = 0; i < cmd->count; ++i) {
-                        CommandIterator* iter = bundles[i]->GetCommands();
-                        iter->Reset();
-                        while (iter->NextCommandId(&type)) {
-                            DAWN_TRY(EncodeRenderBundleCommand(iter, type));
-                        }
-                    }
-                    break;
-                }
-
-                case Command::WriteTimestamp: {
-                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
-
-                    RecordWriteTimestampCmd(commandList, cmd);
-                    break;
-                }
-
-                default: {
-                    DAWN_TRY(EncodeRenderBundleCommand(&mCommands, type));
-                    break;
+            if (type == Command::EndRenderPass) {
+                mCommands.NextCommand<EndRenderPassCmd>();
+                if (useRenderPass) {
+                    commandContext->GetCommandList4()->EndRenderPass();
+                } else if (renderPass->attachmentState->GetSampleCount() > 1) {
+                    ResolveMultisampledRenderPass(commandContext, renderPass);
                 }
+                return {};
             }
+            DAWN_TRY(VisitCommand(&mCommands, type, recorder));
         }
         return {};
     }
@@ -53,6 +53,8 @@ namespace dawn_native { namespace d3d12 {
                                    RenderPassBuilder* renderPassBuilder);
         void EmulateBeginRenderPass(CommandRecordingContext* commandContext,
                                     const RenderPassBuilder* renderPassBuilder) const;
+
+        class CommandRecorder;
     };
 
 }}  // namespace dawn_native::d3d12
@@ -259,6 +259,10 @@ namespace dawn_native { namespace d3d12 {
         return ExecutionSerial(mFence->GetCompletedValue());
     }
 
+    void Device::ReportBackendMemoryUsage(DeviceMemoryUsage* usage) const {
+        mResourceAllocatorManager->ReportMemoryUsage(usage);
+    }
+
     void Device::ReferenceUntilUnused(ComPtr<IUnknown> object) {
         mUsedComObjectRefs.Enqueue(object, GetPendingCommandSerial());
     }
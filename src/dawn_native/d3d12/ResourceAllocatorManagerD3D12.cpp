@@ -240,6 +240,7 @@ namespace dawn_native { namespace d3d12 {
         // manually deleted upon deallocation. See ResourceAllocatorManager::CreateCommittedResource
         // for more information.
         if (allocation.GetInfo().mMethod == AllocationMethod::kDirect) {
+            mDirectlyAllocatedBytes -= allocation.GetInfo().mRequestedSize;
             delete allocation.GetResourceHeap();
         }
 
@@ -394,7 +395,10 @@ namespace dawn_native { namespace d3d12 {
         // track this to avoid calling MakeResident a second time.
         mDevice->GetResidencyManager()->TrackResidentAllocation(heap);
 
+        mDirectlyAllocatedBytes += resourceInfo.SizeInBytes;
+
         AllocationInfo info;
+        info.mRequestedSize = resourceInfo.SizeInBytes;
         info.mMethod = AllocationMethod::kDirect;
 
         return ResourceHeapAllocation{info,
@@ -407,4 +411,16 @@ namespace dawn_native { namespace d3d12 {
         }
     }
 
+    void ResourceAllocatorManager::ReportMemoryUsage(DeviceMemoryUsage* usage) const {
+        for (const std::unique_ptr<BuddyMemoryAllocator>& allocator :
+             mSubAllocatedResourceAllocators) {
+            allocator->ReportMemoryUsage(&usage->subAllocated);
+        }
+        for (const std::unique_ptr<PooledResourceMemoryAllocator>& allocator :
+             mPooledHeapAllocators) {
+            allocator->ReportMemoryUsage(&usage->subAllocated);
+        }
+        usage->directlyAllocatedBytes += mDirectlyAllocatedBytes;
+    }
+
 }}  // namespace dawn_native::d3d12
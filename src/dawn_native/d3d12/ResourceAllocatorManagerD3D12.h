@@ -71,6 +71,8 @@ namespace dawn_native { namespace d3d12 {
 
         void DestroyPool();
 
+        void ReportMemoryUsage(DeviceMemoryUsage* usage) const;
+
       private:
         void FreeMemory(ResourceHeapAllocation& allocation);
 
@@ -100,6 +102,8 @@ namespace dawn_native { namespace d3d12 {
             mPooledHeapAllocators;
 
         SerialQueue<ExecutionSerial, ResourceHeapAllocation> mAllocationsToDelete;
+
+        uint64_t mDirectlyAllocatedBytes = 0;
     };
 
 }}  // namespace dawn_native::d3d12
@@ -868,42 +868,56 @@ namespace dawn_native { namespace d3d12 {
             if (GetFormat().HasDepthOrStencil()) {
                 TrackUsageAndTransitionNow(commandContext, D3D12_RESOURCE_STATE_DEPTH_WRITE, range);
 
-                for (uint32_t level = range.baseMipLevel;
-                     level < range.baseMipLevel + range.levelCount; ++level) {
-                    for (uint32_t layer = range.baseArrayLayer;
-                         layer < range.baseArrayLayer + range.layerCount; ++layer) {
-                        // Iterate the aspects individually to determine which clear flags to use.
-                        D3D12_CLEAR_FLAGS clearFlags = {};
-                        for (Aspect aspect : IterateEnumMask(range.aspects)) {
-                            if (clearValue == TextureBase::ClearValue::Zero &&
-                                IsSubresourceContentInitialized(
-                                    SubresourceRange::SingleMipAndLayer(level, layer, aspect))) {
-                                // Skip lazy clears if already initialized.
-                                continue;
-                            }
-
-                            switch (aspect) {
-                                case Aspect::Depth:
-                                    clearFlags |= D3D12_CLEAR_FLAG_DEPTH;
-                                    break;
-                                case Aspect::Stencil:
-                                    clearFlags |= D3D12_CLEAR_FLAG_STENCIL;
-                                    break;
-                                default:
-                                    UNREACHABLE();
-                            }
+                // Iterate the aspects individually to determine which clear flags to use.
+                auto GetClearFlags = [&](uint32_t level, uint32_t layer) {
+                    D3D12_CLEAR_FLAGS clearFlags = {};
+                    for (Aspect aspect : IterateEnumMask(range.aspects)) {
+                        if (clearValue == TextureBase::ClearValue::Zero &&
+                            IsSubresourceContentInitialized(
+                                SubresourceRange::SingleMipAndLayer(level, layer, aspect))) {
+                            // Skip lazy clears if already initialized.
+                            continue;
+                        }
+
+                        switch (aspect) {
+                            case Aspect::Depth:
+                                clearFlags |= D3D12_CLEAR_FLAG_DEPTH;
+                                break;
+                            case Aspect::Stencil:
+                                clearFlags |= D3D12_CLEAR_FLAG_STENCIL;
+                                break;
+                            default:
+                                UNREACHABLE();
                         }
+                    }
+                    return clearFlags;
+                };
 
+                for (uint32_t level = range.baseMipLevel;
+                     level < range.baseMipLevel + range.levelCount; ++level) {
+                    uint32_t layer = range.baseArrayLayer;
+                    while (layer < range.baseArrayLayer + range.layerCount) {
+                        D3D12_CLEAR_FLAGS clearFlags = GetClearFlags(level, layer);
                         if (clearFlags == 0) {
+                            ++layer;
                             continue;
                         }
 
+                        // Clear all the following layers that need the same aspects cleared with
+                        // a single view.
+                        uint32_t baseLayer = layer;
+                        do {
+                            ++layer;
+                        } while (layer < range.baseArrayLayer + range.layerCount &&
+                                 GetClearFlags(level, layer) == clearFlags);
+
                         CPUDescriptorHeapAllocation dsvHandle;
                         DAWN_TRY_ASSIGN(dsvHandle, device->GetDepthStencilViewAllocator()
                                                        ->AllocateTransientCPUDescriptors());
                         const D3D12_CPU_DESCRIPTOR_HANDLE baseDescriptor =
                             dsvHandle.GetBaseDescriptor();
-                        D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = GetDSVDescriptor(level, layer, 1);
+                        D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc =
+                            GetDSVDescriptor(level, baseLayer, layer - baseLayer);
                         device->GetD3D12Device()->CreateDepthStencilView(GetD3D12Resource(),
                                                                          &dsvDesc, baseDescriptor);
 
@@ -919,23 +933,36 @@ namespace dawn_native { namespace d3d12 {
                                                  fClearColor};
 
                 ASSERT(range.aspects == Aspect::Color);
+                auto NeedsClear = [&](uint32_t level, uint32_t layer) {
+                    // Skip lazy clears if already initialized.
+                    return clearValue != TextureBase::ClearValue::Zero ||
+                           !IsSubresourceContentInitialized(
+                               SubresourceRange::SingleMipAndLayer(level, layer, Aspect::Color));
+                };
+
                 for (uint32_t level = range.baseMipLevel;
                      level < range.baseMipLevel + range.levelCount; ++level) {
-                    for (uint32_t layer = range.baseArrayLayer;
-                         layer < range.baseArrayLayer + range.layerCount; ++layer) {
-                        if (clearValue == TextureBase::ClearValue::Zero &&
-                            IsSubresourceContentInitialized(
-                                SubresourceRange::SingleMipAndLayer(level, layer, Aspect::Color))) {
-                            // Skip lazy clears if already initialized.
+                    uint32_t layer = range.baseArrayLayer;
+                    while (layer < range.baseArrayLayer + range.layerCount) {
+                        if (!NeedsClear(level, layer)) {
+                            ++layer;
                             continue;
                         }
 
+                        // Clear all the following layers that need a clear with a single view.
+                        uint32_t baseLayer = layer;
+                        do {
+                            ++layer;
+                        } while (layer < range.baseArrayLayer + range.layerCount &&
+                                 NeedsClear(level, layer));
+
                         CPUDescriptorHeapAllocation rtvHeap;
                         DAWN_TRY_ASSIGN(rtvHeap, device->GetRenderTargetViewAllocator()
                                                      ->AllocateTransientCPUDescriptors());
                         const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvHeap.GetBaseDescriptor();
 
-                        D3D12_RENDER_TARGET_VIEW_DESC rtvDesc = GetRTVDescriptor(level, layer, 1);
+                        D3D12_RENDER_TARGET_VIEW_DESC rtvDesc =
+                            GetRTVDescriptor(level, baseLayer, layer - baseLayer);
                         device->GetD3D12Device()->CreateRenderTargetView(GetD3D12Resource(),
                                                                          &rtvDesc, rtvHandle);
                         commandList->ClearRenderTargetView(rtvHandle, clearColorRGBA, 0, nullptr);
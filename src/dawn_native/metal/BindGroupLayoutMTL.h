@@ -30,6 +30,8 @@ namespace dawn_native { namespace metal {
         BindGroup* AllocateBindGroup(Device* device, const BindGroupDescriptor* descriptor);
         void DeallocateBindGroup(BindGroup* bindGroup);
 
+        size_t GetBindGroupAllocatorBytes() const override;
+
       private:
         ~BindGroupLayout() override = default;
         SlabAllocator<BindGroup> mBindGroupAllocator;
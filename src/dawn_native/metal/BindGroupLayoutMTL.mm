@@ -33,4 +33,8 @@ namespace dawn_native { namespace metal {
         mBindGroupAllocator.Deallocate(bindGroup);
     }
 
+    size_t BindGroupLayout::GetBindGroupAllocatorBytes() const {
+        return mBindGroupAllocator.GetAllocatedBytes();
+    }
+
 }}  // namespace dawn_native::metal
@@ -46,6 +46,8 @@ namespace dawn_native { namespace metal {
                                             MTLRenderPassDescriptor* mtlRenderPass,
                                             uint32_t width,
                                             uint32_t height);
+
+        class CommandRecorder;
     };
 
 }}  // namespace dawn_native::metal
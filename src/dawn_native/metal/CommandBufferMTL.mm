@@ -530,395 +530,630 @@ namespace dawn_native { namespace metal {
             StorageBufferLengthTracker* mLengthTracker;
         };
 
-    }  // anonymous namespace
-
-    CommandBuffer::CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor)
-        : CommandBufferBase(encoder, descriptor) {
-    }
-
-    MaybeError CommandBuffer::FillCommands(CommandRecordingContext* commandContext) {
-        const std::vector<PassResourceUsage>& passResourceUsages = GetResourceUsages().perPass;
-        size_t nextPassNumber = 0;
-
-        auto LazyClearForPass = [](const PassResourceUsage& usages,
-                                   CommandRecordingContext* commandContext) {
+        void LazyClearForPass(const PassResourceUsage& usages,
+                              CommandRecordingContext* commandContext) {
             for (size_t i = 0; i < usages.textures.size(); ++i) {
                 Texture* texture = ToBackend(usages.textures[i]);
-                // Clear textures that are not output attachments. Output attachments will be
-                // cleared in CreateMTLRenderPassDescriptor by setting the loadop to clear when the
-                // texture subresource has not been initialized before the render pass.
-                if (!(usages.textureUsages[i].usage & wgpu::TextureUsage::OutputAttachment)) {
-                    texture->EnsureSubresourceContentInitialized(texture->GetAllSubresources());
+                // Clear the subresources used in the pass that are not output attachments. Output
+                // attachments will be cleared in CreateMTLRenderPassDescriptor by setting the
+                // loadop to clear when the texture subresource has not been initialized before the
+                // render pass.
+                for (const SubresourceRange& range : usages.textureUsages[i].lazyClearRanges) {
+                    texture->EnsureSubresourceContentInitialized(range);
                 }
             }
             for (BufferBase* bufferBase : usages.buffers) {
                 ToBackend(bufferBase)->EnsureDataInitialized(commandContext);
             }
-        };
+        }
 
-        Command type;
-        while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::BeginComputePass: {
-                    mCommands.NextCommand<BeginComputePassCmd>();
+        // Encodes the commands of a compute pass other than EndComputePass.
+        class ComputePassEncoder {
+          public:
+            explicit ComputePassEncoder(id<MTLComputeCommandEncoder> encoder)
+                : mEncoder(encoder), mBindGroups(&mStorageBufferLengths) {
+            }
 
-                    LazyClearForPass(passResourceUsages[nextPassNumber], commandContext);
-                    commandContext->EndBlit();
+            template <typename T, typename D>
+            void operator()(T*, D*) {
+                UNREACHABLE();
+            }
 
-                    DAWN_TRY(EncodeComputePass(commandContext));
+            void operator()(DispatchCmd* dispatch, CommandData<DispatchCmd>::Type*) {
+                mBindGroups.Apply(mEncoder);
+                mStorageBufferLengths.Apply(mEncoder, mLastPipeline);
 
-                    nextPassNumber++;
-                    break;
-                }
+                [mEncoder dispatchThreadgroups:MTLSizeMake(dispatch->x, dispatch->y, dispatch->z)
+                         threadsPerThreadgroup:mLastPipeline->GetLocalWorkGroupSize()];
+            }
 
-                case Command::BeginRenderPass: {
-                    BeginRenderPassCmd* cmd = mCommands.NextCommand<BeginRenderPassCmd>();
+            void operator()(DispatchIndirectCmd* dispatch,
+                            CommandData<DispatchIndirectCmd>::Type*) {
+                mBindGroups.Apply(mEncoder);
+                mStorageBufferLengths.Apply(mEncoder, mLastPipeline);
+
+                Buffer* buffer = ToBackend(dispatch->indirectBuffer.Get());
+                id<MTLBuffer> indirectBuffer = buffer->GetMTLBuffer();
+                [mEncoder dispatchThreadgroupsWithIndirectBuffer:indirectBuffer
+                                            indirectBufferOffset:dispatch->indirectOffset
+                                           threadsPerThreadgroup:mLastPipeline
+                                                                     ->GetLocalWorkGroupSize()];
+            }
 
-                    LazyClearForPass(passResourceUsages[nextPassNumber], commandContext);
-                    commandContext->EndBlit();
+            void operator()(SetComputePipelineCmd* cmd, CommandData<SetComputePipelineCmd>::Type*) {
+                mLastPipeline = ToBackend(cmd->pipeline).Get();
 
-                    LazyClearRenderPassAttachments(cmd);
-                    MTLRenderPassDescriptor* descriptor = CreateMTLRenderPassDescriptor(cmd);
-                    DAWN_TRY(EncodeRenderPass(commandContext, descriptor, cmd->width, cmd->height));
+                mBindGroups.OnSetPipeline(mLastPipeline);
 
-                    nextPassNumber++;
-                    break;
-                }
+                mLastPipeline->Encode(mEncoder);
+            }
 
-                case Command::CopyBufferToBuffer: {
-                    CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
-
-                    ToBackend(copy->source)->EnsureDataInitialized(commandContext);
-                    ToBackend(copy->destination)
-                        ->EnsureDataInitializedAsDestination(commandContext,
-                                                             copy->destinationOffset, copy->size);
-
-                    [commandContext->EnsureBlit()
-                           copyFromBuffer:ToBackend(copy->source)->GetMTLBuffer()
-                             sourceOffset:copy->sourceOffset
-                                 toBuffer:ToBackend(copy->destination)->GetMTLBuffer()
-                        destinationOffset:copy->destinationOffset
-                                     size:copy->size];
-                    break;
-                }
+            void operator()(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                mBindGroups.OnSetBindGroup(cmd->index, ToBackend(cmd->group.Get()),
+                                           cmd->dynamicOffsetCount,
+                                           cmd->dynamicOffsetCount > 0 ? dynamicOffsets : nullptr);
+            }
 
-                case Command::CopyBufferToTexture: {
-                    CopyBufferToTextureCmd* copy = mCommands.NextCommand<CopyBufferToTextureCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
-                    auto& copySize = copy->copySize;
-                    Buffer* buffer = ToBackend(src.buffer.Get());
-                    Texture* texture = ToBackend(dst.texture.Get());
-
-                    buffer->EnsureDataInitialized(commandContext);
-                    EnsureDestinationTextureInitialized(texture, copy->destination, copy->copySize);
-
-                    TextureBufferCopySplit splitCopies = ComputeTextureBufferCopySplit(
-                        texture, dst.mipLevel, dst.origin, copySize, buffer->GetSize(), src.offset,
-                        src.bytesPerRow, src.rowsPerImage, dst.aspect);
-
-                    for (uint32_t i = 0; i < splitCopies.count; ++i) {
-                        const TextureBufferCopySplit::CopyInfo& copyInfo = splitCopies.copies[i];
-
-                        const uint32_t copyBaseLayer = copyInfo.textureOrigin.z;
-                        const uint32_t copyLayerCount = copyInfo.copyExtent.depth;
-                        const MTLOrigin textureOrigin =
-                            MTLOriginMake(copyInfo.textureOrigin.x, copyInfo.textureOrigin.y, 0);
-                        const MTLSize copyExtent =
-                            MTLSizeMake(copyInfo.copyExtent.width, copyInfo.copyExtent.height, 1);
-
-                        MTLBlitOption blitOption =
-                            ComputeMTLBlitOption(texture->GetFormat(), dst.aspect);
-
-                        uint64_t bufferOffset = copyInfo.bufferOffset;
-                        for (uint32_t copyLayer = copyBaseLayer;
-                             copyLayer < copyBaseLayer + copyLayerCount; ++copyLayer) {
-                            [commandContext->EnsureBlit() copyFromBuffer:buffer->GetMTLBuffer()
-                                                            sourceOffset:bufferOffset
-                                                       sourceBytesPerRow:copyInfo.bytesPerRow
-                                                     sourceBytesPerImage:copyInfo.bytesPerImage
-                                                              sourceSize:copyExtent
-                                                               toTexture:texture->GetMTLTexture()
-                                                        destinationSlice:copyLayer
-                                                        destinationLevel:dst.mipLevel
-                                                       destinationOrigin:textureOrigin
-                                                                 options:blitOption];
-                            bufferOffset += copyInfo.bytesPerImage;
-                        }
-                    }
+            void operator()(InsertDebugMarkerCmd*, char* label) {
+                NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
 
-                    break;
-                }
+                [mEncoder insertDebugSignpost:mtlLabel];
+                [mtlLabel release];
+            }
 
-                case Command::CopyTextureToBuffer: {
-                    CopyTextureToBufferCmd* copy = mCommands.NextCommand<CopyTextureToBufferCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
-                    auto& copySize = copy->copySize;
-                    Texture* texture = ToBackend(src.texture.Get());
-                    Buffer* buffer = ToBackend(dst.buffer.Get());
-
-                    buffer->EnsureDataInitializedAsDestination(commandContext, copy);
-
-                    texture->EnsureSubresourceContentInitialized(
-                        GetSubresourcesAffectedByCopy(src, copySize));
-
-                    TextureBufferCopySplit splitCopies = ComputeTextureBufferCopySplit(
-                        texture, src.mipLevel, src.origin, copySize, buffer->GetSize(), dst.offset,
-                        dst.bytesPerRow, dst.rowsPerImage, src.aspect);
-
-                    for (uint32_t i = 0; i < splitCopies.count; ++i) {
-                        const TextureBufferCopySplit::CopyInfo& copyInfo = splitCopies.copies[i];
-
-                        const uint32_t copyBaseLayer = copyInfo.textureOrigin.z;
-                        const uint32_t copyLayerCount = copyInfo.copyExtent.depth;
-                        const MTLOrigin textureOrigin =
-                            MTLOriginMake(copyInfo.textureOrigin.x, copyInfo.textureOrigin.y, 0);
-                        const MTLSize copyExtent =
-                            MTLSizeMake(copyInfo.copyExtent.width, copyInfo.copyExtent.height, 1);
-
-                        MTLBlitOption blitOption =
-                            ComputeMTLBlitOption(texture->GetFormat(), src.aspect);
-
-                        uint64_t bufferOffset = copyInfo.bufferOffset;
-                        for (uint32_t copyLayer = copyBaseLayer;
-                             copyLayer < copyBaseLayer + copyLayerCount; ++copyLayer) {
-                            [commandContext->EnsureBlit() copyFromTexture:texture->GetMTLTexture()
-                                                              sourceSlice:copyLayer
-                                                              sourceLevel:src.mipLevel
-                                                             sourceOrigin:textureOrigin
-                                                               sourceSize:copyExtent
-                                                                 toBuffer:buffer->GetMTLBuffer()
-                                                        destinationOffset:bufferOffset
-                                                   destinationBytesPerRow:copyInfo.bytesPerRow
-                                                 destinationBytesPerImage:copyInfo.bytesPerImage
-                                                                  options:blitOption];
-                            bufferOffset += copyInfo.bytesPerImage;
-                        }
-                    }
+            void operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                [mEncoder popDebugGroup];
+            }
 
-                    break;
-                }
+            void operator()(PushDebugGroupCmd*, char* label) {
+                NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
 
-                case Command::CopyTextureToTexture: {
-                    CopyTextureToTextureCmd* copy =
-                        mCommands.NextCommand<CopyTextureToTextureCmd>();
-                    Texture* srcTexture = ToBackend(copy->source.texture.Get());
-                    Texture* dstTexture = ToBackend(copy->destination.texture.Get());
-
-                    srcTexture->EnsureSubresourceContentInitialized(
-                        GetSubresourcesAffectedByCopy(copy->source, copy->copySize));
-                    EnsureDestinationTextureInitialized(dstTexture, copy->destination,
-                                                        copy->copySize);
-
-                    // TODO(jiawei.shao@intel.com): support copies with 1D and 3D textures.
-                    ASSERT(srcTexture->GetDimension() == wgpu::TextureDimension::e2D &&
-                           dstTexture->GetDimension() == wgpu::TextureDimension::e2D);
-                    const MTLSize sizeOneLayer =
-                        MTLSizeMake(copy->copySize.width, copy->copySize.height, 1);
-                    const MTLOrigin sourceOriginNoLayer =
-                        MTLOriginMake(copy->source.origin.x, copy->source.origin.y, 0);
-                    const MTLOrigin destinationOriginNoLayer =
-                        MTLOriginMake(copy->destination.origin.x, copy->destination.origin.y, 0);
-
-                    for (uint32_t slice = 0; slice < copy->copySize.depth; ++slice) {
-                        [commandContext->EnsureBlit()
-                              copyFromTexture:srcTexture->GetMTLTexture()
-                                  sourceSlice:copy->source.origin.z + slice
-                                  sourceLevel:copy->source.mipLevel
-                                 sourceOrigin:sourceOriginNoLayer
-                                   sourceSize:sizeOneLayer
-                                    toTexture:dstTexture->GetMTLTexture()
-                             destinationSlice:copy->destination.origin.z + slice
-                             destinationLevel:copy->destination.mipLevel
-                            destinationOrigin:destinationOriginNoLayer];
-                    }
-                    break;
-                }
+                [mEncoder pushDebugGroup:mtlLabel];
+                [mtlLabel release];
+            }
 
-                case Command::ResolveQuerySet: {
-                    ResolveQuerySetCmd* cmd = mCommands.NextCommand<ResolveQuerySetCmd>();
-                    QuerySet* querySet = ToBackend(cmd->querySet.Get());
-                    Buffer* destination = ToBackend(cmd->destination.Get());
-
-                    destination->EnsureDataInitializedAsDestination(
-                        commandContext, cmd->destinationOffset, cmd->queryCount * sizeof(uint64_t));
-
-                    if (@available(macos 10.15, iOS 14.0, *)) {
-                        [commandContext->EnsureBlit()
-                              resolveCounters:querySet->GetCounterSampleBuffer()
-                                      inRange:NSMakeRange(cmd->firstQuery,
-                                                          cmd->firstQuery + cmd->queryCount)
-                            destinationBuffer:destination->GetMTLBuffer()
-                            destinationOffset:NSUInteger(cmd->destinationOffset)];
-                    } else {
-                        UNREACHABLE();
-                    }
-                    break;
+            void operator()(WriteTimestampCmd* cmd, CommandData<WriteTimestampCmd>::Type*) {
+                QuerySet* querySet = ToBackend(cmd->querySet.Get());
+
+                if (@available(macos 10.15, iOS 14.0, *)) {
+                    [mEncoder sampleCountersInBuffer:querySet->GetCounterSampleBuffer()
+                                       atSampleIndex:NSUInteger(cmd->queryIndex)
+                                         withBarrier:YES];
+                } else {
+                    UNREACHABLE();
                 }
+            }
 
-                case Command::WriteTimestamp: {
-                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
-                    QuerySet* querySet = ToBackend(cmd->querySet.Get());
+          private:
+            id<MTLComputeCommandEncoder> mEncoder;
+            ComputePipeline* mLastPipeline = nullptr;
+            StorageBufferLengthTracker mStorageBufferLengths = {};
+            BindGroupTracker mBindGroups;
+        };
 
-                    if (@available(macos 10.15, iOS 14.0, *)) {
-                        [commandContext->EnsureBlit()
-                            sampleCountersInBuffer:querySet->GetCounterSampleBuffer()
-                                     atSampleIndex:NSUInteger(cmd->queryIndex)
-                                       withBarrier:YES];
-                    } else {
-                        UNREACHABLE();
-                    }
-                    break;
+        // Encodes the commands of a render pass other than EndRenderPass, and the commands of the
+        // bundles it executes.
+        class RenderPassEncoder {
+          public:
+            RenderPassEncoder(id<MTLRenderCommandEncoder> encoder, bool enableVertexPulling)
+                : mEncoder(encoder),
+                  mEnableVertexPulling(enableVertexPulling),
+                  mVertexBuffers(&mStorageBufferLengths),
+                  mBindGroups(&mStorageBufferLengths) {
+            }
+
+            template <typename T, typename D>
+            void operator()(T*, D*) {
+                UNREACHABLE();
+            }
+
+            void operator()(DrawCmd* draw, CommandData<DrawCmd>::Type*) {
+                ApplyDrawState();
+                EncodeDraw(draw);
+            }
+
+            void operator()(DrawIndexedCmd* draw, CommandData<DrawIndexedCmd>::Type*) {
+                ApplyDrawState();
+                EncodeDrawIndexed(draw, GetIndexFormat());
+            }
+
+            void operator()(MultiDrawCmd* cmd, DrawCmd* draws) {
+                ApplyDrawState();
+                for (uint32_t i = 0; i < cmd->drawCount; ++i) {
+                    EncodeDraw(&draws[i]);
                 }
+            }
 
-                case Command::InsertDebugMarker: {
-                    // MTLCommandBuffer does not implement insertDebugSignpost
-                    SkipCommand(&mCommands, type);
-                    break;
+            void operator()(MultiDrawIndexedCmd* cmd, DrawIndexedCmd* draws) {
+                ApplyDrawState();
+                wgpu::IndexFormat indexFormat = GetIndexFormat();
+                for (uint32_t i = 0; i < cmd->drawCount; ++i) {
+                    EncodeDrawIndexed(&draws[i], indexFormat);
                 }
+            }
 
-                case Command::PopDebugGroup: {
-                    mCommands.NextCommand<PopDebugGroupCmd>();
+            void operator()(DrawIndirectCmd* draw, CommandData<DrawIndirectCmd>::Type*) {
+                ApplyDrawState();
 
-                    if (@available(macos 10.13, *)) {
-                        [commandContext->GetCommands() popDebugGroup];
-                    }
-                    break;
-                }
+                Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
+                id<MTLBuffer> indirectBuffer = buffer->GetMTLBuffer();
+                [mEncoder drawPrimitives:mLastPipeline->GetMTLPrimitiveTopology()
+                           indirectBuffer:indirectBuffer
+                     indirectBufferOffset:draw->indirectOffset];
+            }
 
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = mCommands.NextCommand<PushDebugGroupCmd>();
-                    char* label = mCommands.NextData<char>(cmd->length + 1);
+            void operator()(DrawIndexedIndirectCmd* draw,
+                            CommandData<DrawIndexedIndirectCmd>::Type*) {
+                ApplyDrawState();
 
-                    if (@available(macos 10.13, *)) {
-                        NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
-                        [commandContext->GetCommands() pushDebugGroup:mtlLabel];
-                        [mtlLabel release];
-                    }
+                wgpu::IndexFormat indexFormat = GetIndexFormat();
 
-                    break;
-                }
+                Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
+                id<MTLBuffer> indirectBuffer = buffer->GetMTLBuffer();
+                [mEncoder drawIndexedPrimitives:mLastPipeline->GetMTLPrimitiveTopology()
+                                      indexType:MTLIndexFormat(indexFormat)
+                                    indexBuffer:mIndexBuffer
+                              indexBufferOffset:mIndexBufferBaseOffset
+                                 indirectBuffer:indirectBuffer
+                           indirectBufferOffset:draw->indirectOffset];
+            }
 
-                default:
-                    UNREACHABLE();
+            void operator()(InsertDebugMarkerCmd*, char* label) {
+                NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
+
+                [mEncoder insertDebugSignpost:mtlLabel];
+                [mtlLabel release];
             }
-        }
 
-        commandContext->EndBlit();
-        return {};
-    }
+            void operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                [mEncoder popDebugGroup];
+            }
 
-    MaybeError CommandBuffer::EncodeComputePass(CommandRecordingContext* commandContext) {
-        ComputePipeline* lastPipeline = nullptr;
-        StorageBufferLengthTracker storageBufferLengths = {};
-        BindGroupTracker bindGroups(&storageBufferLengths);
+            void operator()(PushDebugGroupCmd*, char* label) {
+                NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
 
-        id<MTLComputeCommandEncoder> encoder = commandContext->BeginCompute();
+                [mEncoder pushDebugGroup:mtlLabel];
+                [mtlLabel release];
+            }
 
-        Command type;
-        while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndComputePass: {
-                    mCommands.NextCommand<EndComputePassCmd>();
-                    commandContext->EndCompute();
-                    return {};
-                }
+            void operator()(SetRenderPipelineCmd* cmd, CommandData<SetRenderPipelineCmd>::Type*) {
+                RenderPipeline* newPipeline = ToBackend(cmd->pipeline).Get();
 
-                case Command::Dispatch: {
-                    DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
+                mVertexBuffers.OnSetPipeline(mLastPipeline, newPipeline);
+                mBindGroups.OnSetPipeline(newPipeline);
 
-                    bindGroups.Apply(encoder);
-                    storageBufferLengths.Apply(encoder, lastPipeline);
+                [mEncoder setDepthStencilState:newPipeline->GetMTLDepthStencilState()];
+                [mEncoder setFrontFacingWinding:newPipeline->GetMTLFrontFace()];
+                [mEncoder setCullMode:newPipeline->GetMTLCullMode()];
+                [mEncoder setDepthBias:newPipeline->GetDepthBias()
+                            slopeScale:newPipeline->GetDepthBiasSlopeScale()
+                                 clamp:newPipeline->GetDepthBiasClamp()];
+                newPipeline->Encode(mEncoder);
 
-                    [encoder dispatchThreadgroups:MTLSizeMake(dispatch->x, dispatch->y, dispatch->z)
-                            threadsPerThreadgroup:lastPipeline->GetLocalWorkGroupSize()];
-                    break;
-                }
+                mLastPipeline = newPipeline;
+            }
 
-                case Command::DispatchIndirect: {
-                    DispatchIndirectCmd* dispatch = mCommands.NextCommand<DispatchIndirectCmd>();
+            void operator()(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                mBindGroups.OnSetBindGroup(cmd->index, ToBackend(cmd->group.Get()),
+                                           cmd->dynamicOffsetCount,
+                                           cmd->dynamicOffsetCount > 0 ? dynamicOffsets : nullptr);
+            }
 
-                    bindGroups.Apply(encoder);
-                    storageBufferLengths.Apply(encoder, lastPipeline);
+            void operator()(SetIndexBufferCmd* cmd, CommandData<SetIndexBufferCmd>::Type*) {
+                auto b = ToBackend(cmd->buffer.Get());
+                mIndexBuffer = b->GetMTLBuffer();
+                mIndexBufferBaseOffset = cmd->offset;
+                // TODO(crbug.com/dawn/502): Once setIndexBuffer is required to specify an
+                // index buffer format store as an MTLIndexType.
+                mIndexBufferFormat = cmd->format;
+            }
 
-                    Buffer* buffer = ToBackend(dispatch->indirectBuffer.Get());
-                    id<MTLBuffer> indirectBuffer = buffer->GetMTLBuffer();
-                    [encoder dispatchThreadgroupsWithIndirectBuffer:indirectBuffer
-                                               indirectBufferOffset:dispatch->indirectOffset
-                                              threadsPerThreadgroup:lastPipeline
-                                                                        ->GetLocalWorkGroupSize()];
-                    break;
-                }
+            void operator()(SetVertexBufferCmd* cmd, CommandData<SetVertexBufferCmd>::Type*) {
+                mVertexBuffers.OnSetVertexBuffer(cmd->slot, ToBackend(cmd->buffer.Get()),
+                                                 cmd->offset);
+            }
 
-                case Command::SetComputePipeline: {
-                    SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
-                    lastPipeline = ToBackend(cmd->pipeline).Get();
+            void operator()(SetStencilReferenceCmd* cmd,
+                            CommandData<SetStencilReferenceCmd>::Type*) {
+                [mEncoder setStencilReferenceValue:cmd->reference];
+            }
 
-                    bindGroups.OnSetPipeline(lastPipeline);
+            void operator()(SetViewportCmd* cmd, CommandData<SetViewportCmd>::Type*) {
+                MTLViewport viewport;
+                viewport.originX = cmd->x;
+                viewport.originY = cmd->y;
+                viewport.width = cmd->width;
+                viewport.height = cmd->height;
+                viewport.znear = cmd->minDepth;
+                viewport.zfar = cmd->maxDepth;
 
-                    lastPipeline->Encode(encoder);
-                    break;
-                }
+                [mEncoder setViewport:viewport];
+            }
 
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = mCommands.NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+            void operator()(SetScissorRectCmd* cmd, CommandData<SetScissorRectCmd>::Type*) {
+                MTLScissorRect rect;
+                rect.x = cmd->x;
+                rect.y = cmd->y;
+                rect.width = cmd->width;
+                rect.height = cmd->height;
 
-                    bindGroups.OnSetBindGroup(cmd->index, ToBackend(cmd->group.Get()),
-                                              cmd->dynamicOffsetCount, dynamicOffsets);
-                    break;
-                }
+                [mEncoder setScissorRect:rect];
+            }
 
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = mCommands.NextCommand<InsertDebugMarkerCmd>();
-                    char* label = mCommands.NextData<char>(cmd->length + 1);
-                    NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
+            void operator()(SetBlendColorCmd* cmd, CommandData<SetBlendColorCmd>::Type*) {
+                [mEncoder setBlendColorRed:cmd->color.r
+                                     green:cmd->color.g
+                                      blue:cmd->color.b
+                                     alpha:cmd->color.a];
+            }
 
-                    [encoder insertDebugSignpost:mtlLabel];
-                    [mtlLabel release];
-                    break;
+            void operator()(ExecuteBundlesCmd* cmd, Ref<RenderBundleBase>* bundles) {
+                for (uint32_t i = 0; i < cmd->count; ++i) {
+                    CommandIterator bundleCommands = bundles[i]->GetCommands()->Borrow();
+                    Command bundleType;
+                    while (bundleCommands.NextCommandId(&bundleType)) {
+                        VisitCommand(&bundleCommands, bundleType, *this);
+                    }
                 }
+            }
 
-                case Command::PopDebugGroup: {
-                    mCommands.NextCommand<PopDebugGroupCmd>();
+            void operator()(WriteTimestampCmd* cmd, CommandData<WriteTimestampCmd>::Type*) {
+                QuerySet* querySet = ToBackend(cmd->querySet.Get());
 
-                    [encoder popDebugGroup];
-                    break;
+                if (@available(macos 10.15, iOS 14.0, *)) {
+                    [mEncoder sampleCountersInBuffer:querySet->GetCounterSampleBuffer()
+                                       atSampleIndex:NSUInteger(cmd->queryIndex)
+                                         withBarrier:YES];
+                } else {
+                    UNREACHABLE();
                 }
+            }
 
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = mCommands.NextCommand<PushDebugGroupCmd>();
-                    char* label = mCommands.NextData<char>(cmd->length + 1);
-                    NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
+          private:
+            void ApplyDrawState() {
+                mVertexBuffers.Apply(mEncoder, mLastPipeline, mEnableVertexPulling);
+                mBindGroups.Apply(mEncoder);
+                mStorageBufferLengths.Apply(mEncoder, mLastPipeline, mEnableVertexPulling);
+            }
 
-                    [encoder pushDebugGroup:mtlLabel];
-                    [mtlLabel release];
-                    break;
+            void EncodeDraw(const DrawCmd* draw) {
+                // The instance count must be non-zero, otherwise no-op
+                if (draw->instanceCount != 0) {
+                    // MTLFeatureSet_iOS_GPUFamily3_v1 does not support baseInstance
+                    if (draw->firstInstance == 0) {
+                        [mEncoder drawPrimitives:mLastPipeline->GetMTLPrimitiveTopology()
+                                     vertexStart:draw->firstVertex
+                                     vertexCount:draw->vertexCount
+                                   instanceCount:draw->instanceCount];
+                    } else {
+                        [mEncoder drawPrimitives:mLastPipeline->GetMTLPrimitiveTopology()
+                                     vertexStart:draw->firstVertex
+                                     vertexCount:draw->vertexCount
+                                   instanceCount:draw->instanceCount
+                                    baseInstance:draw->firstInstance];
+                    }
                 }
+            }
 
-                case Command::WriteTimestamp: {
-                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
-                    QuerySet* querySet = ToBackend(cmd->querySet.Get());
+            wgpu::IndexFormat GetIndexFormat() const {
+                // If a index format was specified in setIndexBuffer always use it.
+                wgpu::IndexFormat indexFormat = mIndexBufferFormat;
+                if (indexFormat == wgpu::IndexFormat::Undefined) {
+                    // Otherwise use the pipeline's index format.
+                    // TODO(crbug.com/dawn/502): This path is deprecated.
+                    indexFormat = mLastPipeline->GetVertexStateDescriptor()->indexFormat;
+                }
+                return indexFormat;
+            }
 
-                    if (@available(macos 10.15, iOS 14.0, *)) {
-                        [encoder sampleCountersInBuffer:querySet->GetCounterSampleBuffer()
-                                          atSampleIndex:NSUInteger(cmd->queryIndex)
-                                            withBarrier:YES];
+            void EncodeDrawIndexed(const DrawIndexedCmd* draw, wgpu::IndexFormat indexFormat) {
+                size_t formatSize = IndexFormatSize(indexFormat);
+
+                // The index and instance count must be non-zero, otherwise no-op
+                if (draw->indexCount != 0 && draw->instanceCount != 0) {
+                    // MTLFeatureSet_iOS_GPUFamily3_v1 does not support baseInstance and
+                    // baseVertex.
+                    if (draw->baseVertex == 0 && draw->firstInstance == 0) {
+                        [mEncoder drawIndexedPrimitives:mLastPipeline->GetMTLPrimitiveTopology()
+                                             indexCount:draw->indexCount
+                                              indexType:MTLIndexFormat(indexFormat)
+                                            indexBuffer:mIndexBuffer
+                                      indexBufferOffset:mIndexBufferBaseOffset +
+                                                        draw->firstIndex * formatSize
+                                          instanceCount:draw->instanceCount];
                     } else {
-                        UNREACHABLE();
+                        [mEncoder drawIndexedPrimitives:mLastPipeline->GetMTLPrimitiveTopology()
+                                             indexCount:draw->indexCount
+                                              indexType:MTLIndexFormat(indexFormat)
+                                            indexBuffer:mIndexBuffer
+                                      indexBufferOffset:mIndexBufferBaseOffset +
+                                                        draw->firstIndex * formatSize
+                                          instanceCount:draw->instanceCount
+                                             baseVertex:draw->baseVertex
+                                           baseInstance:draw->firstInstance];
                     }
-                    break;
                 }
+            }
 
-                default: {
-                    UNREACHABLE();
-                    break;
+            id<MTLRenderCommandEncoder> mEncoder;
+            bool mEnableVertexPulling;
+            RenderPipeline* mLastPipeline = nullptr;
+            id<MTLBuffer> mIndexBuffer = nil;
+            uint32_t mIndexBufferBaseOffset = 0;
+            wgpu::IndexFormat mIndexBufferFormat = wgpu::IndexFormat::Undefined;
+            StorageBufferLengthTracker mStorageBufferLengths = {};
+            VertexBufferTracker mVertexBuffers;
+            BindGroupTracker mBindGroups;
+        };
+
+    }  // anonymous namespace
+
+    // Encodes the commands outside of passes.
+    class CommandBuffer::CommandRecorder {
+      public:
+        CommandRecorder(CommandBuffer* commandBuffer, CommandRecordingContext* commandContext)
+            : mCommandBuffer(commandBuffer), mCommandContext(commandContext) {
+        }
+
+        template <typename T, typename D>
+        MaybeError operator()(T*, D*) {
+            UNREACHABLE();
+            return {};
+        }
+
+        MaybeError operator()(BeginComputePassCmd*, CommandData<BeginComputePassCmd>::Type*) {
+            LazyClearForPass(NextPassResourceUsage(), mCommandContext);
+            mCommandContext->EndBlit();
+
+            return mCommandBuffer->EncodeComputePass(mCommandContext);
+        }
+
+        MaybeError operator()(BeginRenderPassCmd* cmd, CommandData<BeginRenderPassCmd>::Type*) {
+            LazyClearForPass(NextPassResourceUsage(), mCommandContext);
+            mCommandContext->EndBlit();
+
+            LazyClearRenderPassAttachments(cmd);
+            MTLRenderPassDescriptor* descriptor = CreateMTLRenderPassDescriptor(cmd);
+            return mCommandBuffer->EncodeRenderPass(mCommandContext, descriptor, cmd->width,
+                                                    cmd->height);
+        }
+
+        MaybeError operator()(CopyBufferToBufferCmd* copy,
+                              CommandData<CopyBufferToBufferCmd>::Type*) {
+            ToBackend(copy->source)->EnsureDataInitialized(mCommandContext);
+            ToBackend(copy->destination)
+                ->EnsureDataInitializedAsDestination(mCommandContext, copy->destinationOffset,
+                                                     copy->size);
+
+            [mCommandContext->EnsureBlit()
+                   copyFromBuffer:ToBackend(copy->source)->GetMTLBuffer()
+                     sourceOffset:copy->sourceOffset
+                         toBuffer:ToBackend(copy->destination)->GetMTLBuffer()
+                destinationOffset:copy->destinationOffset
+                             size:copy->size];
+            return {};
+        }
+
+        MaybeError operator()(CopyBufferToTextureCmd* copy,
+                              CommandData<CopyBufferToTextureCmd>::Type*) {
+            auto& src = copy->source;
+            auto& dst = copy->destination;
+            auto& copySize = copy->copySize;
+            Buffer* buffer = ToBackend(src.buffer.Get());
+            Texture* texture = ToBackend(dst.texture.Get());
+
+            buffer->EnsureDataInitialized(mCommandContext);
+            EnsureDestinationTextureInitialized(texture, copy->destination, copy->copySize);
+
+            TextureBufferCopySplit splitCopies = ComputeTextureBufferCopySplit(
+                texture, dst.mipLevel, dst.origin, copySize, buffer->GetSize(), src.offset,
+                src.bytesPerRow, src.rowsPerImage, dst.aspect);
+
+            for (uint32_t i = 0; i < splitCopies.count; ++i) {
+                const TextureBufferCopySplit::CopyInfo& copyInfo = splitCopies.copies[i];
+
+                const uint32_t copyBaseLayer = copyInfo.textureOrigin.z;
+                const uint32_t copyLayerCount = copyInfo.copyExtent.depth;
+                const MTLOrigin textureOrigin =
+                    MTLOriginMake(copyInfo.textureOrigin.x, copyInfo.textureOrigin.y, 0);
+                const MTLSize copyExtent =
+                    MTLSizeMake(copyInfo.copyExtent.width, copyInfo.copyExtent.height, 1);
+
+                MTLBlitOption blitOption = ComputeMTLBlitOption(texture->GetFormat(), dst.aspect);
+
+                uint64_t bufferOffset = copyInfo.bufferOffset;
+                for (uint32_t copyLayer = copyBaseLayer;
+                     copyLayer < copyBaseLayer + copyLayerCount; ++copyLayer) {
+                    [mCommandContext->EnsureBlit() copyFromBuffer:buffer->GetMTLBuffer()
+                                                     sourceOffset:bufferOffset
+                                                sourceBytesPerRow:copyInfo.bytesPerRow
+                                              sourceBytesPerImage:copyInfo.bytesPerImage
+                                                       sourceSize:copyExtent
+                                                        toTexture:texture->GetMTLTexture()
+                                                 destinationSlice:copyLayer
+                                                 destinationLevel:dst.mipLevel
+                                                destinationOrigin:textureOrigin
+                                                          options:blitOption];
+                    bufferOffset += copyInfo.bytesPerImage;
+                }
+            }
+            return {};
+        }
+
+        MaybeError operator()(CopyTextureToBufferCmd* copy,
+                              CommandData<CopyTextureToBufferCmd>::Type*) {
+            auto& src = copy->source;
+            auto& dst = copy->destination;
+            auto& copySize = copy->copySize;
+            Texture* texture = ToBackend(src.texture.Get());
+            Buffer* buffer = ToBackend(dst.buffer.Get());
+
+            buffer->EnsureDataInitializedAsDestination(mCommandContext, copy);
+
+            texture->EnsureSubresourceContentInitialized(
+                GetSubresourcesAffectedByCopy(src, copySize));
+
+            TextureBufferCopySplit splitCopies = ComputeTextureBufferCopySplit(
+                texture, src.mipLevel, src.origin, copySize, buffer->GetSize(), dst.offset,
+                dst.bytesPerRow, dst.rowsPerImage, src.aspect);
+
+            for (uint32_t i = 0; i < splitCopies.count; ++i) {
+                const TextureBufferCopySplit::CopyInfo& copyInfo = splitCopies.copies[i];
+
+                const uint32_t copyBaseLayer = copyInfo.textureOrigin.z;
+                const uint32_t copyLayerCount = copyInfo.copyExtent.depth;
+                const MTLOrigin textureOrigin =
+                    MTLOriginMake(copyInfo.textureOrigin.x, copyInfo.textureOrigin.y, 0);
+                const MTLSize copyExtent =
+                    MTLSizeMake(copyInfo.copyExtent.width, copyInfo.copyExtent.height, 1);
+
+                MTLBlitOption blitOption = ComputeMTLBlitOption(texture->GetFormat(), src.aspect);
+
+                uint64_t bufferOffset = copyInfo.bufferOffset;
+                for (uint32_t copyLayer = copyBaseLayer;
+                     copyLayer < copyBaseLayer + copyLayerCount; ++copyLayer) {
+                    [mCommandContext->EnsureBlit() copyFromTexture:texture->GetMTLTexture()
+                                                       sourceSlice:copyLayer
+                                                       sourceLevel:src.mipLevel
+                                                      sourceOrigin:textureOrigin
+                                                        sourceSize:copyExtent
+                                                          toBuffer:buffer->GetMTLBuffer()
+                                                 destinationOffset:bufferOffset
+                                            destinationBytesPerRow:copyInfo.bytesPerRow
+                                          destinationBytesPerImage:copyInfo.bytesPerImage
+                                                           options:blitOption];
+                    bufferOffset += copyInfo.bytesPerImage;
                 }
             }
+            return {};
+        }
+
+        MaybeError operator()(CopyTextureToTextureCmd* copy,
+                              CommandData<CopyTextureToTextureCmd>::Type*) {
+            Texture* srcTexture = ToBackend(copy->source.texture.Get());
+            Texture* dstTexture = ToBackend(copy->destination.texture.Get());
+
+            srcTexture->EnsureSubresourceContentInitialized(
+                GetSubresourcesAffectedByCopy(copy->source, copy->copySize));
+            EnsureDestinationTextureInitialized(dstTexture, copy->destination, copy->copySize);
+
+            // TODO(jiawei.shao@intel.com): support copies with 1D and 3D textures.
+            ASSERT(srcTexture->GetDimension() == wgpu::TextureDimension::e2D &&
+                   dstTexture->GetDimension() == wgpu::TextureDimension::e2D);
+            const MTLSize sizeOneLayer =
+                MTLSizeMake(copy->copySize.width, copy->copySize.height, 1);
+            const MTLOrigin sourceOriginNoLayer =
+                MTLOriginMake(copy->source.origin.x, copy->source.origin.y, 0);
+            const MTLOrigin destinationOriginNoLayer =
+                MTLOriginMake(copy->destination.origin.x, copy->destination.origin.y, 0);
+
+            for (uint32_t slice = 0; slice < copy->copySize.depth; ++slice) {
+                [mCommandContext->EnsureBlit()
+                      copyFromTexture:srcTexture->GetMTLTexture()
+                          sourceSlice:copy->source.origin.z + slice
+                          sourceLevel:copy->source.mipLevel
+                         sourceOrigin:sourceOriginNoLayer
+                           sourceSize:sizeOneLayer
+                            toTexture:dstTexture->GetMTLTexture()
+                     destinationSlice:copy->destination.origin.z + slice
+                     destinationLevel:copy->destination.mipLevel
+                    destinationOrigin:destinationOriginNoLayer];
+            }
+            return {};
+        }
+
+        MaybeError operator()(ResolveQuerySetCmd* cmd, CommandData<ResolveQuerySetCmd>::Type*) {
+            QuerySet* querySet = ToBackend(cmd->querySet.Get());
+            Buffer* destination = ToBackend(cmd->destination.Get());
+
+            destination->EnsureDataInitializedAsDestination(
+                mCommandContext, cmd->destinationOffset, cmd->queryCount * sizeof(uint64_t));
+
+            if (@available(macos 10.15, iOS 14.0, *)) {
+                [mCommandContext->EnsureBlit()
+                      resolveCounters:querySet->GetCounterSampleBuffer()
+                              inRange:NSMakeRange(cmd->firstQuery,
+                                                  cmd->firstQuery + cmd->queryCount)
+                    destinationBuffer:destination->GetMTLBuffer()
+                    destinationOffset:NSUInteger(cmd->destinationOffset)];
+            } else {
+                UNREACHABLE();
+            }
+            return {};
+        }
+
+        MaybeError operator()(WriteTimestampCmd* cmd, CommandData<WriteTimestampCmd>::Type*) {
+            QuerySet* querySet = ToBackend(cmd->querySet.Get());
+
+            if (@available(macos 10.15, iOS 14.0, *)) {
+                [mCommandContext->EnsureBlit()
+                    sampleCountersInBuffer:querySet->GetCounterSampleBuffer()
+                             atSampleIndex:NSUInteger(cmd->queryIndex)
+                               withBarrier:YES];
+            } else {
+                UNREACHABLE();
+            }
+            return {};
+        }
+
+        MaybeError operator()(InsertDebugMarkerCmd*, char*) {
+            // MTLCommandBuffer does not implement insertDebugSignpost
+            return {};
+        }
+
+        MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+            if (@available(macos 10.13, *)) {
+                [mCommandContext->GetCommands() popDebugGroup];
+            }
+            return {};
+        }
+
+        MaybeError operator()(PushDebugGroupCmd*, char* label) {
+            if (@available(macos 10.13, *)) {
+                NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
+                [mCommandContext->GetCommands() pushDebugGroup:mtlLabel];
+                [mtlLabel release];
+            }
+            return {};
+        }
+
+      private:
+        const PassResourceUsage& NextPassResourceUsage() {
+            return mCommandBuffer->GetResourceUsages().perPass[mNextPassNumber++];
+        }
+
+        CommandBuffer* mCommandBuffer;
+        CommandRecordingContext* mCommandContext;
+        size_t mNextPassNumber = 0;
+    };
+
+    CommandBuffer::CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor)
+        : CommandBufferBase(encoder, descriptor) {
+    }
+
+    MaybeError CommandBuffer::FillCommands(CommandRecordingContext* commandContext) {
+        CommandRecorder recorder(this, commandContext);
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            DAWN_TRY(VisitCommand(&mCommands, type, recorder));
+        }
+
+        commandContext->EndBlit();
+        return {};
+    }
+
+    MaybeError CommandBuffer::EncodeComputePass(CommandRecordingContext* commandContext) {
+        ComputePassEncoder passEncoder(commandContext->BeginCompute());
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            if (type == Command::EndComputePass) {
+                mCommands.NextCommand<EndComputePassCmd>();
+                commandContext->EndCompute();
+                return {};
+            }
+            VisitCommand(&mCommands, type, passEncoder);
         }
 
         // EndComputePass should have been called
@@ -1023,294 +1258,17 @@ namespace dawn_native { namespace metal {
                                                        uint32_t width,
                                                        uint32_t height) {
         bool enableVertexPulling = GetDevice()->IsToggleEnabled(Toggle::MetalEnableVertexPulling);
-        RenderPipeline* lastPipeline = nullptr;
-        id<MTLBuffer> indexBuffer = nil;
-        uint32_t indexBufferBaseOffset = 0;
-        wgpu::IndexFormat indexBufferFormat = wgpu::IndexFormat::Undefined;
-        StorageBufferLengthTracker storageBufferLengths = {};
-        VertexBufferTracker vertexBuffers(&storageBufferLengths);
-        BindGroupTracker bindGroups(&storageBufferLengths);
-
-        id<MTLRenderCommandEncoder> encoder = commandContext->BeginRender(mtlRenderPass);
-
-        auto EncodeRenderBundleCommand = [&](CommandIterator* iter, Command type) {
-            switch (type) {
-                case Command::Draw: {
-                    DrawCmd* draw = iter->NextCommand<DrawCmd>();
-
-                    vertexBuffers.Apply(encoder, lastPipeline, enableVertexPulling);
-                    bindGroups.Apply(encoder);
-                    storageBufferLengths.Apply(encoder, lastPipeline, enableVertexPulling);
-
-                    // The instance count must be non-zero, otherwise no-op
-                    if (draw->instanceCount != 0) {
-                        // MTLFeatureSet_iOS_GPUFamily3_v1 does not support baseInstance
-                        if (draw->firstInstance == 0) {
-                            [encoder drawPrimitives:lastPipeline->GetMTLPrimitiveTopology()
-                                        vertexStart:draw->firstVertex
-                                        vertexCount:draw->vertexCount
-                                      instanceCount:draw->instanceCount];
-                        } else {
-                            [encoder drawPrimitives:lastPipeline->GetMTLPrimitiveTopology()
-                                        vertexStart:draw->firstVertex
-                                        vertexCount:draw->vertexCount
-                                      instanceCount:draw->instanceCount
-                                       baseInstance:draw->firstInstance];
-                        }
-                    }
-                    break;
-                }
-
-                case Command::DrawIndexed: {
-                    DrawIndexedCmd* draw = iter->NextCommand<DrawIndexedCmd>();
-
-                    vertexBuffers.Apply(encoder, lastPipeline, enableVertexPulling);
-                    bindGroups.Apply(encoder);
-                    storageBufferLengths.Apply(encoder, lastPipeline, enableVertexPulling);
-
-                    // If a index format was specified in setIndexBuffer always use it.
-                    wgpu::IndexFormat indexFormat = indexBufferFormat;
-                    if (indexFormat == wgpu::IndexFormat::Undefined) {
-                        // Otherwise use the pipeline's index format.
-                        // TODO(crbug.com/dawn/502): This path is deprecated.
-                        indexFormat = lastPipeline->GetVertexStateDescriptor()->indexFormat;
-                    }
-                    size_t formatSize = IndexFormatSize(indexFormat);
-
-                    // The index and instance count must be non-zero, otherwise no-op
-                    if (draw->indexCount != 0 && draw->instanceCount != 0) {
-                        // MTLFeatureSet_iOS_GPUFamily3_v1 does not support baseInstance and
-                        // baseVertex.
-                        if (draw->baseVertex == 0 && draw->firstInstance == 0) {
-                            [encoder drawIndexedPrimitives:lastPipeline->GetMTLPrimitiveTopology()
-                                                indexCount:draw->indexCount
-                                                 indexType:MTLIndexFormat(indexFormat)
-                                               indexBuffer:indexBuffer
-                                         indexBufferOffset:indexBufferBaseOffset +
-                                                           draw->firstIndex * formatSize
-                                             instanceCount:draw->instanceCount];
-                        } else {
-                            [encoder drawIndexedPrimitives:lastPipeline->GetMTLPrimitiveTopology()
-                                                indexCount:draw->indexCount
-                                                 indexType:MTLIndexFormat(indexFormat)
-                                               indexBuffer:indexBuffer
-                                         indexBufferOffset:indexBufferBaseOffset +
-                                                           draw->firstIndex * formatSize
-                                             instanceCount:draw->instanceCount
-                                                baseVertex:draw->baseVertex
-                                              baseInstance:draw->firstInstance];
-                        }
-                    }
-                    break;
-                }
-
-                case Command::DrawIndirect: {
-                    DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-
-                    vertexBuffers.Apply(encoder, lastPipeline, enableVertexPulling);
-                    bindGroups.Apply(encoder);
-                    storageBufferLengths.Apply(encoder, lastPipeline, enableVertexPulling);
-
-                    Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
-                    id<MTLBuffer> indirectBuffer = buffer->GetMTLBuffer();
-                    [encoder drawPrimitives:lastPipeline->GetMTLPrimitiveTopology()
-                              indirectBuffer:indirectBuffer
-                        indirectBufferOffset:draw->indirectOffset];
-                    break;
-                }
-
-                case Command::DrawIndexedIndirect: {
-                    DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-
-                    vertexBuffers.Apply(encoder, lastPipeline, enableVertexPulling);
-                    bindGroups.Apply(encoder);
-                    storageBufferLengths.Apply(encoder, lastPipeline, enableVertexPulling);
-
-                    // If a index format was specified in setIndexBuffer always use it.
-                    wgpu::IndexFormat indexFormat = indexBufferFormat;
-                    if (indexFormat == wgpu::IndexFormat::Undefined) {
-                        // Otherwise use the pipeline's index format.
-                        // TODO(crbug.com/dawn/502): This path is deprecated.
-                        indexFormat = lastPipeline->GetVertexStateDescriptor()->indexFormat;
-                    }
-
-                    Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
-                    id<MTLBuffer> indirectBuffer = buffer->GetMTLBuffer();
-                    [encoder drawIndexedPrimitives:lastPipeline->GetMTLPrimitiveTopology()
-                                         indexType:MTLIndexFormat(indexFormat)
-                                       indexBuffer:indexBuffer
-                                 indexBufferOffset:indexBufferBaseOffset
-                                    indirectBuffer:indirectBuffer
-                              indirectBufferOffset:draw->indirectOffset];
-                    break;
-                }
-
-                case Command::InsertDebugMarker: {
-                    InsertDebugMarkerCmd* cmd = iter->NextCommand<InsertDebugMarkerCmd>();
-                    char* label = iter->NextData<char>(cmd->length + 1);
-                    NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
-
-                    [encoder insertDebugSignpost:mtlLabel];
-                    [mtlLabel release];
-                    break;
-                }
-
-                case Command::PopDebugGroup: {
-                    iter->NextCommand<PopDebugGroupCmd>();
-
-                    [encoder popDebugGroup];
-                    break;
-                }
-
-                case Command::PushDebugGroup: {
-                    PushDebugGroupCmd* cmd = iter->NextCommand<PushDebugGroupCmd>();
-                    char* label = iter->NextData<char>(cmd->length + 1);
-                    NSString* mtlLabel = [[NSString alloc] initWithUTF8String:label];
-
-                    [encoder pushDebugGroup:mtlLabel];
-                    [mtlLabel release];
-                    break;
-                }
-
-                case Command::SetRenderPipeline: {
-                    SetRenderPipelineCmd* cmd = iter->NextCommand<SetRenderPipelineCmd>();
-                    RenderPipeline* newPipeline = ToBackend(cmd->pipeline).Get();
-
-                    vertexBuffers.OnSetPipeline(lastPipeline, newPipeline);
-                    bindGroups.OnSetPipeline(newPipeline);
-
-                    [encoder setDepthStencilState:newPipeline->GetMTLDepthStencilState()];
-                    [encoder setFrontFacingWinding:newPipeline->GetMTLFrontFace()];
-                    [encoder setCullMode:newPipeline->GetMTLCullMode()];
-                    [encoder setDepthBias:newPipeline->GetDepthBias()
-                               slopeScale:newPipeline->GetDepthBiasSlopeScale()
-                                    clamp:newPipeline->GetDepthBiasClamp()];
-                    newPipeline->Encode(encoder);
-
-                    lastPipeline = newPipeline;
-                    break;
-                }
-
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
-
-                    bindGroups.OnSetBindGroup(cmd->index, ToBackend(cmd->group.Get()),
-                                              cmd->dynamicOffsetCount, dynamicOffsets);
-                    break;
-                }
-
-                case Command::SetIndexBuffer: {
-                    SetIndexBufferCmd* cmd = iter->NextCommand<SetIndexBufferCmd>();
-                    auto b = ToBackend(cmd->buffer.Get());
-                    indexBuffer = b->GetMTLBuffer();
-                    indexBufferBaseOffset = cmd->offset;
-                    // TODO(crbug.com/dawn/502): Once setIndexBuffer is required to specify an
-                    // index buffer format store as an MTLIndexType.
-                    indexBufferFormat = cmd->format;
-                    break;
-                }
-
-                case Command::SetVertexBuffer: {
-                    SetVertexBufferCmd* cmd = iter->NextCommand<SetVertexBufferCmd>();
-
-                    vertexBuffers.OnSetVertexBuffer(cmd->slot, ToBackend(cmd->buffer.Get()),
-                                                    cmd->offset);
-                    break;
-                }
-
-                default:
-                    UNREACHABLE();
-                    break;
-            }
-        };
+        RenderPassEncoder passEncoder(commandContext->BeginRender(mtlRenderPass),
+                                      enableVertexPulling);
 
         Command type;
         while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndRenderPass: {
-                    mCommands.NextCommand<EndRenderPassCmd>();
-                    commandContext->EndRender();
-                    return {};
-                }
-
-                case Command::SetStencilReference: {
-                    SetStencilReferenceCmd* cmd = mCommands.NextCommand<SetStencilReferenceCmd>();
-                    [encoder setStencilReferenceValue:cmd->reference];
-                    break;
-                }
-
-                case Command::SetViewport: {
-                    SetViewportCmd* cmd = mCommands.NextCommand<SetViewportCmd>();
-                    MTLViewport viewport;
-                    viewport.originX = cmd->x;
-                    viewport.originY = cmd->y;
-                    viewport.width = cmd->width;
-                    viewport.height = cmd->height;
-                    viewport.znear = cmd->minDepth;
-                    viewport.zfar = cmd->maxDepth;
-
-                    [encoder setViewport:viewport];
-                    break;
-                }
-
-                case Command::SetScissorRect: {
-                    SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
-                    MTLScissorRect rect;
-                    rect.x = cmd->x;
-                    rect.y = cmd->y;
-                    rect.width = cmd->width;
-                    rect.height = cmd->height;
-
-                    [encoder setScissorRect:rect];
-                    break;
-                }
-
-                case Command::SetBlendColor: {
-                    SetBlendColorCmd* cmd = mCommands.NextCommand<SetBlendColorCmd>();
-                    [encoder setBlendColorRed:cmd->color.r
-                                        green:cmd->color.g
-                                         blue:cmd->color.b
-                                        alpha:cmd->color.a];
-                    break;
-                }
-
-                case Command::ExecuteBundles: {
-                    ExecuteBundlesCmd* cmd = mCommands.NextCommand<ExecuteBundlesCmd>();
-                    auto bundles = mCommands.NextData<Ref<RenderBundleBase>>(cmd->count);
-
-                    for (uint32_t i = 0; i < cmd->count; ++i) {
-                        CommandIterator* iter = bundles[i]->GetCommands();
-                        iter->Reset();
-                        while (iter->NextCommandId(&type)) {
-                            EncodeRenderBundleCommand(iter, type);
-                        }
-                    }
-                    break;
-                }
-
-                case Command::WriteTimestamp: {
-                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
-                    QuerySet* querySet = ToBackend(cmd->querySet.Get());
-
-                    if (@available(macos 10.15, iOS 14.0, *)) {
-                        [encoder sampleCountersInBuffer:querySet->GetCounterSampleBuffer()
-                                          atSampleIndex:NSUInteger(cmd->queryIndex)
-                                            withBarrier:YES];
-                    } else {
-                        UNREACHABLE();
-                    }
-                    break;
-                }
-
-                default: {
-                    EncodeRenderBundleCommand(&mCommands, type);
-                    break;
-                }
+            if (type == Command::EndRenderPass) {
+                mCommands.NextCommand<EndRenderPassCmd>();
+                commandContext->EndRender();
+                return {};
             }
+            VisitCommand(&mCommands, type, passEncoder);
         }
 
         // EndRenderPass should have been called
@@ -22,6 +22,8 @@
 
 #include <spirv_cross.hpp>
 
+#include <algorithm>
+
 namespace dawn_native { namespace null {
 
     // Implementation of pre-Device objects: the null adapter, null backend connection and Connect()
@@ -68,6 +70,10 @@ namespace dawn_native { namespace null {
             destination->CopyFromStaging(staging, sourceOffset, destinationOffset, size);
         }
 
+        uint64_t GetTransferSize() const override {
+            return size;
+        }
+
         StagingBufferBase* staging;
         Ref<Buffer> destination;
         uint64_t sourceOffset;
@@ -75,6 +81,104 @@ namespace dawn_native { namespace null {
         uint64_t size;
     };
 
+    // AsyncTimeline
+
+    AsyncTimeline::AsyncTimeline() : mThread([this]() { ThreadMain(); }) {
+    }
+
+    AsyncTimeline::~AsyncTimeline() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mIsStopping = true;
+        }
+        mCondition.notify_all();
+        mThread.join();
+    }
+
+    void AsyncTimeline::SetOptions(const AsyncTimelineOptions& options) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOptions = options;
+    }
+
+    void AsyncTimeline::Submit(ExecutionSerial serial,
+                               std::vector<std::unique_ptr<PendingOperation>> operations) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            // Everything submitted before is complete when the timeline is idle, including the
+            // serials that the device moved forward by itself.
+            if (mSubmits.empty() && !mIsExecuting) {
+                mCompletedSerial = serial - ExecutionSerial(1);
+            }
+            Clock::time_point startTime =
+                Clock::now() + std::chrono::microseconds(mOptions.latencyMicroseconds);
+            mSubmits.push_back({serial, startTime, std::move(operations)});
+        }
+        mCondition.notify_all();
+    }
+
+    ExecutionSerial AsyncTimeline::CheckCompletedSerial(
+        ExecutionSerial lastSubmittedSerial,
+        std::vector<std::unique_ptr<PendingOperation>>* executedOperations) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (std::unique_ptr<PendingOperation>& operation : mExecutedOperations) {
+            executedOperations->push_back(std::move(operation));
+        }
+        mExecutedOperations.clear();
+
+        // The device moves its serials forward by itself when it has no work in flight, so the
+        // serial of the last executed submit can be behind the completed serial of the device.
+        if (mSubmits.empty() && !mIsExecuting) {
+            return lastSubmittedSerial;
+        }
+        return mCompletedSerial;
+    }
+
+    void AsyncTimeline::WaitForIdle() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this]() { return mSubmits.empty() && !mIsExecuting; });
+    }
+
+    void AsyncTimeline::ThreadMain() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mCondition.wait(lock, [this]() { return mIsStopping || !mSubmits.empty(); });
+            if (mIsStopping) {
+                return;
+            }
+
+            // Wait for the latency of the submit to elapse. Submits are started in order so the
+            // next ones can't start before.
+            Clock::time_point startTime = mSubmits.front().startTime;
+            if (mCondition.wait_until(lock, startTime, [this]() { return mIsStopping; })) {
+                return;
+            }
+
+            SubmitInFlight submit = std::move(mSubmits.front());
+            mSubmits.pop_front();
+            mIsExecuting = true;
+            uint64_t bytesPerSecond = mOptions.bytesPerSecond;
+            lock.unlock();
+
+            uint64_t transferSize = 0;
+            for (std::unique_ptr<PendingOperation>& operation : submit.operations) {
+                operation->Execute();
+                transferSize += operation->GetTransferSize();
+            }
+            if (bytesPerSecond != 0) {
+                std::this_thread::sleep_for(
+                    std::chrono::microseconds(transferSize * 1000000 / bytesPerSecond));
+            }
+
+            lock.lock();
+            for (std::unique_ptr<PendingOperation>& operation : submit.operations) {
+                mExecutedOperations.push_back(std::move(operation));
+            }
+            mCompletedSerial = submit.serial;
+            mIsExecuting = false;
+            mCondition.notify_all();
+        }
+    }
+
     // Device
 
     // static
@@ -89,7 +193,9 @@ namespace dawn_native { namespace null {
     }
 
     MaybeError Device::Initialize() {
-        return DeviceBase::Initialize(new Queue(this));
+        Queue* defaultQueue = new Queue(this, QueueType::General);
+        mQueues.push_back(defaultQueue);
+        return DeviceBase::Initialize(defaultQueue);
     }
 
     ResultOrError<BindGroupBase*> Device::CreateBindGroupImpl(
@@ -150,6 +256,11 @@ namespace dawn_native { namespace null {
         const TextureViewDescriptor* descriptor) {
         return new TextureView(texture, descriptor);
     }
+    ResultOrError<QueueBase*> Device::CreateAdditionalQueueImpl(QueueType type) {
+        Queue* queue = new Queue(this, type);
+        mQueues.push_back(queue);
+        return queue;
+    }
 
     ResultOrError<std::unique_ptr<StagingBufferBase>> Device::CreateStagingBuffer(size_t size) {
         std::unique_ptr<StagingBufferBase> stagingBuffer =
@@ -163,12 +274,17 @@ namespace dawn_native { namespace null {
 
         // Clear pending operations before checking mMemoryUsage because some operations keep a
         // reference to Buffers.
-        mPendingOperations.clear();
+        for (Queue* queue : mQueues) {
+            queue->ShutDown();
+        }
         ASSERT(mMemoryUsage == 0);
     }
 
     MaybeError Device::WaitForIdleForDestruction() {
-        mPendingOperations.clear();
+        for (Queue* queue : mQueues) {
+            queue->WaitForIdle();
+        }
+        CheckPassedSerials();
         return {};
     }
 
@@ -215,25 +331,53 @@ namespace dawn_native { namespace null {
     }
 
     MaybeError Device::TickImpl() {
-        SubmitPendingOperations();
+        // Submitting nothing on the asynchronous timeline would keep the device busy forever.
+        for (Queue* queue : mQueues) {
+            if (queue->HasPendingOperations()) {
+                SubmitPendingOperations(queue);
+            }
+        }
         return {};
     }
 
     ExecutionSerial Device::CheckAndUpdateCompletedSerials() {
-        return GetLastSubmittedCommandSerial();
+        // A serial is complete once every queue is done with it.
+        ExecutionSerial completedSerial = GetLastSubmittedCommandSerial();
+        for (Queue* queue : mQueues) {
+            completedSerial = std::min(
+                completedSerial, queue->CheckCompletedSerial(GetLastSubmittedCommandSerial()));
+        }
+        return completedSerial;
     }
 
     void Device::AddPendingOperation(std::unique_ptr<PendingOperation> operation) {
-        mPendingOperations.emplace_back(std::move(operation));
+        Queue* queue = mRecordingQueue != nullptr ? mRecordingQueue : mQueues[0];
+        queue->AddPendingOperation(std::move(operation));
     }
-    void Device::SubmitPendingOperations() {
-        for (auto& operation : mPendingOperations) {
-            operation->Execute();
-        }
-        mPendingOperations.clear();
 
+    void Device::SubmitPendingOperations(Queue* queue) {
         CheckPassedSerials();
         IncrementLastSubmittedCommandSerial();
+        queue->SubmitPendingOperations(GetLastSubmittedCommandSerial());
+    }
+
+    void Device::SetRecordingQueue(Queue* queue) {
+        mRecordingQueue = queue;
+    }
+
+    bool Device::UsesAsyncTimeline() const {
+        return IsToggleEnabled(Toggle::NullUseAsyncTimeline);
+    }
+
+    const AsyncTimelineOptions& Device::GetAsyncTimelineOptions() const {
+        return mAsyncTimelineOptions;
+    }
+
+    void Device::SetAsyncTimelineOptions(const AsyncTimelineOptions& options) {
+        mAsyncTimelineOptions = options;
+        for (Queue* queue : mQueues) {
+            queue->SetAsyncTimelineOptions(options);
+        }
     }
 
     // BindGroupDataHolder
@@ -326,21 +470,105 @@ namespace dawn_native { namespace null {
 
     // Queue
 
-    Queue::Queue(Device* device) : QueueBase(device) {
+    Queue::Queue(Device* device, QueueType type) : QueueBase(device, type) {
+        if (device->UsesAsyncTimeline()) {
+            mAsyncTimeline = std::make_unique<AsyncTimeline>();
+            mAsyncTimeline->SetOptions(device->GetAsyncTimelineOptions());
+        }
     }
 
     Queue::~Queue() {
+        ASSERT(mPendingOperations.empty());
+        ASSERT(mAsyncTimeline == nullptr);
     }
 
     MaybeError Queue::SubmitImpl(uint32_t, CommandBufferBase* const*) {
-        ToBackend(GetDevice())->SubmitPendingOperations();
+        ToBackend(GetDevice())->SubmitPendingOperations(this);
         return {};
     }
 
+    void Queue::AddPendingOperation(std::unique_ptr<PendingOperation> operation) {
+        if (mPendingOperations.empty()) {
+            mPendingOperationsSerial = GetDevice()->GetPendingCommandSerial();
+        }
+        mPendingOperations.emplace_back(std::move(operation));
+    }
+
+    bool Queue::HasPendingOperations() const {
+        return !mPendingOperations.empty();
+    }
+
+    void Queue::SubmitPendingOperations(ExecutionSerial serial) {
+        if (mAsyncTimeline != nullptr) {
+            mAsyncTimeline->Submit(serial, std::move(mPendingOperations));
+            mPendingOperations.clear();
+            return;
+        }
+
+        for (auto& operation : mPendingOperations) {
+            operation->Execute();
+        }
+        mPendingOperations.clear();
+    }
+
+    ExecutionSerial Queue::CheckCompletedSerial(ExecutionSerial lastSubmittedSerial) {
+        ExecutionSerial completedSerial = lastSubmittedSerial;
+        if (mAsyncTimeline != nullptr) {
+            // Destroy the executed operations here so that their references are released on the
+            // device's thread.
+            std::vector<std::unique_ptr<PendingOperation>> executedOperations;
+            completedSerial =
+                mAsyncTimeline->CheckCompletedSerial(lastSubmittedSerial, &executedOperations);
+        }
+        if (!mPendingOperations.empty()) {
+            completedSerial =
+                std::min(completedSerial, mPendingOperationsSerial - ExecutionSerial(1));
+        }
+
+        // When all the work of the queue is done, the fences signaled since the last submit
+        // (tracked at the pending serial) are complete too, even if other queues are still busy.
+        mCompletedSerial = completedSerial;
+        if (completedSerial == lastSubmittedSerial && mPendingOperations.empty()) {
+            mCompletedSerial = lastSubmittedSerial + ExecutionSerial(1);
+        }
+        return completedSerial;
+    }
+
+    ExecutionSerial Queue::GetCompletedSerial() const {
+        return std::max(mCompletedSerial, GetDevice()->GetCompletedCommandSerial());
+    }
+
+    void Queue::SetAsyncTimelineOptions(const AsyncTimelineOptions& options) {
+        if (mAsyncTimeline != nullptr) {
+            mAsyncTimeline->SetOptions(options);
+        }
+    }
+
+    void Queue::WaitForIdle() {
+        mPendingOperations.clear();
+        if (mAsyncTimeline != nullptr) {
+            mAsyncTimeline->WaitForIdle();
+        }
+    }
+
+    void Queue::ShutDown() {
+        mPendingOperations.clear();
+        mAsyncTimeline = nullptr;
+    }
+
     MaybeError Queue::WriteBufferImpl(BufferBase* buffer,
                                       uint64_t bufferOffset,
                                       const void* data,
                                       size_t size) {
+        // Writing the buffer right away could race with the operations in flight on the
+        // asynchronous timeline so the write goes through a staging buffer instead.
+        Device* device = ToBackend(GetDevice());
+        if (device->UsesAsyncTimeline()) {
+            device->SetRecordingQueue(this);
+            MaybeError result = QueueBase::WriteBufferImpl(buffer, bufferOffset, data, size);
+            device->SetRecordingQueue(nullptr);
+            return result;
+        }
         ToBackend(buffer)->DoWriteBuffer(bufferOffset, data, size);
         return {};
     }
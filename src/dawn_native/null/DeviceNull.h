@@ -36,6 +36,14 @@
 #include "dawn_native/ToBackend.h"
 #include "dawn_native/dawn_platform.h"
 
+#include "dawn_native/NullBackend.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 namespace dawn_native { namespace null {
 
     class Adapter;
@@ -82,6 +90,58 @@ namespace dawn_native { namespace null {
     struct PendingOperation {
         virtual ~PendingOperation() = default;
         virtual void Execute() = 0;
+
+        // The number of bytes the operation moves, to simulate the bandwidth of the timeline.
+        virtual uint64_t GetTransferSize() const {
+            return 0;
+        }
+    };
+
+    // Executes the operations of the submits on a separate thread, like a GPU would, for the
+    // devices created with the null_use_async_timeline toggle. The operations are given back to
+    // the device once executed so that the objects they reference are released on the device's
+    // thread.
+    class AsyncTimeline {
+      public:
+        AsyncTimeline();
+        // Stops the thread. The submits that haven't executed yet are dropped.
+        ~AsyncTimeline();
+
+        void SetOptions(const AsyncTimelineOptions& options);
+
+        void Submit(ExecutionSerial serial,
+                    std::vector<std::unique_ptr<PendingOperation>> operations);
+
+        // Returns the serial of the last executed submit, or |lastSubmittedSerial| when all the
+        // submits are executed. The executed operations are moved to |executedOperations|.
+        ExecutionSerial CheckCompletedSerial(
+            ExecutionSerial lastSubmittedSerial,
+            std::vector<std::unique_ptr<PendingOperation>>* executedOperations);
+
+        void WaitForIdle();
+
+      private:
+        using Clock = std::chrono::steady_clock;
+
+        struct SubmitInFlight {
+            ExecutionSerial serial;
+            Clock::time_point startTime;
+            std::vector<std::unique_ptr<PendingOperation>> operations;
+        };
+
+        void ThreadMain();
+
+        std::mutex mMutex;
+        // Signaled when a submit is added, when one is executed and when the thread must stop.
+        std::condition_variable mCondition;
+        AsyncTimelineOptions mOptions;
+        std::deque<SubmitInFlight> mSubmits;
+        bool mIsExecuting = false;
+        bool mIsStopping = false;
+        ExecutionSerial mCompletedSerial = ExecutionSerial(0);
+        std::vector<std::unique_ptr<PendingOperation>> mExecutedOperations;
+
+        std::thread mThread;
     };
 
     class Device : public DeviceBase {
@@ -96,8 +156,14 @@ namespace dawn_native { namespace null {
 
         MaybeError TickImpl() override;
 
+        // Adds the operation to the queue recording operations, or to the default queue.
         void AddPendingOperation(std::unique_ptr<PendingOperation> operation);
-        void SubmitPendingOperations();
+        void SubmitPendingOperations(Queue* queue);
+        void SetRecordingQueue(Queue* queue);
+
+        bool UsesAsyncTimeline() const;
+        const AsyncTimelineOptions& GetAsyncTimelineOptions() const;
+        void SetAsyncTimelineOptions(const AsyncTimelineOptions& options);
 
         ResultOrError<std::unique_ptr<StagingBufferBase>> CreateStagingBuffer(size_t size) override;
         MaybeError CopyFromStagingToBuffer(StagingBufferBase* source,
@@ -147,13 +213,17 @@ namespace dawn_native { namespace null {
         ResultOrError<TextureViewBase*> CreateTextureViewImpl(
             TextureBase* texture,
             const TextureViewDescriptor* descriptor) override;
+        ResultOrError<QueueBase*> CreateAdditionalQueueImpl(QueueType type) override;
 
         ExecutionSerial CheckAndUpdateCompletedSerials() override;
 
         void ShutDownImpl() override;
         MaybeError WaitForIdleForDestruction() override;
 
-        std::vector<std::unique_ptr<PendingOperation>> mPendingOperations;
+        // The default queue followed by the additional queues. DeviceBase keeps them alive.
+        std::vector<Queue*> mQueues;
+        Queue* mRecordingQueue = nullptr;
+        AsyncTimelineOptions mAsyncTimelineOptions;
 
         static constexpr uint64_t kMaxMemoryUsage = 256 * 1024 * 1024;
         size_t mMemoryUsage = 0;
@@ -229,9 +299,27 @@ namespace dawn_native { namespace null {
         void DestroyImpl() override;
     };
 
+    // Each queue has its own pending operations and, with the null_use_async_timeline toggle,
+    // its own timeline so that the submits of different queues execute concurrently.
     class Queue final : public QueueBase {
       public:
-        Queue(Device* device);
+        Queue(Device* device, QueueType type);
+
+        void AddPendingOperation(std::unique_ptr<PendingOperation> operation);
+        bool HasPendingOperations() const;
+        // Executes the pending operations, or hands them to the timeline, as the submit |serial|.
+        void SubmitPendingOperations(ExecutionSerial serial);
+
+        // Returns the serial up to which the submits of this queue are complete.
+        ExecutionSerial CheckCompletedSerial(ExecutionSerial lastSubmittedSerial);
+        ExecutionSerial GetCompletedSerial() const override;
+
+        void SetAsyncTimelineOptions(const AsyncTimelineOptions& options);
+        // Drops the operations that weren't submitted and waits for the submitted ones.
+        void WaitForIdle();
+        // Destroys the operations and the timeline while the device can still handle the release
+        // of the objects they reference.
+        void ShutDown();
 
       private:
         ~Queue() override;
@@ -240,6 +328,13 @@ namespace dawn_native { namespace null {
                                    uint64_t bufferOffset,
                                    const void* data,
                                    size_t size) override;
+
+        std::vector<std::unique_ptr<PendingOperation>> mPendingOperations;
+        // The pending serial when the first of |mPendingOperations| was added. The operations
+        // stay incomplete until they are submitted even when other queues advance the serials.
+        ExecutionSerial mPendingOperationsSerial = ExecutionSerial(0);
+        std::unique_ptr<AsyncTimeline> mAsyncTimeline;
+        ExecutionSerial mCompletedSerial = ExecutionSerial(0);
     };
 
     class ShaderModule final : public ShaderModuleBase {
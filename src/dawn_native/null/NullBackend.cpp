@@ -29,4 +29,8 @@ namespace dawn_native { namespace null {
         return impl;
     }
 
+    void SetAsyncTimelineOptions(WGPUDevice device, const AsyncTimelineOptions& options) {
+        reinterpret_cast<Device*>(device)->SetAsyncTimelineOptions(options);
+    }
+
 }}  // namespace dawn_native::null
@@ -430,399 +430,588 @@ namespace dawn_native { namespace opengl {
             return validTextureCopyExtent;
         }
 
-    }  // namespace
-
-    CommandBuffer::CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor)
-        : CommandBufferBase(encoder, descriptor) {
-    }
-
-    MaybeError CommandBuffer::Execute() {
-        const OpenGLFunctions& gl = ToBackend(GetDevice())->gl;
-
-        auto TransitionForPass = [](const PassResourceUsage& usages) {
+        void TransitionForPass(const PassResourceUsage& usages) {
             for (size_t i = 0; i < usages.textures.size(); i++) {
                 Texture* texture = ToBackend(usages.textures[i]);
-                // Clear textures that are not output attachments. Output attachments will be
-                // cleared in BeginRenderPass by setting the loadop to clear when the
-                // texture subresource has not been initialized before the render pass.
-                if (!(usages.textureUsages[i].usage & wgpu::TextureUsage::OutputAttachment)) {
-                    texture->EnsureSubresourceContentInitialized(texture->GetAllSubresources());
+                // Clear the subresources used in the pass that are not output attachments. Output
+                // attachments will be cleared in BeginRenderPass by setting the loadop to clear
+                // when the texture subresource has not been initialized before the render pass.
+                for (const SubresourceRange& range : usages.textureUsages[i].lazyClearRanges) {
+                    texture->EnsureSubresourceContentInitialized(range);
                 }
             }
 
             for (BufferBase* bufferBase : usages.buffers) {
                 ToBackend(bufferBase)->EnsureDataInitialized();
             }
+        }
+
+        // Executes the commands of a compute pass other than EndComputePass.
+        class ComputePassExecutor {
+          public:
+            explicit ComputePassExecutor(const OpenGLFunctions& gl) : mGL(gl) {
+            }
+
+            template <typename T, typename D>
+            MaybeError operator()(T*, D*) {
+                UNREACHABLE();
+                return {};
+            }
+
+            MaybeError operator()(DispatchCmd* dispatch, CommandData<DispatchCmd>::Type*) {
+                mBindGroupTracker.Apply(mGL);
+
+                mGL.DispatchCompute(dispatch->x, dispatch->y, dispatch->z);
+                // TODO(cwallez@chromium.org): add barriers to the API
+                mGL.MemoryBarrier(GL_ALL_BARRIER_BITS);
+                return {};
+            }
+
+            MaybeError operator()(DispatchIndirectCmd* dispatch,
+                                  CommandData<DispatchIndirectCmd>::Type*) {
+                mBindGroupTracker.Apply(mGL);
+
+                uint64_t indirectBufferOffset = dispatch->indirectOffset;
+                Buffer* indirectBuffer = ToBackend(dispatch->indirectBuffer.Get());
+
+                mGL.BindBuffer(GL_DISPATCH_INDIRECT_BUFFER, indirectBuffer->GetHandle());
+                mGL.DispatchComputeIndirect(static_cast<GLintptr>(indirectBufferOffset));
+                // TODO(cwallez@chromium.org): add barriers to the API
+                mGL.MemoryBarrier(GL_ALL_BARRIER_BITS);
+                return {};
+            }
+
+            MaybeError operator()(SetComputePipelineCmd* cmd,
+                                  CommandData<SetComputePipelineCmd>::Type*) {
+                ComputePipeline* pipeline = ToBackend(cmd->pipeline).Get();
+                pipeline->ApplyNow();
+
+                mBindGroupTracker.OnSetPipeline(pipeline);
+                return {};
+            }
+
+            MaybeError operator()(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                mBindGroupTracker.OnSetBindGroup(
+                    cmd->index, cmd->group.Get(), cmd->dynamicOffsetCount,
+                    cmd->dynamicOffsetCount > 0 ? dynamicOffsets : nullptr);
+                return {};
+            }
+
+            // Due to lack of linux driver support for GL_EXT_debug_marker
+            // extension these functions are skipped.
+            MaybeError operator()(InsertDebugMarkerCmd*, char*) {
+                return {};
+            }
+
+            MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                return {};
+            }
+
+            MaybeError operator()(PushDebugGroupCmd*, char*) {
+                return {};
+            }
+
+            MaybeError operator()(WriteTimestampCmd*, CommandData<WriteTimestampCmd>::Type*) {
+                return DAWN_UNIMPLEMENTED_ERROR("WriteTimestamp unimplemented");
+            }
+
+          private:
+            const OpenGLFunctions& mGL;
+            BindGroupTracker mBindGroupTracker = {};
         };
 
-        const std::vector<PassResourceUsage>& passResourceUsages = GetResourceUsages().perPass;
-        uint32_t nextPassNumber = 0;
+        // Executes the commands of a render pass other than EndRenderPass, and the commands of
+        // the bundles it executes.
+        class RenderPassExecutor {
+          public:
+            RenderPassExecutor(const OpenGLFunctions& gl,
+                               PersistentPipelineState* persistentPipelineState)
+                : mGL(gl), mPersistentPipelineState(persistentPipelineState) {
+            }
 
-        Command type;
-        while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::BeginComputePass: {
-                    mCommands.NextCommand<BeginComputePassCmd>();
-                    TransitionForPass(passResourceUsages[nextPassNumber]);
-                    DAWN_TRY(ExecuteComputePass());
+            template <typename T, typename D>
+            MaybeError operator()(T*, D*) {
+                UNREACHABLE();
+                return {};
+            }
 
-                    nextPassNumber++;
-                    break;
-                }
+            MaybeError operator()(DrawCmd* draw, CommandData<DrawCmd>::Type*) {
+                mVertexStateBufferBindingTracker.Apply(mGL);
+                mBindGroupTracker.Apply(mGL);
 
-                case Command::BeginRenderPass: {
-                    auto* cmd = mCommands.NextCommand<BeginRenderPassCmd>();
-                    TransitionForPass(passResourceUsages[nextPassNumber]);
+                DoDraw(draw);
+                return {};
+            }
 
-                    LazyClearRenderPassAttachments(cmd);
-                    DAWN_TRY(ExecuteRenderPass(cmd));
+            MaybeError operator()(DrawIndexedCmd* draw, CommandData<DrawIndexedCmd>::Type*) {
+                mVertexStateBufferBindingTracker.Apply(mGL);
+                mBindGroupTracker.Apply(mGL);
 
-                    nextPassNumber++;
-                    break;
-                }
+                DoDrawIndexed(draw, GetIndexFormat());
+                return {};
+            }
 
-                case Command::CopyBufferToBuffer: {
-                    CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
+            MaybeError operator()(MultiDrawCmd* cmd, DrawCmd* draws) {
+                mVertexStateBufferBindingTracker.Apply(mGL);
+                mBindGroupTracker.Apply(mGL);
 
-                    ToBackend(copy->source)->EnsureDataInitialized();
-                    ToBackend(copy->destination)
-                        ->EnsureDataInitializedAsDestination(copy->destinationOffset, copy->size);
+                for (uint32_t i = 0; i < cmd->drawCount; ++i) {
+                    DoDraw(&draws[i]);
+                }
+                return {};
+            }
 
-                    gl.BindBuffer(GL_PIXEL_PACK_BUFFER, ToBackend(copy->source)->GetHandle());
-                    gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER,
-                                  ToBackend(copy->destination)->GetHandle());
-                    gl.CopyBufferSubData(GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER,
-                                         copy->sourceOffset, copy->destinationOffset, copy->size);
+            MaybeError operator()(MultiDrawIndexedCmd* cmd, DrawIndexedCmd* draws) {
+                mVertexStateBufferBindingTracker.Apply(mGL);
+                mBindGroupTracker.Apply(mGL);
 
-                    gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-                    gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-                    break;
+                wgpu::IndexFormat indexFormat = GetIndexFormat();
+                for (uint32_t i = 0; i < cmd->drawCount; ++i) {
+                    DoDrawIndexed(&draws[i], indexFormat);
                 }
+                return {};
+            }
 
-                case Command::CopyBufferToTexture: {
-                    CopyBufferToTextureCmd* copy = mCommands.NextCommand<CopyBufferToTextureCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
-                    auto& copySize = copy->copySize;
-                    Buffer* buffer = ToBackend(src.buffer.Get());
-                    Texture* texture = ToBackend(dst.texture.Get());
-                    GLenum target = texture->GetGLTarget();
-                    const GLFormat& format = texture->GetGLFormat();
-
-                    if (dst.aspect == Aspect::Stencil) {
-                        return DAWN_VALIDATION_ERROR(
-                            "Copies to stencil textures unsupported on OpenGL");
-                    }
-                    ASSERT(dst.aspect == Aspect::Color);
+            MaybeError operator()(DrawIndirectCmd* draw, CommandData<DrawIndirectCmd>::Type*) {
+                mVertexStateBufferBindingTracker.Apply(mGL);
+                mBindGroupTracker.Apply(mGL);
 
-                    buffer->EnsureDataInitialized();
+                uint64_t indirectBufferOffset = draw->indirectOffset;
+                Buffer* indirectBuffer = ToBackend(draw->indirectBuffer.Get());
 
-                    ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
-                    SubresourceRange subresources =
-                        GetSubresourcesAffectedByCopy(dst, copy->copySize);
-                    if (IsCompleteSubresourceCopiedTo(texture, copySize, dst.mipLevel)) {
-                        texture->SetIsSubresourceContentInitialized(true, subresources);
-                    } else {
-                        texture->EnsureSubresourceContentInitialized(subresources);
-                    }
+                mGL.BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer->GetHandle());
+                mGL.DrawArraysIndirect(
+                    mLastPipeline->GetGLPrimitiveTopology(),
+                    reinterpret_cast<void*>(static_cast<intptr_t>(indirectBufferOffset)));
+                return {};
+            }
 
-                    gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->GetHandle());
-                    gl.ActiveTexture(GL_TEXTURE0);
-                    gl.BindTexture(target, texture->GetHandle());
-
-                    const Format& formatInfo = texture->GetFormat();
-                    const TexelBlockInfo& blockInfo = formatInfo.GetAspectInfo(dst.aspect).block;
-                    gl.PixelStorei(GL_UNPACK_ROW_LENGTH,
-                                   src.bytesPerRow / blockInfo.byteSize * blockInfo.width);
-                    gl.PixelStorei(GL_UNPACK_IMAGE_HEIGHT, src.rowsPerImage * blockInfo.height);
-
-                    if (formatInfo.isCompressed) {
-                        gl.PixelStorei(GL_UNPACK_COMPRESSED_BLOCK_SIZE, blockInfo.byteSize);
-                        gl.PixelStorei(GL_UNPACK_COMPRESSED_BLOCK_WIDTH, blockInfo.width);
-                        gl.PixelStorei(GL_UNPACK_COMPRESSED_BLOCK_HEIGHT, blockInfo.height);
-                        gl.PixelStorei(GL_UNPACK_COMPRESSED_BLOCK_DEPTH, 1);
-
-                        ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
-                        uint64_t copyDataSize = (copySize.width / blockInfo.width) *
-                                                (copySize.height / blockInfo.height) *
-                                                blockInfo.byteSize * copySize.depth;
-                        Extent3D copyExtent = ComputeTextureCopyExtent(dst, copySize);
-
-                        if (texture->GetArrayLayers() > 1) {
-                            gl.CompressedTexSubImage3D(
-                                target, dst.mipLevel, dst.origin.x, dst.origin.y, dst.origin.z,
-                                copyExtent.width, copyExtent.height, copyExtent.depth,
-                                format.internalFormat, copyDataSize,
-                                reinterpret_cast<void*>(static_cast<uintptr_t>(src.offset)));
-                        } else {
-                            gl.CompressedTexSubImage2D(
-                                target, dst.mipLevel, dst.origin.x, dst.origin.y, copyExtent.width,
-                                copyExtent.height, format.internalFormat, copyDataSize,
-                                reinterpret_cast<void*>(static_cast<uintptr_t>(src.offset)));
-                        }
-                    } else {
-                        switch (texture->GetDimension()) {
-                            case wgpu::TextureDimension::e2D:
-                                if (texture->GetArrayLayers() > 1) {
-                                    gl.TexSubImage3D(target, dst.mipLevel, dst.origin.x,
-                                                     dst.origin.y, dst.origin.z, copySize.width,
-                                                     copySize.height, copySize.depth, format.format,
-                                                     format.type,
-                                                     reinterpret_cast<void*>(
-                                                         static_cast<uintptr_t>(src.offset)));
-                                } else {
-                                    gl.TexSubImage2D(target, dst.mipLevel, dst.origin.x,
-                                                     dst.origin.y, copySize.width, copySize.height,
-                                                     format.format, format.type,
-                                                     reinterpret_cast<void*>(
-                                                         static_cast<uintptr_t>(src.offset)));
-                                }
-                                break;
+            MaybeError operator()(DrawIndexedIndirectCmd* draw,
+                                  CommandData<DrawIndexedIndirectCmd>::Type*) {
+                mVertexStateBufferBindingTracker.Apply(mGL);
+                mBindGroupTracker.Apply(mGL);
 
-                            case wgpu::TextureDimension::e1D:
-                            case wgpu::TextureDimension::e3D:
-                                UNREACHABLE();
-                        }
-                    }
+                uint64_t indirectBufferOffset = draw->indirectOffset;
+                Buffer* indirectBuffer = ToBackend(draw->indirectBuffer.Get());
 
-                    gl.PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-                    gl.PixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+                wgpu::IndexFormat indexFormat = GetIndexFormat();
 
-                    gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-                    break;
-                }
+                mGL.BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer->GetHandle());
+                mGL.DrawElementsIndirect(
+                    mLastPipeline->GetGLPrimitiveTopology(), IndexFormatType(indexFormat),
+                    reinterpret_cast<void*>(static_cast<intptr_t>(indirectBufferOffset)));
+                return {};
+            }
 
-                case Command::CopyTextureToBuffer: {
-                    CopyTextureToBufferCmd* copy = mCommands.NextCommand<CopyTextureToBufferCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
-                    auto& copySize = copy->copySize;
-                    Texture* texture = ToBackend(src.texture.Get());
-                    Buffer* buffer = ToBackend(dst.buffer.Get());
-                    const Format& formatInfo = texture->GetFormat();
-                    const GLFormat& format = texture->GetGLFormat();
-                    GLenum target = texture->GetGLTarget();
-
-                    // TODO(jiawei.shao@intel.com): support texture-to-buffer copy with compressed
-                    // texture formats.
-                    if (formatInfo.isCompressed) {
-                        UNREACHABLE();
-                    }
+            // Due to lack of linux driver support for GL_EXT_debug_marker
+            // extension these functions are skipped.
+            MaybeError operator()(InsertDebugMarkerCmd*, char*) {
+                return {};
+            }
 
-                    buffer->EnsureDataInitializedAsDestination(copy);
-
-                    ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
-                    SubresourceRange subresources =
-                        GetSubresourcesAffectedByCopy(src, copy->copySize);
-                    texture->EnsureSubresourceContentInitialized(subresources);
-                    // The only way to move data from a texture to a buffer in GL is via
-                    // glReadPixels with a pack buffer. Create a temporary FBO for the copy.
-                    gl.BindTexture(target, texture->GetHandle());
-
-                    GLuint readFBO = 0;
-                    gl.GenFramebuffers(1, &readFBO);
-                    gl.BindFramebuffer(GL_READ_FRAMEBUFFER, readFBO);
-
-                    const TexelBlockInfo& blockInfo = formatInfo.GetAspectInfo(src.aspect).block;
-
-                    gl.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->GetHandle());
-                    gl.PixelStorei(GL_PACK_IMAGE_HEIGHT, dst.rowsPerImage * blockInfo.height);
-                    gl.PixelStorei(GL_PACK_ROW_LENGTH, dst.bytesPerRow / blockInfo.byteSize);
-
-                    GLenum glAttachment;
-                    GLenum glFormat;
-                    GLenum glType;
-                    switch (src.aspect) {
-                        case Aspect::Color:
-                            glAttachment = GL_COLOR_ATTACHMENT0;
-                            glFormat = format.format;
-                            glType = format.type;
-                            break;
-                        case Aspect::Depth:
-                            glAttachment = GL_DEPTH_ATTACHMENT;
-                            glFormat = GL_DEPTH_COMPONENT;
-                            glType = GL_FLOAT;
-                            break;
-                        case Aspect::Stencil:
-                            glAttachment = GL_STENCIL_ATTACHMENT;
-                            glFormat = GL_STENCIL_INDEX;
-                            glType = GL_UNSIGNED_BYTE;
-                            break;
+            MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                return {};
+            }
 
-                        case Aspect::None:
-                            UNREACHABLE();
-                    }
+            MaybeError operator()(PushDebugGroupCmd*, char*) {
+                return {};
+            }
 
-                    uint8_t* offset =
-                        reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(dst.offset));
-                    switch (texture->GetDimension()) {
-                        case wgpu::TextureDimension::e2D: {
-                            if (texture->GetArrayLayers() == 1) {
-                                gl.FramebufferTexture2D(GL_READ_FRAMEBUFFER, glAttachment, target,
-                                                        texture->GetHandle(), src.mipLevel);
-                                gl.ReadPixels(src.origin.x, src.origin.y, copySize.width,
-                                              copySize.height, glFormat, glType, offset);
-                                break;
-                            }
+            MaybeError operator()(SetRenderPipelineCmd* cmd,
+                                  CommandData<SetRenderPipelineCmd>::Type*) {
+                mLastPipeline = ToBackend(cmd->pipeline).Get();
+                mLastPipeline->ApplyNow(*mPersistentPipelineState);
 
-                            const uint64_t bytesPerImage = dst.bytesPerRow * dst.rowsPerImage;
-                            for (uint32_t layer = 0; layer < copySize.depth; ++layer) {
-                                gl.FramebufferTextureLayer(GL_READ_FRAMEBUFFER, glAttachment,
-                                                           texture->GetHandle(), src.mipLevel,
-                                                           src.origin.z + layer);
-                                gl.ReadPixels(src.origin.x, src.origin.y, copySize.width,
-                                              copySize.height, glFormat, glType, offset);
+                mVertexStateBufferBindingTracker.OnSetPipeline(mLastPipeline);
+                mBindGroupTracker.OnSetPipeline(mLastPipeline);
+                return {};
+            }
 
-                                offset += bytesPerImage;
-                            }
+            MaybeError operator()(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                mBindGroupTracker.OnSetBindGroup(
+                    cmd->index, cmd->group.Get(), cmd->dynamicOffsetCount,
+                    cmd->dynamicOffsetCount > 0 ? dynamicOffsets : nullptr);
+                return {};
+            }
 
-                            break;
-                        }
+            MaybeError operator()(SetIndexBufferCmd* cmd, CommandData<SetIndexBufferCmd>::Type*) {
+                // TODO(crbug.com/dawn/502): Once setIndexBuffer is required to specify an
+                // index buffer format store as an GLenum.
+                mIndexBufferFormat = cmd->format;
+                mIndexBufferBaseOffset = cmd->offset;
+                mVertexStateBufferBindingTracker.OnSetIndexBuffer(cmd->buffer.Get());
+                return {};
+            }
 
-                        case wgpu::TextureDimension::e1D:
-                        case wgpu::TextureDimension::e3D:
-                            UNREACHABLE();
-                    }
+            MaybeError operator()(SetVertexBufferCmd* cmd,
+                                  CommandData<SetVertexBufferCmd>::Type*) {
+                mVertexStateBufferBindingTracker.OnSetVertexBuffer(cmd->slot, cmd->buffer.Get(),
+                                                                   cmd->offset);
+                return {};
+            }
 
-                    gl.PixelStorei(GL_PACK_ROW_LENGTH, 0);
-                    gl.PixelStorei(GL_PACK_IMAGE_HEIGHT, 0);
+            MaybeError operator()(SetStencilReferenceCmd* cmd,
+                                  CommandData<SetStencilReferenceCmd>::Type*) {
+                mPersistentPipelineState->SetStencilReference(mGL, cmd->reference);
+                return {};
+            }
 
-                    gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-                    gl.DeleteFramebuffers(1, &readFBO);
-                    break;
-                }
+            MaybeError operator()(SetViewportCmd* cmd, CommandData<SetViewportCmd>::Type*) {
+                mGL.ViewportIndexedf(0, cmd->x, cmd->y, cmd->width, cmd->height);
+                mGL.DepthRangef(cmd->minDepth, cmd->maxDepth);
+                return {};
+            }
 
-                case Command::CopyTextureToTexture: {
-                    CopyTextureToTextureCmd* copy =
-                        mCommands.NextCommand<CopyTextureToTextureCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
-
-                    // TODO(jiawei.shao@intel.com): add workaround for the case that imageExtentSrc
-                    // is not equal to imageExtentDst. For example when copySize fits in the virtual
-                    // size of the source image but does not fit in the one of the destination
-                    // image.
-                    Extent3D copySize = ComputeTextureCopyExtent(dst, copy->copySize);
-                    Texture* srcTexture = ToBackend(src.texture.Get());
-                    Texture* dstTexture = ToBackend(dst.texture.Get());
-
-                    SubresourceRange srcRange = GetSubresourcesAffectedByCopy(src, copy->copySize);
-                    SubresourceRange dstRange = GetSubresourcesAffectedByCopy(dst, copy->copySize);
-
-                    srcTexture->EnsureSubresourceContentInitialized(srcRange);
-                    if (IsCompleteSubresourceCopiedTo(dstTexture, copySize, dst.mipLevel)) {
-                        dstTexture->SetIsSubresourceContentInitialized(true, dstRange);
-                    } else {
-                        dstTexture->EnsureSubresourceContentInitialized(dstRange);
+            MaybeError operator()(SetScissorRectCmd* cmd, CommandData<SetScissorRectCmd>::Type*) {
+                mGL.Scissor(cmd->x, cmd->y, cmd->width, cmd->height);
+                return {};
+            }
+
+            MaybeError operator()(SetBlendColorCmd* cmd, CommandData<SetBlendColorCmd>::Type*) {
+                const std::array<float, 4> blendColor = ConvertToFloatColor(cmd->color);
+                mGL.BlendColor(blendColor[0], blendColor[1], blendColor[2], blendColor[3]);
+                return {};
+            }
+
+            MaybeError operator()(ExecuteBundlesCmd* cmd, Ref<RenderBundleBase>* bundles) {
+                for (uint32_t i = 0; i < cmd->count; ++i) {
+                    CommandIterator bundleCommands = bundles[i]->GetCommands()->Borrow();
+                    Command bundleType;
+                    while (bundleCommands.NextCommandId(&bundleType)) {
+                        DAWN_TRY(VisitCommand(&bundleCommands, bundleType, *this));
                     }
-                    gl.CopyImageSubData(srcTexture->GetHandle(), srcTexture->GetGLTarget(),
-                                        src.mipLevel, src.origin.x, src.origin.y, src.origin.z,
-                                        dstTexture->GetHandle(), dstTexture->GetGLTarget(),
-                                        dst.mipLevel, dst.origin.x, dst.origin.y, dst.origin.z,
-                                        copySize.width, copySize.height, copy->copySize.depth);
-                    break;
                 }
+                return {};
+            }
 
-                case Command::ResolveQuerySet: {
-                    // TODO(hao.x.li@intel.com): Resolve non-precise occlusion query.
-                    SkipCommand(&mCommands, type);
-                    break;
-                }
+            MaybeError operator()(WriteTimestampCmd*, CommandData<WriteTimestampCmd>::Type*) {
+                return DAWN_UNIMPLEMENTED_ERROR("WriteTimestamp unimplemented");
+            }
 
-                case Command::WriteTimestamp: {
-                    return DAWN_UNIMPLEMENTED_ERROR("WriteTimestamp unimplemented");
+          private:
+            void DoDraw(const DrawCmd* draw) {
+                if (draw->firstInstance > 0) {
+                    mGL.DrawArraysInstancedBaseInstance(mLastPipeline->GetGLPrimitiveTopology(),
+                                                        draw->firstVertex, draw->vertexCount,
+                                                        draw->instanceCount, draw->firstInstance);
+                } else {
+                    // This branch is only needed on OpenGL < 4.2
+                    mGL.DrawArraysInstanced(mLastPipeline->GetGLPrimitiveTopology(),
+                                            draw->firstVertex, draw->vertexCount,
+                                            draw->instanceCount);
                 }
+            }
 
-                case Command::InsertDebugMarker:
-                case Command::PopDebugGroup:
-                case Command::PushDebugGroup: {
-                    // Due to lack of linux driver support for GL_EXT_debug_marker
-                    // extension these functions are skipped.
-                    SkipCommand(&mCommands, type);
-                    break;
+            wgpu::IndexFormat GetIndexFormat() const {
+                // If a index format was specified in setIndexBuffer always use it.
+                wgpu::IndexFormat indexFormat = mIndexBufferFormat;
+                if (indexFormat == wgpu::IndexFormat::Undefined) {
+                    // Otherwise use the pipeline's index format.
+                    // TODO(crbug.com/dawn/502): This path is deprecated.
+                    indexFormat = mLastPipeline->GetVertexStateDescriptor()->indexFormat;
                 }
+                return indexFormat;
+            }
 
-                default:
-                    UNREACHABLE();
+            void DoDrawIndexed(const DrawIndexedCmd* draw, wgpu::IndexFormat indexFormat) {
+                size_t formatSize = IndexFormatSize(indexFormat);
+                void* indices =
+                    reinterpret_cast<void*>(draw->firstIndex * formatSize + mIndexBufferBaseOffset);
+
+                if (draw->firstInstance > 0) {
+                    mGL.DrawElementsInstancedBaseVertexBaseInstance(
+                        mLastPipeline->GetGLPrimitiveTopology(), draw->indexCount,
+                        IndexFormatType(indexFormat), indices, draw->instanceCount,
+                        draw->baseVertex, draw->firstInstance);
+                } else if (draw->baseVertex != 0) {
+                    // This branch is only needed on OpenGL < 4.2; ES < 3.2
+                    mGL.DrawElementsInstancedBaseVertex(
+                        mLastPipeline->GetGLPrimitiveTopology(), draw->indexCount,
+                        IndexFormatType(indexFormat), indices, draw->instanceCount,
+                        draw->baseVertex);
+                } else {
+                    // This branch is only needed on OpenGL < 3.2; ES < 3.2
+                    mGL.DrawElementsInstanced(mLastPipeline->GetGLPrimitiveTopology(),
+                                              draw->indexCount, IndexFormatType(indexFormat),
+                                              indices, draw->instanceCount);
+                }
             }
+
+            const OpenGLFunctions& mGL;
+            PersistentPipelineState* mPersistentPipelineState;
+
+            RenderPipeline* mLastPipeline = nullptr;
+            uint64_t mIndexBufferBaseOffset = 0;
+            wgpu::IndexFormat mIndexBufferFormat = wgpu::IndexFormat::Undefined;
+
+            VertexStateBufferBindingTracker mVertexStateBufferBindingTracker;
+            BindGroupTracker mBindGroupTracker = {};
+        };
+
+    }  // namespace
+
+    // Executes the commands outside of passes.
+    class CommandBuffer::CommandExecutor {
+      public:
+        explicit CommandExecutor(CommandBuffer* commandBuffer)
+            : mCommandBuffer(commandBuffer), mGL(ToBackend(commandBuffer->GetDevice())->gl) {
         }
 
-        return {};
-    }
+        template <typename T, typename D>
+        MaybeError operator()(T*, D*) {
+            UNREACHABLE();
+            return {};
+        }
 
-    MaybeError CommandBuffer::ExecuteComputePass() {
-        const OpenGLFunctions& gl = ToBackend(GetDevice())->gl;
-        ComputePipeline* lastPipeline = nullptr;
-        BindGroupTracker bindGroupTracker = {};
+        MaybeError operator()(BeginComputePassCmd*, CommandData<BeginComputePassCmd>::Type*) {
+            TransitionForPass(NextPassResourceUsage());
+            return mCommandBuffer->ExecuteComputePass();
+        }
 
-        Command type;
-        while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndComputePass: {
-                    mCommands.NextCommand<EndComputePassCmd>();
-                    return {};
-                }
+        MaybeError operator()(BeginRenderPassCmd* cmd, CommandData<BeginRenderPassCmd>::Type*) {
+            TransitionForPass(NextPassResourceUsage());
 
-                case Command::Dispatch: {
-                    DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
-                    bindGroupTracker.Apply(gl);
+            LazyClearRenderPassAttachments(cmd);
+            return mCommandBuffer->ExecuteRenderPass(cmd);
+        }
 
-                    gl.DispatchCompute(dispatch->x, dispatch->y, dispatch->z);
-                    // TODO(cwallez@chromium.org): add barriers to the API
-                    gl.MemoryBarrier(GL_ALL_BARRIER_BITS);
-                    break;
-                }
+        MaybeError operator()(CopyBufferToBufferCmd* copy,
+                              CommandData<CopyBufferToBufferCmd>::Type*) {
+            ToBackend(copy->source)->EnsureDataInitialized();
+            ToBackend(copy->destination)
+                ->EnsureDataInitializedAsDestination(copy->destinationOffset, copy->size);
 
-                case Command::DispatchIndirect: {
-                    DispatchIndirectCmd* dispatch = mCommands.NextCommand<DispatchIndirectCmd>();
-                    bindGroupTracker.Apply(gl);
+            mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, ToBackend(copy->source)->GetHandle());
+            mGL.BindBuffer(GL_PIXEL_UNPACK_BUFFER, ToBackend(copy->destination)->GetHandle());
+            mGL.CopyBufferSubData(GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, copy->sourceOffset,
+                                  copy->destinationOffset, copy->size);
 
-                    uint64_t indirectBufferOffset = dispatch->indirectOffset;
-                    Buffer* indirectBuffer = ToBackend(dispatch->indirectBuffer.Get());
+            mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            mGL.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return {};
+        }
 
-                    gl.BindBuffer(GL_DISPATCH_INDIRECT_BUFFER, indirectBuffer->GetHandle());
-                    gl.DispatchComputeIndirect(static_cast<GLintptr>(indirectBufferOffset));
-                    // TODO(cwallez@chromium.org): add barriers to the API
-                    gl.MemoryBarrier(GL_ALL_BARRIER_BITS);
-                    break;
-                }
+        MaybeError operator()(CopyBufferToTextureCmd* copy,
+                              CommandData<CopyBufferToTextureCmd>::Type*) {
+            auto& src = copy->source;
+            auto& dst = copy->destination;
+            auto& copySize = copy->copySize;
+            Buffer* buffer = ToBackend(src.buffer.Get());
+            Texture* texture = ToBackend(dst.texture.Get());
+
+            if (dst.aspect == Aspect::Stencil) {
+                return DAWN_VALIDATION_ERROR("Copies to stencil textures unsupported on OpenGL");
+            }
+            ASSERT(dst.aspect == Aspect::Color);
+
+            buffer->EnsureDataInitialized();
+
+            ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
+            SubresourceRange subresources = GetSubresourcesAffectedByCopy(dst, copy->copySize);
+            if (IsCompleteSubresourceCopiedTo(texture, copySize, dst.mipLevel)) {
+                texture->SetIsSubresourceContentInitialized(true, subresources);
+            } else {
+                texture->EnsureSubresourceContentInitialized(subresources);
+            }
+
+            mGL.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->GetHandle());
 
-                case Command::SetComputePipeline: {
-                    SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
-                    lastPipeline = ToBackend(cmd->pipeline).Get();
-                    lastPipeline->ApplyNow();
+            TextureDataLayout dataLayout;
+            dataLayout.offset = 0;
+            dataLayout.bytesPerRow = src.bytesPerRow;
+            dataLayout.rowsPerImage = src.rowsPerImage;
+            DoTexSubImage(mGL, dst, reinterpret_cast<void*>(src.offset), dataLayout, copySize);
 
-                    bindGroupTracker.OnSetPipeline(lastPipeline);
+            mGL.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return {};
+        }
+
+        MaybeError operator()(CopyTextureToBufferCmd* copy,
+                              CommandData<CopyTextureToBufferCmd>::Type*) {
+            auto& src = copy->source;
+            auto& dst = copy->destination;
+            auto& copySize = copy->copySize;
+            Texture* texture = ToBackend(src.texture.Get());
+            Buffer* buffer = ToBackend(dst.buffer.Get());
+            const Format& formatInfo = texture->GetFormat();
+            const GLFormat& format = texture->GetGLFormat();
+            GLenum target = texture->GetGLTarget();
+
+            // TODO(jiawei.shao@intel.com): support texture-to-buffer copy with compressed
+            // texture formats.
+            if (formatInfo.isCompressed) {
+                UNREACHABLE();
+            }
+
+            buffer->EnsureDataInitializedAsDestination(copy);
+
+            ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
+            SubresourceRange subresources = GetSubresourcesAffectedByCopy(src, copy->copySize);
+            texture->EnsureSubresourceContentInitialized(subresources);
+            // The only way to move data from a texture to a buffer in GL is via
+            // glReadPixels with a pack buffer. Create a temporary FBO for the copy.
+            mGL.BindTexture(target, texture->GetHandle());
+
+            GLuint readFBO = 0;
+            mGL.GenFramebuffers(1, &readFBO);
+            mGL.BindFramebuffer(GL_READ_FRAMEBUFFER, readFBO);
+
+            const TexelBlockInfo& blockInfo = formatInfo.GetAspectInfo(src.aspect).block;
+
+            mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->GetHandle());
+            mGL.PixelStorei(GL_PACK_IMAGE_HEIGHT, dst.rowsPerImage * blockInfo.height);
+            mGL.PixelStorei(GL_PACK_ROW_LENGTH, dst.bytesPerRow / blockInfo.byteSize);
+
+            GLenum glAttachment;
+            GLenum glFormat;
+            GLenum glType;
+            switch (src.aspect) {
+                case Aspect::Color:
+                    glAttachment = GL_COLOR_ATTACHMENT0;
+                    glFormat = format.format;
+                    glType = format.type;
+                    break;
+                case Aspect::Depth:
+                    glAttachment = GL_DEPTH_ATTACHMENT;
+                    glFormat = GL_DEPTH_COMPONENT;
+                    glType = GL_FLOAT;
+                    break;
+                case Aspect::Stencil:
+                    glAttachment = GL_STENCIL_ATTACHMENT;
+                    glFormat = GL_STENCIL_INDEX;
+                    glType = GL_UNSIGNED_BYTE;
                     break;
-                }
 
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = mCommands.NextData<uint32_t>(cmd->dynamicOffsetCount);
+                case Aspect::None:
+                    UNREACHABLE();
+            }
+
+            uint8_t* offset = reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(dst.offset));
+            switch (texture->GetDimension()) {
+                case wgpu::TextureDimension::e2D: {
+                    if (texture->GetArrayLayers() == 1) {
+                        mGL.FramebufferTexture2D(GL_READ_FRAMEBUFFER, glAttachment, target,
+                                                 texture->GetHandle(), src.mipLevel);
+                        mGL.ReadPixels(src.origin.x, src.origin.y, copySize.width,
+                                       copySize.height, glFormat, glType, offset);
+                        break;
                     }
-                    bindGroupTracker.OnSetBindGroup(cmd->index, cmd->group.Get(),
-                                                    cmd->dynamicOffsetCount, dynamicOffsets);
-                    break;
-                }
 
-                case Command::InsertDebugMarker:
-                case Command::PopDebugGroup:
-                case Command::PushDebugGroup: {
-                    // Due to lack of linux driver support for GL_EXT_debug_marker
-                    // extension these functions are skipped.
-                    SkipCommand(&mCommands, type);
-                    break;
-                }
+                    const uint64_t bytesPerImage = dst.bytesPerRow * dst.rowsPerImage;
+                    for (uint32_t layer = 0; layer < copySize.depth; ++layer) {
+                        mGL.FramebufferTextureLayer(GL_READ_FRAMEBUFFER, glAttachment,
+                                                    texture->GetHandle(), src.mipLevel,
+                                                    src.origin.z + layer);
+                        mGL.ReadPixels(src.origin.x, src.origin.y, copySize.width,
+                                       copySize.height, glFormat, glType, offset);
+
+                        offset += bytesPerImage;
+                    }
 
-                case Command::WriteTimestamp: {
-                    return DAWN_UNIMPLEMENTED_ERROR("WriteTimestamp unimplemented");
+                    break;
                 }
 
-                default:
+                case wgpu::TextureDimension::e1D:
+                case wgpu::TextureDimension::e3D:
                     UNREACHABLE();
             }
+
+            mGL.PixelStorei(GL_PACK_ROW_LENGTH, 0);
+            mGL.PixelStorei(GL_PACK_IMAGE_HEIGHT, 0);
+
+            mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            mGL.DeleteFramebuffers(1, &readFBO);
+            return {};
+        }
+
+        MaybeError operator()(CopyTextureToTextureCmd* copy,
+                              CommandData<CopyTextureToTextureCmd>::Type*) {
+            auto& src = copy->source;
+            auto& dst = copy->destination;
+
+            // TODO(jiawei.shao@intel.com): add workaround for the case that imageExtentSrc
+            // is not equal to imageExtentDst. For example when copySize fits in the virtual
+            // size of the source image but does not fit in the one of the destination
+            // image.
+            Extent3D copySize = ComputeTextureCopyExtent(dst, copy->copySize);
+            Texture* srcTexture = ToBackend(src.texture.Get());
+            Texture* dstTexture = ToBackend(dst.texture.Get());
+
+            SubresourceRange srcRange = GetSubresourcesAffectedByCopy(src, copy->copySize);
+            SubresourceRange dstRange = GetSubresourcesAffectedByCopy(dst, copy->copySize);
+
+            srcTexture->EnsureSubresourceContentInitialized(srcRange);
+            if (IsCompleteSubresourceCopiedTo(dstTexture, copySize, dst.mipLevel)) {
+                dstTexture->SetIsSubresourceContentInitialized(true, dstRange);
+            } else {
+                dstTexture->EnsureSubresourceContentInitialized(dstRange);
+            }
+            mGL.CopyImageSubData(srcTexture->GetHandle(), srcTexture->GetGLTarget(), src.mipLevel,
+                                 src.origin.x, src.origin.y, src.origin.z, dstTexture->GetHandle(),
+                                 dstTexture->GetGLTarget(), dst.mipLevel, dst.origin.x,
+                                 dst.origin.y, dst.origin.z, copySize.width, copySize.height,
+                                 copy->copySize.depth);
+            return {};
+        }
+
+        MaybeError operator()(ResolveQuerySetCmd*, CommandData<ResolveQuerySetCmd>::Type*) {
+            // TODO(hao.x.li@intel.com): Resolve non-precise occlusion query.
+            return {};
+        }
+
+        MaybeError operator()(WriteTimestampCmd*, CommandData<WriteTimestampCmd>::Type*) {
+            return DAWN_UNIMPLEMENTED_ERROR("WriteTimestamp unimplemented");
+        }
+
+        // Due to lack of linux driver support for GL_EXT_debug_marker
+        // extension these functions are skipped.
+        MaybeError operator()(InsertDebugMarkerCmd*, char*) {
+            return {};
+        }
+
+        MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+            return {};
+        }
+
+        MaybeError operator()(PushDebugGroupCmd*, char*) {
+            return {};
+        }
+
+      private:
+        const PassResourceUsage& NextPassResourceUsage() {
+            return mCommandBuffer->GetResourceUsages().perPass[mNextPassNumber++];
+        }
+
+        CommandBuffer* mCommandBuffer;
+        const OpenGLFunctions& mGL;
+        uint32_t mNextPassNumber = 0;
+    };
+
+    CommandBuffer::CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor)
+        : CommandBufferBase(encoder, descriptor) {
+    }
+
+    MaybeError CommandBuffer::Execute() {
+        CommandExecutor executor(this);
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            DAWN_TRY(VisitCommand(&mCommands, type, executor));
+        }
+
+        return {};
+    }
+
+    MaybeError CommandBuffer::ExecuteComputePass() {
+        ComputePassExecutor executor(ToBackend(GetDevice())->gl);
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            if (type == Command::EndComputePass) {
+                mCommands.NextCommand<EndComputePassCmd>();
+                return {};
+            }
+            DAWN_TRY(VisitCommand(&mCommands, type, executor));
         }
 
         // EndComputePass should have been called
@@ -989,232 +1178,82 @@ namespace dawn_native { namespace opengl {
             }
         }
 
-        RenderPipeline* lastPipeline = nullptr;
-        uint64_t indexBufferBaseOffset = 0;
-        wgpu::IndexFormat indexBufferFormat;
-
-        VertexStateBufferBindingTracker vertexStateBufferBindingTracker;
-        BindGroupTracker bindGroupTracker = {};
-
-        auto DoRenderBundleCommand = [&](CommandIterator* iter, Command type) {
-            switch (type) {
-                case Command::Draw: {
-                    DrawCmd* draw = iter->NextCommand<DrawCmd>();
-                    vertexStateBufferBindingTracker.Apply(gl);
-                    bindGroupTracker.Apply(gl);
-
-                    if (draw->firstInstance > 0) {
-                        gl.DrawArraysInstancedBaseInstance(
-                            lastPipeline->GetGLPrimitiveTopology(), draw->firstVertex,
-                            draw->vertexCount, draw->instanceCount, draw->firstInstance);
-                    } else {
-                        // This branch is only needed on OpenGL < 4.2
-                        gl.DrawArraysInstanced(lastPipeline->GetGLPrimitiveTopology(),
-                                               draw->firstVertex, draw->vertexCount,
-                                               draw->instanceCount);
-                    }
-                    break;
-                }
-
-                case Command::DrawIndexed: {
-                    DrawIndexedCmd* draw = iter->NextCommand<DrawIndexedCmd>();
-                    vertexStateBufferBindingTracker.Apply(gl);
-                    bindGroupTracker.Apply(gl);
-
-                    // If a index format was specified in setIndexBuffer always use it.
-                    wgpu::IndexFormat indexFormat = indexBufferFormat;
-                    if (indexFormat == wgpu::IndexFormat::Undefined) {
-                        // Otherwise use the pipeline's index format.
-                        // TODO(crbug.com/dawn/502): This path is deprecated.
-                        indexFormat = lastPipeline->GetVertexStateDescriptor()->indexFormat;
-                    }
-                    size_t formatSize = IndexFormatSize(indexFormat);
-
-                    if (draw->firstInstance > 0) {
-                        gl.DrawElementsInstancedBaseVertexBaseInstance(
-                            lastPipeline->GetGLPrimitiveTopology(), draw->indexCount,
-                            IndexFormatType(indexFormat),
-                            reinterpret_cast<void*>(draw->firstIndex * formatSize +
-                                                    indexBufferBaseOffset),
-                            draw->instanceCount, draw->baseVertex, draw->firstInstance);
-                    } else {
-                        // This branch is only needed on OpenGL < 4.2; ES < 3.2
-                        if (draw->baseVertex != 0) {
-                            gl.DrawElementsInstancedBaseVertex(
-                                lastPipeline->GetGLPrimitiveTopology(), draw->indexCount,
-                                IndexFormatType(indexFormat),
-                                reinterpret_cast<void*>(draw->firstIndex * formatSize +
-                                                        indexBufferBaseOffset),
-                                draw->instanceCount, draw->baseVertex);
-                        } else {
-                            // This branch is only needed on OpenGL < 3.2; ES < 3.2
-                            gl.DrawElementsInstanced(
-                                lastPipeline->GetGLPrimitiveTopology(), draw->indexCount,
-                                IndexFormatType(indexFormat),
-                                reinterpret_cast<void*>(draw->firstIndex * formatSize +
-                                                        indexBufferBaseOffset),
-                                draw->instanceCount);
-                        }
-                    }
-                    break;
-                }
-
-                case Command::DrawIndirect: {
-                    DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-                    vertexStateBufferBindingTracker.Apply(gl);
-                    bindGroupTracker.Apply(gl);
-
-                    uint64_t indirectBufferOffset = draw->indirectOffset;
-                    Buffer* indirectBuffer = ToBackend(draw->indirectBuffer.Get());
-
-                    gl.BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer->GetHandle());
-                    gl.DrawArraysIndirect(
-                        lastPipeline->GetGLPrimitiveTopology(),
-                        reinterpret_cast<void*>(static_cast<intptr_t>(indirectBufferOffset)));
-                    break;
-                }
-
-                case Command::DrawIndexedIndirect: {
-                    DrawIndexedIndirectCmd* draw = iter->NextCommand<DrawIndexedIndirectCmd>();
-                    vertexStateBufferBindingTracker.Apply(gl);
-                    bindGroupTracker.Apply(gl);
-
-                    uint64_t indirectBufferOffset = draw->indirectOffset;
-                    Buffer* indirectBuffer = ToBackend(draw->indirectBuffer.Get());
-
-                    // If a index format was specified in setIndexBuffer always use it.
-                    wgpu::IndexFormat indexFormat = indexBufferFormat;
-                    if (indexFormat == wgpu::IndexFormat::Undefined) {
-                        // Otherwise use the pipeline's index format.
-                        // TODO(crbug.com/dawn/502): This path is deprecated.
-                        indexFormat = lastPipeline->GetVertexStateDescriptor()->indexFormat;
-                    }
-
-                    gl.BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer->GetHandle());
-                    gl.DrawElementsIndirect(
-                        lastPipeline->GetGLPrimitiveTopology(), IndexFormatType(indexFormat),
-                        reinterpret_cast<void*>(static_cast<intptr_t>(indirectBufferOffset)));
-                    break;
-                }
-
-                case Command::InsertDebugMarker:
-                case Command::PopDebugGroup:
-                case Command::PushDebugGroup: {
-                    // Due to lack of linux driver support for GL_EXT_debug_marker
-                    // extension these functions are skipped.
-                    SkipCommand(iter, type);
-                    break;
-                }
-
-                case Command::SetRenderPipeline: {
-                    SetRenderPipelineCmd* cmd = iter->NextCommand<SetRenderPipelineCmd>();
-                    lastPipeline = ToBackend(cmd->pipeline).Get();
-                    lastPipeline->ApplyNow(persistentPipelineState);
-
-                    vertexStateBufferBindingTracker.OnSetPipeline(lastPipeline);
-                    bindGroupTracker.OnSetPipeline(lastPipeline);
-                    break;
-                }
-
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
-                    bindGroupTracker.OnSetBindGroup(cmd->index, cmd->group.Get(),
-                                                    cmd->dynamicOffsetCount, dynamicOffsets);
-                    break;
-                }
-
-                case Command::SetIndexBuffer: {
-                    SetIndexBufferCmd* cmd = iter->NextCommand<SetIndexBufferCmd>();
-                    // TODO(crbug.com/dawn/502): Once setIndexBuffer is required to specify an
-                    // index buffer format store as an GLenum.
-                    indexBufferFormat = cmd->format;
-                    indexBufferBaseOffset = cmd->offset;
-                    vertexStateBufferBindingTracker.OnSetIndexBuffer(cmd->buffer.Get());
-                    break;
-                }
-
-                case Command::SetVertexBuffer: {
-                    SetVertexBufferCmd* cmd = iter->NextCommand<SetVertexBufferCmd>();
-                    vertexStateBufferBindingTracker.OnSetVertexBuffer(cmd->slot, cmd->buffer.Get(),
-                                                                      cmd->offset);
-                    break;
-                }
-
-                default:
-                    UNREACHABLE();
-                    break;
-            }
-        };
+        RenderPassExecutor executor(gl, &persistentPipelineState);
 
         Command type;
         while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndRenderPass: {
-                    mCommands.NextCommand<EndRenderPassCmd>();
-
-                    if (renderPass->attachmentState->GetSampleCount() > 1) {
-                        ResolveMultisampledRenderTargets(gl, renderPass);
-                    }
-                    gl.DeleteFramebuffers(1, &fbo);
-                    return {};
-                }
-
-                case Command::SetStencilReference: {
-                    SetStencilReferenceCmd* cmd = mCommands.NextCommand<SetStencilReferenceCmd>();
-                    persistentPipelineState.SetStencilReference(gl, cmd->reference);
-                    break;
-                }
-
-                case Command::SetViewport: {
-                    SetViewportCmd* cmd = mCommands.NextCommand<SetViewportCmd>();
-                    gl.ViewportIndexedf(0, cmd->x, cmd->y, cmd->width, cmd->height);
-                    gl.DepthRangef(cmd->minDepth, cmd->maxDepth);
-                    break;
-                }
-
-                case Command::SetScissorRect: {
-                    SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
-                    gl.Scissor(cmd->x, cmd->y, cmd->width, cmd->height);
-                    break;
-                }
+            if (type == Command::EndRenderPass) {
+                mCommands.NextCommand<EndRenderPassCmd>();
 
-                case Command::SetBlendColor: {
-                    SetBlendColorCmd* cmd = mCommands.NextCommand<SetBlendColorCmd>();
-                    const std::array<float, 4> blendColor = ConvertToFloatColor(cmd->color);
-                    gl.BlendColor(blendColor[0], blendColor[1], blendColor[2], blendColor[3]);
-                    break;
-                }
-
-                case Command::ExecuteBundles: {
-                    ExecuteBundlesCmd* cmd = mCommands.NextCommand<ExecuteBundlesCmd>();
-                    auto bundles = mCommands.NextData<Ref<RenderBundleBase>>(cmd->count);
-
-                    for (uint32_t i = 0; i < cmd->count; ++i) {
-                        CommandIterator* iter = bundles[i]->GetCommands();
-                        iter->Reset();
-                        while (iter->NextCommandId(&type)) {
-                            DoRenderBundleCommand(iter, type);
-                        }
-                    }
-                    break;
-                }
-
-                case Command::WriteTimestamp:
-                    return DAWN_UNIMPLEMENTED_ERROR("WriteTimestamp unimplemented");
-
-                default: {
-                    DoRenderBundleCommand(&mCommands, type);
-                    break;
+                if (renderPass->attachmentState->GetSampleCount() > 1) {
+                    ResolveMultisampledRenderTargets(gl, renderPass);
                 }
+                gl.DeleteFramebuffers(1, &fbo);
+                return {};
             }
+            DAWN_TRY(VisitCommand(&mCommands, type, executor));
         }
 
         // EndRenderPass should have been called
         UNREACHABLE();
     }
 
+    void DoTexSubImage(const OpenGLFunctions& gl,
+                       const TextureCopy& destination,
+                       const void* data,
+                       const TextureDataLayout& dataLayout,
+                       const Extent3D& copySize) {
+        const Texture* texture = ToBackend(destination.texture.Get());
+        ASSERT(texture->GetDimension() == wgpu::TextureDimension::e2D);
+
+        const GLFormat& format = texture->GetGLFormat();
+        GLenum target = texture->GetGLTarget();
+        gl.ActiveTexture(GL_TEXTURE0);
+        gl.BindTexture(target, texture->GetHandle());
+
+        const Format& formatInfo = texture->GetFormat();
+        const TexelBlockInfo& blockInfo = formatInfo.GetAspectInfo(destination.aspect).block;
+        gl.PixelStorei(GL_UNPACK_ROW_LENGTH,
+                       dataLayout.bytesPerRow / blockInfo.byteSize * blockInfo.width);
+        gl.PixelStorei(GL_UNPACK_IMAGE_HEIGHT, dataLayout.rowsPerImage * blockInfo.height);
+
+        if (formatInfo.isCompressed) {
+            gl.PixelStorei(GL_UNPACK_COMPRESSED_BLOCK_SIZE, blockInfo.byteSize);
+            gl.PixelStorei(GL_UNPACK_COMPRESSED_BLOCK_WIDTH, blockInfo.width);
+            gl.PixelStorei(GL_UNPACK_COMPRESSED_BLOCK_HEIGHT, blockInfo.height);
+            gl.PixelStorei(GL_UNPACK_COMPRESSED_BLOCK_DEPTH, 1);
+
+            uint64_t copyDataSize = (copySize.width / blockInfo.width) *
+                                    (copySize.height / blockInfo.height) * blockInfo.byteSize *
+                                    copySize.depth;
+            Extent3D copyExtent = ComputeTextureCopyExtent(destination, copySize);
+
+            if (texture->GetArrayLayers() > 1) {
+                gl.CompressedTexSubImage3D(target, destination.mipLevel, destination.origin.x,
+                                           destination.origin.y, destination.origin.z,
+                                           copyExtent.width, copyExtent.height, copyExtent.depth,
+                                           format.internalFormat, copyDataSize, data);
+            } else {
+                gl.CompressedTexSubImage2D(target, destination.mipLevel, destination.origin.x,
+                                           destination.origin.y, copyExtent.width,
+                                           copyExtent.height, format.internalFormat, copyDataSize,
+                                           data);
+            }
+        } else {
+            if (texture->GetArrayLayers() > 1) {
+                gl.TexSubImage3D(target, destination.mipLevel, destination.origin.x,
+                                 destination.origin.y, destination.origin.z, copySize.width,
+                                 copySize.height, copySize.depth, format.format, format.type,
+                                 data);
+            } else {
+                gl.TexSubImage2D(target, destination.mipLevel, destination.origin.x,
+                                 destination.origin.y, copySize.width, copySize.height,
+                                 format.format, format.type, data);
+            }
+        }
+
+        gl.PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        gl.PixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+    }
+
 }}  // namespace dawn_native::opengl
@@ -19,11 +19,13 @@
 
 namespace dawn_native {
     struct BeginRenderPassCmd;
+    struct TextureCopy;
 }  // namespace dawn_native
 
 namespace dawn_native { namespace opengl {
 
     class Device;
+    struct OpenGLFunctions;
 
     class CommandBuffer final : public CommandBufferBase {
       public:
@@ -34,8 +36,19 @@ namespace dawn_native { namespace opengl {
       private:
         MaybeError ExecuteComputePass();
         MaybeError ExecuteRenderPass(BeginRenderPassCmd* renderPass);
+
+        class CommandExecutor;
     };
 
+    // Uploads |data| to |destination|. |data| is either a CPU pointer or, when a buffer is bound
+    // to GL_PIXEL_UNPACK_BUFFER, the offset of the texels in that buffer. dataLayout.offset is
+    // ignored: it must already be included in |data|.
+    void DoTexSubImage(const OpenGLFunctions& gl,
+                       const TextureCopy& destination,
+                       const void* data,
+                       const TextureDataLayout& dataLayout,
+                       const Extent3D& copySize);
+
 }}  // namespace dawn_native::opengl
 
 #endif  // DAWNNATIVE_OPENGL_COMMANDBUFFERGL_H_
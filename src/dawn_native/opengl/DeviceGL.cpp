@@ -29,6 +29,7 @@
 #include "dawn_native/opengl/RenderPipelineGL.h"
 #include "dawn_native/opengl/SamplerGL.h"
 #include "dawn_native/opengl/ShaderModuleGL.h"
+#include "dawn_native/opengl/StagingBufferGL.h"
 #include "dawn_native/opengl/SwapChainGL.h"
 #include "dawn_native/opengl/TextureGL.h"
 
@@ -82,6 +83,14 @@ namespace dawn_native { namespace opengl {
         // TODO(crbug.com/dawn/343): Investigate emulation.
         SetToggle(Toggle::DisableBaseVertex, !supportsBaseVertex);
         SetToggle(Toggle::DisableBaseInstance, !supportsBaseInstance);
+
+        // TODO(crbug.com/dawn/343): EXT_buffer_storage would allow persistently mapped staging
+        // buffers on GLES too, but its procs aren't loaded yet.
+        bool supportsBufferStorage = gl.BufferStorage != nullptr;
+        SetToggle(Toggle::OpenGLUsePersistentlyMappedStaging, supportsBufferStorage);
+        if (!supportsBufferStorage) {
+            ForceSetToggle(Toggle::OpenGLUsePersistentlyMappedStaging, false);
+        }
     }
 
     const GLFormat& Device::GetGLFormat(const Format& format) {
@@ -154,9 +163,18 @@ namespace dawn_native { namespace opengl {
         GLsync sync = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
         IncrementLastSubmittedCommandSerial();
         mFencesInFlight.emplace(sync, GetLastSubmittedCommandSerial());
+        mHasUnfencedStagingBufferUses = false;
+    }
+
+    void Device::TrackStagingBufferUse() {
+        mHasUnfencedStagingBufferUses = true;
+        AddFutureSerial(GetPendingCommandSerial());
     }
 
     MaybeError Device::TickImpl() {
+        if (mHasUnfencedStagingBufferUses) {
+            SubmitFenceSync();
+        }
         return {};
     }
 
@@ -185,7 +203,14 @@ namespace dawn_native { namespace opengl {
     }
 
     ResultOrError<std::unique_ptr<StagingBufferBase>> Device::CreateStagingBuffer(size_t size) {
-        return DAWN_UNIMPLEMENTED_ERROR("Device unable to create staging buffer.");
+        if (!IsToggleEnabled(Toggle::OpenGLUsePersistentlyMappedStaging)) {
+            return DAWN_UNIMPLEMENTED_ERROR("Device unable to create staging buffer.");
+        }
+
+        std::unique_ptr<StagingBufferBase> stagingBuffer =
+            std::make_unique<StagingBuffer>(size, this);
+        DAWN_TRY(stagingBuffer->Initialize());
+        return std::move(stagingBuffer);
     }
 
     MaybeError Device::CopyFromStagingToBuffer(StagingBufferBase* source,
@@ -193,14 +218,45 @@ namespace dawn_native { namespace opengl {
                                                BufferBase* destination,
                                                uint64_t destinationOffset,
                                                uint64_t size) {
-        return DAWN_UNIMPLEMENTED_ERROR("Device unable to copy from staging buffer.");
+        ToBackend(destination)->EnsureDataInitializedAsDestination(destinationOffset, size);
+
+        gl.BindBuffer(GL_COPY_READ_BUFFER, ToBackend(source)->GetHandle());
+        gl.BindBuffer(GL_COPY_WRITE_BUFFER, ToBackend(destination)->GetHandle());
+        gl.CopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceOffset,
+                             destinationOffset, size);
+
+        TrackStagingBufferUse();
+        return {};
     }
 
     MaybeError Device::CopyFromStagingToTexture(const StagingBufferBase* source,
                                                 const TextureDataLayout& src,
                                                 TextureCopy* dst,
                                                 const Extent3D& copySizePixels) {
-        return DAWN_UNIMPLEMENTED_ERROR("Device unable to copy from staging buffer to texture.");
+        if (dst->aspect == Aspect::Stencil) {
+            return DAWN_VALIDATION_ERROR("Copies to stencil textures unsupported on OpenGL");
+        }
+        ASSERT(dst->aspect == Aspect::Color);
+
+        Texture* texture = ToBackend(dst->texture.Get());
+        SubresourceRange range = GetSubresourcesAffectedByCopy(*dst, copySizePixels);
+        if (IsCompleteSubresourceCopiedTo(texture, copySizePixels, dst->mipLevel)) {
+            texture->SetIsSubresourceContentInitialized(true, range);
+        } else {
+            texture->EnsureSubresourceContentInitialized(range);
+        }
+
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, ToBackend(source)->GetHandle());
+        DoTexSubImage(gl, *dst, reinterpret_cast<void*>(static_cast<uintptr_t>(src.offset)), src,
+                      copySizePixels);
+        gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        TrackStagingBufferUse();
+        return {};
+    }
+
+    void Device::ReportBackendCounters(DeviceCounters* counters) const {
+        counters->skippedGLStateChanges += gl.GetSkippedStateChangeCount();
     }
 
     void Device::ShutDownImpl() {
@@ -49,6 +49,10 @@ namespace dawn_native { namespace opengl {
 
         void SubmitFenceSync();
 
+        // Copies from staging buffers aren't part of a queue submit. Makes the next tick submit a
+        // fence for them so that the staging memory isn't reused while the GPU reads it.
+        void TrackStagingBufferUse();
+
         // Dawn API
         CommandBufferBase* CreateCommandBuffer(CommandEncoder* encoder,
                                                const CommandBufferDescriptor* descriptor) override;
@@ -106,10 +110,12 @@ namespace dawn_native { namespace opengl {
 
         void InitTogglesFromDriver();
         ExecutionSerial CheckAndUpdateCompletedSerials() override;
+        void ReportBackendCounters(DeviceCounters* counters) const override;
         void ShutDownImpl() override;
         MaybeError WaitForIdleForDestruction() override;
 
         std::queue<std::pair<GLsync, ExecutionSerial>> mFencesInFlight;
+        bool mHasUnfencedStagingBufferUses = false;
 
         GLFormatTable mFormatTable;
     };
@@ -14,12 +14,102 @@
 
 #include "dawn_native/opengl/OpenGLFunctions.h"
 
+#include <algorithm>
+#include <array>
 #include <cctype>
+#include <map>
 #include <tuple>
 
 namespace dawn_native { namespace opengl {
 
+    namespace {
+
+        // A piece of state whose value is unknown until it is set.
+        template <typename T>
+        struct CachedState {
+            bool known = false;
+            T value;
+        };
+
+        // Removes the bindings to any of the |n| objects in |names|.
+        template <typename Key, typename Value, typename GetName>
+        void EraseBindings(std::map<Key, Value>* bindings,
+                           GLsizei n,
+                           const GLuint* names,
+                           GetName getName) {
+            for (auto it = bindings->begin(); it != bindings->end();) {
+                if (std::find(names, names + n, getName(it->second)) != names + n) {
+                    it = bindings->erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        GLuint GetBindingName(GLuint name) {
+            return name;
+        }
+
+        void EraseBinding(CachedState<GLuint>* binding, GLsizei n, const GLuint* names) {
+            if (binding->known && std::find(names, names + n, binding->value) != names + n) {
+                binding->known = false;
+            }
+        }
+
+    }  // anonymous namespace
+
+    struct OpenGLFunctions::StateCache {
+        // Records that the state is set to |value| and returns whether it needs to be set.
+        template <typename T>
+        bool Update(CachedState<T>* state, const T& value) {
+            if (state->known && state->value == value) {
+                skippedStateChangeCount++;
+                return false;
+            }
+            state->known = true;
+            state->value = value;
+            return true;
+        }
+
+        // Same as above for state that has a value per |key|, like a binding point.
+        template <typename Key, typename Value>
+        bool Update(std::map<Key, Value>* states, const Key& key, const Value& value) {
+            auto it = states->find(key);
+            if (it != states->end() && it->second == value) {
+                skippedStateChangeCount++;
+                return false;
+            }
+            (*states)[key] = value;
+            return true;
+        }
+
+        using IndexedBufferBinding = std::tuple<GLuint, GLintptr, GLsizeiptr>;
+
+        CachedState<GLenum> activeTexture;
+        // The textures are keyed by texture unit and target.
+        std::map<std::pair<GLenum, GLenum>, GLuint> textures;
+        std::map<GLuint, GLuint> samplers;
+        // The element array buffer binding is part of the vertex array state, it is forgotten when
+        // the vertex array changes.
+        std::map<GLenum, GLuint> buffers;
+        std::map<std::pair<GLenum, GLuint>, IndexedBufferBinding> indexedBuffers;
+        CachedState<GLuint> readFramebuffer;
+        CachedState<GLuint> drawFramebuffer;
+        CachedState<GLuint> program;
+        CachedState<GLuint> vertexArray;
+
+        // Dawn only uses the first viewport so only its value is known.
+        CachedState<std::array<GLfloat, 4>> viewport;
+        CachedState<std::array<GLint, 4>> scissor;
+        CachedState<std::array<GLfloat, 4>> blendColor;
+        std::map<GLuint, std::array<GLboolean, 4>> colorMasks;
+
+        uint64_t skippedStateChangeCount = 0;
+    };
+
     MaybeError OpenGLFunctions::Initialize(GetProcAddress getProc) {
+        mStateCache = std::make_shared<StateCache>();
+
         PFNGLGETSTRINGPROC getString = reinterpret_cast<PFNGLGETSTRINGPROC>(getProc("glGetString"));
         if (getString == nullptr) {
             return DAWN_INTERNAL_ERROR("Couldn't load glGetString");
@@ -84,4 +174,208 @@ namespace dawn_native { namespace opengl {
                std::tie(mMajorVersion, mMinorVersion) >= std::tie(majorVersion, minorVersion);
     }
 
+    void OpenGLFunctions::ActiveTexture(GLenum texture) const {
+        if (mStateCache->Update(&mStateCache->activeTexture, texture)) {
+            OpenGLFunctionsBase::ActiveTexture(texture);
+        }
+    }
+
+    void OpenGLFunctions::BindBuffer(GLenum target, GLuint buffer) const {
+        if (mStateCache->Update(&mStateCache->buffers, target, buffer)) {
+            OpenGLFunctionsBase::BindBuffer(target, buffer);
+        }
+    }
+
+    void OpenGLFunctions::BindBufferBase(GLenum target, GLuint index, GLuint buffer) const {
+        // Binding the whole buffer is different from binding a range of it, even a range
+        // covering all of it, so the size is -1 which isn't a valid range size.
+        StateCache::IndexedBufferBinding binding{buffer, 0, -1};
+        if (mStateCache->Update(&mStateCache->indexedBuffers, {target, index}, binding)) {
+            // The buffer is also bound to the generic binding point of the target.
+            mStateCache->buffers[target] = buffer;
+            OpenGLFunctionsBase::BindBufferBase(target, index, buffer);
+        }
+    }
+
+    void OpenGLFunctions::BindBufferRange(GLenum target,
+                                          GLuint index,
+                                          GLuint buffer,
+                                          GLintptr offset,
+                                          GLsizeiptr size) const {
+        StateCache::IndexedBufferBinding binding{buffer, offset, size};
+        if (mStateCache->Update(&mStateCache->indexedBuffers, {target, index}, binding)) {
+            // The buffer is also bound to the generic binding point of the target.
+            mStateCache->buffers[target] = buffer;
+            OpenGLFunctionsBase::BindBufferRange(target, index, buffer, offset, size);
+        }
+    }
+
+    void OpenGLFunctions::BindFramebuffer(GLenum target, GLuint framebuffer) const {
+        StateCache* cache = mStateCache.get();
+        bool needsCall = false;
+        switch (target) {
+            case GL_FRAMEBUFFER:
+                if (cache->readFramebuffer.known && cache->readFramebuffer.value == framebuffer &&
+                    cache->drawFramebuffer.known && cache->drawFramebuffer.value == framebuffer) {
+                    cache->skippedStateChangeCount++;
+                } else {
+                    cache->readFramebuffer = {true, framebuffer};
+                    cache->drawFramebuffer = {true, framebuffer};
+                    needsCall = true;
+                }
+                break;
+            case GL_READ_FRAMEBUFFER:
+                needsCall = cache->Update(&cache->readFramebuffer, framebuffer);
+                break;
+            case GL_DRAW_FRAMEBUFFER:
+                needsCall = cache->Update(&cache->drawFramebuffer, framebuffer);
+                break;
+            default:
+                needsCall = true;
+                break;
+        }
+
+        if (needsCall) {
+            OpenGLFunctionsBase::BindFramebuffer(target, framebuffer);
+        }
+    }
+
+    void OpenGLFunctions::BindSampler(GLuint unit, GLuint sampler) const {
+        if (mStateCache->Update(&mStateCache->samplers, unit, sampler)) {
+            OpenGLFunctionsBase::BindSampler(unit, sampler);
+        }
+    }
+
+    void OpenGLFunctions::BindTexture(GLenum target, GLuint texture) const {
+        StateCache* cache = mStateCache.get();
+        if (!cache->activeTexture.known) {
+            // The unit the texture is bound to isn't known, so forget the bindings of the target
+            // on all units.
+            for (auto it = cache->textures.begin(); it != cache->textures.end();) {
+                if (it->first.second == target) {
+                    it = cache->textures.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            OpenGLFunctionsBase::BindTexture(target, texture);
+            return;
+        }
+
+        if (cache->Update(&cache->textures, {cache->activeTexture.value, target}, texture)) {
+            OpenGLFunctionsBase::BindTexture(target, texture);
+        }
+    }
+
+    void OpenGLFunctions::BindVertexArray(GLuint array) const {
+        if (mStateCache->Update(&mStateCache->vertexArray, array)) {
+            mStateCache->buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+            OpenGLFunctionsBase::BindVertexArray(array);
+        }
+    }
+
+    void OpenGLFunctions::BlendColor(GLfloat red,
+                                     GLfloat green,
+                                     GLfloat blue,
+                                     GLfloat alpha) const {
+        if (mStateCache->Update(&mStateCache->blendColor, {red, green, blue, alpha})) {
+            OpenGLFunctionsBase::BlendColor(red, green, blue, alpha);
+        }
+    }
+
+    void OpenGLFunctions::ColorMask(GLboolean red,
+                                    GLboolean green,
+                                    GLboolean blue,
+                                    GLboolean alpha) const {
+        // This sets the mask of all the draw buffers, whose number isn't known.
+        mStateCache->colorMasks.clear();
+        OpenGLFunctionsBase::ColorMask(red, green, blue, alpha);
+    }
+
+    void OpenGLFunctions::ColorMaski(GLuint index,
+                                     GLboolean r,
+                                     GLboolean g,
+                                     GLboolean b,
+                                     GLboolean a) const {
+        if (mStateCache->Update(&mStateCache->colorMasks, index, {r, g, b, a})) {
+            OpenGLFunctionsBase::ColorMaski(index, r, g, b, a);
+        }
+    }
+
+    void OpenGLFunctions::Scissor(GLint x, GLint y, GLsizei width, GLsizei height) const {
+        if (mStateCache->Update(&mStateCache->scissor, {x, y, width, height})) {
+            OpenGLFunctionsBase::Scissor(x, y, width, height);
+        }
+    }
+
+    void OpenGLFunctions::UseProgram(GLuint program) const {
+        if (mStateCache->Update(&mStateCache->program, program)) {
+            OpenGLFunctionsBase::UseProgram(program);
+        }
+    }
+
+    void OpenGLFunctions::Viewport(GLint x, GLint y, GLsizei width, GLsizei height) const {
+        std::array<GLfloat, 4> viewport = {static_cast<GLfloat>(x), static_cast<GLfloat>(y),
+                                           static_cast<GLfloat>(width),
+                                           static_cast<GLfloat>(height)};
+        if (mStateCache->Update(&mStateCache->viewport, viewport)) {
+            OpenGLFunctionsBase::Viewport(x, y, width, height);
+        }
+    }
+
+    void OpenGLFunctions::ViewportIndexedf(GLuint index,
+                                           GLfloat x,
+                                           GLfloat y,
+                                           GLfloat w,
+                                           GLfloat h) const {
+        if (index != 0) {
+            // Viewport sets all the viewports so it must not be skipped after this.
+            mStateCache->viewport.known = false;
+            OpenGLFunctionsBase::ViewportIndexedf(index, x, y, w, h);
+            return;
+        }
+
+        if (mStateCache->Update(&mStateCache->viewport, {x, y, w, h})) {
+            OpenGLFunctionsBase::ViewportIndexedf(index, x, y, w, h);
+        }
+    }
+
+    void OpenGLFunctions::DeleteBuffers(GLsizei n, const GLuint* buffers) const {
+        EraseBindings(&mStateCache->buffers, n, buffers, GetBindingName);
+        EraseBindings(&mStateCache->indexedBuffers, n, buffers,
+                      [](const StateCache::IndexedBufferBinding& binding) {
+                          return std::get<0>(binding);
+                      });
+        OpenGLFunctionsBase::DeleteBuffers(n, buffers);
+    }
+
+    void OpenGLFunctions::DeleteFramebuffers(GLsizei n, const GLuint* framebuffers) const {
+        EraseBinding(&mStateCache->readFramebuffer, n, framebuffers);
+        EraseBinding(&mStateCache->drawFramebuffer, n, framebuffers);
+        OpenGLFunctionsBase::DeleteFramebuffers(n, framebuffers);
+    }
+
+    void OpenGLFunctions::DeleteSamplers(GLsizei count, const GLuint* samplers) const {
+        EraseBindings(&mStateCache->samplers, count, samplers, GetBindingName);
+        OpenGLFunctionsBase::DeleteSamplers(count, samplers);
+    }
+
+    void OpenGLFunctions::DeleteTextures(GLsizei n, const GLuint* textures) const {
+        EraseBindings(&mStateCache->textures, n, textures, GetBindingName);
+        OpenGLFunctionsBase::DeleteTextures(n, textures);
+    }
+
+    void OpenGLFunctions::DeleteVertexArrays(GLsizei n, const GLuint* arrays) const {
+        if (mStateCache->vertexArray.known &&
+            std::find(arrays, arrays + n, mStateCache->vertexArray.value) != arrays + n) {
+            mStateCache->vertexArray.known = false;
+            mStateCache->buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+        OpenGLFunctionsBase::DeleteVertexArrays(n, arrays);
+    }
+
+    uint64_t OpenGLFunctions::GetSkippedStateChangeCount() const {
+        return mStateCache->skippedStateChangeCount;
+    }
+
 }}  // namespace dawn_native::opengl
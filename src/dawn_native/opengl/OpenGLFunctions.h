@@ -15,6 +15,7 @@
 #ifndef DAWNNATIVE_OPENGL_OPENGLFUNCTIONS_H_
 #define DAWNNATIVE_OPENGL_OPENGLFUNCTIONS_H_
 
+#include <memory>
 #include <unordered_set>
 
 #include "dawn_native/opengl/OpenGLFunctionsBase_autogen.h"
@@ -30,9 +31,47 @@ namespace dawn_native { namespace opengl {
 
         bool IsGLExtensionSupported(const char* extension) const;
 
+        // These hide the entry points of OpenGLFunctionsBase to shadow the state they set, and
+        // don't call the driver when the state already has the value being set. The shadowed
+        // state is shared by the copies of the OpenGLFunctions, like the GL context they use, so
+        // all the changes to this state must go through them.
+        void ActiveTexture(GLenum texture) const;
+        void BindBuffer(GLenum target, GLuint buffer) const;
+        void BindBufferBase(GLenum target, GLuint index, GLuint buffer) const;
+        void BindBufferRange(GLenum target,
+                             GLuint index,
+                             GLuint buffer,
+                             GLintptr offset,
+                             GLsizeiptr size) const;
+        void BindFramebuffer(GLenum target, GLuint framebuffer) const;
+        void BindSampler(GLuint unit, GLuint sampler) const;
+        void BindTexture(GLenum target, GLuint texture) const;
+        void BindVertexArray(GLuint array) const;
+        void BlendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) const;
+        void ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) const;
+        void ColorMaski(GLuint index, GLboolean r, GLboolean g, GLboolean b, GLboolean a) const;
+        void Scissor(GLint x, GLint y, GLsizei width, GLsizei height) const;
+        void UseProgram(GLuint program) const;
+        void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) const;
+        void ViewportIndexedf(GLuint index, GLfloat x, GLfloat y, GLfloat w, GLfloat h) const;
+
+        // Deleting objects unbinds them so the shadowed bindings are updated too.
+        void DeleteBuffers(GLsizei n, const GLuint* buffers) const;
+        void DeleteFramebuffers(GLsizei n, const GLuint* framebuffers) const;
+        void DeleteSamplers(GLsizei count, const GLuint* samplers) const;
+        void DeleteTextures(GLsizei n, const GLuint* textures) const;
+        void DeleteVertexArrays(GLsizei n, const GLuint* arrays) const;
+
+        // The number of calls above that weren't sent to the driver because they didn't change
+        // the state.
+        uint64_t GetSkippedStateChangeCount() const;
+
       private:
         void InitializeSupportedGLExtensions();
 
+        struct StateCache;
+        std::shared_ptr<StateCache> mStateCache;
+
         uint32_t mMajorVersion;
         uint32_t mMinorVersion;
 
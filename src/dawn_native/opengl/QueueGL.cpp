@@ -42,6 +42,10 @@ namespace dawn_native { namespace opengl {
                                       uint64_t bufferOffset,
                                       const void* data,
                                       size_t size) {
+        if (GetDevice()->IsToggleEnabled(Toggle::OpenGLUsePersistentlyMappedStaging)) {
+            return QueueBase::WriteBufferImpl(buffer, bufferOffset, data, size);
+        }
+
         const OpenGLFunctions& gl = ToBackend(GetDevice())->gl;
 
         ToBackend(buffer)->EnsureDataInitializedAsDestination(bufferOffset, size);
@@ -55,6 +59,9 @@ namespace dawn_native { namespace opengl {
                                        const void* data,
                                        const TextureDataLayout& dataLayout,
                                        const Extent3D& writeSizePixel) {
+        if (GetDevice()->IsToggleEnabled(Toggle::OpenGLUsePersistentlyMappedStaging)) {
+            return QueueBase::WriteTextureImpl(destination, data, dataLayout, writeSizePixel);
+        }
         return DAWN_UNIMPLEMENTED_ERROR("Unable to write to texture\n");
     }
 
@@ -0,0 +1,45 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_OPENGL_STAGINGBUFFERGL_H_
+#define DAWNNATIVE_OPENGL_STAGINGBUFFERGL_H_
+
+#include "dawn_native/StagingBuffer.h"
+
+#include "dawn_native/opengl/opengl_platform.h"
+
+namespace dawn_native { namespace opengl {
+
+    class Device;
+
+    // A buffer with immutable storage that stays mapped until it is destroyed. The mapping is
+    // coherent so data written to it is visible to the GL commands issued after the write
+    // without flushing or unmapping the buffer.
+    class StagingBuffer : public StagingBufferBase {
+      public:
+        StagingBuffer(size_t size, Device* device);
+        ~StagingBuffer() override;
+
+        GLuint GetHandle() const;
+
+        MaybeError Initialize() override;
+
+      private:
+        Device* mDevice;
+        GLuint mBuffer = 0;
+    };
+
+}}  // namespace dawn_native::opengl
+
+#endif  // DAWNNATIVE_OPENGL_STAGINGBUFFERGL_H_
@@ -17,9 +17,11 @@
 #include "common/Assert.h"
 #include "common/Constants.h"
 #include "common/Math.h"
+#include "dawn_native/DynamicUploader.h"
 #include "dawn_native/EnumMaskIterator.h"
 #include "dawn_native/opengl/BufferGL.h"
 #include "dawn_native/opengl/DeviceGL.h"
+#include "dawn_native/opengl/StagingBufferGL.h"
 #include "dawn_native/opengl/UtilsGL.h"
 
 namespace dawn_native { namespace opengl {
@@ -301,22 +303,35 @@ namespace dawn_native { namespace opengl {
                 clearColor = (clearValue == TextureBase::ClearValue::Zero) ? 0 : 255;
                 clearColorData.fill(clearColor);
 
+                auto NeedsClear = [&](uint32_t level, uint32_t layer) {
+                    // Skip lazy clears if already initialized.
+                    return clearValue != TextureBase::ClearValue::Zero ||
+                           !IsSubresourceContentInitialized(
+                               SubresourceRange::SingleMipAndLayer(level, layer, Aspect::Color));
+                };
+
                 const GLFormat& glFormat = GetGLFormat();
                 for (uint32_t level = range.baseMipLevel;
                      level < range.baseMipLevel + range.levelCount; ++level) {
                     Extent3D mipSize = GetMipLevelPhysicalSize(level);
-                    for (uint32_t layer = range.baseArrayLayer;
-                         layer < range.baseArrayLayer + range.layerCount; ++layer) {
-                        if (clearValue == TextureBase::ClearValue::Zero &&
-                            IsSubresourceContentInitialized(
-                                SubresourceRange::SingleMipAndLayer(level, layer, Aspect::Color))) {
-                            // Skip lazy clears if already initialized.
+                    uint32_t layer = range.baseArrayLayer;
+                    while (layer < range.baseArrayLayer + range.layerCount) {
+                        if (!NeedsClear(level, layer)) {
+                            ++layer;
                             continue;
                         }
+
+                        // Clear all the following layers that need a clear at once.
+                        uint32_t baseLayer = layer;
+                        do {
+                            ++layer;
+                        } while (layer < range.baseArrayLayer + range.layerCount &&
+                                 NeedsClear(level, layer));
+
                         gl.ClearTexSubImage(mHandle, static_cast<GLint>(level), 0, 0,
-                                            static_cast<GLint>(layer), mipSize.width,
-                                            mipSize.height, 1, glFormat.format, glFormat.type,
-                                            clearColorData.data());
+                                            static_cast<GLint>(baseLayer), mipSize.width,
+                                            mipSize.height, layer - baseLayer, glFormat.format,
+                                            glFormat.type, clearColorData.data());
                     }
                 }
             }
@@ -333,22 +348,42 @@ namespace dawn_native { namespace opengl {
             ASSERT(bytesPerRow % blockInfo.byteSize == 0);
             ASSERT(GetHeight() % blockInfo.height == 0);
 
-            dawn_native::BufferDescriptor descriptor = {};
-            descriptor.mappedAtCreation = true;
-            descriptor.usage = wgpu::BufferUsage::CopySrc;
-            descriptor.size = bytesPerRow * (GetHeight() / blockInfo.height);
-            if (descriptor.size > std::numeric_limits<uint32_t>::max()) {
+            uint64_t bufferSize = bytesPerRow * (GetHeight() / blockInfo.height);
+            if (bufferSize > std::numeric_limits<uint32_t>::max()) {
                 return DAWN_OUT_OF_MEMORY_ERROR("Unable to allocate buffer.");
             }
 
-            // We don't count the lazy clear of srcBuffer because it is an internal buffer.
-            // TODO(natlee@microsoft.com): use Dynamic Uploader here for temp buffer
+            // Fill a buffer with the clear color: a staging allocation when they are persistently
+            // mapped, or else a temporary internal buffer.
+            GLuint srcBufferHandle;
+            uint64_t srcBufferOffset = 0;
             Ref<Buffer> srcBuffer;
-            DAWN_TRY_ASSIGN(srcBuffer, Buffer::CreateInternalBuffer(device, &descriptor, false));
-
-            // Fill the buffer with clear color
-            memset(srcBuffer->GetMappedRange(0, descriptor.size), clearColor, descriptor.size);
-            srcBuffer->Unmap();
+            if (device->IsToggleEnabled(Toggle::OpenGLUsePersistentlyMappedStaging)) {
+                UploadHandle uploadHandle;
+                DAWN_TRY_ASSIGN(uploadHandle,
+                                device->GetDynamicUploader()->Allocate(
+                                    bufferSize, device->GetPendingCommandSerial(),
+                                    blockInfo.byteSize));
+                memset(uploadHandle.mappedBuffer, clearColor, bufferSize);
+                device->TrackStagingBufferUse();
+
+                srcBufferHandle = ToBackend(uploadHandle.stagingBuffer)->GetHandle();
+                srcBufferOffset = uploadHandle.startOffset;
+            } else {
+                dawn_native::BufferDescriptor descriptor = {};
+                descriptor.mappedAtCreation = true;
+                descriptor.usage = wgpu::BufferUsage::CopySrc;
+                descriptor.size = bufferSize;
+
+                // We don't count the lazy clear of srcBuffer because it is an internal buffer.
+                DAWN_TRY_ASSIGN(srcBuffer,
+                                Buffer::CreateInternalBuffer(device, &descriptor, false));
+                memset(srcBuffer->GetMappedRange(0, bufferSize), clearColor, bufferSize);
+                srcBuffer->Unmap();
+
+                srcBufferHandle = srcBuffer->GetHandle();
+            }
+            void* srcData = reinterpret_cast<void*>(static_cast<uintptr_t>(srcBufferOffset));
 
             // Bind buffer and texture, and make the buffer to texture copy
             gl.PixelStorei(GL_UNPACK_ROW_LENGTH,
@@ -356,7 +391,7 @@ namespace dawn_native { namespace opengl {
             gl.PixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
             for (uint32_t level = range.baseMipLevel; level < range.baseMipLevel + range.levelCount;
                  ++level) {
-                gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, srcBuffer->GetHandle());
+                gl.BindBuffer(GL_PIXEL_UNPACK_BUFFER, srcBufferHandle);
                 gl.ActiveTexture(GL_TEXTURE0);
                 gl.BindTexture(GetGLTarget(), GetHandle());
 
@@ -372,7 +407,7 @@ namespace dawn_native { namespace opengl {
                             }
                             gl.TexSubImage2D(GetGLTarget(), static_cast<GLint>(level), 0, 0,
                                              size.width, size.height, GetGLFormat().format,
-                                             GetGLFormat().type, 0);
+                                             GetGLFormat().type, srcData);
                         } else {
                             for (uint32_t layer = range.baseArrayLayer;
                                  layer < range.baseArrayLayer + range.layerCount; ++layer) {
@@ -385,7 +420,8 @@ namespace dawn_native { namespace opengl {
                                 }
                                 gl.TexSubImage3D(GetGLTarget(), static_cast<GLint>(level), 0, 0,
                                                  static_cast<GLint>(layer), size.width, size.height,
-                                                 1, GetGLFormat().format, GetGLFormat().type, 0);
+                                                 1, GetGLFormat().format, GetGLFormat().type,
+                                                 srcData);
                             }
                         }
                         break;
@@ -0,0 +1,162 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/BarrierBatch.h"
+
+#include "dawn_native/vulkan/BufferVk.h"
+#include "dawn_native/vulkan/CommandRecordingContext.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/TextureVk.h"
+
+namespace dawn_native { namespace vulkan {
+
+    namespace {
+
+        bool RangesOverlap(uint64_t startA, uint64_t sizeA, uint64_t startB, uint64_t sizeB) {
+            return startA < startB + sizeB && startB < startA + sizeA;
+        }
+
+        bool SubresourcesOverlap(const SubresourceRange& a, const SubresourceRange& b) {
+            return (a.aspects & b.aspects) != Aspect::None &&
+                   RangesOverlap(a.baseMipLevel, a.levelCount, b.baseMipLevel, b.levelCount) &&
+                   RangesOverlap(a.baseArrayLayer, a.layerCount, b.baseArrayLayer, b.layerCount);
+        }
+
+        bool SubresourcesEqual(const SubresourceRange& a, const SubresourceRange& b) {
+            return a.aspects == b.aspects && a.baseMipLevel == b.baseMipLevel &&
+                   a.levelCount == b.levelCount && a.baseArrayLayer == b.baseArrayLayer &&
+                   a.layerCount == b.layerCount;
+        }
+
+    }  // anonymous namespace
+
+    bool BarrierBatch::HasHazard(const Buffer* buffer,
+                                 wgpu::BufferUsage usage,
+                                 uint64_t offset,
+                                 uint64_t size) const {
+        bool isWrite = (usage & kReadOnlyBufferUsages) != usage;
+
+        for (const BufferAccess& access : mBufferAccesses) {
+            if (access.buffer != buffer) {
+                continue;
+            }
+
+            // Buffers are transitioned as a whole so they can have a single usage in the batch.
+            // Writes to the same bytes must be ordered by a barrier.
+            if (access.usage != usage ||
+                (isWrite && RangesOverlap(access.offset, access.size, offset, size))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void BarrierBatch::TransitionUsage(Buffer* buffer,
+                                       wgpu::BufferUsage usage,
+                                       uint64_t offset,
+                                       uint64_t size) {
+        ASSERT(!HasHazard(buffer, usage, offset, size));
+
+        bool alreadyTransitioned = false;
+        for (const BufferAccess& access : mBufferAccesses) {
+            if (access.buffer == buffer) {
+                alreadyTransitioned = true;
+                break;
+            }
+        }
+        mBufferAccesses.push_back({buffer, usage, offset, size});
+
+        // Transitioning the buffer again would add a write-after-write barrier for the disjoint
+        // writes of the batch.
+        if (alreadyTransitioned) {
+            return;
+        }
+
+        VkBufferMemoryBarrier barrier;
+        if (buffer->TransitionUsageAndGetResourceBarrier(usage, &barrier, &mSrcStages,
+                                                         &mDstStages)) {
+            mBufferBarriers.push_back(barrier);
+        }
+    }
+
+    bool BarrierBatch::HasHazard(const Texture* texture,
+                                 wgpu::TextureUsage usage,
+                                 const SubresourceRange& range,
+                                 const Origin3D& origin,
+                                 const Extent3D& extent) const {
+        bool isWrite = (usage & kReadOnlyTextureUsages) != usage;
+
+        for (const TextureAccess& access : mTextureAccesses) {
+            if (access.texture != texture || !SubresourcesOverlap(access.range, range)) {
+                continue;
+            }
+
+            // The subresources shared with another access must be in the same layout, and come
+            // from the same barrier so that there aren't two barriers for them in the batch.
+            if (access.usage != usage || !SubresourcesEqual(access.range, range)) {
+                return true;
+            }
+
+            if (isWrite && RangesOverlap(access.origin.x, access.extent.width, origin.x,
+                                         extent.width) &&
+                RangesOverlap(access.origin.y, access.extent.height, origin.y, extent.height)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void BarrierBatch::TransitionUsage(CommandRecordingContext* recordingContext,
+                                       Texture* texture,
+                                       wgpu::TextureUsage usage,
+                                       const SubresourceRange& range,
+                                       const Origin3D& origin,
+                                       const Extent3D& extent) {
+        ASSERT(!HasHazard(texture, usage, range, origin, extent));
+
+        bool alreadyTransitioned = false;
+        for (const TextureAccess& access : mTextureAccesses) {
+            if (access.texture == texture && SubresourcesEqual(access.range, range)) {
+                alreadyTransitioned = true;
+                break;
+            }
+        }
+        mTextureAccesses.push_back({texture, usage, range, origin, extent});
+
+        if (alreadyTransitioned) {
+            return;
+        }
+
+        texture->TransitionUsageAndGetResourceBarrier(recordingContext, usage, range,
+                                                      &mImageBarriers, &mSrcStages, &mDstStages);
+    }
+
+    void BarrierBatch::RecordBarriers(Device* device, CommandRecordingContext* recordingContext) {
+        if (!mBufferBarriers.empty() || !mImageBarriers.empty()) {
+            ASSERT(mSrcStages != 0 && mDstStages != 0);
+            device->fn.CmdPipelineBarrier(recordingContext->commandBuffer, mSrcStages, mDstStages,
+                                          0, 0, nullptr, mBufferBarriers.size(),
+                                          mBufferBarriers.data(), mImageBarriers.size(),
+                                          mImageBarriers.data());
+        }
+
+        mBufferAccesses.clear();
+        mTextureAccesses.clear();
+        mBufferBarriers.clear();
+        mImageBarriers.clear();
+        mSrcStages = 0;
+        mDstStages = 0;
+    }
+
+}}  // namespace dawn_native::vulkan
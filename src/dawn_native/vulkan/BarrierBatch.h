@@ -0,0 +1,91 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_BARRIERBATCH_H_
+#define DAWNNATIVE_VULKAN_BARRIERBATCH_H_
+
+#include "common/vulkan_platform.h"
+#include "dawn_native/Texture.h"
+#include "dawn_native/dawn_platform.h"
+
+#include <vector>
+
+namespace dawn_native { namespace vulkan {
+
+    class Buffer;
+    struct CommandRecordingContext;
+    class Device;
+    class Texture;
+
+    // Gathers the barriers of a run of transfer commands so that they are recorded with a single
+    // vkCmdPipelineBarrier before the first command of the run. Commands that need a barrier
+    // between them, like a copy reading what a previous copy of the run wrote, can't be part of
+    // the same run: HasHazard returns true for their accesses and the run must end before them.
+    class BarrierBatch {
+      public:
+        // The bytes [offset, offset + size) of the buffer are accessed as |usage|.
+        bool HasHazard(const Buffer* buffer,
+                       wgpu::BufferUsage usage,
+                       uint64_t offset,
+                       uint64_t size) const;
+        void TransitionUsage(Buffer* buffer,
+                             wgpu::BufferUsage usage,
+                             uint64_t offset,
+                             uint64_t size);
+
+        // The texels [origin, origin + extent) of each subresource of |range| are accessed as
+        // |usage|. The depth of the origin and extent is ignored, the array layers are in |range|.
+        bool HasHazard(const Texture* texture,
+                       wgpu::TextureUsage usage,
+                       const SubresourceRange& range,
+                       const Origin3D& origin,
+                       const Extent3D& extent) const;
+        void TransitionUsage(CommandRecordingContext* recordingContext,
+                             Texture* texture,
+                             wgpu::TextureUsage usage,
+                             const SubresourceRange& range,
+                             const Origin3D& origin,
+                             const Extent3D& extent);
+
+        // Records the barriers gathered so far, if any, and empties the batch.
+        void RecordBarriers(Device* device, CommandRecordingContext* recordingContext);
+
+      private:
+        struct BufferAccess {
+            const Buffer* buffer;
+            wgpu::BufferUsage usage;
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct TextureAccess {
+            const Texture* texture;
+            wgpu::TextureUsage usage;
+            SubresourceRange range;
+            Origin3D origin;
+            Extent3D extent;
+        };
+
+        std::vector<BufferAccess> mBufferAccesses;
+        std::vector<TextureAccess> mTextureAccesses;
+
+        std::vector<VkBufferMemoryBarrier> mBufferBarriers;
+        std::vector<VkImageMemoryBarrier> mImageBarriers;
+        VkPipelineStageFlags mSrcStages = 0;
+        VkPipelineStageFlags mDstStages = 0;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_BARRIERBATCH_H_
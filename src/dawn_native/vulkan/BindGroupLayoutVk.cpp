@@ -116,7 +116,7 @@ namespace dawn_native { namespace vulkan {
                                 "CreateDescriptorSetLayout"));
 
         // Compute the size of descriptor pools used for this layout.
-        std::map<VkDescriptorType, uint32_t> descriptorCountPerType;
+        DescriptorCountPerType descriptorCountPerType;
 
         for (BindingIndex bindingIndex{0}; bindingIndex < GetBindingCount(); ++bindingIndex) {
             const BindingInfo& bindingInfo = GetBindingInfo(bindingIndex);
@@ -127,10 +127,8 @@ namespace dawn_native { namespace vulkan {
             descriptorCountPerType[vulkanType]++;
         }
 
-        // TODO(enga): Consider deduping allocators for layouts with the same descriptor type
-        // counts.
         mDescriptorSetAllocator =
-            std::make_unique<DescriptorSetAllocator>(this, std::move(descriptorCountPerType));
+            std::make_unique<DescriptorSetAllocator>(this, descriptorCountPerType);
         return {};
     }
 
@@ -159,18 +157,24 @@ namespace dawn_native { namespace vulkan {
         return mHandle;
     }
 
-    ResultOrError<BindGroup*> BindGroupLayout::AllocateBindGroup(
-        Device* device,
-        const BindGroupDescriptor* descriptor) {
-        DescriptorSetAllocation descriptorSetAllocation;
-        DAWN_TRY_ASSIGN(descriptorSetAllocation, mDescriptorSetAllocator->Allocate());
+    BindGroup* BindGroupLayout::AllocateBindGroup(Device* device,
+                                                  const BindGroupDescriptor* descriptor) {
+        return mBindGroupAllocator.Allocate(device, descriptor);
+    }
 
-        return mBindGroupAllocator.Allocate(device, descriptor, descriptorSetAllocation);
+    ResultOrError<DescriptorSetAllocation> BindGroupLayout::AllocateDescriptorSet(
+        const DescriptorSetContent& content,
+        bool* needsWrite) {
+        return mDescriptorSetAllocator->Allocate(content, needsWrite);
     }
 
     void BindGroupLayout::DeallocateBindGroup(BindGroup* bindGroup,
                                               DescriptorSetAllocation* descriptorSetAllocation) {
-        mDescriptorSetAllocator->Deallocate(descriptorSetAllocation);
+        // The set is missing if the bind group failed to initialize.
+        if (descriptorSetAllocation->set != VK_NULL_HANDLE) {
+            mDescriptorSetAllocator->Deallocate(descriptorSetAllocation,
+                                                bindGroup->ComputeDescriptorSetContent());
+        }
         mBindGroupAllocator.Deallocate(bindGroup);
     }
 
@@ -178,4 +182,8 @@ namespace dawn_native { namespace vulkan {
         mDescriptorSetAllocator->FinishDeallocation(completedSerial);
     }
 
+    size_t BindGroupLayout::GetBindGroupAllocatorBytes() const {
+        return mBindGroupAllocator.GetAllocatedBytes();
+    }
+
 }}  // namespace dawn_native::vulkan
@@ -19,14 +19,13 @@
 
 #include "common/SlabAllocator.h"
 #include "common/vulkan_platform.h"
+#include "dawn_native/vulkan/DescriptorSetAllocator.h"
 
 #include <vector>
 
 namespace dawn_native { namespace vulkan {
 
     class BindGroup;
-    struct DescriptorSetAllocation;
-    class DescriptorSetAllocator;
     class Device;
 
     VkDescriptorType VulkanDescriptorType(wgpu::BindingType type, bool isDynamic);
@@ -39,10 +38,10 @@ namespace dawn_native { namespace vulkan {
     // VkDescriptorSets for its bindgroups, the layout also acts as an allocator for the descriptor
     // sets.
     //
-    // The allocations is done with one pool per descriptor set, which is inefficient, but at least
-    // the pools are reused when no longer used. Minimizing the number of descriptor pool allocation
-    // is important because creating them can incur GPU memory allocation which is usually an
-    // expensive syscall.
+    // The sets are allocated from pools shared by all the layouts with the same number of
+    // descriptors of each type, see DescriptorPoolManager. Minimizing the number of descriptor
+    // pool allocation is important because creating them can incur GPU memory allocation which
+    // is usually an expensive syscall.
     class BindGroupLayout final : public BindGroupLayoutBase {
       public:
         static ResultOrError<BindGroupLayout*> Create(Device* device,
@@ -52,12 +51,17 @@ namespace dawn_native { namespace vulkan {
 
         VkDescriptorSetLayout GetHandle() const;
 
-        ResultOrError<BindGroup*> AllocateBindGroup(Device* device,
-                                                    const BindGroupDescriptor* descriptor);
+        BindGroup* AllocateBindGroup(Device* device, const BindGroupDescriptor* descriptor);
+        // |needsWrite| is set to false when the set already contains the descriptors of |content|.
+        ResultOrError<DescriptorSetAllocation> AllocateDescriptorSet(
+            const DescriptorSetContent& content,
+            bool* needsWrite);
         void DeallocateBindGroup(BindGroup* bindGroup,
                                  DescriptorSetAllocation* descriptorSetAllocation);
         void FinishDeallocation(ExecutionSerial completedSerial);
 
+        size_t GetBindGroupAllocatorBytes() const override;
+
       private:
         ~BindGroupLayout() override;
         MaybeError Initialize();
@@ -29,14 +29,66 @@ namespace dawn_native { namespace vulkan {
     // static
     ResultOrError<BindGroup*> BindGroup::Create(Device* device,
                                                 const BindGroupDescriptor* descriptor) {
-        return ToBackend(descriptor->layout)->AllocateBindGroup(device, descriptor);
+        Ref<BindGroup> bindGroup =
+            AcquireRef(ToBackend(descriptor->layout)->AllocateBindGroup(device, descriptor));
+        DAWN_TRY(bindGroup->Initialize());
+        return bindGroup.Detach();
     }
 
-    BindGroup::BindGroup(Device* device,
-                         const BindGroupDescriptor* descriptor,
-                         DescriptorSetAllocation descriptorSetAllocation)
-        : BindGroupBase(this, device, descriptor),
-          mDescriptorSetAllocation(descriptorSetAllocation) {
+    BindGroup::BindGroup(Device* device, const BindGroupDescriptor* descriptor)
+        : BindGroupBase(this, device, descriptor) {
+    }
+
+    MaybeError BindGroup::Initialize() {
+        bool needsWrite = true;
+        DAWN_TRY_ASSIGN(mDescriptorSetAllocation,
+                        ToBackend(GetLayout())
+                            ->AllocateDescriptorSet(ComputeDescriptorSetContent(), &needsWrite));
+        if (needsWrite) {
+            WriteDescriptorSet();
+        }
+        return {};
+    }
+
+    DescriptorSetContent BindGroup::ComputeDescriptorSetContent() {
+        const BindGroupLayout* layout = ToBackend(GetLayout());
+        DescriptorSetContent content;
+        content.reserve(3 * static_cast<uint32_t>(layout->GetBindingCount()));
+
+        for (BindingIndex bindingIndex{0}; bindingIndex < layout->GetBindingCount();
+             ++bindingIndex) {
+            switch (layout->GetBindingInfo(bindingIndex).type) {
+                case wgpu::BindingType::UniformBuffer:
+                case wgpu::BindingType::StorageBuffer:
+                case wgpu::BindingType::ReadonlyStorageBuffer: {
+                    BufferBinding binding = GetBindingAsBufferBinding(bindingIndex);
+                    content.push_back(ToBackend(binding.buffer)->GetDescriptorId());
+                    content.push_back(binding.offset);
+                    content.push_back(binding.size);
+                    break;
+                }
+
+                case wgpu::BindingType::Sampler:
+                case wgpu::BindingType::ComparisonSampler:
+                    content.push_back(ToBackend(GetBindingAsSampler(bindingIndex))
+                                          ->GetDescriptorId());
+                    break;
+
+                case wgpu::BindingType::SampledTexture:
+                case wgpu::BindingType::MultisampledTexture:
+                case wgpu::BindingType::ReadonlyStorageTexture:
+                case wgpu::BindingType::WriteonlyStorageTexture:
+                    content.push_back(ToBackend(GetBindingAsTextureView(bindingIndex))
+                                          ->GetDescriptorId());
+                    break;
+            }
+        }
+        return content;
+    }
+
+    void BindGroup::WriteDescriptorSet() {
+        Device* device = ToBackend(GetDevice());
+
         // Now do a write of a single descriptor set with all possible chained data allocated on the
         // stack.
         const uint32_t bindingCount = static_cast<uint32_t>((GetLayout()->GetBindingCount()));
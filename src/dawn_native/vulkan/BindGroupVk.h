@@ -21,6 +21,7 @@
 #include "common/vulkan_platform.h"
 #include "dawn_native/vulkan/BindGroupLayoutVk.h"
 #include "dawn_native/vulkan/DescriptorSetAllocation.h"
+#include "dawn_native/vulkan/DescriptorSetAllocator.h"
 
 namespace dawn_native { namespace vulkan {
 
@@ -31,17 +32,23 @@ namespace dawn_native { namespace vulkan {
         static ResultOrError<BindGroup*> Create(Device* device,
                                                 const BindGroupDescriptor* descriptor);
 
-        BindGroup(Device* device,
-                  const BindGroupDescriptor* descriptor,
-                  DescriptorSetAllocation descriptorSetAllocation);
+        BindGroup(Device* device, const BindGroupDescriptor* descriptor);
+
+        // Gets a descriptor set for the bind group and writes the descriptors in it, unless it
+        // already contains them.
+        MaybeError Initialize();
 
         VkDescriptorSet GetHandle() const;
 
+        DescriptorSetContent ComputeDescriptorSetContent();
+
       private:
         ~BindGroup() override;
 
-        // The descriptor set in this allocation outlives the BindGroup because it is owned by
-        // the BindGroupLayout which is referenced by the BindGroup.
+        void WriteDescriptorSet();
+
+        // The descriptor set in this allocation is given back to the BindGroupLayout when the
+        // BindGroup is destroyed, so that it can be reused by bind groups with the same content.
         DescriptorSetAllocation mDescriptorSetAllocation;
     };
 
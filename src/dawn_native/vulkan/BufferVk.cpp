@@ -136,6 +136,8 @@ namespace dawn_native { namespace vulkan {
     }
 
     MaybeError Buffer::Initialize(bool mappedAtCreation) {
+        mDescriptorId = ToBackend(GetDevice())->AcquireDescriptorResourceId();
+
         // Avoid passing ludicrously large sizes to drivers because it causes issues: drivers add
         // some constants to the size passed and align it, but for values close to the maximum
         // VkDeviceSize this can cause overflows and makes drivers crash or return bad sizes in the
@@ -196,6 +198,10 @@ namespace dawn_native { namespace vulkan {
         return mHandle;
     }
 
+    uint64_t Buffer::GetDescriptorId() const {
+        return mDescriptorId;
+    }
+
     void Buffer::TransitionUsageNow(CommandRecordingContext* recordingContext,
                                     wgpu::BufferUsage usage) {
         VkBufferMemoryBarrier barrier;
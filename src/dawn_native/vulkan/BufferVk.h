@@ -32,6 +32,8 @@ namespace dawn_native { namespace vulkan {
                                                  const BufferDescriptor* descriptor);
 
         VkBuffer GetHandle() const;
+        // Identifies the buffer in the descriptor sets, see DescriptorSetContent.
+        uint64_t GetDescriptorId() const;
 
         // Transitions the buffer to be used as `usage`, recording any necessary barrier in
         // `commands`.
@@ -64,6 +66,7 @@ namespace dawn_native { namespace vulkan {
         void* GetMappedPointerImpl() override;
 
         VkBuffer mHandle = VK_NULL_HANDLE;
+        uint64_t mDescriptorId = 0;
         ResourceMemoryAllocation mMemoryAllocation;
 
         wgpu::BufferUsage mLastUsage = wgpu::BufferUsage::None;
@@ -20,9 +20,12 @@
 #include "dawn_native/Commands.h"
 #include "dawn_native/EnumMaskIterator.h"
 #include "dawn_native/RenderBundle.h"
+#include "dawn_native/ScratchBufferAllocator.h"
+#include "dawn_native/vulkan/BarrierBatch.h"
 #include "dawn_native/vulkan/BindGroupVk.h"
 #include "dawn_native/vulkan/BufferVk.h"
 #include "dawn_native/vulkan/CommandRecordingContext.h"
+#include "dawn_native/vulkan/CommandRecordingWorkers.h"
 #include "dawn_native/vulkan/ComputePipelineVk.h"
 #include "dawn_native/vulkan/DeviceVk.h"
 #include "dawn_native/vulkan/FencedDeleter.h"
@@ -124,10 +127,8 @@ namespace dawn_native { namespace vulkan {
           public:
             RenderDescriptorSetTracker() = default;
 
-            void Apply(Device* device,
-                       CommandRecordingContext* recordingContext,
-                       VkPipelineBindPoint bindPoint) {
-                ApplyDescriptorSets(device, recordingContext->commandBuffer, bindPoint,
+            void Apply(Device* device, VkCommandBuffer commands, VkPipelineBindPoint bindPoint) {
+                ApplyDescriptorSets(device, commands, bindPoint,
                                     ToBackend(mPipelineLayout)->GetHandle(),
                                     mDirtyBindGroupsObjectChangedOrIsDynamic, mBindGroups,
                                     mDynamicOffsetCounts, mDynamicOffsets);
@@ -259,9 +260,12 @@ namespace dawn_native { namespace vulkan {
             VkDeviceSize mOffset;
         };
 
+        // |inheritanceInfo| is set for the secondary command buffers executed in the render pass.
         MaybeError RecordBeginRenderPass(CommandRecordingContext* recordingContext,
                                          Device* device,
-                                         BeginRenderPassCmd* renderPass) {
+                                         BeginRenderPassCmd* renderPass,
+                                         VkSubpassContents contents,
+                                         VkCommandBufferInheritanceInfo* inheritanceInfo) {
             VkCommandBuffer commands = recordingContext->commandBuffer;
 
             // Query a VkRenderPass from the cache
@@ -399,7 +403,16 @@ namespace dawn_native { namespace vulkan {
             beginInfo.clearValueCount = attachmentCount;
             beginInfo.pClearValues = clearValues.data();
 
-            device->fn.CmdBeginRenderPass(commands, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            device->fn.CmdBeginRenderPass(commands, &beginInfo, contents);
+
+            inheritanceInfo->sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritanceInfo->pNext = nullptr;
+            inheritanceInfo->renderPass = renderPassVK;
+            inheritanceInfo->subpass = 0;
+            inheritanceInfo->framebuffer = framebuffer;
+            inheritanceInfo->occlusionQueryEnable = VK_FALSE;
+            inheritanceInfo->queryFlags = 0;
+            inheritanceInfo->pipelineStatistics = 0;
 
             return {};
         }
@@ -414,90 +427,554 @@ namespace dawn_native { namespace vulkan {
             }
         }
 
-        void RecordWriteTimestampCmd(CommandRecordingContext* recordingContext,
+        void RecordWriteTimestampCmd(VkCommandBuffer commands,
                                      Device* device,
                                      WriteTimestampCmd* cmd) {
-            VkCommandBuffer commands = recordingContext->commandBuffer;
             QuerySet* querySet = ToBackend(cmd->querySet.Get());
 
             device->fn.CmdWriteTimestamp(commands, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                          querySet->GetHandle(), cmd->queryIndex);
         }
-    }  // anonymous namespace
 
-    // static
-    CommandBuffer* CommandBuffer::Create(CommandEncoder* encoder,
-                                         const CommandBufferDescriptor* descriptor) {
-        return new CommandBuffer(encoder, descriptor);
-    }
+        VkDebugMarkerMarkerInfoEXT GetDebugMarkerInfo(const char* label) {
+            VkDebugMarkerMarkerInfoEXT markerInfo;
+            markerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
+            markerInfo.pNext = nullptr;
+            markerInfo.pMarkerName = label;
+            // Default color to black
+            markerInfo.color[0] = 0.0;
+            markerInfo.color[1] = 0.0;
+            markerInfo.color[2] = 0.0;
+            markerInfo.color[3] = 1.0;
+            return markerInfo;
+        }
 
-    CommandBuffer::CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor)
-        : CommandBufferBase(encoder, descriptor) {
-    }
+        void RecordInsertDebugMarker(Device* device, VkCommandBuffer commands, const char* label) {
+            if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
+                VkDebugMarkerMarkerInfoEXT markerInfo = GetDebugMarkerInfo(label);
+                device->fn.CmdDebugMarkerInsertEXT(commands, &markerInfo);
+            }
+        }
 
-    void CommandBuffer::RecordCopyImageWithTemporaryBuffer(
-        CommandRecordingContext* recordingContext,
-        const TextureCopy& srcCopy,
-        const TextureCopy& dstCopy,
-        const Extent3D& copySize) {
-        ASSERT(srcCopy.texture->GetFormat().format == dstCopy.texture->GetFormat().format);
-        ASSERT(srcCopy.aspect == dstCopy.aspect);
-        dawn_native::Format format = srcCopy.texture->GetFormat();
-        const TexelBlockInfo& blockInfo = format.GetAspectInfo(srcCopy.aspect).block;
-        ASSERT(copySize.width % blockInfo.width == 0);
-        uint32_t widthInBlocks = copySize.width / blockInfo.width;
-        ASSERT(copySize.height % blockInfo.height == 0);
-        uint32_t heightInBlocks = copySize.height / blockInfo.height;
-
-        // Create the temporary buffer. Note that We don't need to respect WebGPU's 256 alignment
-        // because it isn't a hard constraint in Vulkan.
-        uint64_t tempBufferSize = widthInBlocks * heightInBlocks * blockInfo.byteSize;
-        BufferDescriptor tempBufferDescriptor;
-        tempBufferDescriptor.size = tempBufferSize;
-        tempBufferDescriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+        void RecordPushDebugGroup(Device* device, VkCommandBuffer commands, const char* label) {
+            if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
+                VkDebugMarkerMarkerInfoEXT markerInfo = GetDebugMarkerInfo(label);
+                device->fn.CmdDebugMarkerBeginEXT(commands, &markerInfo);
+            }
+        }
 
-        Device* device = ToBackend(GetDevice());
-        Ref<Buffer> tempBuffer = AcquireRef(ToBackend(device->CreateBuffer(&tempBufferDescriptor)));
+        void RecordPopDebugGroup(Device* device, VkCommandBuffer commands) {
+            if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
+                device->fn.CmdDebugMarkerEndEXT(commands);
+            }
+        }
 
-        BufferCopy tempBufferCopy;
-        tempBufferCopy.buffer = tempBuffer.Get();
-        tempBufferCopy.rowsPerImage = heightInBlocks;
-        tempBufferCopy.offset = 0;
-        tempBufferCopy.bytesPerRow = copySize.width / blockInfo.width * blockInfo.byteSize;
+        // Copies are batched until one has a hazard with the previous ones, or this many copies
+        // were batched to bound the cost of looking for hazards.
+        constexpr size_t kMaxBatchedCopies = 256;
 
-        VkCommandBuffer commands = recordingContext->commandBuffer;
-        VkImage srcImage = ToBackend(srcCopy.texture)->GetHandle();
-        VkImage dstImage = ToBackend(dstCopy.texture)->GetHandle();
+        bool IsCopyCommand(Command type) {
+            switch (type) {
+                case Command::CopyBufferToBuffer:
+                case Command::CopyBufferToTexture:
+                case Command::CopyTextureToBuffer:
+                case Command::CopyTextureToTexture:
+                    return true;
+                default:
+                    return false;
+            }
+        }
 
-        tempBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
-        VkBufferImageCopy srcToTempBufferRegion =
-            ComputeBufferImageCopyRegion(tempBufferCopy, srcCopy, copySize);
+        uint64_t GetBufferSizeAffectedByCopy(const BufferCopy& bufferCopy,
+                                             const TextureCopy& textureCopy,
+                                             const Extent3D& copySize) {
+            const TexelBlockInfo& blockInfo =
+                textureCopy.texture->GetFormat().GetAspectInfo(textureCopy.aspect).block;
+            // The copy was validated so the computation can't fail.
+            return ComputeRequiredBytesInCopy(blockInfo, copySize, bufferCopy.bytesPerRow,
+                                              bufferCopy.rowsPerImage)
+                .AcquireSuccess();
+        }
 
-        // The Dawn CopySrc usage is always mapped to GENERAL
-        device->fn.CmdCopyImageToBuffer(commands, srcImage, VK_IMAGE_LAYOUT_GENERAL,
-                                        tempBuffer->GetHandle(), 1, &srcToTempBufferRegion);
+        // Render passes are split in chunks of about this many commands when they are recorded in
+        // parallel. The passes with a single chunk are recorded directly in the primary command
+        // buffer.
+        constexpr uint32_t kCommandsPerRenderPassChunk = 256;
+
+        // The state set by the commands before a chunk of a render pass. Secondary command buffers
+        // don't inherit any state so each chunk sets it again. The commands are alive until the
+        // command buffer is destroyed so they are referenced directly.
+        struct RenderPassState {
+            SetRenderPipelineCmd* pipeline = nullptr;
+            ityp::array<BindGroupIndex, SetBindGroupCmd*, kMaxBindGroups> bindGroups = {};
+            ityp::array<BindGroupIndex, uint32_t*, kMaxBindGroups> dynamicOffsets = {};
+            SetIndexBufferCmd* indexBuffer = nullptr;
+            ityp::array<VertexBufferSlot, SetVertexBufferCmd*, kMaxVertexBuffers> vertexBuffers =
+                {};
+
+            SetBlendColorCmd* blendColor = nullptr;
+            SetStencilReferenceCmd* stencilReference = nullptr;
+            SetViewportCmd* viewport = nullptr;
+            SetScissorRectCmd* scissorRect = nullptr;
+        };
 
-        tempBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopySrc);
-        VkBufferImageCopy tempBufferToDstRegion =
-            ComputeBufferImageCopyRegion(tempBufferCopy, dstCopy, copySize);
+        struct RenderPassChunk {
+            CommandIterator::Position start;
+            uint32_t commandCount;
+            RenderPassState state;
+        };
 
-        // Dawn guarantees dstImage be in the TRANSFER_DST_OPTIMAL layout after the
-        // copy command.
-        device->fn.CmdCopyBufferToImage(commands, tempBuffer->GetHandle(), dstImage,
-                                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                                        &tempBufferToDstRegion);
+        // The visitor of SplitRenderPass for the commands other than EndRenderPass. It tracks the
+        // state set by the commands, and returns the size of each command in the chunk. Draws in
+        // MultiDraws count as separate commands. Bundles count as a single command since knowing
+        // their size would require reading them.
+        class RenderPassSplitter {
+          public:
+            const RenderPassState& GetState() const {
+                return mState;
+            }
 
-        recordingContext->tempBuffers.emplace_back(tempBuffer);
-    }
+            uint32_t GetDebugGroupDepth() const {
+                return mDebugGroupDepth;
+            }
 
-    MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* recordingContext) {
-        Device* device = ToBackend(GetDevice());
-        VkCommandBuffer commands = recordingContext->commandBuffer;
+            template <typename T, typename D>
+            uint32_t operator()(T*, D*) {
+                return 1;
+            }
+
+            uint32_t operator()(SetRenderPipelineCmd* cmd,
+                                CommandData<SetRenderPipelineCmd>::Type*) {
+                mState.pipeline = cmd;
+                return 1;
+            }
+
+            uint32_t operator()(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                mState.bindGroups[cmd->index] = cmd;
+                mState.dynamicOffsets[cmd->index] =
+                    cmd->dynamicOffsetCount > 0 ? dynamicOffsets : nullptr;
+                return 1;
+            }
+
+            uint32_t operator()(SetIndexBufferCmd* cmd, CommandData<SetIndexBufferCmd>::Type*) {
+                mState.indexBuffer = cmd;
+                return 1;
+            }
+
+            uint32_t operator()(SetVertexBufferCmd* cmd, CommandData<SetVertexBufferCmd>::Type*) {
+                mState.vertexBuffers[cmd->slot] = cmd;
+                return 1;
+            }
+
+            uint32_t operator()(SetBlendColorCmd* cmd, CommandData<SetBlendColorCmd>::Type*) {
+                mState.blendColor = cmd;
+                return 1;
+            }
+
+            uint32_t operator()(SetStencilReferenceCmd* cmd,
+                                CommandData<SetStencilReferenceCmd>::Type*) {
+                mState.stencilReference = cmd;
+                return 1;
+            }
+
+            uint32_t operator()(SetViewportCmd* cmd, CommandData<SetViewportCmd>::Type*) {
+                mState.viewport = cmd;
+                return 1;
+            }
+
+            uint32_t operator()(SetScissorRectCmd* cmd, CommandData<SetScissorRectCmd>::Type*) {
+                mState.scissorRect = cmd;
+                return 1;
+            }
+
+            uint32_t operator()(MultiDrawCmd* cmd, DrawCmd*) {
+                return cmd->drawCount;
+            }
+
+            uint32_t operator()(MultiDrawIndexedCmd* cmd, DrawIndexedCmd*) {
+                return cmd->drawCount;
+            }
+
+            uint32_t operator()(ExecuteBundlesCmd* cmd, Ref<RenderBundleBase>*) {
+                // Executing bundles resets the state set by the pass encoder, except the dynamic
+                // state that bundles can't set.
+                if (cmd->count > 0) {
+                    mState.pipeline = nullptr;
+                    mState.bindGroups = {};
+                    mState.dynamicOffsets = {};
+                    mState.indexBuffer = nullptr;
+                    mState.vertexBuffers = {};
+                }
+                return cmd->count;
+            }
+
+            uint32_t operator()(PushDebugGroupCmd*, char*) {
+                mDebugGroupDepth++;
+                return 1;
+            }
+
+            uint32_t operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                ASSERT(mDebugGroupDepth > 0);
+                mDebugGroupDepth--;
+                return 1;
+            }
+
+          private:
+            RenderPassState mState;
+            uint32_t mDebugGroupDepth = 0;
+        };
+
+        // Reads the commands of the render pass up to and including EndRenderPass, and splits them
+        // in chunks. Chunks only end outside of debug groups because the debug markers of
+        // secondary command buffers must be balanced.
+        std::vector<RenderPassChunk> SplitRenderPass(CommandIterator* commands) {
+            std::vector<RenderPassChunk> chunks;
+            RenderPassSplitter splitter;
+            uint32_t chunkSize = 0;
+
+            chunks.push_back({commands->GetPosition(), 0, splitter.GetState()});
+
+            Command type;
+            while (commands->NextCommandId(&type)) {
+                if (type == Command::EndRenderPass) {
+                    commands->NextCommand<EndRenderPassCmd>();
+                    if (chunks.back().commandCount == 0) {
+                        chunks.pop_back();
+                    }
+                    return chunks;
+                }
+
+                chunks.back().commandCount++;
+                chunkSize += VisitCommand(commands, type, splitter);
+                if (chunkSize >= kCommandsPerRenderPassChunk &&
+                    splitter.GetDebugGroupDepth() == 0) {
+                    chunks.push_back({commands->GetPosition(), 0, splitter.GetState()});
+                    chunkSize = 0;
+                }
+            }
+
+            // EndRenderPass should have been called
+            UNREACHABLE();
+        }
+
+        // Records the commands of a render pass in the primary command buffer, or the commands of
+        // a chunk of a render pass in a secondary command buffer.
+        class RenderPassRecorder {
+          public:
+            RenderPassRecorder(Device* device, VkCommandBuffer commands)
+                : mDevice(device), mCommands(commands) {
+            }
+
+            // Sets the dynamic state to its default value for the render pass.
+            void RecordDefaultDynamicState(const BeginRenderPassCmd* renderPass) {
+                mDevice->fn.CmdSetLineWidth(mCommands, 1.0f);
+                mDevice->fn.CmdSetDepthBounds(mCommands, 0.0f, 1.0f);
+
+                mDevice->fn.CmdSetStencilReference(mCommands, VK_STENCIL_FRONT_AND_BACK, 0);
+
+                float blendConstants[4] = {
+                    0.0f,
+                    0.0f,
+                    0.0f,
+                    0.0f,
+                };
+                mDevice->fn.CmdSetBlendConstants(mCommands, blendConstants);
+
+                // The viewport and scissor default to cover all of the attachments
+                VkViewport viewport;
+                viewport.x = 0.0f;
+                viewport.y = static_cast<float>(renderPass->height);
+                viewport.width = static_cast<float>(renderPass->width);
+                viewport.height = -static_cast<float>(renderPass->height);
+                viewport.minDepth = 0.0f;
+                viewport.maxDepth = 1.0f;
+                mDevice->fn.CmdSetViewport(mCommands, 0, 1, &viewport);
+
+                VkRect2D scissorRect;
+                scissorRect.offset.x = 0;
+                scissorRect.offset.y = 0;
+                scissorRect.extent.width = renderPass->width;
+                scissorRect.extent.height = renderPass->height;
+                mDevice->fn.CmdSetScissor(mCommands, 0, 1, &scissorRect);
+            }
+
+            // Sets the state in effect at the start of a chunk of the render pass.
+            void RecordState(const BeginRenderPassCmd* renderPass, const RenderPassState& state) {
+                RecordDefaultDynamicState(renderPass);
+                if (state.blendColor != nullptr) {
+                    RecordSetBlendColor(state.blendColor);
+                }
+                if (state.stencilReference != nullptr) {
+                    RecordSetStencilReference(state.stencilReference);
+                }
+                if (state.viewport != nullptr) {
+                    RecordSetViewport(state.viewport);
+                }
+                if (state.scissorRect != nullptr) {
+                    RecordSetScissorRect(state.scissorRect);
+                }
+
+                if (state.pipeline != nullptr) {
+                    RecordSetRenderPipeline(state.pipeline);
+                }
+                for (BindGroupIndex index(0); index < kMaxBindGroupsTyped; ++index) {
+                    if (state.bindGroups[index] != nullptr) {
+                        RecordSetBindGroup(state.bindGroups[index], state.dynamicOffsets[index]);
+                    }
+                }
+                if (state.indexBuffer != nullptr) {
+                    RecordSetIndexBuffer(state.indexBuffer);
+                }
+                for (VertexBufferSlot slot(uint8_t(0)); slot < kMaxVertexBuffersTyped; ++slot) {
+                    if (state.vertexBuffers[slot] != nullptr) {
+                        RecordSetVertexBuffer(state.vertexBuffers[slot]);
+                    }
+                }
+            }
+
+            // Records a command of the render pass other than EndRenderPass.
+            void RecordCommand(CommandIterator* iter, Command type) {
+                VisitCommand(iter, type, *this);
+            }
+
+            // The calls of VisitCommand for each command of a render pass or render bundle.
+            template <typename T, typename D>
+            void operator()(T*, D*) {
+                UNREACHABLE();
+            }
+
+            void operator()(SetBlendColorCmd* cmd, CommandData<SetBlendColorCmd>::Type*) {
+                RecordSetBlendColor(cmd);
+            }
+
+            void operator()(SetStencilReferenceCmd* cmd,
+                            CommandData<SetStencilReferenceCmd>::Type*) {
+                RecordSetStencilReference(cmd);
+            }
+
+            void operator()(SetViewportCmd* cmd, CommandData<SetViewportCmd>::Type*) {
+                RecordSetViewport(cmd);
+            }
+
+            void operator()(SetScissorRectCmd* cmd, CommandData<SetScissorRectCmd>::Type*) {
+                RecordSetScissorRect(cmd);
+            }
+
+            void operator()(ExecuteBundlesCmd* cmd, Ref<RenderBundleBase>* bundles) {
+                for (uint32_t i = 0; i < cmd->count; ++i) {
+                    // The commands of the bundle are borrowed because other threads can be
+                    // recording the same bundle.
+                    CommandIterator bundleCommands = bundles[i]->GetCommands()->Borrow();
+                    Command bundleType;
+                    while (bundleCommands.NextCommandId(&bundleType)) {
+                        VisitCommand(&bundleCommands, bundleType, *this);
+                    }
+                }
+            }
+
+            void operator()(WriteTimestampCmd* cmd, CommandData<WriteTimestampCmd>::Type*) {
+                RecordWriteTimestampCmd(mCommands, mDevice, cmd);
+            }
+
+            void operator()(DrawCmd* draw, CommandData<DrawCmd>::Type*) {
+                mDescriptorSets.Apply(mDevice, mCommands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                mDevice->fn.CmdDraw(mCommands, draw->vertexCount, draw->instanceCount,
+                                    draw->firstVertex, draw->firstInstance);
+            }
+
+            void operator()(DrawIndexedCmd* draw, CommandData<DrawIndexedCmd>::Type*) {
+                mDescriptorSets.Apply(mDevice, mCommands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                mIndexBufferTracker.Apply(mDevice, mCommands);
+                mDevice->fn.CmdDrawIndexed(mCommands, draw->indexCount, draw->instanceCount,
+                                           draw->firstIndex, draw->baseVertex,
+                                           draw->firstInstance);
+            }
+
+            void operator()(MultiDrawCmd* cmd, DrawCmd* draws) {
+                mDescriptorSets.Apply(mDevice, mCommands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                for (uint32_t i = 0; i < cmd->drawCount; ++i) {
+                    mDevice->fn.CmdDraw(mCommands, draws[i].vertexCount, draws[i].instanceCount,
+                                        draws[i].firstVertex, draws[i].firstInstance);
+                }
+            }
+
+            void operator()(MultiDrawIndexedCmd* cmd, DrawIndexedCmd* draws) {
+                mDescriptorSets.Apply(mDevice, mCommands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                mIndexBufferTracker.Apply(mDevice, mCommands);
+                for (uint32_t i = 0; i < cmd->drawCount; ++i) {
+                    mDevice->fn.CmdDrawIndexed(mCommands, draws[i].indexCount,
+                                               draws[i].instanceCount, draws[i].firstIndex,
+                                               draws[i].baseVertex, draws[i].firstInstance);
+                }
+            }
+
+            void operator()(DrawIndirectCmd* draw, CommandData<DrawIndirectCmd>::Type*) {
+                VkBuffer indirectBuffer = ToBackend(draw->indirectBuffer)->GetHandle();
+
+                mDescriptorSets.Apply(mDevice, mCommands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                mDevice->fn.CmdDrawIndirect(mCommands, indirectBuffer,
+                                            static_cast<VkDeviceSize>(draw->indirectOffset), 1, 0);
+            }
+
+            void operator()(DrawIndexedIndirectCmd* draw,
+                            CommandData<DrawIndexedIndirectCmd>::Type*) {
+                VkBuffer indirectBuffer = ToBackend(draw->indirectBuffer)->GetHandle();
+
+                mDescriptorSets.Apply(mDevice, mCommands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                mIndexBufferTracker.Apply(mDevice, mCommands);
+                mDevice->fn.CmdDrawIndexedIndirect(
+                    mCommands, indirectBuffer, static_cast<VkDeviceSize>(draw->indirectOffset), 1,
+                    0);
+            }
+
+            void operator()(InsertDebugMarkerCmd*, char* label) {
+                RecordInsertDebugMarker(mDevice, mCommands, label);
+            }
+
+            void operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                RecordPopDebugGroup(mDevice, mCommands);
+            }
+
+            void operator()(PushDebugGroupCmd*, char* label) {
+                RecordPushDebugGroup(mDevice, mCommands, label);
+            }
+
+            void operator()(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                RecordSetBindGroup(cmd, cmd->dynamicOffsetCount > 0 ? dynamicOffsets : nullptr);
+            }
+
+            void operator()(SetIndexBufferCmd* cmd, CommandData<SetIndexBufferCmd>::Type*) {
+                RecordSetIndexBuffer(cmd);
+            }
+
+            void operator()(SetRenderPipelineCmd* cmd, CommandData<SetRenderPipelineCmd>::Type*) {
+                RecordSetRenderPipeline(cmd);
+            }
+
+            void operator()(SetVertexBufferCmd* cmd, CommandData<SetVertexBufferCmd>::Type*) {
+                RecordSetVertexBuffer(cmd);
+            }
+
+          private:
+            void RecordSetRenderPipeline(SetRenderPipelineCmd* cmd) {
+                RenderPipeline* pipeline = ToBackend(cmd->pipeline).Get();
+
+                mDevice->fn.CmdBindPipeline(mCommands, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                            pipeline->GetHandle());
+
+                mDescriptorSets.OnSetPipeline(pipeline);
+                mIndexBufferTracker.OnSetPipeline(pipeline);
+            }
+
+            void RecordSetBindGroup(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                BindGroup* bindGroup = ToBackend(cmd->group.Get());
+                mDescriptorSets.OnSetBindGroup(cmd->index, bindGroup, cmd->dynamicOffsetCount,
+                                               dynamicOffsets);
+            }
+
+            void RecordSetIndexBuffer(SetIndexBufferCmd* cmd) {
+                VkBuffer indexBuffer = ToBackend(cmd->buffer)->GetHandle();
+
+                mIndexBufferTracker.OnSetIndexBuffer(indexBuffer, cmd->format,
+                                                     static_cast<VkDeviceSize>(cmd->offset));
+            }
+
+            void RecordSetVertexBuffer(SetVertexBufferCmd* cmd) {
+                VkBuffer buffer = ToBackend(cmd->buffer)->GetHandle();
+                VkDeviceSize offset = static_cast<VkDeviceSize>(cmd->offset);
+
+                mDevice->fn.CmdBindVertexBuffers(mCommands, static_cast<uint8_t>(cmd->slot), 1,
+                                                 &*buffer, &offset);
+            }
+
+            void RecordSetBlendColor(SetBlendColorCmd* cmd) {
+                const std::array<float, 4> blendConstants = ConvertToFloatColor(cmd->color);
+                mDevice->fn.CmdSetBlendConstants(mCommands, blendConstants.data());
+            }
+
+            void RecordSetStencilReference(SetStencilReferenceCmd* cmd) {
+                mDevice->fn.CmdSetStencilReference(mCommands, VK_STENCIL_FRONT_AND_BACK,
+                                                   cmd->reference);
+            }
+
+            void RecordSetViewport(SetViewportCmd* cmd) {
+                VkViewport viewport;
+                viewport.x = cmd->x;
+                viewport.y = cmd->y + cmd->height;
+                viewport.width = cmd->width;
+                viewport.height = -cmd->height;
+                viewport.minDepth = cmd->minDepth;
+                viewport.maxDepth = cmd->maxDepth;
+
+                // Vulkan disallows width = 0, but VK_KHR_maintenance1 which we require allows
+                // height = 0 so use that to do an empty viewport.
+                if (viewport.width == 0) {
+                    viewport.height = 0;
+
+                    // Set the viewport x range to a range that's always valid.
+                    viewport.x = 0;
+                    viewport.width = 1;
+                }
+
+                mDevice->fn.CmdSetViewport(mCommands, 0, 1, &viewport);
+            }
+
+            void RecordSetScissorRect(SetScissorRectCmd* cmd) {
+                VkRect2D rect;
+                rect.offset.x = cmd->x;
+                rect.offset.y = cmd->y;
+                rect.extent.width = cmd->width;
+                rect.extent.height = cmd->height;
+
+                mDevice->fn.CmdSetScissor(mCommands, 0, 1, &rect);
+            }
 
-        // Records the necessary barriers for the resource usage pre-computed by the frontend
-        auto PrepareResourcesForRenderPass = [](Device* device,
-                                                CommandRecordingContext* recordingContext,
-                                                const PassResourceUsage& usages) {
+            Device* mDevice;
+            VkCommandBuffer mCommands;
+            RenderDescriptorSetTracker mDescriptorSets = {};
+            IndexBufferTracker mIndexBufferTracker = {};
+        };
+
+        // Records a chunk of a render pass in a secondary command buffer of the pool of
+        // |threadIndex|. |commands| must be an iterator over the commands of the command buffer.
+        MaybeError RecordRenderPassChunk(Device* device,
+                                         CommandRecordingContext* recordingContext,
+                                         uint32_t threadIndex,
+                                         const BeginRenderPassCmd* renderPass,
+                                         const VkCommandBufferInheritanceInfo& inheritanceInfo,
+                                         const RenderPassChunk& chunk,
+                                         CommandIterator* commands,
+                                         VkCommandBuffer* secondaryCommands) {
+            DAWN_TRY_ASSIGN(*secondaryCommands,
+                            device->GetSecondaryCommandBuffer(recordingContext, threadIndex));
+
+            VkCommandBufferBeginInfo beginInfo;
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.pNext = nullptr;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                              VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+            beginInfo.pInheritanceInfo = &inheritanceInfo;
+            DAWN_TRY(CheckVkSuccess(device->fn.BeginCommandBuffer(*secondaryCommands, &beginInfo),
+                                    "vkBeginCommandBuffer"));
+
+            RenderPassRecorder recorder(device, *secondaryCommands);
+            recorder.RecordState(renderPass, chunk.state);
+
+            commands->SetPosition(chunk.start);
+            for (uint32_t i = 0; i < chunk.commandCount; ++i) {
+                Command type;
+                bool hasCommand = commands->NextCommandId(&type);
+                ASSERT(hasCommand && type != Command::EndRenderPass);
+                recorder.RecordCommand(commands, type);
+            }
+
+            return CheckVkSuccess(device->fn.EndCommandBuffer(*secondaryCommands),
+                                  "vkEndCommandBuffer");
+        }
+        // Records the barriers for the resource usage pre-computed by the frontend
+        void PrepareResourcesForRenderPass(Device* device,
+                                           CommandRecordingContext* recordingContext,
+                                           const PassResourceUsage& usages) {
             std::vector<VkBufferMemoryBarrier> bufferBarriers;
             std::vector<VkImageMemoryBarrier> imageBarriers;
             VkPipelineStageFlags srcStages = 0;
@@ -516,12 +993,12 @@ namespace dawn_native { namespace vulkan {
 
             for (size_t i = 0; i < usages.textures.size(); ++i) {
                 Texture* texture = ToBackend(usages.textures[i]);
-                // Clear textures that are not output attachments. Output attachments will be
-                // cleared in RecordBeginRenderPass by setting the loadop to clear when the
-                // texture subresource has not been initialized before the render pass.
-                if (!(usages.textureUsages[i].usage & wgpu::TextureUsage::OutputAttachment)) {
-                    texture->EnsureSubresourceContentInitialized(recordingContext,
-                                                                 texture->GetAllSubresources());
+                // Clear the subresources used in the pass that are not output attachments. Output
+                // attachments will be cleared in RecordBeginRenderPass by setting the loadop to
+                // clear when the texture subresource has not been initialized before the render
+                // pass.
+                for (const SubresourceRange& range : usages.textureUsages[i].lazyClearRanges) {
+                    texture->EnsureSubresourceContentInitialized(recordingContext, range);
                 }
                 texture->TransitionUsageForPass(recordingContext, usages.textureUsages[i],
                                                 &imageBarriers, &srcStages, &dstStages);
@@ -533,13 +1010,12 @@ namespace dawn_native { namespace vulkan {
                                               bufferBarriers.data(), imageBarriers.size(),
                                               imageBarriers.data());
             }
-        };
+        }
 
         // TODO(jiawei.shao@intel.com): move the resource lazy clearing inside the barrier tracking
         // for compute passes.
-        auto PrepareResourcesForComputePass = [](Device* device,
-                                                 CommandRecordingContext* recordingContext,
-                                                 const PassResourceUsage& usages) {
+        void PrepareResourcesForComputePass(CommandRecordingContext* recordingContext,
+                                            const PassResourceUsage& usages) {
             for (size_t i = 0; i < usages.buffers.size(); ++i) {
                 Buffer* buffer = ToBackend(usages.buffers[i]);
                 buffer->EnsureDataInitialized(recordingContext);
@@ -547,697 +1023,632 @@ namespace dawn_native { namespace vulkan {
 
             for (size_t i = 0; i < usages.textures.size(); ++i) {
                 Texture* texture = ToBackend(usages.textures[i]);
-                texture->EnsureSubresourceContentInitialized(recordingContext,
-                                                             texture->GetAllSubresources());
+                for (const SubresourceRange& range : usages.textureUsages[i].lazyClearRanges) {
+                    texture->EnsureSubresourceContentInitialized(recordingContext, range);
+                }
             }
-        };
-
-        const std::vector<PassResourceUsage>& passResourceUsages = GetResourceUsages().perPass;
-        size_t nextPassNumber = 0;
-
-        // QuerySet must be reset between uses.
-        ResetUsedQuerySets(device, commands, GetResourceUsages().usedQuerySets);
+        }
 
-        Command type;
-        while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::CopyBufferToBuffer: {
-                    CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
+        MaybeError RecordCopyImageWithTemporaryBuffer(Device* device,
+                                                      CommandRecordingContext* recordingContext,
+                                                      const TextureCopy& srcCopy,
+                                                      const TextureCopy& dstCopy,
+                                                      const Extent3D& copySize) {
+            ASSERT(srcCopy.texture->GetFormat().format == dstCopy.texture->GetFormat().format);
+            ASSERT(srcCopy.aspect == dstCopy.aspect);
+            dawn_native::Format format = srcCopy.texture->GetFormat();
+            const TexelBlockInfo& blockInfo = format.GetAspectInfo(srcCopy.aspect).block;
+            ASSERT(copySize.width % blockInfo.width == 0);
+            uint32_t widthInBlocks = copySize.width / blockInfo.width;
+            ASSERT(copySize.height % blockInfo.height == 0);
+            uint32_t heightInBlocks = copySize.height / blockInfo.height;
+
+            // Sub-allocate the temporary buffer from the device's scratch memory, which is reused
+            // once the pending commands complete. Note that We don't need to respect WebGPU's 256
+            // alignment because it isn't a hard constraint in Vulkan, but the offset must be a
+            // multiple of the texel block size.
+            uint64_t tempBufferSize =
+                uint64_t(widthInBlocks) * heightInBlocks * copySize.depth * blockInfo.byteSize;
+
+            ScratchBufferAllocation tempAllocation;
+            DAWN_TRY_ASSIGN(tempAllocation, device->GetScratchBufferAllocator()->Allocate(
+                                                tempBufferSize, device->GetPendingCommandSerial(),
+                                                blockInfo.byteSize));
+            Buffer* tempBuffer = ToBackend(tempAllocation.buffer);
+
+            BufferCopy tempBufferCopy;
+            tempBufferCopy.buffer = tempBuffer;
+            tempBufferCopy.rowsPerImage = heightInBlocks;
+            tempBufferCopy.offset = tempAllocation.offset;
+            tempBufferCopy.bytesPerRow = copySize.width / blockInfo.width * blockInfo.byteSize;
 
-                    Buffer* srcBuffer = ToBackend(copy->source.Get());
-                    Buffer* dstBuffer = ToBackend(copy->destination.Get());
+            VkCommandBuffer commands = recordingContext->commandBuffer;
+            VkImage srcImage = ToBackend(srcCopy.texture)->GetHandle();
+            VkImage dstImage = ToBackend(dstCopy.texture)->GetHandle();
+
+            tempBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
+            VkBufferImageCopy srcToTempBufferRegion =
+                ComputeBufferImageCopyRegion(tempBufferCopy, srcCopy, copySize);
+
+            // The Dawn CopySrc usage is always mapped to GENERAL
+            device->fn.CmdCopyImageToBuffer(commands, srcImage, VK_IMAGE_LAYOUT_GENERAL,
+                                            tempBuffer->GetHandle(), 1, &srcToTempBufferRegion);
+
+            tempBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopySrc);
+            VkBufferImageCopy tempBufferToDstRegion =
+                ComputeBufferImageCopyRegion(tempBufferCopy, dstCopy, copySize);
+
+            // Dawn guarantees dstImage be in the TRANSFER_DST_OPTIMAL layout after the
+            // copy command.
+            device->fn.CmdCopyBufferToImage(commands, tempBuffer->GetHandle(), dstImage,
+                                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                                            &tempBufferToDstRegion);
+            return {};
+        }
 
-                    srcBuffer->EnsureDataInitialized(recordingContext);
-                    dstBuffer->EnsureDataInitializedAsDestination(
-                        recordingContext, copy->destinationOffset, copy->size);
+        // The visitor of CommandBuffer::RecordCopies that clears the resources of a copy that need
+        // it and adds their barriers to the batch. It returns false without doing anything when
+        // the copy has a hazard with the copies already in the batch. Hazards are checked before
+        // the lazy clears because clearing would record barriers for resources that already have
+        // a pending barrier in the batch.
+        class CopyPreparer {
+          public:
+            CopyPreparer(CommandRecordingContext* recordingContext, BarrierBatch* barriers)
+                : mRecordingContext(recordingContext), mBarriers(barriers) {
+            }
 
-                    srcBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopySrc);
-                    dstBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
+            template <typename T, typename D>
+            bool operator()(T*, D*) {
+                UNREACHABLE();
+                return false;
+            }
 
-                    VkBufferCopy region;
-                    region.srcOffset = copy->sourceOffset;
-                    region.dstOffset = copy->destinationOffset;
-                    region.size = copy->size;
+            bool operator()(CopyBufferToBufferCmd* copy,
+                            CommandData<CopyBufferToBufferCmd>::Type*) {
+                Buffer* srcBuffer = ToBackend(copy->source.Get());
+                Buffer* dstBuffer = ToBackend(copy->destination.Get());
 
-                    VkBuffer srcHandle = srcBuffer->GetHandle();
-                    VkBuffer dstHandle = dstBuffer->GetHandle();
-                    device->fn.CmdCopyBuffer(commands, srcHandle, dstHandle, 1, &region);
-                    break;
+                if (mBarriers->HasHazard(srcBuffer, wgpu::BufferUsage::CopySrc, copy->sourceOffset,
+                                         copy->size) ||
+                    mBarriers->HasHazard(dstBuffer, wgpu::BufferUsage::CopyDst,
+                                         copy->destinationOffset, copy->size)) {
+                    return false;
                 }
 
-                case Command::CopyBufferToTexture: {
-                    CopyBufferToTextureCmd* copy = mCommands.NextCommand<CopyBufferToTextureCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
+                srcBuffer->EnsureDataInitialized(mRecordingContext);
+                dstBuffer->EnsureDataInitializedAsDestination(
+                    mRecordingContext, copy->destinationOffset, copy->size);
 
-                    ToBackend(src.buffer)->EnsureDataInitialized(recordingContext);
+                mBarriers->TransitionUsage(srcBuffer, wgpu::BufferUsage::CopySrc,
+                                           copy->sourceOffset, copy->size);
+                mBarriers->TransitionUsage(dstBuffer, wgpu::BufferUsage::CopyDst,
+                                           copy->destinationOffset, copy->size);
+                return true;
+            }
 
-                    VkBufferImageCopy region =
-                        ComputeBufferImageCopyRegion(src, dst, copy->copySize);
-                    VkImageSubresourceLayers subresource = region.imageSubresource;
+            bool operator()(CopyBufferToTextureCmd* copy,
+                            CommandData<CopyBufferToTextureCmd>::Type*) {
+                auto& src = copy->source;
+                auto& dst = copy->destination;
 
-                    ASSERT(dst.texture->GetDimension() == wgpu::TextureDimension::e2D);
-                    SubresourceRange range =
-                        GetSubresourcesAffectedByCopy(copy->destination, copy->copySize);
+                Buffer* srcBuffer = ToBackend(src.buffer.Get());
+                Texture* dstTexture = ToBackend(dst.texture.Get());
+                uint64_t srcSize = GetBufferSizeAffectedByCopy(src, dst, copy->copySize);
 
-                    if (IsCompleteSubresourceCopiedTo(dst.texture.Get(), copy->copySize,
-                                                      subresource.mipLevel)) {
-                        // Since texture has been overwritten, it has been "initialized"
-                        dst.texture->SetIsSubresourceContentInitialized(true, range);
-                    } else {
-                        ToBackend(dst.texture)
-                            ->EnsureSubresourceContentInitialized(recordingContext, range);
-                    }
-                    ToBackend(src.buffer)
-                        ->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopySrc);
-                    ToBackend(dst.texture)
-                        ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopyDst, range);
-                    VkBuffer srcBuffer = ToBackend(src.buffer)->GetHandle();
-                    VkImage dstImage = ToBackend(dst.texture)->GetHandle();
+                ASSERT(dst.texture->GetDimension() == wgpu::TextureDimension::e2D);
+                SubresourceRange range =
+                    GetSubresourcesAffectedByCopy(copy->destination, copy->copySize);
 
-                    // Dawn guarantees dstImage be in the TRANSFER_DST_OPTIMAL layout after the
-                    // copy command.
-                    device->fn.CmdCopyBufferToImage(commands, srcBuffer, dstImage,
-                                                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                                                    &region);
-                    break;
+                if (mBarriers->HasHazard(srcBuffer, wgpu::BufferUsage::CopySrc, src.offset,
+                                         srcSize) ||
+                    mBarriers->HasHazard(dstTexture, wgpu::TextureUsage::CopyDst, range,
+                                         dst.origin, copy->copySize)) {
+                    return false;
                 }
 
-                case Command::CopyTextureToBuffer: {
-                    CopyTextureToBufferCmd* copy = mCommands.NextCommand<CopyTextureToBufferCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
+                srcBuffer->EnsureDataInitialized(mRecordingContext);
 
-                    ToBackend(dst.buffer)
-                        ->EnsureDataInitializedAsDestination(recordingContext, copy);
+                if (IsCompleteSubresourceCopiedTo(dst.texture.Get(), copy->copySize,
+                                                  dst.mipLevel)) {
+                    // Since texture has been overwritten, it has been "initialized"
+                    dst.texture->SetIsSubresourceContentInitialized(true, range);
+                } else {
+                    dstTexture->EnsureSubresourceContentInitialized(mRecordingContext, range);
+                }
 
-                    VkBufferImageCopy region =
-                        ComputeBufferImageCopyRegion(dst, src, copy->copySize);
+                mBarriers->TransitionUsage(srcBuffer, wgpu::BufferUsage::CopySrc, src.offset,
+                                           srcSize);
+                mBarriers->TransitionUsage(mRecordingContext, dstTexture,
+                                           wgpu::TextureUsage::CopyDst, range, dst.origin,
+                                           copy->copySize);
+                return true;
+            }
 
-                    ASSERT(src.texture->GetDimension() == wgpu::TextureDimension::e2D);
-                    SubresourceRange range =
-                        GetSubresourcesAffectedByCopy(copy->source, copy->copySize);
+            bool operator()(CopyTextureToBufferCmd* copy,
+                            CommandData<CopyTextureToBufferCmd>::Type*) {
+                auto& src = copy->source;
+                auto& dst = copy->destination;
 
-                    ToBackend(src.texture)
-                        ->EnsureSubresourceContentInitialized(recordingContext, range);
+                Texture* srcTexture = ToBackend(src.texture.Get());
+                Buffer* dstBuffer = ToBackend(dst.buffer.Get());
+                uint64_t dstSize = GetBufferSizeAffectedByCopy(dst, src, copy->copySize);
 
-                    ToBackend(src.texture)
-                        ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopySrc, range);
-                    ToBackend(dst.buffer)
-                        ->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
+                ASSERT(src.texture->GetDimension() == wgpu::TextureDimension::e2D);
+                SubresourceRange range =
+                    GetSubresourcesAffectedByCopy(copy->source, copy->copySize);
 
-                    VkImage srcImage = ToBackend(src.texture)->GetHandle();
-                    VkBuffer dstBuffer = ToBackend(dst.buffer)->GetHandle();
-                    // The Dawn CopySrc usage is always mapped to GENERAL
-                    device->fn.CmdCopyImageToBuffer(commands, srcImage, VK_IMAGE_LAYOUT_GENERAL,
-                                                    dstBuffer, 1, &region);
-                    break;
+                if (mBarriers->HasHazard(srcTexture, wgpu::TextureUsage::CopySrc, range,
+                                         src.origin, copy->copySize) ||
+                    mBarriers->HasHazard(dstBuffer, wgpu::BufferUsage::CopyDst, dst.offset,
+                                         dstSize)) {
+                    return false;
                 }
 
-                case Command::CopyTextureToTexture: {
-                    CopyTextureToTextureCmd* copy =
-                        mCommands.NextCommand<CopyTextureToTextureCmd>();
-                    TextureCopy& src = copy->source;
-                    TextureCopy& dst = copy->destination;
-                    SubresourceRange srcRange = GetSubresourcesAffectedByCopy(src, copy->copySize);
-                    SubresourceRange dstRange = GetSubresourcesAffectedByCopy(dst, copy->copySize);
-
-                    ToBackend(src.texture)
-                        ->EnsureSubresourceContentInitialized(recordingContext, srcRange);
-                    if (IsCompleteSubresourceCopiedTo(dst.texture.Get(), copy->copySize,
-                                                      dst.mipLevel)) {
-                        // Since destination texture has been overwritten, it has been "initialized"
-                        dst.texture->SetIsSubresourceContentInitialized(true, dstRange);
-                    } else {
-                        ToBackend(dst.texture)
-                            ->EnsureSubresourceContentInitialized(recordingContext, dstRange);
-                    }
-
-                    if (src.texture.Get() == dst.texture.Get() && src.mipLevel == dst.mipLevel) {
-                        // When there are overlapped subresources, the layout of the overlapped
-                        // subresources should all be GENERAL instead of what we set now. Currently
-                        // it is not allowed to copy with overlapped subresources, but we still
-                        // add the ASSERT here as a reminder for this possible misuse.
-                        ASSERT(
-                            !IsRangeOverlapped(src.origin.z, dst.origin.z, copy->copySize.depth));
-                    }
+                dstBuffer->EnsureDataInitializedAsDestination(mRecordingContext, copy);
+                srcTexture->EnsureSubresourceContentInitialized(mRecordingContext, range);
 
-                    // TODO after Yunchao's CL
-                    ToBackend(src.texture)
-                        ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopySrc,
-                                             srcRange);
-                    ToBackend(dst.texture)
-                        ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopyDst,
-                                             dstRange);
-
-                    // In some situations we cannot do texture-to-texture copies with vkCmdCopyImage
-                    // because as Vulkan SPEC always validates image copies with the virtual size of
-                    // the image subresource, when the extent that fits in the copy region of one
-                    // subresource but does not fit in the one of another subresource, we will fail
-                    // to find a valid extent to satisfy the requirements on both source and
-                    // destination image subresource. For example, when the source is the first
-                    // level of a 16x16 texture in BC format, and the destination is the third level
-                    // of a 60x60 texture in the same format, neither 16x16 nor 15x15 is valid as
-                    // the extent of vkCmdCopyImage.
-                    // Our workaround for this issue is replacing the texture-to-texture copy with
-                    // one texture-to-buffer copy and one buffer-to-texture copy.
-                    bool copyUsingTemporaryBuffer =
-                        device->IsToggleEnabled(
-                            Toggle::UseTemporaryBufferInCompressedTextureToTextureCopy) &&
-                        src.texture->GetFormat().isCompressed &&
-                        !HasSameTextureCopyExtent(src, dst, copy->copySize);
-
-                    if (!copyUsingTemporaryBuffer) {
-                        VkImage srcImage = ToBackend(src.texture)->GetHandle();
-                        VkImage dstImage = ToBackend(dst.texture)->GetHandle();
-
-                        for (Aspect aspect : IterateEnumMask(src.texture->GetFormat().aspects)) {
-                            ASSERT(dst.texture->GetFormat().aspects & aspect);
-                            VkImageCopy region =
-                                ComputeImageCopyRegion(src, dst, copy->copySize, aspect);
-
-                            // Dawn guarantees dstImage be in the TRANSFER_DST_OPTIMAL layout after
-                            // the copy command.
-                            device->fn.CmdCopyImage(commands, srcImage, VK_IMAGE_LAYOUT_GENERAL,
-                                                    dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                                    1, &region);
-                        }
-                    } else {
-                        RecordCopyImageWithTemporaryBuffer(recordingContext, src, dst,
-                                                           copy->copySize);
-                    }
+                mBarriers->TransitionUsage(mRecordingContext, srcTexture,
+                                           wgpu::TextureUsage::CopySrc, range, src.origin,
+                                           copy->copySize);
+                mBarriers->TransitionUsage(dstBuffer, wgpu::BufferUsage::CopyDst, dst.offset,
+                                           dstSize);
+                return true;
+            }
 
-                    break;
+            bool operator()(CopyTextureToTextureCmd* copy,
+                            CommandData<CopyTextureToTextureCmd>::Type*) {
+                TextureCopy& src = copy->source;
+                TextureCopy& dst = copy->destination;
+
+                Texture* srcTexture = ToBackend(src.texture.Get());
+                Texture* dstTexture = ToBackend(dst.texture.Get());
+                SubresourceRange srcRange = GetSubresourcesAffectedByCopy(src, copy->copySize);
+                SubresourceRange dstRange = GetSubresourcesAffectedByCopy(dst, copy->copySize);
+
+                if (mBarriers->HasHazard(srcTexture, wgpu::TextureUsage::CopySrc, srcRange,
+                                         src.origin, copy->copySize) ||
+                    mBarriers->HasHazard(dstTexture, wgpu::TextureUsage::CopyDst, dstRange,
+                                         dst.origin, copy->copySize)) {
+                    return false;
                 }
 
-                case Command::BeginRenderPass: {
-                    BeginRenderPassCmd* cmd = mCommands.NextCommand<BeginRenderPassCmd>();
-
-                    PrepareResourcesForRenderPass(device, recordingContext,
-                                                  passResourceUsages[nextPassNumber]);
-
-                    LazyClearRenderPassAttachments(cmd);
-                    DAWN_TRY(RecordRenderPass(recordingContext, cmd));
-
-                    nextPassNumber++;
-                    break;
+                srcTexture->EnsureSubresourceContentInitialized(mRecordingContext, srcRange);
+                if (IsCompleteSubresourceCopiedTo(dst.texture.Get(), copy->copySize,
+                                                  dst.mipLevel)) {
+                    // Since destination texture has been overwritten, it has been "initialized"
+                    dst.texture->SetIsSubresourceContentInitialized(true, dstRange);
+                } else {
+                    dstTexture->EnsureSubresourceContentInitialized(mRecordingContext, dstRange);
                 }
 
-                case Command::BeginComputePass: {
-                    mCommands.NextCommand<BeginComputePassCmd>();
-
-                    PrepareResourcesForComputePass(device, recordingContext,
-                                                   passResourceUsages[nextPassNumber]);
-                    DAWN_TRY(RecordComputePass(recordingContext));
-
-                    nextPassNumber++;
-                    break;
+                if (src.texture.Get() == dst.texture.Get() && src.mipLevel == dst.mipLevel) {
+                    // When there are overlapped subresources, the layout of the overlapped
+                    // subresources should all be GENERAL instead of what we set now. Currently
+                    // it is not allowed to copy with overlapped subresources, but we still
+                    // add the ASSERT here as a reminder for this possible misuse.
+                    ASSERT(!IsRangeOverlapped(src.origin.z, dst.origin.z, copy->copySize.depth));
                 }
 
-                case Command::ResolveQuerySet: {
-                    ResolveQuerySetCmd* cmd = mCommands.NextCommand<ResolveQuerySetCmd>();
-                    QuerySet* querySet = ToBackend(cmd->querySet.Get());
-                    Buffer* destination = ToBackend(cmd->destination.Get());
-
-                    destination->EnsureDataInitializedAsDestination(
-                        recordingContext, cmd->destinationOffset,
-                        cmd->queryCount * sizeof(uint64_t));
-                    destination->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
-
-                    device->fn.CmdCopyQueryPoolResults(
-                        commands, querySet->GetHandle(), cmd->firstQuery, cmd->queryCount,
-                        destination->GetHandle(), cmd->destinationOffset, sizeof(uint64_t),
-                        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
-                    break;
-                }
+                mBarriers->TransitionUsage(mRecordingContext, srcTexture,
+                                           wgpu::TextureUsage::CopySrc, srcRange, src.origin,
+                                           copy->copySize);
+                mBarriers->TransitionUsage(mRecordingContext, dstTexture,
+                                           wgpu::TextureUsage::CopyDst, dstRange, dst.origin,
+                                           copy->copySize);
+                return true;
+            }
 
-                case Command::WriteTimestamp: {
-                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
+          private:
+            CommandRecordingContext* mRecordingContext;
+            BarrierBatch* mBarriers;
+        };
 
-                    RecordWriteTimestampCmd(recordingContext, device, cmd);
-                    break;
-                }
+        // The visitor of CommandBuffer::RecordCopies that records a copy prepared by CopyPreparer.
+        class CopyRecorder {
+          public:
+            CopyRecorder(Device* device, CommandRecordingContext* recordingContext)
+                : mDevice(device),
+                  mRecordingContext(recordingContext),
+                  mCommands(recordingContext->commandBuffer) {
+            }
 
-                case Command::InsertDebugMarker: {
-                    if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
-                        InsertDebugMarkerCmd* cmd = mCommands.NextCommand<InsertDebugMarkerCmd>();
-                        const char* label = mCommands.NextData<char>(cmd->length + 1);
-                        VkDebugMarkerMarkerInfoEXT markerInfo{};
-                        markerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
-                        markerInfo.pMarkerName = label;
-                        // Default color to black
-                        markerInfo.color[0] = 0.0;
-                        markerInfo.color[1] = 0.0;
-                        markerInfo.color[2] = 0.0;
-                        markerInfo.color[3] = 1.0;
-                        device->fn.CmdDebugMarkerInsertEXT(commands, &markerInfo);
-                    } else {
-                        SkipCommand(&mCommands, Command::InsertDebugMarker);
-                    }
-                    break;
-                }
+            template <typename T, typename D>
+            MaybeError operator()(T*, D*) {
+                UNREACHABLE();
+                return {};
+            }
 
-                case Command::PopDebugGroup: {
-                    if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
-                        mCommands.NextCommand<PopDebugGroupCmd>();
-                        device->fn.CmdDebugMarkerEndEXT(commands);
-                    } else {
-                        SkipCommand(&mCommands, Command::PopDebugGroup);
-                    }
-                    break;
-                }
+            MaybeError operator()(CopyBufferToBufferCmd* copy,
+                                  CommandData<CopyBufferToBufferCmd>::Type*) {
+                VkBufferCopy region;
+                region.srcOffset = copy->sourceOffset;
+                region.dstOffset = copy->destinationOffset;
+                region.size = copy->size;
+
+                VkBuffer srcHandle = ToBackend(copy->source)->GetHandle();
+                VkBuffer dstHandle = ToBackend(copy->destination)->GetHandle();
+                mDevice->fn.CmdCopyBuffer(mCommands, srcHandle, dstHandle, 1, &region);
+                return {};
+            }
 
-                case Command::PushDebugGroup: {
-                    if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
-                        PushDebugGroupCmd* cmd = mCommands.NextCommand<PushDebugGroupCmd>();
-                        const char* label = mCommands.NextData<char>(cmd->length + 1);
-                        VkDebugMarkerMarkerInfoEXT markerInfo{};
-                        markerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
-                        markerInfo.pMarkerName = label;
-                        // Default color to black
-                        markerInfo.color[0] = 0.0;
-                        markerInfo.color[1] = 0.0;
-                        markerInfo.color[2] = 0.0;
-                        markerInfo.color[3] = 1.0;
-                        device->fn.CmdDebugMarkerBeginEXT(commands, &markerInfo);
-                    } else {
-                        SkipCommand(&mCommands, Command::PushDebugGroup);
-                    }
-                    break;
-                }
+            MaybeError operator()(CopyBufferToTextureCmd* copy,
+                                  CommandData<CopyBufferToTextureCmd>::Type*) {
+                auto& src = copy->source;
+                auto& dst = copy->destination;
 
-                default:
-                    break;
+                VkBufferImageCopy region = ComputeBufferImageCopyRegion(src, dst, copy->copySize);
+                VkBuffer srcBuffer = ToBackend(src.buffer)->GetHandle();
+                VkImage dstImage = ToBackend(dst.texture)->GetHandle();
+
+                // Dawn guarantees dstImage be in the TRANSFER_DST_OPTIMAL layout after the
+                // copy command.
+                mDevice->fn.CmdCopyBufferToImage(mCommands, srcBuffer, dstImage,
+                                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+                return {};
             }
-        }
 
-        return {};
-    }
+            MaybeError operator()(CopyTextureToBufferCmd* copy,
+                                  CommandData<CopyTextureToBufferCmd>::Type*) {
+                auto& src = copy->source;
+                auto& dst = copy->destination;
 
-    MaybeError CommandBuffer::RecordComputePass(CommandRecordingContext* recordingContext) {
-        Device* device = ToBackend(GetDevice());
-        VkCommandBuffer commands = recordingContext->commandBuffer;
+                VkBufferImageCopy region = ComputeBufferImageCopyRegion(dst, src, copy->copySize);
+                VkImage srcImage = ToBackend(src.texture)->GetHandle();
+                VkBuffer dstBuffer = ToBackend(dst.buffer)->GetHandle();
 
-        ComputeDescriptorSetTracker descriptorSets = {};
+                // The Dawn CopySrc usage is always mapped to GENERAL
+                mDevice->fn.CmdCopyImageToBuffer(mCommands, srcImage, VK_IMAGE_LAYOUT_GENERAL,
+                                                 dstBuffer, 1, &region);
+                return {};
+            }
 
-        Command type;
-        while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndComputePass: {
-                    mCommands.NextCommand<EndComputePassCmd>();
-                    return {};
+            MaybeError operator()(CopyTextureToTextureCmd* copy,
+                                  CommandData<CopyTextureToTextureCmd>::Type*) {
+                TextureCopy& src = copy->source;
+                TextureCopy& dst = copy->destination;
+
+                // In some situations we cannot do texture-to-texture copies with vkCmdCopyImage
+                // because as Vulkan SPEC always validates image copies with the virtual size of
+                // the image subresource, when the extent that fits in the copy region of one
+                // subresource but does not fit in the one of another subresource, we will fail
+                // to find a valid extent to satisfy the requirements on both source and
+                // destination image subresource. For example, when the source is the first
+                // level of a 16x16 texture in BC format, and the destination is the third level
+                // of a 60x60 texture in the same format, neither 16x16 nor 15x15 is valid as
+                // the extent of vkCmdCopyImage.
+                // Our workaround for this issue is replacing the texture-to-texture copy with
+                // one texture-to-buffer copy and one buffer-to-texture copy.
+                bool copyUsingTemporaryBuffer =
+                    mDevice->IsToggleEnabled(
+                        Toggle::UseTemporaryBufferInCompressedTextureToTextureCopy) &&
+                    src.texture->GetFormat().isCompressed &&
+                    !HasSameTextureCopyExtent(src, dst, copy->copySize);
+
+                if (copyUsingTemporaryBuffer) {
+                    return RecordCopyImageWithTemporaryBuffer(mDevice, mRecordingContext, src, dst,
+                                                              copy->copySize);
                 }
 
-                case Command::Dispatch: {
-                    DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
+                VkImage srcImage = ToBackend(src.texture)->GetHandle();
+                VkImage dstImage = ToBackend(dst.texture)->GetHandle();
 
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_COMPUTE);
-                    device->fn.CmdDispatch(commands, dispatch->x, dispatch->y, dispatch->z);
-                    break;
-                }
+                for (Aspect aspect : IterateEnumMask(src.texture->GetFormat().aspects)) {
+                    ASSERT(dst.texture->GetFormat().aspects & aspect);
+                    VkImageCopy region = ComputeImageCopyRegion(src, dst, copy->copySize, aspect);
 
-                case Command::DispatchIndirect: {
-                    DispatchIndirectCmd* dispatch = mCommands.NextCommand<DispatchIndirectCmd>();
-                    ToBackend(dispatch->indirectBuffer)
-                        ->TransitionUsageNow(recordingContext, wgpu::BufferUsage::Indirect);
-                    VkBuffer indirectBuffer = ToBackend(dispatch->indirectBuffer)->GetHandle();
-
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_COMPUTE);
-                    device->fn.CmdDispatchIndirect(
-                        commands, indirectBuffer,
-                        static_cast<VkDeviceSize>(dispatch->indirectOffset));
-                    break;
+                    // Dawn guarantees dstImage be in the TRANSFER_DST_OPTIMAL layout after the
+                    // copy command.
+                    mDevice->fn.CmdCopyImage(mCommands, srcImage, VK_IMAGE_LAYOUT_GENERAL,
+                                             dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                                             &region);
                 }
+                return {};
+            }
 
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
+          private:
+            Device* mDevice;
+            CommandRecordingContext* mRecordingContext;
+            VkCommandBuffer mCommands;
+        };
 
-                    BindGroup* bindGroup = ToBackend(cmd->group.Get());
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = mCommands.NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+        // Records the commands of a compute pass other than EndComputePass.
+        class ComputePassRecorder {
+          public:
+            ComputePassRecorder(Device* device, CommandRecordingContext* recordingContext)
+                : mDevice(device),
+                  mRecordingContext(recordingContext),
+                  mCommands(recordingContext->commandBuffer) {
+            }
 
-                    descriptorSets.OnSetBindGroup(cmd->index, bindGroup, cmd->dynamicOffsetCount,
-                                                  dynamicOffsets);
-                    break;
-                }
+            template <typename T, typename D>
+            void operator()(T*, D*) {
+                UNREACHABLE();
+            }
 
-                case Command::SetComputePipeline: {
-                    SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
-                    ComputePipeline* pipeline = ToBackend(cmd->pipeline).Get();
+            void operator()(DispatchCmd* dispatch, CommandData<DispatchCmd>::Type*) {
+                mDescriptorSets.Apply(mDevice, mRecordingContext, VK_PIPELINE_BIND_POINT_COMPUTE);
+                mDevice->fn.CmdDispatch(mCommands, dispatch->x, dispatch->y, dispatch->z);
+            }
 
-                    device->fn.CmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_COMPUTE,
-                                               pipeline->GetHandle());
-                    descriptorSets.OnSetPipeline(pipeline);
-                    break;
-                }
+            void operator()(DispatchIndirectCmd* dispatch,
+                            CommandData<DispatchIndirectCmd>::Type*) {
+                ToBackend(dispatch->indirectBuffer)
+                    ->TransitionUsageNow(mRecordingContext, wgpu::BufferUsage::Indirect);
+                VkBuffer indirectBuffer = ToBackend(dispatch->indirectBuffer)->GetHandle();
 
-                case Command::InsertDebugMarker: {
-                    if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
-                        InsertDebugMarkerCmd* cmd = mCommands.NextCommand<InsertDebugMarkerCmd>();
-                        const char* label = mCommands.NextData<char>(cmd->length + 1);
-                        VkDebugMarkerMarkerInfoEXT markerInfo;
-                        markerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
-                        markerInfo.pNext = nullptr;
-                        markerInfo.pMarkerName = label;
-                        // Default color to black
-                        markerInfo.color[0] = 0.0;
-                        markerInfo.color[1] = 0.0;
-                        markerInfo.color[2] = 0.0;
-                        markerInfo.color[3] = 1.0;
-                        device->fn.CmdDebugMarkerInsertEXT(commands, &markerInfo);
-                    } else {
-                        SkipCommand(&mCommands, Command::InsertDebugMarker);
-                    }
-                    break;
-                }
+                mDescriptorSets.Apply(mDevice, mRecordingContext, VK_PIPELINE_BIND_POINT_COMPUTE);
+                mDevice->fn.CmdDispatchIndirect(
+                    mCommands, indirectBuffer, static_cast<VkDeviceSize>(dispatch->indirectOffset));
+            }
 
-                case Command::PopDebugGroup: {
-                    if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
-                        mCommands.NextCommand<PopDebugGroupCmd>();
-                        device->fn.CmdDebugMarkerEndEXT(commands);
-                    } else {
-                        SkipCommand(&mCommands, Command::PopDebugGroup);
-                    }
-                    break;
-                }
+            void operator()(SetBindGroupCmd* cmd, uint32_t* dynamicOffsets) {
+                BindGroup* bindGroup = ToBackend(cmd->group.Get());
+                mDescriptorSets.OnSetBindGroup(cmd->index, bindGroup, cmd->dynamicOffsetCount,
+                                               cmd->dynamicOffsetCount > 0 ? dynamicOffsets
+                                                                           : nullptr);
+            }
 
-                case Command::PushDebugGroup: {
-                    if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
-                        PushDebugGroupCmd* cmd = mCommands.NextCommand<PushDebugGroupCmd>();
-                        const char* label = mCommands.NextData<char>(cmd->length + 1);
-                        VkDebugMarkerMarkerInfoEXT markerInfo;
-                        markerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
-                        markerInfo.pNext = nullptr;
-                        markerInfo.pMarkerName = label;
-                        // Default color to black
-                        markerInfo.color[0] = 0.0;
-                        markerInfo.color[1] = 0.0;
-                        markerInfo.color[2] = 0.0;
-                        markerInfo.color[3] = 1.0;
-                        device->fn.CmdDebugMarkerBeginEXT(commands, &markerInfo);
-                    } else {
-                        SkipCommand(&mCommands, Command::PushDebugGroup);
-                    }
-                    break;
-                }
+            void operator()(SetComputePipelineCmd* cmd,
+                            CommandData<SetComputePipelineCmd>::Type*) {
+                ComputePipeline* pipeline = ToBackend(cmd->pipeline).Get();
 
-                case Command::WriteTimestamp: {
-                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
+                mDevice->fn.CmdBindPipeline(mCommands, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                            pipeline->GetHandle());
+                mDescriptorSets.OnSetPipeline(pipeline);
+            }
 
-                    RecordWriteTimestampCmd(recordingContext, device, cmd);
-                    break;
-                }
+            void operator()(InsertDebugMarkerCmd*, char* label) {
+                RecordInsertDebugMarker(mDevice, mCommands, label);
+            }
 
-                default:
-                    UNREACHABLE();
+            void operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+                RecordPopDebugGroup(mDevice, mCommands);
             }
-        }
 
-        // EndComputePass should have been called
-        UNREACHABLE();
-    }
+            void operator()(PushDebugGroupCmd*, char* label) {
+                RecordPushDebugGroup(mDevice, mCommands, label);
+            }
 
-    MaybeError CommandBuffer::RecordRenderPass(CommandRecordingContext* recordingContext,
-                                               BeginRenderPassCmd* renderPassCmd) {
-        Device* device = ToBackend(GetDevice());
-        VkCommandBuffer commands = recordingContext->commandBuffer;
+            void operator()(WriteTimestampCmd* cmd, CommandData<WriteTimestampCmd>::Type*) {
+                RecordWriteTimestampCmd(mCommands, mDevice, cmd);
+            }
 
-        DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd));
-
-        // Set the default value for the dynamic state
-        {
-            device->fn.CmdSetLineWidth(commands, 1.0f);
-            device->fn.CmdSetDepthBounds(commands, 0.0f, 1.0f);
-
-            device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK, 0);
-
-            float blendConstants[4] = {
-                0.0f,
-                0.0f,
-                0.0f,
-                0.0f,
-            };
-            device->fn.CmdSetBlendConstants(commands, blendConstants);
-
-            // The viewport and scissor default to cover all of the attachments
-            VkViewport viewport;
-            viewport.x = 0.0f;
-            viewport.y = static_cast<float>(renderPassCmd->height);
-            viewport.width = static_cast<float>(renderPassCmd->width);
-            viewport.height = -static_cast<float>(renderPassCmd->height);
-            viewport.minDepth = 0.0f;
-            viewport.maxDepth = 1.0f;
-            device->fn.CmdSetViewport(commands, 0, 1, &viewport);
-
-            VkRect2D scissorRect;
-            scissorRect.offset.x = 0;
-            scissorRect.offset.y = 0;
-            scissorRect.extent.width = renderPassCmd->width;
-            scissorRect.extent.height = renderPassCmd->height;
-            device->fn.CmdSetScissor(commands, 0, 1, &scissorRect);
+          private:
+            Device* mDevice;
+            CommandRecordingContext* mRecordingContext;
+            VkCommandBuffer mCommands;
+            ComputeDescriptorSetTracker mDescriptorSets = {};
+        };
+    }  // anonymous namespace
+
+    // Records the commands outside of passes, other than the copies that RecordCopies batches.
+    class CommandBuffer::CommandRecorder {
+      public:
+        CommandRecorder(CommandBuffer* commandBuffer, CommandRecordingContext* recordingContext)
+            : mCommandBuffer(commandBuffer),
+              mDevice(ToBackend(commandBuffer->GetDevice())),
+              mRecordingContext(recordingContext),
+              mCommands(recordingContext->commandBuffer) {
         }
 
-        RenderDescriptorSetTracker descriptorSets = {};
-        IndexBufferTracker indexBufferTracker = {};
-        RenderPipeline* lastPipeline = nullptr;
+        template <typename T, typename D>
+        MaybeError operator()(T*, D*) {
+            UNREACHABLE();
+            return {};
+        }
 
-        auto EncodeRenderBundleCommand = [&](CommandIterator* iter, Command type) {
-            switch (type) {
-                case Command::Draw: {
-                    DrawCmd* draw = iter->NextCommand<DrawCmd>();
+        MaybeError operator()(BeginRenderPassCmd* cmd, CommandData<BeginRenderPassCmd>::Type*) {
+            PrepareResourcesForRenderPass(mDevice, mRecordingContext, NextPassResourceUsage());
 
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                    device->fn.CmdDraw(commands, draw->vertexCount, draw->instanceCount,
-                                       draw->firstVertex, draw->firstInstance);
-                    break;
-                }
+            LazyClearRenderPassAttachments(cmd);
+            return mCommandBuffer->RecordRenderPass(mRecordingContext, cmd);
+        }
 
-                case Command::DrawIndexed: {
-                    DrawIndexedCmd* draw = iter->NextCommand<DrawIndexedCmd>();
+        MaybeError operator()(BeginComputePassCmd*, CommandData<BeginComputePassCmd>::Type*) {
+            PrepareResourcesForComputePass(mRecordingContext, NextPassResourceUsage());
+            return mCommandBuffer->RecordComputePass(mRecordingContext);
+        }
 
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                    indexBufferTracker.Apply(device, commands);
-                    device->fn.CmdDrawIndexed(commands, draw->indexCount, draw->instanceCount,
-                                              draw->firstIndex, draw->baseVertex,
-                                              draw->firstInstance);
-                    break;
-                }
+        MaybeError operator()(ResolveQuerySetCmd* cmd, CommandData<ResolveQuerySetCmd>::Type*) {
+            QuerySet* querySet = ToBackend(cmd->querySet.Get());
+            Buffer* destination = ToBackend(cmd->destination.Get());
 
-                case Command::DrawIndirect: {
-                    DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-                    VkBuffer indirectBuffer = ToBackend(draw->indirectBuffer)->GetHandle();
+            destination->EnsureDataInitializedAsDestination(
+                mRecordingContext, cmd->destinationOffset, cmd->queryCount * sizeof(uint64_t));
+            destination->TransitionUsageNow(mRecordingContext, wgpu::BufferUsage::CopyDst);
 
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                    device->fn.CmdDrawIndirect(commands, indirectBuffer,
-                                               static_cast<VkDeviceSize>(draw->indirectOffset), 1,
-                                               0);
-                    break;
-                }
+            mDevice->fn.CmdCopyQueryPoolResults(
+                mCommands, querySet->GetHandle(), cmd->firstQuery, cmd->queryCount,
+                destination->GetHandle(), cmd->destinationOffset, sizeof(uint64_t),
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+            return {};
+        }
 
-                case Command::DrawIndexedIndirect: {
-                    DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-                    VkBuffer indirectBuffer = ToBackend(draw->indirectBuffer)->GetHandle();
+        MaybeError operator()(WriteTimestampCmd* cmd, CommandData<WriteTimestampCmd>::Type*) {
+            RecordWriteTimestampCmd(mCommands, mDevice, cmd);
+            return {};
+        }
 
-                    descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                    indexBufferTracker.Apply(device, commands);
-                    device->fn.CmdDrawIndexedIndirect(
-                        commands, indirectBuffer, static_cast<VkDeviceSize>(draw->indirectOffset),
-                        1, 0);
-                    break;
-                }
+        MaybeError operator()(InsertDebugMarkerCmd*, char* label) {
+            RecordInsertDebugMarker(mDevice, mCommands, label);
+            return {};
+        }
 
-                case Command::InsertDebugMarker: {
-                    if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
-                        InsertDebugMarkerCmd* cmd = iter->NextCommand<InsertDebugMarkerCmd>();
-                        const char* label = iter->NextData<char>(cmd->length + 1);
-                        VkDebugMarkerMarkerInfoEXT markerInfo;
-                        markerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
-                        markerInfo.pNext = nullptr;
-                        markerInfo.pMarkerName = label;
-                        // Default color to black
-                        markerInfo.color[0] = 0.0;
-                        markerInfo.color[1] = 0.0;
-                        markerInfo.color[2] = 0.0;
-                        markerInfo.color[3] = 1.0;
-                        device->fn.CmdDebugMarkerInsertEXT(commands, &markerInfo);
-                    } else {
-                        SkipCommand(iter, Command::InsertDebugMarker);
-                    }
-                    break;
-                }
+        MaybeError operator()(PopDebugGroupCmd*, CommandData<PopDebugGroupCmd>::Type*) {
+            RecordPopDebugGroup(mDevice, mCommands);
+            return {};
+        }
 
-                case Command::PopDebugGroup: {
-                    if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
-                        iter->NextCommand<PopDebugGroupCmd>();
-                        device->fn.CmdDebugMarkerEndEXT(commands);
-                    } else {
-                        SkipCommand(iter, Command::PopDebugGroup);
-                    }
-                    break;
-                }
+        MaybeError operator()(PushDebugGroupCmd*, char* label) {
+            RecordPushDebugGroup(mDevice, mCommands, label);
+            return {};
+        }
 
-                case Command::PushDebugGroup: {
-                    if (device->GetDeviceInfo().HasExt(DeviceExt::DebugMarker)) {
-                        PushDebugGroupCmd* cmd = iter->NextCommand<PushDebugGroupCmd>();
-                        const char* label = iter->NextData<char>(cmd->length + 1);
-                        VkDebugMarkerMarkerInfoEXT markerInfo;
-                        markerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT;
-                        markerInfo.pNext = nullptr;
-                        markerInfo.pMarkerName = label;
-                        // Default color to black
-                        markerInfo.color[0] = 0.0;
-                        markerInfo.color[1] = 0.0;
-                        markerInfo.color[2] = 0.0;
-                        markerInfo.color[3] = 1.0;
-                        device->fn.CmdDebugMarkerBeginEXT(commands, &markerInfo);
-                    } else {
-                        SkipCommand(iter, Command::PushDebugGroup);
-                    }
-                    break;
-                }
+      private:
+        const PassResourceUsage& NextPassResourceUsage() {
+            return mCommandBuffer->GetResourceUsages().perPass[mNextPassNumber++];
+        }
 
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
-                    BindGroup* bindGroup = ToBackend(cmd->group.Get());
-                    uint32_t* dynamicOffsets = nullptr;
-                    if (cmd->dynamicOffsetCount > 0) {
-                        dynamicOffsets = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                    }
+        CommandBuffer* mCommandBuffer;
+        Device* mDevice;
+        CommandRecordingContext* mRecordingContext;
+        VkCommandBuffer mCommands;
+        size_t mNextPassNumber = 0;
+    };
 
-                    descriptorSets.OnSetBindGroup(cmd->index, bindGroup, cmd->dynamicOffsetCount,
-                                                  dynamicOffsets);
-                    break;
-                }
+    // static
+    CommandBuffer* CommandBuffer::Create(CommandEncoder* encoder,
+                                         const CommandBufferDescriptor* descriptor) {
+        return new CommandBuffer(encoder, descriptor);
+    }
 
-                case Command::SetIndexBuffer: {
-                    SetIndexBufferCmd* cmd = iter->NextCommand<SetIndexBufferCmd>();
-                    VkBuffer indexBuffer = ToBackend(cmd->buffer)->GetHandle();
+    CommandBuffer::CommandBuffer(CommandEncoder* encoder, const CommandBufferDescriptor* descriptor)
+        : CommandBufferBase(encoder, descriptor) {
+    }
 
-                    indexBufferTracker.OnSetIndexBuffer(indexBuffer, cmd->format,
-                                                        static_cast<VkDeviceSize>(cmd->offset));
-                    break;
-                }
+    MaybeError CommandBuffer::RecordCopies(CommandRecordingContext* recordingContext,
+                                           Command type) {
+        // Prepare as many of the following copies as possible, then come back to the first one to
+        // record all of them after a single barrier.
+        CommandIterator::Position firstCopyPosition = mCommands.GetPosition();
+        Command firstCopyType = type;
+
+        BarrierBatch barriers;
+        CopyPreparer preparer(recordingContext, &barriers);
+        size_t copyCount = 0;
+        do {
+            if (!IsCopyCommand(type) || copyCount == kMaxBatchedCopies ||
+                !VisitCommand(&mCommands, type, preparer)) {
+                break;
+            }
+            copyCount++;
+        } while (mCommands.NextCommandId(&type));
+        ASSERT(copyCount > 0);
 
-                case Command::SetRenderPipeline: {
-                    SetRenderPipelineCmd* cmd = iter->NextCommand<SetRenderPipelineCmd>();
-                    RenderPipeline* pipeline = ToBackend(cmd->pipeline).Get();
+        Device* device = ToBackend(GetDevice());
+        barriers.RecordBarriers(device, recordingContext);
+
+        mCommands.SetPosition(firstCopyPosition);
+        type = firstCopyType;
+        CopyRecorder recorder(device, recordingContext);
+        for (size_t i = 0; i < copyCount; ++i) {
+            if (i > 0) {
+                bool hasNextCopy = mCommands.NextCommandId(&type);
+                ASSERT(hasNextCopy);
+            }
+            DAWN_TRY(VisitCommand(&mCommands, type, recorder));
+        }
+        return {};
+    }
 
-                    device->fn.CmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                               pipeline->GetHandle());
-                    lastPipeline = pipeline;
+    MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* recordingContext) {
+        // QuerySet must be reset between uses.
+        ResetUsedQuerySets(ToBackend(GetDevice()), recordingContext->commandBuffer,
+                           GetResourceUsages().usedQuerySets);
 
-                    descriptorSets.OnSetPipeline(pipeline);
-                    indexBufferTracker.OnSetPipeline(pipeline);
-                    break;
-                }
+        CommandRecorder recorder(this, recordingContext);
 
-                case Command::SetVertexBuffer: {
-                    SetVertexBufferCmd* cmd = iter->NextCommand<SetVertexBufferCmd>();
-                    VkBuffer buffer = ToBackend(cmd->buffer)->GetHandle();
-                    VkDeviceSize offset = static_cast<VkDeviceSize>(cmd->offset);
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            if (IsCopyCommand(type)) {
+                DAWN_TRY(RecordCopies(recordingContext, type));
+            } else {
+                DAWN_TRY(VisitCommand(&mCommands, type, recorder));
+            }
+        }
 
-                    device->fn.CmdBindVertexBuffers(commands, static_cast<uint8_t>(cmd->slot), 1,
-                                                    &*buffer, &offset);
-                    break;
-                }
+        return {};
+    }
 
-                default:
-                    UNREACHABLE();
-                    break;
-            }
-        };
+    MaybeError CommandBuffer::RecordComputePass(CommandRecordingContext* recordingContext) {
+        ComputePassRecorder recorder(ToBackend(GetDevice()), recordingContext);
 
         Command type;
         while (mCommands.NextCommandId(&type)) {
-            switch (type) {
-                case Command::EndRenderPass: {
-                    mCommands.NextCommand<EndRenderPassCmd>();
-                    device->fn.CmdEndRenderPass(commands);
-                    return {};
-                }
-
-                case Command::SetBlendColor: {
-                    SetBlendColorCmd* cmd = mCommands.NextCommand<SetBlendColorCmd>();
-                    const std::array<float, 4> blendConstants = ConvertToFloatColor(cmd->color);
-                    device->fn.CmdSetBlendConstants(commands, blendConstants.data());
-                    break;
-                }
-
-                case Command::SetStencilReference: {
-                    SetStencilReferenceCmd* cmd = mCommands.NextCommand<SetStencilReferenceCmd>();
-                    device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK,
-                                                      cmd->reference);
-                    break;
-                }
+            if (type == Command::EndComputePass) {
+                mCommands.NextCommand<EndComputePassCmd>();
+                return {};
+            }
+            VisitCommand(&mCommands, type, recorder);
+        }
 
-                case Command::SetViewport: {
-                    SetViewportCmd* cmd = mCommands.NextCommand<SetViewportCmd>();
-                    VkViewport viewport;
-                    viewport.x = cmd->x;
-                    viewport.y = cmd->y + cmd->height;
-                    viewport.width = cmd->width;
-                    viewport.height = -cmd->height;
-                    viewport.minDepth = cmd->minDepth;
-                    viewport.maxDepth = cmd->maxDepth;
-
-                    // Vulkan disallows width = 0, but VK_KHR_maintenance1 which we require allows
-                    // height = 0 so use that to do an empty viewport.
-                    if (viewport.width == 0) {
-                        viewport.height = 0;
-
-                        // Set the viewport x range to a range that's always valid.
-                        viewport.x = 0;
-                        viewport.width = 1;
-                    }
+        // EndComputePass should have been called
+        UNREACHABLE();
+    }
 
-                    device->fn.CmdSetViewport(commands, 0, 1, &viewport);
-                    break;
-                }
+    MaybeError CommandBuffer::RecordRenderPass(CommandRecordingContext* recordingContext,
+                                               BeginRenderPassCmd* renderPassCmd) {
+        Device* device = ToBackend(GetDevice());
+        VkCommandBuffer commands = recordingContext->commandBuffer;
 
-                case Command::SetScissorRect: {
-                    SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
-                    VkRect2D rect;
-                    rect.offset.x = cmd->x;
-                    rect.offset.y = cmd->y;
-                    rect.extent.width = cmd->width;
-                    rect.extent.height = cmd->height;
+        // Split the pass in chunks to record them in parallel, unless it is too small to benefit
+        // from it. Splitting reads the commands up to the end of the pass.
+        std::vector<RenderPassChunk> chunks;
+        CommandRecordingWorkers* workers = device->GetCommandRecordingWorkers();
+        if (workers != nullptr) {
+            CommandIterator::Position passStart = mCommands.GetPosition();
+            chunks = SplitRenderPass(&mCommands);
+            if (chunks.size() < 2) {
+                mCommands.SetPosition(passStart);
+                chunks.clear();
+            }
+        }
 
-                    device->fn.CmdSetScissor(commands, 0, 1, &rect);
-                    break;
-                }
+        VkCommandBufferInheritanceInfo inheritanceInfo;
+        DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd,
+                                       chunks.empty()
+                                           ? VK_SUBPASS_CONTENTS_INLINE
+                                           : VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS,
+                                       &inheritanceInfo));
 
-                case Command::ExecuteBundles: {
-                    ExecuteBundlesCmd* cmd = mCommands.NextCommand<ExecuteBundlesCmd>();
-                    auto bundles = mCommands.NextData<Ref<RenderBundleBase>>(cmd->count);
+        if (chunks.empty()) {
+            RenderPassRecorder recorder(device, commands);
+            recorder.RecordDefaultDynamicState(renderPassCmd);
 
-                    for (uint32_t i = 0; i < cmd->count; ++i) {
-                        CommandIterator* iter = bundles[i]->GetCommands();
-                        iter->Reset();
-                        while (iter->NextCommandId(&type)) {
-                            EncodeRenderBundleCommand(iter, type);
-                        }
-                    }
-                    break;
+            Command type;
+            while (mCommands.NextCommandId(&type)) {
+                if (type == Command::EndRenderPass) {
+                    mCommands.NextCommand<EndRenderPassCmd>();
+                    device->fn.CmdEndRenderPass(commands);
+                    return {};
                 }
+                recorder.RecordCommand(&mCommands, type);
+            }
 
-                case Command::WriteTimestamp: {
-                    WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
-
-                    RecordWriteTimestampCmd(recordingContext, device, cmd);
-                    break;
-                }
+            // EndRenderPass should have been called
+            UNREACHABLE();
+        }
 
-                default: {
-                    EncodeRenderBundleCommand(&mCommands, type);
-                    break;
+        DAWN_TRY(device->PrepareSecondaryCommandPools(recordingContext, workers->GetThreadCount()));
+
+        std::vector<VkCommandBuffer> secondaryCommands(chunks.size(), VK_NULL_HANDLE);
+        std::vector<MaybeError> results(chunks.size());
+        workers->ParallelFor(
+            static_cast<uint32_t>(chunks.size()), [&](uint32_t threadIndex, uint32_t chunkIndex) {
+                CommandIterator chunkCommands = mCommands.Borrow();
+                results[chunkIndex] = RecordRenderPassChunk(
+                    device, recordingContext, threadIndex, renderPassCmd, inheritanceInfo,
+                    chunks[chunkIndex], &chunkCommands, &secondaryCommands[chunkIndex]);
+            });
+
+        // Return the first error, and discard the others.
+        MaybeError result;
+        for (MaybeError& chunkResult : results) {
+            if (chunkResult.IsError()) {
+                if (result.IsError()) {
+                    chunkResult.AcquireError();
+                } else {
+                    result = std::move(chunkResult);
                 }
             }
         }
+        DAWN_TRY(std::move(result));
 
-        // EndRenderPass should have been called
-        UNREACHABLE();
+        device->fn.CmdExecuteCommands(commands, static_cast<uint32_t>(secondaryCommands.size()),
+                                      secondaryCommands.data());
+        device->fn.CmdEndRenderPass(commands);
+        device->OnSecondaryCommandBuffersRecorded(static_cast<uint32_t>(secondaryCommands.size()));
+        return {};
     }
 
 }}  // namespace dawn_native::vulkan
@@ -22,7 +22,7 @@
 
 namespace dawn_native {
     struct BeginRenderPassCmd;
-    struct TextureCopy;
+    enum class Command;
 }  // namespace dawn_native
 
 namespace dawn_native { namespace vulkan {
@@ -43,10 +43,12 @@ namespace dawn_native { namespace vulkan {
         MaybeError RecordComputePass(CommandRecordingContext* recordingContext);
         MaybeError RecordRenderPass(CommandRecordingContext* recordingContext,
                                     BeginRenderPassCmd* renderPass);
-        void RecordCopyImageWithTemporaryBuffer(CommandRecordingContext* recordingContext,
-                                                const TextureCopy& srcCopy,
-                                                const TextureCopy& dstCopy,
-                                                const Extent3D& copySize);
+
+        // Records the copy of type |type|, whose id was just read, and the copies following it
+        // after a single barrier for all of them.
+        MaybeError RecordCopies(CommandRecordingContext* recordingContext, Command type);
+
+        class CommandRecorder;
     };
 
 }}  // namespace dawn_native::vulkan
@@ -23,6 +23,15 @@
 namespace dawn_native { namespace vulkan {
     class Buffer;
 
+    // The command pool of a recording thread for one submit, and the secondary command buffers
+    // allocated from it. Resetting the pool resets all its command buffers at once.
+    struct SecondaryCommandPool {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> commandBuffers;
+        // The number of command buffers used since the pool was reset.
+        size_t usedCount = 0;
+    };
+
     // Used to track operations that are handled after recording.
     // Currently only tracks semaphores, but may be used to do barrier coalescing in the future.
     struct CommandRecordingContext {
@@ -30,12 +39,11 @@ namespace dawn_native { namespace vulkan {
         std::vector<VkSemaphore> waitSemaphores = {};
         std::vector<VkSemaphore> signalSemaphores = {};
 
-        // The internal buffers used in the workaround of texture-to-texture copies with compressed
-        // formats.
-        std::vector<Ref<Buffer>> tempBuffers;
-
         // For Device state tracking only.
         VkCommandPool commandPool = VK_NULL_HANDLE;
+        // One pool per thread recording secondary command buffers, indexed by the thread index of
+        // CommandRecordingWorkers.
+        std::vector<SecondaryCommandPool> secondaryPools;
         bool used = false;
     };
 
@@ -0,0 +1,110 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/CommandRecordingWorkers.h"
+
+#include "common/Assert.h"
+
+namespace dawn_native { namespace vulkan {
+
+    CommandRecordingWorkers::CommandRecordingWorkers(uint32_t workerCount)
+        : mNextTaskIndex(0), mWorkerCount(workerCount) {
+    }
+
+    CommandRecordingWorkers::~CommandRecordingWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mIsStopping = true;
+        }
+        mWorkAvailable.notify_all();
+        for (std::thread& thread : mThreads) {
+            thread.join();
+        }
+    }
+
+    uint32_t CommandRecordingWorkers::GetThreadCount() const {
+        return mWorkerCount + 1;
+    }
+
+    void CommandRecordingWorkers::ParallelFor(uint32_t taskCount, const Task& task) {
+        if (mWorkerCount == 0 || taskCount <= 1) {
+            for (uint32_t i = 0; i < taskCount; ++i) {
+                task(0, i);
+            }
+            return;
+        }
+
+        // Devices that never split a render pass don't pay for the threads.
+        if (mThreads.empty()) {
+            mThreads.reserve(mWorkerCount);
+            for (uint32_t i = 0; i < mWorkerCount; ++i) {
+                // Thread index 0 is the thread calling ParallelFor.
+                mThreads.emplace_back(&CommandRecordingWorkers::WorkerMain, this, i + 1);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            ASSERT(mBusyWorkerCount == 0);
+            mTask = &task;
+            mTaskCount = taskCount;
+            mNextTaskIndex = 0;
+            mBusyWorkerCount = static_cast<uint32_t>(mThreads.size());
+            mGeneration++;
+        }
+        mWorkAvailable.notify_all();
+
+        RunTasks(0);
+
+        // The workers still reference |task| until they are all done.
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWorkDone.wait(lock, [this]() { return mBusyWorkerCount == 0; });
+        mTask = nullptr;
+    }
+
+    void CommandRecordingWorkers::WorkerMain(uint32_t threadIndex) {
+        uint64_t lastGeneration = 0;
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mWorkAvailable.wait(
+                lock, [&]() { return mIsStopping || mGeneration != lastGeneration; });
+            if (mIsStopping) {
+                return;
+            }
+            lastGeneration = mGeneration;
+
+            lock.unlock();
+            RunTasks(threadIndex);
+            lock.lock();
+
+            ASSERT(mBusyWorkerCount > 0);
+            mBusyWorkerCount--;
+            if (mBusyWorkerCount == 0) {
+                mWorkDone.notify_all();
+            }
+        }
+    }
+
+    void CommandRecordingWorkers::RunTasks(uint32_t threadIndex) {
+        while (true) {
+            uint32_t taskIndex = mNextTaskIndex.fetch_add(1);
+            if (taskIndex >= mTaskCount) {
+                return;
+            }
+            (*mTask)(threadIndex, taskIndex);
+        }
+    }
+
+}}  // namespace dawn_native::vulkan
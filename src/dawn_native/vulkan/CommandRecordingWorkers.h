@@ -0,0 +1,68 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_COMMANDRECORDINGWORKERS_H_
+#define DAWNNATIVE_VULKAN_COMMANDRECORDINGWORKERS_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dawn_native { namespace vulkan {
+
+    // The threads recording secondary command buffers for a device. The workers are started by
+    // the first ParallelFor with more than one task and then sleep until ParallelFor gives them
+    // tasks. The thread calling ParallelFor records tasks too instead of waiting idly.
+    class CommandRecordingWorkers {
+      public:
+        CommandRecordingWorkers(uint32_t workerCount);
+        ~CommandRecordingWorkers();
+
+        // The number of threads recording the tasks, including the thread calling ParallelFor.
+        uint32_t GetThreadCount() const;
+
+        // Calls |task| with each index in [0, taskCount) and returns once all the calls returned.
+        // |task| also gets the index of the thread calling it, which is 0 for the calling thread
+        // and smaller than GetThreadCount(). The calls with the same thread index are never
+        // concurrent so the thread index can select per-thread resources.
+        using Task = std::function<void(uint32_t threadIndex, uint32_t taskIndex)>;
+        void ParallelFor(uint32_t taskCount, const Task& task);
+
+      private:
+        void WorkerMain(uint32_t threadIndex);
+        void RunTasks(uint32_t threadIndex);
+
+        std::mutex mMutex;
+        std::condition_variable mWorkAvailable;
+        std::condition_variable mWorkDone;
+
+        // The ParallelFor being executed, protected by mMutex except for mNextTaskIndex.
+        const Task* mTask = nullptr;
+        uint32_t mTaskCount = 0;
+        std::atomic<uint32_t> mNextTaskIndex;
+        uint32_t mBusyWorkerCount = 0;
+        uint64_t mGeneration = 0;
+        bool mIsStopping = false;
+
+        uint32_t mWorkerCount;
+        std::vector<std::thread> mThreads;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_COMMANDRECORDINGWORKERS_H_
@@ -0,0 +1,217 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/DescriptorPoolManager.h"
+
+#include "common/Constants.h"
+#include "dawn_native/DawnNative.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/VulkanError.h"
+
+#include <algorithm>
+
+namespace dawn_native { namespace vulkan {
+
+    namespace {
+
+        // TODO(enga): Figure out this value.
+        constexpr uint32_t kMaxDescriptorsPerPool = 512;
+
+        // The number of serials a pool stays empty before it is destroyed, so that pools aren't
+        // destroyed and created again when bind group layouts are recreated every few frames.
+        constexpr uint64_t kEmptyPoolSerialsBeforeDestruction = 64;
+
+    }  // anonymous namespace
+
+    struct DescriptorPool {
+        VkDescriptorPool handle = VK_NULL_HANDLE;
+        uint32_t allocatedSetCount = 0;
+        // Set when the driver couldn't allocate a set from the pool even though it isn't full.
+        bool exhausted = false;
+        // The completed serial when the pool became empty.
+        ExecutionSerial emptySinceSerial = ExecutionSerial(0);
+    };
+
+    struct DescriptorPoolList {
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        uint32_t maxSets = 0;
+        std::vector<std::unique_ptr<DescriptorPool>> pools;
+    };
+
+    DescriptorPoolManager::DescriptorPoolManager(Device* device) : mDevice(device) {
+    }
+
+    DescriptorPoolManager::~DescriptorPoolManager() {
+        // The sets still allocated are freed with their pool.
+        for (const auto& it : mPoolLists) {
+            for (const std::unique_ptr<DescriptorPool>& pool : it.second->pools) {
+                mDevice->GetFencedDeleter()->DeleteWhenUnused(pool->handle);
+            }
+        }
+    }
+
+    DescriptorPoolList* DescriptorPoolManager::GetPoolList(
+        const DescriptorCountPerType& descriptorCountPerType) {
+        std::unique_ptr<DescriptorPoolList>& poolList = mPoolLists[descriptorCountPerType];
+        if (poolList != nullptr) {
+            return poolList.get();
+        }
+        poolList = std::make_unique<DescriptorPoolList>();
+
+        // Compute the total number of descriptors for this layout.
+        uint32_t totalDescriptorCount = 0;
+        for (const auto& it : descriptorCountPerType) {
+            ASSERT(it.second > 0);
+            totalDescriptorCount += it.second;
+            poolList->poolSizes.push_back(VkDescriptorPoolSize{it.first, it.second});
+        }
+
+        if (totalDescriptorCount == 0) {
+            // Vulkan requires that valid usage of vkCreateDescriptorPool must have a non-zero
+            // number of pools, each of which has non-zero descriptor counts.
+            // Since the descriptor set layout is empty, we should be able to allocate
+            // |kMaxDescriptorsPerPool| sets from this 1-sized descriptor pool.
+            // The type of this descriptor pool doesn't matter because it is never used.
+            poolList->poolSizes.push_back(
+                VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1});
+            poolList->maxSets = kMaxDescriptorsPerPool;
+        } else {
+            ASSERT(totalDescriptorCount <= kMaxBindingsPerPipelineLayout);
+            static_assert(kMaxBindingsPerPipelineLayout <= kMaxDescriptorsPerPool, "");
+
+            // Compute the total number of descriptors sets that fits given the max.
+            poolList->maxSets = kMaxDescriptorsPerPool / totalDescriptorCount;
+            ASSERT(poolList->maxSets > 0);
+
+            // Grow the number of desciptors in the pool to fit the computed |maxSets|.
+            for (auto& poolSize : poolList->poolSizes) {
+                poolSize.descriptorCount *= poolList->maxSets;
+            }
+        }
+
+        return poolList.get();
+    }
+
+    ResultOrError<DescriptorSetAllocation> DescriptorPoolManager::AllocateSet(
+        DescriptorPoolList* poolList,
+        VkDescriptorSetLayout layout) {
+        VkDescriptorSetAllocateInfo allocateInfo;
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.pNext = nullptr;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &*layout;
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+
+        // The most recently created pools are the most likely to have space left.
+        for (auto it = poolList->pools.rbegin(); it != poolList->pools.rend(); ++it) {
+            DescriptorPool* pool = it->get();
+            if (pool->allocatedSetCount == poolList->maxSets || pool->exhausted) {
+                continue;
+            }
+
+            allocateInfo.descriptorPool = pool->handle;
+            ::VkResult result =
+                mDevice->fn.AllocateDescriptorSets(mDevice->GetVkDevice(), &allocateInfo, &*set);
+            if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+                pool->exhausted = true;
+                continue;
+            }
+            DAWN_TRY(CheckVkSuccess(result, "AllocateDescriptorSets"));
+
+            pool->allocatedSetCount++;
+            return DescriptorSetAllocation{set, pool};
+        }
+
+        DescriptorPool* pool = nullptr;
+        DAWN_TRY_ASSIGN(pool, CreatePool(poolList));
+
+        allocateInfo.descriptorPool = pool->handle;
+        DAWN_TRY(CheckVkSuccess(
+            mDevice->fn.AllocateDescriptorSets(mDevice->GetVkDevice(), &allocateInfo, &*set),
+            "AllocateDescriptorSets"));
+
+        pool->allocatedSetCount++;
+        return DescriptorSetAllocation{set, pool};
+    }
+
+    void DescriptorPoolManager::FreeSet(const DescriptorSetAllocation& allocation) {
+        DescriptorPool* pool = allocation.pool;
+        ASSERT(pool != nullptr && pool->allocatedSetCount > 0);
+
+        VkDescriptorSet set = allocation.set;
+        mDevice->fn.FreeDescriptorSets(mDevice->GetVkDevice(), pool->handle, 1, &*set);
+        pool->allocatedSetCount--;
+        pool->exhausted = false;
+
+        if (pool->allocatedSetCount == 0) {
+            pool->emptySinceSerial = mDevice->GetCompletedCommandSerial();
+        }
+    }
+
+    void DescriptorPoolManager::RecordSetReused() {
+        mSetsReused++;
+    }
+
+    void DescriptorPoolManager::Tick(ExecutionSerial completedSerial) {
+        for (const auto& it : mPoolLists) {
+            std::vector<std::unique_ptr<DescriptorPool>>& pools = it.second->pools;
+            auto isIdle = [&](const std::unique_ptr<DescriptorPool>& pool) {
+                return pool->allocatedSetCount == 0 &&
+                       uint64_t(completedSerial) >=
+                           uint64_t(pool->emptySinceSerial) + kEmptyPoolSerialsBeforeDestruction;
+            };
+
+            auto firstIdle = std::stable_partition(
+                pools.begin(), pools.end(),
+                [&](const std::unique_ptr<DescriptorPool>& pool) { return !isIdle(pool); });
+            for (auto pool = firstIdle; pool != pools.end(); ++pool) {
+                mDevice->GetFencedDeleter()->DeleteWhenUnused((*pool)->handle);
+                mPoolCount--;
+            }
+            pools.erase(firstIdle, pools.end());
+        }
+    }
+
+    void DescriptorPoolManager::ReportCounters(DeviceCounters* counters) const {
+        counters->liveDescriptorPools += mPoolCount;
+        counters->descriptorSetsReused += mSetsReused;
+    }
+
+    ResultOrError<DescriptorPool*> DescriptorPoolManager::CreatePool(
+        DescriptorPoolList* poolList) {
+        VkDescriptorPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        // Sets are freed individually when the layout that allocated them is destroyed.
+        createInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        createInfo.maxSets = poolList->maxSets;
+        createInfo.poolSizeCount = static_cast<uint32_t>(poolList->poolSizes.size());
+        createInfo.pPoolSizes = poolList->poolSizes.data();
+
+        VkDescriptorPool handle = VK_NULL_HANDLE;
+        DAWN_TRY(CheckVkSuccess(mDevice->fn.CreateDescriptorPool(mDevice->GetVkDevice(),
+                                                                 &createInfo, nullptr, &*handle),
+                                "CreateDescriptorPool"));
+
+        std::unique_ptr<DescriptorPool> pool = std::make_unique<DescriptorPool>();
+        pool->handle = handle;
+        poolList->pools.push_back(std::move(pool));
+        mPoolCount++;
+
+        return poolList->pools.back().get();
+    }
+
+}}  // namespace dawn_native::vulkan
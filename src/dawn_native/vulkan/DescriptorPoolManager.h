@@ -0,0 +1,78 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_DESCRIPTORPOOLMANAGER_H_
+#define DAWNNATIVE_VULKAN_DESCRIPTORPOOLMANAGER_H_
+
+#include "common/vulkan_platform.h"
+#include "dawn_native/Error.h"
+#include "dawn_native/IntegerTypes.h"
+#include "dawn_native/vulkan/DescriptorSetAllocation.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace dawn_native {
+    struct DeviceCounters;
+}  // namespace dawn_native
+
+namespace dawn_native { namespace vulkan {
+
+    class Device;
+
+    // The number of descriptors of each type in a descriptor set.
+    using DescriptorCountPerType = std::map<VkDescriptorType, uint32_t>;
+
+    struct DescriptorPoolList;
+
+    // Owns the VkDescriptorPools of a device. Descriptor sets with the same number of descriptors
+    // of each type are allocated from the same pools, even when their layouts differ, so that
+    // the many bind group layouts of an application don't each have their own partially used
+    // pools. Since all the sets of a pool have the same size, freeing sets doesn't fragment the
+    // pools. Pools that stay empty for a while are destroyed.
+    class DescriptorPoolManager {
+      public:
+        DescriptorPoolManager(Device* device);
+        ~DescriptorPoolManager();
+
+        // Returns the pools for the descriptor sets with these descriptor counts. The list is
+        // valid for the lifetime of the manager.
+        DescriptorPoolList* GetPoolList(const DescriptorCountPerType& descriptorCountPerType);
+
+        ResultOrError<DescriptorSetAllocation> AllocateSet(DescriptorPoolList* poolList,
+                                                           VkDescriptorSetLayout layout);
+        // Frees the set immediately: the GPU must not be using it anymore.
+        void FreeSet(const DescriptorSetAllocation& allocation);
+
+        void RecordSetReused();
+
+        // Destroys the pools that have been empty for long enough.
+        void Tick(ExecutionSerial completedSerial);
+
+        void ReportCounters(DeviceCounters* counters) const;
+
+      private:
+        ResultOrError<DescriptorPool*> CreatePool(DescriptorPoolList* poolList);
+
+        Device* mDevice;
+        std::map<DescriptorCountPerType, std::unique_ptr<DescriptorPoolList>> mPoolLists;
+
+        uint64_t mPoolCount = 0;
+        uint64_t mSetsReused = 0;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_DESCRIPTORPOOLMANAGER_H_
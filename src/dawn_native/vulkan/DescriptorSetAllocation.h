@@ -19,11 +19,12 @@
 
 namespace dawn_native { namespace vulkan {
 
+    struct DescriptorPool;
+
     // Contains a descriptor set along with data necessary to track its allocation.
     struct DescriptorSetAllocation {
         VkDescriptorSet set = VK_NULL_HANDLE;
-        uint32_t poolIndex;
-        uint16_t setIndex;
+        DescriptorPool* pool = nullptr;
     };
 
 }}  // namespace dawn_native::vulkan
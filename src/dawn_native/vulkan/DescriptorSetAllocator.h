@@ -19,6 +19,7 @@
 #include "common/vulkan_platform.h"
 #include "dawn_native/Error.h"
 #include "dawn_native/IntegerTypes.h"
+#include "dawn_native/vulkan/DescriptorPoolManager.h"
 #include "dawn_native/vulkan/DescriptorSetAllocation.h"
 
 #include <map>
@@ -28,39 +29,36 @@ namespace dawn_native { namespace vulkan {
 
     class BindGroupLayout;
 
-    class DescriptorSetAllocator {
-        using PoolIndex = uint32_t;
-        using SetIndex = uint16_t;
+    // Identifies the descriptors written in a descriptor set: the ID, offset and size of the
+    // resource of each binding, in binding index order. The resource IDs are never reused so two
+    // sets with the same content contain the same descriptors.
+    using DescriptorSetContent = std::vector<uint64_t>;
 
+    // Allocates the descriptor sets of a bind group layout from the device's descriptor pools.
+    // Freed sets are kept for the next bind groups of the layout, grouped by their content so
+    // that a bind group with the same content as a previous one gets a set that doesn't need to
+    // be written again.
+    class DescriptorSetAllocator {
       public:
         DescriptorSetAllocator(BindGroupLayout* layout,
-                               std::map<VkDescriptorType, uint32_t> descriptorCountPerType);
+                               const DescriptorCountPerType& descriptorCountPerType);
         ~DescriptorSetAllocator();
 
-        ResultOrError<DescriptorSetAllocation> Allocate();
-        void Deallocate(DescriptorSetAllocation* allocationInfo);
+        // |needsWrite| is set to false when the set already contains the descriptors of |content|.
+        ResultOrError<DescriptorSetAllocation> Allocate(const DescriptorSetContent& content,
+                                                        bool* needsWrite);
+        void Deallocate(DescriptorSetAllocation* allocationInfo, DescriptorSetContent content);
         void FinishDeallocation(ExecutionSerial completedSerial);
 
       private:
-        MaybeError AllocateDescriptorPool();
-
         BindGroupLayout* mLayout;
+        DescriptorPoolList* mPoolList;
 
-        std::vector<VkDescriptorPoolSize> mPoolSizes;
-        SetIndex mMaxSets;
-
-        struct DescriptorPool {
-            VkDescriptorPool vkPool;
-            std::vector<VkDescriptorSet> sets;
-            std::vector<SetIndex> freeSetIndices;
-        };
-
-        std::vector<PoolIndex> mAvailableDescriptorPoolIndices;
-        std::vector<DescriptorPool> mDescriptorPools;
+        std::map<DescriptorSetContent, std::vector<DescriptorSetAllocation>> mFreeSets;
 
         struct Deallocation {
-            PoolIndex poolIndex;
-            SetIndex setIndex;
+            DescriptorSetAllocation allocation;
+            DescriptorSetContent content;
         };
         SerialQueue<ExecutionSerial, Deallocation> mPendingDeallocations;
         ExecutionSerial mLastDeallocationSerial = ExecutionSerial(0);
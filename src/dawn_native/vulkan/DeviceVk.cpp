@@ -25,8 +25,11 @@
 #include "dawn_native/vulkan/BindGroupVk.h"
 #include "dawn_native/vulkan/BufferVk.h"
 #include "dawn_native/vulkan/CommandBufferVk.h"
+#include "dawn_native/vulkan/CommandRecordingWorkers.h"
 #include "dawn_native/vulkan/ComputePipelineVk.h"
+#include "dawn_native/vulkan/DescriptorPoolManager.h"
 #include "dawn_native/vulkan/FencedDeleter.h"
+#include "dawn_native/vulkan/PipelineCache.h"
 #include "dawn_native/vulkan/PipelineLayoutVk.h"
 #include "dawn_native/vulkan/QuerySetVk.h"
 #include "dawn_native/vulkan/QueueVk.h"
@@ -41,8 +44,19 @@
 #include "dawn_native/vulkan/UtilsVulkan.h"
 #include "dawn_native/vulkan/VulkanError.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace dawn_native { namespace vulkan {
 
+    namespace {
+
+        // The recording of render passes doesn't scale much past a few threads because the
+        // recording thread is also splitting the passes and submitting them.
+        constexpr uint32_t kMaxRecordingWorkers = 3;
+
+    }  // anonymous namespace
+
     // static
     ResultOrError<Device*> Device::Create(Adapter* adapter, const DeviceDescriptor* descriptor) {
         Ref<Device> device = AcquireRef(new Device(adapter, descriptor));
@@ -83,9 +97,18 @@ namespace dawn_native { namespace vulkan {
             mDeleter = std::make_unique<FencedDeleter>(this);
         }
 
+        mDescriptorPoolManager = std::make_unique<DescriptorPoolManager>(this);
+        DAWN_TRY_ASSIGN(mPipelineCache, PipelineCache::Create(this));
         mRenderPassCache = std::make_unique<RenderPassCache>(this);
         mResourceMemoryAllocator = std::make_unique<ResourceMemoryAllocator>(this);
 
+        if (IsToggleEnabled(Toggle::VulkanRecordRenderPassesInParallel)) {
+            uint32_t coreCount = std::thread::hardware_concurrency();
+            uint32_t workerCount =
+                coreCount > 1 ? std::min(coreCount - 1, kMaxRecordingWorkers) : 0;
+            mRecordingWorkers = std::make_unique<CommandRecordingWorkers>(workerCount);
+        }
+
         mExternalMemoryService = std::make_unique<external_memory::Service>(this);
         mExternalSemaphoreService = std::make_unique<external_semaphore::Service>(this);
 
@@ -168,6 +191,7 @@ namespace dawn_native { namespace vulkan {
             bgl->FinishDeallocation(completedSerial);
         }
         mBindGroupLayoutsPendingDeallocation.ClearUpTo(completedSerial);
+        mDescriptorPoolManager->Tick(completedSerial);
 
         mResourceMemoryAllocator->Tick(completedSerial);
         mDeleter->Tick(completedSerial);
@@ -198,10 +222,18 @@ namespace dawn_native { namespace vulkan {
         return mQueue;
     }
 
+    DescriptorPoolManager* Device::GetDescriptorPoolManager() const {
+        return mDescriptorPoolManager.get();
+    }
+
     FencedDeleter* Device::GetFencedDeleter() const {
         return mDeleter.get();
     }
 
+    PipelineCache* Device::GetPipelineCache() const {
+        return mPipelineCache.get();
+    }
+
     RenderPassCache* Device::GetRenderPassCache() const {
         return mRenderPassCache.get();
     }
@@ -210,6 +242,10 @@ namespace dawn_native { namespace vulkan {
         mBindGroupLayoutsPendingDeallocation.Enqueue(bindGroupLayout, GetPendingCommandSerial());
     }
 
+    uint64_t Device::AcquireDescriptorResourceId() {
+        return mNextDescriptorResourceId++;
+    }
+
     CommandRecordingContext* Device::GetPendingRecordingContext() {
         ASSERT(mRecordingContext.commandBuffer != VK_NULL_HANDLE);
         mRecordingContext.used = true;
@@ -258,14 +294,80 @@ namespace dawn_native { namespace vulkan {
         mFencesInFlight.emplace(fence, lastSubmittedSerial);
 
         CommandPoolAndBuffer submittedCommands = {mRecordingContext.commandPool,
-                                                  mRecordingContext.commandBuffer};
-        mCommandsInFlight.Enqueue(submittedCommands, lastSubmittedSerial);
+                                                  mRecordingContext.commandBuffer,
+                                                  std::move(mRecordingContext.secondaryPools)};
+        mCommandsInFlight.Enqueue(std::move(submittedCommands), lastSubmittedSerial);
         mRecordingContext = CommandRecordingContext();
         DAWN_TRY(PrepareRecordingContext());
 
         return {};
     }
 
+    CommandRecordingWorkers* Device::GetCommandRecordingWorkers() const {
+        return mRecordingWorkers.get();
+    }
+
+    MaybeError Device::PrepareSecondaryCommandPools(CommandRecordingContext* recordingContext,
+                                                    uint32_t threadCount) {
+        std::vector<SecondaryCommandPool>& pools = recordingContext->secondaryPools;
+        while (pools.size() < threadCount) {
+            VkCommandPoolCreateInfo createInfo;
+            createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            createInfo.pNext = nullptr;
+            createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            createInfo.queueFamilyIndex = mQueueFamily;
+
+            SecondaryCommandPool pool;
+            DAWN_TRY(CheckVkSuccess(
+                fn.CreateCommandPool(mVkDevice, &createInfo, nullptr, &*pool.pool),
+                "vkCreateCommandPool"));
+            pools.push_back(std::move(pool));
+        }
+        return {};
+    }
+
+    ResultOrError<VkCommandBuffer> Device::GetSecondaryCommandBuffer(
+        CommandRecordingContext* recordingContext,
+        uint32_t threadIndex) {
+        ASSERT(threadIndex < recordingContext->secondaryPools.size());
+        SecondaryCommandPool& pool = recordingContext->secondaryPools[threadIndex];
+
+        // The command buffers of the pool were reset with it so they can be recorded again.
+        if (pool.usedCount == pool.commandBuffers.size()) {
+            VkCommandBufferAllocateInfo allocateInfo;
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.pNext = nullptr;
+            allocateInfo.commandPool = pool.pool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocateInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            DAWN_TRY(CheckVkSuccess(
+                fn.AllocateCommandBuffers(mVkDevice, &allocateInfo, &commandBuffer),
+                "vkAllocateCommandBuffers"));
+            pool.commandBuffers.push_back(commandBuffer);
+        }
+
+        return pool.commandBuffers[pool.usedCount++];
+    }
+
+    void Device::OnSecondaryCommandBuffersRecorded(uint32_t count) {
+        mSecondaryCommandBuffersRecorded += count;
+    }
+
+    void Device::DestroySecondaryCommandPools(std::vector<SecondaryCommandPool>* pools) {
+        for (const SecondaryCommandPool& pool : *pools) {
+            // See the comment in ShutDownImpl about freeing the command buffers.
+            if (!pool.commandBuffers.empty()) {
+                fn.FreeCommandBuffers(mVkDevice, pool.pool,
+                                      static_cast<uint32_t>(pool.commandBuffers.size()),
+                                      pool.commandBuffers.data());
+            }
+            fn.DestroyCommandPool(mVkDevice, pool.pool, nullptr);
+        }
+        pools->clear();
+    }
+
     ResultOrError<VulkanDeviceKnobs> Device::CreateDevice(VkPhysicalDevice physicalDevice) {
         VulkanDeviceKnobs usedKnobs = {};
 
@@ -533,13 +635,22 @@ namespace dawn_native { namespace vulkan {
 
         // First try to recycle unused command pools.
         if (!mUnusedCommands.empty()) {
-            CommandPoolAndBuffer commands = mUnusedCommands.back();
+            CommandPoolAndBuffer commands = std::move(mUnusedCommands.back());
             mUnusedCommands.pop_back();
             DAWN_TRY(CheckVkSuccess(fn.ResetCommandPool(mVkDevice, commands.pool, 0),
                                     "vkResetCommandPool"));
 
+            // Each pool of the recording threads is reset once for all its secondary command
+            // buffers, instead of resetting them one by one.
+            for (SecondaryCommandPool& pool : commands.secondaryPools) {
+                DAWN_TRY(CheckVkSuccess(fn.ResetCommandPool(mVkDevice, pool.pool, 0),
+                                        "vkResetCommandPool"));
+                pool.usedCount = 0;
+            }
+
             mRecordingContext.commandBuffer = commands.commandBuffer;
             mRecordingContext.commandPool = commands.pool;
+            mRecordingContext.secondaryPools = std::move(commands.secondaryPools);
         } else {
             // Create a new command pool for our commands and allocate the command buffer.
             VkCommandPoolCreateInfo createInfo;
@@ -577,7 +688,7 @@ namespace dawn_native { namespace vulkan {
 
     void Device::RecycleCompletedCommands() {
         for (auto& commands : mCommandsInFlight.IterateUpTo(GetCompletedCommandSerial())) {
-            mUnusedCommands.push_back(commands);
+            mUnusedCommands.push_back(std::move(commands));
         }
         mCommandsInFlight.ClearUpTo(GetCompletedCommandSerial());
     }
@@ -798,6 +909,15 @@ namespace dawn_native { namespace vulkan {
         return mResourceMemoryAllocator->FindBestTypeIndex(requirements, mappable);
     }
 
+    void Device::ReportBackendMemoryUsage(DeviceMemoryUsage* usage) const {
+        mResourceMemoryAllocator->ReportMemoryUsage(usage);
+    }
+
+    void Device::ReportBackendCounters(DeviceCounters* counters) const {
+        mDescriptorPoolManager->ReportCounters(counters);
+        counters->secondaryCommandBuffersRecorded += mSecondaryCommandBuffersRecorded;
+    }
+
     ResourceMemoryAllocator* Device::GetResourceMemoryAllocatorForTesting() const {
         return mResourceMemoryAllocator.get();
     }
@@ -812,8 +932,9 @@ namespace dawn_native { namespace vulkan {
         // ShutDownImpl
         if (mRecordingContext.used) {
             CommandPoolAndBuffer commands = {mRecordingContext.commandPool,
-                                             mRecordingContext.commandBuffer};
-            mUnusedCommands.push_back(commands);
+                                             mRecordingContext.commandBuffer,
+                                             std::move(mRecordingContext.secondaryPools)};
+            mUnusedCommands.push_back(std::move(commands));
             mRecordingContext = CommandRecordingContext();
         }
 
@@ -878,6 +999,7 @@ namespace dawn_native { namespace vulkan {
                                   &mRecordingContext.commandBuffer);
             fn.DestroyCommandPool(mVkDevice, mRecordingContext.commandPool, nullptr);
         }
+        DestroySecondaryCommandPools(&mRecordingContext.secondaryPools);
 
         for (VkSemaphore semaphore : mRecordingContext.waitSemaphores) {
             fn.DestroySemaphore(mVkDevice, semaphore, nullptr);
@@ -890,13 +1012,14 @@ namespace dawn_native { namespace vulkan {
         mRecordingContext.signalSemaphores.clear();
 
         ASSERT(mCommandsInFlight.Empty());
-        for (const CommandPoolAndBuffer& commands : mUnusedCommands) {
+        for (CommandPoolAndBuffer& commands : mUnusedCommands) {
             // The VkCommandBuffer memory should be wholly owned by the pool and freed when it is
             // destroyed, but that's not the case in some drivers and the leak memory.
             // So we call FreeCommandBuffers before DestroyCommandPool to be safe.
             // TODO(enga): Only do this on a known list of bad drivers.
             fn.FreeCommandBuffers(mVkDevice, commands.pool, 1, &commands.commandBuffer);
             fn.DestroyCommandPool(mVkDevice, commands.pool, nullptr);
+            DestroySecondaryCommandPools(&commands.secondaryPools);
         }
         mUnusedCommands.clear();
 
@@ -913,6 +1036,16 @@ namespace dawn_native { namespace vulkan {
         // Allow recycled memory to be deleted.
         mResourceMemoryAllocator->DestroyPool();
 
+        // Keep the pipelines compiled by the driver for the next runs of the application. The
+        // pipelines created from the cache don't depend on it so it can be destroyed now.
+        if (mPipelineCache != nullptr) {
+            mPipelineCache->Store();
+            mPipelineCache = nullptr;
+        }
+
+        // All the bind group layouts are destroyed so the descriptor pools can be deleted.
+        mDescriptorPoolManager = nullptr;
+
         // The VkRenderPasses in the cache can be destroyed immediately since all commands referring
         // to them are guaranteed to be finished executing.
         mRenderPassCache = nullptr;
@@ -36,7 +36,10 @@ namespace dawn_native { namespace vulkan {
     class Adapter;
     class BindGroupLayout;
     class BufferUploader;
+    class CommandRecordingWorkers;
+    class DescriptorPoolManager;
     class FencedDeleter;
+    class PipelineCache;
     class RenderPassCache;
     class ResourceMemoryAllocator;
 
@@ -57,14 +60,33 @@ namespace dawn_native { namespace vulkan {
         VkQueue GetQueue() const;
 
         BufferUploader* GetBufferUploader() const;
+        DescriptorPoolManager* GetDescriptorPoolManager() const;
         FencedDeleter* GetFencedDeleter() const;
+        PipelineCache* GetPipelineCache() const;
         RenderPassCache* GetRenderPassCache() const;
 
         CommandRecordingContext* GetPendingRecordingContext();
         MaybeError SubmitPendingCommands();
 
+        // Returns nullptr when the render passes aren't recorded in parallel.
+        CommandRecordingWorkers* GetCommandRecordingWorkers() const;
+        // Creates the command pools of the threads recording secondary command buffers for the
+        // recording context. Must be called before the threads get their command buffers.
+        MaybeError PrepareSecondaryCommandPools(CommandRecordingContext* recordingContext,
+                                                uint32_t threadCount);
+        // Returns an unused secondary command buffer from the pool of |threadIndex|. The threads
+        // can call it concurrently as long as they use different thread indices.
+        ResultOrError<VkCommandBuffer> GetSecondaryCommandBuffer(
+            CommandRecordingContext* recordingContext,
+            uint32_t threadIndex);
+        void OnSecondaryCommandBuffersRecorded(uint32_t count);
+
         void EnqueueDeferredDeallocation(BindGroupLayout* bindGroupLayout);
 
+        // Returns an ID that no other resource of the device has, used to know which resources
+        // are written in the descriptor sets.
+        uint64_t AcquireDescriptorResourceId();
+
         // Dawn Native API
 
         TextureBase* CreateTextureWrappingVulkanImage(
@@ -159,17 +181,24 @@ namespace dawn_native { namespace vulkan {
         uint32_t mQueueFamily = 0;
         VkQueue mQueue = VK_NULL_HANDLE;
         uint32_t mComputeSubgroupSize = 0;
+        uint64_t mNextDescriptorResourceId = 1;
 
         SerialQueue<ExecutionSerial, Ref<BindGroupLayout>> mBindGroupLayoutsPendingDeallocation;
         std::unique_ptr<FencedDeleter> mDeleter;
+        std::unique_ptr<DescriptorPoolManager> mDescriptorPoolManager;
         std::unique_ptr<ResourceMemoryAllocator> mResourceMemoryAllocator;
+        std::unique_ptr<PipelineCache> mPipelineCache;
         std::unique_ptr<RenderPassCache> mRenderPassCache;
+        std::unique_ptr<CommandRecordingWorkers> mRecordingWorkers;
+        uint64_t mSecondaryCommandBuffersRecorded = 0;
 
         std::unique_ptr<external_memory::Service> mExternalMemoryService;
         std::unique_ptr<external_semaphore::Service> mExternalSemaphoreService;
 
         ResultOrError<VkFence> GetUnusedFence();
         ExecutionSerial CheckAndUpdateCompletedSerials() override;
+        void ReportBackendMemoryUsage(DeviceMemoryUsage* usage) const override;
+        void ReportBackendCounters(DeviceCounters* counters) const override;
 
         // We track which operations are in flight on the GPU with an increasing serial.
         // This works only because we have a single queue. Each submit to a queue is associated
@@ -181,10 +210,12 @@ namespace dawn_native { namespace vulkan {
 
         MaybeError PrepareRecordingContext();
         void RecycleCompletedCommands();
+        void DestroySecondaryCommandPools(std::vector<SecondaryCommandPool>* pools);
 
         struct CommandPoolAndBuffer {
             VkCommandPool pool = VK_NULL_HANDLE;
             VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            std::vector<SecondaryCommandPool> secondaryPools;
         };
         SerialQueue<ExecutionSerial, CommandPoolAndBuffer> mCommandsInFlight;
         // Command pools in the unused list haven't been reset yet.
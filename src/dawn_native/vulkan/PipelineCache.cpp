@@ -0,0 +1,174 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_native/vulkan/PipelineCache.h"
+
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_native/vulkan/VulkanError.h"
+#include "dawn_platform/DawnPlatform.h"
+
+#include <cstring>
+
+namespace dawn_native { namespace vulkan {
+
+    namespace {
+
+        constexpr char kKeyPrefix[] = "DawnVulkanPipelineCache";
+
+        // The header at the start of the data returned by vkGetPipelineCacheData.
+        struct PipelineCacheHeader {
+            uint32_t headerSize;
+            uint32_t headerVersion;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        };
+
+        template <typename T>
+        void AppendToKey(std::vector<uint8_t>* key, const T& value) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+            key->insert(key->end(), bytes, bytes + sizeof(T));
+        }
+
+        std::vector<uint8_t> ComputeKey(const VkPhysicalDeviceProperties& properties) {
+            std::vector<uint8_t> key(kKeyPrefix, kKeyPrefix + sizeof(kKeyPrefix));
+            AppendToKey(&key, properties.vendorID);
+            AppendToKey(&key, properties.deviceID);
+            AppendToKey(&key, properties.driverVersion);
+            AppendToKey(&key, properties.pipelineCacheUUID);
+            return key;
+        }
+
+        // Drivers should ignore data they can't use but some of them crash on it instead, so
+        // the header is checked before giving the data to the driver.
+        bool IsCompatibleData(const std::vector<uint8_t>& data,
+                              const VkPhysicalDeviceProperties& properties) {
+            PipelineCacheHeader header;
+            if (data.size() < sizeof(header)) {
+                return false;
+            }
+            memcpy(&header, data.data(), sizeof(header));
+
+            return header.headerSize >= sizeof(header) && header.headerSize <= data.size() &&
+                   header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                   header.vendorID == properties.vendorID &&
+                   header.deviceID == properties.deviceID &&
+                   memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) ==
+                       0;
+        }
+
+    }  // anonymous namespace
+
+    // static
+    ResultOrError<std::unique_ptr<PipelineCache>> PipelineCache::Create(Device* device) {
+        dawn_platform::CachingInterface* cachingInterface = nullptr;
+        if (device->GetPlatform() != nullptr) {
+            cachingInterface = device->GetPlatform()->GetCachingInterface();
+        }
+
+        std::unique_ptr<PipelineCache> cache(new PipelineCache(device, cachingInterface));
+        DAWN_TRY(cache->Initialize());
+        return std::move(cache);
+    }
+
+    PipelineCache::PipelineCache(Device* device, dawn_platform::CachingInterface* cachingInterface)
+        : mDevice(device),
+          mCachingInterface(cachingInterface),
+          mKey(ComputeKey(device->GetDeviceInfo().properties)) {
+    }
+
+    PipelineCache::~PipelineCache() {
+        if (mHandle != VK_NULL_HANDLE) {
+            mDevice->fn.DestroyPipelineCache(mDevice->GetVkDevice(), mHandle, nullptr);
+            mHandle = VK_NULL_HANDLE;
+        }
+    }
+
+    MaybeError PipelineCache::Initialize() {
+        std::vector<uint8_t> initialData = LoadStoredData();
+
+        VkPipelineCacheCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.initialDataSize = initialData.size();
+        createInfo.pInitialData = initialData.data();
+
+        return CheckVkSuccess(mDevice->fn.CreatePipelineCache(mDevice->GetVkDevice(), &createInfo,
+                                                              nullptr, &*mHandle),
+                              "CreatePipelineCache");
+    }
+
+    VkPipelineCache PipelineCache::GetHandle() const {
+        return mHandle;
+    }
+
+    std::vector<uint8_t> PipelineCache::LoadStoredData() const {
+        std::vector<uint8_t> data;
+        if (mCachingInterface == nullptr) {
+            return data;
+        }
+
+        size_t size = mCachingInterface->LoadData(mKey.data(), mKey.size(), nullptr, 0);
+        if (size == 0) {
+            return data;
+        }
+
+        data.resize(size);
+        // Another device could have stored a larger value in between the two calls.
+        if (mCachingInterface->LoadData(mKey.data(), mKey.size(), data.data(), size) != size ||
+            !IsCompatibleData(data, mDevice->GetDeviceInfo().properties)) {
+            data.clear();
+        }
+        return data;
+    }
+
+    void PipelineCache::Store() {
+        if (mCachingInterface == nullptr) {
+            return;
+        }
+
+        VkDevice device = mDevice->GetVkDevice();
+        const VulkanFunctions& fn = mDevice->fn;
+
+        std::vector<uint8_t> storedData = LoadStoredData();
+        if (!storedData.empty()) {
+            VkPipelineCacheCreateInfo createInfo;
+            createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+            createInfo.pNext = nullptr;
+            createInfo.flags = 0;
+            createInfo.initialDataSize = storedData.size();
+            createInfo.pInitialData = storedData.data();
+
+            VkPipelineCache storedCache = VK_NULL_HANDLE;
+            if (fn.CreatePipelineCache(device, &createInfo, nullptr, &*storedCache) ==
+                VK_SUCCESS) {
+                fn.MergePipelineCaches(device, mHandle, 1, &*storedCache);
+                fn.DestroyPipelineCache(device, storedCache, nullptr);
+            }
+        }
+
+        size_t size = 0;
+        if (fn.GetPipelineCacheData(device, mHandle, &size, nullptr) != VK_SUCCESS || size == 0) {
+            return;
+        }
+        std::vector<uint8_t> data(size);
+        if (fn.GetPipelineCacheData(device, mHandle, &size, data.data()) != VK_SUCCESS) {
+            return;
+        }
+
+        mCachingInterface->StoreData(mKey.data(), mKey.size(), data.data(), size);
+    }
+
+}}  // namespace dawn_native::vulkan
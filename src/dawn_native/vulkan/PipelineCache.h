@@ -0,0 +1,64 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNNATIVE_VULKAN_PIPELINECACHE_H_
+#define DAWNNATIVE_VULKAN_PIPELINECACHE_H_
+
+#include "common/vulkan_platform.h"
+#include "dawn_native/Error.h"
+
+#include <memory>
+#include <vector>
+
+namespace dawn_platform {
+    class CachingInterface;
+}  // namespace dawn_platform
+
+namespace dawn_native { namespace vulkan {
+
+    class Device;
+
+    // The VkPipelineCache used to create all the pipelines of a device. When the platform has a
+    // CachingInterface, the cache is seeded from it and stored back into it when the device is
+    // destroyed, so that the driver doesn't compile the same pipelines again in the next runs.
+    // The data is keyed by the adapter and driver version so that it is only given back to a
+    // driver that can use it.
+    class PipelineCache {
+      public:
+        static ResultOrError<std::unique_ptr<PipelineCache>> Create(Device* device);
+        ~PipelineCache();
+
+        VkPipelineCache GetHandle() const;
+
+        // Merges the data stored by the other devices of the adapter since this cache was
+        // loaded, so that they don't lose their pipelines, then stores the result. The cache is
+        // only an optimization so failures are ignored.
+        void Store();
+
+      private:
+        PipelineCache(Device* device, dawn_platform::CachingInterface* cachingInterface);
+        MaybeError Initialize();
+
+        // Returns the data stored for this adapter, or nothing if it can't be used by the driver.
+        std::vector<uint8_t> LoadStoredData() const;
+
+        Device* mDevice;
+        dawn_platform::CachingInterface* mCachingInterface;
+        std::vector<uint8_t> mKey;
+        VkPipelineCache mHandle = VK_NULL_HANDLE;
+    };
+
+}}  // namespace dawn_native::vulkan
+
+#endif  // DAWNNATIVE_VULKAN_PIPELINECACHE_H_
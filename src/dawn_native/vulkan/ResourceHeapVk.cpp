@@ -16,8 +16,8 @@
 
 namespace dawn_native { namespace vulkan {
 
-    ResourceHeap::ResourceHeap(VkDeviceMemory memory, size_t memoryType)
-        : mMemory(memory), mMemoryType(memoryType) {
+    ResourceHeap::ResourceHeap(VkDeviceMemory memory, size_t memoryType, uint8_t* mappedPointer)
+        : mMemory(memory), mMemoryType(memoryType), mMappedPointer(mappedPointer) {
     }
 
     VkDeviceMemory ResourceHeap::GetMemory() const {
@@ -28,4 +28,8 @@ namespace dawn_native { namespace vulkan {
         return mMemoryType;
     }
 
+    uint8_t* ResourceHeap::GetMappedPointer() const {
+        return mMappedPointer;
+    }
+
 }}  // namespace dawn_native::vulkan
@@ -23,15 +23,19 @@ namespace dawn_native { namespace vulkan {
     // Wrapper for physical memory used with or without a resource object.
     class ResourceHeap : public ResourceHeapBase {
       public:
-        ResourceHeap(VkDeviceMemory memory, size_t memoryType);
+        ResourceHeap(VkDeviceMemory memory, size_t memoryType, uint8_t* mappedPointer = nullptr);
         ~ResourceHeap() = default;
 
         VkDeviceMemory GetMemory() const;
         size_t GetMemoryType() const;
 
+        // The pointer to the start of the memory for heaps that stay mapped while they are alive.
+        uint8_t* GetMappedPointer() const;
+
       private:
         VkDeviceMemory mMemory = VK_NULL_HANDLE;
         size_t mMemoryType = 0;
+        uint8_t* mMappedPointer = nullptr;
     };
 
 }}  // namespace dawn_native::vulkan
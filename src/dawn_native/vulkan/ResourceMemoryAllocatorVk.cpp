@@ -38,14 +38,20 @@ namespace dawn_native { namespace vulkan {
     }  // anonymous namespace
 
     // SingleTypeAllocator is a combination of a BuddyMemoryAllocator and its client and can
-    // service suballocation requests, but for a single Vulkan memory type.
+    // service suballocation requests, but for a single Vulkan memory type. The heaps of mappable
+    // allocators are mapped for as long as they are alive so that each suballocation can be
+    // given a pointer into the mapping.
 
     class ResourceMemoryAllocator::SingleTypeAllocator : public ResourceHeapAllocator {
       public:
-        SingleTypeAllocator(Device* device, size_t memoryTypeIndex, VkDeviceSize memoryHeapSize)
+        SingleTypeAllocator(Device* device,
+                            size_t memoryTypeIndex,
+                            VkDeviceSize memoryHeapSize,
+                            bool mappable)
             : mDevice(device),
               mMemoryTypeIndex(memoryTypeIndex),
               mMemoryHeapSize(memoryHeapSize),
+              mMappable(mappable),
               mPooledMemoryAllocator(this),
               mBuddySystem(
                   // Round down to a power of 2 that's <= mMemoryHeapSize. This will always
@@ -64,13 +70,28 @@ namespace dawn_native { namespace vulkan {
 
         ResultOrError<ResourceMemoryAllocation> AllocateMemory(
             const VkMemoryRequirements& requirements) {
-            return mBuddySystem.Allocate(requirements.size, requirements.alignment);
+            ResourceMemoryAllocation subAllocation;
+            DAWN_TRY_ASSIGN(subAllocation,
+                            mBuddySystem.Allocate(requirements.size, requirements.alignment));
+            if (!mMappable || subAllocation.GetInfo().mMethod == AllocationMethod::kInvalid) {
+                return std::move(subAllocation);
+            }
+
+            ResourceHeap* heap = ToBackend(subAllocation.GetResourceHeap());
+            return ResourceMemoryAllocation(subAllocation.GetInfo(), subAllocation.GetOffset(),
+                                            heap,
+                                            heap->GetMappedPointer() + subAllocation.GetOffset());
         }
 
         void DeallocateMemory(const ResourceMemoryAllocation& allocation) {
             mBuddySystem.Deallocate(allocation);
         }
 
+        void ReportMemoryUsage(DeviceMemoryUsage::SubAllocatorUsage* usage) const {
+            mBuddySystem.ReportMemoryUsage(usage);
+            mPooledMemoryAllocator.ReportMemoryUsage(usage);
+        }
+
         // Implementation of the MemoryAllocator interface to be a client of BuddyMemoryAllocator
 
         ResultOrError<std::unique_ptr<ResourceHeapBase>> AllocateResourceHeap(
@@ -94,7 +115,23 @@ namespace dawn_native { namespace vulkan {
                 "vkAllocateMemory"));
 
             ASSERT(allocatedMemory != VK_NULL_HANDLE);
-            return {std::make_unique<ResourceHeap>(allocatedMemory, mMemoryTypeIndex)};
+
+            // The memory is implicitly unmapped when it is freed.
+            void* mappedPointer = nullptr;
+            if (mMappable) {
+                MaybeError mapResult =
+                    CheckVkSuccess(mDevice->fn.MapMemory(mDevice->GetVkDevice(), allocatedMemory,
+                                                         0, size, 0, &mappedPointer),
+                                   "vkMapMemory");
+                if (mapResult.IsError()) {
+                    // Nothing can be using the memory yet so it is freed immediately.
+                    mDevice->fn.FreeMemory(mDevice->GetVkDevice(), allocatedMemory, nullptr);
+                    return mapResult.AcquireError();
+                }
+            }
+
+            return {std::make_unique<ResourceHeap>(allocatedMemory, mMemoryTypeIndex,
+                                                   static_cast<uint8_t*>(mappedPointer))};
         }
 
         void DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase> allocation) override {
@@ -105,6 +142,7 @@ namespace dawn_native { namespace vulkan {
         Device* mDevice;
         size_t mMemoryTypeIndex;
         VkDeviceSize mMemoryHeapSize;
+        bool mMappable;
         PooledResourceMemoryAllocator mPooledMemoryAllocator;
         BuddyMemoryAllocator mBuddySystem;
     };
@@ -114,10 +152,20 @@ namespace dawn_native { namespace vulkan {
     ResourceMemoryAllocator::ResourceMemoryAllocator(Device* device) : mDevice(device) {
         const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
         mAllocatorsPerType.reserve(info.memoryTypes.size());
+        mMappableAllocatorsPerType.resize(info.memoryTypes.size());
+
+        constexpr VkMemoryPropertyFlags kMappableFlags =
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
 
         for (size_t i = 0; i < info.memoryTypes.size(); i++) {
-            mAllocatorsPerType.emplace_back(std::make_unique<SingleTypeAllocator>(
-                mDevice, i, info.memoryHeaps[info.memoryTypes[i].heapIndex].size));
+            VkDeviceSize heapSize = info.memoryHeaps[info.memoryTypes[i].heapIndex].size;
+            mAllocatorsPerType.emplace_back(
+                std::make_unique<SingleTypeAllocator>(mDevice, i, heapSize, false));
+
+            if ((info.memoryTypes[i].propertyFlags & kMappableFlags) == kMappableFlags) {
+                mMappableAllocatorsPerType[i] =
+                    std::make_unique<SingleTypeAllocator>(mDevice, i, heapSize, true);
+            }
         }
     }
 
@@ -130,15 +178,17 @@ namespace dawn_native { namespace vulkan {
         int memoryType = FindBestTypeIndex(requirements, mappable);
         ASSERT(memoryType >= 0);
 
+        // Mappable resources are allocated in separate heaps that stay mapped, so that the
+        // resources sharing a heap also share its mapping.
+        SingleTypeAllocator* allocator = mappable ? mMappableAllocatorsPerType[memoryType].get()
+                                                  : mAllocatorsPerType[memoryType].get();
+        ASSERT(allocator != nullptr);
+
         VkDeviceSize size = requirements.size;
 
-        // Sub-allocate non-mappable resources because at the moment the mapped pointer
-        // is part of the resource and not the heap, which doesn't match the Vulkan model.
-        // TODO(cwallez@chromium.org): allow sub-allocating mappable resources, maybe.
-        if (requirements.size < kMaxSizeForSubAllocation && !mappable) {
+        if (requirements.size < kMaxSizeForSubAllocation) {
             ResourceMemoryAllocation subAllocation;
-            DAWN_TRY_ASSIGN(subAllocation,
-                            mAllocatorsPerType[memoryType]->AllocateMemory(requirements));
+            DAWN_TRY_ASSIGN(subAllocation, allocator->AllocateMemory(requirements));
             if (subAllocation.GetInfo().mMethod != AllocationMethod::kInvalid) {
                 return std::move(subAllocation);
             }
@@ -146,21 +196,15 @@ namespace dawn_native { namespace vulkan {
 
         // If sub-allocation failed, allocate memory just for it.
         std::unique_ptr<ResourceHeapBase> resourceHeap;
-        DAWN_TRY_ASSIGN(resourceHeap, mAllocatorsPerType[memoryType]->AllocateResourceHeap(size));
-
-        void* mappedPointer = nullptr;
-        if (mappable) {
-            DAWN_TRY(
-                CheckVkSuccess(mDevice->fn.MapMemory(mDevice->GetVkDevice(),
-                                                     ToBackend(resourceHeap.get())->GetMemory(), 0,
-                                                     size, 0, &mappedPointer),
-                               "vkMapMemory"));
-        }
+        DAWN_TRY_ASSIGN(resourceHeap, allocator->AllocateResourceHeap(size));
+        uint8_t* mappedPointer = ToBackend(resourceHeap.get())->GetMappedPointer();
+
+        mDirectlyAllocatedBytes += size;
 
         AllocationInfo info;
+        info.mRequestedSize = size;
         info.mMethod = AllocationMethod::kDirect;
-        return ResourceMemoryAllocation(info, /*offset*/ 0, resourceHeap.release(),
-                                        static_cast<uint8_t*>(mappedPointer));
+        return ResourceMemoryAllocation(info, /*offset*/ 0, resourceHeap.release(), mappedPointer);
     }
 
     void ResourceMemoryAllocator::Deallocate(ResourceMemoryAllocation* allocation) {
@@ -174,6 +218,7 @@ namespace dawn_native { namespace vulkan {
             // deleter will make sure the resources are freed before the memory.
             case AllocationMethod::kDirect: {
                 ResourceHeap* heap = ToBackend(allocation->GetResourceHeap());
+                mDirectlyAllocatedBytes -= allocation->GetInfo().mRequestedSize;
                 allocation->Invalidate();
                 mDevice->GetFencedDeleter()->DeleteWhenUnused(heap->GetMemory());
                 delete heap;
@@ -202,14 +247,31 @@ namespace dawn_native { namespace vulkan {
         for (const ResourceMemoryAllocation& allocation :
              mSubAllocationsToDelete.IterateUpTo(completedSerial)) {
             ASSERT(allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated);
-            size_t memoryType = ToBackend(allocation.GetResourceHeap())->GetMemoryType();
+            ResourceHeap* heap = ToBackend(allocation.GetResourceHeap());
+            size_t memoryType = heap->GetMemoryType();
 
-            mAllocatorsPerType[memoryType]->DeallocateMemory(allocation);
+            if (heap->GetMappedPointer() != nullptr) {
+                mMappableAllocatorsPerType[memoryType]->DeallocateMemory(allocation);
+            } else {
+                mAllocatorsPerType[memoryType]->DeallocateMemory(allocation);
+            }
         }
 
         mSubAllocationsToDelete.ClearUpTo(completedSerial);
     }
 
+    void ResourceMemoryAllocator::ReportMemoryUsage(DeviceMemoryUsage* usage) const {
+        for (const std::unique_ptr<SingleTypeAllocator>& allocator : mAllocatorsPerType) {
+            allocator->ReportMemoryUsage(&usage->subAllocated);
+        }
+        for (const std::unique_ptr<SingleTypeAllocator>& allocator : mMappableAllocatorsPerType) {
+            if (allocator != nullptr) {
+                allocator->ReportMemoryUsage(&usage->subAllocated);
+            }
+        }
+        usage->directlyAllocatedBytes += mDirectlyAllocatedBytes;
+    }
+
     int ResourceMemoryAllocator::FindBestTypeIndex(VkMemoryRequirements requirements,
                                                    bool mappable) {
         const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
@@ -268,6 +330,11 @@ namespace dawn_native { namespace vulkan {
         for (auto& alloc : mAllocatorsPerType) {
             alloc->DestroyPool();
         }
+        for (auto& alloc : mMappableAllocatorsPerType) {
+            if (alloc != nullptr) {
+                alloc->DestroyPool();
+            }
+        }
     }
 
 }}  // namespace dawn_native::vulkan
@@ -44,13 +44,19 @@ namespace dawn_native { namespace vulkan {
 
         int FindBestTypeIndex(VkMemoryRequirements requirements, bool mappable);
 
+        void ReportMemoryUsage(DeviceMemoryUsage* usage) const;
+
       private:
         Device* mDevice;
 
         class SingleTypeAllocator;
         std::vector<std::unique_ptr<SingleTypeAllocator>> mAllocatorsPerType;
+        // Only the host visible and coherent memory types have a mappable allocator.
+        std::vector<std::unique_ptr<SingleTypeAllocator>> mMappableAllocatorsPerType;
 
         SerialQueue<ExecutionSerial, ResourceMemoryAllocation> mSubAllocationsToDelete;
+
+        uint64_t mDirectlyAllocatedBytes = 0;
     };
 
 }}  // namespace dawn_native::vulkan
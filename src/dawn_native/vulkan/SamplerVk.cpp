@@ -60,6 +60,8 @@ namespace dawn_native { namespace vulkan {
     }
 
     MaybeError Sampler::Initialize(const SamplerDescriptor* descriptor) {
+        mDescriptorId = ToBackend(GetDevice())->AcquireDescriptorResourceId();
+
         VkSamplerCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
         createInfo.pNext = nullptr;
@@ -102,4 +104,8 @@ namespace dawn_native { namespace vulkan {
         return mHandle;
     }
 
+    uint64_t Sampler::GetDescriptorId() const {
+        return mDescriptorId;
+    }
+
 }}  // namespace dawn_native::vulkan
@@ -29,6 +29,8 @@ namespace dawn_native { namespace vulkan {
         static ResultOrError<Sampler*> Create(Device* device, const SamplerDescriptor* descriptor);
 
         VkSampler GetHandle() const;
+        // Identifies the sampler in the descriptor sets, see DescriptorSetContent.
+        uint64_t GetDescriptorId() const;
 
       private:
         ~Sampler() override;
@@ -36,6 +38,7 @@ namespace dawn_native { namespace vulkan {
         MaybeError Initialize(const SamplerDescriptor* descriptor);
 
         VkSampler mHandle = VK_NULL_HANDLE;
+        uint64_t mDescriptorId = 0;
     };
 
 }}  // namespace dawn_native::vulkan
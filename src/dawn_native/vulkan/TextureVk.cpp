@@ -904,11 +904,8 @@ namespace dawn_native { namespace vulkan {
         VkPipelineStageFlags srcStages = 0;
         VkPipelineStageFlags dstStages = 0;
 
-        TransitionUsageAndGetResourceBarrier(usage, range, &barriers, &srcStages, &dstStages);
-
-        if (mExternalState != ExternalState::InternalOnly) {
-            TweakTransitionForExternalUsage(recordingContext, &barriers, 0);
-        }
+        TransitionUsageAndGetResourceBarrier(recordingContext, usage, range, &barriers, &srcStages,
+                                             &dstStages);
 
         if (!barriers.empty()) {
             ASSERT(srcStages != 0 && dstStages != 0);
@@ -918,6 +915,22 @@ namespace dawn_native { namespace vulkan {
         }
     }
 
+    void Texture::TransitionUsageAndGetResourceBarrier(
+        CommandRecordingContext* recordingContext,
+        wgpu::TextureUsage usage,
+        const SubresourceRange& range,
+        std::vector<VkImageMemoryBarrier>* imageBarriers,
+        VkPipelineStageFlags* srcStages,
+        VkPipelineStageFlags* dstStages) {
+        size_t transitionBarrierStart = imageBarriers->size();
+        TransitionUsageAndGetResourceBarrier(usage, range, imageBarriers, srcStages, dstStages);
+
+        if (mExternalState != ExternalState::InternalOnly) {
+            TweakTransitionForExternalUsage(recordingContext, imageBarriers,
+                                            transitionBarrierStart);
+        }
+    }
+
     void Texture::TransitionUsageAndGetResourceBarrier(
         wgpu::TextureUsage usage,
         const SubresourceRange& range,
@@ -1003,30 +1016,40 @@ namespace dawn_native { namespace vulkan {
 
         VkImageSubresourceRange imageRange = {};
         imageRange.levelCount = 1;
-        imageRange.layerCount = 1;
+
+        auto GetAspectsToClear = [&](uint32_t level, uint32_t layer) {
+            Aspect aspects = Aspect::None;
+            for (Aspect aspect : IterateEnumMask(range.aspects)) {
+                if (clearValue == TextureBase::ClearValue::Zero &&
+                    IsSubresourceContentInitialized(
+                        SubresourceRange::SingleMipAndLayer(level, layer, aspect))) {
+                    // Skip lazy clears if already initialized.
+                    continue;
+                }
+                aspects |= aspect;
+            }
+            return aspects;
+        };
 
         for (uint32_t level = range.baseMipLevel; level < range.baseMipLevel + range.levelCount;
              ++level) {
             imageRange.baseMipLevel = level;
-            for (uint32_t layer = range.baseArrayLayer;
-                 layer < range.baseArrayLayer + range.layerCount; ++layer) {
-                Aspect aspects = Aspect::None;
-                for (Aspect aspect : IterateEnumMask(range.aspects)) {
-                    if (clearValue == TextureBase::ClearValue::Zero &&
-                        IsSubresourceContentInitialized(
-                            SubresourceRange::SingleMipAndLayer(level, layer, aspect))) {
-                        // Skip lazy clears if already initialized.
-                        continue;
-                    }
-                    aspects |= aspect;
-                }
-
+            uint32_t layer = range.baseArrayLayer;
+            while (layer < range.baseArrayLayer + range.layerCount) {
+                Aspect aspects = GetAspectsToClear(level, layer);
                 if (aspects == Aspect::None) {
+                    ++layer;
                     continue;
                 }
 
-                imageRange.aspectMask = VulkanAspectMask(aspects);
+                // Clear all the following layers that need the same aspects cleared at once.
                 imageRange.baseArrayLayer = layer;
+                do {
+                    ++layer;
+                } while (layer < range.baseArrayLayer + range.layerCount &&
+                         GetAspectsToClear(level, layer) == aspects);
+                imageRange.layerCount = layer - imageRange.baseArrayLayer;
+                imageRange.aspectMask = VulkanAspectMask(aspects);
 
                 if (aspects & (Aspect::Depth | Aspect::Stencil)) {
                     VkClearDepthStencilValue clearDepthStencilValue[1];
@@ -1103,6 +1126,8 @@ namespace dawn_native { namespace vulkan {
     }
 
     MaybeError TextureView::Initialize(const TextureViewDescriptor* descriptor) {
+        mDescriptorId = ToBackend(GetDevice())->AcquireDescriptorResourceId();
+
         if ((GetTexture()->GetUsage() &
              ~(wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::CopyDst)) == 0) {
             // If the texture view has no other usage than CopySrc and CopyDst, then it can't
@@ -1148,4 +1173,8 @@ namespace dawn_native { namespace vulkan {
         return mHandle;
     }
 
+    uint64_t TextureView::GetDescriptorId() const {
+        return mDescriptorId;
+    }
+
 }}  // namespace dawn_native::vulkan
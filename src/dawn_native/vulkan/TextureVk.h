@@ -75,6 +75,14 @@ namespace dawn_native { namespace vulkan {
                                                   std::vector<VkImageMemoryBarrier>* imageBarriers,
                                                   VkPipelineStageFlags* srcStages,
                                                   VkPipelineStageFlags* dstStages);
+        // Same as TransitionUsageNow but adds the barriers to |imageBarriers| so that they can be
+        // recorded with the barriers of other resources.
+        void TransitionUsageAndGetResourceBarrier(CommandRecordingContext* recordingContext,
+                                                  wgpu::TextureUsage usage,
+                                                  const SubresourceRange& range,
+                                                  std::vector<VkImageMemoryBarrier>* imageBarriers,
+                                                  VkPipelineStageFlags* srcStages,
+                                                  VkPipelineStageFlags* dstStages);
         void TransitionUsageForPass(CommandRecordingContext* recordingContext,
                                     const PassTextureUsage& textureUsages,
                                     std::vector<VkImageMemoryBarrier>* imageBarriers,
@@ -147,6 +155,8 @@ namespace dawn_native { namespace vulkan {
         static ResultOrError<TextureView*> Create(TextureBase* texture,
                                                   const TextureViewDescriptor* descriptor);
         VkImageView GetHandle() const;
+        // Identifies the view in the descriptor sets, see DescriptorSetContent.
+        uint64_t GetDescriptorId() const;
 
       private:
         ~TextureView() override;
@@ -154,6 +164,7 @@ namespace dawn_native { namespace vulkan {
         MaybeError Initialize(const TextureViewDescriptor* descriptor);
 
         VkImageView mHandle = VK_NULL_HANDLE;
+        uint64_t mDescriptorId = 0;
     };
 
 }}  // namespace dawn_native::vulkan
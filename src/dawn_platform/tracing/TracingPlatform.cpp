@@ -0,0 +1,322 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dawn_platform/tracing/TracingPlatform.h"
+
+#include "common/Assert.h"
+#include "common/Math.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+
+namespace dawn_platform { namespace tracing {
+
+    namespace {
+
+        constexpr uint32_t kTraceCategoryCount = 4;
+        static_assert(static_cast<uint32_t>(TraceCategory::General) == 0, "");
+        static_assert(static_cast<uint32_t>(TraceCategory::Validation) == 1, "");
+        static_assert(static_cast<uint32_t>(TraceCategory::Recording) == 2, "");
+        static_assert(static_cast<uint32_t>(TraceCategory::GPUWork) == 3, "");
+
+        constexpr const char* kTraceCategoryNames[kTraceCategoryCount] = {
+            "General",
+            "Validation",
+            "Recording",
+            "GPUWork",
+        };
+
+        // The flags returned to the trace macros. Like in the trace macros, they are read and
+        // written without synchronization: a change of the enabled categories is eventually seen
+        // by the recording threads.
+        unsigned char gTraceCategoryEnabled[kTraceCategoryCount] = {};
+
+        std::atomic<uint64_t> gNextInstanceId(1);
+
+        // The buffer of the last TracingPlatform used by this thread. Keyed by instance ID
+        // instead of address in case a platform is allocated where a deleted one was.
+        struct LocalThreadBufferCache {
+            uint64_t instanceId = 0;
+            void* buffer = nullptr;
+        };
+        thread_local LocalThreadBufferCache tLocalThreadBuffer;
+
+        uint8_t CategoryFromEnabledFlag(const unsigned char* categoryGroupEnabled) {
+            // The flag might come from a different Platform if the trace macros cached it first.
+            if (categoryGroupEnabled >= &gTraceCategoryEnabled[0] &&
+                categoryGroupEnabled < &gTraceCategoryEnabled[kTraceCategoryCount]) {
+                return static_cast<uint8_t>(categoryGroupEnabled - &gTraceCategoryEnabled[0]);
+            }
+            return static_cast<uint8_t>(TraceCategory::General);
+        }
+
+        void WriteJSONString(std::ostringstream* stream, const std::string& str) {
+            *stream << '"';
+            for (char c : str) {
+                switch (c) {
+                    case '"':
+                        *stream << "\\\"";
+                        break;
+                    case '\\':
+                        *stream << "\\\\";
+                        break;
+                    case '\n':
+                        *stream << "\\n";
+                        break;
+                    default:
+                        // Control characters aren't allowed in JSON strings.
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            char escaped[7];
+                            snprintf(escaped, sizeof(escaped), "\\u%04x",
+                                     static_cast<unsigned int>(c));
+                            *stream << escaped;
+                        } else {
+                            *stream << c;
+                        }
+                        break;
+                }
+            }
+            *stream << '"';
+        }
+
+    }  // anonymous namespace
+
+    void TracingPlatform::EventSlot::Write(uint64_t index, const Event& event) {
+        // Mark the slot as being written before any of the fields change.
+        sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        timestamp.store(event.timestamp, std::memory_order_relaxed);
+        id.store(event.id, std::memory_order_relaxed);
+        nameIndex.store(event.nameIndex, std::memory_order_relaxed);
+        phase.store(event.phase, std::memory_order_relaxed);
+        category.store(event.category, std::memory_order_relaxed);
+
+        sequence.store(index + 1, std::memory_order_release);
+    }
+
+    bool TracingPlatform::EventSlot::Read(uint64_t index, Event* event) const {
+        if (sequence.load(std::memory_order_acquire) != index + 1) {
+            return false;
+        }
+
+        event->timestamp = timestamp.load(std::memory_order_relaxed);
+        event->id = id.load(std::memory_order_relaxed);
+        event->nameIndex = nameIndex.load(std::memory_order_relaxed);
+        event->phase = phase.load(std::memory_order_relaxed);
+        event->category = category.load(std::memory_order_relaxed);
+
+        // If the owning thread started overwriting the slot during the copy, the fence makes
+        // the sequence it changed visible here.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == index + 1;
+    }
+
+    TracingPlatform::ThreadBuffer::ThreadBuffer(size_t capacity,
+                                                std::thread::id threadId,
+                                                uint32_t threadIndex)
+        : events(new EventSlot[capacity]),
+          mask(capacity - 1),
+          writeIndex(0),
+          threadId(threadId),
+          threadIndex(threadIndex) {
+        ASSERT(IsPowerOfTwo(capacity));
+    }
+
+    TracingPlatform::TracingPlatform(size_t eventsPerThread)
+        : mInstanceId(gNextInstanceId.fetch_add(1, std::memory_order_relaxed)),
+          mEventsPerThread(NextPowerOfTwo(std::max(eventsPerThread, size_t(1)))),
+          mOrigin(std::chrono::steady_clock::now()),
+          mThreadBuffers(nullptr),
+          mThreadCount(0),
+          mDroppedEventCount(0) {
+    }
+
+    TracingPlatform::~TracingPlatform() {
+        ThreadBuffer* buffer = mThreadBuffers.load(std::memory_order_acquire);
+        while (buffer != nullptr) {
+            ThreadBuffer* next = buffer->next;
+            delete buffer;
+            buffer = next;
+        }
+    }
+
+    // static
+    void TracingPlatform::SetCategoryEnabled(TraceCategory category, bool enabled) {
+        ASSERT(static_cast<uint32_t>(category) < kTraceCategoryCount);
+        gTraceCategoryEnabled[static_cast<uint32_t>(category)] = enabled ? 1 : 0;
+    }
+
+    // static
+    bool TracingPlatform::IsCategoryEnabled(TraceCategory category) {
+        ASSERT(static_cast<uint32_t>(category) < kTraceCategoryCount);
+        return gTraceCategoryEnabled[static_cast<uint32_t>(category)] != 0;
+    }
+
+    const unsigned char* TracingPlatform::GetTraceCategoryEnabledFlag(TraceCategory category) {
+        ASSERT(static_cast<uint32_t>(category) < kTraceCategoryCount);
+        return &gTraceCategoryEnabled[static_cast<uint32_t>(category)];
+    }
+
+    double TracingPlatform::MonotonicallyIncreasingTime() {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mOrigin;
+        // 0 means that the time isn't available, see EventTracer's AddTraceEvent.
+        return std::max(elapsed.count(), std::numeric_limits<double>::min());
+    }
+
+    TracingPlatform::ThreadBuffer* TracingPlatform::GetLocalThreadBuffer() {
+        if (tLocalThreadBuffer.instanceId == mInstanceId) {
+            return static_cast<ThreadBuffer*>(tLocalThreadBuffer.buffer);
+        }
+
+        // The thread may have used another platform since it last used this one.
+        std::thread::id threadId = std::this_thread::get_id();
+        ThreadBuffer* buffer = mThreadBuffers.load(std::memory_order_acquire);
+        while (buffer != nullptr && buffer->threadId != threadId) {
+            buffer = buffer->next;
+        }
+
+        if (buffer == nullptr) {
+            buffer = new ThreadBuffer(mEventsPerThread, threadId,
+                                      mThreadCount.fetch_add(1, std::memory_order_relaxed));
+            buffer->next = mThreadBuffers.load(std::memory_order_relaxed);
+            while (!mThreadBuffers.compare_exchange_weak(buffer->next, buffer,
+                                                         std::memory_order_release,
+                                                         std::memory_order_relaxed)) {
+            }
+        }
+
+        tLocalThreadBuffer.instanceId = mInstanceId;
+        tLocalThreadBuffer.buffer = buffer;
+        return buffer;
+    }
+
+    uint32_t TracingPlatform::InternName(ThreadBuffer* buffer, const char* name) {
+        // Names are literals so most lookups are resolved by address in the per-thread cache.
+        auto cached = buffer->nameIndexCache.find(name);
+        if (cached != buffer->nameIndexCache.end()) {
+            return cached->second;
+        }
+
+        uint32_t nameIndex;
+        {
+            std::lock_guard<std::mutex> lock(mNameMutex);
+            auto it = mNameIndices.find(name);
+            if (it != mNameIndices.end()) {
+                nameIndex = it->second;
+            } else {
+                nameIndex = static_cast<uint32_t>(mNames.size());
+                mNames.emplace_back(name);
+                mNameIndices.emplace(mNames.back(), nameIndex);
+            }
+        }
+        buffer->nameIndexCache.emplace(name, nameIndex);
+        return nameIndex;
+    }
+
+    uint64_t TracingPlatform::AddTraceEvent(char phase,
+                                            const unsigned char* categoryGroupEnabled,
+                                            const char* name,
+                                            uint64_t id,
+                                            double timestamp,
+                                            int numArgs,
+                                            const char** argNames,
+                                            const unsigned char* argTypes,
+                                            const uint64_t* argValues,
+                                            unsigned char flags) {
+        ThreadBuffer* buffer = GetLocalThreadBuffer();
+
+        // Only this thread writes to the buffer so the index can be loaded relaxed. The release
+        // store publishes the event to the exporter.
+        uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+        Event event;
+        event.timestamp = timestamp;
+        event.id = id;
+        event.nameIndex = InternName(buffer, name);
+        event.phase = phase;
+        event.category = CategoryFromEnabledFlag(categoryGroupEnabled);
+        buffer->events[index & buffer->mask].Write(index, event);
+        buffer->writeIndex.store(index + 1, std::memory_order_release);
+
+        return (static_cast<uint64_t>(buffer->threadIndex) << 48) | (index + 1);
+    }
+
+    std::string TracingPlatform::ExportChromeTraceJSON() {
+        std::lock_guard<std::mutex> exportLock(mExportMutex);
+
+        struct ExportedEvent {
+            Event event;
+            uint32_t threadIndex;
+        };
+        std::vector<ExportedEvent> events;
+
+        for (ThreadBuffer* buffer = mThreadBuffers.load(std::memory_order_acquire);
+             buffer != nullptr; buffer = buffer->next) {
+            uint64_t capacity = buffer->mask + 1;
+            uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+            uint64_t begin = std::max(buffer->readIndex, end > capacity ? end - capacity : 0);
+
+            // The events older than begin were overwritten before this export, and the ones
+            // overwritten during the copy fail to be read.
+            uint64_t droppedCount = begin - buffer->readIndex;
+            for (uint64_t i = begin; i < end; ++i) {
+                ExportedEvent exported;
+                exported.threadIndex = buffer->threadIndex;
+                if (buffer->events[i & buffer->mask].Read(i, &exported.event)) {
+                    events.push_back(exported);
+                } else {
+                    droppedCount++;
+                }
+            }
+
+            mDroppedEventCount.fetch_add(droppedCount, std::memory_order_relaxed);
+            buffer->readIndex = end;
+        }
+
+        std::sort(events.begin(), events.end(), [](const ExportedEvent& a, const ExportedEvent& b) {
+            return a.event.timestamp < b.event.timestamp;
+        });
+
+        std::lock_guard<std::mutex> nameLock(mNameMutex);
+        std::ostringstream stream;
+        stream.precision(3);
+        stream << std::fixed << "{\"traceEvents\":[";
+        for (size_t i = 0; i < events.size(); ++i) {
+            const Event& event = events[i].event;
+            if (i != 0) {
+                stream << ",";
+            }
+            stream << "{\"name\":";
+            WriteJSONString(&stream, mNames[event.nameIndex]);
+            stream << ",\"cat\":\"" << kTraceCategoryNames[event.category] << "\"";
+            stream << ",\"ph\":\"" << event.phase << "\"";
+            // Chrome trace timestamps are in microseconds.
+            stream << ",\"ts\":" << event.timestamp * 1000000.0;
+            stream << ",\"pid\":0,\"tid\":" << events[i].threadIndex;
+            if (event.id != 0) {
+                stream << ",\"id\":" << event.id;
+            }
+            stream << "}";
+        }
+        stream << "],\"displayTimeUnit\":\"ms\"}";
+        return stream.str();
+    }
+
+    uint64_t TracingPlatform::GetDroppedEventCount() const {
+        return mDroppedEventCount.load(std::memory_order_relaxed);
+    }
+
+}}  // namespace dawn_platform::tracing
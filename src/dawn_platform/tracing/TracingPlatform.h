@@ -0,0 +1,137 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DAWNPLATFORM_TRACING_TRACINGPLATFORM_H_
+#define DAWNPLATFORM_TRACING_TRACINGPLATFORM_H_
+
+#include "dawn_platform/DawnPlatform.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dawn_platform { namespace tracing {
+
+    // A Platform that records trace events cheaply enough to be left enabled in production.
+    // Each thread records in its own fixed-size ring buffer without taking any lock, and the
+    // oldest events of a thread are overwritten when its buffer is full. Event names are interned
+    // so that events stay small. The recorded events can be exported in the Chrome trace event
+    // format to be viewed in chrome://tracing or Perfetto.
+    class TracingPlatform : public Platform {
+      public:
+        static constexpr size_t kDefaultEventsPerThread = 1 << 16;
+
+        // eventsPerThread is rounded up to a power of two.
+        explicit TracingPlatform(size_t eventsPerThread = kDefaultEventsPerThread);
+        ~TracingPlatform() override;
+
+        // The trace macros cache the category flags in static variables, so the enabled
+        // categories are shared by all the TracingPlatforms. All categories start disabled.
+        static void SetCategoryEnabled(TraceCategory category, bool enabled);
+        static bool IsCategoryEnabled(TraceCategory category);
+
+        // Returns the events recorded since the last export as a Chrome trace event JSON object.
+        // This can be called while other threads are recording: events that are overwritten
+        // during the export are dropped instead of being exported torn.
+        std::string ExportChromeTraceJSON();
+
+        // The number of events that were overwritten before they could be exported.
+        uint64_t GetDroppedEventCount() const;
+
+        const unsigned char* GetTraceCategoryEnabledFlag(TraceCategory category) override;
+        double MonotonicallyIncreasingTime() override;
+        uint64_t AddTraceEvent(char phase,
+                               const unsigned char* categoryGroupEnabled,
+                               const char* name,
+                               uint64_t id,
+                               double timestamp,
+                               int numArgs,
+                               const char** argNames,
+                               const unsigned char* argTypes,
+                               const uint64_t* argValues,
+                               unsigned char flags) override;
+
+      private:
+        struct Event {
+            double timestamp;
+            uint64_t id;
+            uint32_t nameIndex;
+            char phase;
+            uint8_t category;
+        };
+
+        // The owning thread can overwrite a slot while the exporter copies it, so its fields are
+        // relaxed atomics and |sequence| works as a seqlock: it is the index of the event in the
+        // slot plus one, and 0 while the slot is being written. The exporter drops the events
+        // whose sequence changed during the copy.
+        struct EventSlot {
+            std::atomic<uint64_t> sequence{0};
+            std::atomic<double> timestamp;
+            std::atomic<uint64_t> id;
+            std::atomic<uint32_t> nameIndex;
+            std::atomic<char> phase;
+            std::atomic<uint8_t> category;
+
+            void Write(uint64_t index, const Event& event);
+            // Returns false if the slot doesn't contain the event at |index| anymore.
+            bool Read(uint64_t index, Event* event) const;
+        };
+
+        // Only the owning thread writes events and the name cache. The exporter only reads the
+        // events, and owns readIndex.
+        struct ThreadBuffer {
+            ThreadBuffer(size_t capacity, std::thread::id threadId, uint32_t threadIndex);
+
+            std::unique_ptr<EventSlot[]> events;
+            const uint64_t mask;
+            std::atomic<uint64_t> writeIndex;
+            uint64_t readIndex = 0;
+
+            const std::thread::id threadId;
+            const uint32_t threadIndex;
+            std::unordered_map<const char*, uint32_t> nameIndexCache;
+
+            ThreadBuffer* next = nullptr;
+        };
+
+        ThreadBuffer* GetLocalThreadBuffer();
+        uint32_t InternName(ThreadBuffer* buffer, const char* name);
+
+        const uint64_t mInstanceId;
+        const size_t mEventsPerThread;
+        const std::chrono::steady_clock::time_point mOrigin;
+
+        // Buffers are prepended by the threads when they record their first event and only
+        // freed with the platform.
+        std::atomic<ThreadBuffer*> mThreadBuffers;
+        std::atomic<uint32_t> mThreadCount;
+
+        // Interned names, indexed by Event::nameIndex. Only accessed when a thread sees a name
+        // for the first time and when exporting.
+        std::mutex mNameMutex;
+        std::vector<std::string> mNames;
+        std::unordered_map<std::string, uint32_t> mNameIndices;
+
+        std::mutex mExportMutex;
+        std::atomic<uint64_t> mDroppedEventCount;
+    };
+
+}}  // namespace dawn_platform::tracing
+
+#endif  // DAWNPLATFORM_TRACING_TRACINGPLATFORM_H_
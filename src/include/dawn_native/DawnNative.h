@@ -181,6 +181,110 @@ namespace dawn_native {
     // Backdoor to get the number of deprecation warnings for testing
     DAWN_NATIVE_EXPORT size_t GetDeprecationWarningCountForTesting(WGPUDevice device);
 
+    // Counters that the device always keeps about the work it does. They are cumulative since
+    // the creation of the device, except for the live object counts.
+    struct DAWN_NATIVE_EXPORT DeviceCounters {
+        struct CacheCounters {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+        };
+
+        // Commands in successfully finished command buffers and render bundles.
+        uint64_t renderPassesEncoded = 0;
+        uint64_t computePassesEncoded = 0;
+        uint64_t drawsEncoded = 0;
+        uint64_t dispatchesEncoded = 0;
+        uint64_t copiesEncoded = 0;
+        uint64_t pipelineChangesEncoded = 0;
+        uint64_t bindGroupChangesEncoded = 0;
+        uint64_t otherCommandsEncoded = 0;
+
+        uint64_t queueSubmits = 0;
+        uint64_t bytesUploaded = 0;
+
+        CacheCounters attachmentStateCache;
+        CacheCounters bindGroupLayoutCache;
+        CacheCounters computePipelineCache;
+        CacheCounters pipelineLayoutCache;
+        CacheCounters renderPipelineCache;
+        CacheCounters samplerCache;
+        CacheCounters shaderModuleCache;
+
+        // Objects waiting for their deferred deletion are still counted as live.
+        uint64_t liveBuffers = 0;
+        uint64_t liveTextures = 0;
+        uint64_t liveBindGroups = 0;
+        uint64_t liveBindGroupLayouts = 0;
+        uint64_t liveComputePipelines = 0;
+        uint64_t livePipelineLayouts = 0;
+        uint64_t liveRenderPipelines = 0;
+        uint64_t liveSamplers = 0;
+        uint64_t liveShaderModules = 0;
+
+        uint64_t validateFinishNanoseconds = 0;
+        uint64_t validateSubmitNanoseconds = 0;
+
+        // Only reported by the Vulkan backend. The live descriptor pools, the bind groups that
+        // got a descriptor set already containing their descriptors, and the secondary command
+        // buffers recorded for the chunks of the render passes.
+        uint64_t liveDescriptorPools = 0;
+        uint64_t descriptorSetsReused = 0;
+        uint64_t secondaryCommandBuffersRecorded = 0;
+
+        // Only reported by the OpenGL backend. The GL state changes that weren't sent to the
+        // driver because the state already had the value, counted for the whole GL context.
+        uint64_t skippedGLStateChanges = 0;
+    };
+
+    // Query a snapshot of the device counters. This is cheap enough to be called every frame.
+    DAWN_NATIVE_EXPORT DeviceCounters GetDeviceCounters(WGPUDevice device);
+
+    // An estimate of the memory held by a device, in bytes. The frontend fields break the memory
+    // down by the objects holding it, and the backend fields by how the GPU memory was allocated,
+    // so the same memory can be counted by both.
+    struct DAWN_NATIVE_EXPORT DeviceMemoryUsage {
+        // Memory of the backend sub-allocators, which place resources in large heaps.
+        struct SubAllocatorUsage {
+            // The heaps containing at least one live resource.
+            uint64_t heapBytes = 0;
+            // The memory requested by the live resources.
+            uint64_t usedBytes = 0;
+            // Lost rounding the resources up to the block sizes of the allocator.
+            uint64_t wastedBytes = 0;
+            // Unused in the heaps, possibly too fragmented to be allocated.
+            uint64_t freeBytes = 0;
+            // Empty heaps kept for reuse.
+            uint64_t pooledBytes = 0;
+        };
+
+        // CPU memory of the commands of the live command buffers and render bundles.
+        uint64_t commandBytes = 0;
+        // CPU memory of the slabs the bind groups are allocated from.
+        uint64_t bindGroupAllocatorBytes = 0;
+        // CPU memory of the shader code of the cached shader modules.
+        uint64_t shaderModuleBytes = 0;
+
+        // The size of the live buffers and textures, without the padding added by the backend.
+        uint64_t bufferBytes = 0;
+        uint64_t textureBytes = 0;
+
+        // Staging memory for WriteBuffer and WriteTexture, and the part that is in use.
+        uint64_t uploadBytes = 0;
+        uint64_t uploadUsedBytes = 0;
+        // GPU memory for the intermediate copies done by the backends, and the part that is in
+        // use.
+        uint64_t scratchBytes = 0;
+        uint64_t scratchUsedBytes = 0;
+
+        // Only reported by the backends that sub-allocate GPU memory: D3D12 and Vulkan.
+        SubAllocatorUsage subAllocated;
+        uint64_t directlyAllocatedBytes = 0;
+    };
+
+    // Query an estimate of the memory held by the device. It walks the cached objects so it is
+    // more expensive than GetDeviceCounters.
+    DAWN_NATIVE_EXPORT DeviceMemoryUsage GetDeviceMemoryUsage(WGPUDevice device);
+
     //  Query if texture has been initialized
     DAWN_NATIVE_EXPORT bool IsTextureSubresourceInitialized(
         WGPUTexture texture,
@@ -195,6 +299,23 @@ namespace dawn_native {
 
     DAWN_NATIVE_EXPORT bool DeviceTick(WGPUDevice device);
 
+    // The work that the queues created with CreateAdditionalQueue accept.
+    enum class QueueType {
+        // Render passes, compute passes and copies, like the default queue.
+        General,
+        // Compute passes and copies.
+        Compute,
+        // Copies only.
+        Copy,
+    };
+
+    // Creates a queue with its own timeline, on which the work can execute concurrently with the
+    // work of the other queues. A fence signaled on the queue completes as soon as the work
+    // submitted to the queue before the signal is done, so fences express the dependencies
+    // between queues. Backends that don't support additional queues produce a validation error
+    // and return an error queue. The caller owns the returned reference.
+    DAWN_NATIVE_EXPORT WGPUQueue CreateAdditionalQueue(WGPUDevice device, QueueType type);
+
     // ErrorInjector functions used for testing only. Defined in dawn_native/ErrorInjector.cpp
     DAWN_NATIVE_EXPORT void EnableErrorInjector();
     DAWN_NATIVE_EXPORT void DisableErrorInjector();
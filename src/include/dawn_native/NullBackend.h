@@ -18,8 +18,25 @@
 #include <dawn/dawn_wsi.h>
 #include <dawn_native/DawnNative.h>
 
+#include <cstdint>
+
 namespace dawn_native { namespace null {
     DAWN_NATIVE_EXPORT DawnSwapChainImplementation CreateNativeSwapChainImpl();
+
+    // How long the work of a Null device created with the null_use_async_timeline toggle takes
+    // on its timeline thread. Each submit starts executing |latencyMicroseconds| after it is
+    // submitted, and submits overlap during that latency like they would on a GPU. Executing a
+    // submit then takes the time to transfer its bytes at |bytesPerSecond|, one submit at a time.
+    // A |bytesPerSecond| of 0 makes transfers instantaneous.
+    struct DAWN_NATIVE_EXPORT AsyncTimelineOptions {
+        uint64_t latencyMicroseconds = 0;
+        uint64_t bytesPerSecond = 0;
+    };
+
+    // Applies to the work submitted after the call. Does nothing if the device doesn't use the
+    // asynchronous timeline.
+    DAWN_NATIVE_EXPORT void SetAsyncTimelineOptions(WGPUDevice device,
+                                                    const AsyncTimelineOptions& options);
 }}  // namespace dawn_native::null
 
 #endif  // DAWNNATIVE_NULLBACKEND_H_
@@ -17,6 +17,7 @@
 
 #include <dawn_native/dawn_native_export.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace dawn_platform {
@@ -28,6 +29,28 @@ namespace dawn_platform {
         GPUWork,     // Actual GPU work
     };
 
+    // A blob store used by Dawn to keep data across runs of the application, like the pipeline
+    // caches of the drivers. Keys and values are opaque binary data. The interface can be called
+    // concurrently by devices on different threads.
+    class DAWN_NATIVE_EXPORT CachingInterface {
+      public:
+        virtual ~CachingInterface() {
+        }
+
+        // Returns the size of the value stored for the key, or 0 if there is none. The value is
+        // copied to valueOut only when valueOut isn't null and valueSize is at least that size.
+        virtual size_t LoadData(const void* key,
+                                size_t keySize,
+                                void* valueOut,
+                                size_t valueSize) = 0;
+
+        // Replaces the value stored for the key.
+        virtual void StoreData(const void* key,
+                               size_t keySize,
+                               const void* value,
+                               size_t valueSize) = 0;
+    };
+
     class DAWN_NATIVE_EXPORT Platform {
       public:
         virtual ~Platform() {
@@ -46,6 +69,11 @@ namespace dawn_platform {
                                        const unsigned char* argTypes,
                                        const uint64_t* argValues,
                                        unsigned char flags) = 0;
+
+        // Returns the blob store in which Dawn can persist data, or nullptr if it must not.
+        virtual CachingInterface* GetCachingInterface() {
+            return nullptr;
+        }
     };
 
 }  // namespace dawn_platform
@@ -627,6 +627,13 @@ bool DawnTestBase::IsAsan() const {
 #endif
 }
 
+bool DawnTestBase::HasToggleEnabled(const char* toggle) const {
+    std::vector<const char*> toggles = dawn_native::GetTogglesUsed(backendDevice);
+    return std::find_if(toggles.begin(), toggles.end(), [toggle](const char* name) {
+               return strcmp(toggle, name) == 0;
+           }) != toggles.end();
+}
+
 bool DawnTestBase::HasVendorIdFilter() const {
     return gTestEnv->HasVendorIdFilter();
 }
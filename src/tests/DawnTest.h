@@ -254,6 +254,9 @@ class DawnTestBase {
 
     bool IsAsan() const;
 
+    // Whether the toggle is enabled on the device, either by the test or by default.
+    bool HasToggleEnabled(const char* toggle) const;
+
     void StartExpectDeviceError();
     bool EndExpectDeviceError();
 
@@ -15,6 +15,7 @@
 #ifndef TESTS_PARAMGENERATOR_H_
 #define TESTS_PARAMGENERATOR_H_
 
+#include <array>
 #include <tuple>
 #include <vector>
 
@@ -105,4 +105,45 @@ TEST_P(DrawTest, Uint32) {
     Test(6, 1, 0, 0, filled, filled);
 }
 
+// Test that each draw of a multi draw is executed.
+TEST_P(DrawTest, MultiDraw) {
+    RGBA8 filled(0, 255, 0, 255);
+    RGBA8 notFilled(0, 0, 0, 0);
+
+    auto TestMultiDraw = [&](const std::vector<wgpu::DrawArguments>& draws,
+                             RGBA8 bottomLeftExpected, RGBA8 topRightExpected) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        {
+            wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass.renderPassInfo);
+            pass.SetPipeline(pipeline);
+            pass.SetVertexBuffer(0, vertexBuffer);
+            pass.MultiDraw(static_cast<uint32_t>(draws.size()), draws.data());
+            pass.EndPass();
+        }
+
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+
+        EXPECT_PIXEL_RGBA8_EQ(bottomLeftExpected, renderPass.color, 1, 3);
+        EXPECT_PIXEL_RGBA8_EQ(topRightExpected, renderPass.color, 3, 1);
+    };
+
+    wgpu::DrawArguments empty = {};
+    empty.vertexCount = 0;
+
+    wgpu::DrawArguments bottomLeft = {};
+    bottomLeft.vertexCount = 3;
+
+    wgpu::DrawArguments topRight = {};
+    topRight.vertexCount = 3;
+    topRight.firstVertex = 3;
+
+    // Test a multi draw containing only an empty draw.
+    TestMultiDraw({empty}, notFilled, notFilled);
+    // Test a multi draw with an empty draw followed by the top right triangle.
+    TestMultiDraw({empty, topRight}, notFilled, filled);
+    // Test a multi draw with both triangles drawn separately.
+    TestMultiDraw({bottomLeft, topRight}, filled, filled);
+}
+
 DAWN_INSTANTIATE_TEST(DrawTest, D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend());
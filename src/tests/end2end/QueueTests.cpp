@@ -19,6 +19,7 @@
 
 #include "tests/DawnTest.h"
 
+#include "common/Constants.h"
 #include "common/Math.h"
 #include "utils/TestUtils.h"
 #include "utils/TextureFormatUtils.h"
@@ -40,6 +41,82 @@ DAWN_INSTANTIATE_TEST(QueueTests,
                       OpenGLBackend(),
                       VulkanBackend());
 
+class QueueReusableCommandBufferTests : public DawnTest {};
+
+// Test that a reusable command buffer sees the updated contents of its resources each time it is
+// submitted.
+TEST_P(QueueReusableCommandBufferTests, SubmitMultipleTimes) {
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = sizeof(uint32_t);
+    descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer src = device.CreateBuffer(&descriptor);
+    wgpu::Buffer dst = device.CreateBuffer(&descriptor);
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(src, 0, dst, 0, sizeof(uint32_t));
+    wgpu::CommandBufferDescriptor commandBufferDescriptor;
+    commandBufferDescriptor.reusable = true;
+    wgpu::CommandBuffer commands = encoder.Finish(&commandBufferDescriptor);
+
+    for (uint32_t value = 1; value <= 3; ++value) {
+        queue.WriteBuffer(src, 0, &value, sizeof(value));
+        queue.Submit(1, &commands);
+        EXPECT_BUFFER_U32_EQ(value, dst, 0);
+    }
+}
+
+// Test that an attachment lazily cleared by the first submit of a reusable command buffer is
+// loaded, not cleared, by the following submits.
+TEST_P(QueueReusableCommandBufferTests, LazyClearedAttachmentLoadedOnResubmit) {
+    constexpr uint32_t kSize = 4;
+    constexpr wgpu::TextureFormat kFormat = wgpu::TextureFormat::RGBA8Unorm;
+
+    wgpu::TextureDescriptor textureDescriptor;
+    textureDescriptor.size = {kSize, kSize, 1};
+    textureDescriptor.format = kFormat;
+    textureDescriptor.usage = wgpu::TextureUsage::OutputAttachment |
+                              wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::CopyDst;
+    wgpu::Texture texture = device.CreateTexture(&textureDescriptor);
+
+    // A render pass that loads the attachment and stores it unchanged.
+    utils::ComboRenderPassDescriptor renderPass({texture.CreateView()});
+    renderPass.cColorAttachments[0].loadOp = wgpu::LoadOp::Load;
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.BeginRenderPass(&renderPass).EndPass();
+    wgpu::CommandBufferDescriptor commandBufferDescriptor;
+    commandBufferDescriptor.reusable = true;
+    wgpu::CommandBuffer commands = encoder.Finish(&commandBufferDescriptor);
+
+    // The texture isn't initialized so the first submit clears it to zero.
+    queue.Submit(1, &commands);
+    std::vector<RGBA8> expectedZeros(kSize * kSize, RGBA8(0, 0, 0, 0));
+    EXPECT_TEXTURE_RGBA8_EQ(expectedZeros.data(), texture, 0, 0, kSize, kSize, 0, 0);
+
+    // Fill the texture and submit again, its contents must be preserved.
+    std::vector<RGBA8> data(kTextureBytesPerRowAlignment / sizeof(RGBA8) * kSize,
+                            RGBA8(1, 2, 3, 4));
+    wgpu::Buffer buffer = utils::CreateBufferFromData(
+        device, data.data(), data.size() * sizeof(RGBA8), wgpu::BufferUsage::CopySrc);
+    wgpu::BufferCopyView bufferCopyView =
+        utils::CreateBufferCopyView(buffer, 0, kTextureBytesPerRowAlignment, 0);
+    wgpu::TextureCopyView textureCopyView = utils::CreateTextureCopyView(texture, 0, {0, 0, 0});
+    wgpu::Extent3D copySize = {kSize, kSize, 1};
+    wgpu::CommandEncoder copyEncoder = device.CreateCommandEncoder();
+    copyEncoder.CopyBufferToTexture(&bufferCopyView, &textureCopyView, &copySize);
+    wgpu::CommandBuffer copy = copyEncoder.Finish();
+    queue.Submit(1, &copy);
+
+    queue.Submit(1, &commands);
+    std::vector<RGBA8> expectedData(kSize * kSize, RGBA8(1, 2, 3, 4));
+    EXPECT_TEXTURE_RGBA8_EQ(expectedData.data(), texture, 0, 0, kSize, kSize, 0, 0);
+}
+
+DAWN_INSTANTIATE_TEST(QueueReusableCommandBufferTests,
+                      D3D12Backend(),
+                      MetalBackend(),
+                      OpenGLBackend(),
+                      VulkanBackend());
+
 class QueueWriteBufferTests : public DawnTest {};
 
 // Test the simplest WriteBuffer setting one u32 at offset 0.
@@ -175,10 +252,9 @@ TEST_P(QueueWriteBufferTests, SuperLargeWriteBuffer) {
 // data, it might be necessary to use a ring buffer with properly aligned offset.
 TEST_P(QueueWriteBufferTests, UnalignedDynamicUploader) {
     // TODO(dawn:483): Skipping test because WriteTexture inside UnalignDynamicUploader
-    // is not implemented. Moreover when using UnalignDynamicUploader we are assuming
-    // that WriteTexture implementation uses a DynamicUploader which might be false in the
-    // case of a future OpenGL implementation.
-    DAWN_SKIP_TEST_IF(IsOpenGL());
+    // is only implemented on OpenGL when it streams uploads through persistently mapped
+    // staging buffers.
+    DAWN_SKIP_TEST_IF(IsOpenGL() && !HasToggleEnabled("opengl_use_persistently_mapped_staging"));
 
     utils::UnalignDynamicUploader(device);
 
@@ -201,6 +277,13 @@ DAWN_INSTANTIATE_TEST(QueueWriteBufferTests,
 
 class QueueWriteTextureTests : public DawnTest {
   protected:
+    void SetUp() override {
+        DawnTest::SetUp();
+        // WriteTexture on OpenGL needs the persistently mapped staging buffers.
+        DAWN_SKIP_TEST_IF(IsOpenGL() &&
+                          !HasToggleEnabled("opengl_use_persistently_mapped_staging"));
+    }
+
     static constexpr wgpu::TextureFormat kTextureFormat = wgpu::TextureFormat::RGBA8Unorm;
 
     struct TextureSpec {
@@ -568,4 +651,8 @@ TEST_P(QueueWriteTextureTests, UnalignedDynamicUploader) {
     DoTest(textureSpec, MinimumDataSpec(size), size);
 }
 
-DAWN_INSTANTIATE_TEST(QueueWriteTextureTests, D3D12Backend(), MetalBackend(), VulkanBackend());
+DAWN_INSTANTIATE_TEST(QueueWriteTextureTests,
+                      D3D12Backend(),
+                      MetalBackend(),
+                      OpenGLBackend(),
+                      VulkanBackend());
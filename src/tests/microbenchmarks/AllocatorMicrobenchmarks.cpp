@@ -0,0 +1,193 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/microbenchmarks/Microbenchmark.h"
+
+#include "common/SlabAllocator.h"
+#include "dawn_native/BuddyAllocator.h"
+#include "dawn_native/BuddyMemoryAllocator.h"
+#include "dawn_native/ResourceHeapAllocator.h"
+#include "dawn_native/RingBufferAllocator.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace dawn_native;
+
+namespace {
+
+    // The size of the objects of the slab storms, about the size of a small frontend object.
+    struct SlabObject {
+        uint64_t data[16];
+    };
+
+    constexpr uint32_t kSlabObjectCount = 1024;
+
+    // The buddy churns keep this many allocations alive and replace one of them per operation.
+    constexpr uint32_t kLiveAllocationCount = 256;
+    constexpr uint32_t kChurnOpsPerRun = 1024;
+    constexpr uint64_t kBuddyMaxSize = 64 * 1024 * 1024;
+    constexpr uint64_t kHeapSize = 4 * 1024 * 1024;
+
+    constexpr uint64_t kRingBufferSize = 4 * 1024 * 1024;
+    constexpr uint32_t kUploadsPerFrame = 64;
+    constexpr uint64_t kFramesInFlight = 3;
+
+    // Sizes from 256 bytes to 64KB, with more small sizes than large ones like the buffers of
+    // real applications.
+    std::vector<uint64_t> MakeAllocationSizes(std::mt19937* generator, size_t count) {
+        std::uniform_int_distribution<uint32_t> log2Size(8, 16);
+        std::uniform_int_distribution<uint32_t> extraSize(0, 255);
+        std::vector<uint64_t> sizes(count);
+        for (uint64_t& size : sizes) {
+            uint32_t log2 = std::min(log2Size(*generator), log2Size(*generator));
+            size = (uint64_t(1) << log2) + extraSize(*generator);
+        }
+        return sizes;
+    }
+
+    std::vector<uint32_t> MakeSlotIndices(std::mt19937* generator, size_t count) {
+        std::uniform_int_distribution<uint32_t> slot(0, kLiveAllocationCount - 1);
+        std::vector<uint32_t> indices(count);
+        for (uint32_t& index : indices) {
+            index = slot(*generator);
+        }
+        return indices;
+    }
+
+    class DummyResourceHeapAllocator : public ResourceHeapAllocator {
+      public:
+        ResultOrError<std::unique_ptr<ResourceHeapBase>> AllocateResourceHeap(
+            uint64_t size) override {
+            return std::make_unique<ResourceHeapBase>();
+        }
+        void DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase> allocation) override {
+        }
+    };
+
+}  // anonymous namespace
+
+class AllocatorMicrobenchmarks : public Microbenchmark {
+  protected:
+    void SetUp() override {
+        std::mt19937 generator(42);
+        mSizes = MakeAllocationSizes(&generator, kChurnOpsPerRun);
+        mSlots = MakeSlotIndices(&generator, kChurnOpsPerRun);
+
+        mFreeOrder.resize(kSlabObjectCount);
+        for (uint32_t i = 0; i < kSlabObjectCount; ++i) {
+            mFreeOrder[i] = i;
+        }
+        std::shuffle(mFreeOrder.begin(), mFreeOrder.end(), generator);
+    }
+
+    std::vector<uint64_t> mSizes;
+    std::vector<uint32_t> mSlots;
+    std::vector<uint32_t> mFreeOrder;
+};
+
+// Allocate a burst of objects then free them in random order, like the creation and release of
+// the objects of a frame. Compared with the same storm on the heap.
+TEST_F(AllocatorMicrobenchmarks, SlabStorm) {
+    std::vector<SlabObject*> objects(kSlabObjectCount);
+
+    SlabAllocator<SlabObject> allocator(64 * sizeof(SlabObject));
+    Measure("slab", 2 * kSlabObjectCount, [&]() {
+        for (SlabObject*& object : objects) {
+            object = allocator.Allocate();
+        }
+        for (uint32_t index : mFreeOrder) {
+            allocator.Deallocate(objects[index]);
+        }
+    });
+
+    Measure("heap", 2 * kSlabObjectCount, [&]() {
+        for (SlabObject*& object : objects) {
+            object = new SlabObject();
+        }
+        for (uint32_t index : mFreeOrder) {
+            delete objects[index];
+        }
+    });
+}
+
+// Replace random allocations of a fragmented BuddyAllocator with allocations of different
+// sizes. Failed allocations leave their slot empty so the allocator stays fragmented.
+TEST_F(AllocatorMicrobenchmarks, BuddyFragmentationChurn) {
+    BuddyAllocator allocator(kBuddyMaxSize);
+    std::vector<uint64_t> offsets(kLiveAllocationCount, BuddyAllocator::kInvalidOffset);
+
+    uint64_t failures = 0;
+    Measure("buddy_churn", kChurnOpsPerRun, [&]() {
+        for (uint32_t i = 0; i < kChurnOpsPerRun; ++i) {
+            uint64_t& offset = offsets[mSlots[i]];
+            if (offset != BuddyAllocator::kInvalidOffset) {
+                allocator.Deallocate(offset);
+            }
+            offset = allocator.Allocate(mSizes[i], 256);
+            failures += offset == BuddyAllocator::kInvalidOffset;
+        }
+    });
+    Consume(failures);
+}
+
+// Same as BuddyFragmentationChurn but with the heaps of the BuddyMemoryAllocator created and
+// released as the allocations come and go.
+TEST_F(AllocatorMicrobenchmarks, BuddyMemoryAllocatorChurn) {
+    DummyResourceHeapAllocator heapAllocator;
+    BuddyMemoryAllocator allocator(kBuddyMaxSize, kHeapSize, &heapAllocator);
+    std::vector<ResourceMemoryAllocation> allocations(kLiveAllocationCount);
+
+    Measure("buddy_memory_churn", kChurnOpsPerRun, [&]() {
+        for (uint32_t i = 0; i < kChurnOpsPerRun; ++i) {
+            ResourceMemoryAllocation& allocation = allocations[mSlots[i]];
+            if (allocation.GetInfo().mMethod != AllocationMethod::kInvalid) {
+                allocator.Deallocate(allocation);
+            }
+
+            ResultOrError<ResourceMemoryAllocation> result = allocator.Allocate(mSizes[i], 256);
+            allocation = result.IsSuccess() ? result.AcquireSuccess() : ResourceMemoryAllocation{};
+        }
+    });
+
+    for (ResourceMemoryAllocation& allocation : allocations) {
+        if (allocation.GetInfo().mMethod != AllocationMethod::kInvalid) {
+            allocator.Deallocate(allocation);
+        }
+    }
+}
+
+// Allocate the uploads of a frame from a RingBufferAllocator and release the ones of the frame
+// that completed, like the DynamicUploader does.
+TEST_F(AllocatorMicrobenchmarks, RingBufferFrames) {
+    RingBufferAllocator allocator(kRingBufferSize);
+    uint64_t serial = 0;
+
+    uint64_t failures = 0;
+    Measure("ring_buffer_upload", kUploadsPerFrame, [&]() {
+        serial++;
+        for (uint32_t i = 0; i < kUploadsPerFrame; ++i) {
+            uint64_t offset = allocator.Allocate(mSizes[(serial * kUploadsPerFrame + i) %
+                                                        kChurnOpsPerRun],
+                                                 ExecutionSerial(serial));
+            failures += offset == RingBufferAllocator::kInvalidOffset;
+        }
+        if (serial > kFramesInFlight) {
+            allocator.Deallocate(ExecutionSerial(serial - kFramesInFlight));
+        }
+    });
+    Consume(failures);
+}
@@ -0,0 +1,122 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/microbenchmarks/Microbenchmark.h"
+
+#include "dawn_native/CommandAllocator.h"
+
+using namespace dawn_native;
+
+namespace {
+
+    // Commands shaped like the ones of a render pass with a bind group and a draw per object.
+    enum class CommandType {
+        SetPipeline,
+        SetBindGroup,
+        Draw,
+    };
+
+    struct CommandSetPipeline {
+        uint64_t pipeline;
+    };
+
+    struct CommandSetBindGroup {
+        uint64_t group;
+        uint32_t index;
+        uint32_t dynamicOffsetCount;
+    };
+
+    struct CommandDraw {
+        uint32_t vertexCount;
+        uint32_t instanceCount;
+        uint32_t firstVertex;
+        uint32_t firstInstance;
+    };
+
+    constexpr uint32_t kDynamicOffsetCount = 2;
+    constexpr uint32_t kDrawsPerPipeline = 16;
+
+    // Each draw is encoded as a bind group change with its dynamic offsets, and a draw.
+    constexpr uint32_t kCommandsPerDraw = 2;
+
+}  // anonymous namespace
+
+class CommandAllocatorMicrobenchmarks : public Microbenchmark {
+  protected:
+    // Encodes |drawCount| draws in a new CommandAllocator, then iterates over them like the
+    // backends do when recording the native commands.
+    void EncodeAndIterate(const std::string& name, uint32_t drawCount) {
+        uint32_t commandCount = drawCount * kCommandsPerDraw + drawCount / kDrawsPerPipeline;
+
+        Measure(name, commandCount, [&]() {
+            CommandAllocator allocator;
+            for (uint32_t i = 0; i < drawCount; ++i) {
+                if (i % kDrawsPerPipeline == 0) {
+                    CommandSetPipeline* setPipeline =
+                        allocator.Allocate<CommandSetPipeline>(CommandType::SetPipeline);
+                    setPipeline->pipeline = i;
+                }
+
+                uint32_t* offsets;
+                CommandSetBindGroup* setBindGroup = allocator.AllocateWithData<CommandSetBindGroup>(
+                    CommandType::SetBindGroup, kDynamicOffsetCount, &offsets);
+                setBindGroup->group = i;
+                setBindGroup->index = 0;
+                setBindGroup->dynamicOffsetCount = kDynamicOffsetCount;
+                offsets[0] = i * 256;
+                offsets[1] = i * 512;
+
+                CommandDraw* draw = allocator.Allocate<CommandDraw>(CommandType::Draw);
+                draw->vertexCount = 3;
+                draw->instanceCount = 1;
+                draw->firstVertex = 0;
+                draw->firstInstance = i;
+            }
+
+            CommandIterator iterator(std::move(allocator));
+            uint64_t checksum = 0;
+            CommandType type;
+            while (iterator.NextCommandId(&type)) {
+                switch (type) {
+                    case CommandType::SetPipeline:
+                        checksum += iterator.NextCommand<CommandSetPipeline>()->pipeline;
+                        break;
+                    case CommandType::SetBindGroup: {
+                        CommandSetBindGroup* setBindGroup =
+                            iterator.NextCommand<CommandSetBindGroup>();
+                        uint32_t* offsets =
+                            iterator.NextData<uint32_t>(setBindGroup->dynamicOffsetCount);
+                        checksum += setBindGroup->group + offsets[0];
+                        break;
+                    }
+                    case CommandType::Draw:
+                        checksum += iterator.NextCommand<CommandDraw>()->firstInstance;
+                        break;
+                }
+            }
+            iterator.MakeEmptyAsDataWasDestroyed();
+            Consume(checksum);
+        });
+    }
+};
+
+// A few draws that fit in the first block of the allocator.
+TEST_F(CommandAllocatorMicrobenchmarks, EncodeAndIterateSmall) {
+    EncodeAndIterate("encode_iterate_64_draws", 64);
+}
+
+// Enough draws to need several blocks.
+TEST_F(CommandAllocatorMicrobenchmarks, EncodeAndIterateLarge) {
+    EncodeAndIterate("encode_iterate_4096_draws", 4096);
+}
@@ -0,0 +1,139 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/microbenchmarks/Microbenchmark.h"
+
+#include "common/BitSetIterator.h"
+#include "common/LinkedList.h"
+#include "common/SerialMap.h"
+#include "common/StackContainer.h"
+
+#include <bitset>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct ListNode : public LinkNode<ListNode> {
+        uint64_t touchCount = 0;
+    };
+
+    constexpr uint32_t kListNodeCount = 256;
+    constexpr uint32_t kListOpsPerRun = 1024;
+
+    constexpr uint32_t kSerialMapOpsPerRun = 1024;
+    constexpr uint64_t kSerialsInFlight = 3;
+
+}  // anonymous namespace
+
+class ContainerMicrobenchmarks : public Microbenchmark {};
+
+// Move random nodes to the back of a LinkedList, like an LRU list of objects touched every frame.
+TEST_F(ContainerMicrobenchmarks, LinkedListMoveToBack) {
+    std::vector<ListNode> nodes(kListNodeCount);
+    LinkedList<ListNode> list;
+    for (ListNode& node : nodes) {
+        list.Append(&node);
+    }
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<uint32_t> nodeIndex(0, kListNodeCount - 1);
+    std::vector<uint32_t> touched(kListOpsPerRun);
+    for (uint32_t& index : touched) {
+        index = nodeIndex(generator);
+    }
+
+    Measure("linked_list_move_to_back", kListOpsPerRun, [&]() {
+        for (uint32_t index : touched) {
+            ListNode* node = &nodes[index];
+            node->RemoveFromList();
+            list.Append(node);
+            node->touchCount++;
+        }
+        Consume(list.head()->value()->touchCount);
+    });
+
+    while (!list.empty()) {
+        list.head()->RemoveFromList();
+    }
+}
+
+// Fill a short-lived vector of a few elements, which is what StackVector is used for in the
+// frontend. The first size fits in the stack storage, the second one spills to the heap.
+TEST_F(ContainerMicrobenchmarks, StackVectorFill) {
+    for (uint32_t count : {8u, 32u}) {
+        std::string suffix = "_" + std::to_string(count) + "_elements";
+
+        Measure("stack_vector" + suffix, count, [&]() {
+            StackVector<uint32_t, 16> vector;
+            for (uint32_t i = 0; i < count; ++i) {
+                vector->push_back(i);
+            }
+            Consume(vector[count - 1]);
+        });
+
+        Measure("std_vector" + suffix, count, [&]() {
+            std::vector<uint32_t> vector;
+            for (uint32_t i = 0; i < count; ++i) {
+                vector.push_back(i);
+            }
+            Consume(vector[count - 1]);
+        });
+    }
+}
+
+// Enqueue values in a SerialMap for a few serials in the future, like the mapping requests of
+// buffers, and clear the completed serials.
+TEST_F(ContainerMicrobenchmarks, SerialMapChurn) {
+    SerialMap<uint64_t, uint64_t> map;
+    uint64_t serial = 0;
+
+    Measure("serial_map_churn", kSerialMapOpsPerRun, [&]() {
+        uint64_t checksum = 0;
+        for (uint32_t i = 0; i < kSerialMapOpsPerRun; ++i) {
+            serial++;
+            map.Enqueue(serial, serial + kSerialsInFlight);
+            map.Enqueue(serial, serial + 1);
+
+            for (uint64_t value : map.IterateUpTo(serial)) {
+                checksum += value;
+            }
+            map.ClearUpTo(serial);
+        }
+        Consume(checksum);
+    });
+}
+
+// Iterate over the set bits of masks with a few bits set, like the dirty bind groups and vertex
+// buffers tracked by the command buffer state.
+TEST_F(ContainerMicrobenchmarks, BitSetIterate) {
+    std::mt19937 generator(42);
+    std::vector<std::bitset<32>> masks(256);
+    for (std::bitset<32>& mask : masks) {
+        mask.set(generator() % 32);
+        mask.set(generator() % 32);
+        mask.set(generator() % 32);
+    }
+
+    Measure("bitset_iterate", masks.size(), [&]() {
+        uint64_t checksum = 0;
+        for (const std::bitset<32>& mask : masks) {
+            for (uint32_t bit : IterateBitSet(mask)) {
+                checksum += bit;
+            }
+        }
+        Consume(checksum);
+    });
+}
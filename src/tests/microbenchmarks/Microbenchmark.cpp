@@ -0,0 +1,41 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/microbenchmarks/Microbenchmark.h"
+
+#include "common/Log.h"
+
+#include <sstream>
+
+constexpr double Microbenchmark::kCalibrationRunTimeSeconds;
+constexpr unsigned int Microbenchmark::kNumTrials;
+
+void Microbenchmark::Consume(uint64_t value) {
+    mSink = mSink + value;
+}
+
+void Microbenchmark::PrintResult(const std::string& trace,
+                                 double value,
+                                 const std::string& units) const {
+    const ::testing::TestInfo* const testInfo =
+        ::testing::UnitTest::GetInstance()->current_test_info();
+
+    std::ostringstream stream;
+    stream.precision(3);
+    stream << std::fixed << value;
+
+    // The same format as dawn_perf_tests so the same tools can process the results.
+    dawn::InfoLog() << "RESULT " << testInfo->test_suite_name() << "." << trace << ": "
+                    << testInfo->name() << "= " << stream.str() << " " << units;
+}
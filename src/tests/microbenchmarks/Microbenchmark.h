@@ -0,0 +1,94 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TESTS_MICROBENCHMARKS_MICROBENCHMARK_H_
+#define TESTS_MICROBENCHMARKS_MICROBENCHMARK_H_
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+// The number of calls to the global operator new since the start of the process. Defined in
+// MicrobenchmarksMain.cpp which replaces the global allocation functions to count them.
+uint64_t GetAllocationCount();
+
+// Base fixture of the microbenchmarks of the data structures in common/ and dawn_native. Unlike
+// dawn_perf_tests these don't need a device, and they report the number of heap allocations done
+// per operation in addition to the time per operation.
+class Microbenchmark : public testing::Test {
+  protected:
+    // The approximate time spent in each trial.
+    static constexpr double kCalibrationRunTimeSeconds = 0.25;
+    static constexpr unsigned int kNumTrials = 3;
+
+    // Runs |body| repeatedly and reports the time and the heap allocations per operation, where
+    // |body| does |opsPerRun| operations each time it is called. The best trial is reported to
+    // filter out noise from the rest of the system.
+    template <typename F>
+    void Measure(const std::string& name, uint64_t opsPerRun, F&& body);
+
+    // Keeps the compiler from optimizing away the computation of |value|.
+    void Consume(uint64_t value);
+
+  private:
+    template <typename F>
+    static double RunSeconds(uint64_t runs, F&& body);
+
+    void PrintResult(const std::string& trace, double value, const std::string& units) const;
+
+    volatile uint64_t mSink = 0;
+};
+
+template <typename F>
+void Microbenchmark::Measure(const std::string& name, uint64_t opsPerRun, F&& body) {
+    // Warm up the caches and let the data structures reach their steady-state size.
+    body();
+
+    uint64_t runsPerTrial = 1;
+    while (RunSeconds(runsPerTrial, body) < kCalibrationRunTimeSeconds &&
+           runsPerTrial < (uint64_t(1) << 40)) {
+        runsPerTrial *= 2;
+    }
+
+    double bestSeconds = std::numeric_limits<double>::max();
+    uint64_t fewestAllocations = std::numeric_limits<uint64_t>::max();
+    for (unsigned int trial = 0; trial < kNumTrials; ++trial) {
+        uint64_t allocationsBefore = GetAllocationCount();
+        double seconds = RunSeconds(runsPerTrial, body);
+        uint64_t allocations = GetAllocationCount() - allocationsBefore;
+
+        bestSeconds = std::min(bestSeconds, seconds);
+        fewestAllocations = std::min(fewestAllocations, allocations);
+    }
+
+    double totalOps = static_cast<double>(runsPerTrial * opsPerRun);
+    PrintResult(name + "_time", bestSeconds * 1e9 / totalOps, "ns");
+    PrintResult(name + "_allocations", static_cast<double>(fewestAllocations) / totalOps,
+                "count");
+}
+
+template <typename F>
+double Microbenchmark::RunSeconds(uint64_t runs, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < runs; ++i) {
+        body();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+#endif  // TESTS_MICROBENCHMARKS_MICROBENCHMARK_H_
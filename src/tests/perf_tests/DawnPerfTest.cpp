@@ -15,8 +15,10 @@
 #include "tests/perf_tests/DawnPerfTest.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <limits>
+#include <sstream>
 
 #include "common/Assert.h"
 #include "common/Log.h"
@@ -68,6 +70,89 @@ namespace {
         outFile.close();
     }
 
+    // Escapes the characters that can't appear as is in a JSON string.
+    std::string EscapeJSONString(const std::string& string) {
+        std::string escaped;
+        escaped.reserve(string.size());
+        for (char c : string) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    // Returns the value of a string field in a line of a results file, or an empty string.
+    std::string ParseResultField(const std::string& line, const char* field) {
+        std::string key = std::string("\"") + field + "\": \"";
+        size_t start = line.find(key);
+        if (start == std::string::npos) {
+            return "";
+        }
+
+        std::string value;
+        for (size_t i = start + key.size(); i < line.size(); ++i) {
+            if (line[i] == '"') {
+                return value;
+            }
+            if (line[i] == '\\' && i + 1 < line.size()) {
+                ++i;
+            }
+            value += line[i];
+        }
+        return "";
+    }
+
+    std::vector<double> ParseResultValues(const std::string& line) {
+        std::vector<double> values;
+        // The values are the last field, after the strings that could contain brackets.
+        std::string key = "\"values\": [";
+        size_t start = line.rfind(key);
+        if (start == std::string::npos) {
+            return values;
+        }
+        start += key.size();
+        size_t end = line.find(']', start);
+        if (end == std::string::npos) {
+            return values;
+        }
+
+        std::istringstream stream(line.substr(start, end - start));
+        std::string value;
+        while (std::getline(stream, value, ',')) {
+            values.push_back(strtod(value.c_str(), nullptr));
+        }
+        return values;
+    }
+
+    double Median(std::vector<double> values) {
+        ASSERT(!values.empty());
+        std::sort(values.begin(), values.end());
+        size_t middle = values.size() / 2;
+        if (values.size() % 2 == 0) {
+            return (values[middle - 1] + values[middle]) / 2.0;
+        }
+        return values[middle];
+    }
+
+    // Returns how many seconds one unit is, or 0 if the units aren't a duration.
+    double GetSecondsPerUnit(const std::string& units) {
+        if (units == "s") {
+            return 1.0;
+        }
+        if (units == "ms") {
+            return 1e-3;
+        }
+        if (units == "us") {
+            return 1e-6;
+        }
+        if (units == "ns") {
+            return 1e-9;
+        }
+        return 0.0;
+    }
+
 }  // namespace
 
 void InitDawnPerfTestEnvironment(int argc, char** argv) {
@@ -105,14 +190,50 @@ DawnPerfTestEnvironment::DawnPerfTestEnvironment(int argc, char** argv)
             continue;
         }
 
+        constexpr const char kResultsFileArg[] = "--results-file=";
+        argLen = sizeof(kResultsFileArg) - 1;
+        if (strncmp(argv[i], kResultsFileArg, argLen) == 0) {
+            const char* resultsFile = argv[i] + argLen;
+            if (resultsFile[0] != '\0') {
+                mResultsFile = resultsFile;
+            }
+            continue;
+        }
+
+        constexpr const char kBaselineFileArg[] = "--baseline-file=";
+        argLen = sizeof(kBaselineFileArg) - 1;
+        if (strncmp(argv[i], kBaselineFileArg, argLen) == 0) {
+            const char* baselineFile = argv[i] + argLen;
+            if (baselineFile[0] != '\0') {
+                mBaselineFile = baselineFile;
+            }
+            continue;
+        }
+
+        constexpr const char kRegressionThresholdArg[] = "--regression-threshold=";
+        argLen = sizeof(kRegressionThresholdArg) - 1;
+        if (strncmp(argv[i], kRegressionThresholdArg, argLen) == 0) {
+            const char* regressionThreshold = argv[i] + argLen;
+            if (regressionThreshold[0] != '\0') {
+                mRegressionThreshold = strtod(regressionThreshold, nullptr);
+            }
+            continue;
+        }
+
         if (strcmp("-h", argv[i]) == 0 || strcmp("--help", argv[i]) == 0) {
             dawn::InfoLog()
                 << "Additional flags:"
-                << " [--calibration] [--override-steps=x] [--trace-file=file]\n"
+                << " [--calibration] [--override-steps=x] [--trace-file=file]"
+                   " [--results-file=file] [--baseline-file=file] [--regression-threshold=x]\n"
                 << "  --calibration: Only run calibration. Calibration allows the perf test"
                    " runner script to save some time.\n"
                 << " --override-steps: Set a fixed number of steps to run for each test\n"
-                << " --trace-file: The file to dump trace results.\n";
+                << " --trace-file: The file to dump trace results.\n"
+                << " --results-file: The file to write the results to as JSON.\n"
+                << " --baseline-file: A results file to compare the results against. Tests fail"
+                   " if a time metric regresses.\n"
+                << " --regression-threshold: The fraction by which the median of a time metric"
+                   " may exceed the baseline. Defaults to 0.1.\n";
             continue;
         }
     }
@@ -126,6 +247,10 @@ void DawnPerfTestEnvironment::SetUp() {
     mPlatform = std::make_unique<DawnPerfTestPlatform>();
     mInstance->SetPlatform(mPlatform.get());
 
+    if (mBaselineFile != nullptr) {
+        LoadBaseline();
+    }
+
     // Begin writing the trace event array.
     if (mTraceFile != nullptr) {
         std::ofstream outFile;
@@ -153,6 +278,10 @@ void DawnPerfTestEnvironment::TearDown() {
         outFile.close();
     }
 
+    if (mResultsFile != nullptr) {
+        WriteResults();
+    }
+
     DawnTestEnvironment::TearDown();
 }
 
@@ -172,6 +301,80 @@ DawnPerfTestPlatform* DawnPerfTestEnvironment::GetPlatform() const {
     return mPlatform.get();
 }
 
+void DawnPerfTestEnvironment::AddResult(const std::string& metric,
+                                        const std::string& story,
+                                        double value,
+                                        const std::string& units) {
+    for (Result& result : mResults) {
+        if (result.metric == metric && result.story == story) {
+            ASSERT(result.units == units);
+            result.values.push_back(value);
+            return;
+        }
+    }
+    mResults.push_back({metric, story, units, {value}});
+}
+
+const std::vector<DawnPerfTestEnvironment::Result>& DawnPerfTestEnvironment::GetResults() const {
+    return mResults;
+}
+
+const DawnPerfTestEnvironment::Result* DawnPerfTestEnvironment::GetBaselineResult(
+    const std::string& metric,
+    const std::string& story) const {
+    for (const Result& result : mBaselineResults) {
+        if (result.metric == metric && result.story == story) {
+            return &result;
+        }
+    }
+    return nullptr;
+}
+
+double DawnPerfTestEnvironment::GetRegressionThreshold() const {
+    return mRegressionThreshold;
+}
+
+void DawnPerfTestEnvironment::LoadBaseline() {
+    std::ifstream inFile(mBaselineFile);
+    if (!inFile.is_open()) {
+        dawn::ErrorLog() << "Couldn't open the baseline file " << mBaselineFile;
+        return;
+    }
+
+    // WriteResults writes one result per line, so there is no need for a full JSON parser.
+    std::string line;
+    while (std::getline(inFile, line)) {
+        Result result;
+        result.metric = ParseResultField(line, "metric");
+        result.story = ParseResultField(line, "story");
+        result.units = ParseResultField(line, "units");
+        result.values = ParseResultValues(line);
+        if (!result.metric.empty() && !result.values.empty()) {
+            mBaselineResults.push_back(std::move(result));
+        }
+    }
+}
+
+void DawnPerfTestEnvironment::WriteResults() const {
+    std::ofstream outFile;
+    outFile.open(mResultsFile);
+    outFile.precision(std::numeric_limits<double>::max_digits10);
+
+    outFile << "{\"results\": [\n";
+    for (size_t i = 0; i < mResults.size(); ++i) {
+        const Result& result = mResults[i];
+        outFile << "  {\"metric\": \"" << EscapeJSONString(result.metric) << "\", \"story\": \""
+                << EscapeJSONString(result.story) << "\", \"units\": \""
+                << EscapeJSONString(result.units) << "\", \"values\": [";
+        for (size_t j = 0; j < result.values.size(); ++j) {
+            outFile << (j == 0 ? "" : ", ") << result.values[j];
+        }
+        outFile << "]}" << (i + 1 == mResults.size() ? "" : ",") << "\n";
+    }
+    outFile << "]}" << std::endl;
+    outFile.close();
+}
+
 DawnPerfTestBase::DawnPerfTestBase(DawnTestBase* test,
                                    unsigned int iterationsPerStep,
                                    unsigned int maxStepsInFlight)
@@ -228,6 +431,8 @@ void DawnPerfTestBase::RunTest() {
         }
     }
     platform->EnableTraceEventRecording(false);
+
+    CheckForRegressions();
 }
 
 void DawnPerfTestBase::DoRunLoop(double maxRunTime) {
@@ -235,6 +440,7 @@ void DawnPerfTestBase::DoRunLoop(double maxRunTime) {
 
     mNumStepsPerformed = 0;
     cpuTime = 0;
+    mStepTimes.Clear();
     mRunning = true;
 
     wgpu::FenceDescriptor desc = {};
@@ -252,7 +458,9 @@ void DawnPerfTestBase::DoRunLoop(double maxRunTime) {
         TRACE_EVENT0(platform, General, "Step");
         double stepStart = mTimer->GetElapsedTime();
         Step();
-        cpuTime += mTimer->GetElapsedTime() - stepStart;
+        double stepTime = mTimer->GetElapsedTime() - stepStart;
+        cpuTime += stepTime;
+        mStepTimes.Record(stepTime);
 
         mTest->queue.Signal(fence, ++signaledFenceValue);
 
@@ -344,6 +552,13 @@ void DawnPerfTestBase::OutputResults() {
     PrintPerIterationResultFromSeconds("validation_time", totalValidationTime, true);
     PrintPerIterationResultFromSeconds("recording_time", totalRecordingTime, true);
 
+    // The distribution of the time of whole Steps, for the tail latencies hidden by the mean.
+    PrintResultFromSeconds("step_time_min", mStepTimes.GetMin(), false);
+    PrintResultFromSeconds("step_time_p50", mStepTimes.GetPercentile(50), false);
+    PrintResultFromSeconds("step_time_p90", mStepTimes.GetPercentile(90), false);
+    PrintResultFromSeconds("step_time_p99", mStepTimes.GetPercentile(99), false);
+    PrintResultFromSeconds("step_time_max", mStepTimes.GetMax(), false);
+
     const char* traceFile = gTestEnv->GetTraceFile();
     if (traceFile != nullptr) {
         DumpTraceEventsToJSONFile(traceEventBuffer, traceFile);
@@ -359,34 +574,48 @@ void DawnPerfTestBase::PrintPerIterationResultFromSeconds(const std::string& tra
 
     double secondsPerIteration =
         valueInSeconds / static_cast<double>(mNumStepsPerformed * mIterationsPerStep);
+    PrintResultFromSeconds(trace, secondsPerIteration, important);
+}
 
+void DawnPerfTestBase::PrintResultFromSeconds(const std::string& trace,
+                                              double valueInSeconds,
+                                              bool important) const {
     // Give the result a different name to ensure separate graphs if we transition.
-    if (secondsPerIteration > 1) {
-        PrintResult(trace, secondsPerIteration * 1e3, "ms", important);
-    } else if (secondsPerIteration > 1e-3) {
-        PrintResult(trace, secondsPerIteration * 1e6, "us", important);
+    double value;
+    const char* units;
+    if (valueInSeconds > 1) {
+        value = valueInSeconds * 1e3;
+        units = "ms";
+    } else if (valueInSeconds > 1e-3) {
+        value = valueInSeconds * 1e6;
+        units = "us";
     } else {
-        PrintResult(trace, secondsPerIteration * 1e9, "ns", important);
+        value = valueInSeconds * 1e9;
+        units = "ns";
     }
+    PrintResultImpl(trace, std::to_string(value), units, valueInSeconds, "s", important);
 }
 
 void DawnPerfTestBase::PrintResult(const std::string& trace,
                                    double value,
                                    const std::string& units,
                                    bool important) const {
-    PrintResultImpl(trace, std::to_string(value), units, important);
+    PrintResultImpl(trace, std::to_string(value), units, value, units, important);
 }
 
 void DawnPerfTestBase::PrintResult(const std::string& trace,
                                    unsigned int value,
                                    const std::string& units,
                                    bool important) const {
-    PrintResultImpl(trace, std::to_string(value), units, important);
+    PrintResultImpl(trace, std::to_string(value), units, static_cast<double>(value), units,
+                    important);
 }
 
 void DawnPerfTestBase::PrintResultImpl(const std::string& trace,
                                        const std::string& value,
                                        const std::string& units,
+                                       double recordedValue,
+                                       const std::string& recordedUnits,
                                        bool important) const {
     const ::testing::TestInfo* const testInfo =
         ::testing::UnitTest::GetInstance()->current_test_info();
@@ -400,4 +629,43 @@ void DawnPerfTestBase::PrintResultImpl(const std::string& trace,
     // [chromium]//src/tools/perf/generate_legacy_perf_dashboard_json.py
     dawn::InfoLog() << (important ? "*" : "") << "RESULT " << metric << ": " << story << "= "
                     << value << " " << units;
+
+    gTestEnv->AddResult(metric, story, recordedValue, recordedUnits);
+}
+
+void DawnPerfTestBase::CheckForRegressions() const {
+    const ::testing::TestInfo* const testInfo =
+        ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string metricPrefix = std::string(testInfo->test_suite_name()) + ".";
+    std::string story = testInfo->name();
+    std::replace(story.begin(), story.end(), '/', '_');
+
+    for (const DawnPerfTestEnvironment::Result& result : gTestEnv->GetResults()) {
+        if (result.story != story ||
+            result.metric.compare(0, metricPrefix.size(), metricPrefix) != 0) {
+            continue;
+        }
+
+        const DawnPerfTestEnvironment::Result* baseline =
+            gTestEnv->GetBaselineResult(result.metric, result.story);
+        if (baseline == nullptr) {
+            continue;
+        }
+
+        // Only time metrics are compared, in seconds since baselines written by older versions
+        // used units that depend on the value.
+        double secondsPerUnit = GetSecondsPerUnit(result.units);
+        double baselineSecondsPerUnit = GetSecondsPerUnit(baseline->units);
+        if (secondsPerUnit == 0.0 || baselineSecondsPerUnit == 0.0) {
+            continue;
+        }
+
+        double median = Median(result.values) * secondsPerUnit;
+        double baselineMedian = Median(baseline->values) * baselineSecondsPerUnit;
+        if (median > baselineMedian * (1.0 + gTestEnv->GetRegressionThreshold())) {
+            ADD_FAILURE() << result.metric << " regressed for " << story << ": median of "
+                          << median * 1e6 << "us against " << baselineMedian * 1e6
+                          << "us in the baseline";
+        }
+    }
 }
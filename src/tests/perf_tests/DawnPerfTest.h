@@ -16,6 +16,10 @@
 #define TESTS_PERFTESTS_DAWNPERFTEST_H_
 
 #include "tests/DawnTest.h"
+#include "tests/perf_tests/LatencyHistogram.h"
+
+#include <string>
+#include <vector>
 
 namespace utils {
     class Timer;
@@ -42,7 +46,31 @@ class DawnPerfTestEnvironment : public DawnTestEnvironment {
 
     DawnPerfTestPlatform* GetPlatform() const;
 
+    // All the values reported for a metric of a test, one per trial.
+    struct Result {
+        std::string metric;
+        std::string story;
+        std::string units;
+        std::vector<double> values;
+    };
+
+    void AddResult(const std::string& metric,
+                   const std::string& story,
+                   double value,
+                   const std::string& units);
+    const std::vector<Result>& GetResults() const;
+
+    // Returns the result of a previous run loaded from the baseline file, or nullptr if there is
+    // no baseline for that metric.
+    const Result* GetBaselineResult(const std::string& metric, const std::string& story) const;
+    // A time metric regresses if its median is larger than the baseline median by more than
+    // this fraction.
+    double GetRegressionThreshold() const;
+
   private:
+    void LoadBaseline();
+    void WriteResults() const;
+
     // Only run calibration which allows the perf test runner to save time.
     bool mIsCalibrating = false;
 
@@ -51,6 +79,15 @@ class DawnPerfTestEnvironment : public DawnTestEnvironment {
 
     const char* mTraceFile = nullptr;
 
+    // Files to write the results to and to compare the results against, in the JSON format
+    // written by WriteResults.
+    const char* mResultsFile = nullptr;
+    const char* mBaselineFile = nullptr;
+    double mRegressionThreshold = 0.1;
+
+    std::vector<Result> mResults;
+    std::vector<Result> mBaselineResults;
+
     std::unique_ptr<DawnPerfTestPlatform> mPlatform;
 };
 
@@ -78,6 +115,9 @@ class DawnPerfTestBase {
     void PrintPerIterationResultFromSeconds(const std::string& trace,
                                             double valueInSeconds,
                                             bool important) const;
+    void PrintResultFromSeconds(const std::string& trace,
+                                double valueInSeconds,
+                                bool important) const;
     void PrintResult(const std::string& trace,
                      double value,
                      const std::string& units,
@@ -90,10 +130,16 @@ class DawnPerfTestBase {
   private:
     void DoRunLoop(double maxRunTime);
     void OutputResults();
+    void CheckForRegressions() const;
 
+    // |recordedValue| and |recordedUnits| are what is added to the results. Time metrics are
+    // recorded in seconds so that all their trials have the same units, whichever units are
+    // printed.
     void PrintResultImpl(const std::string& trace,
                          const std::string& value,
                          const std::string& units,
+                         double recordedValue,
+                         const std::string& recordedUnits,
                          bool important) const;
 
     virtual void Step() = 0;
@@ -105,6 +151,8 @@ class DawnPerfTestBase {
     unsigned int mStepsToRun = 0;
     unsigned int mNumStepsPerformed = 0;
     double cpuTime;
+    // The CPU time of each Step, to report the latency distribution and not only the mean.
+    LatencyHistogram mStepTimes;
     std::unique_ptr<utils::Timer> mTimer;
 };
 
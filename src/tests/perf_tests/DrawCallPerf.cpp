@@ -92,16 +92,22 @@ namespace {
         Yes,  // Record commands in a render bundle
     };
 
+    enum class DrawBatching {
+        Individual,  // Record one Draw command per draw.
+        MultiDraw,   // Record all the draws in a single MultiDraw command.
+    };
+
     struct DrawCallParam {
         Pipeline pipelineType;
         VertexBuffer vertexBufferType;
         BindGroup bindGroupType;
         UniformData uniformDataType;
         RenderBundle withRenderBundle;
+        DrawBatching drawBatching;
     };
 
     using DrawCallParamTuple =
-        std::tuple<Pipeline, VertexBuffer, BindGroup, UniformData, RenderBundle>;
+        std::tuple<Pipeline, VertexBuffer, BindGroup, UniformData, RenderBundle, DrawBatching>;
 
     template <typename T>
     unsigned int AssignParam(T& lhs, T rhs) {
@@ -117,11 +123,13 @@ namespace {
     //  - BindGroup::NoChange
     //  - UniformData::Static
     //  - RenderBundle::No
+    //  - DrawBatching::Individual
     template <typename... Ts>
     DrawCallParam MakeParam(Ts... args) {
         // Baseline param
-        DrawCallParamTuple paramTuple{Pipeline::Static, VertexBuffer::NoChange, BindGroup::NoChange,
-                                      UniformData::Static, RenderBundle::No};
+        DrawCallParamTuple paramTuple{Pipeline::Static,    VertexBuffer::NoChange,
+                                      BindGroup::NoChange, UniformData::Static,
+                                      RenderBundle::No,    DrawBatching::Individual};
 
         unsigned int unused[] = {
             0,  // Avoid making a 0-sized array.
@@ -132,7 +140,7 @@ namespace {
         return DrawCallParam{
             std::get<Pipeline>(paramTuple),     std::get<VertexBuffer>(paramTuple),
             std::get<BindGroup>(paramTuple),    std::get<UniformData>(paramTuple),
-            std::get<RenderBundle>(paramTuple),
+            std::get<RenderBundle>(paramTuple), std::get<DrawBatching>(paramTuple),
         };
     }
 
@@ -202,6 +210,14 @@ namespace {
                 break;
         }
 
+        switch (param.drawBatching) {
+            case DrawBatching::Individual:
+                break;
+            case DrawBatching::MultiDraw:
+                ostream << "_MultiDraw";
+                break;
+        }
+
         return ostream;
     }
 
@@ -221,6 +237,8 @@ namespace {
 //     precomputed in a render bundle.
 //   - Static/Dynamic data: Updating data for each draw is a common use case. It also tests
 //     the efficiency of resource transitions.
+//   - Individual/Multi draws: When no state changes between draws, a single MultiDraw
+//     command avoids the per-draw encoding and validation overhead.
 class DrawCallPerf : public DawnPerfTestWithParams<DrawCallParamForTest> {
   public:
     DrawCallPerf() : DawnPerfTestWithParams(kNumDraws, 3) {
@@ -265,6 +283,9 @@ class DrawCallPerf : public DawnPerfTestWithParams<DrawCallParamForTest> {
     wgpu::TextureView mDepthStencilAttachment;
 
     wgpu::RenderBundle mRenderBundle;
+
+    // The draws recorded with a single MultiDraw when using DrawBatching::MultiDraw.
+    std::vector<wgpu::DrawArguments> mMultiDraws;
 };
 
 void DrawCallPerf::SetUp() {
@@ -455,6 +476,12 @@ void DrawCallPerf::SetUp() {
             break;
     }
 
+    if (GetParam().drawBatching == DrawBatching::MultiDraw) {
+        wgpu::DrawArguments draw = {};
+        draw.vertexCount = 3;
+        mMultiDraws = std::vector<wgpu::DrawArguments>(kNumDraws, draw);
+    }
+
     // If using render bundles, record the render commands now.
     if (GetParam().withRenderBundle == RenderBundle::Yes) {
         wgpu::RenderBundleEncoderDescriptor descriptor = {};
@@ -490,6 +517,16 @@ void DrawCallPerf::RecordRenderCommands(Encoder pass) {
         pass.SetBindGroup(uniformBindGroupIndex, mUniformBindGroups[0]);
     }
 
+    if (GetParam().drawBatching == DrawBatching::MultiDraw) {
+        // Multi draws can only be used when no state changes between the draws.
+        ASSERT(GetParam().pipelineType == Pipeline::Static);
+        ASSERT(GetParam().vertexBufferType == VertexBuffer::NoChange);
+        ASSERT(GetParam().bindGroupType == BindGroup::NoChange);
+
+        pass.MultiDraw(kNumDraws, mMultiDraws.data());
+        return;
+    }
+
     for (unsigned int i = 0; i < kNumDraws; ++i) {
         switch (GetParam().pipelineType) {
             case Pipeline::Static:
@@ -613,8 +650,10 @@ TEST_P(DrawCallPerf, Run) {
 
 DAWN_INSTANTIATE_PERF_TEST_SUITE_P(
     DrawCallPerf,
-    {D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend(),
-     VulkanBackend({"skip_validation"})},
+    // The Null backend isolates the per-draw frontend cost: with validation enabled,
+    // validation_time is dominated by the CommandBufferStateTracker checks done for every draw.
+    {D3D12Backend(), MetalBackend(), NullBackend(), NullBackend({"skip_validation"}),
+     OpenGLBackend(), VulkanBackend(), VulkanBackend({"skip_validation"})},
     {
         // Baseline
         MakeParam(),
@@ -659,6 +698,11 @@ DAWN_INSTANTIATE_PERF_TEST_SUITE_P(
 
         // ----------- Render Bundles (end)-------
 
+        // Record all the draws in a single MultiDraw, to compare with the baseline which records
+        // them as individual draws.
+        MakeParam(DrawBatching::MultiDraw),
+        MakeParam(DrawBatching::MultiDraw, RenderBundle::Yes),
+
         // Update per-draw data in the bind group(s). This will cause resource transitions between
         // updating and drawing.
         MakeParam(BindGroup::Multiple,
@@ -0,0 +1,337 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/perf_tests/DawnPerfTest.h"
+
+#include "common/Constants.h"
+#include "tests/ParamGenerator.h"
+#include "utils/WGPUHelpers.h"
+
+namespace {
+
+    constexpr uint32_t kBufferSize = 256;
+    constexpr uint32_t kTextureSize = 16;
+    constexpr uint32_t kDispatchesPerPass = 16;
+
+    enum class Workload {
+        CreateBindGroup,
+        CreateDestroyBuffer,
+        PipelineCacheHit,
+        EncodeAndFinish,
+        Submit,
+        MapAsyncRoundTrip,
+        WriteBuffer,
+        WriteTexture,
+        ErrorScope,
+        ErrorHeavyEncoding,
+    };
+
+    struct FrontendParams : AdapterTestParam {
+        FrontendParams(const AdapterTestParam& param, Workload workload)
+            : AdapterTestParam(param), workload(workload) {
+        }
+
+        Workload workload;
+    };
+
+    std::ostream& operator<<(std::ostream& ostream, const FrontendParams& param) {
+        ostream << static_cast<const AdapterTestParam&>(param);
+
+        switch (param.workload) {
+            case Workload::CreateBindGroup:
+                ostream << "_CreateBindGroup";
+                break;
+            case Workload::CreateDestroyBuffer:
+                ostream << "_CreateDestroyBuffer";
+                break;
+            case Workload::PipelineCacheHit:
+                ostream << "_PipelineCacheHit";
+                break;
+            case Workload::EncodeAndFinish:
+                ostream << "_EncodeAndFinish";
+                break;
+            case Workload::Submit:
+                ostream << "_Submit";
+                break;
+            case Workload::MapAsyncRoundTrip:
+                ostream << "_MapAsyncRoundTrip";
+                break;
+            case Workload::WriteBuffer:
+                ostream << "_WriteBuffer";
+                break;
+            case Workload::WriteTexture:
+                ostream << "_WriteTexture";
+                break;
+            case Workload::ErrorScope:
+                ostream << "_ErrorScope";
+                break;
+            case Workload::ErrorHeavyEncoding:
+                ostream << "_ErrorHeavyEncoding";
+                break;
+        }
+        return ostream;
+    }
+
+    unsigned int GetIterationsPerStep(Workload workload) {
+        switch (workload) {
+            // Each of these iterations ticks the device at least once.
+            case Workload::MapAsyncRoundTrip:
+                return 100;
+            // Each of these iterations creates one error per command of a pass.
+            case Workload::ErrorHeavyEncoding:
+                return 100;
+            default:
+                return 1000;
+        }
+    }
+
+}  // namespace
+
+// Test the CPU cost of frontend entry points, one workload at a time. Everything runs on the Null
+// backend so these measure the validation and bookkeeping done by Dawn itself, and can run on
+// machines without a GPU.
+class FrontendPerf : public DawnPerfTestWithParams<FrontendParams> {
+  public:
+    FrontendPerf()
+        : DawnPerfTestWithParams(GetIterationsPerStep(GetParam().workload), 1),
+          mIterations(GetIterationsPerStep(GetParam().workload)) {
+    }
+    ~FrontendPerf() override = default;
+
+    void SetUp() override;
+
+  private:
+    void Step() override;
+
+    void StepMapAsyncRoundTrip();
+
+    const unsigned int mIterations;
+
+    wgpu::ShaderModule mComputeModule;
+    wgpu::BindGroupLayout mBindGroupLayout;
+    wgpu::PipelineLayout mPipelineLayout;
+    wgpu::ComputePipeline mPipeline;
+    wgpu::Buffer mUniformBuffer;
+    wgpu::Sampler mSampler;
+    wgpu::BindGroup mBindGroup;
+    wgpu::Buffer mCopyDstBuffer;
+    wgpu::Buffer mMapReadBuffer;
+    wgpu::Texture mTexture;
+    wgpu::CommandBuffer mReusableCommands;
+    std::vector<uint8_t> mData;
+};
+
+void FrontendPerf::SetUp() {
+    DawnPerfTestWithParams<FrontendParams>::SetUp();
+
+    mComputeModule = utils::CreateShaderModule(device, utils::SingleShaderStage::Compute, R"(
+        #version 450
+        layout(set = 0, binding = 0) uniform Uniforms {
+            vec4 value;
+        };
+        layout(set = 0, binding = 1) uniform sampler samp;
+        void main() {
+        })");
+
+    mBindGroupLayout = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::UniformBuffer},
+                 {1, wgpu::ShaderStage::Compute, wgpu::BindingType::Sampler}});
+    mPipelineLayout = utils::MakeBasicPipelineLayout(device, &mBindGroupLayout);
+
+    wgpu::ComputePipelineDescriptor pipelineDescriptor;
+    pipelineDescriptor.layout = mPipelineLayout;
+    pipelineDescriptor.computeStage.module = mComputeModule;
+    pipelineDescriptor.computeStage.entryPoint = "main";
+    mPipeline = device.CreateComputePipeline(&pipelineDescriptor);
+
+    wgpu::BufferDescriptor bufferDescriptor;
+    bufferDescriptor.size = kBufferSize;
+    bufferDescriptor.usage = wgpu::BufferUsage::Uniform;
+    mUniformBuffer = device.CreateBuffer(&bufferDescriptor);
+
+    bufferDescriptor.usage = wgpu::BufferUsage::CopyDst;
+    mCopyDstBuffer = device.CreateBuffer(&bufferDescriptor);
+
+    bufferDescriptor.usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead;
+    mMapReadBuffer = device.CreateBuffer(&bufferDescriptor);
+
+    mSampler = device.CreateSampler(nullptr);
+    mBindGroup = utils::MakeBindGroup(device, mBindGroupLayout,
+                                      {{0, mUniformBuffer, 0, kBufferSize}, {1, mSampler}});
+
+    wgpu::TextureDescriptor textureDescriptor;
+    textureDescriptor.size = {kTextureSize, kTextureSize, 1};
+    textureDescriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+    textureDescriptor.usage = wgpu::TextureUsage::CopyDst;
+    mTexture = device.CreateTexture(&textureDescriptor);
+
+    mData.resize(kTextureSize * kTextureSize * 4);
+
+    // Submitting the same reusable command buffer keeps encoding out of the Submit workload.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.SetPipeline(mPipeline);
+        pass.SetBindGroup(0, mBindGroup);
+        pass.Dispatch(1);
+        pass.EndPass();
+
+        wgpu::CommandBufferDescriptor commandBufferDescriptor;
+        commandBufferDescriptor.reusable = true;
+        mReusableCommands = encoder.Finish(&commandBufferDescriptor);
+    }
+}
+
+void FrontendPerf::Step() {
+    switch (GetParam().workload) {
+        case Workload::CreateBindGroup: {
+            for (unsigned int i = 0; i < mIterations; ++i) {
+                utils::MakeBindGroup(device, mBindGroupLayout,
+                                     {{0, mUniformBuffer, 0, kBufferSize}, {1, mSampler}});
+            }
+            break;
+        }
+
+        case Workload::CreateDestroyBuffer: {
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = kBufferSize;
+            descriptor.usage = wgpu::BufferUsage::Vertex | wgpu::BufferUsage::CopyDst;
+            for (unsigned int i = 0; i < mIterations; ++i) {
+                device.CreateBuffer(&descriptor).Destroy();
+            }
+            break;
+        }
+
+        case Workload::PipelineCacheHit: {
+            // The pipeline created in SetUp keeps the cache entry alive so every creation is a hit.
+            wgpu::ComputePipelineDescriptor descriptor;
+            descriptor.layout = mPipelineLayout;
+            descriptor.computeStage.module = mComputeModule;
+            descriptor.computeStage.entryPoint = "main";
+            for (unsigned int i = 0; i < mIterations; ++i) {
+                device.CreateComputePipeline(&descriptor);
+            }
+            break;
+        }
+
+        case Workload::EncodeAndFinish: {
+            for (unsigned int i = 0; i < mIterations; ++i) {
+                wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+                wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+                pass.SetPipeline(mPipeline);
+                for (uint32_t j = 0; j < kDispatchesPerPass; ++j) {
+                    pass.SetBindGroup(0, mBindGroup);
+                    pass.Dispatch(1);
+                }
+                pass.EndPass();
+                encoder.Finish();
+            }
+            break;
+        }
+
+        case Workload::Submit: {
+            for (unsigned int i = 0; i < mIterations; ++i) {
+                queue.Submit(1, &mReusableCommands);
+            }
+            break;
+        }
+
+        case Workload::MapAsyncRoundTrip: {
+            StepMapAsyncRoundTrip();
+            break;
+        }
+
+        case Workload::WriteBuffer: {
+            for (unsigned int i = 0; i < mIterations; ++i) {
+                queue.WriteBuffer(mCopyDstBuffer, 0, mData.data(), kBufferSize);
+            }
+            queue.Submit(0, nullptr);
+            break;
+        }
+
+        case Workload::WriteTexture: {
+            wgpu::TextureCopyView copyView = utils::CreateTextureCopyView(mTexture, 0, {0, 0, 0});
+            wgpu::TextureDataLayout dataLayout =
+                utils::CreateTextureDataLayout(0, kTextureSize * 4, kTextureSize);
+            wgpu::Extent3D copySize = {kTextureSize, kTextureSize, 1};
+            for (unsigned int i = 0; i < mIterations; ++i) {
+                queue.WriteTexture(&copyView, mData.data(), mData.size(), &dataLayout, &copySize);
+            }
+            queue.Submit(0, nullptr);
+            break;
+        }
+
+        case Workload::ErrorScope: {
+            for (unsigned int i = 0; i < mIterations; ++i) {
+                device.PushErrorScope(wgpu::ErrorFilter::Validation);
+                device.PopErrorScope([](WGPUErrorType, const char*, void*) {}, nullptr);
+            }
+            device.Tick();
+            break;
+        }
+
+        case Workload::ErrorHeavyEncoding: {
+            // Every SetBindGroup fails validation when it is encoded because its index is over the
+            // max. The encoder keeps the first error and discards the others, and the error of
+            // Finish is captured by the error scope, like an application with a bug in its frame
+            // loop.
+            for (unsigned int i = 0; i < mIterations; ++i) {
+                device.PushErrorScope(wgpu::ErrorFilter::Validation);
+                wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+                wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+                for (uint32_t j = 0; j < kDispatchesPerPass; ++j) {
+                    pass.SetBindGroup(kMaxBindGroups, mBindGroup);
+                    pass.Dispatch(1);
+                }
+                pass.EndPass();
+                encoder.Finish();
+                device.PopErrorScope([](WGPUErrorType, const char*, void*) {}, nullptr);
+            }
+            device.Tick();
+            break;
+        }
+    }
+}
+
+void FrontendPerf::StepMapAsyncRoundTrip() {
+    for (unsigned int i = 0; i < mIterations; ++i) {
+        bool done = false;
+        mMapReadBuffer.MapAsync(
+            wgpu::MapMode::Read, 0, kBufferSize,
+            [](WGPUBufferMapAsyncStatus status, void* userdata) {
+                ASSERT(status == WGPUBufferMapAsyncStatus_Success);
+                *static_cast<bool*>(userdata) = true;
+            },
+            &done);
+
+        // Don't use WaitABit because its sleep would dominate the measurement.
+        while (!done) {
+            device.Tick();
+            FlushWire();
+        }
+        mMapReadBuffer.Unmap();
+    }
+}
+
+TEST_P(FrontendPerf, Run) {
+    RunTest();
+}
+
+DAWN_INSTANTIATE_PERF_TEST_SUITE_P(FrontendPerf,
+                                   {NullBackend()},
+                                   {Workload::CreateBindGroup, Workload::CreateDestroyBuffer,
+                                    Workload::PipelineCacheHit, Workload::EncodeAndFinish,
+                                    Workload::Submit, Workload::MapAsyncRoundTrip,
+                                    Workload::WriteBuffer, Workload::WriteTexture,
+                                    Workload::ErrorScope, Workload::ErrorHeavyEncoding});
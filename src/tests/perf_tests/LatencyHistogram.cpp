@@ -0,0 +1,103 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/perf_tests/LatencyHistogram.h"
+
+#include "common/Assert.h"
+#include "common/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+LatencyHistogram::LatencyHistogram() {
+    Clear();
+}
+
+void LatencyHistogram::Clear() {
+    mBuckets.fill(0);
+    mCount = 0;
+    mMinNanoseconds = std::numeric_limits<uint64_t>::max();
+    mMaxNanoseconds = 0;
+}
+
+void LatencyHistogram::Record(double seconds) {
+    uint64_t nanoseconds = static_cast<uint64_t>(std::max(seconds, 0.0) * 1e9);
+    mBuckets[GetBucketIndex(nanoseconds)]++;
+    mCount++;
+    mMinNanoseconds = std::min(mMinNanoseconds, nanoseconds);
+    mMaxNanoseconds = std::max(mMaxNanoseconds, nanoseconds);
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+    return mCount;
+}
+
+double LatencyHistogram::GetMin() const {
+    return mCount == 0 ? 0.0 : static_cast<double>(mMinNanoseconds) * 1e-9;
+}
+
+double LatencyHistogram::GetMax() const {
+    return static_cast<double>(mMaxNanoseconds) * 1e-9;
+}
+
+double LatencyHistogram::GetPercentile(double percentile) const {
+    ASSERT(percentile >= 0.0 && percentile <= 100.0);
+    if (mCount == 0) {
+        return 0.0;
+    }
+
+    // The rank of the duration at that percentile, using the nearest-rank method.
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * mCount));
+    rank = std::max(rank, uint64_t(1));
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < kBucketCount; ++i) {
+        seen += mBuckets[i];
+        if (seen >= rank) {
+            uint64_t nanoseconds =
+                std::min(std::max(GetBucketMiddle(i), mMinNanoseconds), mMaxNanoseconds);
+            return static_cast<double>(nanoseconds) * 1e-9;
+        }
+    }
+    UNREACHABLE();
+    return GetMax();
+}
+
+// static
+uint32_t LatencyHistogram::GetBucketIndex(uint64_t nanoseconds) {
+    // Small values each get their own bucket.
+    if (nanoseconds < kSubBucketCount) {
+        return static_cast<uint32_t>(nanoseconds);
+    }
+
+    // Otherwise the bucket is chosen by the power of two and the next kSubBucketBits bits.
+    uint32_t exponent = Log2(nanoseconds);
+    uint32_t subBucket =
+        static_cast<uint32_t>(nanoseconds >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1);
+    return (exponent - kSubBucketBits + 1) * kSubBucketCount + subBucket;
+}
+
+// static
+uint64_t LatencyHistogram::GetBucketMiddle(uint32_t bucketIndex) {
+    if (bucketIndex < kSubBucketCount) {
+        return bucketIndex;
+    }
+
+    uint32_t exponent = bucketIndex / kSubBucketCount + kSubBucketBits - 1;
+    uint64_t subBucket = bucketIndex % kSubBucketCount;
+    uint64_t width = uint64_t(1) << (exponent - kSubBucketBits);
+    uint64_t lowerBound = (uint64_t(1) << exponent) + subBucket * width;
+    return lowerBound + width / 2;
+}
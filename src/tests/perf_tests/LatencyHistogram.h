@@ -0,0 +1,51 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TESTS_PERFTESTS_LATENCYHISTOGRAM_H_
+#define TESTS_PERFTESTS_LATENCYHISTOGRAM_H_
+
+#include <array>
+#include <cstdint>
+
+// Records durations in buckets whose width is a sixteenth of their power of two, so that
+// percentiles are within about 3% of the exact value while using a fixed amount of memory no
+// matter how many durations are recorded. The minimum and maximum are exact.
+class LatencyHistogram {
+  public:
+    LatencyHistogram();
+
+    void Clear();
+    void Record(double seconds);
+
+    uint64_t GetCount() const;
+    double GetMin() const;
+    double GetMax() const;
+    // |percentile| is in [0, 100]. Returns 0 if no duration was recorded.
+    double GetPercentile(double percentile) const;
+
+  private:
+    static constexpr uint32_t kSubBucketBits = 4;
+    static constexpr uint32_t kSubBucketCount = 1 << kSubBucketBits;
+    static constexpr uint32_t kBucketCount = kSubBucketCount * (64 - kSubBucketBits + 1);
+
+    static uint32_t GetBucketIndex(uint64_t nanoseconds);
+    static uint64_t GetBucketMiddle(uint32_t bucketIndex);
+
+    std::array<uint64_t, kBucketCount> mBuckets;
+    uint64_t mCount;
+    uint64_t mMinNanoseconds;
+    uint64_t mMaxNanoseconds;
+};
+
+#endif  // TESTS_PERFTESTS_LATENCYHISTOGRAM_H_
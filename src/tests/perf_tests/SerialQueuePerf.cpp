@@ -0,0 +1,90 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/perf_tests/DawnPerfTest.h"
+
+#include "common/SerialQueue.h"
+#include "tests/ParamGenerator.h"
+
+namespace {
+
+    constexpr unsigned int kNumIterations = 10000;
+
+    struct SerialQueueParams : AdapterTestParam {
+        SerialQueueParams(const AdapterTestParam& param,
+                          uint32_t valuesPerSerial,
+                          uint32_t serialsInFlight)
+            : AdapterTestParam(param),
+              valuesPerSerial(valuesPerSerial),
+              serialsInFlight(serialsInFlight) {
+        }
+
+        uint32_t valuesPerSerial;
+        uint32_t serialsInFlight;
+    };
+
+    std::ostream& operator<<(std::ostream& ostream, const SerialQueueParams& param) {
+        ostream << static_cast<const AdapterTestParam&>(param);
+        ostream << "_" << param.valuesPerSerial << "ValuesPerSerial";
+        ostream << "_" << param.serialsInFlight << "SerialsInFlight";
+        return ostream;
+    }
+
+}  // namespace
+
+// Test the churn of a SerialQueue used like the deleters and allocators of the backends: each
+// iteration enqueues values for a new serial and clears the serials that completed. It doesn't
+// use the GPU, the Null backend is only there to satisfy the perf test harness.
+class SerialQueuePerf : public DawnPerfTestWithParams<SerialQueueParams> {
+  public:
+    SerialQueuePerf() : DawnPerfTestWithParams(kNumIterations, 1) {
+    }
+    ~SerialQueuePerf() override = default;
+
+  private:
+    void Step() override;
+
+    SerialQueue<uint64_t, uint64_t> mQueue;
+    uint64_t mSerial = 0;
+    uint64_t mChecksum = 0;
+};
+
+void SerialQueuePerf::Step() {
+    const uint32_t valuesPerSerial = GetParam().valuesPerSerial;
+    const uint32_t serialsInFlight = GetParam().serialsInFlight;
+
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        mSerial++;
+        for (uint32_t v = 0; v < valuesPerSerial; ++v) {
+            mQueue.Enqueue(mSerial + v, mSerial);
+        }
+
+        if (mSerial > serialsInFlight) {
+            uint64_t completedSerial = mSerial - serialsInFlight;
+            for (uint64_t value : mQueue.IterateUpTo(completedSerial)) {
+                mChecksum += value;
+            }
+            mQueue.ClearUpTo(completedSerial);
+        }
+    }
+}
+
+TEST_P(SerialQueuePerf, Run) {
+    RunTest();
+}
+
+DAWN_INSTANTIATE_PERF_TEST_SUITE_P(SerialQueuePerf,
+                                   {NullBackend()},
+                                   {1u, 16u},
+                                   {3u, 64u});
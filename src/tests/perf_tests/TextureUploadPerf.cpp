@@ -0,0 +1,203 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/perf_tests/DawnPerfTest.h"
+
+#include "common/Assert.h"
+#include "common/Constants.h"
+#include "common/Math.h"
+#include "tests/ParamGenerator.h"
+#include "utils/WGPUHelpers.h"
+
+namespace {
+
+    constexpr unsigned int kNumIterations = 50;
+
+    enum class TextureFormat {
+        R8Unorm,
+        RGBA8Unorm,
+        RGBA32Float,
+    };
+
+    enum class UploadSize {
+        TextureSize_64x64,
+        TextureSize_512x512,
+        TextureSize_2048x2048,
+    };
+
+    // Whether the rows of the uploaded data are tightly packed or padded to
+    // kTextureBytesPerRowAlignment.
+    enum class RowPitch {
+        Tight,
+        Aligned,
+    };
+
+    struct TextureUploadParams : AdapterTestParam {
+        TextureUploadParams(const AdapterTestParam& param,
+                            TextureFormat format,
+                            UploadSize uploadSize,
+                            RowPitch rowPitch)
+            : AdapterTestParam(param), format(format), uploadSize(uploadSize), rowPitch(rowPitch) {
+        }
+
+        TextureFormat format;
+        UploadSize uploadSize;
+        RowPitch rowPitch;
+    };
+
+    std::ostream& operator<<(std::ostream& ostream, const TextureUploadParams& param) {
+        ostream << static_cast<const AdapterTestParam&>(param);
+
+        switch (param.format) {
+            case TextureFormat::R8Unorm:
+                ostream << "_R8Unorm";
+                break;
+            case TextureFormat::RGBA8Unorm:
+                ostream << "_RGBA8Unorm";
+                break;
+            case TextureFormat::RGBA32Float:
+                ostream << "_RGBA32Float";
+                break;
+        }
+
+        switch (param.uploadSize) {
+            case UploadSize::TextureSize_64x64:
+                ostream << "_TextureSize_64x64";
+                break;
+            case UploadSize::TextureSize_512x512:
+                ostream << "_TextureSize_512x512";
+                break;
+            case UploadSize::TextureSize_2048x2048:
+                ostream << "_TextureSize_2048x2048";
+                break;
+        }
+
+        switch (param.rowPitch) {
+            case RowPitch::Tight:
+                ostream << "_TightRows";
+                break;
+            case RowPitch::Aligned:
+                ostream << "_AlignedRows";
+                break;
+        }
+
+        return ostream;
+    }
+
+    wgpu::TextureFormat GetTextureFormat(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::R8Unorm:
+                return wgpu::TextureFormat::R8Unorm;
+            case TextureFormat::RGBA8Unorm:
+                return wgpu::TextureFormat::RGBA8Unorm;
+            case TextureFormat::RGBA32Float:
+                return wgpu::TextureFormat::RGBA32Float;
+        }
+        UNREACHABLE();
+    }
+
+    uint32_t GetBytesPerTexel(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::R8Unorm:
+                return 1;
+            case TextureFormat::RGBA8Unorm:
+                return 4;
+            case TextureFormat::RGBA32Float:
+                return 16;
+        }
+        UNREACHABLE();
+    }
+
+    uint32_t GetTextureSize(UploadSize uploadSize) {
+        switch (uploadSize) {
+            case UploadSize::TextureSize_64x64:
+                return 64;
+            case UploadSize::TextureSize_512x512:
+                return 512;
+            case UploadSize::TextureSize_2048x2048:
+                return 2048;
+        }
+        UNREACHABLE();
+    }
+
+}  // namespace
+
+// Test uploading a 2D texture with WriteTexture |kNumIterations| times. This stresses the
+// repacking of the data into the layout expected by the backend, which is all the work done
+// on the Null backend.
+class TextureUploadPerf : public DawnPerfTestWithParams<TextureUploadParams> {
+  public:
+    TextureUploadPerf() : DawnPerfTestWithParams(kNumIterations, 1) {
+    }
+    ~TextureUploadPerf() override = default;
+
+    void SetUp() override;
+
+  private:
+    void Step() override;
+
+    wgpu::Texture mTexture;
+    wgpu::TextureDataLayout mDataLayout = {};
+    wgpu::Extent3D mSize = {};
+    std::vector<uint8_t> mData;
+};
+
+void TextureUploadPerf::SetUp() {
+    DawnPerfTestWithParams<TextureUploadParams>::SetUp();
+
+    uint32_t size = GetTextureSize(GetParam().uploadSize);
+    mSize = {size, size, 1};
+
+    wgpu::TextureDescriptor desc = {};
+    desc.size = mSize;
+    desc.format = GetTextureFormat(GetParam().format);
+    desc.usage = wgpu::TextureUsage::CopyDst;
+    mTexture = device.CreateTexture(&desc);
+
+    uint32_t bytesPerRow = size * GetBytesPerTexel(GetParam().format);
+    if (GetParam().rowPitch == RowPitch::Aligned) {
+        // Always add padding so that the rows aren't tightly packed even when their size is
+        // already a multiple of the alignment.
+        bytesPerRow = Align(bytesPerRow + 1, kTextureBytesPerRowAlignment);
+    }
+    mDataLayout.bytesPerRow = bytesPerRow;
+    mDataLayout.rowsPerImage = size;
+
+    mData.resize(uint64_t(bytesPerRow) * size);
+    for (size_t i = 0; i < mData.size(); ++i) {
+        mData[i] = static_cast<uint8_t>(i);
+    }
+}
+
+void TextureUploadPerf::Step() {
+    wgpu::TextureCopyView copyView = utils::CreateTextureCopyView(mTexture, 0, {0, 0, 0});
+    for (unsigned int i = 0; i < kNumIterations; ++i) {
+        queue.WriteTexture(&copyView, mData.data(), mData.size(), &mDataLayout, &mSize);
+    }
+    // Make sure all WriteTexture's are flushed.
+    queue.Submit(0, nullptr);
+}
+
+TEST_P(TextureUploadPerf, Run) {
+    RunTest();
+}
+
+DAWN_INSTANTIATE_PERF_TEST_SUITE_P(TextureUploadPerf,
+                                   {D3D12Backend(), MetalBackend(), NullBackend(), OpenGLBackend(),
+                                    VulkanBackend()},
+                                   {TextureFormat::R8Unorm, TextureFormat::RGBA8Unorm,
+                                    TextureFormat::RGBA32Float},
+                                   {UploadSize::TextureSize_64x64, UploadSize::TextureSize_512x512,
+                                    UploadSize::TextureSize_2048x2048},
+                                   {RowPitch::Tight, RowPitch::Aligned});
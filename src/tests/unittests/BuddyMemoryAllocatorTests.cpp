@@ -58,6 +58,12 @@ class DummyBuddyResourceAllocator {
         return mAllocator.ComputeTotalNumOfHeapsForTesting();
     }
 
+    DeviceMemoryUsage::SubAllocatorUsage GetMemoryUsage() const {
+        DeviceMemoryUsage::SubAllocatorUsage usage;
+        mAllocator.ReportMemoryUsage(&usage);
+        return usage;
+    }
+
   private:
     DummyResourceHeapAllocator mHeapAllocator;
     BuddyMemoryAllocator mAllocator;
@@ -457,4 +463,40 @@ TEST(BuddyMemoryAllocatorTests, DestroyHeaps) {
     // Make sure we can destroy the remaining heaps.
     poolAllocator.DestroyPool();
     ASSERT_EQ(poolAllocator.GetPoolSizeForTesting(), 0u);
-}
\ No newline at end of file
+}
+// Verify the memory usage reported for allocations that are not a power of two.
+TEST(BuddyMemoryAllocatorTests, ReportMemoryUsage) {
+    constexpr uint64_t heapSize = 128;
+    constexpr uint64_t maxBlockSize = 512;
+    DummyBuddyResourceAllocator allocator(maxBlockSize, heapSize);
+
+    // A 100 byte allocation takes a 128 byte block which fills the first heap.
+    ResourceMemoryAllocation allocation1 = allocator.Allocate(100);
+    ASSERT_EQ(allocation1.GetInfo().mMethod, AllocationMethod::kSubAllocated);
+
+    // A 20 byte allocation takes a 32 byte block of the second heap.
+    ResourceMemoryAllocation allocation2 = allocator.Allocate(20);
+    ASSERT_EQ(allocation2.GetInfo().mMethod, AllocationMethod::kSubAllocated);
+    ASSERT_EQ(allocator.ComputeTotalNumOfHeapsForTesting(), 2u);
+
+    DeviceMemoryUsage::SubAllocatorUsage usage = allocator.GetMemoryUsage();
+    EXPECT_EQ(usage.heapBytes, 256u);
+    EXPECT_EQ(usage.usedBytes, 120u);
+    EXPECT_EQ(usage.wastedBytes, 40u);
+    EXPECT_EQ(usage.freeBytes, 96u);
+    EXPECT_EQ(usage.pooledBytes, 0u);
+
+    allocator.Deallocate(allocation1);
+    usage = allocator.GetMemoryUsage();
+    EXPECT_EQ(usage.heapBytes, 128u);
+    EXPECT_EQ(usage.usedBytes, 20u);
+    EXPECT_EQ(usage.wastedBytes, 12u);
+    EXPECT_EQ(usage.freeBytes, 96u);
+
+    allocator.Deallocate(allocation2);
+    usage = allocator.GetMemoryUsage();
+    EXPECT_EQ(usage.heapBytes, 0u);
+    EXPECT_EQ(usage.usedBytes, 0u);
+    EXPECT_EQ(usage.wastedBytes, 0u);
+    EXPECT_EQ(usage.freeBytes, 0u);
+}
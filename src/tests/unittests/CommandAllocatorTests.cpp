@@ -16,6 +16,7 @@
 
 #include "dawn_native/CommandAllocator.h"
 
+#include <array>
 #include <limits>
 
 using namespace dawn_native;
@@ -121,12 +122,12 @@ TEST(CommandAllocator, BasicWithData) {
     uint32_t myValues[5] = {6, 42, 0xFFFFFFFF, 0, 54};
 
     {
-        CommandPushConstants* pushConstants =
-            allocator.Allocate<CommandPushConstants>(CommandType::PushConstants);
+        uint32_t* values;
+        CommandPushConstants* pushConstants = allocator.AllocateWithData<CommandPushConstants>(
+            CommandType::PushConstants, 5, &values);
         pushConstants->size = mySize;
         pushConstants->offset = myOffset;
 
-        uint32_t* values = allocator.AllocateData<uint32_t>(5);
         for (size_t i = 0; i < 5; i++) {
             values[i] = myValues[i];
         }
@@ -156,6 +157,49 @@ TEST(CommandAllocator, BasicWithData) {
     }
 }
 
+// Test that the data is aligned after commands of any size and that commands with no data or
+// with data that doesn't fit in the current block are iterated correctly.
+TEST(CommandAllocator, WithDataAlignmentAndSizes) {
+    CommandAllocator allocator;
+
+    constexpr size_t kLargeCount = 4096;
+    const std::array<size_t, 4> counts = {3, 0, kLargeCount, 1};
+
+    for (size_t count : counts) {
+        uint64_t* values;
+        CommandSmall* small =
+            allocator.AllocateWithData<CommandSmall>(CommandType::Small, count, &values);
+        small->data = static_cast<uint16_t>(count);
+        ASSERT_TRUE(IsPtrAligned(values, alignof(uint64_t)));
+        for (size_t i = 0; i < count; i++) {
+            values[i] = count + i;
+        }
+
+        CommandDraw* draw = allocator.Allocate<CommandDraw>(CommandType::Draw);
+        draw->first = static_cast<uint32_t>(count);
+    }
+
+    CommandIterator iterator(std::move(allocator));
+    CommandType type;
+    for (size_t count : counts) {
+        ASSERT_TRUE(iterator.NextCommandId(&type));
+        ASSERT_EQ(type, CommandType::Small);
+        CommandSmall* small = iterator.NextCommand<CommandSmall>();
+        ASSERT_EQ(small->data, count);
+        uint64_t* values = iterator.NextData<uint64_t>(small->data);
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQ(values[i], count + i);
+        }
+
+        ASSERT_TRUE(iterator.NextCommandId(&type));
+        ASSERT_EQ(type, CommandType::Draw);
+        ASSERT_EQ(iterator.NextCommand<CommandDraw>()->first, count);
+    }
+    ASSERT_FALSE(iterator.NextCommandId(&type));
+
+    iterator.MakeEmptyAsDataWasDestroyed();
+}
+
 // Test basic iterating several times
 TEST(CommandAllocator, MultipleIterations) {
     CommandAllocator allocator;
@@ -329,6 +373,38 @@ TEST(CommandAllocator, IteratorReset) {
     }
 }
 
+// Test that setting the position of the iterator back allows reading commands again, including
+// after reaching the end of the commands.
+TEST(CommandAllocator, IteratorPosition) {
+    CommandAllocator allocator;
+
+    for (uint32_t i = 0; i < 2; ++i) {
+        CommandBig* big = allocator.Allocate<CommandBig>(CommandType::Big);
+        big->buffer[0] = i;
+    }
+
+    CommandIterator iterator(std::move(allocator));
+    CommandType type;
+
+    ASSERT_TRUE(iterator.NextCommandId(&type));
+    CommandIterator::Position firstCommand = iterator.GetPosition();
+    ASSERT_EQ(iterator.NextCommand<CommandBig>()->buffer[0], 0u);
+
+    // Read the second command, in another block, and reach the end.
+    ASSERT_TRUE(iterator.NextCommandId(&type));
+    ASSERT_EQ(iterator.NextCommand<CommandBig>()->buffer[0], 1u);
+    ASSERT_FALSE(iterator.NextCommandId(&type));
+
+    iterator.SetPosition(firstCommand);
+    ASSERT_EQ(iterator.NextCommand<CommandBig>()->buffer[0], 0u);
+    ASSERT_TRUE(iterator.NextCommandId(&type));
+    ASSERT_EQ(type, CommandType::Big);
+    ASSERT_EQ(iterator.NextCommand<CommandBig>()->buffer[0], 1u);
+    ASSERT_FALSE(iterator.NextCommandId(&type));
+
+    iterator.MakeEmptyAsDataWasDestroyed();
+}
+
 // Test iterating empty iterators
 TEST(CommandAllocator, EmptyIterator) {
     {
@@ -374,33 +450,37 @@ struct alignas(A) AlignedStruct {
 // Test for overflows in Allocate's computations, size 1 variant
 TEST(CommandAllocator, AllocationOverflow_1) {
     CommandAllocator allocator;
-    AlignedStruct<1>* data =
-        allocator.AllocateData<AlignedStruct<1>>(std::numeric_limits<size_t>::max() / 1);
-    ASSERT_EQ(data, nullptr);
+    AlignedStruct<1>* data;
+    CommandDraw* draw = allocator.AllocateWithData<CommandDraw>(
+        CommandType::Draw, std::numeric_limits<size_t>::max() / 1, &data);
+    ASSERT_EQ(draw, nullptr);
 }
 
 // Test for overflows in Allocate's computations, size 2 variant
 TEST(CommandAllocator, AllocationOverflow_2) {
     CommandAllocator allocator;
-    AlignedStruct<2>* data =
-        allocator.AllocateData<AlignedStruct<2>>(std::numeric_limits<size_t>::max() / 2);
-    ASSERT_EQ(data, nullptr);
+    AlignedStruct<2>* data;
+    CommandDraw* draw = allocator.AllocateWithData<CommandDraw>(
+        CommandType::Draw, std::numeric_limits<size_t>::max() / 2, &data);
+    ASSERT_EQ(draw, nullptr);
 }
 
 // Test for overflows in Allocate's computations, size 4 variant
 TEST(CommandAllocator, AllocationOverflow_4) {
     CommandAllocator allocator;
-    AlignedStruct<4>* data =
-        allocator.AllocateData<AlignedStruct<4>>(std::numeric_limits<size_t>::max() / 4);
-    ASSERT_EQ(data, nullptr);
+    AlignedStruct<4>* data;
+    CommandDraw* draw = allocator.AllocateWithData<CommandDraw>(
+        CommandType::Draw, std::numeric_limits<size_t>::max() / 4, &data);
+    ASSERT_EQ(draw, nullptr);
 }
 
 // Test for overflows in Allocate's computations, size 8 variant
 TEST(CommandAllocator, AllocationOverflow_8) {
     CommandAllocator allocator;
-    AlignedStruct<8>* data =
-        allocator.AllocateData<AlignedStruct<8>>(std::numeric_limits<size_t>::max() / 8);
-    ASSERT_EQ(data, nullptr);
+    AlignedStruct<8>* data;
+    CommandDraw* draw = allocator.AllocateWithData<CommandDraw>(
+        CommandType::Draw, std::numeric_limits<size_t>::max() / 8, &data);
+    ASSERT_EQ(draw, nullptr);
 }
 
 template <int DefaultValue>
@@ -428,18 +508,23 @@ TEST(CommandAllocator, AllocateDefaultInitializes) {
     iterator.MakeEmptyAsDataWasDestroyed();
 }
 
-// Test that the allcator correctly defaults initalizes data for AllocateData
-TEST(CommandAllocator, AllocateDataDefaultInitializes) {
+// Test that the allcator correctly defaults initalizes data for AllocateWithData
+TEST(CommandAllocator, AllocateWithDataDefaultInitializes) {
     CommandAllocator allocator;
 
-    IntWithDefault<33>* int33 = allocator.AllocateData<IntWithDefault<33>>(1);
+    IntWithDefault<33>* int33;
+    IntWithDefault<32>* int32 =
+        allocator.AllocateWithData<IntWithDefault<32>>(CommandType::Draw, 1, &int33);
+    ASSERT_EQ(int32->value, 32);
     ASSERT_EQ(int33[0].value, 33);
 
-    IntWithDefault<34>* int34 = allocator.AllocateData<IntWithDefault<34>>(2);
+    IntWithDefault<34>* int34;
+    allocator.AllocateWithData<IntWithDefault<32>>(CommandType::Draw, 2, &int34);
     ASSERT_EQ(int34[0].value, 34);
     ASSERT_EQ(int34[0].value, 34);
 
-    IntWithDefault<35>* int35 = allocator.AllocateData<IntWithDefault<35>>(3);
+    IntWithDefault<35>* int35;
+    allocator.AllocateWithData<IntWithDefault<32>>(CommandType::Draw, 3, &int35);
     ASSERT_EQ(int35[0].value, 35);
     ASSERT_EQ(int35[1].value, 35);
     ASSERT_EQ(int35[2].value, 35);
@@ -447,3 +532,80 @@ TEST(CommandAllocator, AllocateDataDefaultInitializes) {
     CommandIterator iterator(std::move(allocator));
     iterator.MakeEmptyAsDataWasDestroyed();
 }
+
+// Test that borrowed iterators read the commands independently of the iterator owning them.
+TEST(CommandAllocator, BorrowedIterators) {
+    CommandAllocator allocator;
+
+    // Use big commands so that the commands span several blocks.
+    constexpr uint32_t kCommandCount = 5;
+    for (uint32_t i = 0; i < kCommandCount; ++i) {
+        CommandBig* big = allocator.Allocate<CommandBig>(CommandType::Big);
+        big->buffer[0] = i;
+    }
+
+    CommandIterator iterator(std::move(allocator));
+    {
+        CommandIterator borrowedA = iterator.Borrow();
+
+        // Start the second borrowed iterator at the third command, read by the first one.
+        CommandType type;
+        for (uint32_t i = 0; i < 2; ++i) {
+            ASSERT_TRUE(borrowedA.NextCommandId(&type));
+            borrowedA.NextCommand<CommandBig>();
+        }
+        CommandIterator borrowedB = iterator.Borrow();
+        borrowedB.SetPosition(borrowedA.GetPosition());
+        borrowedA.Reset();
+
+        for (uint32_t i = 0; i < kCommandCount; ++i) {
+            ASSERT_TRUE(borrowedA.NextCommandId(&type));
+            ASSERT_EQ(type, CommandType::Big);
+            ASSERT_EQ(borrowedA.NextCommand<CommandBig>()->buffer[0], i);
+        }
+        ASSERT_FALSE(borrowedA.NextCommandId(&type));
+
+        for (uint32_t i = 2; i < kCommandCount; ++i) {
+            ASSERT_TRUE(borrowedB.NextCommandId(&type));
+            ASSERT_EQ(borrowedB.NextCommand<CommandBig>()->buffer[0], i);
+        }
+        ASSERT_FALSE(borrowedB.NextCommandId(&type));
+    }
+
+    // The owning iterator wasn't moved by the borrowed ones and still owns the commands.
+    CommandType type;
+    ASSERT_TRUE(iterator.NextCommandId(&type));
+    ASSERT_EQ(iterator.NextCommand<CommandBig>()->buffer[0], 0u);
+    iterator.MakeEmptyAsDataWasDestroyed();
+}
+
+// Test that borrowing an empty iterator works.
+TEST(CommandAllocator, BorrowEmptyIterator) {
+    CommandIterator iterator;
+    CommandIterator borrowed = iterator.Borrow();
+
+    CommandType type;
+    ASSERT_FALSE(borrowed.NextCommandId(&type));
+}
+
+// Test that a moved borrowed iterator still reads the commands of the owning iterator.
+TEST(CommandAllocator, MoveBorrowedIterator) {
+    CommandAllocator allocator;
+    CommandBig* big = allocator.Allocate<CommandBig>(CommandType::Big);
+    big->buffer[0] = 42;
+
+    CommandIterator iterator(std::move(allocator));
+    {
+        CommandIterator borrowed;
+        borrowed = iterator.Borrow();
+        CommandIterator moved(std::move(borrowed));
+
+        CommandType type;
+        ASSERT_TRUE(moved.NextCommandId(&type));
+        ASSERT_EQ(moved.NextCommand<CommandBig>()->buffer[0], 42u);
+        ASSERT_FALSE(moved.NextCommandId(&type));
+
+        ASSERT_FALSE(borrowed.NextCommandId(&type));
+    }
+    iterator.MakeEmptyAsDataWasDestroyed();
+}
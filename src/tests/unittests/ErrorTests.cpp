@@ -17,6 +17,8 @@
 #include "dawn_native/Error.h"
 #include "dawn_native/ErrorData.h"
 
+#include <thread>
+
 using namespace dawn_native;
 
 namespace {
@@ -40,7 +42,7 @@ namespace {
         ASSERT_TRUE(result.IsError());
 
         std::unique_ptr<ErrorData> errorData = result.AcquireError();
-        ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+        ASSERT_STREQ(errorData->GetMessage(), dummyErrorMessage);
     }
 
     // Check returning a success ResultOrError with an implicit conversion
@@ -62,7 +64,7 @@ namespace {
         ASSERT_TRUE(result.IsError());
 
         std::unique_ptr<ErrorData> errorData = result.AcquireError();
-        ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+        ASSERT_STREQ(errorData->GetMessage(), dummyErrorMessage);
     }
 
     // Check DAWN_TRY handles successes correctly.
@@ -98,7 +100,7 @@ namespace {
         ASSERT_TRUE(result.IsError());
 
         std::unique_ptr<ErrorData> errorData = result.AcquireError();
-        ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+        ASSERT_STREQ(errorData->GetMessage(), dummyErrorMessage);
     }
 
     // Check DAWN_TRY adds to the backtrace.
@@ -169,7 +171,7 @@ namespace {
         ASSERT_TRUE(result.IsError());
 
         std::unique_ptr<ErrorData> errorData = result.AcquireError();
-        ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+        ASSERT_STREQ(errorData->GetMessage(), dummyErrorMessage);
     }
 
     // Check DAWN_TRY_ASSIGN adds to the backtrace.
@@ -218,7 +220,7 @@ namespace {
         ASSERT_TRUE(result.IsError());
 
         std::unique_ptr<ErrorData> errorData = result.AcquireError();
-        ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+        ASSERT_STREQ(errorData->GetMessage(), dummyErrorMessage);
     }
 
     // Check a ResultOrError can be DAWN_TRY_ASSIGNED in a function that returns an Error
@@ -240,7 +242,7 @@ namespace {
         ASSERT_TRUE(result.IsError());
 
         std::unique_ptr<ErrorData> errorData = result.AcquireError();
-        ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+        ASSERT_STREQ(errorData->GetMessage(), dummyErrorMessage);
     }
 
     // Check a MaybeError can be DAWN_TRIED in a function that returns an ResultOrError
@@ -257,7 +259,7 @@ namespace {
         ASSERT_TRUE(result.IsError());
 
         std::unique_ptr<ErrorData> errorData = result.AcquireError();
-        ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+        ASSERT_STREQ(errorData->GetMessage(), dummyErrorMessage);
     }
 
     // Check a MaybeError can be DAWN_TRIED in a function that returns an ResultOrError
@@ -274,7 +276,89 @@ namespace {
         ASSERT_TRUE(result.IsError());
 
         std::unique_ptr<ErrorData> errorData = result.AcquireError();
-        ASSERT_EQ(errorData->GetMessage(), dummyErrorMessage);
+        ASSERT_STREQ(errorData->GetMessage(), dummyErrorMessage);
+    }
+
+    // Check that string literal messages are referenced instead of copied.
+    TEST(ErrorTests, LiteralMessageIsNotCopied) {
+        auto MakeError = []() { return DAWN_VALIDATION_ERROR("I am a literal error message"); };
+        std::unique_ptr<ErrorData> first = MakeError();
+        std::unique_ptr<ErrorData> second = MakeError();
+        ASSERT_EQ(first->GetMessage(), second->GetMessage());
+        ASSERT_STREQ(first->GetMessage(), "I am a literal error message");
+    }
+
+    // Check that the messages that aren't a string literal are copied.
+    TEST(ErrorTests, NonLiteralMessageIsCopied) {
+        char message[] = "I am a mutable error message";
+        std::unique_ptr<ErrorData> errorData = DAWN_VALIDATION_ERROR(message);
+        message[0] = 'X';
+        ASSERT_STREQ(errorData->GetMessage(), "I am a mutable error message");
+
+        const char* pointerMessage = message;
+        std::unique_ptr<ErrorData> pointerData = DAWN_VALIDATION_ERROR(pointerMessage);
+        message[0] = 'I';
+        ASSERT_STREQ(pointerData->GetMessage(), "X am a mutable error message");
+
+        std::string suffix = "concatenated";
+        std::unique_ptr<ErrorData> concatenatedData =
+            DAWN_VALIDATION_ERROR("I am a message " + suffix);
+        suffix.clear();
+        ASSERT_STREQ(concatenatedData->GetMessage(), "I am a message concatenated");
+    }
+
+    // Check that backtraces longer than the inline storage are kept whole.
+    TEST(ErrorTests, LongBacktrace) {
+        std::unique_ptr<ErrorData> errorData = DAWN_VALIDATION_ERROR(dummyErrorMessage);
+        for (int line = 0; line < 3 * static_cast<int>(ErrorData::kInlineBacktraceSize); ++line) {
+            errorData->AppendBacktrace("file", "function", line);
+        }
+
+        const ErrorData::Backtrace& backtrace = errorData->GetBacktrace();
+        ASSERT_EQ(backtrace.size(), 3 * ErrorData::kInlineBacktraceSize + 1);
+        for (size_t i = 1; i < backtrace.size(); ++i) {
+            ASSERT_EQ(backtrace[i].line, static_cast<int>(i - 1));
+        }
+    }
+
+    // Check that the formatted message contains the message and every call site.
+    TEST(ErrorTests, FormattedMessage) {
+        auto ReturnError = []() -> MaybeError { return DAWN_VALIDATION_ERROR(dummyErrorMessage); };
+        auto Try = [ReturnError]() -> MaybeError {
+            DAWN_TRY(ReturnError());
+            return {};
+        };
+
+        MaybeError result = Try();
+        ASSERT_TRUE(result.IsError());
+
+        std::unique_ptr<ErrorData> errorData = result.AcquireError();
+        std::string formatted = errorData->GetFormattedMessage();
+        ASSERT_EQ(formatted.find(dummyErrorMessage), 0u);
+        for (const ErrorData::BacktraceRecord& record : errorData->GetBacktrace()) {
+            std::string callsite = std::string(record.file) + ":" + std::to_string(record.line);
+            ASSERT_NE(formatted.find(callsite), std::string::npos);
+        }
+    }
+
+    // Check that the memory of freed errors is reused for new errors.
+    TEST(ErrorTests, ErrorDataIsPooled) {
+        std::unique_ptr<ErrorData> first = DAWN_VALIDATION_ERROR(dummyErrorMessage);
+        ErrorData* firstAddress = first.get();
+        first = nullptr;
+
+        std::unique_ptr<ErrorData> second = DAWN_VALIDATION_ERROR(dummyErrorMessage);
+        ASSERT_EQ(firstAddress, second.get());
+    }
+
+    // Check that errors can be freed at thread exit after the pool of the thread is destroyed.
+    TEST(ErrorTests, ErrorFreedAfterThreadPoolDestruction) {
+        std::thread thread([]() {
+            // Constructed before the pool of the thread, so destroyed after it.
+            thread_local std::unique_ptr<ErrorData> tError;
+            tError = DAWN_VALIDATION_ERROR("I am freed at thread exit");
+        });
+        thread.join();
     }
 
 }  // anonymous namespace
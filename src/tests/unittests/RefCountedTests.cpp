@@ -108,6 +108,31 @@ TEST(RefCounted, RaceOnReferenceRelease) {
     EXPECT_TRUE(deleted);
 }
 
+// An RC whose deletion is deferred, like dawn_native objects with the defer_object_destruction
+// toggle.
+struct RCDeferredTest : public RCTest {
+    void DeleteThis() override {
+        deletionDeferred = true;
+    }
+
+    bool deletionDeferred = false;
+};
+
+// Test that TryReference adds a reference only while the RC has references.
+TEST(RefCounted, TryReference) {
+    auto* test = new RCDeferredTest();
+
+    EXPECT_TRUE(test->TryReference());
+    EXPECT_EQ(test->GetRefCountForTesting(), 2u);
+    test->Release();
+    test->Release();
+    EXPECT_TRUE(test->deletionDeferred);
+
+    EXPECT_FALSE(test->TryReference());
+    EXPECT_EQ(test->GetRefCountForTesting(), 0u);
+    delete test;
+}
+
 // Test Ref remove reference when going out of scope
 TEST(Ref, EndOfScopeRemovesRef) {
     bool deleted = false;
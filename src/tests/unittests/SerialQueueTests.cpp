@@ -17,6 +17,9 @@
 #include "common/SerialQueue.h"
 #include "common/TypedInteger.h"
 
+#include <memory>
+#include <string>
+
 using TestSerialQueue = SerialQueue<uint64_t, int>;
 
 // A number of basic tests for SerialQueue that are difficult to split from one another
@@ -173,3 +176,148 @@ TEST(SerialQueue, TypedInteger) {
     }
     ASSERT_TRUE(expectedValues.empty());
 }
+
+// Test that values are kept in order when the circular storage wraps around and grows
+TEST(SerialQueue, WrapAroundAndGrow) {
+    TestSerialQueue queue;
+
+    // Move the start of the queue away from the start of the storage.
+    for (int i = 0; i < 6; ++i) {
+        queue.Enqueue(i, i);
+    }
+    queue.ClearUpTo(4);
+    EXPECT_EQ(queue.FirstSerial(), 5u);
+
+    // Enqueue enough values to wrap around the end of the storage and then to grow it.
+    for (int i = 6; i < 40; ++i) {
+        queue.Enqueue(i, 5 + (i - 6) / 2);
+    }
+    EXPECT_EQ(queue.FirstSerial(), 5u);
+    EXPECT_EQ(queue.LastSerial(), 21u);
+
+    int expectedValue = 5;
+    for (int value : queue.IterateAll()) {
+        EXPECT_EQ(expectedValue, value);
+        expectedValue++;
+    }
+    EXPECT_EQ(expectedValue, 40);
+
+    expectedValue = 5;
+    for (int value : queue.IterateUpTo(10)) {
+        EXPECT_EQ(expectedValue, value);
+        expectedValue++;
+    }
+    EXPECT_EQ(expectedValue, 18);
+
+    queue.ClearUpTo(20);
+    std::vector<int> expectedValues = {38, 39};
+    for (int value : queue.IterateAll()) {
+        EXPECT_EQ(expectedValues.front(), value);
+        ASSERT_FALSE(expectedValues.empty());
+        expectedValues.erase(expectedValues.begin());
+    }
+    ASSERT_TRUE(expectedValues.empty());
+}
+
+// Test that a queue with a high rate of serials being enqueued and cleared keeps working
+TEST(SerialQueue, HighSerialRateChurn) {
+    TestSerialQueue queue;
+
+    uint64_t clearedSerial = 0;
+    for (uint64_t serial = 1; serial < 1000; ++serial) {
+        queue.Enqueue(static_cast<int>(serial), serial);
+        queue.Enqueue(static_cast<int>(serial), serial);
+
+        // Retire serials lagging three serials behind.
+        if (serial > 3) {
+            clearedSerial = serial - 3;
+            queue.ClearUpTo(clearedSerial);
+        }
+        EXPECT_EQ(queue.FirstSerial(), clearedSerial + 1);
+
+        uint64_t expectedValue = clearedSerial + 1;
+        unsigned int count = 0;
+        for (int value : queue.IterateAll()) {
+            EXPECT_EQ(static_cast<int>(expectedValue), value);
+            count++;
+            if (count % 2 == 0) {
+                expectedValue++;
+            }
+        }
+        EXPECT_EQ(count, 2 * (serial - clearedSerial));
+    }
+}
+
+// Test that move-only values can be stored and that they are destroyed when cleared
+TEST(SerialQueue, MoveOnlyValues) {
+    int liveValues = 0;
+    struct Counted {
+        explicit Counted(int* counter) : counter(counter) {
+            (*counter)++;
+        }
+        ~Counted() {
+            (*counter)--;
+        }
+        int* counter;
+    };
+
+    {
+        SerialQueue<uint64_t, std::unique_ptr<Counted>> queue;
+        for (uint64_t serial = 0; serial < 20; ++serial) {
+            queue.Enqueue(std::make_unique<Counted>(&liveValues), serial);
+        }
+        EXPECT_EQ(liveValues, 20);
+
+        queue.ClearUpTo(9);
+        EXPECT_EQ(liveValues, 10);
+
+        for (const std::unique_ptr<Counted>& value : queue.IterateAll()) {
+            EXPECT_EQ(value->counter, &liveValues);
+        }
+    }
+
+    // The remaining values are destroyed with the queue.
+    EXPECT_EQ(liveValues, 0);
+}
+
+// Test copying and moving queues
+TEST(SerialQueue, CopyAndMove) {
+    TestSerialQueue queue;
+    queue.Enqueue(1, 0);
+    queue.Enqueue(2, 1);
+
+    TestSerialQueue copy(queue);
+    queue.ClearUpTo(0);
+    EXPECT_EQ(copy.FirstSerial(), 0u);
+    EXPECT_EQ(queue.FirstSerial(), 1u);
+
+    TestSerialQueue moved(std::move(copy));
+    EXPECT_TRUE(copy.Empty());
+
+    std::vector<int> expectedValues = {1, 2};
+    for (int value : moved.IterateAll()) {
+        EXPECT_EQ(expectedValues.front(), value);
+        ASSERT_FALSE(expectedValues.empty());
+        expectedValues.erase(expectedValues.begin());
+    }
+    ASSERT_TRUE(expectedValues.empty());
+
+    moved = queue;
+    EXPECT_EQ(moved.FirstSerial(), 1u);
+    EXPECT_EQ(moved.LastSerial(), 1u);
+}
+
+// Test enqueuing one of the values of the queue, including when the queue grows
+TEST(SerialQueue, EnqueueOwnValue) {
+    SerialQueue<uint64_t, std::string> queue;
+    queue.Enqueue(std::string(100, 'a'), 0);
+
+    for (uint64_t serial = 1; serial < 20; ++serial) {
+        const std::string& first = *queue.IterateAll().begin();
+        queue.Enqueue(first, serial);
+    }
+
+    for (const std::string& value : queue.IterateAll()) {
+        EXPECT_EQ(value, std::string(100, 'a'));
+    }
+}
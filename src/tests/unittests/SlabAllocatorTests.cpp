@@ -178,3 +178,27 @@ TEST(SlabAllocatorTests, AllocateDeallocateMany) {
         allocator.Deallocate(object);
     }
 }
+
+// Test that the allocated bytes grow by a slab at a time and are kept when objects are freed.
+TEST(SlabAllocatorTests, GetAllocatedBytes) {
+    SlabAllocator<Foo> allocator(4 * sizeof(Foo));
+    EXPECT_EQ(allocator.GetAllocatedBytes(), 0u);
+
+    std::vector<Foo*> objects;
+    objects.push_back(allocator.Allocate(0));
+    size_t slabBytes = allocator.GetAllocatedBytes();
+    EXPECT_GT(slabBytes, 4 * sizeof(Foo));
+
+    for (int i = 1; i < 4; ++i) {
+        objects.push_back(allocator.Allocate(i));
+    }
+    EXPECT_EQ(allocator.GetAllocatedBytes(), slabBytes);
+
+    objects.push_back(allocator.Allocate(4));
+    EXPECT_EQ(allocator.GetAllocatedBytes(), 2 * slabBytes);
+
+    for (Foo* object : objects) {
+        allocator.Deallocate(object);
+    }
+    EXPECT_EQ(allocator.GetAllocatedBytes(), 2 * slabBytes);
+}
@@ -0,0 +1,167 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "dawn_platform/tracing/TraceEvent.h"
+#include "dawn_platform/tracing/TracingPlatform.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using dawn_platform::TraceCategory;
+using dawn_platform::tracing::TracingPlatform;
+
+namespace {
+
+    size_t CountOccurrences(const std::string& str, const std::string& pattern) {
+        size_t count = 0;
+        for (size_t pos = str.find(pattern); pos != std::string::npos;
+             pos = str.find(pattern, pos + pattern.size())) {
+            count++;
+        }
+        return count;
+    }
+
+    void RecordEvent(TracingPlatform* platform, const char* name) {
+        platform->AddTraceEvent(TRACE_EVENT_PHASE_INSTANT,
+                                platform->GetTraceCategoryEnabledFlag(TraceCategory::General),
+                                name, 0, platform->MonotonicallyIncreasingTime(), 0, nullptr,
+                                nullptr, nullptr, 0);
+    }
+
+    class TracingPlatformTests : public testing::Test {
+      protected:
+        void TearDown() override {
+            TracingPlatform::SetCategoryEnabled(TraceCategory::General, false);
+            TracingPlatform::SetCategoryEnabled(TraceCategory::Validation, false);
+        }
+    };
+
+}  // anonymous namespace
+
+// Test that scoped trace events are exported as begin and end events only when their category is
+// enabled.
+TEST_F(TracingPlatformTests, CategoryEnablement) {
+    TracingPlatform platform;
+    TracingPlatform::SetCategoryEnabled(TraceCategory::Validation, true);
+    EXPECT_TRUE(TracingPlatform::IsCategoryEnabled(TraceCategory::Validation));
+    EXPECT_FALSE(TracingPlatform::IsCategoryEnabled(TraceCategory::General));
+
+    {
+        TRACE_EVENT0(&platform, Validation, "EnabledEvent");
+        TRACE_EVENT0(&platform, General, "DisabledEvent");
+    }
+
+    std::string json = platform.ExportChromeTraceJSON();
+    EXPECT_EQ(2u, CountOccurrences(json, "\"name\":\"EnabledEvent\""));
+    EXPECT_EQ(1u, CountOccurrences(json, "\"ph\":\"B\""));
+    EXPECT_EQ(1u, CountOccurrences(json, "\"ph\":\"E\""));
+    EXPECT_EQ(2u, CountOccurrences(json, "\"cat\":\"Validation\""));
+    EXPECT_EQ(0u, CountOccurrences(json, "DisabledEvent"));
+}
+
+// Test that each export only contains the events recorded since the previous one.
+TEST_F(TracingPlatformTests, ExportDrainsEvents) {
+    TracingPlatform platform;
+    RecordEvent(&platform, "First");
+
+    std::string json = platform.ExportChromeTraceJSON();
+    EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+    EXPECT_EQ(1u, CountOccurrences(json, "\"name\":\"First\""));
+
+    RecordEvent(&platform, "Second");
+    json = platform.ExportChromeTraceJSON();
+    EXPECT_EQ(0u, CountOccurrences(json, "\"name\":\"First\""));
+    EXPECT_EQ(1u, CountOccurrences(json, "\"name\":\"Second\""));
+
+    json = platform.ExportChromeTraceJSON();
+    EXPECT_EQ(0u, CountOccurrences(json, "\"name\""));
+}
+
+// Test that the oldest events are overwritten and counted as dropped when a thread records more
+// events than its buffer can hold.
+TEST_F(TracingPlatformTests, RingBufferOverwritesOldestEvents) {
+    TracingPlatform platform(4);
+    for (uint32_t i = 0; i < 6; ++i) {
+        RecordEvent(&platform, i < 2 ? "Old" : "New");
+    }
+
+    std::string json = platform.ExportChromeTraceJSON();
+    EXPECT_EQ(0u, CountOccurrences(json, "\"name\":\"Old\""));
+    EXPECT_EQ(4u, CountOccurrences(json, "\"name\":\"New\""));
+    EXPECT_EQ(2u, platform.GetDroppedEventCount());
+}
+
+// Test that names with characters that must be escaped produce valid JSON strings.
+TEST_F(TracingPlatformTests, NamesAreEscaped) {
+    TracingPlatform platform;
+    RecordEvent(&platform, "Quote\"Backslash\\Tab\t");
+
+    std::string json = platform.ExportChromeTraceJSON();
+    EXPECT_EQ(1u,
+              CountOccurrences(json, "\"name\":\"Quote\\\"Backslash\\\\Tab\\u0009\""));
+}
+
+// Test that events are recorded from several threads, each with its own thread ID.
+TEST_F(TracingPlatformTests, MultipleThreads) {
+    constexpr uint32_t kThreadCount = 4;
+    constexpr uint32_t kEventsPerThread = 100;
+
+    TracingPlatform platform;
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < kThreadCount; ++i) {
+        threads.emplace_back([&platform]() {
+            for (uint32_t j = 0; j < kEventsPerThread; ++j) {
+                RecordEvent(&platform, "ThreadEvent");
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::string json = platform.ExportChromeTraceJSON();
+    EXPECT_EQ(kThreadCount * kEventsPerThread, CountOccurrences(json, "\"name\":\"ThreadEvent\""));
+    for (uint32_t i = 0; i < kThreadCount; ++i) {
+        std::string tid = "\"tid\":" + std::to_string(i) + "}";
+        EXPECT_EQ(kEventsPerThread, CountOccurrences(json, tid));
+    }
+    EXPECT_EQ(0u, platform.GetDroppedEventCount());
+}
+
+// Test that exporting while another thread overwrites its events either exports or drops each
+// event, without reading events that are being written.
+TEST_F(TracingPlatformTests, ExportWhileRecording) {
+    constexpr uint32_t kEventCount = 100000;
+
+    TracingPlatform platform(16);
+    std::thread recorder([&platform]() {
+        for (uint32_t i = 0; i < kEventCount; ++i) {
+            RecordEvent(&platform, "RecordedEvent");
+        }
+    });
+
+    size_t exportedCount = 0;
+    for (uint32_t i = 0; i < 100; ++i) {
+        exportedCount +=
+            CountOccurrences(platform.ExportChromeTraceJSON(), "\"name\":\"RecordedEvent\"");
+    }
+    recorder.join();
+    exportedCount +=
+        CountOccurrences(platform.ExportChromeTraceJSON(), "\"name\":\"RecordedEvent\"");
+
+    EXPECT_EQ(kEventCount, exportedCount + platform.GetDroppedEventCount());
+}
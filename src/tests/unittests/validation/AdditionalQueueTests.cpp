@@ -0,0 +1,225 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "dawn_native/DawnNative.h"
+#include "dawn_native/NullBackend.h"
+
+namespace {
+
+    constexpr uint64_t kBufferSize = 4;
+
+    class AdditionalQueueTest : public ValidationTest {
+      protected:
+        wgpu::Queue CreateQueue(const wgpu::Device& device, dawn_native::QueueType type) {
+            return wgpu::Queue::Acquire(dawn_native::CreateAdditionalQueue(device.Get(), type));
+        }
+
+        wgpu::CommandBuffer EncodeComputePass() {
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+            pass.EndPass();
+            return encoder.Finish();
+        }
+
+        wgpu::CommandBuffer EncodeRenderPass() {
+            DummyRenderPass renderPass(device);
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+            pass.EndPass();
+            return encoder.Finish();
+        }
+
+        wgpu::CommandBuffer EncodeCopy() {
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = kBufferSize;
+            descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+            wgpu::Buffer source = device.CreateBuffer(&descriptor);
+            wgpu::Buffer destination = device.CreateBuffer(&descriptor);
+
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            encoder.CopyBufferToBuffer(source, 0, destination, 0, kBufferSize);
+            return encoder.Finish();
+        }
+    };
+
+}  // anonymous namespace
+
+// Test that general queues accept all the passes.
+TEST_F(AdditionalQueueTest, GeneralQueueAcceptsPasses) {
+    wgpu::Queue general = CreateQueue(device, dawn_native::QueueType::General);
+
+    wgpu::CommandBuffer commands[] = {EncodeRenderPass(), EncodeComputePass(), EncodeCopy()};
+    general.Submit(3, commands);
+}
+
+// Test that compute queues accept compute passes and copies but not render passes.
+TEST_F(AdditionalQueueTest, ComputeQueueRejectsRenderPasses) {
+    wgpu::Queue compute = CreateQueue(device, dawn_native::QueueType::Compute);
+
+    wgpu::CommandBuffer commands[] = {EncodeComputePass(), EncodeCopy()};
+    compute.Submit(2, commands);
+
+    wgpu::CommandBuffer renderPass = EncodeRenderPass();
+    ASSERT_DEVICE_ERROR(compute.Submit(1, &renderPass));
+}
+
+// Test that copy queues accept copies and writes but not passes.
+TEST_F(AdditionalQueueTest, CopyQueueRejectsPasses) {
+    wgpu::Queue copy = CreateQueue(device, dawn_native::QueueType::Copy);
+
+    wgpu::CommandBuffer copyCommands = EncodeCopy();
+    copy.Submit(1, &copyCommands);
+
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = kBufferSize;
+    descriptor.usage = wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+    uint32_t value = 0;
+    copy.WriteBuffer(buffer, 0, &value, sizeof(value));
+
+    wgpu::CommandBuffer computePass = EncodeComputePass();
+    ASSERT_DEVICE_ERROR(copy.Submit(1, &computePass));
+    wgpu::CommandBuffer renderPass = EncodeRenderPass();
+    ASSERT_DEVICE_ERROR(copy.Submit(1, &renderPass));
+}
+
+// Test that fences signaled on an additional queue complete.
+TEST_F(AdditionalQueueTest, FenceCompletes) {
+    wgpu::Queue compute = CreateQueue(device, dawn_native::QueueType::Compute);
+    wgpu::Fence fence = compute.CreateFence();
+
+    wgpu::CommandBuffer commands = EncodeComputePass();
+    compute.Submit(1, &commands);
+    compute.Signal(fence, 1);
+
+    while (fence.GetCompletedValue() < 1) {
+        device.Tick();
+    }
+}
+
+// Test that a fence signaled on a queue doesn't wait for the work of the other queues.
+TEST_F(AdditionalQueueTest, FenceDoesntWaitForOtherQueues) {
+    dawn_native::DeviceDescriptor descriptor;
+    descriptor.forceEnabledToggles.push_back("null_use_async_timeline");
+    wgpu::Device asyncDevice = wgpu::Device::Acquire(adapter.CreateDevice(&descriptor));
+
+    // The options apply to the work submitted after they are set so only the work of the slow
+    // queue has latency. The latency is short enough to not slow down the destruction of the
+    // device too much.
+    wgpu::Queue fast = CreateQueue(asyncDevice, dawn_native::QueueType::Compute);
+    wgpu::Queue slow = CreateQueue(asyncDevice, dawn_native::QueueType::Copy);
+
+    dawn_native::null::AsyncTimelineOptions options;
+    options.latencyMicroseconds = 1000 * 1000;
+    dawn_native::null::SetAsyncTimelineOptions(asyncDevice.Get(), options);
+
+    wgpu::BufferDescriptor bufferDescriptor;
+    bufferDescriptor.size = kBufferSize;
+    bufferDescriptor.usage = wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = asyncDevice.CreateBuffer(&bufferDescriptor);
+    uint32_t value = 0;
+    slow.WriteBuffer(buffer, 0, &value, sizeof(value));
+    slow.Submit(0, nullptr);
+
+    dawn_native::null::SetAsyncTimelineOptions(asyncDevice.Get(), {});
+
+    wgpu::Fence fence = fast.CreateFence();
+    fast.Submit(0, nullptr);
+    fast.Signal(fence, 1);
+
+    while (fence.GetCompletedValue() < 1) {
+        asyncDevice.Tick();
+    }
+    // The work of the slow queue is still in flight.
+    EXPECT_TRUE(dawn_native::DeviceTick(asyncDevice.Get()));
+}
+
+
+// Test that a buffer can't be used on a queue while the commands of another queue that use it are
+// still in flight.
+TEST_F(AdditionalQueueTest, BufferInUseOnAnotherQueue) {
+    dawn_native::DeviceDescriptor descriptor;
+    descriptor.forceEnabledToggles.push_back("null_use_async_timeline");
+    wgpu::Device asyncDevice = wgpu::Device::Acquire(adapter.CreateDevice(&descriptor));
+
+    wgpu::Queue slow = CreateQueue(asyncDevice, dawn_native::QueueType::Copy);
+    wgpu::Queue other = CreateQueue(asyncDevice, dawn_native::QueueType::General);
+
+    wgpu::BufferDescriptor bufferDescriptor;
+    bufferDescriptor.size = kBufferSize;
+    bufferDescriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = asyncDevice.CreateBuffer(&bufferDescriptor);
+
+    auto EncodeCopyToBuffer = [&]() {
+        wgpu::Buffer source = asyncDevice.CreateBuffer(&bufferDescriptor);
+        wgpu::CommandEncoder encoder = asyncDevice.CreateCommandEncoder();
+        encoder.CopyBufferToBuffer(source, 0, buffer, 0, kBufferSize);
+        return encoder.Finish();
+    };
+
+    // Submits on |queue| in an error scope and returns the type of the error it produced.
+    auto SubmitAndGetErrorType = [&](const wgpu::Queue& queue) {
+        wgpu::CommandBuffer commands = EncodeCopyToBuffer();
+        asyncDevice.PushErrorScope(wgpu::ErrorFilter::Validation);
+        queue.Submit(1, &commands);
+
+        // The scope of a successful submit is only popped once the submit completes.
+        WGPUErrorType errorType = WGPUErrorType_Force32;
+        asyncDevice.PopErrorScope(
+            [](WGPUErrorType type, const char*, void* userdata) {
+                *static_cast<WGPUErrorType*>(userdata) = type;
+            },
+            &errorType);
+        while (errorType == WGPUErrorType_Force32) {
+            asyncDevice.Tick();
+        }
+        return errorType;
+    };
+
+    // The latency is short enough to not slow down the test too much, but long enough for the
+    // work of the slow queue to be in flight during the submits of the other queue.
+    dawn_native::null::AsyncTimelineOptions options;
+    options.latencyMicroseconds = 100 * 1000;
+    dawn_native::null::SetAsyncTimelineOptions(asyncDevice.Get(), options);
+
+    wgpu::CommandBuffer slowCommands = EncodeCopyToBuffer();
+    slow.Submit(1, &slowCommands);
+
+    dawn_native::null::SetAsyncTimelineOptions(asyncDevice.Get(), {});
+
+    // The buffer can't be used on another queue, with a submit or a write, while the commands of
+    // the slow queue use it.
+    EXPECT_EQ(SubmitAndGetErrorType(other), WGPUErrorType_Validation);
+    uint32_t value = 0;
+    asyncDevice.PushErrorScope(wgpu::ErrorFilter::Validation);
+    other.WriteBuffer(buffer, 0, &value, sizeof(value));
+    WGPUErrorType writeErrorType = WGPUErrorType_NoError;
+    asyncDevice.PopErrorScope(
+        [](WGPUErrorType type, const char*, void* userdata) {
+            *static_cast<WGPUErrorType*>(userdata) = type;
+        },
+        &writeErrorType);
+    EXPECT_EQ(writeErrorType, WGPUErrorType_Validation);
+
+    wgpu::Fence fence = slow.CreateFence();
+    slow.Signal(fence, 1);
+    while (fence.GetCompletedValue() < 1) {
+        asyncDevice.Tick();
+    }
+
+    // The buffer can be used on the other queue once the commands of the slow queue complete.
+    EXPECT_EQ(SubmitAndGetErrorType(other), WGPUErrorType_NoError);
+}
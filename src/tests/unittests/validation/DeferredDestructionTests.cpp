@@ -0,0 +1,236 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "utils/WGPUHelpers.h"
+
+#include <thread>
+#include <vector>
+
+class DeferredDestructionTest : public ValidationTest {
+  protected:
+    void SetUp() override {
+        ValidationTest::SetUp();
+
+        dawn_native::DeviceDescriptor descriptor;
+        descriptor.forceEnabledToggles.push_back("defer_object_destruction");
+        mDeferringDevice = wgpu::Device::Acquire(adapter.CreateDevice(&descriptor));
+    }
+
+    void TearDown() override {
+        mDeferringDevice = nullptr;
+        ValidationTest::TearDown();
+    }
+
+    dawn_native::DeviceCounters GetCounters() {
+        return dawn_native::GetDeviceCounters(mDeferringDevice.Get());
+    }
+
+    wgpu::Buffer CreateUniformBuffer() {
+        wgpu::BufferDescriptor descriptor;
+        descriptor.size = 16;
+        descriptor.usage = wgpu::BufferUsage::Uniform;
+        return mDeferringDevice.CreateBuffer(&descriptor);
+    }
+
+    wgpu::Device mDeferringDevice;
+};
+
+// Test that released objects are only destroyed by the next Tick.
+TEST_F(DeferredDestructionTest, DestroyedOnTick) {
+    dawn_native::DeviceCounters before = GetCounters();
+
+    wgpu::Buffer buffer = CreateUniformBuffer();
+    EXPECT_EQ(before.liveBuffers + 1, GetCounters().liveBuffers);
+
+    buffer = nullptr;
+    EXPECT_EQ(before.liveBuffers + 1, GetCounters().liveBuffers);
+
+    mDeferringDevice.Tick();
+    EXPECT_EQ(before.liveBuffers, GetCounters().liveBuffers);
+}
+
+// Test that cached objects are deferred like the other objects.
+TEST_F(DeferredDestructionTest, CachedObjectsAreDeferred) {
+    dawn_native::DeviceCounters before = GetCounters();
+
+    wgpu::BindGroupLayout layout = utils::MakeBindGroupLayout(
+        mDeferringDevice, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::UniformBuffer}});
+    EXPECT_EQ(before.liveBindGroupLayouts + 1, GetCounters().liveBindGroupLayouts);
+
+    layout = nullptr;
+    EXPECT_EQ(before.liveBindGroupLayouts + 1, GetCounters().liveBindGroupLayouts);
+
+    mDeferringDevice.Tick();
+    EXPECT_EQ(before.liveBindGroupLayouts, GetCounters().liveBindGroupLayouts);
+}
+
+// Test that the cache doesn't return an object waiting for its deferred deletion, and that
+// deleting it doesn't remove the object that replaced it from the cache.
+TEST_F(DeferredDestructionTest, CachedObjectReplacedWhileDeferred) {
+    dawn_native::DeviceCounters before = GetCounters();
+
+    wgpu::SamplerDescriptor descriptor = {};
+    wgpu::Sampler sampler = mDeferringDevice.CreateSampler(&descriptor);
+    sampler = nullptr;
+
+    sampler = mDeferringDevice.CreateSampler(&descriptor);
+    EXPECT_EQ(before.liveSamplers + 2, GetCounters().liveSamplers);
+
+    mDeferringDevice.Tick();
+    EXPECT_EQ(before.liveSamplers + 1, GetCounters().liveSamplers);
+
+    // The replacement is still cached.
+    wgpu::Sampler sameSampler = mDeferringDevice.CreateSampler(&descriptor);
+    EXPECT_EQ(sampler.Get(), sameSampler.Get());
+    EXPECT_EQ(before.liveSamplers + 1, GetCounters().liveSamplers);
+
+    sampler = nullptr;
+    sameSampler = nullptr;
+    mDeferringDevice.Tick();
+    EXPECT_EQ(before.liveSamplers, GetCounters().liveSamplers);
+}
+
+// Test that objects released while deleting deferred objects are destroyed by the same Tick.
+TEST_F(DeferredDestructionTest, ChainedReleases) {
+    dawn_native::DeviceCounters before = GetCounters();
+
+    wgpu::BindGroupLayout layout = utils::MakeBindGroupLayout(
+        mDeferringDevice, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::UniformBuffer}});
+    wgpu::Buffer buffer = CreateUniformBuffer();
+    wgpu::BindGroup bindGroup =
+        utils::MakeBindGroup(mDeferringDevice, layout, {{0, buffer, 0, 16}});
+
+    // The bind group holds the last references to the layout and the buffer.
+    layout = nullptr;
+    buffer = nullptr;
+    bindGroup = nullptr;
+    EXPECT_EQ(before.liveBindGroups + 1, GetCounters().liveBindGroups);
+
+    mDeferringDevice.Tick();
+    dawn_native::DeviceCounters after = GetCounters();
+    EXPECT_EQ(before.liveBindGroups, after.liveBindGroups);
+    EXPECT_EQ(before.liveBindGroupLayouts, after.liveBindGroupLayouts);
+    EXPECT_EQ(before.liveBuffers, after.liveBuffers);
+}
+
+// Test that objects can be released from several threads at the same time.
+TEST_F(DeferredDestructionTest, ReleaseFromThreads) {
+    constexpr uint32_t kThreadCount = 4;
+    constexpr uint32_t kBuffersPerThread = 64;
+
+    dawn_native::DeviceCounters before = GetCounters();
+
+    std::vector<std::vector<wgpu::Buffer>> buffers(kThreadCount);
+    for (std::vector<wgpu::Buffer>& threadBuffers : buffers) {
+        for (uint32_t i = 0; i < kBuffersPerThread; ++i) {
+            threadBuffers.push_back(CreateUniformBuffer());
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (std::vector<wgpu::Buffer>& threadBuffers : buffers) {
+        threads.emplace_back([&threadBuffers]() { threadBuffers.clear(); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(before.liveBuffers + kThreadCount * kBuffersPerThread, GetCounters().liveBuffers);
+
+    mDeferringDevice.Tick();
+    EXPECT_EQ(before.liveBuffers, GetCounters().liveBuffers);
+}
+
+// Test that cached objects can be released from other threads while the device's thread looks
+// them up in the caches.
+TEST_F(DeferredDestructionTest, ReleaseCachedObjectsFromThreads) {
+    constexpr uint32_t kThreadCount = 4;
+    constexpr uint32_t kObjectsPerThread = 32;
+    constexpr uint32_t kObjectCount = kThreadCount * kObjectsPerThread;
+
+    dawn_native::DeviceCounters before = GetCounters();
+
+    // Each object of a thread has a different descriptor.
+    auto CreateLayout = [this](uint32_t i) {
+        return utils::MakeBindGroupLayout(
+            mDeferringDevice, {{i, wgpu::ShaderStage::Compute, wgpu::BindingType::UniformBuffer}});
+    };
+    auto CreateSampler = [this](uint32_t i) {
+        wgpu::SamplerDescriptor descriptor = {};
+        descriptor.lodMaxClamp = static_cast<float>(i);
+        return mDeferringDevice.CreateSampler(&descriptor);
+    };
+
+    std::vector<std::vector<wgpu::BindGroupLayout>> layouts(kThreadCount);
+    std::vector<std::vector<wgpu::Sampler>> samplers(kThreadCount);
+    for (uint32_t t = 0; t < kThreadCount; ++t) {
+        for (uint32_t i = 0; i < kObjectsPerThread; ++i) {
+            layouts[t].push_back(CreateLayout(t * kObjectsPerThread + i));
+            samplers[t].push_back(CreateSampler(t * kObjectsPerThread + i));
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < kThreadCount; ++t) {
+        threads.emplace_back([&layouts, &samplers, t]() {
+            layouts[t].clear();
+            samplers[t].clear();
+        });
+    }
+
+    // Look up the same objects while they are released. Each lookup either gets the object
+    // released by the other thread or creates a new one.
+    std::vector<wgpu::BindGroupLayout> keptLayouts;
+    std::vector<wgpu::Sampler> keptSamplers;
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+        keptLayouts.push_back(CreateLayout(i));
+        keptSamplers.push_back(CreateSampler(i));
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Only the objects kept by this thread are left, once per descriptor.
+    mDeferringDevice.Tick();
+    EXPECT_EQ(before.liveBindGroupLayouts + kObjectCount, GetCounters().liveBindGroupLayouts);
+    EXPECT_EQ(before.liveSamplers + kObjectCount, GetCounters().liveSamplers);
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+        EXPECT_EQ(keptLayouts[i].Get(), CreateLayout(i).Get());
+        EXPECT_EQ(keptSamplers[i].Get(), CreateSampler(i).Get());
+    }
+
+    keptLayouts.clear();
+    keptSamplers.clear();
+    mDeferringDevice.Tick();
+    EXPECT_EQ(before.liveBindGroupLayouts, GetCounters().liveBindGroupLayouts);
+    EXPECT_EQ(before.liveSamplers, GetCounters().liveSamplers);
+}
+
+// Test that objects that are still queued are destroyed when the device is.
+TEST_F(DeferredDestructionTest, DestroyedWithDevice) {
+    wgpu::BindGroupLayout layout = utils::MakeBindGroupLayout(
+        mDeferringDevice, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::UniformBuffer}});
+    wgpu::Buffer buffer = CreateUniformBuffer();
+    wgpu::BindGroup bindGroup =
+        utils::MakeBindGroup(mDeferringDevice, layout, {{0, buffer, 0, 16}});
+
+    layout = nullptr;
+    buffer = nullptr;
+    bindGroup = nullptr;
+
+    // The cache of the device asserts it is empty when destroyed.
+    mDeferringDevice = nullptr;
+}
@@ -0,0 +1,124 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "utils/WGPUHelpers.h"
+
+class DeviceCountersTest : public ValidationTest {
+  protected:
+    dawn_native::DeviceCounters GetCounters() {
+        return dawn_native::GetDeviceCounters(device.Get());
+    }
+};
+
+// Test that the encoded commands are counted per category when the encoder is finished.
+TEST_F(DeviceCountersTest, EncodedCommands) {
+    wgpu::Buffer source = utils::CreateBufferFromData<uint32_t>(device, wgpu::BufferUsage::CopySrc,
+                                                                {0, 1, 2, 3});
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 16;
+    descriptor.usage = wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer destination = device.CreateBuffer(&descriptor);
+
+    dawn_native::DeviceCounters before = GetCounters();
+
+    DummyRenderPass renderPass(device);
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(source, 0, destination, 0, 16);
+    encoder.CopyBufferToBuffer(source, 0, destination, 0, 4);
+    encoder.BeginRenderPass(&renderPass).EndPass();
+
+    // Nothing is counted until the encoder is finished.
+    EXPECT_EQ(before.copiesEncoded, GetCounters().copiesEncoded);
+
+    wgpu::CommandBuffer commands = encoder.Finish();
+    dawn_native::DeviceCounters after = GetCounters();
+    EXPECT_EQ(before.copiesEncoded + 2, after.copiesEncoded);
+    EXPECT_EQ(before.renderPassesEncoded + 1, after.renderPassesEncoded);
+    EXPECT_EQ(before.computePassesEncoded, after.computePassesEncoded);
+    EXPECT_EQ(before.drawsEncoded, after.drawsEncoded);
+
+    device.GetDefaultQueue().Submit(1, &commands);
+    EXPECT_EQ(before.queueSubmits + 1, GetCounters().queueSubmits);
+}
+
+// Test that cache lookups are counted as hits and misses.
+TEST_F(DeviceCountersTest, CacheHitsAndMisses) {
+    dawn_native::DeviceCounters before = GetCounters();
+
+    wgpu::BindGroupLayout layout1 = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::UniformBuffer}});
+    wgpu::BindGroupLayout layout2 = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::UniformBuffer}});
+    ASSERT_EQ(layout1.Get(), layout2.Get());
+
+    dawn_native::DeviceCounters after = GetCounters();
+    EXPECT_EQ(before.bindGroupLayoutCache.misses + 1, after.bindGroupLayoutCache.misses);
+    EXPECT_EQ(before.bindGroupLayoutCache.hits + 1, after.bindGroupLayoutCache.hits);
+    EXPECT_EQ(before.liveBindGroupLayouts + 1, after.liveBindGroupLayouts);
+
+    layout1 = nullptr;
+    layout2 = nullptr;
+    EXPECT_EQ(before.liveBindGroupLayouts, GetCounters().liveBindGroupLayouts);
+}
+
+// Test that buffers and textures are counted while they are alive, but not error objects.
+TEST_F(DeviceCountersTest, LiveObjects) {
+    dawn_native::DeviceCounters before = GetCounters();
+
+    wgpu::BufferDescriptor bufferDescriptor;
+    bufferDescriptor.size = 4;
+    bufferDescriptor.usage = wgpu::BufferUsage::Uniform;
+    wgpu::Buffer buffer = device.CreateBuffer(&bufferDescriptor);
+
+    wgpu::TextureDescriptor textureDescriptor;
+    textureDescriptor.size = {1, 1, 1};
+    textureDescriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+    textureDescriptor.usage = wgpu::TextureUsage::Sampled;
+    wgpu::Texture texture = device.CreateTexture(&textureDescriptor);
+
+    textureDescriptor.mipLevelCount = 0;
+    ASSERT_DEVICE_ERROR(device.CreateTexture(&textureDescriptor));
+
+    dawn_native::DeviceCounters after = GetCounters();
+    EXPECT_EQ(before.liveBuffers + 1, after.liveBuffers);
+    EXPECT_EQ(before.liveTextures + 1, after.liveTextures);
+
+    buffer = nullptr;
+    texture = nullptr;
+    after = GetCounters();
+    EXPECT_EQ(before.liveBuffers, after.liveBuffers);
+    EXPECT_EQ(before.liveTextures, after.liveTextures);
+}
+
+// Test that data written to textures through the queue is counted as uploaded. The uploaded size
+// includes the row padding required by the backend.
+TEST_F(DeviceCountersTest, BytesUploaded) {
+    wgpu::TextureDescriptor descriptor;
+    descriptor.size = {2, 2, 1};
+    descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+    descriptor.usage = wgpu::TextureUsage::CopyDst;
+    wgpu::Texture texture = device.CreateTexture(&descriptor);
+
+    dawn_native::DeviceCounters before = GetCounters();
+
+    uint32_t data[4] = {};
+    wgpu::TextureDataLayout dataLayout = utils::CreateTextureDataLayout(0, 2 * sizeof(uint32_t), 2);
+    wgpu::TextureCopyView copyView = utils::CreateTextureCopyView(texture, 0, {0, 0, 0});
+    wgpu::Extent3D copySize = {2, 2, 1};
+    device.GetDefaultQueue().WriteTexture(&copyView, data, sizeof(data), &dataLayout, &copySize);
+
+    EXPECT_GE(GetCounters().bytesUploaded, before.bytesUploaded + sizeof(data));
+}
@@ -0,0 +1,122 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "utils/WGPUHelpers.h"
+
+class DeviceMemoryUsageTest : public ValidationTest {
+  protected:
+    dawn_native::DeviceMemoryUsage GetMemoryUsage() {
+        return dawn_native::GetDeviceMemoryUsage(device.Get());
+    }
+};
+
+// Test that the size of buffers is counted until they are destroyed or released.
+TEST_F(DeviceMemoryUsageTest, Buffers) {
+    dawn_native::DeviceMemoryUsage before = GetMemoryUsage();
+
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 256;
+    descriptor.usage = wgpu::BufferUsage::Uniform;
+    wgpu::Buffer buffer1 = device.CreateBuffer(&descriptor);
+    wgpu::Buffer buffer2 = device.CreateBuffer(&descriptor);
+    EXPECT_EQ(before.bufferBytes + 512, GetMemoryUsage().bufferBytes);
+
+    // Destroying a buffer twice, then releasing it, only frees its memory once.
+    buffer1.Destroy();
+    buffer1.Destroy();
+    EXPECT_EQ(before.bufferBytes + 256, GetMemoryUsage().bufferBytes);
+    buffer1 = nullptr;
+    EXPECT_EQ(before.bufferBytes + 256, GetMemoryUsage().bufferBytes);
+
+    buffer2 = nullptr;
+    EXPECT_EQ(before.bufferBytes, GetMemoryUsage().bufferBytes);
+
+    // Error buffers aren't counted.
+    descriptor.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::Uniform;
+    ASSERT_DEVICE_ERROR(device.CreateBuffer(&descriptor));
+    EXPECT_EQ(before.bufferBytes, GetMemoryUsage().bufferBytes);
+}
+
+// Test that the estimated size of textures includes all the mip levels and array layers.
+TEST_F(DeviceMemoryUsageTest, Textures) {
+    dawn_native::DeviceMemoryUsage before = GetMemoryUsage();
+
+    wgpu::TextureDescriptor descriptor;
+    descriptor.size = {4, 4, 2};
+    descriptor.mipLevelCount = 2;
+    descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+    descriptor.usage = wgpu::TextureUsage::Sampled;
+    wgpu::Texture texture = device.CreateTexture(&descriptor);
+
+    // (4x4 + 2x2) texels of 4 bytes for each of the 2 layers.
+    EXPECT_EQ(before.textureBytes + 160, GetMemoryUsage().textureBytes);
+
+    texture.Destroy();
+    EXPECT_EQ(before.textureBytes, GetMemoryUsage().textureBytes);
+    texture = nullptr;
+    EXPECT_EQ(before.textureBytes, GetMemoryUsage().textureBytes);
+}
+
+// Test that the commands are counted while the command buffer is alive.
+TEST_F(DeviceMemoryUsageTest, Commands) {
+    wgpu::Buffer source = utils::CreateBufferFromData<uint32_t>(device, wgpu::BufferUsage::CopySrc,
+                                                                {0, 1, 2, 3});
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = 16;
+    descriptor.usage = wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer destination = device.CreateBuffer(&descriptor);
+
+    dawn_native::DeviceMemoryUsage before = GetMemoryUsage();
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(source, 0, destination, 0, 16);
+    wgpu::CommandBuffer commands = encoder.Finish();
+    EXPECT_GT(GetMemoryUsage().commandBytes, before.commandBytes);
+
+    device.GetDefaultQueue().Submit(1, &commands);
+    commands = nullptr;
+    encoder = nullptr;
+    EXPECT_EQ(before.commandBytes, GetMemoryUsage().commandBytes);
+}
+
+// Test that the code of shader modules and the staging memory of uploads are counted.
+TEST_F(DeviceMemoryUsageTest, ShaderModulesAndUploads) {
+    dawn_native::DeviceMemoryUsage before = GetMemoryUsage();
+
+    wgpu::ShaderModule module =
+        utils::CreateShaderModule(device, utils::SingleShaderStage::Compute, R"(
+        #version 450
+        void main() {
+        })");
+    EXPECT_GT(GetMemoryUsage().shaderModuleBytes, before.shaderModuleBytes);
+
+    wgpu::TextureDescriptor descriptor;
+    descriptor.size = {2, 2, 1};
+    descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+    descriptor.usage = wgpu::TextureUsage::CopyDst;
+    wgpu::Texture texture = device.CreateTexture(&descriptor);
+
+    uint32_t data[4] = {};
+    wgpu::TextureDataLayout dataLayout = utils::CreateTextureDataLayout(0, 2 * sizeof(uint32_t), 2);
+    wgpu::TextureCopyView copyView = utils::CreateTextureCopyView(texture, 0, {0, 0, 0});
+    wgpu::Extent3D copySize = {2, 2, 1};
+    device.GetDefaultQueue().WriteTexture(&copyView, data, sizeof(data), &dataLayout, &copySize);
+
+    dawn_native::DeviceMemoryUsage after = GetMemoryUsage();
+    EXPECT_GE(after.uploadBytes, sizeof(data));
+    EXPECT_GE(after.uploadUsedBytes, sizeof(data));
+    EXPECT_LE(after.uploadUsedBytes, after.uploadBytes);
+}
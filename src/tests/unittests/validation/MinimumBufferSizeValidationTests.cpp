@@ -475,6 +475,69 @@ TEST_F(MinBufferSizeDrawTimeValidationTests, MultipleGroups) {
     });
 }
 
+// Draw time validation is redone when switching between pipelines that share a layout but have
+// different minimum buffer sizes.
+TEST_F(MinBufferSizeDrawTimeValidationTests, PipelinesSharingLayout) {
+    std::vector<BindingDescriptor> smallBindings = {{0, 0, "float a", 4}};
+    std::vector<BindingDescriptor> largeBindings = {{0, 0, "float a; float b", 8}};
+
+    std::string vertexShader = CreateVertexShaderWithBindings("std140", {});
+    wgpu::BindGroupLayout layout = CreateBindGroupLayout(smallBindings, {0});
+
+    wgpu::RenderPipeline smallPipeline = CreateRenderPipeline(
+        {layout}, vertexShader, CreateFragmentShaderWithBindings("std140", smallBindings));
+    wgpu::RenderPipeline largePipeline = CreateRenderPipeline(
+        {layout}, vertexShader, CreateFragmentShaderWithBindings("std140", largeBindings));
+
+    wgpu::BindGroup smallBindGroup = CreateBindGroup(layout, smallBindings, {4});
+    wgpu::BindGroup largeBindGroup = CreateBindGroup(layout, largeBindings, {8});
+
+    DummyRenderPass renderPass(device);
+
+    // Switching to the pipeline with the larger minimum size is an error for the small binding.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.SetPipeline(smallPipeline);
+        pass.SetBindGroup(0, smallBindGroup);
+        pass.Draw(3);
+        pass.SetPipeline(largePipeline);
+        pass.Draw(3);
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+
+    // Switching back to the pipeline with the smaller minimum size makes the binding valid again.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.SetPipeline(largePipeline);
+        pass.SetBindGroup(0, smallBindGroup);
+        pass.SetPipeline(smallPipeline);
+        pass.Draw(3);
+        pass.SetBindGroup(0, largeBindGroup);
+        pass.SetPipeline(largePipeline);
+        pass.Draw(3);
+        pass.EndPass();
+        encoder.Finish();
+    }
+
+    // Redundantly setting the same state doesn't hide a previous binding that is too small.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.SetPipeline(largePipeline);
+        pass.SetBindGroup(0, largeBindGroup);
+        pass.Draw(3);
+        pass.SetBindGroup(0, smallBindGroup);
+        pass.SetPipeline(largePipeline);
+        pass.SetBindGroup(0, smallBindGroup);
+        pass.Draw(3);
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+}
+
 // The correctness of minimum buffer size for the defaulted layout for a pipeline
 class MinBufferSizeDefaultLayoutTests : public MinBufferSizeTestsBase {
   public:
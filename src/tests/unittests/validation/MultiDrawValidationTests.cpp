@@ -0,0 +1,157 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "utils/ComboRenderBundleEncoderDescriptor.h"
+#include "utils/ComboRenderPipelineDescriptor.h"
+#include "utils/WGPUHelpers.h"
+
+class MultiDrawValidationTest : public ValidationTest {
+  protected:
+    void SetUp() override {
+        ValidationTest::SetUp();
+
+        wgpu::ShaderModule vsModule =
+            utils::CreateShaderModule(device, utils::SingleShaderStage::Vertex, R"(
+            #version 450
+            void main() {
+                gl_Position = vec4(0.0);
+            })");
+
+        wgpu::ShaderModule fsModule =
+            utils::CreateShaderModule(device, utils::SingleShaderStage::Fragment, R"(
+            #version 450
+            layout(location = 0) out vec4 fragColor;
+            void main() {
+                fragColor = vec4(0.0);
+            })");
+
+        utils::ComboRenderPipelineDescriptor descriptor(device);
+        descriptor.layout = utils::MakeBasicPipelineLayout(device, nullptr);
+        descriptor.vertexStage.module = vsModule;
+        descriptor.cFragmentStage.module = fsModule;
+        pipeline = device.CreateRenderPipeline(&descriptor);
+
+        indexBuffer = utils::CreateBufferFromData<uint32_t>(device, wgpu::BufferUsage::Index,
+                                                            {0, 1, 2, 0, 1, 2});
+    }
+
+    wgpu::RenderPipeline pipeline;
+    wgpu::Buffer indexBuffer;
+};
+
+// Test that multi draws validate like the equivalent individual draws.
+TEST_F(MultiDrawValidationTest, Success) {
+    DummyRenderPass renderPass(device);
+
+    wgpu::DrawArguments draws[3] = {};
+    draws[0].vertexCount = 3;
+    draws[1].vertexCount = 3;
+    draws[1].firstVertex = 3;
+    draws[2].vertexCount = 6;
+    draws[2].instanceCount = 4;
+
+    wgpu::DrawIndexedArguments indexedDraws[2] = {};
+    indexedDraws[0].indexCount = 3;
+    indexedDraws[1].indexCount = 3;
+    indexedDraws[1].firstIndex = 3;
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+    pass.SetPipeline(pipeline);
+    pass.MultiDraw(3, draws);
+    pass.SetIndexBufferWithFormat(indexBuffer, wgpu::IndexFormat::Uint32);
+    pass.MultiDrawIndexed(2, indexedDraws);
+    pass.EndPass();
+    encoder.Finish();
+}
+
+// Test that multi draws check the draw state once for all the draws.
+TEST_F(MultiDrawValidationTest, MissingState) {
+    DummyRenderPass renderPass(device);
+
+    wgpu::DrawArguments draws[2] = {};
+    draws[0].vertexCount = 3;
+    draws[1].vertexCount = 3;
+
+    wgpu::DrawIndexedArguments indexedDraws[2] = {};
+    indexedDraws[0].indexCount = 3;
+    indexedDraws[1].indexCount = 3;
+
+    // Missing pipeline
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.MultiDraw(2, draws);
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+
+    // Missing index buffer
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.SetPipeline(pipeline);
+        pass.MultiDrawIndexed(2, indexedDraws);
+        pass.EndPass();
+        ASSERT_DEVICE_ERROR(encoder.Finish());
+    }
+}
+
+// Test that a multi draw with no draws is a no-op that doesn't require any state.
+TEST_F(MultiDrawValidationTest, ZeroDraws) {
+    DummyRenderPass renderPass(device);
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+    pass.MultiDraw(0, nullptr);
+    pass.MultiDrawIndexed(0, nullptr);
+    pass.EndPass();
+    encoder.Finish();
+}
+
+// Test that multi draws are validated when recorded in a render bundle.
+TEST_F(MultiDrawValidationTest, RenderBundle) {
+    DummyRenderPass renderPass(device);
+
+    utils::ComboRenderBundleEncoderDescriptor desc = {};
+    desc.colorFormatsCount = 1;
+    desc.cColorFormats[0] = renderPass.attachmentFormat;
+
+    wgpu::DrawArguments draws[2] = {};
+    draws[0].vertexCount = 3;
+    draws[1].vertexCount = 3;
+
+    // Success case
+    {
+        wgpu::RenderBundleEncoder renderBundleEncoder = device.CreateRenderBundleEncoder(&desc);
+        renderBundleEncoder.SetPipeline(pipeline);
+        renderBundleEncoder.MultiDraw(2, draws);
+        wgpu::RenderBundle renderBundle = renderBundleEncoder.Finish();
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+        pass.ExecuteBundles(1, &renderBundle);
+        pass.EndPass();
+        encoder.Finish();
+    }
+
+    // Missing pipeline
+    {
+        wgpu::RenderBundleEncoder renderBundleEncoder = device.CreateRenderBundleEncoder(&desc);
+        renderBundleEncoder.MultiDraw(2, draws);
+        ASSERT_DEVICE_ERROR(renderBundleEncoder.Finish());
+    }
+}
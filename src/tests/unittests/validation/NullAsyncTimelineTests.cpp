@@ -0,0 +1,145 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "dawn_native/NullBackend.h"
+
+#include <cstring>
+
+namespace {
+
+    constexpr uint64_t kBufferSize = 4;
+
+    // Long enough for the tests to check that the work isn't done right after being submitted.
+    constexpr uint64_t kLatencyMicroseconds = 200 * 1000;
+
+    class NullAsyncTimelineTest : public ValidationTest {
+      protected:
+        void SetUp() override {
+            ValidationTest::SetUp();
+
+            dawn_native::DeviceDescriptor descriptor;
+            descriptor.forceEnabledToggles.push_back("null_use_async_timeline");
+            mAsyncDevice = wgpu::Device::Acquire(adapter.CreateDevice(&descriptor));
+            mQueue = mAsyncDevice.GetDefaultQueue();
+        }
+
+        void TearDown() override {
+            mQueue = nullptr;
+            mAsyncDevice = nullptr;
+            ValidationTest::TearDown();
+        }
+
+        void SetLatency(uint64_t latencyMicroseconds) {
+            dawn_native::null::AsyncTimelineOptions options;
+            options.latencyMicroseconds = latencyMicroseconds;
+            dawn_native::null::SetAsyncTimelineOptions(mAsyncDevice.Get(), options);
+        }
+
+        wgpu::Buffer CreateReadbackBuffer() {
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = kBufferSize;
+            descriptor.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+            return mAsyncDevice.CreateBuffer(&descriptor);
+        }
+
+        // Maps the buffer for reading and returns its content once the map is done.
+        uint32_t ReadBack(wgpu::Buffer buffer) {
+            bool done = false;
+            buffer.MapAsync(
+                wgpu::MapMode::Read, 0, kBufferSize,
+                [](WGPUBufferMapAsyncStatus status, void* userdata) {
+                    EXPECT_EQ(WGPUBufferMapAsyncStatus_Success, status);
+                    *static_cast<bool*>(userdata) = true;
+                },
+                &done);
+            while (!done) {
+                mAsyncDevice.Tick();
+            }
+
+            uint32_t value;
+            memcpy(&value, buffer.GetConstMappedRange(), sizeof(value));
+            buffer.Unmap();
+            return value;
+        }
+
+        wgpu::Device mAsyncDevice;
+        wgpu::Queue mQueue;
+    };
+
+}  // anonymous namespace
+
+// Test that a map waits for the submitted work to be executed by the timeline.
+TEST_F(NullAsyncTimelineTest, MapWaitsForLatency) {
+    SetLatency(kLatencyMicroseconds);
+
+    wgpu::Buffer buffer = CreateReadbackBuffer();
+    uint32_t value = 0x01020304;
+    mQueue.WriteBuffer(buffer, 0, &value, sizeof(value));
+
+    bool done = false;
+    buffer.MapAsync(
+        wgpu::MapMode::Read, 0, kBufferSize,
+        [](WGPUBufferMapAsyncStatus status, void* userdata) {
+            *static_cast<bool*>(userdata) = true;
+        },
+        &done);
+    mAsyncDevice.Tick();
+    EXPECT_FALSE(done);
+
+    while (!done) {
+        mAsyncDevice.Tick();
+    }
+    EXPECT_EQ(value, *static_cast<const uint32_t*>(buffer.GetConstMappedRange()));
+}
+
+// Test that the writes execute in submission order on the timeline.
+TEST_F(NullAsyncTimelineTest, WritesExecuteInOrder) {
+    wgpu::Buffer buffer = CreateReadbackBuffer();
+    for (uint32_t value = 1; value <= 16; ++value) {
+        mQueue.WriteBuffer(buffer, 0, &value, sizeof(value));
+        mQueue.Submit(0, nullptr);
+    }
+    EXPECT_EQ(16u, ReadBack(buffer));
+}
+
+// Test that the device becomes idle once the timeline executed all the work.
+TEST_F(NullAsyncTimelineTest, BecomesIdle) {
+    wgpu::Buffer buffer = CreateReadbackBuffer();
+    uint32_t value = 42;
+    mQueue.WriteBuffer(buffer, 0, &value, sizeof(value));
+    EXPECT_EQ(value, ReadBack(buffer));
+
+    // Ticks don't submit anything when there is no pending work.
+    bool isBusy = true;
+    for (uint32_t i = 0; i < 1000 && isBusy; ++i) {
+        isBusy = dawn_native::DeviceTick(mAsyncDevice.Get());
+    }
+    EXPECT_FALSE(isBusy);
+}
+
+// Test that the device can be destroyed while the timeline has work in flight.
+TEST_F(NullAsyncTimelineTest, DestroyWithWorkInFlight) {
+    SetLatency(kLatencyMicroseconds);
+
+    wgpu::Buffer buffer = CreateReadbackBuffer();
+    uint32_t value = 42;
+    mQueue.WriteBuffer(buffer, 0, &value, sizeof(value));
+    mAsyncDevice.Tick();
+
+    buffer = nullptr;
+    mQueue = nullptr;
+    mAsyncDevice = nullptr;
+}
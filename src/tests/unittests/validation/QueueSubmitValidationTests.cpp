@@ -239,4 +239,55 @@ namespace {
         ASSERT_DEVICE_ERROR(queue.Submit(1, &commands));
     }
 
+    // Test that reusable command buffers can be submitted multiple times
+    TEST_F(QueueSubmitValidationTest, ReusableCommandBufferSubmittedTwice) {
+        wgpu::CommandBufferDescriptor descriptor;
+        descriptor.reusable = true;
+        wgpu::CommandBuffer commandBuffer = device.CreateCommandEncoder().Finish(&descriptor);
+        wgpu::Queue queue = device.GetDefaultQueue();
+
+        queue.Submit(1, &commandBuffer);
+        queue.Submit(1, &commandBuffer);
+
+        // Submitting the same reusable command buffer twice in a single submit is valid too
+        wgpu::CommandBuffer commandBuffers[2] = {commandBuffer, commandBuffer};
+        queue.Submit(2, commandBuffers);
+    }
+
+    // Test that the resources used by reusable command buffers are validated at each submit
+    TEST_F(QueueSubmitValidationTest, ReusableCommandBufferResourcesValidated) {
+        const uint64_t kBufferSize = 4;
+        wgpu::BufferDescriptor descriptor;
+        descriptor.usage = wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc;
+        descriptor.size = kBufferSize;
+        wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+        descriptor.usage = wgpu::BufferUsage::CopyDst;
+        wgpu::Buffer targetBuffer = device.CreateBuffer(&descriptor);
+
+        wgpu::CommandBuffer commands;
+        {
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            encoder.CopyBufferToBuffer(buffer, 0, targetBuffer, 0, kBufferSize);
+            wgpu::CommandBufferDescriptor commandBufferDescriptor;
+            commandBufferDescriptor.reusable = true;
+            commands = encoder.Finish(&commandBufferDescriptor);
+        }
+
+        wgpu::Queue queue = device.GetDefaultQueue();
+        queue.Submit(1, &commands);
+
+        // Submitting while the source buffer is mapped is an error
+        buffer.MapAsync(wgpu::MapMode::Write, 0, kBufferSize, nullptr, nullptr);
+        ASSERT_DEVICE_ERROR(queue.Submit(1, &commands));
+
+        // Unlike one-time command buffers, the failed submit doesn't prevent submitting again
+        buffer.Unmap();
+        queue.Submit(1, &commands);
+
+        // Submitting with a destroyed buffer is an error
+        targetBuffer.Destroy();
+        ASSERT_DEVICE_ERROR(queue.Submit(1, &commands));
+    }
+
 }  // anonymous namespace
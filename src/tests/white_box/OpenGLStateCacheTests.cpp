@@ -0,0 +1,127 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "dawn_native/DawnNative.h"
+#include "utils/ComboRenderPipelineDescriptor.h"
+#include "utils/WGPUHelpers.h"
+
+#include <array>
+
+namespace {
+
+    constexpr uint32_t kRTSize = 4;
+
+    // These tests don't need a GPU: they run on Mesa's software rasterizer (llvmpipe) with
+    // LIBGL_ALWAYS_SOFTWARE=1.
+    class OpenGLStateCacheTests : public DawnTest {
+      protected:
+        void SetUp() override {
+            DawnTest::SetUp();
+            DAWN_SKIP_TEST_IF(UsesWire());
+
+            wgpu::ShaderModule vsModule =
+                utils::CreateShaderModule(device, utils::SingleShaderStage::Vertex, R"(
+                #version 450
+                void main() {
+                    const vec2 pos[3] = vec2[3](vec2(-1.f, -1.f), vec2(3.f, -1.f), vec2(-1.f, 3.f));
+                    gl_Position = vec4(pos[gl_VertexIndex], 0.f, 1.f);
+                })");
+
+            wgpu::ShaderModule fsModule =
+                utils::CreateShaderModule(device, utils::SingleShaderStage::Fragment, R"(
+                #version 450
+                layout(set = 0, binding = 0) uniform Color {
+                    vec4 color;
+                };
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = color;
+                })");
+
+            mRenderPass = utils::CreateBasicRenderPass(device, kRTSize, kRTSize);
+
+            utils::ComboRenderPipelineDescriptor descriptor(device);
+            descriptor.vertexStage.module = vsModule;
+            descriptor.cFragmentStage.module = fsModule;
+            descriptor.cColorStates[0].format = mRenderPass.colorFormat;
+            mPipeline = device.CreateRenderPipeline(&descriptor);
+        }
+
+        uint64_t GetSkippedStateChanges() {
+            return dawn_native::GetDeviceCounters(device.Get()).skippedGLStateChanges;
+        }
+
+        wgpu::Buffer CreateColorBuffer(std::array<float, 4> color) {
+            return utils::CreateBufferFromData(device, color.data(), sizeof(color),
+                                               wgpu::BufferUsage::Uniform);
+        }
+
+        void Draw(wgpu::Buffer colorBuffer) {
+            wgpu::BindGroup bindGroup = utils::MakeBindGroup(
+                device, mPipeline.GetBindGroupLayout(0), {{0, colorBuffer, 0, 4 * sizeof(float)}});
+
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&mRenderPass.renderPassInfo);
+            pass.SetPipeline(mPipeline);
+            pass.SetBindGroup(0, bindGroup);
+            pass.Draw(3);
+            pass.EndPass();
+            wgpu::CommandBuffer commands = encoder.Finish();
+            queue.Submit(1, &commands);
+        }
+
+        utils::BasicRenderPass mRenderPass;
+        wgpu::RenderPipeline mPipeline;
+    };
+
+}  // anonymous namespace
+
+// Test that drawing again with the same state skips the state changes.
+TEST_P(OpenGLStateCacheTests, SameStateIsSkipped) {
+    wgpu::Buffer red = CreateColorBuffer({1.f, 0.f, 0.f, 1.f});
+
+    Draw(red);
+    uint64_t skippedStateChanges = GetSkippedStateChanges();
+
+    Draw(red);
+    EXPECT_LT(skippedStateChanges, GetSkippedStateChanges());
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kRed, mRenderPass.color, 0, 0);
+}
+
+// Test that changing the bound buffer isn't skipped.
+TEST_P(OpenGLStateCacheTests, ChangedBindingIsSet) {
+    Draw(CreateColorBuffer({1.f, 0.f, 0.f, 1.f}));
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kRed, mRenderPass.color, 0, 0);
+
+    Draw(CreateColorBuffer({0.f, 1.f, 0.f, 1.f}));
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kGreen, mRenderPass.color, 0, 0);
+}
+
+// Test that a buffer reusing the GL name of a deleted buffer is bound, even though a buffer with
+// the same name was bound before.
+TEST_P(OpenGLStateCacheTests, RecycledNameIsBound) {
+    {
+        wgpu::Buffer red = CreateColorBuffer({1.f, 0.f, 0.f, 1.f});
+        Draw(red);
+        EXPECT_PIXEL_RGBA8_EQ(RGBA8::kRed, mRenderPass.color, 0, 0);
+        red.Destroy();
+    }
+
+    Draw(CreateColorBuffer({0.f, 0.f, 1.f, 1.f}));
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kBlue, mRenderPass.color, 0, 0);
+}
+
+DAWN_INSTANTIATE_TEST(OpenGLStateCacheTests, OpenGLBackend());
@@ -0,0 +1,114 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "dawn_native/Buffer.h"
+#include "dawn_native/DawnNative.h"
+#include "dawn_native/Device.h"
+#include "dawn_native/ScratchBufferAllocator.h"
+
+namespace {
+
+    constexpr uint64_t kAllocationSize = 1024;
+    constexpr uint64_t kLargeAllocationSize = 8 * 1024 * 1024;
+
+    class ScratchBufferAllocatorTests : public DawnTest {
+      protected:
+        void SetUp() override {
+            DawnTest::SetUp();
+            DAWN_SKIP_TEST_IF(UsesWire());
+
+            mDevice = reinterpret_cast<dawn_native::DeviceBase*>(device.Get());
+        }
+
+        dawn_native::ScratchBufferAllocation Allocate(uint64_t size, uint64_t alignment = 16) {
+            dawn_native::ScratchBufferAllocation allocation = {};
+            EXPECT_FALSE(mDevice->ConsumedError(
+                mDevice->GetScratchBufferAllocator()->Allocate(
+                    size, mDevice->GetPendingCommandSerial(), alignment),
+                &allocation));
+            return allocation;
+        }
+
+        // Submits the allocations made so far and waits for them to be reclaimable.
+        void SubmitAndWait() {
+            wgpu::CommandBuffer commands = device.CreateCommandEncoder().Finish();
+            queue.Submit(1, &commands);
+            WaitForAllOperations();
+        }
+
+        dawn_native::DeviceMemoryUsage GetMemoryUsage() {
+            return dawn_native::GetDeviceMemoryUsage(device.Get());
+        }
+
+        dawn_native::DeviceBase* mDevice = nullptr;
+    };
+
+}  // anonymous namespace
+
+// Test that the allocations of the same serial are aligned and don't overlap.
+TEST_P(ScratchBufferAllocatorTests, AllocationsDontOverlap) {
+    dawn_native::ScratchBufferAllocation first = Allocate(kAllocationSize - 1);
+    dawn_native::ScratchBufferAllocation second = Allocate(kAllocationSize, 256);
+
+    ASSERT_NE(first.buffer, nullptr);
+    EXPECT_EQ(first.buffer, second.buffer);
+    EXPECT_EQ(0u, first.offset % 16);
+    EXPECT_EQ(0u, second.offset % 256);
+    EXPECT_LE(first.offset + kAllocationSize - 1, second.offset);
+
+    dawn_native::DeviceMemoryUsage usage = GetMemoryUsage();
+    EXPECT_LE(2 * kAllocationSize, usage.scratchUsedBytes);
+    EXPECT_LE(usage.scratchUsedBytes, usage.scratchBytes);
+}
+
+// Test that the scratch memory is reused once the commands using it have completed, instead of
+// creating new buffers.
+TEST_P(ScratchBufferAllocatorTests, CompletedAllocationsAreReused) {
+    dawn_native::ScratchBufferAllocation first = Allocate(kAllocationSize);
+    SubmitAndWait();
+    uint64_t scratchBytes = GetMemoryUsage().scratchBytes;
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        dawn_native::ScratchBufferAllocation allocation = Allocate(kAllocationSize);
+        EXPECT_EQ(first.buffer, allocation.buffer);
+        SubmitAndWait();
+        EXPECT_EQ(0u, GetMemoryUsage().scratchUsedBytes);
+    }
+    EXPECT_EQ(scratchBytes, GetMemoryUsage().scratchBytes);
+}
+
+// Test that an allocation larger than the ring buffer gets a larger ring buffer, and that the
+// smaller one is released once it isn't used anymore.
+TEST_P(ScratchBufferAllocatorTests, LargeAllocationGrowsTheRingBuffer) {
+    dawn_native::ScratchBufferAllocation small = Allocate(kAllocationSize);
+    dawn_native::ScratchBufferAllocation large = Allocate(kLargeAllocationSize);
+    EXPECT_NE(small.buffer, large.buffer);
+    EXPECT_LE(kLargeAllocationSize, large.buffer->GetSize());
+
+    SubmitAndWait();
+    EXPECT_EQ(large.buffer->GetSize(), GetMemoryUsage().scratchBytes);
+
+    // The next allocations use the remaining large ring buffer.
+    dawn_native::ScratchBufferAllocation next = Allocate(kAllocationSize);
+    EXPECT_EQ(large.buffer, next.buffer);
+}
+
+DAWN_INSTANTIATE_TEST(ScratchBufferAllocatorTests,
+                      D3D12Backend(),
+                      MetalBackend(),
+                      NullBackend(),
+                      OpenGLBackend(),
+                      VulkanBackend());
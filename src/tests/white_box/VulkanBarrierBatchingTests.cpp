@@ -0,0 +1,218 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "common/vulkan_platform.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "utils/WGPUHelpers.h"
+
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t kBufferSize = 256;
+    constexpr uint32_t kBufferCount = 4;
+    constexpr uint32_t kTextureSize = 16;
+    constexpr uint32_t kBytesPerRow = 256;
+
+    PFN_vkCmdPipelineBarrier gCmdPipelineBarrier = nullptr;
+    uint32_t gPipelineBarrierCount = 0;
+
+    VKAPI_ATTR void VKAPI_CALL
+    CountingCmdPipelineBarrier(VkCommandBuffer commandBuffer,
+                               VkPipelineStageFlags srcStageMask,
+                               VkPipelineStageFlags dstStageMask,
+                               VkDependencyFlags dependencyFlags,
+                               uint32_t memoryBarrierCount,
+                               const VkMemoryBarrier* pMemoryBarriers,
+                               uint32_t bufferMemoryBarrierCount,
+                               const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+                               uint32_t imageMemoryBarrierCount,
+                               const VkImageMemoryBarrier* pImageMemoryBarriers) {
+        gPipelineBarrierCount++;
+        gCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, dependencyFlags,
+                            memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount,
+                            pBufferMemoryBarriers, imageMemoryBarrierCount, pImageMemoryBarriers);
+    }
+
+    class VulkanBarrierBatchingTests : public DawnTest {
+      protected:
+        void SetUp() override {
+            DawnTest::SetUp();
+            DAWN_SKIP_TEST_IF(UsesWire());
+
+            // Wrap vkCmdPipelineBarrier to count the barriers. The functions are only mutable by
+            // the device, like Device::GetMutableFunctions does.
+            dawn_native::vulkan::Device* deviceVk =
+                reinterpret_cast<dawn_native::vulkan::Device*>(device.Get());
+            mFunctions = const_cast<dawn_native::vulkan::VulkanFunctions*>(&deviceVk->fn);
+            gCmdPipelineBarrier = mFunctions->CmdPipelineBarrier;
+            mFunctions->CmdPipelineBarrier = CountingCmdPipelineBarrier;
+        }
+
+        void TearDown() override {
+            if (mFunctions != nullptr) {
+                mFunctions->CmdPipelineBarrier = gCmdPipelineBarrier;
+            }
+            DawnTest::TearDown();
+        }
+
+        // Submits |commands| and returns the number of barriers recorded for them.
+        uint32_t SubmitAndCountBarriers(wgpu::CommandBuffer commands) {
+            gPipelineBarrierCount = 0;
+            queue.Submit(1, &commands);
+            return gPipelineBarrierCount;
+        }
+
+        wgpu::Buffer CreateStagingBuffer(uint64_t size) {
+            std::vector<uint32_t> data(size / sizeof(uint32_t));
+            for (uint32_t i = 0; i < data.size(); ++i) {
+                data[i] = i;
+            }
+            return utils::CreateBufferFromData(device, data.data(), size,
+                                               wgpu::BufferUsage::CopySrc);
+        }
+
+        wgpu::Buffer CreateBuffer() {
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = kBufferSize;
+            descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+            return device.CreateBuffer(&descriptor);
+        }
+
+        wgpu::Texture CreateTexture(uint32_t mipLevelCount) {
+            wgpu::TextureDescriptor descriptor;
+            descriptor.size = {kTextureSize, kTextureSize, 1};
+            descriptor.format = wgpu::TextureFormat::RGBA8Unorm;
+            descriptor.mipLevelCount = mipLevelCount;
+            descriptor.usage = wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::CopyDst;
+            return device.CreateTexture(&descriptor);
+        }
+
+      private:
+        dawn_native::vulkan::VulkanFunctions* mFunctions = nullptr;
+    };
+
+}  // anonymous namespace
+
+// Test that the copies of an upload to buffers and to the mip levels of a texture are recorded
+// after a single barrier.
+TEST_P(VulkanBarrierBatchingTests, UploadCopiesShareOneBarrier) {
+    constexpr uint32_t kMipLevelCount = 3;
+    wgpu::Buffer staging = CreateStagingBuffer(kBytesPerRow * kTextureSize);
+
+    std::vector<wgpu::Buffer> buffers;
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        buffers.push_back(CreateBuffer());
+    }
+    wgpu::Texture texture = CreateTexture(kMipLevelCount);
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        encoder.CopyBufferToBuffer(staging, i * kBufferSize, buffers[i], 0, kBufferSize);
+    }
+    wgpu::BufferCopyView bufferCopyView =
+        utils::CreateBufferCopyView(staging, 0, kBytesPerRow, 0);
+    for (uint32_t level = 0; level < kMipLevelCount; ++level) {
+        wgpu::TextureCopyView textureCopyView =
+            utils::CreateTextureCopyView(texture, level, {0, 0, 0});
+        wgpu::Extent3D copySize = {kTextureSize >> level, kTextureSize >> level, 1};
+        encoder.CopyBufferToTexture(&bufferCopyView, &textureCopyView, &copySize);
+    }
+
+    EXPECT_EQ(1u, SubmitAndCountBarriers(encoder.Finish()));
+
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        std::vector<uint32_t> expected(kBufferSize / sizeof(uint32_t));
+        for (uint32_t j = 0; j < expected.size(); ++j) {
+            expected[j] = i * expected.size() + j;
+        }
+        EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), buffers[i], 0, expected.size());
+    }
+}
+
+// Test that copies to disjoint regions of the same subresource are recorded after a single
+// barrier.
+TEST_P(VulkanBarrierBatchingTests, DisjointRegionsShareOneBarrier) {
+    wgpu::Buffer staging = CreateStagingBuffer(kBytesPerRow * kTextureSize);
+    wgpu::Texture texture = CreateTexture(1);
+
+    wgpu::BufferCopyView bufferCopyView =
+        utils::CreateBufferCopyView(staging, 0, kBytesPerRow, 0);
+
+    // Initialize the texture first so that the partial copies don't clear it.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::TextureCopyView textureCopyView =
+            utils::CreateTextureCopyView(texture, 0, {0, 0, 0});
+        wgpu::Extent3D copySize = {kTextureSize, kTextureSize, 1};
+        encoder.CopyBufferToTexture(&bufferCopyView, &textureCopyView, &copySize);
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+    }
+
+    // Copy to the four quadrants of the texture.
+    constexpr uint32_t kHalfSize = kTextureSize / 2;
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    for (uint32_t y = 0; y < 2; ++y) {
+        for (uint32_t x = 0; x < 2; ++x) {
+            wgpu::TextureCopyView textureCopyView =
+                utils::CreateTextureCopyView(texture, 0, {x * kHalfSize, y * kHalfSize, 0});
+            wgpu::Extent3D copySize = {kHalfSize, kHalfSize, 1};
+            encoder.CopyBufferToTexture(&bufferCopyView, &textureCopyView, &copySize);
+        }
+    }
+
+    EXPECT_EQ(1u, SubmitAndCountBarriers(encoder.Finish()));
+}
+
+// Test that a copy reading the data written by a previous copy isn't batched with it.
+TEST_P(VulkanBarrierBatchingTests, ReadAfterWriteIsNotBatched) {
+    wgpu::Buffer staging = CreateStagingBuffer(kBufferSize);
+    wgpu::Buffer intermediate = CreateBuffer();
+    wgpu::Buffer destination = CreateBuffer();
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(staging, 0, intermediate, 0, kBufferSize);
+    encoder.CopyBufferToBuffer(intermediate, 0, destination, 0, kBufferSize);
+
+    EXPECT_EQ(2u, SubmitAndCountBarriers(encoder.Finish()));
+
+    std::vector<uint32_t> expected(kBufferSize / sizeof(uint32_t));
+    for (uint32_t i = 0; i < expected.size(); ++i) {
+        expected[i] = i;
+    }
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), destination, 0, expected.size());
+}
+
+// Test that overlapping writes to the same buffer aren't batched together.
+TEST_P(VulkanBarrierBatchingTests, WriteAfterWriteIsNotBatched) {
+    wgpu::Buffer staging = CreateStagingBuffer(2 * kBufferSize);
+    wgpu::Buffer destination = CreateBuffer();
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(staging, 0, destination, 0, kBufferSize);
+    encoder.CopyBufferToBuffer(staging, kBufferSize, destination, 0, kBufferSize);
+
+    EXPECT_EQ(2u, SubmitAndCountBarriers(encoder.Finish()));
+
+    std::vector<uint32_t> expected(kBufferSize / sizeof(uint32_t));
+    for (uint32_t i = 0; i < expected.size(); ++i) {
+        expected[i] = expected.size() + i;
+    }
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), destination, 0, expected.size());
+}
+
+DAWN_INSTANTIATE_TEST(VulkanBarrierBatchingTests, VulkanBackend());
@@ -0,0 +1,139 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "dawn_native/DawnNative.h"
+#include "utils/WGPUHelpers.h"
+
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t kNumValues = 4;
+    constexpr uint64_t kBufferSize = kNumValues * sizeof(uint32_t);
+
+    class VulkanDescriptorPoolTests : public DawnTest {
+      protected:
+        void SetUp() override {
+            DawnTest::SetUp();
+            DAWN_SKIP_TEST_IF(UsesWire());
+        }
+
+        dawn_native::DeviceCounters GetCounters() {
+            return dawn_native::GetDeviceCounters(device.Get());
+        }
+
+        wgpu::Buffer CreateStorageBuffer() {
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = kBufferSize;
+            descriptor.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc;
+            return device.CreateBuffer(&descriptor);
+        }
+
+        // Makes sure the bind groups released so far can give their descriptor set to the next
+        // bind groups.
+        void WaitForReleasedBindGroups() {
+            wgpu::CommandBuffer commands = device.CreateCommandEncoder().Finish();
+            queue.Submit(1, &commands);
+            WaitForAllOperations();
+        }
+    };
+
+}  // anonymous namespace
+
+// Test that layouts with the same number of descriptors of each type allocate their descriptor
+// sets from the same pool.
+TEST_P(VulkanDescriptorPoolTests, LayoutsWithSameDescriptorCountsSharePools) {
+    wgpu::Buffer buffer = CreateStorageBuffer();
+
+    // The layouts only differ by their visibility so they aren't deduplicated.
+    wgpu::BindGroupLayout computeLayout = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::StorageBuffer}});
+    wgpu::BindGroupLayout fragmentLayout = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Fragment, wgpu::BindingType::StorageBuffer}});
+
+    wgpu::BindGroup computeGroup =
+        utils::MakeBindGroup(device, computeLayout, {{0, buffer, 0, kBufferSize}});
+    uint64_t poolCount = GetCounters().liveDescriptorPools;
+    EXPECT_LE(1u, poolCount);
+
+    wgpu::BindGroup fragmentGroup =
+        utils::MakeBindGroup(device, fragmentLayout, {{0, buffer, 0, kBufferSize}});
+    EXPECT_EQ(poolCount, GetCounters().liveDescriptorPools);
+}
+
+// Test that a bind group with the same resources as a released one reuses its descriptor set.
+TEST_P(VulkanDescriptorPoolTests, SameContentReusesDescriptorSet) {
+    wgpu::Buffer buffer = CreateStorageBuffer();
+    wgpu::BindGroupLayout layout = utils::MakeBindGroupLayout(
+        device, {{0, wgpu::ShaderStage::Compute, wgpu::BindingType::StorageBuffer}});
+
+    utils::MakeBindGroup(device, layout, {{0, buffer, 0, kBufferSize}});
+    WaitForReleasedBindGroups();
+
+    uint64_t reusedCount = GetCounters().descriptorSetsReused;
+    wgpu::BindGroup group = utils::MakeBindGroup(device, layout, {{0, buffer, 0, kBufferSize}});
+    EXPECT_EQ(reusedCount + 1, GetCounters().descriptorSetsReused);
+
+    // A different range of the buffer needs the descriptor set to be written again.
+    group = nullptr;
+    WaitForReleasedBindGroups();
+
+    reusedCount = GetCounters().descriptorSetsReused;
+    group = utils::MakeBindGroup(device, layout, {{0, buffer, 0, kBufferSize / 2}});
+    EXPECT_EQ(reusedCount, GetCounters().descriptorSetsReused);
+}
+
+// Test that a descriptor set given to a bind group with different resources is written with them.
+TEST_P(VulkanDescriptorPoolTests, RecycledDescriptorSetIsWritten) {
+    wgpu::ShaderModule module =
+        utils::CreateShaderModule(device, utils::SingleShaderStage::Compute, R"(
+        #version 450
+        layout(std430, set = 0, binding = 0) buffer Buf { uint buf[]; };
+        void main() {
+            buf[gl_GlobalInvocationID.x] = 0x1234;
+        }
+    )");
+
+    wgpu::ComputePipelineDescriptor pipelineDesc = {};
+    pipelineDesc.computeStage.module = module;
+    pipelineDesc.computeStage.entryPoint = "main";
+    wgpu::ComputePipeline pipeline = device.CreateComputePipeline(&pipelineDesc);
+
+    wgpu::Buffer bufferA = CreateStorageBuffer();
+    wgpu::Buffer bufferB = CreateStorageBuffer();
+    for (wgpu::Buffer buffer : {bufferA, bufferB}) {
+        wgpu::BindGroup bindGroup = utils::MakeBindGroup(device, pipeline.GetBindGroupLayout(0),
+                                                         {{0, buffer, 0, kBufferSize}});
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.SetPipeline(pipeline);
+        pass.SetBindGroup(0, bindGroup);
+        pass.Dispatch(kNumValues);
+        pass.EndPass();
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+
+        bindGroup = nullptr;
+        WaitForReleasedBindGroups();
+    }
+
+    std::vector<uint32_t> expected(kNumValues, 0x1234);
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), bufferA, 0, kNumValues);
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), bufferB, 0, kNumValues);
+}
+
+DAWN_INSTANTIATE_TEST(VulkanDescriptorPoolTests, VulkanBackend());
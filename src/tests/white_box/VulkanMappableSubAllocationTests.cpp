@@ -0,0 +1,127 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "dawn_native/DawnNative.h"
+
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t kBufferCount = 64;
+    constexpr uint64_t kBufferSize = 256;
+
+    class VulkanMappableSubAllocationTests : public DawnTest {
+      protected:
+        void SetUp() override {
+            DawnTest::SetUp();
+            DAWN_SKIP_TEST_IF(UsesWire());
+        }
+
+        dawn_native::DeviceMemoryUsage GetMemoryUsage() {
+            return dawn_native::GetDeviceMemoryUsage(device.Get());
+        }
+
+        wgpu::Buffer CreateMappedBuffer(wgpu::BufferUsage usage, uint32_t value) {
+            wgpu::BufferDescriptor descriptor;
+            descriptor.size = kBufferSize;
+            descriptor.usage = usage;
+            descriptor.mappedAtCreation = true;
+            wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+            uint32_t* data = static_cast<uint32_t*>(buffer.GetMappedRange());
+            for (uint32_t i = 0; i < kBufferSize / sizeof(uint32_t); ++i) {
+                data[i] = value;
+            }
+            buffer.Unmap();
+            return buffer;
+        }
+    };
+
+}  // anonymous namespace
+
+// Test that small mappable buffers are sub-allocated instead of each having their own memory.
+TEST_P(VulkanMappableSubAllocationTests, MappableBuffersAreSubAllocated) {
+    dawn_native::DeviceMemoryUsage before = GetMemoryUsage();
+
+    std::vector<wgpu::Buffer> buffers;
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        wgpu::BufferDescriptor descriptor;
+        descriptor.size = kBufferSize;
+        descriptor.usage = i % 2 == 0 ? wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst
+                                      : wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc;
+        buffers.push_back(device.CreateBuffer(&descriptor));
+    }
+
+    dawn_native::DeviceMemoryUsage after = GetMemoryUsage();
+    EXPECT_EQ(before.directlyAllocatedBytes, after.directlyAllocatedBytes);
+    EXPECT_GE(after.subAllocated.usedBytes - before.subAllocated.usedBytes,
+              kBufferCount * kBufferSize);
+}
+
+// Test that buffers sharing a mapped heap each see their own data.
+TEST_P(VulkanMappableSubAllocationTests, SubAllocatedBuffersHaveTheirOwnData) {
+    std::vector<wgpu::Buffer> buffers;
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        buffers.push_back(
+            CreateMappedBuffer(wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc, i));
+    }
+
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        EXPECT_BUFFER_U32_EQ(i, buffers[i], 0);
+        EXPECT_BUFFER_U32_EQ(i, buffers[i], kBufferSize - sizeof(uint32_t));
+    }
+}
+
+// Test mapping for reading buffers that share a mapped heap.
+TEST_P(VulkanMappableSubAllocationTests, MapReadSubAllocatedBuffers) {
+    std::vector<wgpu::Buffer> buffers;
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        wgpu::Buffer source = CreateMappedBuffer(wgpu::BufferUsage::CopySrc, i);
+
+        wgpu::BufferDescriptor descriptor;
+        descriptor.size = kBufferSize;
+        descriptor.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+        buffers.push_back(device.CreateBuffer(&descriptor));
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        encoder.CopyBufferToBuffer(source, 0, buffers[i], 0, kBufferSize);
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+    }
+
+    uint32_t mappedCount = 0;
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        buffers[i].MapAsync(
+            wgpu::MapMode::Read, 0, kBufferSize,
+            [](WGPUBufferMapAsyncStatus status, void* userdata) {
+                ASSERT_EQ(WGPUBufferMapAsyncStatus_Success, status);
+                (*static_cast<uint32_t*>(userdata))++;
+            },
+            &mappedCount);
+    }
+    while (mappedCount < kBufferCount) {
+        WaitABit();
+    }
+
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        const uint32_t* data = static_cast<const uint32_t*>(buffers[i].GetConstMappedRange());
+        EXPECT_EQ(i, data[0]);
+        EXPECT_EQ(i, data[kBufferSize / sizeof(uint32_t) - 1]);
+        buffers[i].Unmap();
+    }
+}
+
+DAWN_INSTANTIATE_TEST(VulkanMappableSubAllocationTests, VulkanBackend());
@@ -0,0 +1,168 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "dawn_native/DawnNative.h"
+#include "utils/ComboRenderBundleEncoderDescriptor.h"
+#include "utils/ComboRenderPipelineDescriptor.h"
+#include "utils/WGPUHelpers.h"
+
+#include <array>
+
+namespace {
+
+    constexpr uint32_t kRTSize = 4;
+
+    // Enough draws for the render passes to be split in several chunks.
+    constexpr uint32_t kDrawCount = 2000;
+
+    class VulkanParallelRenderPassTests : public DawnTest {
+      protected:
+        void SetUp() override {
+            DawnTest::SetUp();
+            DAWN_SKIP_TEST_IF(UsesWire());
+            DAWN_SKIP_TEST_IF(!HasToggleEnabled("vulkan_record_render_passes_in_parallel"));
+
+            wgpu::ShaderModule vsModule =
+                utils::CreateShaderModule(device, utils::SingleShaderStage::Vertex, R"(
+                #version 450
+                void main() {
+                    const vec2 pos[3] = vec2[3](vec2(-1.f, -1.f), vec2(3.f, -1.f), vec2(-1.f, 3.f));
+                    gl_Position = vec4(pos[gl_VertexIndex], 0.f, 1.f);
+                })");
+
+            wgpu::ShaderModule fsModule =
+                utils::CreateShaderModule(device, utils::SingleShaderStage::Fragment, R"(
+                #version 450
+                layout(set = 0, binding = 0) uniform Color {
+                    vec4 color;
+                };
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = color;
+                })");
+
+            mRenderPass = utils::CreateBasicRenderPass(device, kRTSize, kRTSize);
+
+            utils::ComboRenderPipelineDescriptor descriptor(device);
+            descriptor.vertexStage.module = vsModule;
+            descriptor.cFragmentStage.module = fsModule;
+            descriptor.cColorStates[0].format = mRenderPass.colorFormat;
+            mPipeline = device.CreateRenderPipeline(&descriptor);
+
+            mRedGroup = CreateColorBindGroup({1.f, 0.f, 0.f, 1.f});
+            mGreenGroup = CreateColorBindGroup({0.f, 1.f, 0.f, 1.f});
+        }
+
+        wgpu::BindGroup CreateColorBindGroup(std::array<float, 4> color) {
+            wgpu::Buffer buffer = utils::CreateBufferFromData(device, color.data(), sizeof(color),
+                                                              wgpu::BufferUsage::Uniform);
+            return utils::MakeBindGroup(device, mPipeline.GetBindGroupLayout(0),
+                                        {{0, buffer, 0, sizeof(color)}});
+        }
+
+        uint64_t GetSecondaryCommandBuffersRecorded() {
+            return dawn_native::GetDeviceCounters(device.Get()).secondaryCommandBuffersRecorded;
+        }
+
+        utils::BasicRenderPass mRenderPass;
+        wgpu::RenderPipeline mPipeline;
+        wgpu::BindGroup mRedGroup;
+        wgpu::BindGroup mGreenGroup;
+    };
+
+}  // anonymous namespace
+
+// Test that the state set at the start of a large render pass is used by all its chunks.
+TEST_P(VulkanParallelRenderPassTests, StateIsSetInEachChunk) {
+    uint64_t recordedCount = GetSecondaryCommandBuffersRecorded();
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&mRenderPass.renderPassInfo);
+    // Only draw in the left half of the render target.
+    pass.SetViewport(0, 0, kRTSize / 2, kRTSize, 0, 1);
+    pass.SetPipeline(mPipeline);
+    pass.SetBindGroup(0, mRedGroup);
+    pass.PushDebugGroup("Red draws");
+    for (uint32_t i = 0; i < kDrawCount; ++i) {
+        pass.Draw(3);
+    }
+    pass.PopDebugGroup();
+    for (uint32_t i = 0; i < kDrawCount; ++i) {
+        pass.Draw(3);
+    }
+    pass.SetBindGroup(0, mGreenGroup);
+    pass.Draw(3);
+    pass.EndPass();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    EXPECT_LT(recordedCount + 1, GetSecondaryCommandBuffersRecorded());
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kGreen, mRenderPass.color, 0, 0);
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kZero, mRenderPass.color, kRTSize - 1, 0);
+}
+
+// Test that the chunks of a render pass can execute the same render bundle.
+TEST_P(VulkanParallelRenderPassTests, SameBundleInSeveralChunks) {
+    utils::ComboRenderBundleEncoderDescriptor desc = {};
+    desc.colorFormatsCount = 1;
+    desc.cColorFormats[0] = mRenderPass.colorFormat;
+
+    wgpu::RenderBundleEncoder bundleEncoder = device.CreateRenderBundleEncoder(&desc);
+    bundleEncoder.SetPipeline(mPipeline);
+    bundleEncoder.SetBindGroup(0, mRedGroup);
+    bundleEncoder.Draw(3);
+    wgpu::RenderBundle bundle = bundleEncoder.Finish();
+
+    uint64_t recordedCount = GetSecondaryCommandBuffersRecorded();
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&mRenderPass.renderPassInfo);
+    for (uint32_t i = 0; i < kDrawCount; ++i) {
+        pass.ExecuteBundles(1, &bundle);
+    }
+    pass.EndPass();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    EXPECT_LT(recordedCount + 1, GetSecondaryCommandBuffersRecorded());
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kRed, mRenderPass.color, 0, 0);
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8::kRed, mRenderPass.color, kRTSize - 1, kRTSize - 1);
+}
+
+// Test that the command pools of the recording threads are reused by the next submits.
+TEST_P(VulkanParallelRenderPassTests, CommandPoolsAreReused) {
+    for (uint32_t frame = 0; frame < 4; ++frame) {
+        wgpu::BindGroup group = frame % 2 == 0 ? mRedGroup : mGreenGroup;
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&mRenderPass.renderPassInfo);
+        pass.SetPipeline(mPipeline);
+        pass.SetBindGroup(0, group);
+        for (uint32_t i = 0; i < kDrawCount; ++i) {
+            pass.Draw(3);
+        }
+        pass.EndPass();
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+
+        EXPECT_PIXEL_RGBA8_EQ(frame % 2 == 0 ? RGBA8::kRed : RGBA8::kGreen, mRenderPass.color,
+                              0, 0);
+        WaitForAllOperations();
+    }
+}
+
+DAWN_INSTANTIATE_TEST(VulkanParallelRenderPassTests,
+                      VulkanBackend({"vulkan_record_render_passes_in_parallel"}));
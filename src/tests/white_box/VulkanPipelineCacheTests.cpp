@@ -0,0 +1,216 @@
+// Copyright 2020 The Dawn Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/DawnTest.h"
+
+#include "dawn_native/Instance.h"
+#include "dawn_native/vulkan/AdapterVk.h"
+#include "dawn_native/vulkan/DeviceVk.h"
+#include "dawn_platform/DawnPlatform.h"
+#include "utils/WGPUHelpers.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace {
+
+    // A blob store in memory that counts its calls.
+    class FakeCachingInterface : public dawn_platform::CachingInterface {
+      public:
+        size_t LoadData(const void* key,
+                        size_t keySize,
+                        void* valueOut,
+                        size_t valueSize) override {
+            loadCount++;
+            auto it = entries.find(std::string(static_cast<const char*>(key), keySize));
+            if (it == entries.end()) {
+                return 0;
+            }
+            if (valueOut != nullptr && valueSize >= it->second.size()) {
+                memcpy(valueOut, it->second.data(), it->second.size());
+            }
+            return it->second.size();
+        }
+
+        void StoreData(const void* key,
+                       size_t keySize,
+                       const void* value,
+                       size_t valueSize) override {
+            storeCount++;
+            entries[std::string(static_cast<const char*>(key), keySize)] =
+                std::string(static_cast<const char*>(value), valueSize);
+        }
+
+        std::map<std::string, std::string> entries;
+        uint32_t loadCount = 0;
+        uint32_t storeCount = 0;
+    };
+
+    // A platform that only provides the caching interface.
+    class CachingPlatform : public dawn_platform::Platform {
+      public:
+        const unsigned char* GetTraceCategoryEnabledFlag(
+            dawn_platform::TraceCategory category) override {
+            static unsigned char disabled = 0;
+            return &disabled;
+        }
+
+        double MonotonicallyIncreasingTime() override {
+            return 0.0;
+        }
+
+        uint64_t AddTraceEvent(char phase,
+                               const unsigned char* categoryGroupEnabled,
+                               const char* name,
+                               uint64_t id,
+                               double timestamp,
+                               int numArgs,
+                               const char** argNames,
+                               const unsigned char* argTypes,
+                               const uint64_t* argValues,
+                               unsigned char flags) override {
+            return 0;
+        }
+
+        dawn_platform::CachingInterface* GetCachingInterface() override {
+            return &cachingInterface;
+        }
+
+        FakeCachingInterface cachingInterface;
+    };
+
+    class VulkanPipelineCacheTests : public DawnTest {
+      protected:
+        void SetUp() override {
+            DawnTest::SetUp();
+            DAWN_SKIP_TEST_IF(UsesWire());
+
+            dawn_native::vulkan::Device* deviceVk =
+                reinterpret_cast<dawn_native::vulkan::Device*>(device.Get());
+            mAdapter = deviceVk->GetAdapter();
+
+            // The platform is only used by the devices created by the tests.
+            mPreviousPlatform = mAdapter->GetInstance()->GetPlatform();
+            mAdapter->GetInstance()->SetPlatform(&mPlatform);
+        }
+
+        void TearDown() override {
+            if (mAdapter != nullptr) {
+                mAdapter->GetInstance()->SetPlatform(mPreviousPlatform);
+            }
+            DawnTest::TearDown();
+        }
+
+        wgpu::Device CreateDevice() {
+            dawn_native::DeviceDescriptor descriptor;
+            descriptor.forceEnabledToggles = GetParam().forceEnabledWorkarounds;
+            descriptor.forceDisabledToggles = GetParam().forceDisabledWorkarounds;
+            return wgpu::Device::Acquire(
+                reinterpret_cast<WGPUDevice>(mAdapter->CreateDevice(&descriptor)));
+        }
+
+        void CreateComputePipeline(const wgpu::Device& otherDevice, uint32_t value) {
+            std::string shader = R"(
+                #version 450
+                layout(std140, set = 0, binding = 0) buffer Data { uint data; };
+                void main() {
+                    data = )" + std::to_string(value) +
+                                 R"(u;
+                })";
+
+            wgpu::ComputePipelineDescriptor descriptor;
+            descriptor.computeStage.module = utils::CreateShaderModule(
+                otherDevice, utils::SingleShaderStage::Compute, shader.c_str());
+            descriptor.computeStage.entryPoint = "main";
+            otherDevice.CreateComputePipeline(&descriptor);
+        }
+
+        CachingPlatform mPlatform;
+
+      private:
+        dawn_native::AdapterBase* mAdapter = nullptr;
+        dawn_platform::Platform* mPreviousPlatform = nullptr;
+    };
+
+}  // anonymous namespace
+
+// Test that the pipeline cache is stored when the device is destroyed and used to create the
+// pipeline cache of the next device.
+TEST_P(VulkanPipelineCacheTests, StoredCacheSeedsTheNextDevice) {
+    FakeCachingInterface& cache = mPlatform.cachingInterface;
+
+    wgpu::Device firstDevice = CreateDevice();
+    ASSERT_NE(firstDevice, nullptr);
+    EXPECT_EQ(0u, cache.storeCount);
+
+    CreateComputePipeline(firstDevice, 1);
+    firstDevice = nullptr;
+    EXPECT_EQ(1u, cache.storeCount);
+    ASSERT_EQ(1u, cache.entries.size());
+    EXPECT_FALSE(cache.entries.begin()->second.empty());
+
+    // The next device reads both the size and the content of the stored data.
+    uint32_t loadCountBefore = cache.loadCount;
+    wgpu::Device secondDevice = CreateDevice();
+    ASSERT_NE(secondDevice, nullptr);
+    EXPECT_EQ(loadCountBefore + 2, cache.loadCount);
+
+    CreateComputePipeline(secondDevice, 1);
+    secondDevice = nullptr;
+    EXPECT_EQ(2u, cache.storeCount);
+    EXPECT_EQ(1u, cache.entries.size());
+}
+
+// Test that data the driver can't use isn't given to it.
+TEST_P(VulkanPipelineCacheTests, IncompatibleDataIsIgnored) {
+    FakeCachingInterface& cache = mPlatform.cachingInterface;
+
+    // Store the data of a device to know the key used for the adapter.
+    {
+        wgpu::Device otherDevice = CreateDevice();
+        ASSERT_NE(otherDevice, nullptr);
+    }
+    ASSERT_EQ(1u, cache.entries.size());
+
+    cache.entries.begin()->second = "not a pipeline cache";
+    wgpu::Device otherDevice = CreateDevice();
+    ASSERT_NE(otherDevice, nullptr);
+    CreateComputePipeline(otherDevice, 2);
+    otherDevice = nullptr;
+
+    EXPECT_NE("not a pipeline cache", cache.entries.begin()->second);
+}
+
+// Test that a device doesn't overwrite the pipelines stored by another device of the adapter
+// that was destroyed after it was created.
+TEST_P(VulkanPipelineCacheTests, DevicesMergeTheirCaches) {
+    FakeCachingInterface& cache = mPlatform.cachingInterface;
+
+    wgpu::Device firstDevice = CreateDevice();
+    wgpu::Device secondDevice = CreateDevice();
+    ASSERT_NE(firstDevice, nullptr);
+    ASSERT_NE(secondDevice, nullptr);
+
+    CreateComputePipeline(firstDevice, 3);
+    firstDevice = nullptr;
+    ASSERT_EQ(1u, cache.entries.size());
+    size_t firstDeviceDataSize = cache.entries.begin()->second.size();
+
+    CreateComputePipeline(secondDevice, 4);
+    secondDevice = nullptr;
+    EXPECT_GE(cache.entries.begin()->second.size(), firstDeviceDataSize);
+}
+
+DAWN_INSTANTIATE_TEST(VulkanPipelineCacheTests, VulkanBackend());